@@ -0,0 +1,179 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Precomputes the FFTW wisdom of every DFT size used by the LTE and NR PHY: the OFDM symbol sizes of all the
+ * bandwidths, with and without standard sampling rates, and the LTE transform precoding sizes. It also plans the
+ * batched OFDM transforms of the LTE bandwidths. The resulting file is read at startup from SRSRAN_FFTW_WISDOM, or
+ * ~/.srsran_fftwisdom, so that the applications do not run the FFTW planner.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/srsran.h"
+
+#define MAX_NOF_SIZES 512
+
+static char* output_file_name = NULL;
+static bool  exhaustive       = false;
+
+static const uint32_t lte_nof_prb[] = {6, 15, 25, 50, 75, 100};
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [ox]\n", prog);
+  printf("\t-o output wisdom file [Default SRSRAN_FFTW_WISDOM or ~/.srsran_fftwisdom]\n");
+  printf("\t-x use the exhaustive FFTW planner instead of the patient one [Default %s]\n",
+         exhaustive ? "Enabled" : "Disabled");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ox")) != -1) {
+    switch (opt) {
+      case 'o':
+        output_file_name = argv[optind];
+        break;
+      case 'x':
+        exhaustive = true;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static double elapsed_ms(struct timespec* ts_start)
+{
+  struct timespec ts_end;
+  clock_gettime(CLOCK_MONOTONIC, &ts_end);
+  return (double)(ts_end.tv_sec - ts_start->tv_sec) * 1e3 + (double)(ts_end.tv_nsec - ts_start->tv_nsec) / 1e6;
+}
+
+static void add_size(uint32_t* sizes, uint32_t* nof_sizes, uint32_t size)
+{
+  for (uint32_t i = 0; i < *nof_sizes; i++) {
+    if (sizes[i] == size) {
+      return;
+    }
+  }
+  if (size > 0 && *nof_sizes < MAX_NOF_SIZES) {
+    sizes[(*nof_sizes)++] = size;
+  }
+}
+
+static uint32_t get_sizes(uint32_t* sizes)
+{
+  uint32_t nof_sizes = 0;
+  bool     standard  = srsran_symbol_size_is_standard();
+
+  // OFDM symbol sizes, with and without standard LTE sampling rates
+  for (uint32_t s = 0; s < 2; s++) {
+    srsran_use_standard_symbol_size(s == 0);
+    for (uint32_t i = 0; i < sizeof(lte_nof_prb) / sizeof(uint32_t); i++) {
+      int symbol_sz = srsran_symbol_sz(lte_nof_prb[i]);
+      if (symbol_sz > 0) {
+        add_size(sizes, &nof_sizes, (uint32_t)symbol_sz);
+      }
+    }
+    for (uint32_t nof_prb = 1; nof_prb <= SRSRAN_MAX_PRB_NR; nof_prb++) {
+      add_size(sizes, &nof_sizes, srsran_min_symbol_sz_rb(nof_prb));
+    }
+  }
+  srsran_use_standard_symbol_size(standard);
+
+  // Transform precoding sizes
+  for (uint32_t nof_prb = 1; nof_prb <= SRSRAN_MAX_PRB; nof_prb++) {
+    if (srsran_dft_precoding_valid_prb(nof_prb)) {
+      add_size(sizes, &nof_sizes, nof_prb * SRSRAN_NRE);
+    }
+  }
+
+  return nof_sizes;
+}
+
+// The OFDM objects plan their batched transforms with the same buffer layout the PHY uses
+static int plan_ofdm(uint32_t nof_prb, srsran_cp_t cp)
+{
+  int           ret    = SRSRAN_ERROR;
+  srsran_ofdm_t tx     = {};
+  srsran_ofdm_t rx     = {};
+  uint32_t      sf_len = SRSRAN_SF_LEN_PRB(nof_prb);
+  cf_t*         grid   = srsran_vec_cf_malloc(SRSRAN_SF_LEN_RE(nof_prb, cp));
+  cf_t*         signal = srsran_vec_cf_malloc(sf_len);
+
+  if (grid != NULL && signal != NULL && srsran_ofdm_tx_init(&tx, cp, grid, signal, nof_prb) == SRSRAN_SUCCESS &&
+      srsran_ofdm_rx_init(&rx, cp, signal, grid, nof_prb) == SRSRAN_SUCCESS) {
+    ret = SRSRAN_SUCCESS;
+  }
+
+  srsran_ofdm_tx_free(&tx);
+  srsran_ofdm_rx_free(&rx);
+  free(grid);
+  free(signal);
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  struct timespec t_start, t_size;
+  uint32_t        sizes[MAX_NOF_SIZES];
+
+  parse_args(argc, argv);
+
+  clock_gettime(CLOCK_MONOTONIC, &t_start);
+  uint32_t nof_sizes = get_sizes(sizes);
+  for (uint32_t i = 0; i < nof_sizes; i++) {
+    clock_gettime(CLOCK_MONOTONIC, &t_size);
+    if (srsran_dft_precompute_wisdom((int)sizes[i], exhaustive)) {
+      ERROR("Error planning DFT of %d points", sizes[i]);
+      exit(-1);
+    }
+    printf("DFT %5d points: %8.1f ms\n", sizes[i], elapsed_ms(&t_size));
+  }
+
+  for (uint32_t i = 0; i < sizeof(lte_nof_prb) / sizeof(uint32_t); i++) {
+    for (uint32_t c = 0; c < 2; c++) {
+      srsran_cp_t cp = (c == 0) ? SRSRAN_CP_NORM : SRSRAN_CP_EXT;
+      clock_gettime(CLOCK_MONOTONIC, &t_size);
+      if (plan_ofdm(lte_nof_prb[i], cp)) {
+        ERROR("Error planning OFDM of %d PRB", lte_nof_prb[i]);
+        exit(-1);
+      }
+      printf("OFDM %3d PRB %s: %8.1f ms\n", lte_nof_prb[i], srsran_cp_string(cp), elapsed_ms(&t_size));
+    }
+  }
+
+  if (srsran_dft_export_wisdom(output_file_name)) {
+    ERROR("Error exporting wisdom to %s", output_file_name ? output_file_name : "the default file");
+    exit(-1);
+  }
+
+  printf("Planned %d DFT sizes in %.1f s\n", nof_sizes, elapsed_ms(&t_start) / 1e3);
+
+  exit(0);
+}
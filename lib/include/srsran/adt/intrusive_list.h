@@ -108,6 +108,23 @@ public:
     node        = node->next_node;
     return static_cast<T*>(ret);
   }
+  /// Inserts t after the node pos, which must belong to the list
+  void insert_after(T* pos, T* t)
+  {
+    node_t* prev_node   = static_cast<node_t*>(pos);
+    node_t* new_node    = static_cast<node_t*>(t);
+    new_node->next_node = prev_node->next_node;
+    prev_node->next_node = new_node;
+  }
+  /// Unlinks and returns the node after pos, which must exist
+  T* erase_after(T* pos)
+  {
+    node_t* prev_node    = static_cast<node_t*>(pos);
+    node_t* ret          = prev_node->next_node;
+    prev_node->next_node = ret->next_node;
+    ret->next_node       = nullptr;
+    return static_cast<T*>(ret);
+  }
   void clear()
   {
     while (node != nullptr) {
@@ -24,15 +24,28 @@
 
 #include "memblock_cache.h"
 #include "srsran/adt/circular_buffer.h"
+#include <algorithm>
+#include <cinttypes>
 #include <thread>
+#include <vector>
 
 namespace srsran {
 
+/// Allocation statistics of one worker thread of a concurrent_fixed_memory_pool
+struct memory_pool_thread_metrics {
+  std::thread::id id;                   ///< default id for the sum of all the threads that already exited
+  size_t          nof_cached_blocks;    ///< blocks currently held in the thread-local cache
+  uint64_t        nof_cache_hits;       ///< allocations served by the thread-local cache
+  uint64_t        nof_cache_misses;     ///< allocations that had to refill the cache from the central cache
+  uint64_t        nof_alloc_failures;   ///< allocations that failed because the pool was depleted
+  uint64_t        nof_batches_returned; ///< batches of blocks sent back to the central cache
+};
+
 /**
  * Concurrent fixed size memory pool made of blocks of equal size
  * Each worker keeps a separate thread-local memory block cache that it uses for fast allocation/deallocation.
- * When this cache gets depleted, the worker tries to obtain blocks from a central memory block cache.
- * When accessing a thread local cache, no locks are required.
+ * When this cache gets depleted, the worker obtains a batch of blocks from a central memory block cache.
+ * When accessing a thread local cache, no locks are required, and the central cache is a lock-free stack of batches.
  * Since there is no stealing of blocks between workers, it is possible that a worker can't allocate while another
  * worker still has blocks in its own cache. To minimize the impact of this event, an upper bound is place on a worker
  * thread cache size. Once a worker reaches that upper bound, it sends half of its stored blocks to the central cache.
@@ -55,18 +68,23 @@ class concurrent_fixed_memory_pool
   const static size_t batch_steal_size = 16;
 
   // ctor only accessible from singleton get_instance()
-  explicit concurrent_fixed_memory_pool(size_t nof_objects_)
+  explicit concurrent_fixed_memory_pool(size_t nof_objects_) :
+    nof_blocks(nof_objects_),
+    allocated_blocks(new obj_storage_t[nof_objects_]()),
+    central_mem_cache(allocated_blocks.get(), sizeof(obj_storage_t), nof_objects_)
   {
     srsran_assert(nof_objects_ > batch_steal_size, "A positive pool size must be provided");
+    srsran_assert(allocated_blocks != nullptr, "Failed to instantiate fixed memory pool");
 
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.resize(nof_objects_);
-    for (std::unique_ptr<obj_storage_t>& b : allocated_blocks) {
-      b.reset(new obj_storage_t());
-      srsran_assert(b.get() != nullptr, "Failed to instantiate fixed memory pool");
-      central_mem_cache.push(static_cast<void*>(b.get()));
+    // Group all the blocks in batches in the central cache
+    free_memblock_list blocks;
+    for (size_t i = nof_blocks; i > 0; --i) {
+      blocks.push(static_cast<void*>(&allocated_blocks[i - 1]));
     }
-    local_growth_thres = allocated_blocks.size() / 16;
+    while (not blocks.empty()) {
+      central_mem_cache.push_batch(blocks, batch_steal_size);
+    }
+    local_growth_thres = nof_blocks / 16;
     local_growth_thres = local_growth_thres < batch_steal_size ? batch_steal_size : local_growth_thres;
   }
 
@@ -81,7 +99,7 @@ public:
   ~concurrent_fixed_memory_pool()
   {
     std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.clear();
+    allocated_blocks.reset();
   }
 
   static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress>* get_instance(size_t size = 4096)
@@ -90,7 +108,7 @@ public:
     return &pool;
   }
 
-  size_t size() { return allocated_blocks.size(); }
+  size_t size() { return nof_blocks; }
 
   void* allocate_node(size_t sz)
   {
@@ -98,16 +116,25 @@ public:
     worker_ctxt* worker_ctxt = get_worker_cache();
 
     void* node = worker_ctxt->cache.try_pop();
-    if (node == nullptr) {
+    if (node != nullptr) {
+      increment(worker_ctxt->nof_cache_hits);
+    } else {
+      increment(worker_ctxt->nof_cache_misses);
+
       // fill the thread local cache enough for this and next allocations
-      std::array<void*, batch_steal_size> popped_blocks;
-      size_t                              n = central_mem_cache.try_pop(popped_blocks);
-      for (size_t i = 0; i < n; ++i) {
-        new (popped_blocks[i]) obj_storage_t();
-        worker_ctxt->cache.push(static_cast<void*>(popped_blocks[i]));
+      free_memblock_list popped_blocks;
+      central_mem_cache.pop_batch(popped_blocks);
+      while (not popped_blocks.empty()) {
+        void* block = popped_blocks.pop();
+        new (block) obj_storage_t();
+        worker_ctxt->cache.push(block);
       }
       node = worker_ctxt->cache.try_pop();
+      if (node == nullptr) {
+        increment(worker_ctxt->nof_alloc_failures);
+      }
     }
+    worker_ctxt->nof_cached_blocks.store(worker_ctxt->cache.size(), std::memory_order_relaxed);
 
 #ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
     if (node == nullptr) {
@@ -125,9 +152,7 @@ public:
 
     if (DebugSanitizeAddress) {
       std::lock_guard<std::mutex> lock(mutex);
-      srsran_assert(std::any_of(allocated_blocks.begin(),
-                                allocated_blocks.end(),
-                                [block_ptr](const std::unique_ptr<obj_storage_t>& b) { return b.get() == block_ptr; }),
+      srsran_assert(block_ptr >= &allocated_blocks[0] and block_ptr < &allocated_blocks[nof_blocks],
                     "Error deallocating block with address 0x%lx",
                     (long unsigned)block_ptr);
     }
@@ -137,8 +162,9 @@ public:
 
     if (worker_ctxt->cache.size() >= local_growth_thres) {
       // if local cache reached max capacity, send half of the blocks to central cache
-      central_mem_cache.steal_blocks(worker_ctxt->cache, worker_ctxt->cache.size() / 2);
+      return_blocks(*worker_ctxt, worker_ctxt->cache.size() / 2);
     }
+    worker_ctxt->nof_cached_blocks.store(worker_ctxt->cache.size(), std::memory_order_relaxed);
   }
 
   void enable_logger(bool enabled)
@@ -151,30 +177,72 @@ public:
     }
   }
 
-  void print_all_buffers()
+  /// Allocation statistics of every thread that used the pool, plus one entry with the threads that already exited
+  std::vector<memory_pool_thread_metrics> get_metrics()
   {
-    auto*  worker     = get_worker_cache();
-    size_t tot_blocks = 0;
-    {
-      std::lock_guard<std::mutex> lock(mutex);
-      tot_blocks = allocated_blocks.size();
+    std::vector<memory_pool_thread_metrics> ret;
+    std::lock_guard<std::mutex>             lock(mutex);
+    ret.reserve(workers.size() + 1);
+    for (const worker_ctxt* w : workers) {
+      ret.push_back(w->get_metrics());
+    }
+    if (exited_workers.nof_cache_hits + exited_workers.nof_cache_misses > 0) {
+      ret.push_back(exited_workers);
     }
+    return ret;
+  }
+
+  void print_all_buffers()
+  {
+    auto* worker = get_worker_cache();
     printf("There are %zd/%zd buffers in shared block container. This thread contains %zd in its local cache\n",
            central_mem_cache.size(),
-           tot_blocks,
+           nof_blocks,
            worker->cache.size());
+    for (const memory_pool_thread_metrics& m : get_metrics()) {
+      uint64_t    nof_allocs = m.nof_cache_hits + m.nof_cache_misses;
+      std::string name       = m.id == std::thread::id()
+                                   ? std::string("exited threads")
+                                   : fmt::format("thread 0x{:x}", std::hash<std::thread::id>{}(m.id));
+      printf(" - %s: cached=%zd, allocs=%" PRIu64 ", hit rate=%.1f%%, failures=%" PRIu64 ", returned batches=%" PRIu64
+             "\n",
+             name.c_str(),
+             m.nof_cached_blocks,
+             nof_allocs,
+             nof_allocs > 0 ? 100.0 * m.nof_cache_hits / nof_allocs : 0.0,
+             m.nof_alloc_failures,
+             m.nof_batches_returned);
+    }
   }
 
 private:
   struct worker_ctxt {
-    std::thread::id    id;
-    free_memblock_list cache;
+    std::thread::id       id;
+    free_memblock_list    cache;
+    std::atomic<size_t>   nof_cached_blocks{0};
+    std::atomic<uint64_t> nof_cache_hits{0};
+    std::atomic<uint64_t> nof_cache_misses{0};
+    std::atomic<uint64_t> nof_alloc_failures{0};
+    std::atomic<uint64_t> nof_batches_returned{0};
 
-    worker_ctxt() : id(std::this_thread::get_id()) {}
+    worker_ctxt() : id(std::this_thread::get_id()) { pool_type::get_instance()->register_worker(this); }
     ~worker_ctxt()
     {
-      concurrent_free_memblock_list& central_cache = pool_type::get_instance()->central_mem_cache;
-      central_cache.steal_blocks(cache, cache.size());
+      pool_type* pool = pool_type::get_instance();
+      pool->return_blocks(*this, cache.size());
+      pool->unregister_worker(this);
+    }
+
+    memory_pool_thread_metrics get_metrics() const
+    {
+      memory_pool_thread_metrics m;
+      m.id                   = id;
+      m.nof_cached_blocks    = nof_cached_blocks.load(std::memory_order_relaxed);
+      m.nof_cache_hits       = nof_cache_hits.load(std::memory_order_relaxed);
+      m.nof_cache_misses     = nof_cache_misses.load(std::memory_order_relaxed);
+      m.nof_alloc_failures   = nof_alloc_failures.load(std::memory_order_relaxed);
+      m.nof_batches_returned = nof_batches_returned.load(std::memory_order_relaxed);
+      return m;
     }
   };
 
@@ -184,6 +252,39 @@ private:
     return &worker_cache;
   }
 
+  /// Counters are only written by their owner thread, so no read-modify-write atomic is needed
+  static void increment(std::atomic<uint64_t>& counter)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  /// Sends nof_blocks from the worker cache to the central cache, in batches
+  void return_blocks(worker_ctxt& worker, size_t nof_blocks_)
+  {
+    while (nof_blocks_ > 0 and not worker.cache.empty()) {
+      nof_blocks_ -= central_mem_cache.push_batch(worker.cache, std::min(nof_blocks_, batch_steal_size));
+      increment(worker.nof_batches_returned);
+    }
+    worker.nof_cached_blocks.store(worker.cache.size(), std::memory_order_relaxed);
+  }
+
+  void register_worker(worker_ctxt* worker)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    workers.push_back(worker);
+  }
+
+  void unregister_worker(worker_ctxt* worker)
+  {
+    memory_pool_thread_metrics  m = worker->get_metrics();
+    std::lock_guard<std::mutex> lock(mutex);
+    exited_workers.nof_cache_hits += m.nof_cache_hits;
+    exited_workers.nof_cache_misses += m.nof_cache_misses;
+    exited_workers.nof_alloc_failures += m.nof_alloc_failures;
+    exited_workers.nof_batches_returned += m.nof_batches_returned;
+    workers.erase(std::remove(workers.begin(), workers.end(), worker), workers.end());
+  }
+
   /// Formats and prints the input string and arguments into the configured output stream.
   template <typename... Args>
   void print_error(const char* str, Args&&... args)
@@ -198,9 +299,14 @@ private:
   size_t                local_growth_thres = 0;
   srslog::basic_logger* logger             = nullptr;
 
-  concurrent_free_memblock_list                central_mem_cache;
-  std::mutex                                   mutex;
-  std::vector<std::unique_ptr<obj_storage_t> > allocated_blocks;
+  const size_t                     nof_blocks;
+  std::unique_ptr<obj_storage_t[]> allocated_blocks;
+  concurrent_memblock_batch_stack  central_mem_cache;
+
+  // Protects the list of workers
+  std::mutex                 mutex;
+  std::vector<worker_ctxt*>  workers;
+  memory_pool_thread_metrics exited_workers = {};
 };
 
 } // namespace srsran
@@ -23,6 +23,9 @@
 #define SRSRAN_MEMBLOCK_CACHE_H
 
 #include "pool_utils.h"
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <mutex>
 
 namespace srsran {
@@ -269,6 +272,120 @@ private:
   mutable std::mutex mutex;
 };
 
+/**
+ * Lock-free stack of batches of memory blocks. All the blocks must be part of the same contiguous array, with a
+ * fixed stride between them.
+ * Each batch is stored in its first memory block, which keeps the list of the remaining blocks of the batch. The index
+ * of the next batch in the stack is kept in a separate array indexed by block, as a pop that races with another pop
+ * reads it after the block may have been handed to the user. The stack head packs the index of the top batch together
+ * with a counter that is incremented on every update, which avoids the ABA problem without the need for double-width
+ * atomics. A stale "next" index read by such a pop is harmless, as its compare-and-swap fails.
+ */
+class concurrent_memblock_batch_stack
+{
+  struct batch_header {
+    detail::intrusive_memblock_list::node* blocks;
+    size_t                                 nof_blocks;
+  };
+
+public:
+  concurrent_memblock_batch_stack(void* base_, size_t block_stride_, size_t nof_blocks_) :
+    base(static_cast<uint8_t*>(base_)),
+    block_stride(block_stride_),
+    max_nof_blocks(nof_blocks_),
+    next_batch(new std::atomic<uint32_t>[nof_blocks_]())
+  {
+    srsran_assert(block_stride >= sizeof(batch_header), "Memory blocks are too small to store a batch header");
+    srsran_assert(nof_blocks_ < std::numeric_limits<uint32_t>::max(), "Too many memory blocks");
+  }
+  concurrent_memblock_batch_stack(const concurrent_memblock_batch_stack&) = delete;
+  concurrent_memblock_batch_stack& operator=(const concurrent_memblock_batch_stack&) = delete;
+
+  /// Moves up to max_n blocks from "blocks" into a new batch on top of the stack. Returns the number of moved blocks
+  size_t push_batch(free_memblock_list& blocks, size_t max_n) noexcept
+  {
+    if (max_n == 0 or blocks.empty()) {
+      return 0;
+    }
+    void*                           first = blocks.pop();
+    detail::intrusive_memblock_list rest;
+    for (size_t i = 1; i < max_n and not blocks.empty(); ++i) {
+      rest.push(blocks.pop());
+    }
+    batch_header* hdr = ::new (first) batch_header();
+    hdr->blocks       = rest.head;
+    hdr->nof_blocks   = rest.size();
+    size_t n          = rest.size() + 1;
+    nof_blocks.fetch_add(n, std::memory_order_relaxed);
+
+    const uint32_t idx      = index_of(first);
+    uint64_t       old_head = head.load(std::memory_order_relaxed);
+    uint64_t       new_head;
+    do {
+      next_batch[idx].store(static_cast<uint32_t>(old_head), std::memory_order_relaxed);
+      new_head = (next_tag(old_head) << 32U) | (idx + 1);
+    } while (not head.compare_exchange_weak(old_head, new_head, std::memory_order_release, std::memory_order_relaxed));
+
+    return n;
+  }
+
+  /// Moves the batch on top of the stack into "blocks". Returns the number of moved blocks
+  size_t pop_batch(free_memblock_list& blocks) noexcept
+  {
+    batch_header* hdr      = nullptr;
+    uint64_t      old_head = head.load(std::memory_order_acquire);
+    do {
+      if ((old_head & 0xffffffffU) == 0) {
+        return 0;
+      }
+      const uint32_t idx      = static_cast<uint32_t>(old_head) - 1;
+      uint64_t       new_head = (next_tag(old_head) << 32U) | next_batch[idx].load(std::memory_order_relaxed);
+      hdr                     = block_at(idx);
+      if (head.compare_exchange_weak(old_head, new_head, std::memory_order_acquire, std::memory_order_acquire)) {
+        break;
+      }
+    } while (true);
+
+    detail::intrusive_memblock_list::node* node = hdr->blocks;
+    size_t                                 n    = hdr->nof_blocks;
+    for (size_t i = 0; i < n; ++i) {
+      detail::intrusive_memblock_list::node* next = node->next;
+      blocks.push(static_cast<void*>(node));
+      node = next;
+    }
+    hdr->~batch_header();
+    blocks.push(static_cast<void*>(hdr));
+    nof_blocks.fetch_sub(n + 1, std::memory_order_relaxed);
+
+    return n + 1;
+  }
+
+  bool empty() const noexcept { return (head.load(std::memory_order_relaxed) & 0xffffffffU) == 0; }
+
+  /// Number of blocks in the stack. Only approximate while other threads are pushing/popping
+  size_t size() const noexcept { return nof_blocks.load(std::memory_order_relaxed); }
+
+private:
+  static uint64_t next_tag(uint64_t h) { return ((h >> 32U) + 1) & 0xffffffffU; }
+
+  uint32_t index_of(void* block) const
+  {
+    size_t offset = static_cast<size_t>(static_cast<uint8_t*>(block) - base);
+    srsran_assert(offset % block_stride == 0 and offset / block_stride < max_nof_blocks,
+                  "Memory block does not belong to the stack");
+    return static_cast<uint32_t>(offset / block_stride);
+  }
+  batch_header* block_at(uint32_t idx) const { return reinterpret_cast<batch_header*>(base + idx * block_stride); }
+
+  uint8_t* const                           base;
+  const size_t                             block_stride;
+  const size_t                             max_nof_blocks;
+  /// index + 1 of the batch below the batch that starts at each block, 0 if it is the bottom one
+  std::unique_ptr<std::atomic<uint32_t>[]> next_batch;
+  std::atomic<uint64_t>                    head{0};
+  std::atomic<size_t>                      nof_blocks{0};
+};
+
 /**
  * Manages the allocation, caching and deallocation of memory blocks.
  * On alloc, a memory block is stolen from cache. If cache is empty, malloc/new is called.
@@ -28,6 +28,7 @@
 
 #include <arpa/inet.h>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <netinet/in.h>
 #include <netinet/sctp.h>
@@ -132,16 +133,17 @@ protected:
 };
 
 /**
- * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via a select
+ * Description - Instantiates one or more threads that block waiting for IO from multiple sockets, via epoll.
  *               The user can register their own (socket fd, data handler) in this class via the
- *               add_socket_handler(fd, task) API or its other variants
+ *               add_socket_handler(fd, task) API or its other variants. Each socket is assigned to the rx thread
+ *               with the fewest registered sockets, and its handler is always called from that thread.
  */
-class socket_manager final : public thread, public socket_manager_itf
+class socket_manager final : public socket_manager_itf
 {
   using recv_callback_t = socket_manager_itf::recv_callback_t;
 
 public:
-  socket_manager();
+  explicit socket_manager(uint32_t nof_rx_threads = 1);
   ~socket_manager() final;
 
   void stop();
@@ -149,28 +151,18 @@ public:
   bool remove_socket(int fd) final;
   bool add_socket_handler(int fd, recv_callback_t handler) final;
 
-  void run_thread() override;
+  /// Starts new rx threads until there are nof_rx_threads. Sockets already registered stay in their current thread
+  bool     set_nof_rx_threads(uint32_t nof_rx_threads);
+  uint32_t get_nof_rx_threads();
 
 private:
-  const int thread_prio = 65;
+  class rx_thread;
 
-  // used to unlock select
-  struct ctrl_cmd_t {
-    enum class cmd_id_t { EXIT, NEW_FD, RM_FD };
-    cmd_id_t cmd;
-    int      new_fd;
-    bool     signal_rm_complete;
-    ctrl_cmd_t() { bzero(this, sizeof(ctrl_cmd_t)); }
-  };
-  std::map<int, recv_callback_t>::iterator remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd);
+  const int thread_prio = 65;
 
   // state
-  std::mutex                     socket_mutex;
-  std::map<int, recv_callback_t> active_sockets;
-  std::atomic<bool>              running   = {false};
-  int                            pipefd[2] = {-1, -1};
-  std::vector<int>               rem_fd_tmp_list;
-  std::condition_variable        rem_cvar;
+  std::mutex                               mutex;
+  std::vector<std::unique_ptr<rx_thread> > rx_threads;
 };
 
 /// Function signature for SDU byte buffers received from SCTP socket
@@ -194,11 +186,19 @@ using recvfrom_callback_t = srsran::move_callback<void(srsran::unique_byte_buffe
 socket_manager_itf::recv_callback_t
 make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, sctp_recv_callback_t rx_callback);
 
+/// Maximum number of datagrams read with a single recvmmsg(...) call by the handlers of make_sdu_handler
+const uint32_t SOCKET_MAX_RX_BATCH = 32;
+
 /**
- * Similar to make_sctp_sdu_handler, but for any sockaddr_in-based socket type
+ * Similar to make_sctp_sdu_handler, but for any sockaddr_in-based socket type. Up to max_batch datagrams are read
+ * with a single recvmmsg(...) call, and each one of them is dispatched to the queue. The byte buffers are allocated on
+ * every call, as many as datagrams were read by the previous one (doubled if it filled them all), and the unused ones
+ * are returned to the pool, so the handler holds no buffers between calls.
  */
-socket_manager_itf::recv_callback_t
-make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, recvfrom_callback_t rx_callback);
+socket_manager_itf::recv_callback_t make_sdu_handler(srslog::basic_logger&      logger,
+                                                     srsran::task_queue_handle& queue,
+                                                     recvfrom_callback_t        rx_callback,
+                                                     uint32_t                   max_batch = SOCKET_MAX_RX_BATCH);
 
 inline socket_manager& get_rx_io_manager()
 {
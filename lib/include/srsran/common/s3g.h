@@ -39,10 +39,18 @@
 #include <string.h>
 
 typedef struct {
-  uint32_t* lfsr;
-  uint32_t* fsm;
+  uint32_t lfsr[16];
+  uint32_t fsm[3];
 } S3G_STATE;
 
+/* State of 8 SNOW 3G instances run in parallel, one per 32-bit lane. Word i of
+ * lane l is stored in lfsr[i][l].
+ */
+typedef struct {
+  uint32_t lfsr[16][8] __attribute__((aligned(32)));
+  uint32_t fsm[3][8] __attribute__((aligned(32)));
+} S3G_STATE_X8;
+
 /* Initialization.
  * Input k[4]: Four 32-bit words making up 128-bit key.
  * Input IV[4]: Four 32-bit words making 128-bit initialization variable.
@@ -72,6 +80,20 @@ void s3g_deinitialize(S3G_STATE* state);
 
 void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
+/* Returns true if the CPU supports the 8-lane (AVX2) SNOW 3G functions below. */
+bool s3g_x8_supported();
+
+/* Initialization of 8 parallel instances, with the key and IV of lane l in
+ * k[l] and iv[l]. Unlike s3g_initialize(), the first FSM output is already
+ * discarded, i.e. the state is ready to generate z_1.
+ */
+void s3g_initialize_x8(S3G_STATE_X8* state, const uint32_t k[8][4], const uint32_t iv[8][4]);
+
+/* Generates the next n keystream words of the 8 instances. ks[t][l] holds the
+ * word t of lane l. Can be called several times to produce a long keystream.
+ */
+void s3g_generate_keystream_x8(S3G_STATE_X8* state, uint32_t n, uint32_t (*ks)[8]);
+
 /* f8.
  * Input key: 128 bit Confidentiality Key.
  * Input count:32-bit Count, Frame dependent input.
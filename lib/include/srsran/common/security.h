@@ -309,6 +309,58 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/******************************************************************************
+ * Batch ciphering / integrity protection
+ *
+ * Process many PDUs of the same bearer (each one with its own COUNT) per call.
+ * Lengths are in bytes. out may be equal to msg for in-place ciphering.
+ *****************************************************************************/
+struct security_pdu_t {
+  uint32_t       count;
+  const uint8_t* msg;
+  uint32_t       msg_len;
+  uint8_t*       out; ///< ciphered/deciphered PDU
+  uint8_t*       mac; ///< 4 bytes of MAC-I
+};
+
+typedef enum {
+  SECURITY_AES128_GENERIC = 0,
+  SECURITY_AES128_AESNI,
+  SECURITY_AES128_VAES,
+  SECURITY_AES128_N_ITEMS,
+} security_aes128_impl_t;
+static const char security_aes128_impl_text[SECURITY_AES128_N_ITEMS][10] = {"generic", "aesni", "vaes"};
+
+/// AES-128 key of EEA2/EIA2, expanded once together with the CMAC subkeys instead of once per PDU
+struct security_aes128_ctx_t {
+  uint8_t                key[16];
+  alignas(16) uint8_t    round_keys[11][16];
+  uint8_t                k1[16];
+  uint8_t                k2[16];
+  security_aes128_impl_t impl;
+};
+
+/// Expands the key, selecting the fastest implementation supported by the CPU
+void security_aes128_init(security_aes128_ctx_t* ctx, const uint8_t* key);
+/// Forces an implementation. Returns false if the CPU does not support it
+bool security_aes128_set_impl(security_aes128_ctx_t* ctx, security_aes128_impl_t impl);
+
+void security_128_eea1_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, security_pdu_t* pdus, uint32_t nof_pdus);
+
+void security_128_eea2_batch(const security_aes128_ctx_t* ctx,
+                             uint8_t                      bearer,
+                             uint8_t                      direction,
+                             security_pdu_t*              pdus,
+                             uint32_t                     nof_pdus);
+
+void security_128_eea3_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, security_pdu_t* pdus, uint32_t nof_pdus);
+
+void security_128_eia2_batch(const security_aes128_ctx_t* ctx,
+                             uint32_t                     bearer,
+                             uint8_t                      direction,
+                             security_pdu_t*              pdus,
+                             uint32_t                     nof_pdus);
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -32,6 +32,7 @@
 #include "srsran/adt/intrusive_list.h"
 #include "srsran/adt/move_callback.h"
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <inttypes.h>
@@ -56,20 +57,32 @@ public:
  *   This deque will only grow in size. Erased timers are just tagged in the deque as empty, and can be reused for the
  *   creation of new timers. To avoid unnecessary runtime allocations, the user can set an initial capacity.
  * - free_list - intrusive forward linked list to keep track of the empty timers and speed up new timer creation.
- * - A large circular vector of size WHEEL_SIZE which works as a time wheel, storing and circularly indexing the
- *   currently running timers by their respective timeout value.
- *   For a number of running timers N, and uniform distribution of timeout values, the step_all() complexity
- *   should be O(N/WHEEL_SIZE). Thus, the performance should improve with a larger WHEEL_SIZE, at the expense of more
- *   used memory.
+ * - A hierarchical time wheel with NOF_WHEEL_LEVELS levels. The first level has one slot per tic, and each of the
+ *   following levels has slots that span a whole turn of the level below. Running timers are stored in the slot of
+ *   the lowest level that can hold their timeout, and are cascaded down to the lower levels as the time advances.
+ *   step_all() only visits the slot of the current tic, plus one slot of the upper levels every time a level wraps
+ *   around, so its complexity is O(1) per expired timer, regardless of the number of running timers.
+ * - pending_list - lock-free list of the timers that were started since the last step_all().
+ *   run(), stop() and set(duration) only update the atomic state of the timer and, when started, push the timer into
+ *   the pending list, so they do not contend for the mutex. The wheel is only accessed by step_all(), which moves the
+ *   pending timers to their wheel slot, and drops the stopped timers from the wheel when their slot is visited.
+ *   The mutex protects the allocation of timers and their callbacks.
  */
 class timer_handler
 {
-  using tic_diff_t                      = uint32_t;
-  using tic_t                           = uint32_t;
-  constexpr static uint32_t INVALID_ID  = std::numeric_limits<uint32_t>::max();
-  constexpr static size_t   WHEEL_SHIFT = 16U;
-  constexpr static size_t   WHEEL_SIZE  = 1U << WHEEL_SHIFT;
-  constexpr static size_t   WHEEL_MASK  = WHEEL_SIZE - 1U;
+  using tic_diff_t                             = uint32_t;
+  using tic_t                                  = uint32_t;
+  constexpr static uint32_t INVALID_ID         = std::numeric_limits<uint32_t>::max();
+  constexpr static size_t   WHEEL_SHIFT        = 8U;
+  constexpr static size_t   WHEEL_SIZE         = 1U << WHEEL_SHIFT;
+  constexpr static size_t   WHEEL_MASK         = WHEEL_SIZE - 1U;
+  constexpr static size_t   UPPER_WHEEL_SHIFT  = 6U;
+  constexpr static size_t   UPPER_WHEEL_SIZE   = 1U << UPPER_WHEEL_SHIFT;
+  constexpr static size_t   UPPER_WHEEL_MASK   = UPPER_WHEEL_SIZE - 1U;
+  constexpr static size_t   NOF_WHEEL_LEVELS   = 5U;
+  constexpr static size_t   NOF_WHEEL_SLOTS    = WHEEL_SIZE + (NOF_WHEEL_LEVELS - 1U) * UPPER_WHEEL_SIZE;
+  constexpr static uint16_t INVALID_WHEEL_SLOT = std::numeric_limits<uint16_t>::max();
+  static_assert(WHEEL_SHIFT + (NOF_WHEEL_LEVELS - 1U) * UPPER_WHEEL_SHIFT >= 32U, "The wheel must cover all tics");
 
   constexpr static uint64_t   STOPPED_FLAG       = 0U;
   constexpr static uint64_t   RUNNING_FLAG       = static_cast<uint64_t>(1U) << 63U;
@@ -84,6 +97,8 @@ class timer_handler
   {
     return mode_flag + (static_cast<uint64_t>(duration) << 32U) + timeout;
   }
+  /// Shift of the tics spanned by one slot of the given wheel level
+  static size_t level_shift(size_t level) { return level == 0 ? 0 : WHEEL_SHIFT + (level - 1) * UPPER_WHEEL_SHIFT; }
 
   struct timer_impl : public intrusive_double_linked_list_element<>, public intrusive_forward_list_element<> {
     // const
@@ -93,6 +108,11 @@ class timer_handler
     bool                                  allocated = false;
     std::atomic<uint64_t>                 state{0}; ///< read can be without lock, thus writes must be atomic
     srsran::move_callback<void(uint32_t)> callback;
+    // pending list
+    std::atomic<bool> pending{false};
+    timer_impl*       next_pending = nullptr;
+    // only accessed by step_all()
+    uint16_t wheel_slot = INVALID_WHEEL_SLOT;
 
     explicit timer_impl(timer_handler& parent_, uint32_t id_) : parent(parent_), id(id_) {}
     timer_impl(const timer_impl&) = delete;
@@ -110,7 +130,8 @@ class timer_handler
       uint64_t state_snapshot = state.load(std::memory_order_relaxed);
       bool     running = decode_is_running(state_snapshot), expired = decode_is_expired(state_snapshot);
       uint32_t duration = decode_duration(state_snapshot), timeout = decode_timeout(state_snapshot);
-      return running ? duration - (timeout - parent.cur_time) : (expired ? duration : 0);
+      // the timer may have been started with a stale time, if it raced with step_all()
+      return running ? std::min(duration, duration - (timeout - parent.cur_time)) : (expired ? duration : 0);
     }
 
     void set(uint32_t duration_)
@@ -119,7 +140,6 @@ class timer_handler
                     "Invalid timer duration=%" PRIu32 ">%" PRIu32,
                     duration_,
                     MAX_TIMER_DURATION);
-      std::lock_guard<std::mutex> lock(parent.mutex);
       set_(duration_);
     }
 
@@ -134,15 +154,10 @@ class timer_handler
       callback = std::move(callback_);
     }
 
-    void run()
-    {
-      std::lock_guard<std::mutex> lock(parent.mutex);
-      parent.start_run_(*this);
-    }
+    void run() { parent.start_run_(*this); }
 
     void stop()
     {
-      std::lock_guard<std::mutex> lock(parent.mutex);
       // does not call callback
       parent.stop_timer_(*this, false);
     }
@@ -157,13 +172,16 @@ class timer_handler
     void set_(uint32_t duration_)
     {
       duration_ = std::max(duration_, 1U); // the next step will be one place ahead of current one
-      // called in locked context
       uint64_t old_state = state.load(std::memory_order_relaxed);
-      if (decode_is_running(old_state)) {
+      uint64_t new_state;
+      do {
         // if already running, just extends timer lifetime
-        parent.start_run_(*this, duration_);
-      } else {
-        state.store(encode_state(STOPPED_FLAG, duration_, 0), std::memory_order_relaxed);
+        uint32_t new_timeout = parent.cur_time.load(std::memory_order_relaxed) + duration_;
+        new_state            = decode_is_running(old_state) ? encode_state(RUNNING_FLAG, duration_, new_timeout)
+                                                            : encode_state(STOPPED_FLAG, duration_, 0);
+      } while (not state.compare_exchange_weak(old_state, new_state, std::memory_order_relaxed));
+      if (decode_is_running(new_state)) {
+        parent.push_pending_(*this);
       }
     }
   };
@@ -234,7 +252,7 @@ public:
 
   explicit timer_handler(uint32_t capacity = 64)
   {
-    time_wheel.resize(WHEEL_SIZE);
+    time_wheel.resize(NOF_WHEEL_SLOTS);
     // Pre-reserve timers
     while (timer_list.size() < capacity) {
       timer_list.emplace_back(*this, timer_list.size());
@@ -250,29 +268,70 @@ public:
   {
     std::unique_lock<std::mutex> lock(mutex);
     uint32_t                     cur_time_local = cur_time.load(std::memory_order_relaxed) + 1;
-    auto&                        wheel_list     = time_wheel[cur_time_local & WHEEL_MASK];
 
-    for (auto it = wheel_list.begin(); it != wheel_list.end();) {
-      timer_impl& timer = timer_list[it->id];
-      ++it;
-      if (decode_timeout(timer.state.load(std::memory_order_relaxed)) == cur_time_local) {
+    // Insert the timers started since the last step in the wheel
+    move_pending_to_wheel_(cur_time_local);
+
+    // Cascade the upper level slots that span the upcoming tics, highest level first
+    if ((cur_time_local & WHEEL_MASK) == 0) {
+      size_t level = 1;
+      while (level + 1 < NOF_WHEEL_LEVELS and (cur_time_local & ((1U << level_shift(level + 1)) - 1U)) == 0) {
+        level++;
+      }
+      for (; level > 0; --level) {
+        size_t slot = WHEEL_SIZE + (level - 1) * UPPER_WHEEL_SIZE +
+                      ((cur_time_local >> level_shift(level)) & UPPER_WHEEL_MASK);
+        intrusive_double_linked_list<timer_impl> cascaded = std::move(time_wheel[slot]);
+        while (not cascaded.empty()) {
+          timer_impl& timer = cascaded.front();
+          cascaded.pop_front();
+          timer.wheel_slot = INVALID_WHEEL_SLOT;
+          uint64_t timer_state = timer.state.load(std::memory_order_relaxed);
+          if (decode_is_running(timer_state)) {
+            insert_in_wheel_(timer, decode_timeout(timer_state), cur_time_local);
+          }
+        }
+      }
+    }
+
+    // Expire the timers of the current tic. The slot is detached, as the lock is released during the callbacks
+    intrusive_double_linked_list<timer_impl> wheel_list = std::move(time_wheel[cur_time_local & WHEEL_MASK]);
+    while (not wheel_list.empty()) {
+      timer_impl& timer = wheel_list.front();
+      wheel_list.pop_front();
+      timer.wheel_slot = INVALID_WHEEL_SLOT;
+
+      uint64_t timer_state = timer.state.load(std::memory_order_relaxed);
+      bool     expired     = false;
+      while (decode_is_running(timer_state)) {
+        uint32_t timeout = decode_timeout(timer_state);
+        if (static_cast<int32_t>(timeout - cur_time_local) > 0) {
+          // restarted with a later timeout, but not moved yet
+          insert_in_wheel_(timer, timeout, cur_time_local);
+          break;
+        }
         // stop timer (callback has to see the timer has already expired)
-        stop_timer_(timer, true);
+        uint64_t new_state = encode_state(EXPIRED_FLAG, decode_duration(timer_state), timeout);
+        if (timer.state.compare_exchange_weak(timer_state, new_state, std::memory_order_relaxed)) {
+          nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
+          expired = true;
+          break;
+        }
+      }
 
-        // Call callback if configured
-        if (not timer.callback.is_empty()) {
-          // unlock mutex. It can happen that the callback tries to run a timer too
-          lock.unlock();
+      // Call callback if configured
+      if (expired and not timer.callback.is_empty()) {
+        // unlock mutex. It can happen that the callback tries to run a timer too
+        lock.unlock();
 
-          timer.callback(timer.id);
+        timer.callback(timer.id);
 
-          // Lock again to keep protecting the wheel
-          lock.lock();
-        }
+        // Lock again to keep protecting the timer list
+        lock.lock();
       }
     }
 
-    cur_time.fetch_add(1, std::memory_order_relaxed);
+    cur_time.store(cur_time_local, std::memory_order_relaxed);
   }
 
   void stop_all()
@@ -292,11 +351,7 @@ public:
     return timer_list.size() - nof_free_timers;
   }
 
-  uint32_t nof_running_timers() const
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    return nof_timers_running_;
-  }
+  uint32_t nof_running_timers() const { return nof_timers_running_.load(std::memory_order_relaxed); }
 
   constexpr static uint32_t max_timer_duration() { return MAX_TIMER_DURATION; }
 
@@ -313,7 +368,7 @@ public:
     timer.run();
   }
 
-  // useful for testing
+  // useful for testing. Number of tics of a turn of the lowest wheel level
   static size_t get_wheel_size() { return WHEEL_SIZE; }
 
 private:
@@ -347,60 +402,108 @@ private:
     timer.callback = srsran::move_callback<void(uint32_t)>();
     free_list.push_front(&timer);
     nof_free_timers++;
-    // leave id unchanged.
+    // leave id unchanged. The timer is dropped from the wheel and pending list by step_all()
   }
 
-  void start_run_(timer_impl& timer, uint32_t duration_ = 0)
+  void start_run_(timer_impl& timer)
   {
     uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
-    duration_                = duration_ == 0 ? decode_duration(timer_old_state) : duration_;
-    uint32_t new_timeout     = cur_time.load(std::memory_order_relaxed) + duration_;
-    size_t   new_wheel_pos   = new_timeout & WHEEL_MASK;
-
-    uint32_t old_timeout = decode_timeout(timer_old_state);
-    bool     was_running = decode_is_running(timer_old_state);
-    if (was_running and (old_timeout & WHEEL_MASK) == new_wheel_pos) {
-      // If no change in timer wheel position. Just update absolute timeout
-      timer.state.store(encode_state(RUNNING_FLAG, duration_, new_timeout), std::memory_order_relaxed);
-      return;
-    }
+    uint64_t new_state;
+    do {
+      uint32_t duration_ = decode_duration(timer_old_state);
+      new_state = encode_state(RUNNING_FLAG, duration_, cur_time.load(std::memory_order_relaxed) + duration_);
+    } while (not timer.state.compare_exchange_weak(timer_old_state, new_state, std::memory_order_relaxed));
 
-    // Stop timer if it was running, removing it from wheel in the process
-    if (was_running) {
-      time_wheel[old_timeout & WHEEL_MASK].pop(&timer);
-      nof_timers_running_--;
+    if (not decode_is_running(timer_old_state)) {
+      nof_timers_running_.fetch_add(1, std::memory_order_relaxed);
     }
-
-    // Insert timer in wheel
-    time_wheel[new_wheel_pos].push_front(&timer);
-    timer.state.store(encode_state(RUNNING_FLAG, duration_, new_timeout), std::memory_order_relaxed);
-    nof_timers_running_++;
+    push_pending_(timer);
   }
 
-  /// called when user manually stops timer (as an alternative to expiry)
+  /// called when user manually stops timer (as an alternative to expiry). The timer stays in the wheel until its slot
+  /// is visited by step_all()
   void stop_timer_(timer_impl& timer, bool expiry)
   {
     uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
-    if (not decode_is_running(timer_old_state)) {
+    uint64_t new_state;
+    do {
+      if (not decode_is_running(timer_old_state)) {
+        return;
+      }
+      new_state = encode_state(expiry ? EXPIRED_FLAG : STOPPED_FLAG,
+                               decode_duration(timer_old_state),
+                               decode_timeout(timer_old_state));
+    } while (not timer.state.compare_exchange_weak(timer_old_state, new_state, std::memory_order_relaxed));
+    nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Lock-free push of a started timer into the pending list, unless it is already there
+  void push_pending_(timer_impl& timer)
+  {
+    // Pairs with the fence in move_pending_to_wheel_(). Either step_all() sees the new state or the timer is pushed
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (timer.pending.exchange(true, std::memory_order_acq_rel)) {
       return;
     }
+    timer_impl* head = pending_list.load(std::memory_order_relaxed);
+    do {
+      timer.next_pending = head;
+    } while (
+        not pending_list.compare_exchange_weak(head, &timer, std::memory_order_release, std::memory_order_relaxed));
+  }
 
-    // If already running, need to disconnect it from previous wheel
-    uint32_t old_timeout = decode_timeout(timer_old_state);
-    time_wheel[old_timeout & WHEEL_MASK].pop(&timer);
-    uint64_t new_state =
-        encode_state(expiry ? EXPIRED_FLAG : STOPPED_FLAG, decode_duration(timer_old_state), old_timeout);
-    timer.state.store(new_state, std::memory_order_relaxed);
-    nof_timers_running_--;
+  /// called in locked context, from step_all()
+  void move_pending_to_wheel_(tic_t now)
+  {
+    timer_impl* timer = pending_list.exchange(nullptr, std::memory_order_acquire);
+    while (timer != nullptr) {
+      timer_impl* next = timer->next_pending;
+      // Cleared before reading the state, so that a concurrent restart pushes the timer again
+      timer->pending.store(false, std::memory_order_release);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (timer->wheel_slot != INVALID_WHEEL_SLOT) {
+        time_wheel[timer->wheel_slot].pop(timer);
+        timer->wheel_slot = INVALID_WHEEL_SLOT;
+      }
+      uint64_t timer_state = timer->state.load(std::memory_order_relaxed);
+      if (decode_is_running(timer_state)) {
+        insert_in_wheel_(*timer, decode_timeout(timer_state), now);
+      }
+      timer = next;
+    }
+  }
+
+  /// Inserts timer in the slot of the lowest wheel level that holds its timeout. "now" is the next tic to be expired
+  void insert_in_wheel_(timer_impl& timer, tic_t timeout, tic_t now)
+  {
+    size_t slot;
+    if (static_cast<int32_t>(timeout - now) <= 0) {
+      // Timeout is due, e.g. the timer was started concurrently with step_all()
+      slot = now & WHEEL_MASK;
+    } else {
+      tic_diff_t delta = timeout - now;
+      size_t     level = 0;
+      while (level + 1 < NOF_WHEEL_LEVELS and (delta >> level_shift(level + 1)) != 0) {
+        level++;
+      }
+      slot = level == 0 ? (timeout & WHEEL_MASK)
+                        : WHEEL_SIZE + (level - 1) * UPPER_WHEEL_SIZE +
+                              ((timeout >> level_shift(level)) & UPPER_WHEEL_MASK);
+    }
+    time_wheel[slot].push_front(&timer);
+    timer.wheel_slot = static_cast<uint16_t>(slot);
   }
 
-  std::atomic<tic_t> cur_time{0};
-  size_t             nof_timers_running_ = 0, nof_free_timers = 0;
+  std::atomic<tic_t>    cur_time{0};
+  std::atomic<uint32_t> nof_timers_running_{0};
+  size_t                nof_free_timers = 0;
   // using a deque to maintain reference validity on emplace_back. Also, this deque will only grow.
   std::deque<timer_impl>                                         timer_list;
   srsran::intrusive_forward_list<timer_impl>                     free_list;
+  std::atomic<timer_impl*>                                       pending_list{nullptr};
   std::vector<srsran::intrusive_double_linked_list<timer_impl> > time_wheel;
-  mutable std::mutex                                             mutex; // Protect priority queue
+  mutable std::mutex                                             mutex; // Protect timer allocation and callbacks
 };
 
 using unique_timer = timer_handler::unique_timer;
@@ -0,0 +1,150 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         tti_trace.h
+ *  Description:  Low overhead latency tracing. Each thread records the duration
+ *                of the traced scopes in its own ring of binary events, which
+ *                are exported at the end in the Chrome trace JSON format, that
+ *                can be opened with chrome://tracing or ui.perfetto.dev.
+ *                Tracing is enabled at runtime with tti_trace_init(), until then
+ *                a traced scope costs a relaxed atomic load.
+ *****************************************************************************/
+
+#ifndef SRSRAN_TTI_TRACE_H
+#define SRSRAN_TTI_TRACE_H
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace srsran {
+
+/// TTI value of the events that are not bound to a TTI
+constexpr uint32_t TTI_TRACE_NO_TTI = UINT32_MAX;
+
+/// Traced scope. The category and name must be string literals, as only the pointers are stored
+struct tti_trace_event_t {
+  const char* category;
+  const char* name;
+  uint64_t    start_ns;
+  uint32_t    duration_ns;
+  uint32_t    tti;
+};
+
+/// Ring of events written by a single thread. When full, the oldest events get overwritten. When the thread exits, the
+/// ring is kept for export until a new thread reuses it
+class tti_trace_ring
+{
+public:
+  tti_trace_ring(uint32_t nof_events, std::string thread_name_, uint32_t tid_);
+
+  /// Discards the events and hands the ring to a new writer thread. The writer must have exited
+  void reset(uint32_t nof_events, std::string thread_name_, uint32_t tid_);
+
+  void push(const tti_trace_event_t& event)
+  {
+    uint64_t h       = head.load(std::memory_order_relaxed);
+    events[h & mask] = event;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  /// Copies the events in the ring, oldest first. Events overwritten by the writer during the copy are discarded, as
+  /// well as the oldest event once the ring is full, since its slot is the next one to be written
+  std::vector<tti_trace_event_t> snapshot() const;
+
+  /// Number of events that can no longer be exported
+  uint64_t nof_lost() const;
+
+  const std::string& thread_name() const { return name; }
+  uint32_t           tid() const { return thread_id; }
+
+private:
+  std::vector<tti_trace_event_t> events;
+  uint64_t                       mask;
+  std::atomic<uint64_t>          head = {0};
+  std::string                    name;
+  uint32_t                       thread_id;
+};
+
+namespace detail {
+extern std::atomic<bool> tti_trace_enabled;
+} // namespace detail
+
+/// Enables tracing, with a ring of nof_events_per_thread events (rounded up to a power of 2) per thread. The ring size
+/// only applies to the threads that record their first event afterwards. The events are written into filename by
+/// tti_trace_write(). The rings of exited threads are reused by new threads, so their events are only written if
+/// tti_trace_write() is called before that
+bool tti_trace_init(const std::string& filename, uint32_t nof_events_per_thread = 65536);
+
+inline bool tti_trace_is_enabled()
+{
+  return detail::tti_trace_enabled.load(std::memory_order_relaxed);
+}
+
+/// Current time in the trace clock
+uint64_t tti_trace_now_ns();
+
+/// Records an event in the ring of the calling thread
+void tti_trace_record(const char* category, const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t tti);
+
+/// Writes the events of all threads in the Chrome trace JSON format, into the file given to tti_trace_init()
+bool tti_trace_write();
+bool tti_trace_write(const std::string& filename);
+
+/// Disables tracing. The recorded events can still be written
+void tti_trace_stop();
+
+/// Scoped type object that records the time spent between its construction and destruction
+class tti_trace_scope
+{
+public:
+  explicit tti_trace_scope(const char* category_, const char* name_, uint32_t tti_ = TTI_TRACE_NO_TTI) :
+    category(category_), name(name_), tti(tti_), start_ns(tti_trace_is_enabled() ? tti_trace_now_ns() : 0)
+  {}
+  tti_trace_scope(const tti_trace_scope&) = delete;
+  tti_trace_scope& operator=(const tti_trace_scope&) = delete;
+  ~tti_trace_scope()
+  {
+    if (start_ns != 0) {
+      tti_trace_record(category, name, start_ns, tti_trace_now_ns(), tti);
+    }
+  }
+
+private:
+  const char* const category;
+  const char* const name;
+  const uint32_t    tti;
+  const uint64_t    start_ns;
+};
+
+} // namespace srsran
+
+#define SRSRAN_TTI_TRACE_COMBINE1(X, Y) X##Y
+#define SRSRAN_TTI_TRACE_COMBINE(X, Y) SRSRAN_TTI_TRACE_COMBINE1(X, Y)
+
+/// Traces the rest of the enclosing scope, e.g. tti_trace_event("MAC", "mac::get_dl_sched", tti)
+#define tti_trace_event(...)                                                                                           \
+  srsran::tti_trace_scope SRSRAN_TTI_TRACE_COMBINE(tti_trace_scope_, __LINE__)(__VA_ARGS__)
+
+#endif // SRSRAN_TTI_TRACE_H
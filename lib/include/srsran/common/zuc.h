@@ -53,7 +53,22 @@ typedef struct {
   u32 BRC_X3;
 } zuc_state_t;
 
+/* the state of 8 ZUC instances run in parallel, one per 32-bit lane */
+typedef struct {
+  u32 LFSR_S[16][8] __attribute__((aligned(32)));
+  u32 F_R1[8] __attribute__((aligned(32)));
+  u32 F_R2[8] __attribute__((aligned(32)));
+} zuc_state_x8_t;
+
 void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv);
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream);
 
+/* 8-lane (AVX2) version. zuc_initialize_x8() also discards the first output of F,
+ * so that each zuc_generate_keystream_x8() call continues the keystream where the
+ * previous one stopped. p_keystream[t][l] is the word t of lane l.
+ */
+bool zuc_x8_supported();
+void zuc_initialize_x8(zuc_state_x8_t* state, const u8 k[8][16], const u8 iv[8][16]);
+void zuc_generate_keystream_x8(zuc_state_x8_t* state, int key_stream_len, u32 (*p_keystream)[8]);
+
 #endif // SRSRAN_ZUC_H
@@ -113,6 +113,7 @@ class gtpu_interface_gtpc // GTP-C -> GTP-U
 public:
   virtual in_addr_t get_s1u_addr() = 0;
 
+  virtual bool add_gtpu_ul_tunnel(in_addr_t ue_ipv4, uint32_t up_user_teid)                                       = 0;
   virtual bool modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtpc_f_teid_ie dw_user_fteid, uint32_t up_ctrl_teid) = 0;
   virtual bool delete_gtpu_tunnel(in_addr_t ue_ipv4)                                                              = 0;
   virtual bool delete_gtpc_tunnel(in_addr_t ue_ipv4)                                                              = 0;
@@ -23,6 +23,7 @@
 #define SRSRAN_UE_PDCP_INTERFACES_H
 
 #include "pdcp_interface_types.h"
+#include "srsran/adt/bounded_vector.h"
 #include "srsran/common/byte_buffer.h"
 
 namespace srsue {
@@ -75,6 +76,10 @@ public:
   virtual void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t pdu) = 0;
 };
 
+/// Maximum number of SDUs of the same EPS bearer that the GW hands to the stack at once
+const uint32_t GW_MAX_SDU_BATCH = 32;
+using gw_sdu_batch_t            = srsran::bounded_vector<srsran::unique_byte_buffer_t, GW_MAX_SDU_BATCH>;
+
 // STACK interface for GW (based on EPS-bearer IDs)
 class stack_interface_gw
 {
@@ -82,6 +87,8 @@ public:
   virtual bool is_registered()         = 0;
   virtual bool start_service_request() = 0;
   virtual void write_sdu(uint32_t eps_bearer_id, srsran::unique_byte_buffer_t sdu) = 0;
+  ///< Push several SDUs of the same EPS bearer with a single stack task
+  virtual void write_sdu_batch(uint32_t eps_bearer_id, gw_sdu_batch_t sdus) = 0;
   ///< Allow GW to query if a radio bearer for a given EPS bearer ID is currently active
   virtual bool has_active_radio_bearer(uint32_t eps_bearer_id) = 0;
 };
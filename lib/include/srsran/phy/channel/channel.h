@@ -29,8 +29,12 @@
 #include "rlf.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/srslog/srslog.h"
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace srsran {
 
@@ -39,7 +43,8 @@ class channel
 public:
   struct args_t {
     // General
-    bool enable = false;
+    bool     enable      = false;
+    uint32_t nof_threads = 1; // Threads running the fading and delay of the channels, the caller thread included
 
     // AWGN options
     bool  awgn_enable            = false;
@@ -76,18 +81,33 @@ public:
   void run(cf_t* in[SRSRAN_MAX_CHANNELS], cf_t* out[SRSRAN_MAX_CHANNELS], uint32_t len, const srsran_timestamp_t& t);
 
 private:
+  void run_link(uint32_t i, uint32_t len, const srsran_timestamp_t& t);
+  void run_worker(uint32_t id);
+
   srslog::basic_logger&    logger;
-  float                    hst_init_phase              = 0.0f;
-  srsran_channel_fading_t* fading[SRSRAN_MAX_CHANNELS] = {};
-  srsran_channel_delay_t*  delay[SRSRAN_MAX_CHANNELS]  = {};
-  srsran_channel_awgn_t*   awgn                        = nullptr;
-  srsran_channel_hst_t*    hst                         = nullptr;
-  srsran_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
-  uint32_t                 nof_channels                = 0;
-  uint32_t                 current_srate               = 0;
-  args_t                   args                        = {};
+  float                    hst_init_phase                   = 0.0f;
+  srsran_channel_fading_t* fading[SRSRAN_MAX_CHANNELS]      = {};
+  srsran_channel_delay_t*  delay[SRSRAN_MAX_CHANNELS]       = {};
+  srsran_channel_awgn_t*   awgn                             = nullptr;
+  srsran_channel_hst_t*    hst                              = nullptr;
+  srsran_channel_rlf_t*    rlf                              = nullptr;
+  cf_t*                    buffer_in[SRSRAN_MAX_CHANNELS]   = {};
+  cf_t*                    buffer_out[SRSRAN_MAX_CHANNELS]  = {};
+  bool                     link_active[SRSRAN_MAX_CHANNELS] = {};
+  uint32_t                 nof_channels                     = 0;
+  uint32_t                 current_srate                    = 0;
+  args_t                   args                             = {};
+
+  // Workers running the links in parallel with the caller, link i runs in worker i % (nof_workers + 1)
+  std::vector<std::thread> workers;
+  std::mutex               worker_mutex;
+  std::condition_variable  worker_start_cvar;
+  std::condition_variable  worker_done_cvar;
+  uint64_t                 worker_run     = 0;
+  uint32_t                 worker_pending = 0;
+  bool                     worker_quit    = false;
+  uint32_t                 worker_len     = 0;
+  srsran_timestamp_t       worker_ts      = {};
 };
 
 typedef std::unique_ptr<channel> channel_ptr;
@@ -45,25 +45,25 @@ typedef struct {
   float                         doppler; // Maximum doppler: 5, 70, 300
 
   // Internal tap parametrisation
-  uint32_t N;          // FFT size
-  uint32_t path_delay; // Path delay
-  uint32_t state_len;  // Length of the impulse response saved in the state
+  uint32_t N;           // FFT size
+  uint32_t path_delay;  // Path delay
+  uint32_t segment_len; // Number of samples filtered with every FFT, the rest of the FFT overlaps the previous ones
 
   float coeff_alpha[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS]; // Angle of arrival
+  float coeff_w[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Doppler phase rate in rad/s
   float coeff_a[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Random phase
   float coeff_b[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Random phase
-  cf_t* h_tap[SRSRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain
+  cf_t* h_tap[SRSRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain, FFT shifted
 
   // Utils
-  srsran_dft_plan_t fft;             // DFT to frequency domain
-  srsran_dft_plan_t ifft;            // DFT to time domain
-  cf_t*             temp;            // Temporal buffer, length fft_size
-  cf_t*             h_freq;          // Channel frequency response, length fft_size
-  cf_t*             y_freq;          // Intermediate frequency domain buffer
-  float             sin_table[1024]; // Table of sinus values
+  srsran_dft_plan_t fft;    // DFT to frequency domain
+  srsran_dft_plan_t ifft;   // DFT to time domain
+  cf_t*             temp;   // Temporal buffer, length fft_size
+  cf_t*             h_freq; // Channel frequency response, length fft_size
+  cf_t*             y_freq; // Intermediate frequency domain buffer
 
   // State variables
-  cf_t* state; // To save impulse response of the filter
+  cf_t* state; // Last fft_size input samples, for the overlap-save filter
 } srsran_channel_fading_t;
 
 #ifdef __cplusplus
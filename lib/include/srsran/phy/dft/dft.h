@@ -24,6 +24,7 @@
 
 #include "srsran/config.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**********************************************************************************************
  *  File:         dft.h
@@ -40,6 +41,10 @@
  *                norm   - Normalizes output (by sqrt(len) for complex, len for real).
  *                dc     - Handles insertion and removal of null DC carrier internally.
  *
+ *                The one-dimensional plans are created once per size, direction and mode
+ *                and shared by all the DFT objects of the process. The FFTW wisdom is
+ *                read from the file given in SRSRAN_FFTW_WISDOM, or ~/.srsran_fftwisdom.
+ *
  *  Reference:
  *********************************************************************************************/
 
@@ -58,6 +63,7 @@ typedef struct SRSRAN_API {
   void*             out;       // Output buffer
   void*             p;         // DFT plan
   bool              is_guru;
+  bool              is_shared; // The plan belongs to the process-wide cache
   bool              forward; // Forward transform?
   bool              mirror;  // Shift negative and positive frequencies?
   bool              db;      // Provide output in dB?
@@ -67,6 +73,15 @@ typedef struct SRSRAN_API {
   srsran_dft_mode_t mode;    // Complex/Real
 } srsran_dft_plan_t;
 
+typedef struct SRSRAN_API {
+  uint64_t wisdom_load_ns;    // Time spent importing the FFTW wisdom at startup
+  uint32_t nof_cached;        // Number of plans in the process-wide cache
+  uint64_t nof_cache_hits;    // Number of plans served from the cache without calling the FFTW planner
+  uint64_t nof_plans_created; // Number of calls to the FFTW planner, including the guru plans
+  uint64_t plan_time_ns;      // Total time spent in the FFTW planner
+  uint64_t max_plan_time_ns;  // Longest call to the FFTW planner
+} srsran_dft_metrics_t;
+
 SRSRAN_API int srsran_dft_plan(srsran_dft_plan_t* plan, int dft_points, srsran_dft_dir_t dir, srsran_dft_mode_t type);
 
 SRSRAN_API int srsran_dft_plan_c(srsran_dft_plan_t* plan, int dft_points, srsran_dft_dir_t dir);
@@ -82,6 +97,20 @@ SRSRAN_API int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
                                       int                idist,
                                       int                odist);
 
+/* Plans how_many_outer x how_many transforms in a single guru plan. The transform (i, j) reads the input from
+ * in_buffer + i * idist_outer + j * idist and writes the output into out_buffer + i * odist_outer + j * odist */
+SRSRAN_API int srsran_dft_plan_guru_batch_c(srsran_dft_plan_t* plan,
+                                            int                dft_points,
+                                            srsran_dft_dir_t   dir,
+                                            cf_t*              in_buffer,
+                                            cf_t*              out_buffer,
+                                            int                how_many_outer,
+                                            int                idist_outer,
+                                            int                odist_outer,
+                                            int                how_many,
+                                            int                idist,
+                                            int                odist);
+
 SRSRAN_API int srsran_dft_plan_r(srsran_dft_plan_t* plan, int dft_points, srsran_dft_dir_t dir);
 
 SRSRAN_API int srsran_dft_replan(srsran_dft_plan_t* plan, const int new_dft_points);
@@ -102,6 +131,21 @@ SRSRAN_API int srsran_dft_replan_r(srsran_dft_plan_t* plan, int new_dft_points);
 
 SRSRAN_API void srsran_dft_plan_free(srsran_dft_plan_t* plan);
 
+/* Plan cache and wisdom */
+
+SRSRAN_API void srsran_dft_get_metrics(srsran_dft_metrics_t* metrics);
+
+/* Writes a one line summary of the plan cache metrics into str. Planning the FFTW transforms is the main contributor to
+ * the PHY startup latency, so the PHYs log it once they are initialized */
+SRSRAN_API uint32_t srsran_dft_metrics_info(char* str, uint32_t str_len);
+
+/* Plans both directions of a complex DFT of dft_points with the patient, or exhaustive, FFTW planner. The resulting
+ * wisdom makes the later plans of the same size immediate once it is exported */
+SRSRAN_API int srsran_dft_precompute_wisdom(int dft_points, bool exhaustive);
+
+/* Exports the accumulated wisdom to filename, or to the default wisdom file if filename is NULL */
+SRSRAN_API int srsran_dft_export_wisdom(const char* filename);
+
 /* Set options */
 
 SRSRAN_API void srsran_dft_plan_set_mirror(srsran_dft_plan_t* plan, bool val);
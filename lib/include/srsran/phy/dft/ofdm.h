@@ -71,7 +71,8 @@ typedef struct SRSRAN_API {
 typedef struct SRSRAN_API {
   srsran_ofdm_cfg_t cfg;
   srsran_dft_plan_t fft_plan;
-  srsran_dft_plan_t fft_plan_sf[2];
+  srsran_dft_plan_t fft_plan_sf[2]; ///< Guru DFT plans of each slot, used by MBSFN subframes
+  srsran_dft_plan_t fft_plan_batch; ///< Guru DFT plan of all the symbols of a subframe
   uint32_t          max_prb;
   uint32_t          nof_symbols;
   uint32_t          nof_guards;
@@ -36,6 +36,17 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/*
+ * CRC engines used by srsran_crc_checksum() and srsran_crc_checksum_byte(). All of them give the same result, the
+ * default is the fastest one supported by the running CPU. The byte-wise srsran_crc_checksum_put_byte() always uses the
+ * byte table.
+ */
+typedef enum SRSRAN_API {
+  SRSRAN_CRC_IMPL_TABLE = 0, // One byte per iteration, single 256-entry table
+  SRSRAN_CRC_IMPL_SLICE8,    // Eight bytes per iteration, 8x256-entry tables
+  SRSRAN_CRC_IMPL_CLMUL,     // Carry-less multiplication folding (x86 PCLMULQDQ), slice-by-8 for the tail
+} srsran_crc_impl_t;
+
 typedef struct SRSRAN_API {
   uint64_t table[256];
   int      polynom;
@@ -44,12 +55,24 @@ typedef struct SRSRAN_API {
   uint64_t crcmask;
   uint64_t crchighbit;
   uint32_t srsran_crc_out;
+
+  // Slice-by-8 and folding state, the CRC register is kept left-aligned in 32 bits
+  srsran_crc_impl_t impl;
+  uint32_t          table8[8][256];
+  uint64_t          fold_k[4]; // x^(512+64), x^512, x^(128+64) and x^128 modulo the left-aligned polynomial
 } srsran_crc_t;
 
 SRSRAN_API int srsran_crc_init(srsran_crc_t* h, uint32_t srsran_crc_poly, int srsran_crc_order);
 
 SRSRAN_API int srsran_crc_set_init(srsran_crc_t* h, uint64_t init_value);
 
+/**
+ * Selects the CRC engine. Returns SRSRAN_ERROR if the engine is not supported by the CPU or by the CRC order.
+ */
+SRSRAN_API int srsran_crc_set_impl(srsran_crc_t* h, srsran_crc_impl_t impl);
+
+SRSRAN_API const char* srsran_crc_impl_string(srsran_crc_impl_t impl);
+
 SRSRAN_API uint32_t srsran_crc_attach(srsran_crc_t* h, uint8_t* data, int len);
 
 SRSRAN_API uint32_t srsran_crc_attach_byte(srsran_crc_t* h, uint8_t* data, int len);
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         fec_pool.h
+ *
+ *  Description:  Pool of threads for decoding the codeblocks of a transport block
+ *                in parallel. Every thread owns a private decoder context, created
+ *                by the user of the pool, so codeblocks of the same transport block
+ *                can be processed concurrently. The pool is shared by all PHY
+ *                workers, which push one job per codeblock and wait for them on a
+ *                completion barrier.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSRAN_FEC_POOL_H
+#define SRSRAN_FEC_POOL_H
+
+#include "srsran/config.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SRSRAN_FEC_POOL_MAX_JOBS 1024
+
+/**
+ * @brief Creates the private context of a pool thread. It returns NULL if the context can not be created
+ */
+typedef void* (*srsran_fec_pool_ctx_init_t)(void* arg);
+
+/**
+ * @brief Releases the private context of a pool thread
+ */
+typedef void (*srsran_fec_pool_ctx_free_t)(void* ctx);
+
+/**
+ * @brief Job function, it receives the private context of the thread that runs it
+ */
+typedef void (*srsran_fec_pool_job_fn_t)(void* ctx, void* arg);
+
+/**
+ * @brief Counts the jobs of a caller that are still pending
+ */
+typedef struct SRSRAN_API {
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar;
+  uint32_t        pending;
+} srsran_fec_pool_barrier_t;
+
+typedef struct SRSRAN_API {
+  srsran_fec_pool_job_fn_t   fn;
+  void*                      arg;
+  srsran_fec_pool_barrier_t* barrier;
+} srsran_fec_pool_job_t;
+
+typedef struct SRSRAN_API {
+  uint32_t                   nof_workers;
+  uint32_t                   nof_ctx;
+  pthread_t*                 threads;
+  void**                     ctx;
+  srsran_fec_pool_ctx_free_t ctx_free;
+
+  /* Job queue */
+  pthread_mutex_t       mutex;
+  pthread_cond_t        cvar_job;
+  pthread_cond_t        cvar_space;
+  srsran_fec_pool_job_t jobs[SRSRAN_FEC_POOL_MAX_JOBS];
+  uint32_t              jobs_r;
+  uint32_t              jobs_count;
+  uint32_t              nof_started;
+  bool                  quit;
+} srsran_fec_pool_t;
+
+/**
+ * @brief Creates a pool of threads, each with its own context
+ * @param q FEC pool object
+ * @param nof_workers Number of threads
+ * @param ctx_init Function that creates the context of every thread
+ * @param ctx_free Function that releases the context of every thread
+ * @param ctx_arg Argument passed to ctx_init
+ * @return SRSRAN_SUCCESS if the pool is created, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_fec_pool_init(srsran_fec_pool_t*         q,
+                                    uint32_t                   nof_workers,
+                                    srsran_fec_pool_ctx_init_t ctx_init,
+                                    srsran_fec_pool_ctx_free_t ctx_free,
+                                    void*                      ctx_arg);
+
+/**
+ * @brief Stops the threads and releases their contexts. Pending jobs are still executed
+ */
+SRSRAN_API void srsran_fec_pool_free(srsran_fec_pool_t* q);
+
+/**
+ * @brief Queues a job, it blocks if the queue is full
+ * @param q FEC pool object
+ * @param fn Job function
+ * @param arg Job argument
+ * @param barrier Barrier that is released when the job is done
+ * @return SRSRAN_SUCCESS if the job is queued, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int
+srsran_fec_pool_push(srsran_fec_pool_t* q, srsran_fec_pool_job_fn_t fn, void* arg, srsran_fec_pool_barrier_t* barrier);
+
+SRSRAN_API int srsran_fec_pool_barrier_init(srsran_fec_pool_barrier_t* b);
+
+SRSRAN_API void srsran_fec_pool_barrier_free(srsran_fec_pool_barrier_t* b);
+
+/**
+ * @brief Waits until all the jobs pushed with this barrier are done
+ */
+SRSRAN_API void srsran_fec_pool_barrier_wait(srsran_fec_pool_barrier_t* b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_FEC_POOL_H
@@ -60,8 +60,27 @@ typedef struct {
   uint16_t                   ls;           /*!< \brief The desired lifting size. */
   float                      scaling_fctr; /*!< \brief Scaling factor of the normalized min-sum algorithm.*/
   uint32_t                   max_nof_iter; /*!< \brief Maximum number of iterations, set to 0 for default value. */
+  bool                       early_stop;   /*!< \brief Stops when the syndrome is zero, if there is no CRC. */
 } srsran_ldpc_decoder_args_t;
 
+/*!
+ * \brief Number of bins of the histogram of iterations, the last bin also counts the decodings that took more
+ * iterations.
+ */
+#define SRSRAN_LDPC_DECODER_NOF_ITER_BINS 32
+
+/*!
+ * \brief Decoding statistics, accumulated by the decoder object since it was initialized or last reset.
+ */
+typedef struct {
+  uint64_t nof_cb;          /*!< \brief Number of decoded codeblocks. */
+  uint64_t nof_batches;     /*!< \brief Number of decodings of several packed codeblocks at once. */
+  uint64_t nof_iter;        /*!< \brief Total number of iterations, over all the codeblocks. */
+  uint64_t nof_early_stops; /*!< \brief Codeblocks that met the stopping criterion before the last iteration. */
+  uint64_t nof_failures;    /*!< \brief Codeblocks that did not meet the stopping criterion (CRC or syndrome). */
+  uint64_t iter_hist[SRSRAN_LDPC_DECODER_NOF_ITER_BINS]; /*!< \brief Number of codeblocks per number of iterations. */
+} srsran_ldpc_decoder_stats_t;
+
 /*!
  * \brief Describes an LDPC decoder.
  */
@@ -82,6 +101,15 @@ typedef struct SRSRAN_API {
 
   float scaling_fctr; /*!< \brief Scaling factor for the normalized min-sum algorithm. */
 
+  bool     early_stop; /*!< \brief Stops iterating as soon as the syndrome is zero, when no CRC is provided. */
+  uint8_t* codeword;   /*!< \brief Hard decisions of the codeword, used for the syndrome check. */
+  uint8_t* syndrome;   /*!< \brief Parity checks of one layer, used for the syndrome check. */
+
+  void*    ptr_batch;  /*!< \brief Registers used by the decoder of packed codeblocks, NULL if not supported. */
+  uint32_t batch_size; /*!< \brief Number of codeblocks decoded at once by srsran_ldpc_decoder_decode_batch_c(). */
+
+  srsran_ldpc_decoder_stats_t stats; /*!< \brief Decoding statistics. */
+
   void (*free)(void*); /*!< \brief Pointer to a "destructor". */
 
   int (*decode_f)(void*,
@@ -99,6 +127,13 @@ typedef struct SRSRAN_API {
                   uint8_t*,
                   uint32_t,
                   srsran_crc_t*); /*!< \brief Pointer to the decoding function (16-bit version). */
+  int (*decode_batch_c)(void*,
+                        int8_t**,
+                        uint8_t**,
+                        uint32_t,
+                        uint32_t,
+                        srsran_crc_t*,
+                        int*); /*!< \brief Pointer to the decoding function of packed codeblocks (8-bit version). */
 } srsran_ldpc_decoder_t;
 
 /*!
@@ -171,7 +206,8 @@ srsran_ldpc_decoder_decode_c(srsran_ldpc_decoder_t* q, const int8_t* llrs, uint8
  *    operation.
  * \param[in] cdwd_rm_length The number of bits forming the codeword (after rate matching).
  * \param[in,out] crc Code-block CRC object for early stop. Set for NULL to disable check
- * \return -1 if an error occurred, the number of used iterations, and 0 if CRC is provided and did not match
+ * \return -1 if an error occurred, the number of used iterations, and 0 if CRC is provided and did not match (or, with
+ * no CRC and the syndrome early stop enabled, if the syndrome is not zero after the last iteration)
  */
 SRSRAN_API int srsran_ldpc_decoder_decode_crc_c(srsran_ldpc_decoder_t* q,
                                                 const int8_t*          llrs,
@@ -179,4 +215,34 @@ SRSRAN_API int srsran_ldpc_decoder_decode_crc_c(srsran_ldpc_decoder_t* q,
                                                 uint32_t               cdwd_rm_length,
                                                 srsran_crc_t*          crc);
 
+/*!
+ * Decodes several codeblocks with 8-bit integer-valued LLRs. All of them share the base graph and the lifting size of
+ * the decoder, and the rate-matched length. When the lifting size is small, the AVX2 decoder packs up to
+ * \ref srsran_ldpc_decoder_t::batch_size codeblocks in its registers and decodes them at once; the rest of decoders,
+ * and the AVX2 decoder with larger lifting sizes, decode one codeblock at a time. Every codeblock stops iterating as
+ * soon as it meets the stopping criterion, but a packed decoding runs until all its codeblocks do.
+ * \param[in] q A pointer to the LDPC decoder (a srsran_ldpc_decoder_t structure
+ *    instance) that carries out the decoding.
+ * \param[in] llrs The LLRs of each codeblock, as in srsran_ldpc_decoder_decode_crc_c().
+ * \param[out] messages The decoded message of each codeblock.
+ * \param[in] nof_cb The number of codeblocks.
+ * \param[in] cdwd_rm_length The number of bits forming the codewords (after rate matching).
+ * \param[in,out] crc Code-block CRC object for early stop. Set for NULL to disable check
+ * \param[out] nof_iter The result of each codeblock, as returned by srsran_ldpc_decoder_decode_crc_c().
+ * \return 0 if the function executes correctly, -1 otherwise.
+ */
+SRSRAN_API int srsran_ldpc_decoder_decode_batch_c(srsran_ldpc_decoder_t* q,
+                                                  int8_t**               llrs,
+                                                  uint8_t**              messages,
+                                                  uint32_t               nof_cb,
+                                                  uint32_t               cdwd_rm_length,
+                                                  srsran_crc_t*          crc,
+                                                  int*                   nof_iter);
+
+/*!
+ * Clears the decoding statistics of the decoder.
+ * \param[in,out] q A pointer to the LDPC decoder.
+ */
+SRSRAN_API void srsran_ldpc_decoder_reset_stats(srsran_ldpc_decoder_t* q);
+
 #endif // SRSRAN_LDPCDECODER_H
@@ -37,6 +37,11 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/*!
+ * \brief Maximum list size of the Simplified Successive Cancellation List (SSCL) decoders.
+ */
+#define SRSRAN_POLAR_DECODER_MAX_LIST_SIZE 8
+
 /*!
  * Lists the different types of polar decoder.
  */
@@ -45,15 +50,22 @@ typedef enum SRSRAN_API {
   SRSRAN_POLAR_DECODER_SSC_S = 1, /*!< \brief Fixed-point (16 bit) Simplified Successive Cancellation (SSC) decoder. */
   SRSRAN_POLAR_DECODER_SSC_C = 2, /*!< \brief Fixed-point (8 bit) Simplified Successive Cancellation (SSC) decoder. */
   SRSRAN_POLAR_DECODER_SSC_C_AVX2 =
-      3 /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation (SSC) decoder. */
+      3, /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation (SSC) decoder. */
+  SRSRAN_POLAR_DECODER_SSCL2_C_AVX2 =
+      4, /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation List (SSCL) decoder, L = 2. */
+  SRSRAN_POLAR_DECODER_SSCL4_C_AVX2 =
+      5, /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation List (SSCL) decoder, L = 4. */
+  SRSRAN_POLAR_DECODER_SSCL8_C_AVX2 =
+      6 /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation List (SSCL) decoder, L = 8. */
 } srsran_polar_decoder_type_t;
 
 /*!
  * \brief Describes a polar decoder.
  */
 typedef struct SRSRAN_API {
-  void*   ptr;  /*!< \brief Pointer to the actual polar decoder structure. */
-  uint8_t nMax; /*!< \brief Maximum \f$log_2(code_size)\f$. */
+  void*   ptr;       /*!< \brief Pointer to the actual polar decoder structure. */
+  uint8_t nMax;      /*!< \brief Maximum \f$log_2(code_size)\f$. */
+  uint8_t list_size; /*!< \brief Number of candidates returned by the list decoder, 1 for the SSC decoders. */
   int (*decode_f)(void*           ptr,
                   const float*    symbols,
                   uint8_t*        data_decoded,
@@ -72,6 +84,12 @@ typedef struct SRSRAN_API {
                   const uint8_t   n,
                   const uint16_t* frozen_set,
                   const uint16_t  frozen_set_size); /*!< \brief Pointer to the decoder function (8-bit version). */
+  int (*decode_list_c)(void*           ptr,
+                       const int8_t*   symbols,
+                       uint8_t**       data_decoded,
+                       const uint8_t   n,
+                       const uint16_t* frozen_set,
+                       const uint16_t  frozen_set_size); /*!< \brief Pointer to the list decoder function (8-bit). */
   void (*free)(void*);                             /*!< \brief Pointer to a "destructor". */
 } srsran_polar_decoder_t;
 
@@ -145,4 +163,23 @@ SRSRAN_API int srsran_polar_decoder_decode_c(srsran_polar_decoder_t* q,
                                              const uint16_t*         frozen_set,
                                              const uint16_t          frozen_set_size);
 
+/*!
+ * Decodes the input (int8_t) codeword with the specified polar decoder and returns all the surviving candidates of
+ * the list, sorted from the most to the least likely one. The caller is expected to pick the first candidate that
+ * passes the CRC check (CRC-aided list decoding). Decoders without a list return their only candidate.
+ * \param[in] q A pointer to the desired polar decoder.
+ * \param[in] input_llr The decoder LLR input vector.
+ * \param[out] data_decoded Array of \a q->list_size pointers to the decoder output vectors.
+ * \param[in] code_size_log The \f$ log_2\f$ of the number of bits of the decoder input/output vector.
+ * \param[in] frozen_set The position of the frozen bits in increasing order.
+ * \param[in] frozen_set_size The size of the frozen_set.
+ * \return The number of candidates written in \a data_decoded if the function executes correctly, -1 otherwise.
+ */
+SRSRAN_API int srsran_polar_decoder_decode_list_c(srsran_polar_decoder_t* q,
+                                                  const int8_t*           input_llr,
+                                                  uint8_t**               data_decoded,
+                                                  const uint8_t           code_size_log,
+                                                  const uint16_t*         frozen_set,
+                                                  const uint16_t          frozen_set_size);
+
 #endif // SRSRAN_POLARDECODER_H
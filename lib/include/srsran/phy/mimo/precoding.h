@@ -95,6 +95,40 @@ SRSRAN_API int srsran_predecoding_diversity_multi(cf_t*  y[SRSRAN_MAX_PORTS],
                                                   int    nof_symbols,
                                                   float  scaling);
 
+/* Estimates the vectors "x" of up to 4 layers received with nof_rxant >= nof_layers antennas, h[layer][rxant] is the
+ * effective channel of every layer (precoding included). Uses the decoder selected with
+ * srsran_predecoding_set_mimo_decoder(). If sinr is not NULL, the linear post-equalisation SINR of every layer and RE
+ * is written in sinr[layer].
+ */
+SRSRAN_API int srsran_predecoding_mimo(cf_t*  y[SRSRAN_MAX_PORTS],
+                                       cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                       cf_t*  x[SRSRAN_MAX_LAYERS],
+                                       float* sinr[SRSRAN_MAX_LAYERS],
+                                       int    nof_rxant,
+                                       int    nof_layers,
+                                       int    nof_symbols,
+                                       float  scaling,
+                                       float  noise_estimate);
+
+/* Computes the equaliser weights w[layer][rxant] of srsran_predecoding_mimo() for every RE, so that they can be applied
+ * with srsran_predecoding_mimo_apply() to all the OFDM symbols that share the same channel estimate.
+ */
+SRSRAN_API int srsran_predecoding_mimo_weights(cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                               cf_t*  w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                                               float* sinr[SRSRAN_MAX_LAYERS],
+                                               int    nof_rxant,
+                                               int    nof_layers,
+                                               int    nof_symbols,
+                                               float  scaling,
+                                               float  noise_estimate);
+
+SRSRAN_API int srsran_predecoding_mimo_apply(cf_t* y[SRSRAN_MAX_PORTS],
+                                             cf_t* w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                                             cf_t* x[SRSRAN_MAX_LAYERS],
+                                             int   nof_rxant,
+                                             int   nof_layers,
+                                             int   nof_symbols);
+
 SRSRAN_API void srsran_predecoding_set_mimo_decoder(srsran_mimo_decoder_t _mimo_decoder);
 
 SRSRAN_API int srsran_predecoding_type(cf_t*              y[SRSRAN_MAX_PORTS],
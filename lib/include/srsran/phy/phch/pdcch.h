@@ -47,6 +47,23 @@
 
 typedef enum SRSRAN_API { SEARCH_UE, SEARCH_COMMON } srsran_pdcch_search_mode_t;
 
+#define SRSRAN_PDCCH_MAX_DECODED_MSG 48
+
+/* Viterbi output of a location, reused by the candidates of the subframe with the same location and size */
+typedef struct SRSRAN_API {
+  srsran_dci_location_t location;
+  uint32_t              nof_bits;
+  uint16_t              crc_rem;
+  uint8_t               payload[SRSRAN_DCI_MAX_BITS];
+} srsran_pdcch_decoded_msg_t;
+
+typedef struct SRSRAN_API {
+  uint64_t nof_candidates; // Number of candidates given to srsran_pdcch_decode_msg()
+  uint64_t nof_decoded;    // Number of candidates that ran the Viterbi decoder
+  uint64_t nof_skipped;    // Number of candidates rejected by the CCE LLR energy pre-screen
+  uint64_t nof_reused;     // Number of candidates that reused the decoding of the same location and size
+} srsran_pdcch_metrics_t;
+
 /* PDCCH object */
 typedef struct SRSRAN_API {
   srsran_cell_t cell;
@@ -73,6 +90,12 @@ typedef struct SRSRAN_API {
   srsran_viterbi_t     decoder;
   srsran_crc_t         crc;
 
+  /* decoding state of the current subframe, reset by srsran_pdcch_extract_llr() */
+  float*                     cce_mean_llr; // Mean absolute LLR of every CCE, negative until computed
+  srsran_pdcch_decoded_msg_t decoded_msg[SRSRAN_PDCCH_MAX_DECODED_MSG];
+  uint32_t                   nof_decoded_msg;
+  srsran_pdcch_metrics_t     metrics;
+
 } srsran_pdcch_t;
 
 SRSRAN_API int srsran_pdcch_init_ue(srsran_pdcch_t* q, uint32_t max_prb, uint32_t nof_rx_antennas);
@@ -112,6 +135,8 @@ srsran_pdcch_decode_msg(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dci_cf
  */
 SRSRAN_API float srsran_pdcch_msg_corr(srsran_pdcch_t* q, srsran_dci_msg_t* msg);
 
+SRSRAN_API void srsran_pdcch_get_metrics(srsran_pdcch_t* q, srsran_pdcch_metrics_t* metrics);
+
 SRSRAN_API int
 srsran_pdcch_dci_decode(srsran_pdcch_t* q, float* e, uint8_t* data, uint32_t E, uint32_t nof_bits, uint16_t* crc);
 
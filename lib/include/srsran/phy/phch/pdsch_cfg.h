@@ -32,6 +32,7 @@
 
 #include "srsran/phy/fec/cbsegm.h"
 #include "srsran/phy/fec/softbuffer.h"
+#include "srsran/phy/phch/phch_meas_time.h"
 #include "srsran/phy/phch/ra.h"
 
 typedef struct SRSRAN_API {
@@ -65,9 +66,10 @@ typedef struct SRSRAN_API {
     srsran_softbuffer_rx_t* rx[SRSRAN_MAX_CODEWORDS];
   } softbuffers;
 
-  bool     meas_evm_en;
-  bool     meas_time_en;
-  uint32_t meas_time_value;
+  bool                    meas_evm_en;
+  bool                    meas_time_en;
+  uint32_t                meas_time_value;
+  srsran_phch_meas_time_t meas_time_stages; ///< Time in each stage of the last decode, if meas_time_en
 } srsran_pdsch_cfg_t;
 
 #endif // SRSRAN_PDSCH_CFG_H
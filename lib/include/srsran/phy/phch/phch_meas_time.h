@@ -0,0 +1,51 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         phch_meas_time.h
+ *
+ *  Description:  Processing time of the stages of the LTE shared channel decoders,
+ *                measured when meas_time_en is set in the PDSCH/PUSCH configuration
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSRAN_PHCH_MEAS_TIME_H
+#define SRSRAN_PHCH_MEAS_TIME_H
+
+#include "srsran/config.h"
+#include <stdint.h>
+#include <time.h>
+
+typedef struct SRSRAN_API {
+  uint64_t equalizer_ns; ///< Resource element extraction, equalization/predecoding, layer demapping and DFT despreading
+  uint64_t demod_ns;     ///< Soft demodulation and descrambling
+  uint64_t decode_ns;    ///< Rate dematching, channel decoding and CRC check, including UCI in the PUSCH
+} srsran_phch_meas_time_t;
+
+static inline uint64_t srsran_phch_meas_time_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+#endif // SRSRAN_PHCH_MEAS_TIME_H
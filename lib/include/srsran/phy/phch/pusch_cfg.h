@@ -23,6 +23,7 @@
 #define SRSRAN_PUSCH_CFG_H
 
 #include "srsran/phy/fec/softbuffer.h"
+#include "srsran/phy/phch/phch_meas_time.h"
 #include "srsran/phy/phch/ra.h"
 #include "srsran/phy/phch/uci_cfg.h"
 
@@ -76,8 +77,9 @@ typedef struct SRSRAN_API {
     srsran_softbuffer_rx_t* rx;
   } softbuffers;
 
-  bool     meas_time_en;
-  uint32_t meas_time_value;
+  bool                    meas_time_en;
+  uint32_t                meas_time_value;
+  srsran_phch_meas_time_t meas_time_stages; ///< Time in each stage of the last decode, if meas_time_en
 
   bool meas_epre_en;
   bool meas_ta_en;
@@ -33,6 +33,7 @@
 #include "srsran/config.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/fec_pool.h"
 #include "srsran/phy/fec/turbo/rm_turbo.h"
 #include "srsran/phy/fec/turbo/turbocoder.h"
 #include "srsran/phy/fec/turbo/turbodecoder.h"
@@ -71,6 +72,12 @@ typedef struct SRSRAN_API {
 
   srsran_uci_cqi_pusch_t uci_cqi;
 
+  /* Optional pool for decoding the codeblocks in parallel, it is not owned by this object */
+  srsran_fec_pool_t* fec_pool;
+
+  /* Decoding time of each codeblock of the last transport block, in microseconds */
+  uint32_t cb_time_us[SRSRAN_MAX_CODEBLOCKS];
+
 } srsran_sch_t;
 
 SRSRAN_API int srsran_sch_init(srsran_sch_t* q);
@@ -81,6 +88,20 @@ SRSRAN_API void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 
 SRSRAN_API float srsran_sch_last_noi(srsran_sch_t* q);
 
+/**
+ * @brief Creates a FEC pool whose threads hold the turbo decoder and CRC objects for decoding LTE SCH codeblocks
+ * @param pool FEC pool object
+ * @param nof_workers Number of threads
+ * @return SRSRAN_SUCCESS if the pool is created, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_sch_fec_pool_init(srsran_fec_pool_t* pool, uint32_t nof_workers);
+
+/**
+ * @brief Sets a pool created with srsran_sch_fec_pool_init() for decoding the codeblocks of a transport block in
+ * parallel. Set it to NULL for decoding in the calling thread
+ */
+SRSRAN_API void srsran_sch_set_fec_pool(srsran_sch_t* q, srsran_fec_pool_t* pool);
+
 SRSRAN_API int srsran_dlsch_encode(srsran_sch_t* q, srsran_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSRAN_API int srsran_dlsch_encode2(srsran_sch_t*       q,
@@ -33,6 +33,7 @@
 #include "srsran/config.h"
 #include "srsran/phy/common/phy_common_nr.h"
 #include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/fec_pool.h"
 #include "srsran/phy/fec/ldpc/ldpc_decoder.h"
 #include "srsran/phy/fec/ldpc/ldpc_encoder.h"
 #include "srsran/phy/fec/ldpc/ldpc_rm.h"
@@ -76,6 +77,12 @@ typedef struct SRSRAN_API {
   /// LDPC Rate matcher
   srsran_ldpc_rm_t tx_rm;
   srsran_ldpc_rm_t rx_rm;
+
+  /// Optional pool for decoding the codeblocks in parallel, it is not owned by this object
+  srsran_fec_pool_t* fec_pool;
+
+  /// Decoding time of each codeblock of the last transport block, in microseconds
+  uint32_t cb_time_us[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
 } srsran_sch_nr_t;
 
 /**
@@ -159,6 +166,25 @@ SRSRAN_API int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_arg
  */
 SRSRAN_API int srsran_sch_nr_set_carrier(srsran_sch_nr_t* q, const srsran_carrier_nr_t* carrier);
 
+/**
+ * @brief Creates a FEC pool whose threads hold the LDPC decoder, rate matching and CRC objects for decoding NR SCH
+ * codeblocks
+ * @param pool FEC pool object
+ * @param nof_workers Number of threads
+ * @param args Decoder arguments, they shall match the ones of the SCH objects that use the pool
+ * @return SRSRAN_SUCCESS if the pool is created, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int
+srsran_sch_nr_fec_pool_init(srsran_fec_pool_t* pool, uint32_t nof_workers, const srsran_sch_nr_args_t* args);
+
+/**
+ * @brief Sets a pool created with srsran_sch_nr_fec_pool_init() for decoding the codeblocks of a transport block in
+ * parallel
+ * @param q Points ats the SCH object
+ * @param pool FEC pool object, NULL for decoding in the calling thread
+ */
+SRSRAN_API void srsran_sch_nr_set_fec_pool(srsran_sch_nr_t* q, srsran_fec_pool_t* pool);
+
 /**
  * @brief Free allocated resources used by an SCH intance
  * @param q Points ats the SCH object
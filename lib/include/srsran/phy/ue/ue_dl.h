@@ -74,6 +74,14 @@ typedef struct SRSRAN_API {
   uint32_t              nof_formats;
 } dci_blind_search_t;
 
+/* UE-specific search space of an RNTI, it only depends on the number of CCE and the subframe index */
+typedef struct SRSRAN_API {
+  uint16_t              rnti;
+  uint32_t              nof_cce;
+  uint32_t              nof_locations;
+  srsran_dci_location_t loc[SRSRAN_MAX_CANDIDATES_UE];
+} srsran_ue_dl_ss_cache_t;
+
 typedef struct SRSRAN_API {
   // Cell configuration
   srsran_cell_t cell;
@@ -102,6 +110,9 @@ typedef struct SRSRAN_API {
   cf_t*              sf_symbols[SRSRAN_MAX_PORTS];
   dci_blind_search_t current_ss_common;
 
+  // UE-specific search spaces for every CFI and subframe, reused across frames
+  srsran_ue_dl_ss_cache_t ue_ss_cache[3][SRSRAN_NOF_SF_X_FRAME];
+
   srsran_dci_msg_t pending_ul_dci_msg[SRSRAN_MAX_DCI_MSG];
   uint32_t         pending_ul_dci_count;
 
@@ -180,6 +191,10 @@ SRSRAN_API int srsran_ue_dl_decode_fft_estimate_noguru(srsran_ue_dl_t*     q,
                                                        srsran_ue_dl_cfg_t* cfg,
                                                        cf_t*               input[SRSRAN_MAX_PORTS]);
 
+/* Channel estimation, CFI decoding and PDCCH LLR extraction on the subframe symbols already in the object, for callers
+ * that run the FFT themselves */
+SRSRAN_API int srsran_ue_dl_estimate(srsran_ue_dl_t* q, srsran_dl_sf_cfg_t* sf, srsran_ue_dl_cfg_t* cfg);
+
 /* Finds UL/DL DCI in the signal processed in a previous call to decode_fft_estimate() */
 SRSRAN_API int srsran_ue_dl_find_ul_dci(srsran_ue_dl_t*     q,
                                         srsran_dl_sf_cfg_t* sf,
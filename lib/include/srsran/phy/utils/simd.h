@@ -569,6 +569,27 @@ static inline simd_f_t srsran_simd_f_abs(simd_f_t a)
 #endif /* LV_HAVE_AVX512 */
 }
 
+static inline simd_f_t srsran_simd_f_round(simd_f_t a)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  /* Round half away from zero, adds 0.5 with the sign of a and truncates */
+  float32x4_t half = vbslq_f32(vdupq_n_u32(0x80000000), a, vdupq_n_f32(0.5f));
+  return vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(a, half)));
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
 static inline void srsran_simd_f_fprintf(FILE* stream, simd_f_t a)
 {
   float x[SRSRAN_SIMD_F_SIZE];
@@ -1584,6 +1605,44 @@ static inline simd_s_t srsran_simd_s_sub(simd_s_t a, simd_s_t b)
 #endif /* LV_HAVE_AVX512 */
 }
 
+static inline simd_s_t srsran_simd_s_set1(int16_t x)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_set1_epi16(x);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_set1_epi16(x);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_set1_epi16(x);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  return vdupq_n_s16(x);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline simd_s_t srsran_simd_s_max(simd_s_t a, simd_s_t b)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_max_epi16(a, b);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_max_epi16(a, b);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_max_epi16(a, b);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  return vmaxq_s16(a, b);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
 #endif /* SRSRAN_SIMD_S_SIZE */
 
 #if SRSRAN_SIMD_C16_SIZE
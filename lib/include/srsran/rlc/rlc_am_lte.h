@@ -189,7 +189,7 @@ private:
   bool inside_rx_window(const int16_t sn);
   void debug_state();
   void print_rx_segments();
-  bool add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu* segment);
+  bool add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu_segment* segment);
   void reset_status();
 
   rlc_am*           parent = nullptr;
@@ -222,7 +222,10 @@ private:
 
   // Rx windows
   rlc_ringbuffer_t<rlc_amd_rx_pdu, RLC_AM_WINDOW_SIZE> rx_window;
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>        rx_segments;
+
+  // Segments of the PDUs partially received, indexed by SN. The pool must outlive the segments window
+  rlc_amd_rx_segment_pool                                         rx_segment_pool;
+  rlc_ringbuffer_t<rlc_amd_rx_pdu_segments_t, RLC_AM_WINDOW_SIZE> rx_segments;
 
   bool              poll_received = false;
   std::atomic<bool> do_status     = {false}; // light-weight access from Tx entity
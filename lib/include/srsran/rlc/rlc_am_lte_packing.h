@@ -25,7 +25,7 @@
 #include "srsran/common/string_helpers.h"
 #include "srsran/rlc/rlc_am_base.h"
 #include "srsran/rlc/rlc_am_data_structs.h" // required for rlc_am_pdu_segment
-#include <list>
+#include <deque>
 
 namespace srsran {
 
@@ -43,8 +43,102 @@ struct rlc_amd_rx_pdu {
   explicit rlc_amd_rx_pdu(uint32_t rlc_sn_) : rlc_sn(rlc_sn_) {}
 };
 
+class rlc_amd_rx_segment_pool;
+
+/// Received segment of a RLC AMD PDU. The buffer keeps the segment header in front of the data, so that the LIs only
+/// get unpacked once all the segments of the PDU have been received
+struct rlc_amd_rx_pdu_segment : public intrusive_forward_list_element<> {
+  unique_byte_buffer_t buf;
+  uint32_t             so          = 0;
+  uint32_t             payload_len = 0;
+  bool                 lsf         = false;
+
+  uint8_t* payload() const { return buf->msg + buf->N_bytes - payload_len; }
+
+  /// Frees the buffer and returns the segment to its pool. The segment must not be in a list
+  void release();
+
+private:
+  friend class rlc_amd_rx_segment_pool;
+  rlc_amd_rx_segment_pool* parent_pool = nullptr;
+};
+
+/// Segments shared by all the PDUs of the RX window of a RLC AM entity. They are only created when the RX window
+/// needs more of them than it ever did, and are then reused, so an entity that never receives segmented PDUs does not
+/// pay for them. Each stored segment also holds a byte buffer, hence the pool is bounded by the default size of the
+/// byte buffer pool
+class rlc_amd_rx_segment_pool
+{
+public:
+  const static size_t MAX_POOL_SIZE = 4096;
+
+  rlc_amd_rx_segment_pool()                               = default;
+  rlc_amd_rx_segment_pool(const rlc_amd_rx_segment_pool&) = delete;
+  rlc_amd_rx_segment_pool(rlc_amd_rx_segment_pool&&)      = delete;
+  rlc_amd_rx_segment_pool& operator=(const rlc_amd_rx_segment_pool&) = delete;
+  rlc_amd_rx_segment_pool& operator=(rlc_amd_rx_segment_pool&&) = delete;
+
+  /// Returns nullptr if all the segments are in use
+  rlc_amd_rx_pdu_segment* allocate()
+  {
+    if (not free_list.empty()) {
+      nof_free--;
+      return free_list.pop_front();
+    }
+    if (segments.size() == MAX_POOL_SIZE) {
+      return nullptr;
+    }
+    // std::deque does not move the existing elements when it grows
+    segments.emplace_back();
+    segments.back().parent_pool = this;
+    return &segments.back();
+  }
+  size_t nof_free_segments() const { return nof_free + MAX_POOL_SIZE - segments.size(); }
+
+private:
+  friend struct rlc_amd_rx_pdu_segment;
+  void deallocate(rlc_amd_rx_pdu_segment* segment)
+  {
+    segment->buf.reset();
+    free_list.push_front(segment);
+    nof_free++;
+  }
+
+  intrusive_forward_list<rlc_amd_rx_pdu_segment> free_list;
+  size_t                                         nof_free = 0;
+  std::deque<rlc_amd_rx_pdu_segment>             segments;
+};
+
+inline void rlc_amd_rx_pdu_segment::release()
+{
+  parent_pool->deallocate(this);
+}
+
+/// Segments received for a RLC AMD PDU, sorted by segment offset. They are returned to the pool on destruction
 struct rlc_amd_rx_pdu_segments_t {
-  std::list<rlc_amd_rx_pdu> segments;
+  intrusive_forward_list<rlc_amd_rx_pdu_segment> segments;
+  uint32_t                                       rlc_sn = 0;
+
+  rlc_amd_rx_pdu_segments_t() = default;
+  explicit rlc_amd_rx_pdu_segments_t(uint32_t rlc_sn_) : rlc_sn(rlc_sn_) {}
+  rlc_amd_rx_pdu_segments_t(rlc_amd_rx_pdu_segments_t&& other) noexcept = default;
+  rlc_amd_rx_pdu_segments_t& operator=(rlc_amd_rx_pdu_segments_t&& other) noexcept
+  {
+    if (this != &other) {
+      clear();
+      segments = std::move(other.segments);
+      rlc_sn   = other.rlc_sn;
+    }
+    return *this;
+  }
+  ~rlc_amd_rx_pdu_segments_t() { clear(); }
+
+  void clear()
+  {
+    while (not segments.empty()) {
+      segments.pop_front()->release();
+    }
+  }
 };
 
 /****************************************************************************
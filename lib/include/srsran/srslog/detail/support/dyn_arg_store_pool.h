@@ -24,6 +24,7 @@
 
 #include "srsran/srslog/bundled/fmt/printf.h"
 #include "srsran/srslog/detail/support/backend_capacity.h"
+#include "srsran/srslog/detail/support/work_queue.h"
 
 namespace srslog {
 
@@ -41,23 +42,15 @@ public:
     for (auto& elem : pool) {
       // Reserve for 10 normal and 2 named arguments.
       elem.reserve(10, 2);
-    }
-    free_list.reserve(SRSLOG_QUEUE_CAPACITY);
-    for (auto& elem : pool) {
-      free_list.push_back(&elem);
+      free_list.push(&elem);
     }
   }
 
   /// Returns a pointer to a free dyn arg store object, otherwise returns nullptr.
   fmt::dynamic_format_arg_store<fmt::printf_context>* alloc()
   {
-    scoped_lock lock(m);
-    if (free_list.empty()) {
-      return nullptr;
-    }
-
-    auto* p = free_list.back();
-    free_list.pop_back();
+    fmt::dynamic_format_arg_store<fmt::printf_context>* p = nullptr;
+    free_list.try_pop(&p, 1);
 
     return p;
   }
@@ -70,14 +63,13 @@ public:
     }
 
     p->clear();
-    scoped_lock lock(m);
-    free_list.push_back(p);
+    free_list.push(p);
   }
 
 private:
   std::vector<fmt::dynamic_format_arg_store<fmt::printf_context> > pool;
-  std::vector<fmt::dynamic_format_arg_store<fmt::printf_context>*> free_list;
-  mutable mutex                                                    m;
+  /// Lock free, as objects are allocated by the logging threads and returned by the backend.
+  work_queue<fmt::dynamic_format_arg_store<fmt::printf_context>*> free_list;
 };
 
 } // namespace detail
@@ -22,26 +22,82 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 #define SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 
-#include "srsran/adt/circular_buffer.h"
 #include "srsran/srslog/detail/support/backend_capacity.h"
-#include "srsran/srslog/detail/support/thread_utils.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
 
 namespace srslog {
 
 namespace detail {
 
-//: TODO: this is a temp work queue.
-
 /// Thread safe generic data type work queue.
+/// Lock free bounded ring, where each slot holds a sequence number that tells
+/// producers and consumers when the slot may be written or read (D. Vyukov's
+/// bounded MPMC queue). Producers and consumers only contend on their own
+/// position counter, each in a separate cache line. The backend uses it with
+/// multiple producers and a single consumer.
+/// NOTE: The capacity gets rounded up to the next power of two.
 template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
 class work_queue
 {
-  srsran::dyn_circular_buffer<T> queue;
-  mutable mutex                  m;
-  static constexpr size_t        threshold = capacity * 0.98;
+  static constexpr size_t cache_line_size = 64;
+
+  static constexpr size_t round_up_pow2(size_t value, size_t pow2 = 1)
+  {
+    return (pow2 >= value) ? pow2 : round_up_pow2(value, pow2 * 2);
+  }
+
+  static constexpr size_t size      = round_up_pow2(capacity);
+  static constexpr size_t mask      = size - 1;
+  static constexpr size_t threshold = size * 0.98;
+
+  struct slot {
+    std::atomic<size_t> sequence;
+    T                   value;
+  };
+
+  /// Position counter padded to fill a whole cache line.
+  struct padded_position {
+    std::atomic<size_t> value;
+    char                padding[cache_line_size - sizeof(std::atomic<size_t>)];
+  };
+
+  padded_position         enqueue_pos;
+  padded_position         dequeue_pos;
+  std::unique_ptr<slot[]> slots;
+
+  /// Reserves a slot for writing. Returns nullptr when the queue is full.
+  slot* acquire_write_slot(size_t& pos)
+  {
+    pos = enqueue_pos.value.load(std::memory_order_relaxed);
+    while (true) {
+      slot*     s    = &slots[pos & mask];
+      size_t    seq  = s->sequence.load(std::memory_order_acquire);
+      ptrdiff_t diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return s;
+        }
+      } else if (diff < 0) {
+        // The slot has not been read yet since the last lap.
+        return nullptr;
+      } else {
+        pos = enqueue_pos.value.load(std::memory_order_relaxed);
+      }
+    }
+  }
 
 public:
-  work_queue() : queue(capacity) {}
+  work_queue() : slots(new slot[size])
+  {
+    enqueue_pos.value.store(0, std::memory_order_relaxed);
+    dequeue_pos.value.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i != size; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
 
   work_queue(const work_queue&) = delete;
   work_queue& operator=(const work_queue&) = delete;
@@ -50,30 +106,30 @@ public:
   /// queue is full, otherwise true.
   bool push(const T& value)
   {
-    m.lock();
+    size_t pos;
+    slot*  s = acquire_write_slot(pos);
     // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
+    if (!s) {
       return false;
     }
-    queue.push(value);
-    m.unlock();
+    s->value = value;
+    s->sequence.store(pos + 1, std::memory_order_release);
 
     return true;
   }
 
   /// Inserts a new element into the back of the queue. Returns false when the
-  /// queue is full, otherwise true.
+  /// queue is full, otherwise true. The value is left untouched on failure.
   bool push(T&& value)
   {
-    m.lock();
+    size_t pos;
+    slot*  s = acquire_write_slot(pos);
     // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
+    if (!s) {
       return false;
     }
-    queue.push(std::move(value));
-    m.unlock();
+    s->value = std::move(value);
+    s->sequence.store(pos + 1, std::memory_order_release);
 
     return true;
   }
@@ -82,32 +138,56 @@ public:
   /// Returns a pair with a bool indicating if the pop has been successful.
   std::pair<bool, T> try_pop()
   {
-    m.lock();
-
-    if (queue.empty()) {
-      m.unlock();
+    T item;
+    if (try_pop(&item, 1) == 0) {
       return {false, T()};
     }
+    return {true, std::move(item)};
+  }
 
-    // Here we have been woken up normally.
-    T Item = std::move(queue.top());
-    queue.pop();
-
-    m.unlock();
-
-    return {true, std::move(Item)};
+  /// Extracts up to max_items elements from the front of the queue into the
+  /// specified array, in a single operation. Returns the number of extracted
+  /// elements.
+  size_t try_pop(T* items, size_t max_items)
+  {
+    size_t pos = dequeue_pos.value.load(std::memory_order_relaxed);
+    while (true) {
+      // Count the consecutive slots that have been completely written.
+      size_t count = 0;
+      for (; count != max_items; ++count) {
+        size_t seq = slots[(pos + count) & mask].sequence.load(std::memory_order_acquire);
+        if (seq != pos + count + 1) {
+          break;
+        }
+      }
+      if (count == 0) {
+        return 0;
+      }
+      if (dequeue_pos.value.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+        for (size_t i = 0; i != count; ++i) {
+          slot& s  = slots[(pos + i) & mask];
+          items[i] = std::move(s.value);
+          // Hand the slot over to the producers of the next lap.
+          s.sequence.store(pos + i + size, std::memory_order_release);
+        }
+        return count;
+      }
+    }
   }
 
   /// Capacity of the queue.
-  size_t get_capacity() const { return capacity; }
+  size_t get_capacity() const { return size; }
 
-  /// Returns true when the queue is almost full, otherwise returns false.
-  bool is_almost_full() const
+  /// Approximate number of elements in the queue.
+  size_t get_size() const
   {
-    scoped_lock lock(m);
-
-    return queue.size() > threshold;
+    size_t tail = dequeue_pos.value.load(std::memory_order_relaxed);
+    size_t head = enqueue_pos.value.load(std::memory_order_relaxed);
+    return (head > tail) ? head - tail : 0;
   }
+
+  /// Returns true when the queue is almost full, otherwise returns false.
+  bool is_almost_full() const { return get_size() > threshold; }
 };
 
 } // namespace detail
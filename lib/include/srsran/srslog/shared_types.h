@@ -40,6 +40,18 @@ enum class backend_priority {
   very_high
 };
 
+/// Backend behaviour when its queue of log entries is full.
+enum class backend_overflow_policy {
+  /// New log entries get discarded.
+  discard,
+  /// New log entries get discarded, and the number of discarded entries is
+  /// periodically reported through the error handler.
+  discard_and_count,
+  /// The logging thread waits until there is space in the queue. Log entries
+  /// never get lost, at the cost of stalling the logging threads.
+  block
+};
+
 /// syslog log local types
 enum class syslog_local_type {
   local0,
@@ -254,6 +254,14 @@ void flush();
 /// NOTE: This function should be called before init() and is NOT thread safe.
 void set_error_handler(error_handler handler);
 
+/// Selects the behaviour of the framework when log entries are generated faster
+/// than they can be processed. By default new entries get discarded.
+void set_overflow_policy(backend_overflow_policy policy);
+
+/// Returns the total number of log entries that have been discarded as the
+/// backend was full, regardless of the overflow policy.
+uint64_t get_nof_discarded_entries();
+
 } // namespace srslog
 
 #endif // SRSLOG_SRSLOG_H
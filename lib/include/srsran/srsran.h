@@ -70,6 +70,7 @@ extern "C" {
 #include "srsran/phy/fec/convolutional/rm_conv.h"
 #include "srsran/phy/fec/convolutional/viterbi.h"
 #include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/fec_pool.h"
 #include "srsran/phy/fec/turbo/rm_turbo.h"
 #include "srsran/phy/fec/turbo/tc_interl.h"
 #include "srsran/phy/fec/turbo/turbocoder.h"
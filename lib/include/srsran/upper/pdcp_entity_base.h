@@ -169,6 +169,12 @@ protected:
 
   srsran::as_security_config_t sec_cfg = {};
 
+  // AES-128 key schedules and CMAC subkeys for EEA2/EIA2, computed once in config_security()
+  security_aes128_ctx_t aes_rrc_enc = {};
+  security_aes128_ctx_t aes_up_enc  = {};
+  security_aes128_ctx_t aes_rrc_int = {};
+  security_aes128_ctx_t aes_up_int  = {};
+
   // Security functions
   void integrity_generate(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
   bool integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
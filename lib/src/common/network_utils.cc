@@ -21,10 +21,14 @@
 
 #include "srsran/common/network_utils.h"
 
+#include <array>
+#include <limits>
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
-#include <unistd.h> // for the pipe
+#include <unistd.h>
 
 #define rxSockError(fmt, ...) logger.error("RxSockets: " fmt, ##__VA_ARGS__)
 #define rxSockWarn(fmt, ...) logger.warning("RxSockets: " fmt, ##__VA_ARGS__)
@@ -395,199 +399,256 @@ bool unique_socket::sctp_set_init_msg_opts(int max_init_attempts, int max_init_t
  *                 Rx Multisocket Handler
  **************************************************************/
 
-socket_manager::socket_manager() : thread("RXsockets"), socket_manager_itf(srslog::fetch_basic_logger("COMN"))
+/**
+ * Thread that waits for IO on a subset of the sockets of the socket_manager, and calls their handlers
+ */
+class socket_manager::rx_thread final : public thread
 {
-  // register control pipe fd
-  int fd = pipe(pipefd);
-  srsran_assert(fd != -1, "Failed to open control pipe");
-  start(thread_prio);
-}
+public:
+  rx_thread(srslog::basic_logger& logger_, const std::string& name_) : thread(name_), logger(logger_) {}
+  ~rx_thread() final { stop(); }
 
-socket_manager::~socket_manager()
-{
-  stop();
-}
+  bool init(int prio)
+  {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+      rxSockError("Failed to create epoll instance: %s", strerror(errno));
+      return false;
+    }
+    // used to unlock epoll_wait on exit
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd < 0) {
+      rxSockError("Failed to create control eventfd: %s", strerror(errno));
+      return false;
+    }
+    epoll_event ev = {};
+    ev.events      = EPOLLIN;
+    ev.data.u64    = ctrl_event_id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &ev) < 0) {
+      rxSockError("Failed to register control eventfd: %s", strerror(errno));
+      return false;
+    }
+    running = true;
+    if (not start(prio)) {
+      running = false;
+      return false;
+    }
+    return true;
+  }
 
-void socket_manager::stop()
-{
-  if (running) {
-    // close thread
-    {
-      std::lock_guard<std::mutex> lock(socket_mutex);
-      ctrl_cmd_t                  msg;
-      msg.cmd = ctrl_cmd_t::cmd_id_t::EXIT;
-      if (write(pipefd[1], &msg, sizeof(msg)) != sizeof(msg)) {
-        rxSockError("while writing to control pipe");
+  void stop()
+  {
+    if (running) {
+      running         = false;
+      uint64_t wakeup = 1;
+      if (write(event_fd, &wakeup, sizeof(wakeup)) != sizeof(wakeup)) {
+        rxSockError("while writing to control eventfd");
       }
+      rxSockDebug("Closing rx socket handler thread");
+      wait_thread_finish();
+    }
+    if (event_fd >= 0) {
+      close(event_fd);
+      event_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+      close(epoll_fd);
+      epoll_fd = -1;
+      rxSockDebug("closed.");
     }
-    rxSockDebug("Closing rx socket handler thread");
-    wait_thread_finish();
   }
 
-  if (pipefd[0] >= 0) {
-    close(pipefd[0]);
-    close(pipefd[1]);
-    pipefd[0] = -1;
-    pipefd[1] = -1;
-    rxSockDebug("closed.");
+  bool add(int fd, recv_callback_t handler)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t                    gen = next_gen++;
+
+    // The generation prevents an event of a removed fd from reaching a new socket that reuses the same fd number
+    epoll_event ev = {};
+    ev.events      = EPOLLIN;
+    ev.data.u64    = ((uint64_t)gen << 32U) | (uint32_t)fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      rxSockError("Failed to register fd=%d in epoll: %s", fd, strerror(errno));
+      return false;
+    }
+    active_sockets.emplace(fd, socket_entry{std::move(handler), gen});
+    nof_sockets = active_sockets.size();
+    return true;
   }
-}
 
-bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
-{
-  std::lock_guard<std::mutex> lock(socket_mutex);
-  if (fd < 0) {
-    rxSockError("Provided SCTP socket must be already open");
-    return false;
+  /// Once this returns, the handler of the fd is not running and it won't be called again
+  bool remove(int fd)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return remove_unprotected(fd);
   }
-  if (active_sockets.count(fd) > 0) {
-    rxSockError("Tried to register fd=%d, but this fd already exists", fd);
-    return false;
+
+  bool contains(int fd)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return active_sockets.count(fd) > 0;
   }
 
-  active_sockets.insert(std::make_pair(fd, std::move(handler)));
+  size_t size() const { return nof_sockets.load(std::memory_order_relaxed); }
 
-  // this unlocks the reading thread to add new connections
-  ctrl_cmd_t msg;
-  msg.cmd    = ctrl_cmd_t::cmd_id_t::NEW_FD;
-  msg.new_fd = fd;
-  if (write(pipefd[1], &msg, sizeof(msg)) != sizeof(msg)) {
-    rxSockError("while writing to control pipe");
-    return false;
-  }
+  void run_thread() override
+  {
+    std::array<epoll_event, max_events> events;
 
-  rxSockDebug("socket fd=%d has been registered.", fd);
-  return true;
-}
+    while (running.load(std::memory_order_relaxed)) {
+      int n = epoll_wait(epoll_fd, events.data(), (int)events.size(), -1);
 
-bool socket_manager::remove_socket_nonblocking(int fd, bool signal_completion)
-{
-  std::lock_guard<std::mutex> lock(socket_mutex);
-  auto                        it = active_sockets.find(fd);
-  if (it == active_sockets.end()) {
-    rxSockWarn("The socket fd=%d to be removed does not exist", fd);
-    return false;
+      // handle epoll_wait return
+      if (n == -1) {
+        if (errno != EINTR) {
+          rxSockError("Error from epoll_wait: %s. Number of rx sockets: %zd", strerror(errno), size());
+        }
+        continue;
+      }
+
+      // Shared state area
+      std::lock_guard<std::mutex> lock(mutex);
+
+      // call read callback for all SCTP/TCP/UDP connections
+      for (int i = 0; i < n; ++i) {
+        if (events[i].data.u64 == ctrl_event_id) {
+          // exit was requested, running is already false
+          continue;
+        }
+        int  fd = (int)(uint32_t)events[i].data.u64;
+        auto it = active_sockets.find(fd);
+        if (it == active_sockets.end() or it->second.gen != (uint32_t)(events[i].data.u64 >> 32U)) {
+          // the socket was removed after epoll_wait returned
+          continue;
+        }
+        bool socket_valid = it->second.callback(fd);
+        if (not socket_valid) {
+          rxSockInfo("The socket fd=%d has been closed by peer", fd);
+          remove_unprotected(fd);
+        }
+      }
+    }
   }
 
-  ctrl_cmd_t msg;
-  msg.cmd                = ctrl_cmd_t::cmd_id_t::RM_FD;
-  msg.new_fd             = fd;
-  msg.signal_rm_complete = signal_completion;
-  if (write(pipefd[1], &msg, sizeof(msg)) != sizeof(msg)) {
-    rxSockError("while writing to control pipe");
-    return false;
+private:
+  const static uint64_t ctrl_event_id = std::numeric_limits<uint64_t>::max();
+  const static size_t   max_events    = 64;
+
+  struct socket_entry {
+    recv_callback_t callback;
+    uint32_t        gen;
+  };
+
+  bool remove_unprotected(int fd)
+  {
+    auto it = active_sockets.find(fd);
+    if (it == active_sockets.end()) {
+      return false;
+    }
+    // the fd may already be closed, in which case the kernel already removed it from the epoll set
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    active_sockets.erase(it);
+    nof_sockets = active_sockets.size();
+    rxSockDebug("Socket fd=%d has been successfully removed", fd);
+    return true;
   }
-  return true;
+
+  srslog::basic_logger& logger;
+
+  std::mutex                  mutex;
+  std::map<int, socket_entry> active_sockets;
+  std::atomic<size_t>         nof_sockets = {0};
+  uint32_t                    next_gen    = 0;
+  std::atomic<bool>           running     = {false};
+  int                         epoll_fd    = -1;
+  int                         event_fd    = -1;
+};
+
+socket_manager::socket_manager(uint32_t nof_rx_threads) : socket_manager_itf(srslog::fetch_basic_logger("COMN"))
+{
+  bool ret = set_nof_rx_threads(std::max(nof_rx_threads, 1U));
+  srsran_assert(ret, "Failed to start rx socket threads");
 }
 
-bool socket_manager::remove_socket(int fd)
+socket_manager::~socket_manager()
 {
-  bool result = remove_socket_nonblocking(fd, true);
+  stop();
+}
 
-  // block waiting for socket removal
-  if (result) {
-    std::unique_lock<std::mutex> lock(socket_mutex);
-    while (std::count(rem_fd_tmp_list.begin(), rem_fd_tmp_list.end(), fd) == 0) {
-      rem_cvar.wait(lock);
-    }
-    rem_fd_tmp_list.erase(std::find(rem_fd_tmp_list.begin(), rem_fd_tmp_list.end(), fd));
+void socket_manager::stop()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (std::unique_ptr<rx_thread>& t : rx_threads) {
+    t->stop();
   }
-  return result;
 }
 
-std::map<int, socket_manager::recv_callback_t>::iterator
-socket_manager::remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd)
+bool socket_manager::set_nof_rx_threads(uint32_t nof_rx_threads)
 {
-  if (fd < 0) {
-    rxSockError("fd to be removed is not valid");
-    return active_sockets.end();
+  std::lock_guard<std::mutex> lock(mutex);
+  while (rx_threads.size() < nof_rx_threads) {
+    std::string name = rx_threads.empty() ? "RXsockets" : fmt::format("RXsockets{}", rx_threads.size());
+    std::unique_ptr<rx_thread> t(new rx_thread(logger, name));
+    if (not t->init(thread_prio)) {
+      rxSockError("Failed to start rx socket thread %zd", rx_threads.size());
+      return false;
+    }
+    rx_threads.push_back(std::move(t));
   }
-  auto it = active_sockets.find(fd);
-  it      = active_sockets.erase(it);
-  FD_CLR(fd, total_fd_set);
-  // assumes ordering
-  *max_fd = (active_sockets.empty()) ? pipefd[0] : std::max(pipefd[0], active_sockets.rbegin()->first);
-  rxSockDebug("Socket fd=%d has been successfully removed", fd);
-  return it;
+  return true;
 }
 
-void socket_manager::run_thread()
+uint32_t socket_manager::get_nof_rx_threads()
 {
-  running = true;
-  fd_set total_fd_set, read_fd_set;
-  FD_ZERO(&total_fd_set);
-  int max_fd = 0;
-
-  FD_SET(pipefd[0], &total_fd_set);
-  max_fd = std::max(pipefd[0], max_fd);
-
-  while (running.load(std::memory_order_relaxed)) {
-    memcpy(&read_fd_set, &total_fd_set, sizeof(total_fd_set));
-    int n = select(max_fd + 1, &read_fd_set, nullptr, nullptr, nullptr);
+  std::lock_guard<std::mutex> lock(mutex);
+  return rx_threads.size();
+}
 
-    // handle select return
-    if (n == -1) {
-      rxSockError("Error from select(%d,...). Number of rx sockets: %d", max_fd + 1, (int)active_sockets.size() + 1);
-      continue;
-    }
-    if (n == 0) {
-      rxSockDebug("No data from select.");
-      continue;
+bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (fd < 0) {
+    rxSockError("Provided SCTP socket must be already open");
+    return false;
+  }
+  for (std::unique_ptr<rx_thread>& t : rx_threads) {
+    if (t->contains(fd)) {
+      rxSockError("Tried to register fd=%d, but this fd already exists", fd);
+      return false;
     }
+  }
 
-    // Shared state area
-    std::lock_guard<std::mutex> lock(socket_mutex);
-
-    // call read callback for all SCTP/TCP/UDP connections
-    for (auto handler_it = active_sockets.begin(); handler_it != active_sockets.end();) {
-      int              fd       = handler_it->first;
-      recv_callback_t& callback = handler_it->second;
-      if (not FD_ISSET(fd, &read_fd_set)) {
-        ++handler_it;
-        continue;
-      }
-      bool socket_valid = callback(fd);
-      if (not socket_valid) {
-        rxSockInfo("The socket fd=%d has been closed by peer", fd);
-        handler_it = remove_socket_unprotected(fd, &total_fd_set, &max_fd);
-      } else {
-        ++handler_it;
-      }
+  // shard the sockets over the rx threads
+  size_t chosen = 0;
+  for (size_t i = 1; i < rx_threads.size(); ++i) {
+    if (rx_threads[i]->size() < rx_threads[chosen]->size()) {
+      chosen = i;
     }
+  }
+  if (rx_threads.empty() or not rx_threads[chosen]->add(fd, std::move(handler))) {
+    return false;
+  }
 
-    // handle ctrl messages
-    if (FD_ISSET(pipefd[0], &read_fd_set)) {
-      ctrl_cmd_t msg;
-      ssize_t    nrd = read(pipefd[0], &msg, sizeof(msg));
-      if (nrd <= 0) {
-        rxSockError("Unable to read control message.");
-        continue;
-      }
-      switch (msg.cmd) {
-        case ctrl_cmd_t::cmd_id_t::EXIT:
-          running = false;
-          return;
-        case ctrl_cmd_t::cmd_id_t::NEW_FD:
-          if (msg.new_fd >= 0) {
-            FD_SET(msg.new_fd, &total_fd_set);
-            max_fd = std::max(max_fd, msg.new_fd);
-          } else {
-            rxSockError("added fd is not valid");
-          }
-          break;
-        case ctrl_cmd_t::cmd_id_t::RM_FD:
-          remove_socket_unprotected(msg.new_fd, &total_fd_set, &max_fd);
-          if (msg.signal_rm_complete) {
-            rem_fd_tmp_list.push_back(msg.new_fd);
-            rem_cvar.notify_one();
-          }
-          rxSockDebug("Socket fd=%d has been successfully removed", msg.new_fd);
-          break;
-        default:
-          rxSockError("ctrl message command %d is not valid", (int)msg.cmd);
-      }
+  rxSockDebug("socket fd=%d has been registered in rx thread %zd.", fd, chosen);
+  return true;
+}
+
+bool socket_manager::remove_socket_nonblocking(int fd, bool signal_completion)
+{
+  // epoll allows removing the socket right away, so there is nothing to wait for
+  std::lock_guard<std::mutex> lock(mutex);
+  for (std::unique_ptr<rx_thread>& t : rx_threads) {
+    if (t->remove(fd)) {
+      return true;
     }
   }
+  rxSockWarn("The socket fd=%d to be removed does not exist", fd);
+  return false;
+}
+
+bool socket_manager::remove_socket(int fd)
+{
+  return remove_socket_nonblocking(fd, true);
 }
 
 /***************************************************************
@@ -650,55 +711,101 @@ make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& q
 
 /**
  * Description: Functor for the case the received data is
- * in the form of unique_byte_buffer, and a recvfrom(...) call is used
+ * in the form of unique_byte_buffer, and a recvmmsg(...) call is used to read several datagrams at once
  */
 class recvfrom_pdu_task
 {
 public:
   using callback_t = recvfrom_callback_t;
-  explicit recvfrom_pdu_task(srslog::basic_logger& logger, srsran::task_queue_handle& queue_, callback_t func_) :
-    logger(logger), queue(queue_), func(std::move(func_))
+  explicit recvfrom_pdu_task(srslog::basic_logger&      logger,
+                             srsran::task_queue_handle& queue_,
+                             callback_t                 func_,
+                             uint32_t                   max_batch) :
+    logger(logger), queue(queue_), func(std::move(func_)), rx_batch(new batch_t(std::max(max_batch, 1U)))
   {}
 
   bool operator()(int fd)
   {
-    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-    if (pdu == nullptr) {
+    batch_t& batch = *rx_batch;
+
+    // Only allocate the buffers expected to be filled, nothing is kept from one call to the next
+    uint32_t nof_bufs = 0;
+    for (; nof_bufs < batch.nof_bufs_next; ++nof_bufs) {
+      srsran::unique_byte_buffer_t& pdu = batch.pdus[nof_bufs];
+      pdu                               = srsran::make_byte_buffer();
+      if (pdu == nullptr) {
+        break;
+      }
+      batch.iovs[nof_bufs].iov_base            = pdu->msg;
+      batch.iovs[nof_bufs].iov_len             = pdu->get_tailroom();
+      batch.msgs[nof_bufs].msg_hdr             = {};
+      batch.msgs[nof_bufs].msg_hdr.msg_name    = &batch.from[nof_bufs];
+      batch.msgs[nof_bufs].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      batch.msgs[nof_bufs].msg_hdr.msg_iov     = &batch.iovs[nof_bufs];
+      batch.msgs[nof_bufs].msg_hdr.msg_iovlen  = 1;
+    }
+    if (nof_bufs == 0) {
       logger.error("Unable to allocate byte buffer");
       return true;
     }
-    sockaddr_in from    = {};
-    socklen_t   fromlen = sizeof(from);
 
-    ssize_t n_recv = recvfrom(fd, pdu->msg, pdu->get_tailroom(), 0, (struct sockaddr*)&from, &fromlen);
+    // The first datagram is already available, only take the ones that are queued without blocking
+    int n_recv = recvmmsg(fd, batch.msgs.data(), nof_bufs, MSG_DONTWAIT, nullptr);
     if (n_recv == -1 and errno != EAGAIN) {
       logger.error("Error reading from socket: %s", strerror(errno));
-      return true;
-    }
-    if (n_recv == -1 and errno == EAGAIN) {
+    } else if (n_recv == -1 and errno == EAGAIN) {
       logger.debug("Socket timeout reached");
-      return true;
     }
+    n_recv = std::max(n_recv, 0);
 
-    pdu->N_bytes = static_cast<uint32_t>(n_recv);
+    for (int i = 0; i < n_recv; ++i) {
+      srsran::unique_byte_buffer_t pdu  = std::move(batch.pdus[i]);
+      sockaddr_in                  from = batch.from[i];
+      pdu->N_bytes                      = batch.msgs[i].msg_len;
 
-    // Defer handling of received packet to provided queue
-    queue.push(
-        std::bind([this, from](srsran::unique_byte_buffer_t& sdu) { func(std::move(sdu), from); }, std::move(pdu)));
+      // Defer handling of received packet to provided queue
+      queue.push(
+          std::bind([this, from](srsran::unique_byte_buffer_t& sdu) { func(std::move(sdu), from); }, std::move(pdu)));
+    }
+
+    // Give the unused buffers back to the pool
+    for (uint32_t i = n_recv; i < nof_bufs; ++i) {
+      batch.pdus[i].reset();
+    }
+
+    // Grow the batch while it fills up, otherwise shrink it to what was received
+    if (static_cast<uint32_t>(n_recv) == nof_bufs) {
+      batch.nof_bufs_next = std::min(2 * nof_bufs, static_cast<uint32_t>(batch.pdus.size()));
+    } else {
+      batch.nof_bufs_next = std::max(static_cast<uint32_t>(n_recv), 1U);
+    }
 
     return true;
   }
 
 private:
+  // Kept in the heap, so the iovecs and headers are not invalidated when the task is moved
+  struct batch_t {
+    explicit batch_t(uint32_t size) : pdus(size), msgs(size), iovs(size), from(size) {}
+    uint32_t                                  nof_bufs_next = 1;
+    std::vector<srsran::unique_byte_buffer_t> pdus;
+    std::vector<mmsghdr>                      msgs;
+    std::vector<iovec>                        iovs;
+    std::vector<sockaddr_in>                  from;
+  };
+
   srslog::basic_logger&      logger;
   srsran::task_queue_handle& queue;
   callback_t                 func;
+  std::unique_ptr<batch_t>   rx_batch;
 };
 
-socket_manager_itf::recv_callback_t
-make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, recvfrom_callback_t rx_callback)
+socket_manager_itf::recv_callback_t make_sdu_handler(srslog::basic_logger&      logger,
+                                                     srsran::task_queue_handle& queue,
+                                                     recvfrom_callback_t        rx_callback,
+                                                     uint32_t                   max_batch)
 {
-  return socket_manager_itf::recv_callback_t(recvfrom_pdu_task(logger, queue, std::move(rx_callback)));
+  return socket_manager_itf::recv_callback_t(recvfrom_pdu_task(logger, queue, std::move(rx_callback), max_batch));
 }
 
 } // namespace srsran
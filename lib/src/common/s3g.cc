@@ -21,6 +21,11 @@
 
 #include "srsran/common/s3g.h"
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define S3G_HAVE_X8
+#endif
+
 /* S-box SQ */
 static const uint8_t SQ[256] = {
     0x25, 0x24, 0x73, 0x67, 0xD7, 0xAE, 0x5C, 0x30, 0xA4, 0xEE, 0x6E, 0xCB, 0x7D, 0xB5, 0x82, 0xDB, 0xE4, 0x8E, 0x48,
@@ -51,6 +56,15 @@ static const uint8_t S[256] = {
     180, 198, 232, 221, 116, 31,  75,  189, 139, 138, 112, 62,  181, 102, 72,  3,   246, 14,  97,  53,  87,  185,
     134, 193, 29,  158, 225, 248, 152, 17,  105, 217, 142, 148, 155, 30,  135, 233, 206, 85,  40,  223, 140, 161,
     137, 13,  191, 230, 66,  104, 65,  153, 45,  15,  176, 84,  187, 22};
+typedef struct {
+  uint32_t mul_alpha[256];
+  uint32_t div_alpha[256];
+  uint32_t s1[4][256];
+  uint32_t s2[4][256];
+} s3g_tables_t;
+
+static const s3g_tables_t& s3g_get_tables();
+
 /*********************************************************************
     Name: s3g_mul_x
 
@@ -194,6 +208,57 @@ uint8_t s3g_mul_x_pow(uint8_t v, uint8_t i, uint8_t c)
     return s3g_mul_x(s3g_mul_x_pow(v, i - 1, c), c);
 }
 
+/*********************************************************************
+    Name: s3g_mix_column
+
+    Description: MixColumn step of the S-Boxes S1 and S2, applied to
+                 the already substituted bytes w0..w3.
+
+    Document Reference: Specification of the 3GPP Confidentiality and
+                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
+                            Section 3.3
+*********************************************************************/
+static uint32_t s3g_mix_column(uint8_t w0, uint8_t w1, uint8_t w2, uint8_t w3, uint8_t c)
+{
+  uint8_t r0 = s3g_mul_x(w0, c) ^ w1 ^ w2 ^ s3g_mul_x(w3, c) ^ w3;
+  uint8_t r1 = s3g_mul_x(w0, c) ^ w0 ^ s3g_mul_x(w1, c) ^ w2 ^ w3;
+  uint8_t r2 = w0 ^ s3g_mul_x(w1, c) ^ w1 ^ s3g_mul_x(w2, c) ^ w3;
+  uint8_t r3 = w0 ^ w1 ^ s3g_mul_x(w2, c) ^ w2 ^ s3g_mul_x(w3, c);
+
+  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) | (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+}
+
+/*********************************************************************
+    Name: s3g_get_tables
+
+    Description: Lookup tables of MULalpha, DIValpha and of the S-Boxes
+                 S1 and S2 (one table per input byte, the MixColumn
+                 step being linear). Built once, on first use.
+*********************************************************************/
+static const s3g_tables_t& s3g_get_tables()
+{
+  static const s3g_tables_t tables = []() {
+    s3g_tables_t t = {};
+    for (uint32_t x = 0; x < 256; x++) {
+      uint8_t c      = (uint8_t)x;
+      t.mul_alpha[x] = ((((uint32_t)s3g_mul_x_pow(c, 23, 0xa9)) << 24) | (((uint32_t)s3g_mul_x_pow(c, 245, 0xa9)) << 16) |
+                        (((uint32_t)s3g_mul_x_pow(c, 48, 0xa9)) << 8) | (((uint32_t)s3g_mul_x_pow(c, 239, 0xa9))));
+      t.div_alpha[x] = ((((uint32_t)s3g_mul_x_pow(c, 16, 0xa9)) << 24) | (((uint32_t)s3g_mul_x_pow(c, 39, 0xa9)) << 16) |
+                        (((uint32_t)s3g_mul_x_pow(c, 6, 0xa9)) << 8) | (((uint32_t)s3g_mul_x_pow(c, 64, 0xa9))));
+      t.s1[0][x] = s3g_mix_column(S[x], 0, 0, 0, 0x1b);
+      t.s1[1][x] = s3g_mix_column(0, S[x], 0, 0, 0x1b);
+      t.s1[2][x] = s3g_mix_column(0, 0, S[x], 0, 0x1b);
+      t.s1[3][x] = s3g_mix_column(0, 0, 0, S[x], 0x1b);
+      t.s2[0][x] = s3g_mix_column(SQ[x], 0, 0, 0, 0x69);
+      t.s2[1][x] = s3g_mix_column(0, SQ[x], 0, 0, 0x69);
+      t.s2[2][x] = s3g_mix_column(0, 0, SQ[x], 0, 0x69);
+      t.s2[3][x] = s3g_mix_column(0, 0, 0, SQ[x], 0x69);
+    }
+    return t;
+  }();
+  return tables;
+}
+
 /*********************************************************************
     Name: s3g_mul_alpha
 
@@ -205,8 +270,7 @@ uint8_t s3g_mul_x_pow(uint8_t v, uint8_t i, uint8_t c)
 *********************************************************************/
 uint32_t s3g_mul_alpha(uint8_t c)
 {
-  return ((((uint32_t)s3g_mul_x_pow(c, 23, 0xa9)) << 24) | (((uint32_t)s3g_mul_x_pow(c, 245, 0xa9)) << 16) |
-          (((uint32_t)s3g_mul_x_pow(c, 48, 0xa9)) << 8) | (((uint32_t)s3g_mul_x_pow(c, 239, 0xa9))));
+  return s3g_get_tables().mul_alpha[c];
 }
 
 /*********************************************************************
@@ -220,8 +284,7 @@ uint32_t s3g_mul_alpha(uint8_t c)
 *********************************************************************/
 uint32_t s3g_div_alpha(uint8_t c)
 {
-  return ((((uint32_t)s3g_mul_x_pow(c, 16, 0xa9)) << 24) | (((uint32_t)s3g_mul_x_pow(c, 39, 0xa9)) << 16) |
-          (((uint32_t)s3g_mul_x_pow(c, 6, 0xa9)) << 8) | (((uint32_t)s3g_mul_x_pow(c, 64, 0xa9))));
+  return s3g_get_tables().div_alpha[c];
 }
 
 /*********************************************************************
@@ -235,21 +298,8 @@ uint32_t s3g_div_alpha(uint8_t c)
 *********************************************************************/
 uint32_t s3g_s1(uint32_t w)
 {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t srw0 = S[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t srw1 = S[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t srw2 = S[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t srw3 = S[(uint8_t)((w)&0xff)];
-
-  r0 = ((s3g_mul_x(srw0, 0x1b)) ^ (srw1) ^ (srw2) ^ ((s3g_mul_x(srw3, 0x1b)) ^ srw3));
-
-  r1 = (((s3g_mul_x(srw0, 0x1b)) ^ srw0) ^ (s3g_mul_x(srw1, 0x1b)) ^ (srw2) ^ (srw3));
-
-  r2 = ((srw0) ^ ((s3g_mul_x(srw1, 0x1b)) ^ srw1) ^ (s3g_mul_x(srw2, 0x1b)) ^ (srw3));
-
-  r3 = ((srw0) ^ (srw1) ^ ((s3g_mul_x(srw2, 0x1b)) ^ srw2) ^ (s3g_mul_x(srw3, 0x1b)));
-
-  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) | (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+  const s3g_tables_t& t = s3g_get_tables();
+  return t.s1[0][(w >> 24) & 0xff] ^ t.s1[1][(w >> 16) & 0xff] ^ t.s1[2][(w >> 8) & 0xff] ^ t.s1[3][w & 0xff];
 }
 
 /*********************************************************************
@@ -263,21 +313,8 @@ uint32_t s3g_s1(uint32_t w)
 *********************************************************************/
 uint32_t s3g_s2(uint32_t w)
 {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t sqw0 = SQ[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t sqw1 = SQ[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t sqw2 = SQ[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t sqw3 = SQ[(uint8_t)((w)&0xff)];
-
-  r0 = ((s3g_mul_x(sqw0, 0x69)) ^ (sqw1) ^ (sqw2) ^ ((s3g_mul_x(sqw3, 0x69)) ^ sqw3));
-
-  r1 = (((s3g_mul_x(sqw0, 0x69)) ^ sqw0) ^ (s3g_mul_x(sqw1, 0x69)) ^ (sqw2) ^ (sqw3));
-
-  r2 = ((sqw0) ^ ((s3g_mul_x(sqw1, 0x69)) ^ sqw1) ^ (s3g_mul_x(sqw2, 0x69)) ^ (sqw3));
-
-  r3 = ((sqw0) ^ (sqw1) ^ ((s3g_mul_x(sqw2, 0x69)) ^ sqw2) ^ (s3g_mul_x(sqw3, 0x69)));
-
-  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) | (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+  const s3g_tables_t& t = s3g_get_tables();
+  return t.s2[0][(w >> 24) & 0xff] ^ t.s2[1][(w >> 16) & 0xff] ^ t.s2[2][(w >> 8) & 0xff] ^ t.s2[3][w & 0xff];
 }
 
 /*********************************************************************
@@ -337,9 +374,6 @@ void s3g_initialize(S3G_STATE* state, uint32_t k[4], uint32_t iv[4])
   uint8_t  i = 0;
   uint32_t f = 0x0;
 
-  state->lfsr = (uint32_t*)calloc(16, sizeof(uint32_t));
-  state->fsm  = (uint32_t*)calloc(3, sizeof(uint32_t));
-
   state->lfsr[15] = k[3] ^ iv[0];
   state->lfsr[14] = k[2];
   state->lfsr[13] = k[1];
@@ -377,8 +411,7 @@ void s3g_initialize(S3G_STATE* state, uint32_t k[4], uint32_t iv[4])
 *********************************************************************/
 void s3g_deinitialize(S3G_STATE* state)
 {
-  free(state->lfsr);
-  free(state->fsm);
+  // The state is not dynamically allocated, nothing to release
 }
 
 /*********************************************************************
@@ -454,9 +487,11 @@ uint64_t s3g_MUL64(uint64_t V, uint64_t P, uint64_t c)
   uint64_t result = 0;
   int      i      = 0;
 
+  // MUL64xPOW(V, i, c) computed incrementally, one MUL64x per bit of P
   for (i = 0; i < 64; i++) {
     if ((P >> i) & 0x1)
-      result ^= s3g_MUL64xPOW(V, i, c);
+      result ^= V;
+    V = s3g_MUL64x(V, c);
   }
   return result;
 }
@@ -565,4 +600,139 @@ uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir
     MAC_I[i] = ((EVAL >> (56 - (i * 8))) ^ (z[4] >> (24 - (i * 8)))) & 0xff;
 
   return MAC_I;
-}
\ No newline at end of file
+}
+/*********************************************************************
+    8-lane SNOW 3G, one instance per 32-bit lane of an AVX2 register.
+    The table lookups of the FSM and of the LFSR feedback are done
+    with gathers.
+*********************************************************************/
+#ifdef S3G_HAVE_X8
+
+bool s3g_x8_supported()
+{
+  return __builtin_cpu_supports("avx2");
+}
+
+__attribute__((target("avx2"))) static inline __m256i s3g_lookup_x8(const uint32_t (*t)[256], __m256i w)
+{
+  const __m256i mask = _mm256_set1_epi32(0xff);
+  __m256i       r    = _mm256_i32gather_epi32((const int*)t[0], _mm256_srli_epi32(w, 24), 4);
+  r = _mm256_xor_si256(r, _mm256_i32gather_epi32((const int*)t[1], _mm256_and_si256(_mm256_srli_epi32(w, 16), mask), 4));
+  r = _mm256_xor_si256(r, _mm256_i32gather_epi32((const int*)t[2], _mm256_and_si256(_mm256_srli_epi32(w, 8), mask), 4));
+  r = _mm256_xor_si256(r, _mm256_i32gather_epi32((const int*)t[3], _mm256_and_si256(w, mask), 4));
+  return r;
+}
+
+/* Clocks the FSM and then the LFSR. f is XORed into the feedback during
+ * initialization only. Returns the FSM output F.
+ */
+__attribute__((target("avx2"))) static inline __m256i
+s3g_clock_x8(const s3g_tables_t& t, __m256i* lfsr, __m256i* fsm, bool init_mode)
+{
+  // FSM
+  __m256i f = _mm256_xor_si256(_mm256_add_epi32(lfsr[15], fsm[0]), fsm[1]);
+  __m256i r = _mm256_add_epi32(fsm[1], _mm256_xor_si256(fsm[2], lfsr[5]));
+  fsm[2]    = s3g_lookup_x8(t.s2, fsm[1]);
+  fsm[1]    = s3g_lookup_x8(t.s1, fsm[0]);
+  fsm[0]    = r;
+
+  // LFSR
+  const __m256i mask = _mm256_set1_epi32(0xff);
+  __m256i       v    = _mm256_xor_si256(_mm256_slli_epi32(lfsr[0], 8), lfsr[2]);
+  v                  = _mm256_xor_si256(v, _mm256_i32gather_epi32((const int*)t.mul_alpha, _mm256_srli_epi32(lfsr[0], 24), 4));
+  v                  = _mm256_xor_si256(v, _mm256_srli_epi32(lfsr[11], 8));
+  v = _mm256_xor_si256(v, _mm256_i32gather_epi32((const int*)t.div_alpha, _mm256_and_si256(lfsr[11], mask), 4));
+  if (init_mode) {
+    v = _mm256_xor_si256(v, f);
+  }
+  for (uint32_t i = 0; i < 15; i++) {
+    lfsr[i] = lfsr[i + 1];
+  }
+  lfsr[15] = v;
+  return f;
+}
+
+__attribute__((target("avx2"))) void
+s3g_initialize_x8(S3G_STATE_X8* state, const uint32_t k[8][4], const uint32_t iv[8][4])
+{
+  const s3g_tables_t& t = s3g_get_tables();
+
+  // Same initial loading as s3g_initialize(), lane by lane
+  for (uint32_t l = 0; l < 8; l++) {
+    state->lfsr[15][l] = k[l][3] ^ iv[l][0];
+    state->lfsr[14][l] = k[l][2];
+    state->lfsr[13][l] = k[l][1];
+    state->lfsr[12][l] = k[l][0] ^ iv[l][1];
+    state->lfsr[11][l] = k[l][3] ^ 0xffffffff;
+    state->lfsr[10][l] = k[l][2] ^ 0xffffffff ^ iv[l][2];
+    state->lfsr[9][l]  = k[l][1] ^ 0xffffffff ^ iv[l][3];
+    state->lfsr[8][l]  = k[l][0] ^ 0xffffffff;
+    state->lfsr[7][l]  = k[l][3];
+    state->lfsr[6][l]  = k[l][2];
+    state->lfsr[5][l]  = k[l][1];
+    state->lfsr[4][l]  = k[l][0];
+    state->lfsr[3][l]  = k[l][3] ^ 0xffffffff;
+    state->lfsr[2][l]  = k[l][2] ^ 0xffffffff;
+    state->lfsr[1][l]  = k[l][1] ^ 0xffffffff;
+    state->lfsr[0][l]  = k[l][0] ^ 0xffffffff;
+  }
+
+  __m256i lfsr[16];
+  __m256i fsm[3] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+  for (uint32_t i = 0; i < 16; i++) {
+    lfsr[i] = _mm256_load_si256((const __m256i*)state->lfsr[i]);
+  }
+  for (uint32_t i = 0; i < 32; i++) {
+    s3g_clock_x8(t, lfsr, fsm, true);
+  }
+  // Discard the first output, as in s3g_generate_keystream()
+  s3g_clock_x8(t, lfsr, fsm, false);
+
+  for (uint32_t i = 0; i < 16; i++) {
+    _mm256_store_si256((__m256i*)state->lfsr[i], lfsr[i]);
+  }
+  for (uint32_t i = 0; i < 3; i++) {
+    _mm256_store_si256((__m256i*)state->fsm[i], fsm[i]);
+  }
+}
+
+__attribute__((target("avx2"))) void s3g_generate_keystream_x8(S3G_STATE_X8* state, uint32_t n, uint32_t (*ks)[8])
+{
+  const s3g_tables_t& t = s3g_get_tables();
+
+  __m256i lfsr[16];
+  __m256i fsm[3];
+  for (uint32_t i = 0; i < 16; i++) {
+    lfsr[i] = _mm256_load_si256((const __m256i*)state->lfsr[i]);
+  }
+  for (uint32_t i = 0; i < 3; i++) {
+    fsm[i] = _mm256_load_si256((const __m256i*)state->fsm[i]);
+  }
+
+  for (uint32_t i = 0; i < n; i++) {
+    // z = F ^ s0, taken before the LFSR is clocked
+    __m256i s0 = lfsr[0];
+    __m256i f  = s3g_clock_x8(t, lfsr, fsm, false);
+    _mm256_storeu_si256((__m256i*)ks[i], _mm256_xor_si256(f, s0));
+  }
+
+  for (uint32_t i = 0; i < 16; i++) {
+    _mm256_store_si256((__m256i*)state->lfsr[i], lfsr[i]);
+  }
+  for (uint32_t i = 0; i < 3; i++) {
+    _mm256_store_si256((__m256i*)state->fsm[i], fsm[i]);
+  }
+}
+
+#else // S3G_HAVE_X8
+
+bool s3g_x8_supported()
+{
+  return false;
+}
+
+void s3g_initialize_x8(S3G_STATE_X8* state, const uint32_t k[8][4], const uint32_t iv[8][4]) {}
+
+void s3g_generate_keystream_x8(S3G_STATE_X8* state, uint32_t n, uint32_t (*ks)[8]) {}
+
+#endif // S3G_HAVE_X8
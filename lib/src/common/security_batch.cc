@@ -0,0 +1,692 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * Batch versions of the EEA1/EEA2/EEA3 ciphering and EIA2 integrity algorithms.
+ *
+ * EEA2/EIA2 keep the AES-128 key schedule and CMAC subkeys in a context, and
+ * encrypt the blocks of several PDUs at once so that the AES-NI (or VAES)
+ * pipeline stays full. The CMAC chains of several PDUs are interleaved for the
+ * same reason. EEA1/EEA3 run 8 SNOW 3G/ZUC instances in parallel, one per PDU.
+ *****************************************************************************/
+
+#include "srsran/common/liblte_security.h"
+#include "srsran/common/s3g.h"
+#include "srsran/common/security.h"
+#include "srsran/common/ssl.h"
+#include "srsran/common/zuc.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define SECURITY_HAVE_AESNI
+#if !defined(__clang__) && __GNUC__ >= 8
+#define SECURITY_HAVE_VAES
+#endif
+#endif
+
+// Maximum number of AES blocks processed at once (VAES: 8 registers of 2 blocks)
+#define SECURITY_AES128_MAX_LANES 16
+
+// Minimum number of PDUs for which the 8-lane SNOW 3G/ZUC is faster than one PDU at a time
+#define SECURITY_X8_MIN_PDUS 3
+
+namespace srsran {
+
+/******************************************************************************
+ * AES-128 block encryption
+ *****************************************************************************/
+#ifdef SECURITY_HAVE_AESNI
+
+#define AESNI_TARGET __attribute__((target("aes,sse4.1")))
+
+AESNI_TARGET static inline __m128i aesni_expand_step(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, 0xff);
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+#define AESNI_EXPAND(k, rcon) aesni_expand_step(k, _mm_aeskeygenassist_si128(k, rcon))
+
+AESNI_TARGET static void aesni_expand_key(const uint8_t* key, uint8_t (*rk)[16])
+{
+  __m128i k[11];
+  k[0]  = _mm_loadu_si128((const __m128i*)key);
+  k[1]  = AESNI_EXPAND(k[0], 0x01);
+  k[2]  = AESNI_EXPAND(k[1], 0x02);
+  k[3]  = AESNI_EXPAND(k[2], 0x04);
+  k[4]  = AESNI_EXPAND(k[3], 0x08);
+  k[5]  = AESNI_EXPAND(k[4], 0x10);
+  k[6]  = AESNI_EXPAND(k[5], 0x20);
+  k[7]  = AESNI_EXPAND(k[6], 0x40);
+  k[8]  = AESNI_EXPAND(k[7], 0x80);
+  k[9]  = AESNI_EXPAND(k[8], 0x1b);
+  k[10] = AESNI_EXPAND(k[9], 0x36);
+  for (uint32_t i = 0; i < 11; i++) {
+    _mm_store_si128((__m128i*)rk[i], k[i]);
+  }
+}
+
+template <uint32_t N>
+AESNI_TARGET static inline void aesni_encrypt_n(const uint8_t (*rk)[16], const uint8_t (*in)[16], uint8_t (*out)[16])
+{
+  __m128i b[N];
+  __m128i k = _mm_load_si128((const __m128i*)rk[0]);
+  for (uint32_t i = 0; i < N; i++) {
+    b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in[i]), k);
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    k = _mm_load_si128((const __m128i*)rk[r]);
+    for (uint32_t i = 0; i < N; i++) {
+      b[i] = _mm_aesenc_si128(b[i], k);
+    }
+  }
+  k = _mm_load_si128((const __m128i*)rk[10]);
+  for (uint32_t i = 0; i < N; i++) {
+    _mm_storeu_si128((__m128i*)out[i], _mm_aesenclast_si128(b[i], k));
+  }
+}
+
+AESNI_TARGET static void aesni_encrypt(const uint8_t (*rk)[16], const uint8_t (*in)[16], uint8_t (*out)[16], uint32_t n)
+{
+  for (; n >= 8; n -= 8, in += 8, out += 8) {
+    aesni_encrypt_n<8>(rk, in, out);
+  }
+  if (n >= 4) {
+    aesni_encrypt_n<4>(rk, in, out);
+    n -= 4, in += 4, out += 4;
+  }
+  for (; n > 0; n--, in++, out++) {
+    aesni_encrypt_n<1>(rk, in, out);
+  }
+}
+
+// Counter mode over 8 * nof_chunks full blocks. ctr0 is the first counter block, incremented in its last 64 bits
+AESNI_TARGET static void
+aesni_ctr(const uint8_t (*rk)[16], const uint8_t* ctr0, const uint8_t* in, uint8_t* out, uint32_t nof_chunks)
+{
+  const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  __m128i       k[11];
+  for (uint32_t r = 0; r < 11; r++) {
+    k[r] = _mm_load_si128((const __m128i*)rk[r]);
+  }
+  // Byte reversed, so that the block counter is the lower 64-bit lane
+  __m128i ctr = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)ctr0), bswap);
+
+  for (uint32_t c = 0; c < nof_chunks; c++, in += 128, out += 128) {
+    __m128i b[8];
+    for (uint32_t i = 0; i < 8; i++) {
+      b[i] = _mm_xor_si128(_mm_shuffle_epi8(_mm_add_epi64(ctr, _mm_set_epi64x(0, i)), bswap), k[0]);
+    }
+    for (uint32_t r = 1; r < 10; r++) {
+      for (uint32_t i = 0; i < 8; i++) {
+        b[i] = _mm_aesenc_si128(b[i], k[r]);
+      }
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+      b[i] = _mm_aesenclast_si128(b[i], k[10]);
+      _mm_storeu_si128((__m128i*)&out[16 * i], _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i*)&in[16 * i])));
+    }
+    ctr = _mm_add_epi64(ctr, _mm_set_epi64x(0, 8));
+  }
+}
+
+#endif // SECURITY_HAVE_AESNI
+
+#ifdef SECURITY_HAVE_VAES
+
+#define VAES_TARGET __attribute__((target("vaes,aes,avx2")))
+
+// Encrypts 2 * N blocks, two per 256-bit register
+template <uint32_t N>
+VAES_TARGET static inline void vaes_encrypt_n(const uint8_t (*rk)[16], const uint8_t (*in)[16], uint8_t (*out)[16])
+{
+  __m256i b[N];
+  __m256i k = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)rk[0]));
+  for (uint32_t i = 0; i < N; i++) {
+    b[i] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)in[2 * i]), k);
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    k = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)rk[r]));
+    for (uint32_t i = 0; i < N; i++) {
+      b[i] = _mm256_aesenc_epi128(b[i], k);
+    }
+  }
+  k = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)rk[10]));
+  for (uint32_t i = 0; i < N; i++) {
+    _mm256_storeu_si256((__m256i*)out[2 * i], _mm256_aesenclast_epi128(b[i], k));
+  }
+}
+
+VAES_TARGET static void vaes_encrypt(const uint8_t (*rk)[16], const uint8_t (*in)[16], uint8_t (*out)[16], uint32_t n)
+{
+  for (; n >= 16; n -= 16, in += 16, out += 16) {
+    vaes_encrypt_n<8>(rk, in, out);
+  }
+  if (n >= 8) {
+    vaes_encrypt_n<4>(rk, in, out);
+    n -= 8, in += 8, out += 8;
+  }
+  for (; n >= 2; n -= 2, in += 2, out += 2) {
+    vaes_encrypt_n<1>(rk, in, out);
+  }
+  if (n > 0) {
+    aesni_encrypt_n<1>(rk, in, out);
+  }
+}
+
+// Same as aesni_ctr() with 16 * nof_chunks blocks
+VAES_TARGET static void
+vaes_ctr(const uint8_t (*rk)[16], const uint8_t* ctr0, const uint8_t* in, uint8_t* out, uint32_t nof_chunks)
+{
+  const __m256i bswap = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+  __m256i k[11];
+  for (uint32_t r = 0; r < 11; r++) {
+    k[r] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)rk[r]));
+  }
+  // Counters n and n + 1 in each register, byte reversed
+  __m256i ctr = _mm256_add_epi64(_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctr0)), bswap),
+                                 _mm256_set_epi64x(0, 1, 0, 0));
+
+  for (uint32_t c = 0; c < nof_chunks; c++, in += 256, out += 256) {
+    __m256i b[8];
+    for (uint32_t i = 0; i < 8; i++) {
+      b[i] = _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_add_epi64(ctr, _mm256_set_epi64x(0, 2 * i, 0, 2 * i)), bswap),
+                              k[0]);
+    }
+    for (uint32_t r = 1; r < 10; r++) {
+      for (uint32_t i = 0; i < 8; i++) {
+        b[i] = _mm256_aesenc_epi128(b[i], k[r]);
+      }
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+      b[i] = _mm256_aesenclast_epi128(b[i], k[10]);
+      _mm256_storeu_si256((__m256i*)&out[32 * i],
+                          _mm256_xor_si256(b[i], _mm256_loadu_si256((const __m256i*)&in[32 * i])));
+    }
+    ctr = _mm256_add_epi64(ctr, _mm256_set_epi64x(0, 16, 0, 16));
+  }
+}
+
+#endif // SECURITY_HAVE_VAES
+
+static bool aes128_impl_supported(security_aes128_impl_t impl)
+{
+  switch (impl) {
+    case SECURITY_AES128_GENERIC:
+      return true;
+#ifdef SECURITY_HAVE_AESNI
+    case SECURITY_AES128_AESNI:
+      return __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse4.1");
+#endif // SECURITY_HAVE_AESNI
+#ifdef SECURITY_HAVE_VAES
+    case SECURITY_AES128_VAES:
+      return __builtin_cpu_supports("vaes") && __builtin_cpu_supports("aes") && __builtin_cpu_supports("avx2");
+#endif // SECURITY_HAVE_VAES
+    default:
+      return false;
+  }
+}
+
+/// Encrypts blocks with the implementation selected in the context. The generic one expands the key once per batch
+class aes128_engine
+{
+public:
+  explicit aes128_engine(const security_aes128_ctx_t* ctx_) : ctx(ctx_)
+  {
+    if (ctx->impl == SECURITY_AES128_GENERIC) {
+      aes_setkey_enc(&sw_ctx, ctx->key, 128);
+    }
+  }
+
+  uint32_t nof_lanes() const { return ctx->impl == SECURITY_AES128_VAES ? 16 : 8; }
+
+  /// Counter mode over the full nof_lanes() block chunks of nof_blocks. Returns the number of blocks processed
+  uint32_t ctr_bulk(const uint8_t* ctr0, const uint8_t* in, uint8_t* out, uint32_t nof_blocks)
+  {
+    uint32_t nof_chunks = nof_blocks / nof_lanes();
+    switch (ctx->impl) {
+#ifdef SECURITY_HAVE_VAES
+      case SECURITY_AES128_VAES:
+        vaes_ctr(ctx->round_keys, ctr0, in, out, nof_chunks);
+        return nof_chunks * nof_lanes();
+#endif // SECURITY_HAVE_VAES
+#ifdef SECURITY_HAVE_AESNI
+      case SECURITY_AES128_AESNI:
+        aesni_ctr(ctx->round_keys, ctr0, in, out, nof_chunks);
+        return nof_chunks * nof_lanes();
+#endif // SECURITY_HAVE_AESNI
+      default:
+        return 0;
+    }
+  }
+
+  void encrypt(const uint8_t (*in)[16], uint8_t (*out)[16], uint32_t n)
+  {
+    switch (ctx->impl) {
+#ifdef SECURITY_HAVE_VAES
+      case SECURITY_AES128_VAES:
+        vaes_encrypt(ctx->round_keys, in, out, n);
+        break;
+#endif // SECURITY_HAVE_VAES
+#ifdef SECURITY_HAVE_AESNI
+      case SECURITY_AES128_AESNI:
+        aesni_encrypt(ctx->round_keys, in, out, n);
+        break;
+#endif // SECURITY_HAVE_AESNI
+      default:
+        for (uint32_t i = 0; i < n; i++) {
+          aes_crypt_ecb(&sw_ctx, AES_ENCRYPT, in[i], out[i]);
+        }
+        break;
+    }
+  }
+
+private:
+  const security_aes128_ctx_t* ctx;
+  aes_context                  sw_ctx;
+};
+
+// Subkey generation of RFC 4493, section 2.3
+static void cmac_subkey(const uint8_t* in, uint8_t* out)
+{
+  for (uint32_t i = 0; i < 15; i++) {
+    out[i] = (in[i] << 1) | ((in[i + 1] >> 7) & 0x01);
+  }
+  out[15] = in[15] << 1;
+  if (in[0] & 0x80) {
+    out[15] ^= 0x87;
+  }
+}
+
+void security_aes128_init(security_aes128_ctx_t* ctx, const uint8_t* key)
+{
+  memcpy(ctx->key, key, sizeof(ctx->key));
+  if (not security_aes128_set_impl(ctx, SECURITY_AES128_VAES) and
+      not security_aes128_set_impl(ctx, SECURITY_AES128_AESNI)) {
+    security_aes128_set_impl(ctx, SECURITY_AES128_GENERIC);
+  }
+}
+
+bool security_aes128_set_impl(security_aes128_ctx_t* ctx, security_aes128_impl_t impl)
+{
+  if (not aes128_impl_supported(impl)) {
+    return false;
+  }
+  ctx->impl = impl;
+  memset(ctx->round_keys, 0, sizeof(ctx->round_keys));
+#ifdef SECURITY_HAVE_AESNI
+  if (impl != SECURITY_AES128_GENERIC) {
+    aesni_expand_key(ctx->key, ctx->round_keys);
+  }
+#endif // SECURITY_HAVE_AESNI
+
+  // CMAC subkeys, from L = AES(K, 0)
+  const uint8_t zero[1][16] = {};
+  uint8_t       L[1][16];
+  aes128_engine(ctx).encrypt(zero, L, 1);
+  cmac_subkey(L[0], ctx->k1);
+  cmac_subkey(ctx->k1, ctx->k2);
+  return true;
+}
+
+/******************************************************************************
+ * EEA2: AES-128 in counter mode, 33.401 Annex B.1.3
+ *****************************************************************************/
+namespace {
+
+struct ctr_lane_t {
+  const uint8_t* in;
+  uint8_t*       out;
+  uint32_t       len;
+};
+
+} // namespace
+
+static void ctr_flush(aes128_engine&    aes,
+                      const uint8_t (*ctr)[16],
+                      uint8_t (*ks)[16],
+                      const ctr_lane_t* lanes,
+                      uint32_t          nof_lanes)
+{
+  aes.encrypt(ctr, ks, nof_lanes);
+  for (uint32_t l = 0; l < nof_lanes; l++) {
+    if (lanes[l].len == 16) {
+      uint64_t m[2], k[2];
+      memcpy(m, lanes[l].in, 16);
+      memcpy(k, ks[l], 16);
+      m[0] ^= k[0];
+      m[1] ^= k[1];
+      memcpy(lanes[l].out, m, 16);
+    } else {
+      for (uint32_t i = 0; i < lanes[l].len; i++) {
+        lanes[l].out[i] = lanes[l].in[i] ^ ks[l][i];
+      }
+    }
+  }
+}
+
+void security_128_eea2_batch(const security_aes128_ctx_t* ctx,
+                             uint8_t                      bearer,
+                             uint8_t                      direction,
+                             security_pdu_t*              pdus,
+                             uint32_t                     nof_pdus)
+{
+  aes128_engine aes(ctx);
+  uint32_t      max_lanes = aes.nof_lanes();
+
+  // The counter blocks of all the PDUs are queued and encrypted max_lanes at a time
+  alignas(16) uint8_t ctr[SECURITY_AES128_MAX_LANES][16];
+  alignas(16) uint8_t ks[SECURITY_AES128_MAX_LANES][16];
+  ctr_lane_t          lanes[SECURITY_AES128_MAX_LANES];
+  uint32_t            nof_lanes = 0;
+
+  for (uint32_t p = 0; p < nof_pdus; p++) {
+    const security_pdu_t& pdu = pdus[p];
+
+    // COUNT | BEARER | DIRECTION | 0^26, followed by the 64-bit block counter
+    uint8_t nonce[8] = {(uint8_t)(pdu.count >> 24),
+                        (uint8_t)(pdu.count >> 16),
+                        (uint8_t)(pdu.count >> 8),
+                        (uint8_t)(pdu.count),
+                        (uint8_t)(((bearer & 0x1F) << 3) | ((direction & 0x01) << 2)),
+                        0,
+                        0,
+                        0};
+
+    // Full chunks of blocks go straight through the AES pipeline, the rest of the PDU is queued
+    alignas(16) uint8_t ctr0[16] = {};
+    memcpy(ctr0, nonce, 8);
+    uint32_t block  = aes.ctr_bulk(ctr0, pdu.msg, pdu.out, pdu.msg_len / 16);
+    uint32_t offset = 16 * block;
+    for (; offset < pdu.msg_len; offset += 16, block++) {
+      memcpy(ctr[nof_lanes], nonce, 8);
+      memset(&ctr[nof_lanes][8], 0, 4);
+      ctr[nof_lanes][12] = (uint8_t)(block >> 24);
+      ctr[nof_lanes][13] = (uint8_t)(block >> 16);
+      ctr[nof_lanes][14] = (uint8_t)(block >> 8);
+      ctr[nof_lanes][15] = (uint8_t)(block);
+      lanes[nof_lanes]   = {pdu.msg + offset, pdu.out + offset, std::min(16U, pdu.msg_len - offset)};
+      if (++nof_lanes == max_lanes) {
+        ctr_flush(aes, ctr, ks, lanes, nof_lanes);
+        nof_lanes = 0;
+      }
+    }
+  }
+  if (nof_lanes > 0) {
+    ctr_flush(aes, ctr, ks, lanes, nof_lanes);
+  }
+}
+
+/******************************************************************************
+ * EIA2: AES-128 CMAC, 33.401 Annex B.2.3 and RFC 4493
+ *****************************************************************************/
+namespace {
+
+struct cmac_lane_t {
+  security_pdu_t* pdu;
+  uint8_t         hdr[8]; ///< COUNT | BEARER | DIRECTION | 0^26, prepended to the message
+  uint32_t        block;
+  uint32_t        nof_blocks;
+  uint8_t         T[16];
+};
+
+} // namespace
+
+static void cmac_start(cmac_lane_t& lane, security_pdu_t* pdu, uint32_t bearer, uint8_t direction)
+{
+  lane.pdu        = pdu;
+  lane.hdr[0]     = (pdu->count >> 24) & 0xFF;
+  lane.hdr[1]     = (pdu->count >> 16) & 0xFF;
+  lane.hdr[2]     = (pdu->count >> 8) & 0xFF;
+  lane.hdr[3]     = pdu->count & 0xFF;
+  lane.hdr[4]     = (bearer << 3) | (direction << 2);
+  lane.hdr[5]     = 0;
+  lane.hdr[6]     = 0;
+  lane.hdr[7]     = 0;
+  lane.block      = 0;
+  lane.nof_blocks = (pdu->msg_len + 8 + 15) / 16;
+  memset(lane.T, 0, sizeof(lane.T));
+}
+
+// Writes T ^ M_i into x, with the padding and the subkey applied to the last block
+static void cmac_next_input(const security_aes128_ctx_t* ctx, const cmac_lane_t& lane, uint8_t* x)
+{
+  const uint8_t* msg   = lane.pdu->msg;
+  uint32_t       start = 16 * lane.block;
+  uint8_t        m[16];
+
+  if (lane.block + 1 < lane.nof_blocks) {
+    if (lane.block == 0) {
+      memcpy(m, lane.hdr, 8);
+      memcpy(&m[8], msg, 8);
+    } else {
+      memcpy(m, &msg[start - 8], 16);
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+      x[i] = lane.T[i] ^ m[i];
+    }
+  } else {
+    uint32_t rem = lane.pdu->msg_len + 8 - start;
+    memset(m, 0, sizeof(m));
+    for (uint32_t i = 0; i < rem; i++) {
+      m[i] = (start + i < 8) ? lane.hdr[start + i] : msg[start + i - 8];
+    }
+    const uint8_t* subkey = ctx->k1;
+    if (rem < 16) {
+      m[rem] = 0x80;
+      subkey = ctx->k2;
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+      x[i] = lane.T[i] ^ m[i] ^ subkey[i];
+    }
+  }
+}
+
+void security_128_eia2_batch(const security_aes128_ctx_t* ctx,
+                             uint32_t                     bearer,
+                             uint8_t                      direction,
+                             security_pdu_t*              pdus,
+                             uint32_t                     nof_pdus)
+{
+  aes128_engine aes(ctx);
+  uint32_t      max_lanes = aes.nof_lanes();
+
+  // Each lane runs the CMAC chain of one PDU. Lanes are refilled with the next PDU as soon as they finish
+  cmac_lane_t         lanes[SECURITY_AES128_MAX_LANES];
+  alignas(16) uint8_t x[SECURITY_AES128_MAX_LANES][16];
+  alignas(16) uint8_t t[SECURITY_AES128_MAX_LANES][16];
+  uint32_t            next   = 0;
+  uint32_t            active = 0;
+  for (; active < max_lanes and next < nof_pdus; active++, next++) {
+    cmac_start(lanes[active], &pdus[next], bearer, direction);
+  }
+
+  while (active > 0) {
+    for (uint32_t l = 0; l < active; l++) {
+      cmac_next_input(ctx, lanes[l], x[l]);
+    }
+    aes.encrypt(x, t, active);
+    for (uint32_t l = 0; l < active; l++) {
+      memcpy(lanes[l].T, t[l], 16);
+      lanes[l].block++;
+    }
+
+    for (uint32_t l = 0; l < active;) {
+      if (lanes[l].block < lanes[l].nof_blocks) {
+        l++;
+        continue;
+      }
+      memcpy(lanes[l].pdu->mac, lanes[l].T, 4);
+      if (next < nof_pdus) {
+        cmac_start(lanes[l], &pdus[next++], bearer, direction);
+        l++;
+      } else {
+        // Keep the active lanes packed at the front
+        lanes[l] = lanes[--active];
+      }
+    }
+  }
+}
+
+/******************************************************************************
+ * EEA1 (SNOW 3G) and EEA3 (ZUC), 8 PDUs at a time
+ *****************************************************************************/
+
+// XORs the keystream words [word_offset, word_offset + nof_words) of each lane into its PDU
+static void
+keystream_xor_x8(const uint32_t (*ks)[8], uint32_t nof_words, uint32_t word_offset, security_pdu_t* pdus, uint32_t nof_pdus)
+{
+  for (uint32_t l = 0; l < nof_pdus; l++) {
+    security_pdu_t& pdu = pdus[l];
+    for (uint32_t w = 0; w < nof_words; w++) {
+      uint32_t offset = 4 * (word_offset + w);
+      if (offset >= pdu.msg_len) {
+        break;
+      }
+      // Keystream words are applied MSB first
+      uint32_t z = ks[w][l];
+      if (offset + 4 <= pdu.msg_len) {
+        uint32_t m;
+        z = __builtin_bswap32(z);
+        memcpy(&m, &pdu.msg[offset], 4);
+        m ^= z;
+        memcpy(&pdu.out[offset], &m, 4);
+      } else {
+        for (uint32_t i = 0; offset + i < pdu.msg_len; i++) {
+          pdu.out[offset + i] = pdu.msg[offset + i] ^ ((z >> (24 - 8 * i)) & 0xFF);
+        }
+      }
+    }
+  }
+}
+
+static uint32_t max_nof_words(const security_pdu_t* pdus, uint32_t nof_pdus)
+{
+  uint32_t max_len = 0;
+  for (uint32_t l = 0; l < nof_pdus; l++) {
+    max_len = std::max(max_len, pdus[l].msg_len);
+  }
+  return (max_len + 3) / 4;
+}
+
+// Number of keystream words generated per call, per lane
+#define SECURITY_X8_KS_CHUNK 32
+
+void security_128_eea1_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, security_pdu_t* pdus, uint32_t nof_pdus)
+{
+  uint32_t p = 0;
+  if (s3g_x8_supported()) {
+    uint32_t k[4];
+    for (int32_t i = 3; i >= 0; i--) {
+      k[i] = (key[4 * (3 - i) + 0] << 24) | (key[4 * (3 - i) + 1] << 16) | (key[4 * (3 - i) + 2] << 8) |
+             (key[4 * (3 - i) + 3]);
+    }
+
+    for (; nof_pdus - p >= SECURITY_X8_MIN_PDUS; p += std::min(8U, nof_pdus - p)) {
+      uint32_t     nof_lanes = std::min(8U, nof_pdus - p);
+      uint32_t     k_x8[8][4];
+      uint32_t     iv_x8[8][4];
+      S3G_STATE_X8 state;
+      for (uint32_t l = 0; l < 8; l++) {
+        // Unused lanes replicate the first PDU
+        const security_pdu_t& pdu = pdus[p + (l < nof_lanes ? l : 0)];
+        memcpy(k_x8[l], k, sizeof(k));
+        iv_x8[l][3] = pdu.count;
+        iv_x8[l][2] = ((bearer & 0x1F) << 27) | ((direction & 0x01) << 26);
+        iv_x8[l][1] = iv_x8[l][3];
+        iv_x8[l][0] = iv_x8[l][2];
+      }
+      s3g_initialize_x8(&state, k_x8, iv_x8);
+
+      uint32_t nof_words = max_nof_words(&pdus[p], nof_lanes);
+      uint32_t ks[SECURITY_X8_KS_CHUNK][8];
+      for (uint32_t w = 0; w < nof_words; w += SECURITY_X8_KS_CHUNK) {
+        uint32_t n = std::min((uint32_t)SECURITY_X8_KS_CHUNK, nof_words - w);
+        s3g_generate_keystream_x8(&state, n, ks);
+        keystream_xor_x8(ks, n, w, &pdus[p], nof_lanes);
+      }
+    }
+  }
+
+  for (; p < nof_pdus; p++) {
+    security_128_eea1((uint8_t*)key,
+                      pdus[p].count,
+                      bearer,
+                      direction,
+                      (uint8_t*)pdus[p].msg,
+                      pdus[p].msg_len,
+                      pdus[p].out);
+  }
+}
+
+void security_128_eea3_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, security_pdu_t* pdus, uint32_t nof_pdus)
+{
+  uint32_t p = 0;
+  if (zuc_x8_supported()) {
+    for (; nof_pdus - p >= SECURITY_X8_MIN_PDUS; p += std::min(8U, nof_pdus - p)) {
+      uint32_t       nof_lanes = std::min(8U, nof_pdus - p);
+      uint8_t        k_x8[8][16];
+      uint8_t        iv_x8[8][16];
+      zuc_state_x8_t state;
+      for (uint32_t l = 0; l < 8; l++) {
+        // Unused lanes replicate the first PDU
+        const security_pdu_t& pdu = pdus[p + (l < nof_lanes ? l : 0)];
+        memcpy(k_x8[l], key, 16);
+        iv_x8[l][0] = (pdu.count >> 24) & 0xFF;
+        iv_x8[l][1] = (pdu.count >> 16) & 0xFF;
+        iv_x8[l][2] = (pdu.count >> 8) & 0xFF;
+        iv_x8[l][3] = (pdu.count) & 0xFF;
+        iv_x8[l][4] = ((bearer & 0x1F) << 3) | ((direction & 0x01) << 2);
+        iv_x8[l][5] = 0;
+        iv_x8[l][6] = 0;
+        iv_x8[l][7] = 0;
+        memcpy(&iv_x8[l][8], iv_x8[l], 8);
+      }
+      zuc_initialize_x8(&state, k_x8, iv_x8);
+
+      uint32_t nof_words = max_nof_words(&pdus[p], nof_lanes);
+      uint32_t ks[SECURITY_X8_KS_CHUNK][8];
+      for (uint32_t w = 0; w < nof_words; w += SECURITY_X8_KS_CHUNK) {
+        uint32_t n = std::min((uint32_t)SECURITY_X8_KS_CHUNK, nof_words - w);
+        zuc_generate_keystream_x8(&state, n, ks);
+        keystream_xor_x8(ks, n, w, &pdus[p], nof_lanes);
+      }
+    }
+  }
+
+  for (; p < nof_pdus; p++) {
+    security_128_eea3((uint8_t*)key,
+                      pdus[p].count,
+                      bearer,
+                      direction,
+                      (uint8_t*)pdus[p].msg,
+                      pdus[p].msg_len,
+                      pdus[p].out);
+  }
+}
+
+} // namespace srsran
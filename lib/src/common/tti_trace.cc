@@ -0,0 +1,243 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/tti_trace.h"
+#include <chrono>
+#include <cinttypes>
+#include <mutex>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace srsran {
+
+namespace detail {
+std::atomic<bool> tti_trace_enabled = {false};
+} // namespace detail
+
+tti_trace_ring::tti_trace_ring(uint32_t nof_events, std::string thread_name_, uint32_t tid_)
+{
+  reset(nof_events, std::move(thread_name_), tid_);
+}
+
+void tti_trace_ring::reset(uint32_t nof_events, std::string thread_name_, uint32_t tid_)
+{
+  uint64_t size = 1;
+  while (size < nof_events) {
+    size <<= 1U;
+  }
+  events.resize(size);
+  events.shrink_to_fit();
+  mask      = size - 1;
+  name      = std::move(thread_name_);
+  thread_id = tid_;
+  head.store(0, std::memory_order_relaxed);
+}
+
+std::vector<tti_trace_event_t> tti_trace_ring::snapshot() const
+{
+  uint64_t end   = head.load(std::memory_order_acquire);
+  uint64_t begin = end > events.size() ? end - events.size() : 0;
+
+  std::vector<tti_trace_event_t> ret;
+  ret.reserve(end - begin);
+  for (uint64_t i = begin; i < end; ++i) {
+    ret.push_back(events[i & mask]);
+  }
+
+  // Drop the oldest events if the writer wrapped around them while they were being copied. push() writes the slot of
+  // event new_end before publishing it, and that slot also holds event new_end - size, so it is dropped as well
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t new_end   = head.load(std::memory_order_relaxed);
+  uint64_t new_begin = new_end + 1 > events.size() ? new_end + 1 - events.size() : 0;
+  if (new_begin > begin) {
+    ret.erase(ret.begin(), ret.begin() + std::min(new_begin - begin, (uint64_t)ret.size()));
+  }
+  return ret;
+}
+
+uint64_t tti_trace_ring::nof_lost() const
+{
+  uint64_t end = head.load(std::memory_order_relaxed);
+  return end + 1 > events.size() ? end + 1 - events.size() : 0;
+}
+
+namespace {
+
+/// Rings of all the threads that have recorded events. The rings of the exited threads are also in free_rings
+struct tti_trace_registry {
+  std::mutex                                    mutex;
+  std::vector<std::unique_ptr<tti_trace_ring> > rings;
+  std::vector<tti_trace_ring*>                  free_rings;
+  std::string                                   filename;
+  uint32_t                                      nof_events_per_thread = 65536;
+  uint64_t                                      t0_ns                 = 0;
+};
+
+tti_trace_registry& get_registry()
+{
+  // Never destroyed, as threads may still record events while the process exits
+  static tti_trace_registry* registry = new tti_trace_registry;
+  return *registry;
+}
+
+tti_trace_ring* register_thread()
+{
+  char thread_name[32] = {};
+  if (pthread_getname_np(pthread_self(), thread_name, sizeof(thread_name)) != 0) {
+    snprintf(thread_name, sizeof(thread_name), "unnamed");
+  }
+  uint32_t tid = (uint32_t)syscall(SYS_gettid);
+
+  tti_trace_registry&         registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  // Reuse the ring of an exited thread, so that threads created and destroyed at runtime do not grow the registry
+  if (not registry.free_rings.empty()) {
+    tti_trace_ring* ring = registry.free_rings.back();
+    registry.free_rings.pop_back();
+    ring->reset(registry.nof_events_per_thread, thread_name, tid);
+    return ring;
+  }
+
+  registry.rings.emplace_back(new tti_trace_ring(registry.nof_events_per_thread, thread_name, tid));
+  return registry.rings.back().get();
+}
+
+/// Ring of the calling thread, released for reuse when the thread exits
+struct local_ring_owner {
+  tti_trace_ring* ring = nullptr;
+
+  ~local_ring_owner()
+  {
+    if (ring != nullptr) {
+      tti_trace_registry&         registry = get_registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.free_rings.push_back(ring);
+    }
+  }
+};
+
+thread_local local_ring_owner local_ring;
+
+} // namespace
+
+bool tti_trace_init(const std::string& filename, uint32_t nof_events_per_thread)
+{
+  if (nof_events_per_thread == 0) {
+    return false;
+  }
+
+  tti_trace_registry& registry = get_registry();
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.filename              = filename;
+    registry.nof_events_per_thread = nof_events_per_thread;
+    if (registry.t0_ns == 0) {
+      registry.t0_ns = tti_trace_now_ns();
+    }
+  }
+  detail::tti_trace_enabled.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+uint64_t tti_trace_now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void tti_trace_record(const char* category, const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t tti)
+{
+  if (local_ring.ring == nullptr) {
+    local_ring.ring = register_thread();
+  }
+  local_ring.ring->push({category, name, start_ns, (uint32_t)std::min(end_ns - start_ns, (uint64_t)UINT32_MAX), tti});
+}
+
+bool tti_trace_write()
+{
+  std::string filename;
+  {
+    tti_trace_registry&         registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    filename = registry.filename;
+  }
+  return tti_trace_write(filename);
+}
+
+bool tti_trace_write(const std::string& filename)
+{
+  FILE* f = fopen(filename.c_str(), "w");
+  if (f == nullptr) {
+    perror("fopen");
+    return false;
+  }
+
+  tti_trace_registry&         registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  // Chrome trace event format, with timestamps and durations in microseconds
+  int         pid       = getpid();
+  const char* separator = "";
+  fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  for (const std::unique_ptr<tti_trace_ring>& ring : registry.rings) {
+    fprintf(f,
+            "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            separator,
+            pid,
+            ring->tid(),
+            ring->thread_name().c_str());
+    separator = ",";
+
+    for (const tti_trace_event_t& ev : ring->snapshot()) {
+      uint64_t ts_ns = ev.start_ns > registry.t0_ns ? ev.start_ns - registry.t0_ns : 0;
+      fprintf(f,
+              ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRIu64 ".%03" PRIu64
+              ",\"dur\":%u.%03u,\"pid\":%d,\"tid\":%u",
+              ev.name,
+              ev.category,
+              ts_ns / 1000,
+              ts_ns % 1000,
+              ev.duration_ns / 1000,
+              ev.duration_ns % 1000,
+              pid,
+              ring->tid());
+      if (ev.tti != TTI_TRACE_NO_TTI) {
+        fprintf(f, ",\"args\":{\"tti\":%u}", ev.tti);
+      }
+      fprintf(f, "}");
+    }
+  }
+  fprintf(f, "\n]}\n");
+
+  bool ret = (ferror(f) == 0);
+  fclose(f);
+  return ret;
+}
+
+void tti_trace_stop()
+{
+  detail::tti_trace_enabled.store(false, std::memory_order_relaxed);
+}
+
+} // namespace srsran
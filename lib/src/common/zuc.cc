@@ -31,6 +31,11 @@
 
 #include "srsran/common/zuc.h"
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define ZUC_HAVE_X8
+#endif
+
 #define MAKEU32(a, b, c, d) (((u32)(a) << 24) | ((u32)(b) << 16) | ((u32)(c) << 8) | ((u32)(d)))
 #define MulByPow2(x, k) ((((x) << k) | ((x) >> (31 - k))) & 0x7FFFFFFF)
 #define MAKEU31(a, b, c) (((u32)(a) << 23) | ((u32)(b) << 8) | (u32)(c))
@@ -252,3 +257,176 @@ void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keyst
     LFSRWithWorkMode(state);
   }
 }
+
+/* ——————————————————————- */
+/* 8-lane ZUC, one instance per 32-bit lane of an AVX2 register */
+#ifdef ZUC_HAVE_X8
+
+bool zuc_x8_supported()
+{
+  return __builtin_cpu_supports("avx2");
+}
+
+/* S-boxes placed at the byte position of MAKEU32(S0, S1, S0, S1), so that a 32-bit gather can read them */
+typedef struct {
+  u32 T[4][256];
+} zuc_sbox_x8_t;
+
+static const zuc_sbox_x8_t& zuc_get_sbox_x8()
+{
+  static const zuc_sbox_x8_t tables = []() {
+    zuc_sbox_x8_t t = {};
+    for (u32 x = 0; x < 256; x++) {
+      t.T[0][x] = (u32)S0[x] << 24;
+      t.T[1][x] = (u32)S1[x] << 16;
+      t.T[2][x] = (u32)S0[x] << 8;
+      t.T[3][x] = (u32)S1[x];
+    }
+    return t;
+  }();
+  return tables;
+}
+
+__attribute__((target("avx2"))) static inline __m256i zuc_add_m_x8(__m256i a, __m256i b)
+{
+  __m256i c = _mm256_add_epi32(a, b);
+  return _mm256_add_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7FFFFFFF)), _mm256_srli_epi32(c, 31));
+}
+
+#define ZUC_MUL_BY_POW2_X8(x, k)                                                                                       \
+  _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 31 - k)),                            \
+                   _mm256_set1_epi32(0x7FFFFFFF))
+#define ZUC_ROT_X8(a, k) _mm256_or_si256(_mm256_slli_epi32(a, k), _mm256_srli_epi32(a, 32 - k))
+
+__attribute__((target("avx2"))) static inline __m256i zuc_l1_x8(__m256i x)
+{
+  __m256i r = _mm256_xor_si256(x, ZUC_ROT_X8(x, 2));
+  r         = _mm256_xor_si256(r, ZUC_ROT_X8(x, 10));
+  r         = _mm256_xor_si256(r, ZUC_ROT_X8(x, 18));
+  return _mm256_xor_si256(r, ZUC_ROT_X8(x, 24));
+}
+
+__attribute__((target("avx2"))) static inline __m256i zuc_l2_x8(__m256i x)
+{
+  __m256i r = _mm256_xor_si256(x, ZUC_ROT_X8(x, 8));
+  r         = _mm256_xor_si256(r, ZUC_ROT_X8(x, 14));
+  r         = _mm256_xor_si256(r, ZUC_ROT_X8(x, 22));
+  return _mm256_xor_si256(r, ZUC_ROT_X8(x, 30));
+}
+
+__attribute__((target("avx2"))) static inline __m256i zuc_sbox_x8(const zuc_sbox_x8_t& t, __m256i x)
+{
+  const __m256i mask = _mm256_set1_epi32(0xff);
+  __m256i       r    = _mm256_i32gather_epi32((const int*)t.T[0], _mm256_srli_epi32(x, 24), 4);
+  r = _mm256_or_si256(r, _mm256_i32gather_epi32((const int*)t.T[1], _mm256_and_si256(_mm256_srli_epi32(x, 16), mask), 4));
+  r = _mm256_or_si256(r, _mm256_i32gather_epi32((const int*)t.T[2], _mm256_and_si256(_mm256_srli_epi32(x, 8), mask), 4));
+  r = _mm256_or_si256(r, _mm256_i32gather_epi32((const int*)t.T[3], _mm256_and_si256(x, mask), 4));
+  return r;
+}
+
+/* One round: BitReorganization, F and LFSR. In initialisation mode the output of F is fed
+ * back into the LFSR. Returns F ^ X3.
+ */
+__attribute__((target("avx2"))) static inline __m256i
+zuc_round_x8(const zuc_sbox_x8_t& t, __m256i* s, __m256i* r1, __m256i* r2, bool init_mode)
+{
+  const __m256i lo16 = _mm256_set1_epi32(0xFFFF);
+
+  // BitReorganization
+  __m256i x0 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(s[15], _mm256_set1_epi32(0x7FFF8000)), 1),
+                               _mm256_and_si256(s[14], lo16));
+  __m256i x1 = _mm256_or_si256(_mm256_slli_epi32(s[11], 16), _mm256_srli_epi32(s[9], 15));
+  __m256i x2 = _mm256_or_si256(_mm256_slli_epi32(s[7], 16), _mm256_srli_epi32(s[5], 15));
+  __m256i x3 = _mm256_or_si256(_mm256_slli_epi32(s[2], 16), _mm256_srli_epi32(s[0], 15));
+
+  // F
+  __m256i w  = _mm256_add_epi32(_mm256_xor_si256(x0, *r1), *r2);
+  __m256i w1 = _mm256_add_epi32(*r1, x1);
+  __m256i w2 = _mm256_xor_si256(*r2, x2);
+  __m256i u  = zuc_l1_x8(_mm256_or_si256(_mm256_slli_epi32(w1, 16), _mm256_srli_epi32(w2, 16)));
+  __m256i v  = zuc_l2_x8(_mm256_or_si256(_mm256_slli_epi32(w2, 16), _mm256_srli_epi32(w1, 16)));
+  *r1        = zuc_sbox_x8(t, u);
+  *r2        = zuc_sbox_x8(t, v);
+
+  // LFSR
+  __m256i f = s[0];
+  f         = zuc_add_m_x8(f, ZUC_MUL_BY_POW2_X8(s[0], 8));
+  f         = zuc_add_m_x8(f, ZUC_MUL_BY_POW2_X8(s[4], 20));
+  f         = zuc_add_m_x8(f, ZUC_MUL_BY_POW2_X8(s[10], 21));
+  f         = zuc_add_m_x8(f, ZUC_MUL_BY_POW2_X8(s[13], 17));
+  f         = zuc_add_m_x8(f, ZUC_MUL_BY_POW2_X8(s[15], 15));
+  if (init_mode) {
+    f = zuc_add_m_x8(f, _mm256_srli_epi32(w, 1));
+  }
+  for (int i = 0; i < 15; i++) {
+    s[i] = s[i + 1];
+  }
+  s[15] = f;
+
+  return _mm256_xor_si256(w, x3);
+}
+
+__attribute__((target("avx2"))) void zuc_initialize_x8(zuc_state_x8_t* state, const u8 k[8][16], const u8 iv[8][16])
+{
+  const zuc_sbox_x8_t& t = zuc_get_sbox_x8();
+
+  for (int l = 0; l < 8; l++) {
+    for (int i = 0; i < 16; i++) {
+      state->LFSR_S[i][l] = MAKEU31(k[l][i], EK_d[i], iv[l][i]);
+    }
+  }
+
+  __m256i s[16];
+  __m256i r1 = _mm256_setzero_si256();
+  __m256i r2 = _mm256_setzero_si256();
+  for (int i = 0; i < 16; i++) {
+    s[i] = _mm256_load_si256((const __m256i*)state->LFSR_S[i]);
+  }
+  for (int i = 0; i < 32; i++) {
+    zuc_round_x8(t, s, &r1, &r2, true);
+  }
+  // discard the output of F
+  zuc_round_x8(t, s, &r1, &r2, false);
+
+  for (int i = 0; i < 16; i++) {
+    _mm256_store_si256((__m256i*)state->LFSR_S[i], s[i]);
+  }
+  _mm256_store_si256((__m256i*)state->F_R1, r1);
+  _mm256_store_si256((__m256i*)state->F_R2, r2);
+}
+
+__attribute__((target("avx2"))) void
+zuc_generate_keystream_x8(zuc_state_x8_t* state, int key_stream_len, u32 (*p_keystream)[8])
+{
+  const zuc_sbox_x8_t& t = zuc_get_sbox_x8();
+
+  __m256i s[16];
+  for (int i = 0; i < 16; i++) {
+    s[i] = _mm256_load_si256((const __m256i*)state->LFSR_S[i]);
+  }
+  __m256i r1 = _mm256_load_si256((const __m256i*)state->F_R1);
+  __m256i r2 = _mm256_load_si256((const __m256i*)state->F_R2);
+
+  for (int i = 0; i < key_stream_len; i++) {
+    _mm256_storeu_si256((__m256i*)p_keystream[i], zuc_round_x8(t, s, &r1, &r2, false));
+  }
+
+  for (int i = 0; i < 16; i++) {
+    _mm256_store_si256((__m256i*)state->LFSR_S[i], s[i]);
+  }
+  _mm256_store_si256((__m256i*)state->F_R1, r1);
+  _mm256_store_si256((__m256i*)state->F_R2, r2);
+}
+
+#else // ZUC_HAVE_X8
+
+bool zuc_x8_supported()
+{
+  return false;
+}
+
+void zuc_initialize_x8(zuc_state_x8_t* state, const u8 k[8][16], const u8 iv[8][16]) {}
+
+void zuc_generate_keystream_x8(zuc_state_x8_t* state, int key_stream_len, u32 (*p_keystream)[8]) {}
+
+#endif // ZUC_HAVE_X8
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/upper/pdcp.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/upper/pdcp_entity_nr.h"
 
 namespace srsran {
@@ -94,6 +95,7 @@ bool pdcp::is_lcid_enabled(uint32_t lcid)
 
 void pdcp::write_sdu(uint32_t lcid, unique_byte_buffer_t sdu, int sn)
 {
+  tti_trace_event("PDCP", "pdcp::write_sdu");
   if (valid_lcid(lcid)) {
     pdcp_array.at(lcid)->write_sdu(std::move(sdu), sn);
   } else {
@@ -287,6 +289,7 @@ std::map<uint32_t, srsran::unique_byte_buffer_t> pdcp::get_buffered_pdus(uint32_
 *******************************************************************************/
 void pdcp::write_pdu(uint32_t lcid, unique_byte_buffer_t pdu)
 {
+  tti_trace_event("PDCP", "pdcp::write_pdu");
   if (valid_lcid(lcid)) {
     pdcp_array.at(lcid)->write_pdu(std::move(pdu));
   } else {
@@ -44,6 +44,12 @@ void pdcp_entity_base::config_security(const as_security_config_t& sec_cfg_)
   logger.debug(sec_cfg.k_up_enc.data(), 32, "K_up_enc");
   logger.debug(sec_cfg.k_rrc_int.data(), 32, "K_rrc_int");
   logger.debug(sec_cfg.k_up_int.data(), 32, "K_up_int");
+
+  // The 128-bit algorithms use the lower half of the 256-bit keys
+  security_aes128_init(&aes_rrc_enc, &sec_cfg.k_rrc_enc[16]);
+  security_aes128_init(&aes_up_enc, &sec_cfg.k_up_enc[16]);
+  security_aes128_init(&aes_rrc_int, &sec_cfg.k_rrc_int[16]);
+  security_aes128_init(&aes_up_int, &sec_cfg.k_up_int[16]);
 }
 
 /****************************************************************************
@@ -66,9 +72,10 @@ void pdcp_entity_base::integrity_generate(uint8_t* msg, uint32_t msg_len, uint32
     case INTEGRITY_ALGORITHM_ID_128_EIA1:
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
-    case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
-      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2: {
+      security_pdu_t pdu = {count, msg, msg_len, nullptr, mac};
+      security_128_eia2_batch(is_srb() ? &aes_rrc_int : &aes_up_int, cfg.bearer_id - 1, cfg.tx_direction, &pdu, 1);
+    } break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
@@ -104,9 +111,10 @@ bool pdcp_entity_base::integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t
     case INTEGRITY_ALGORITHM_ID_128_EIA1:
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
-    case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
-      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2: {
+      security_pdu_t pdu = {count, msg, msg_len, nullptr, mac_exp};
+      security_128_eia2_batch(is_srb() ? &aes_rrc_int : &aes_up_int, cfg.bearer_id - 1, cfg.rx_direction, &pdu, 1);
+    } break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
@@ -161,10 +169,11 @@ void pdcp_entity_base::cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t c
       security_128_eea1(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
       memcpy(ct, ct_tmp, msg_len);
       break;
-    case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
-      memcpy(ct, ct_tmp, msg_len);
-      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2: {
+      // Counter mode works in place, no need for the temporary buffer
+      security_pdu_t pdu = {count, msg, msg_len, ct, nullptr};
+      security_128_eea2_batch(is_srb() ? &aes_rrc_enc : &aes_up_enc, cfg.bearer_id - 1, cfg.tx_direction, &pdu, 1);
+    } break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
       memcpy(ct, ct_tmp, msg_len);
@@ -201,10 +210,10 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
       security_128_eea1(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
       memcpy(msg, msg_tmp, ct_len);
       break;
-    case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
-      memcpy(msg, msg_tmp, ct_len);
-      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2: {
+      security_pdu_t pdu = {count, ct, ct_len, msg, nullptr};
+      security_128_eea2_batch(is_srb() ? &aes_rrc_enc : &aes_up_enc, cfg.bearer_id - 1, cfg.rx_direction, &pdu, 1);
+    } break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
       memcpy(msg, msg_tmp, ct_len);
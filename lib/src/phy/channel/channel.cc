@@ -43,15 +43,15 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, sr
   // Copy args
   args = channel_args;
 
-  // Allocate internal buffers
-  buffer_in  = srsran_vec_cf_malloc(buffer_size);
-  buffer_out = srsran_vec_cf_malloc(buffer_size);
-  if (!buffer_out || !buffer_in) {
-    ret = SRSRAN_ERROR;
-  }
-
   nof_channels = _nof_channels;
   for (uint32_t i = 0; i < nof_channels; i++) {
+    // Allocate internal buffers, every channel has its own so they can run in parallel
+    buffer_in[i]  = srsran_vec_cf_malloc(buffer_size);
+    buffer_out[i] = srsran_vec_cf_malloc(buffer_size);
+    if (!buffer_out[i] || !buffer_in[i]) {
+      ret = SRSRAN_ERROR;
+    }
+
     // Create fading channel
     if (channel_args.fading_enable && !channel_args.fading_model.empty() && channel_args.fading_model != "none" &&
         ret == SRSRAN_SUCCESS) {
@@ -96,17 +96,25 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, sr
 
   if (ret != SRSRAN_SUCCESS) {
     fprintf(stderr, "Error: Creating channel\n\n");
+    return;
+  }
+
+  // Create the workers for the channels the caller does not run
+  uint32_t nof_workers = SRSRAN_MIN(SRSRAN_MAX(args.nof_threads, 1), nof_channels) - 1;
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    workers.emplace_back(&channel::run_worker, this, i + 1);
   }
 }
 
 channel::~channel()
 {
-  if (buffer_in) {
-    free(buffer_in);
+  {
+    std::unique_lock<std::mutex> lock(worker_mutex);
+    worker_quit = true;
   }
-
-  if (buffer_out) {
-    free(buffer_out);
+  worker_start_cvar.notify_all();
+  for (std::thread& w : workers) {
+    w.join();
   }
 
   if (awgn) {
@@ -125,6 +133,14 @@ channel::~channel()
   }
 
   for (uint32_t i = 0; i < nof_channels; i++) {
+    if (buffer_in[i]) {
+      free(buffer_in[i]);
+    }
+
+    if (buffer_out[i]) {
+      free(buffer_out[i]);
+    }
+
     if (fading[i]) {
       srsran_channel_fading_free(fading[i]);
       free(fading[i]);
@@ -147,6 +163,47 @@ static inline cf_t local_cexpf(float phase)
 }
 }
 
+void channel::run_link(uint32_t i, uint32_t len, const srsran_timestamp_t& t)
+{
+  if (fading[i]) {
+    srsran_channel_fading_execute(fading[i], buffer_in[i], buffer_out[i], len, t.full_secs + t.frac_secs);
+    srsran_vec_cf_copy(buffer_in[i], buffer_out[i], len);
+  }
+
+  if (delay[i]) {
+    srsran_channel_delay_execute(delay[i], buffer_in[i], buffer_out[i], len, &t);
+    srsran_vec_cf_copy(buffer_in[i], buffer_out[i], len);
+  }
+}
+
+void channel::run_worker(uint32_t id)
+{
+  uint64_t                     run = 0;
+  std::unique_lock<std::mutex> lock(worker_mutex);
+
+  while (true) {
+    worker_start_cvar.wait(lock, [this, run]() { return worker_quit || worker_run != run; });
+    if (worker_quit) {
+      return;
+    }
+    run                  = worker_run;
+    uint32_t           n = worker_len;
+    srsran_timestamp_t t = worker_ts;
+    lock.unlock();
+
+    for (uint32_t i = id; i < nof_channels; i += workers.size() + 1) {
+      if (link_active[i]) {
+        run_link(i, n, t);
+      }
+    }
+
+    lock.lock();
+    if (--worker_pending == 0) {
+      worker_done_cvar.notify_one();
+    }
+  }
+}
+
 void channel::run(cf_t*                     in[SRSRAN_MAX_CHANNELS],
                   cf_t*                     out[SRSRAN_MAX_CHANNELS],
                   uint32_t                  len,
@@ -159,6 +216,8 @@ void channel::run(cf_t*                     in[SRSRAN_MAX_CHANNELS],
 
   // For each channel
   for (uint32_t i = 0; i < nof_channels; i++) {
+    link_active[i] = false;
+
     // Skip iteration if any buffer is null
     if (in[i] == nullptr || out[i] == nullptr) {
       continue;
@@ -173,35 +232,57 @@ void channel::run(cf_t*                     in[SRSRAN_MAX_CHANNELS],
     }
 
     // Copy input buffer
-    srsran_vec_cf_copy(buffer_in, in[i], len);
+    srsran_vec_cf_copy(buffer_in[i], in[i], len);
 
     if (hst) {
-      srsran_channel_hst_execute(hst, buffer_in, buffer_out, len, &t);
-      srsran_vec_sc_prod_ccc(buffer_out, local_cexpf(hst_init_phase), buffer_in, len);
+      srsran_channel_hst_execute(hst, buffer_in[i], buffer_out[i], len, &t);
+      srsran_vec_sc_prod_ccc(buffer_out[i], local_cexpf(hst_init_phase), buffer_in[i], len);
     }
 
+    // The noise generator is shared by all channels, keep its sequence in channel order
     if (awgn) {
-      srsran_channel_awgn_run_c(awgn, buffer_in, buffer_out, len);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+      srsran_channel_awgn_run_c(awgn, buffer_in[i], buffer_out[i], len);
+      srsran_vec_cf_copy(buffer_in[i], buffer_out[i], len);
     }
 
-    if (fading[i]) {
-      srsran_channel_fading_execute(fading[i], buffer_in, buffer_out, len, t.full_secs + t.frac_secs);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+    link_active[i] = true;
+  }
+
+  // Run fading and delay of every channel, spread over the workers
+  if (!workers.empty()) {
+    {
+      std::unique_lock<std::mutex> lock(worker_mutex);
+      worker_len     = len;
+      worker_ts      = t;
+      worker_pending = (uint32_t)workers.size();
+      worker_run++;
     }
+    worker_start_cvar.notify_all();
+  }
 
-    if (delay[i]) {
-      srsran_channel_delay_execute(delay[i], buffer_in, buffer_out, len, &t);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+  for (uint32_t i = 0; i < nof_channels; i += workers.size() + 1) {
+    if (link_active[i]) {
+      run_link(i, len, t);
+    }
+  }
+
+  if (!workers.empty()) {
+    std::unique_lock<std::mutex> lock(worker_mutex);
+    worker_done_cvar.wait(lock, [this]() { return worker_pending == 0; });
+  }
+
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    if (!link_active[i]) {
+      continue;
     }
 
     if (rlf) {
-      srsran_channel_rlf_execute(rlf, buffer_in, buffer_out, len, &t);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+      srsran_channel_rlf_execute(rlf, buffer_in[i], buffer_out[i], len, &t);
+      srsran_vec_cf_copy(buffer_in[i], buffer_out[i], len);
     }
 
     // Copy output buffer
-    srsran_vec_cf_copy(out[i], buffer_in, len);
+    srsran_vec_cf_copy(out[i], buffer_in[i], len);
   }
 
   if (hst) {
@@ -21,6 +21,7 @@
 
 #include "srsran/phy/channel/fading.h"
 #include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 #include <math.h>
 #include <stdio.h>
@@ -77,80 +78,85 @@ static inline int parse_model(srsran_channel_fading_t* q, const char* str)
   return ret;
 }
 
-#ifdef LV_HAVE_SSE
-#include <immintrin.h>
-static inline __m128 _sine(const float* table, __m128 arg)
-{
-  __m128 ret;
-  int    idx[4];
-  float  sine[4];
-
-  __m128 turns =
-      _mm_round_ps(_mm_mul_ps(arg, _mm_set1_ps(1.0f / (2.0f * (float)M_PI))), (_MM_FROUND_TO_ZERO + _MM_FROUND_NO_EXC));
-  __m128  argmod   = _mm_sub_ps(arg, _mm_mul_ps(turns, _mm_set1_ps(2.0f * (float)M_PI)));
-  __m128  indexps  = _mm_mul_ps(argmod, _mm_set1_ps(1024.0f / (2.0f * (float)M_PI)));
-  __m128i indexi32 = _mm_abs_epi32(_mm_cvtps_epi32(indexps));
-  _mm_store_si128((__m128i*)idx, indexi32);
-
-  for (int i = 0; i < 4; i++) {
-    sine[i] = table[idx[i]];
-  }
-
-  ret = _mm_load_ps(sine);
-  return ret;
-}
-
-static inline __m128 _cosine(float* table, __m128 arg)
+#if SRSRAN_SIMD_F_SIZE
+/*
+ * Computes sine and cosine of x. The argument is reduced to [-pi, pi], sine and cosine of the half angle are
+ * approximated with their Taylor series and the angle is doubled back. The absolute error is below 1e-6.
+ */
+static inline void fading_simd_sincos(simd_f_t x, simd_f_t* s, simd_f_t* c)
 {
-  arg = _mm_add_ps(arg, _mm_set1_ps((float)M_PI_2));
-  return _sine(table, arg);
+  simd_f_t turns = srsran_simd_f_round(srsran_simd_f_mul(x, srsran_simd_f_set1(1.0f / (2.0f * (float)M_PI))));
+  simd_f_t h     = srsran_simd_f_sub(x, srsran_simd_f_mul(turns, srsran_simd_f_set1(2.0f * (float)M_PI)));
+  h              = srsran_simd_f_mul(h, srsran_simd_f_set1(0.5f));
+  simd_f_t h2    = srsran_simd_f_mul(h, h);
+  simd_f_t one   = srsran_simd_f_set1(1.0f);
+
+  // sin(h) = h * (1 - h^2/6 * (1 - h^2/20 * (1 - h^2/42 * (1 - h^2/72 * (1 - h^2/110)))))
+  simd_f_t sh = srsran_simd_f_sub(one, srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 110.0f)));
+  sh          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 72.0f)), sh));
+  sh          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 42.0f)), sh));
+  sh          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 20.0f)), sh));
+  sh          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 6.0f)), sh));
+  sh          = srsran_simd_f_mul(h, sh);
+
+  // cos(h) = 1 - h^2/2 * (1 - h^2/12 * (1 - h^2/30 * (1 - h^2/56 * (1 - h^2/90))))
+  simd_f_t ch = srsran_simd_f_sub(one, srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 90.0f)));
+  ch          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 56.0f)), ch));
+  ch          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 30.0f)), ch));
+  ch          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 12.0f)), ch));
+  ch          = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_mul(h2, srsran_simd_f_set1(1.0f / 2.0f)), ch));
+
+  // sin(2h) = 2 * sin(h) * cos(h), cos(2h) = 1 - 2 * sin(h)^2
+  *s = srsran_simd_f_mul(srsran_simd_f_set1(2.0f), srsran_simd_f_mul(sh, ch));
+  *c = srsran_simd_f_sub(one, srsran_simd_f_mul(srsran_simd_f_set1(2.0f), srsran_simd_f_mul(sh, sh)));
 }
-#endif /*LV_HAVE_SSE*/
+#endif /* SRSRAN_SIMD_F_SIZE */
 
-static inline cf_t
-get_doppler_dispersion(srsran_channel_fading_t* q, float t, float F_d, float* alpha, float* a, float* b)
+static inline cf_t get_doppler_dispersion(srsran_channel_fading_t* q, float t, uint32_t tap)
 {
-#ifdef LV_HAVE_SSE
-  const float recN   = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
-  cf_t        ret    = 0;
-  __m128      _reacc = _mm_setzero_ps();
-  __m128      _imacc = _mm_setzero_ps();
-  __m128      _arg   = _mm_set1_ps((float)M_PI * F_d);
-  __m128      _t     = _mm_set1_ps(t);
-  __m128      _arg_  = (_mm_mul_ps(_arg, _t));
-
-  for (int i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i += 4) {
-    __m128 _alpha = _mm_loadu_ps(&alpha[i]);
-    __m128 _a     = _mm_loadu_ps(&a[i]);
-    __m128 _b     = _mm_loadu_ps(&b[i]);
-    __m128 _arg1  = _mm_mul_ps(_arg_, _cosine(q->sin_table, _alpha));
-    __m128 _re    = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
-    __m128 _im    = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
-    _reacc        = _mm_add_ps(_reacc, _re);
-    _imacc        = _mm_add_ps(_imacc, _im);
+  const float  recN = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
+  const float* w    = q->coeff_w[tap];
+  const float* a    = q->coeff_a[tap];
+  const float* b    = q->coeff_b[tap];
+  float        re   = 0.0f;
+  float        im   = 0.0f;
+  uint32_t     i    = 0;
+
+#if SRSRAN_SIMD_F_SIZE
+  simd_f_t _t     = srsran_simd_f_set1(t);
+  simd_f_t _reacc = srsran_simd_f_zero();
+  simd_f_t _imacc = srsran_simd_f_zero();
+  for (; i + SRSRAN_SIMD_F_SIZE <= SRSRAN_CHANNEL_FADING_NTERMS; i += SRSRAN_SIMD_F_SIZE) {
+    simd_f_t _arg = srsran_simd_f_mul(srsran_simd_f_loadu(&w[i]), _t);
+    simd_f_t _s, _c, _unused;
+
+    // Real part from the cosine of arg + a, imaginary part from the sine of arg + b
+    fading_simd_sincos(srsran_simd_f_add(_arg, srsran_simd_f_loadu(&a[i])), &_unused, &_c);
+    fading_simd_sincos(srsran_simd_f_add(_arg, srsran_simd_f_loadu(&b[i])), &_s, &_unused);
+    _reacc = srsran_simd_f_add(_reacc, _c);
+    _imacc = srsran_simd_f_add(_imacc, _s);
   }
 
-  __m128 _tmp = _mm_hadd_ps(_reacc, _imacc);
-  _tmp        = _mm_hadd_ps(_tmp, _tmp);
-  float r[4];
-  _mm_store_ps(r, _tmp);
-  __real__ ret = r[0];
-  __imag__ ret = r[1];
-
-  return ret * recN;
-
-#else
-  const float recN = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
-  cf_t        r    = 0;
+  float r[SRSRAN_SIMD_F_SIZE];
+  float m[SRSRAN_SIMD_F_SIZE];
+  srsran_simd_f_storeu(r, _reacc);
+  srsran_simd_f_storeu(m, _imacc);
+  for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE; j++) {
+    re += r[j];
+    im += m[j];
+  }
+#endif /* SRSRAN_SIMD_F_SIZE */
 
-  for (uint32_t i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i++) {
-    float arg = (float)M_PI * F_d * cosf(alpha[i]) * t;
-    __real__ r += cosf(arg + a[i]);
-    __imag__ r += sinf(arg + b[i]);
+  for (; i < SRSRAN_CHANNEL_FADING_NTERMS; i++) {
+    float arg = w[i] * t;
+    re += cosf(arg + a[i]);
+    im += sinf(arg + b[i]);
   }
 
-  return recN * r;
-#endif /*LV_HAVE_SSE*/
+  cf_t ret;
+  __real__ ret = re;
+  __imag__ ret = im;
+  return recN * ret;
 }
 
 static inline void generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, uint32_t N, uint32_t path_delay)
@@ -162,53 +168,63 @@ static inline void generate_tap(float delay_ns, float power_db, float srate, cf_
   srsran_vec_gen_sine(a0, -O, buf, N);
 }
 
-static inline void generate_taps(srsran_channel_fading_t* q, float time)
+/*
+ * Builds the channel frequency response as the sum of the tap responses weighted by their Doppler dispersion and
+ * applies it to y_freq in the same pass, so that every tap response is read once per segment.
+ */
+static inline void apply_taps(srsran_channel_fading_t* q, const cf_t* a)
 {
-  // Generate taps
-  for (int i = 0; i < nof_taps[q->model]; i++) {
-    // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
-
-    if (i) {
-      // Copy tap frequency response
-      srsran_vec_sc_prod_ccc(q->h_tap[i], a, q->temp, q->N);
-
-      // Add to frequency response, shifts FFT at same time
-      srsran_vec_sum_ccc(q->h_freq, &q->temp[q->N / 2], q->h_freq, q->N / 2);
-      srsran_vec_sum_ccc(&q->h_freq[q->N / 2], q->temp, &q->h_freq[q->N / 2], q->N / 2);
-    } else {
-      // Copy tap frequency response
-      srsran_vec_sc_prod_ccc(&q->h_tap[i][q->N / 2], a, q->h_freq, q->N / 2);
-      srsran_vec_sc_prod_ccc(&q->h_tap[i][0], a, &q->h_freq[q->N / 2], q->N / 2);
+  uint32_t ntaps = nof_taps[q->model];
+  uint32_t k     = 0;
+
+#if SRSRAN_SIMD_CF_SIZE
+  simd_cf_t _a[SRSRAN_CHANNEL_FADING_MAXTAPS];
+  for (uint32_t i = 0; i < ntaps; i++) {
+    _a[i] = srsran_simd_cf_set1(a[i]);
+  }
+
+  for (; k + SRSRAN_SIMD_CF_SIZE <= q->N; k += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t _h = srsran_simd_cf_prod(_a[0], srsran_simd_cfi_load(&q->h_tap[0][k]));
+    for (uint32_t i = 1; i < ntaps; i++) {
+      _h = srsran_simd_cf_add(_h, srsran_simd_cf_prod(_a[i], srsran_simd_cfi_load(&q->h_tap[i][k])));
     }
+    srsran_simd_cfi_store(&q->h_freq[k], _h);
+    srsran_simd_cfi_store(&q->y_freq[k], srsran_simd_cf_prod(srsran_simd_cfi_load(&q->y_freq[k]), _h));
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE */
+
+  for (; k < q->N; k++) {
+    cf_t h = 0;
+    for (uint32_t i = 0; i < ntaps; i++) {
+      h += a[i] * q->h_tap[i][k];
+    }
+    q->h_freq[k] = h;
+    q->y_freq[k] *= h;
   }
-  // at this stage, q->h_freq should contain the frequency response
 }
 
-static inline void filter_segment(srsran_channel_fading_t* q, const cf_t* input, cf_t* output, uint32_t nsamples)
+/*
+ * Overlap-save filtering: the FFT covers the new nsamples preceded by the previous input samples, and only the last
+ * nsamples of the circular convolution are kept. The impulse response fits in the overlap.
+ */
+static inline void
+filter_segment(srsran_channel_fading_t* q, const cf_t* a, const cf_t* input, cf_t* output, uint32_t nsamples)
 {
-  // Fill Input vector
-  srsran_vec_cf_copy(q->temp, input, nsamples);
-  srsran_vec_cf_zero(&q->temp[nsamples], q->N - nsamples);
+  // Slide the input history and append the new samples
+  memmove(q->state, &q->state[nsamples], sizeof(cf_t) * (q->N - nsamples));
+  srsran_vec_cf_copy(&q->state[q->N - nsamples], input, nsamples);
 
   // Do FFT
-  srsran_dft_run_c_zerocopy(&q->fft, q->temp, q->y_freq);
+  srsran_dft_run_c_zerocopy(&q->fft, q->state, q->y_freq);
 
   // Apply channel
-  srsran_vec_prod_ccc(q->y_freq, q->h_freq, q->y_freq, q->N);
+  apply_taps(q, a);
 
   // Do iFFT
   srsran_dft_run_c_zerocopy(&q->ifft, q->y_freq, q->temp);
 
-  // Add state
-  srsran_vec_sum_ccc(q->temp, q->state, q->temp, q->state_len);
-
-  // Copy the first nsamples into the output
-  srsran_vec_cf_copy(output, q->temp, nsamples);
-
-  // Copy the rest of the samples into the state
-  q->state_len = q->N - nsamples;
-  srsran_vec_cf_copy(q->state, &q->temp[nsamples], q->state_len);
+  // Copy the samples free of circular aliasing into the output
+  srsran_vec_cf_copy(output, &q->temp[q->N - nsamples], nsamples);
 }
 
 int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const char* model, uint32_t seed)
@@ -225,12 +241,21 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
     // Fill srate
     q->srate = (float)srate;
 
-    // Populate internal parameters
+    // Populate internal parameters. The impulse response spans up to half of filter_len samples, the FFT doubles it so
+    // that every FFT filters three quarters of its length with overlap-save
     uint32_t fft_min_pow =
         (uint32_t)round(log2(excess_tap_delay_ns[q->model][nof_taps[q->model] - 1] * 1e-9 * srate)) + 3;
-    q->N          = SRSRAN_MAX(1U << fft_min_pow, (uint32_t)(srate / (15e3f * 4.0f)));
-    q->path_delay = q->N / 4;
-    q->state_len  = 0;
+    uint32_t filter_len = SRSRAN_MAX(1U << fft_min_pow, (uint32_t)(srate / (15e3f * 4.0f)));
+    q->N                = 2 * filter_len;
+    q->path_delay       = filter_len / 4;
+    q->segment_len      = q->N - filter_len / 2;
+
+    // Allocate memory
+    q->temp = srsran_vec_cf_malloc(q->N);
+    if (!q->temp) {
+      fprintf(stderr, "Error: allocating temp\n");
+      goto clean_exit;
+    }
 
     // Initialise random number
     srsran_random_t* random = srsran_random_init(seed);
@@ -242,19 +267,22 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
         q->coeff_a[i][j]     = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_b[i][j]     = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_alpha[i][j] = ((float)M_PI * ((float)i - (float)0.5f)) / (2.0f * nof_taps[q->model]);
+        q->coeff_w[i][j]     = (float)M_PI * q->doppler * cosf(q->coeff_alpha[i][j]);
       }
 
       // Allocate tap frequency response
       q->h_tap[i] = srsran_vec_cf_malloc(q->N);
+      if (!q->h_tap[i]) {
+        fprintf(stderr, "Error: allocating h_tap\n");
+        srsran_random_free(random);
+        goto clean_exit;
+      }
 
-      // Generate tap frequency response
+      // Generate tap frequency response and shift the FFT, so it does not need to be shifted for every segment
       generate_tap(
-          excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->h_tap[i], q->N, q->path_delay);
-    }
-
-    // Generate sine Table
-    for (uint32_t i = 0; i < 1024; i++) {
-      q->sin_table[i] = sinf((float)i * 2.0f * (float)M_PI / 1024);
+          excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->temp, q->N, q->path_delay);
+      srsran_vec_cf_copy(q->h_tap[i], &q->temp[q->N / 2], q->N / 2);
+      srsran_vec_cf_copy(&q->h_tap[i][q->N / 2], q->temp, q->N / 2);
     }
 
     // Free random
@@ -272,13 +300,6 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
       goto clean_exit;
     }
 
-    // Allocate memory
-    q->temp = srsran_vec_cf_malloc(q->N);
-    if (!q->temp) {
-      fprintf(stderr, "Error: allocating h_freq\n");
-      goto clean_exit;
-    }
-
     q->h_freq = srsran_vec_cf_malloc(q->N);
     if (!q->h_freq) {
       fprintf(stderr, "Error: allocating h_freq\n");
@@ -342,17 +363,20 @@ double srsran_channel_fading_execute(srsran_channel_fading_t* q,
                                      double                   init_time)
 {
   uint32_t counter = 0;
+  cf_t     a[SRSRAN_CHANNEL_FADING_MAXTAPS];
 
   if (q) {
     while (counter < nsamples) {
-      // Generate taps
-      generate_taps(q, (float)init_time);
+      // Compute the doppler dispersion of every tap
+      for (uint32_t i = 0; i < nof_taps[q->model]; i++) {
+        a[i] = get_doppler_dispersion(q, (float)init_time, i);
+      }
 
-      // Do not process more than N/2 samples
-      uint32_t n = SRSRAN_MIN(q->N / 2, nsamples - counter);
+      // Do not process more than a segment
+      uint32_t n = SRSRAN_MIN(q->segment_len, nsamples - counter);
 
       // Execute
-      filter_segment(q, &in[counter], &out[counter], n);
+      filter_segment(q, a, &in[counter], &out[counter], n);
 
       // Increment time
       init_time += n / q->srate;
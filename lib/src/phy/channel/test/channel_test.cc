@@ -0,0 +1,111 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/channel/channel.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+#include <cstring>
+
+static uint32_t    nof_channels = 4;
+static uint32_t    nof_sf       = 20;
+static uint32_t    srate        = (uint32_t)23.04e6;
+static std::string model        = "eva70";
+
+/*
+ * Runs the same random input through a channel running every link in the caller thread and through channels spreading
+ * the links over 2 to nof_channels threads. The fading and delay of every link only depend on its own state and the
+ * noise is added serially, so all of them must produce exactly the same output.
+ */
+int test_threads_match_serial()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("CHANNEL", false);
+  uint32_t              sf_len = srate / 1000;
+  logger.set_level(srslog::basic_levels::warning);
+
+  srsran::channel::args_t args = {};
+  args.enable                  = true;
+  args.fading_enable           = true;
+  args.fading_model            = model;
+  args.delay_enable            = true;
+  args.delay_period_s          = 1;
+  args.awgn_enable             = true;
+  args.awgn_snr_dB             = 20.0f;
+
+  std::vector<std::unique_ptr<srsran::channel> > channels;
+  for (uint32_t nof_threads = 1; nof_threads <= nof_channels; nof_threads++) {
+    args.nof_threads = nof_threads;
+    channels.emplace_back(new srsran::channel(args, nof_channels, logger));
+    channels.back()->set_srate(srate);
+  }
+
+  // Every channel keeps its own input and output buffers
+  std::vector<std::vector<cf_t> > in(channels.size() * nof_channels, std::vector<cf_t>(sf_len));
+  std::vector<std::vector<cf_t> > out(channels.size() * nof_channels, std::vector<cf_t>(sf_len));
+
+  srsran_random_t random = srsran_random_init(0x1234);
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    srsran_timestamp_t ts = {};
+    srsran_timestamp_init(&ts, sf / 1000, (sf % 1000) / 1000.0);
+
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      srsran_random_uniform_complex_dist_vector(random, in[i].data(), sf_len, -1.0f, 1.0f);
+    }
+
+    for (uint32_t c = 0; c < channels.size(); c++) {
+      cf_t* in_ptr[SRSRAN_MAX_CHANNELS]  = {};
+      cf_t* out_ptr[SRSRAN_MAX_CHANNELS] = {};
+      for (uint32_t i = 0; i < nof_channels; i++) {
+        if (c > 0) {
+          srsran_vec_cf_copy(in[c * nof_channels + i].data(), in[i].data(), sf_len);
+        }
+        in_ptr[i]  = in[c * nof_channels + i].data();
+        out_ptr[i] = out[c * nof_channels + i].data();
+      }
+      channels[c]->run(in_ptr, out_ptr, sf_len, ts);
+    }
+
+    for (uint32_t c = 1; c < channels.size(); c++) {
+      for (uint32_t i = 0; i < nof_channels; i++) {
+        TESTASSERT(memcmp(out[i].data(), out[c * nof_channels + i].data(), sizeof(cf_t) * sf_len) == 0);
+      }
+    }
+  }
+  srsran_random_free(random);
+
+  printf("-- %d channels with model %s: 1 to %d threads match\n", nof_channels, model.c_str(), nof_channels);
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  if (argc > 1) {
+    model = argv[1];
+  }
+
+  TESTASSERT(test_threads_match_serial() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -21,6 +21,7 @@
 
 #include "srsran/phy/channel/fading.h"
 #include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
 #include <complex.h>
 #include <math.h>
 #include <memory.h>
@@ -38,18 +39,116 @@ static bool enable_gui = false;
 
 static srsran_channel_fading_t channel_fading;
 
-static char     default_model[] = "epa5";
-static uint32_t duration_ms     = 1000;
-static char*    model           = default_model;
-static uint32_t srate           = (uint32_t)30.72e6;
-static uint32_t random_seed     = 0x12345678; // Default seed, deterministic channel
+static const char* default_models[] = {"epa5", "eva70", "etu300"};
+static uint32_t    duration_ms       = 1000;
+static const char* model             = NULL; // All the default models unless given
+static uint32_t    srate             = (uint32_t)30.72e6;
+static uint32_t    random_seed       = 0x12345678; // Default seed, deterministic channel
 
 #define INPUT_TYPE 0 /* 0: Dirac Delta; Otherwise: Random*/
 
+/*
+ * Tables provided in 36.104 R10 section B.2, the impulse response of the models without Doppler is checked against them
+ */
+#define DIRAC_NOF_MODELS 3
+static const char*    dirac_models[DIRAC_NOF_MODELS]   = {"epa0", "eva0", "etu0"};
+static const uint32_t dirac_nof_taps[DIRAC_NOF_MODELS] = {7, 9, 9};
+
+static const float dirac_delay_ns[DIRAC_NOF_MODELS][SRSRAN_CHANNEL_FADING_MAXTAPS] = {
+    /* EPA  */ {0, 30, 70, 90, 110, 190, 410, NAN, NAN},
+    /* EVA  */ {0, 30, 150, 310, 370, 710, 1090, 1730, 2510},
+    /* ETU  */ {0, 50, 120, 200, 230, 500, 1600, 2300, 5000}};
+
+static const float dirac_power_db[DIRAC_NOF_MODELS][SRSRAN_CHANNEL_FADING_MAXTAPS] = {
+    /* EPA  */ {+0.0f, -1.0f, -2.0f, -3.0f, -8.0f, -17.2f, -20.8f, NAN, NAN},
+    /* EVA  */ {+0.0f, -1.5f, -1.4f, -3.6f, -0.6f, -9.1f, -7.0f, -12.0f, -16.9f},
+    /* ETU  */ {-1.0f, -1.0f, -1.0f, +0.0f, +0.0f, +0.0f, -3.0f, -5.0f, -7.0f},
+};
+
+/*
+ * Time response of a tap delayed x samples, whose spectrum spans the bins [-N/2, N/2) of the channel FFT
+ */
+static double _Complex dirichlet(double x, uint32_t N)
+{
+  double _Complex den = 1.0 - cexp(_Complex_I * 2.0 * M_PI * x / N);
+  if (cabs(den) < 1e-9) {
+    return 1.0;
+  }
+  return cexp(-_Complex_I * M_PI * x) * (1.0 - cexp(_Complex_I * 2.0 * M_PI * x)) / (N * den);
+}
+
+/*
+ * Feeds a Dirac delta through a model without Doppler and compares the output of the first segment with the impulse
+ * response: every tap delayed by the path delay plus its excess delay and weighted by its power and its dispersion.
+ */
+static int test_dirac(uint32_t m)
+{
+  srsran_channel_fading_t q = {};
+  TESTASSERT(srsran_channel_fading_init(&q, srate, dirac_models[m], random_seed) == SRSRAN_SUCCESS);
+
+  // The delay spread must fit in the samples every FFT overlaps with the previous one
+  uint32_t ntaps     = dirac_nof_taps[m];
+  double   max_delay = dirac_delay_ns[m][ntaps - 1] * 1e-9 * srate;
+  TESTASSERT(q.path_delay + max_delay < q.N - q.segment_len);
+
+  uint32_t nsamples = q.segment_len;
+  cf_t*    in       = srsran_vec_cf_malloc(nsamples);
+  cf_t*    out      = srsran_vec_cf_malloc(nsamples);
+  TESTASSERT(in != NULL && out != NULL);
+  srsran_vec_cf_zero(in, nsamples);
+  in[0] = 1.0f;
+  srsran_channel_fading_execute(&q, in, out, nsamples, 0.0);
+
+  // Without Doppler the dispersion of every tap is constant. The tap responses are generated over the FFT shifted bins,
+  // which rotates every tap by pi times its delay
+  double _Complex c[SRSRAN_CHANNEL_FADING_MAXTAPS];
+  double          delay[SRSRAN_CHANNEL_FADING_MAXTAPS];
+  for (uint32_t i = 0; i < ntaps; i++) {
+    double _Complex a = 0;
+    for (uint32_t j = 0; j < SRSRAN_CHANNEL_FADING_NTERMS; j++) {
+      a += cos(q.coeff_a[i][j]) + _Complex_I * sin(q.coeff_b[i][j]);
+    }
+    delay[i] = dirac_delay_ns[m][i] * 1e-9 * srate + q.path_delay;
+    c[i]     = a / sqrt(SRSRAN_CHANNEL_FADING_NTERMS) * srsran_convert_dB_to_power(dirac_power_db[m][i]) *
+           cexp(-_Complex_I * M_PI * delay[i]);
+  }
+
+  double   max_error = 0.0;
+  double   peak      = 0.0;
+  uint32_t peak_idx  = 0;
+  for (uint32_t n = 0; n < nsamples; n++) {
+    double _Complex h = 0;
+    for (uint32_t i = 0; i < ntaps; i++) {
+      h += c[i] * dirichlet(n - delay[i], q.N);
+    }
+    max_error = SRSRAN_MAX(max_error, cabs(out[n] - h));
+    if (cabsf(out[n]) > peak) {
+      peak     = cabsf(out[n]);
+      peak_idx = n;
+    }
+  }
+
+  printf("-- Dirac %s: path_delay=%d; peak_idx=%d; error=%.1e\n",
+         dirac_models[m],
+         q.path_delay,
+         peak_idx,
+         max_error / peak);
+
+  free(in);
+  free(out);
+  srsran_channel_fading_free(&q);
+
+  // The response starts at the path delay and matches the taps
+  TESTASSERT(peak_idx >= q.path_delay && peak_idx <= q.path_delay + (uint32_t)ceil(max_delay));
+  TESTASSERT(max_error < 1e-3 * peak);
+
+  return SRSRAN_SUCCESS;
+}
+
 static void usage(char* prog)
 {
   printf("Usage: %s [mts]\n", prog);
-  printf("\t-m Channel model: epa5, eva70, etu300 [Default %s]\n", model);
+  printf("\t-m Channel model: epa5, eva70, etu300 [Default all of them]\n");
   printf("\t-t Simulation time in ms: [Default %d]\n", duration_ms);
   printf("\t-s Sampling rate in Hz: [Default %d]\n", srate);
   printf("\t-r Random generator seed: [Default %d]\n", random_seed);
@@ -110,6 +209,14 @@ int main(int argc, char** argv)
   srsran_dft_plan_t ifft;
   srsran_dft_plan_c(&ifft, srate / 1000, SRSRAN_DFT_BACKWARD);
 
+  // Check the impulse response of every model
+  for (uint32_t m = 0; m < DIRAC_NOF_MODELS; m++) {
+    if (test_dirac(m) != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error: impulse response of %s\n", dirac_models[m]);
+      goto clean_exit;
+    }
+  }
+
 #ifdef ENABLE_GUI
   plot_real_t plot_fft = NULL;
   plot_real_t plot_h   = NULL;
@@ -158,12 +265,6 @@ int main(int argc, char** argv)
   }
 #endif /* ENABLE_GUI */
 
-  // Initialise channel
-  if (srsran_channel_fading_init(&channel_fading, srate, model, 0x12345678)) {
-    fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%d\n", model, srate);
-    goto clean_exit;
-  }
-
   // Allocate buffers
   input_buffer = srsran_vec_cf_malloc(srate / 1000);
   if (!input_buffer) {
@@ -187,50 +288,69 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
-  printf("-- Starting Fading channel simulator. srate=%.2fMHz; model=%s; duration=%dms\n",
-         (double)srate / 1e6,
-         model,
-         duration_ms);
+  uint32_t nof_models = model ? 1 : (uint32_t)(sizeof(default_models) / sizeof(default_models[0]));
+  for (uint32_t m = 0; m < nof_models; m++) {
+    const char* m_name = model ? model : default_models[m];
 
-  for (int i = 0; i < duration_ms; i++) {
-    gettimeofday(&t[1], NULL);
-    srsran_channel_fading_execute(&channel_fading, input_buffer, output_buffer, srate / 1000, (double)i / 1000.0);
-    gettimeofday(&t[2], NULL);
-    get_time_interval(t);
-    time_usec += (uint64_t)(t->tv_sec * 1e6 + t->tv_usec);
+    // Initialise channel
+    if (srsran_channel_fading_init(&channel_fading, srate, m_name, random_seed)) {
+      fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%d\n", m_name, srate);
+      ret = SRSRAN_ERROR;
+      goto clean_exit;
+    }
 
-#ifdef ENABLE_GUI
-    if (enable_gui) {
-      srsran_dft_run_c_zerocopy(&fft, output_buffer, fft_buffer);
-      srsran_vec_prod_conj_ccc(fft_buffer, fft_buffer, fft_buffer, srate / 1000);
-      for (int j = 0; j < srate / 1000; j++) {
-        fft_mag[j] = srsran_convert_power_to_dB(__real__ fft_buffer[j]);
-      }
-      plot_real_setNewData(&plot_fft, fft_mag, srate / 1000);
+    printf("-- Starting Fading channel simulator. srate=%.2fMHz; model=%s; duration=%dms\n",
+           (double)srate / 1e6,
+           m_name,
+           duration_ms);
 
-      for (int j = 0; j < channel_fading.N; j++) {
-        fft_mag[j] = srsran_convert_amplitude_to_dB(cabsf(channel_fading.h_freq[j]));
-      }
-      plot_real_setNewData(&plot_h, fft_mag, channel_fading.N);
+    time_usec = 0;
+    for (int i = 0; i < duration_ms; i++) {
+      gettimeofday(&t[1], NULL);
+      srsran_channel_fading_execute(&channel_fading, input_buffer, output_buffer, srate / 1000, (double)i / 1000.0);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      time_usec += (uint64_t)(t->tv_sec * 1e6 + t->tv_usec);
 
-      for (int j = 0; j < srate / 1000; j++) {
-        imp[j] = cabsf(output_buffer[j]);
+#ifdef ENABLE_GUI
+      if (enable_gui) {
+        srsran_dft_run_c_zerocopy(&fft, output_buffer, fft_buffer);
+        srsran_vec_prod_conj_ccc(fft_buffer, fft_buffer, fft_buffer, srate / 1000);
+        for (int j = 0; j < srate / 1000; j++) {
+          fft_mag[j] = srsran_convert_power_to_dB(__real__ fft_buffer[j]);
+        }
+        plot_real_setNewData(&plot_fft, fft_mag, srate / 1000);
+
+        for (int j = 0; j < channel_fading.N; j++) {
+          fft_mag[j] = srsran_convert_amplitude_to_dB(cabsf(channel_fading.h_freq[j]));
+        }
+        plot_real_setNewData(&plot_h, fft_mag, channel_fading.N);
+
+        for (int j = 0; j < srate / 1000; j++) {
+          imp[j] = cabsf(output_buffer[j]);
+        }
+        plot_real_setNewData(&plot_imp, imp, channel_fading.N);
+
+        usleep(1000);
       }
-      plot_real_setNewData(&plot_imp, imp, channel_fading.N);
+#endif /* ENABLE_GUI */
+    }
 
-      usleep(1000);
+    // Print results
+    if (time_usec) {
+      double msps = duration_ms * (srate / 1000.0) / (double)time_usec;
+      printf("Ok ... %s: %.1f MSps (%.1f times real time)\n", m_name, msps, msps * 1e6 / srate);
+      ret = SRSRAN_SUCCESS;
+    } else {
+      printf("Error in Msps calculation: undefined division\n");
+      ret = SRSRAN_ERROR;
     }
-#endif /* ENABLE_GUI */
-  }
 
-  // Print results and exit
-  double msps = 0;
-  if (time_usec) {
-    msps = duration_ms * (srate / 1000.0) / (double)time_usec;
-    printf("Ok ... %.1f MSps\n", msps);
-    ret = SRSRAN_SUCCESS;
-  } else {
-    printf("Error in Msps calculation: undefined division\n");
+    srsran_channel_fading_free(&channel_fading);
+    bzero(&channel_fading, sizeof(srsran_channel_fading_t));
+    if (ret != SRSRAN_SUCCESS) {
+      break;
+    }
   }
 
 clean_exit:
@@ -25,6 +25,7 @@
 #include <math.h>
 #include <pwd.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "srsran/phy/dft/dft.h"
@@ -34,9 +35,16 @@
 #define dft_floor(a, b) (a / b)
 
 #define FFTW_WISDOM_FILE "%s/.srsran_fftwisdom"
+#define FFTW_WISDOM_ENV "SRSRAN_FFTW_WISDOM"
 
 static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 {
+  // A wisdom file shared by all the processes, e.g. precomputed at install, takes precedence over the user's one
+  const char* shared_path = getenv(FFTW_WISDOM_ENV);
+  if (shared_path != NULL && shared_path[0] != '\0') {
+    return snprintf(full_path, n, "%s", shared_path);
+  }
+
   const char* homedir = NULL;
   if ((homedir = getenv("HOME")) == NULL) {
     homedir = getpwuid(getuid())->pw_dir;
@@ -53,15 +61,53 @@ static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 
 static pthread_mutex_t fft_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+#define DFT_PLAN_CACHE_SIZE 512
+
+/* Process-wide cache of the one-dimensional plans, shared by all the DFT objects with the same size, direction and
+ * mode. The entries are appended under fft_mutex and published by incrementing dft_cache_len, they are never modified
+ * afterwards, so the lookups do not need the lock. Users execute the shared plans on their own buffers with the FFTW
+ * new-array interface, which is thread-safe. */
+typedef struct {
+  int               size;
+  srsran_dft_dir_t  dir;
+  srsran_dft_mode_t mode;
+  fftwf_plan        p;
+} dft_cache_entry_t;
+
+static dft_cache_entry_t dft_cache[DFT_PLAN_CACHE_SIZE];
+static uint32_t          dft_cache_len = 0;
+
+static srsran_dft_metrics_t dft_metrics = {};
+
+static uint64_t dft_time_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+// Accounts a call to the FFTW planner, it must be called with fft_mutex locked
+static void dft_metrics_plan(uint64_t t_start_ns)
+{
+  uint64_t t_ns = dft_time_ns() - t_start_ns;
+  dft_metrics.nof_plans_created++;
+  dft_metrics.plan_time_ns += t_ns;
+  dft_metrics.max_plan_time_ns = SRSRAN_MAX(dft_metrics.max_plan_time_ns, t_ns);
+}
+
 // This function is called in the beggining of any executable where it is linked
 __attribute__((constructor)) static void srsran_dft_load()
 {
 #ifdef FFTW_WISDOM_FILE
-  char full_path[256];
+  uint64_t t_start = dft_time_ns();
+  char     full_path[256];
   get_fftw_wisdom_file(full_path, sizeof(full_path));
-  // lockf needs a file descriptor open for writing, so this must be r+
+  // lockf needs a file descriptor open for writing, so this must be r+. A read-only shared file is imported unlocked
   FILE* fd = fopen(full_path, "r+");
   if (fd == NULL) {
+    if (fftwf_import_wisdom_from_filename(full_path)) {
+      dft_metrics.wisdom_load_ns = dft_time_ns() - t_start;
+    }
     return;
   }
   if (lockf(fileno(fd), F_LOCK, 0) == -1) {
@@ -76,6 +122,7 @@ __attribute__((constructor)) static void srsran_dft_load()
     return;
   }
   fclose(fd);
+  dft_metrics.wisdom_load_ns = dft_time_ns() - t_start;
 #else
   printf("Warning: FFTW Wisdom file not defined\n");
 #endif
@@ -104,9 +151,107 @@ __attribute__((destructor)) void srsran_dft_exit()
   }
   fclose(fd);
 #endif
+  pthread_mutex_lock(&fft_mutex);
+  for (uint32_t i = 0; i < dft_cache_len; i++) {
+    fftwf_destroy_plan(dft_cache[i].p);
+  }
+  dft_cache_len = 0;
+  pthread_mutex_unlock(&fft_mutex);
   fftwf_cleanup();
 }
 
+static fftwf_plan dft_cache_find(int size, srsran_dft_dir_t dir, srsran_dft_mode_t mode)
+{
+  uint32_t len = __atomic_load_n(&dft_cache_len, __ATOMIC_ACQUIRE);
+  for (uint32_t i = 0; i < len; i++) {
+    if (dft_cache[i].size == size && dft_cache[i].dir == dir && dft_cache[i].mode == mode) {
+      return dft_cache[i].p;
+    }
+  }
+  return NULL;
+}
+
+/* Returns the shared plan for the given size, direction and mode, creating it the first time. Returns NULL if the
+ * cache is full or the planner fails, the caller shall create a private plan then. */
+static fftwf_plan dft_cache_get(int size, srsran_dft_dir_t dir, srsran_dft_mode_t mode)
+{
+  fftwf_plan p = dft_cache_find(size, dir, mode);
+  if (p != NULL) {
+    __atomic_fetch_add(&dft_metrics.nof_cache_hits, 1, __ATOMIC_RELAXED);
+    return p;
+  }
+
+  pthread_mutex_lock(&fft_mutex);
+
+  // Another thread may have created it while waiting for the lock
+  p = dft_cache_find(size, dir, mode);
+  if (p != NULL) {
+    __atomic_fetch_add(&dft_metrics.nof_cache_hits, 1, __ATOMIC_RELAXED);
+  } else if (dft_cache_len < DFT_PLAN_CACHE_SIZE) {
+    // Plan on scratch buffers with the same alignment as the ones of the users
+    size_t sample_sz = (mode == SRSRAN_DFT_COMPLEX) ? sizeof(fftwf_complex) : sizeof(float);
+    void*  in        = fftwf_malloc(sample_sz * size);
+    void*  out       = fftwf_malloc(sample_sz * size);
+
+    if (in != NULL && out != NULL) {
+      uint64_t t_start = dft_time_ns();
+      if (mode == SRSRAN_DFT_COMPLEX) {
+        int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+        p        = fftwf_plan_dft_1d(size, in, out, sign, FFTW_TYPE);
+      } else {
+        int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+        p        = fftwf_plan_r2r_1d(size, in, out, sign, FFTW_TYPE);
+      }
+      dft_metrics_plan(t_start);
+    }
+    fftwf_free(in);
+    fftwf_free(out);
+
+    if (p != NULL) {
+      dft_cache[dft_cache_len] = (dft_cache_entry_t){size, dir, mode, p};
+      __atomic_store_n(&dft_cache_len, dft_cache_len + 1, __ATOMIC_RELEASE);
+    }
+  }
+
+  pthread_mutex_unlock(&fft_mutex);
+  return p;
+}
+
+// Releases the plan of a DFT object before replanning it, shared plans are only destroyed at exit
+static void dft_release_1d(srsran_dft_plan_t* plan)
+{
+  pthread_mutex_lock(&fft_mutex);
+  if (plan->p != NULL && !plan->is_shared) {
+    fftwf_destroy_plan(plan->p);
+  }
+  plan->p = NULL;
+  pthread_mutex_unlock(&fft_mutex);
+}
+
+/* Points plan to the shared plan of its size, or creates a private plan on its own buffers if it cannot be shared */
+static int dft_plan_1d(srsran_dft_plan_t* plan, int dft_points, srsran_dft_dir_t dir, srsran_dft_mode_t mode)
+{
+  plan->p         = dft_cache_get(dft_points, dir, mode);
+  plan->is_shared = (plan->p != NULL);
+  if (plan->p != NULL) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&fft_mutex);
+  uint64_t t_start = dft_time_ns();
+  if (mode == SRSRAN_DFT_COMPLEX) {
+    int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+    plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  } else {
+    int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+    plan->p  = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  }
+  dft_metrics_plan(t_start);
+  pthread_mutex_unlock(&fft_mutex);
+
+  return (plan->p != NULL) ? 0 : -1;
+}
+
 int srsran_dft_plan(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir, srsran_dft_mode_t mode)
 {
   bzero(plan, sizeof(srsran_dft_plan_t));
@@ -161,7 +306,9 @@ int srsran_dft_replan_guru_c(srsran_dft_plan_t* plan,
   /* Destroy current plan */
   fftwf_destroy_plan(plan->p);
 
+  uint64_t t_start = dft_time_ns();
   plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  dft_metrics_plan(t_start);
 
   pthread_mutex_unlock(&fft_mutex);
 
@@ -176,47 +323,35 @@ int srsran_dft_replan_guru_c(srsran_dft_plan_t* plan,
 
 int srsran_dft_replan_c(srsran_dft_plan_t* plan, const int new_dft_points)
 {
-  int sign = (plan->dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-
   // No change in size, skip re-planning
   if (plan->size == new_dft_points) {
     return 0;
   }
 
-  pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
-  }
-  plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
-
-  if (!plan->p) {
+  dft_release_1d(plan);
+  if (dft_plan_1d(plan, new_dft_points, plan->dir, SRSRAN_DFT_COMPLEX)) {
     return -1;
   }
   plan->size = new_dft_points;
   return 0;
 }
 
-int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
+static int dft_plan_guru_c(srsran_dft_plan_t* plan,
                            const int          dft_points,
                            srsran_dft_dir_t   dir,
                            cf_t*              in_buffer,
                            cf_t*              out_buffer,
-                           int                istride,
-                           int                ostride,
-                           int                how_many,
-                           int                idist,
-                           int                odist)
+                           const fftwf_iodim* iodim,
+                           int                howmany_rank,
+                           const fftwf_iodim* howmany_dims)
 {
   int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
 
-  const fftwf_iodim iodim        = {dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
-
   pthread_mutex_lock(&fft_mutex);
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  uint64_t t_start = dft_time_ns();
+  plan->p = fftwf_plan_guru_dft(1, iodim, howmany_rank, howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  dft_metrics_plan(t_start);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -237,18 +372,46 @@ int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
   return 0;
 }
 
-int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir)
+int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
+                           const int          dft_points,
+                           srsran_dft_dir_t   dir,
+                           cf_t*              in_buffer,
+                           cf_t*              out_buffer,
+                           int                istride,
+                           int                ostride,
+                           int                how_many,
+                           int                idist,
+                           int                odist)
 {
-  allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
+  const fftwf_iodim iodim        = {dft_points, istride, ostride};
+  const fftwf_iodim howmany_dims = {how_many, idist, odist};
 
-  pthread_mutex_lock(&fft_mutex);
+  return dft_plan_guru_c(plan, dft_points, dir, in_buffer, out_buffer, &iodim, 1, &howmany_dims);
+}
 
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-  plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+int srsran_dft_plan_guru_batch_c(srsran_dft_plan_t* plan,
+                                 const int          dft_points,
+                                 srsran_dft_dir_t   dir,
+                                 cf_t*              in_buffer,
+                                 cf_t*              out_buffer,
+                                 int                how_many_outer,
+                                 int                idist_outer,
+                                 int                odist_outer,
+                                 int                how_many,
+                                 int                idist,
+                                 int                odist)
+{
+  const fftwf_iodim iodim           = {dft_points, 1, 1};
+  const fftwf_iodim howmany_dims[2] = {{how_many_outer, idist_outer, odist_outer}, {how_many, idist, odist}};
 
-  pthread_mutex_unlock(&fft_mutex);
+  return dft_plan_guru_c(plan, dft_points, dir, in_buffer, out_buffer, &iodim, 2, howmany_dims);
+}
 
-  if (!plan->p) {
+int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir)
+{
+  allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
+
+  if (dft_plan_1d(plan, dft_points, dir, SRSRAN_DFT_COMPLEX)) {
     return -1;
   }
   plan->size      = dft_points;
@@ -267,17 +430,8 @@ int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_
 
 int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
 {
-  int sign = (plan->dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
-
-  pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
-  }
-  plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
-
-  if (!plan->p) {
+  dft_release_1d(plan);
+  if (dft_plan_1d(plan, new_dft_points, plan->dir, SRSRAN_REAL)) {
     return -1;
   }
   plan->size = new_dft_points;
@@ -287,13 +441,8 @@ int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
 int srsran_dft_plan_r(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir)
 {
   allocate(plan, sizeof(float), sizeof(float), dft_points);
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
-  pthread_mutex_lock(&fft_mutex);
-  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
-
-  if (!plan->p) {
+  if (dft_plan_1d(plan, dft_points, dir, SRSRAN_REAL)) {
     return -1;
   }
   plan->size      = dft_points;
@@ -372,7 +521,7 @@ void srsran_dft_run_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out)
   fftwf_complex* f_out = plan->out;
 
   copy_pre((uint8_t*)plan->in, (uint8_t*)in, sizeof(cf_t), plan->size, plan->forward, plan->mirror, plan->dc);
-  fftwf_execute(plan->p);
+  fftwf_execute_dft(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / sqrtf(plan->size);
     srsran_vec_sc_prod_cfc(f_out, norm, f_out, plan->size);
@@ -402,7 +551,7 @@ void srsran_dft_run_r(srsran_dft_plan_t* plan, const float* in, float* out)
   float* f_out = plan->out;
 
   memcpy(plan->in, in, sizeof(float) * plan->size);
-  fftwf_execute(plan->p);
+  fftwf_execute_r2r(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / plan->size;
     srsran_vec_sc_prod_fff(f_out, norm, f_out, plan->size);
@@ -429,8 +578,77 @@ void srsran_dft_plan_free(srsran_dft_plan_t* plan)
     if (plan->out)
       fftwf_free(plan->out);
   }
-  if (plan->p)
+  if (plan->p && !plan->is_shared)
     fftwf_destroy_plan(plan->p);
   pthread_mutex_unlock(&fft_mutex);
   bzero(plan, sizeof(srsran_dft_plan_t));
 }
+
+void srsran_dft_get_metrics(srsran_dft_metrics_t* metrics)
+{
+  pthread_mutex_lock(&fft_mutex);
+  *metrics                = dft_metrics;
+  metrics->nof_cache_hits = __atomic_load_n(&dft_metrics.nof_cache_hits, __ATOMIC_RELAXED);
+  metrics->nof_cached     = dft_cache_len;
+  pthread_mutex_unlock(&fft_mutex);
+}
+
+uint32_t srsran_dft_metrics_info(char* str, uint32_t str_len)
+{
+  srsran_dft_metrics_t metrics = {};
+  srsran_dft_get_metrics(&metrics);
+  return srsran_print_check(str,
+                            str_len,
+                            0,
+                            "DFT plans: %d shared, %ld cache hits, %ld planned in %.1f ms (max %.1f ms), wisdom loaded in "
+                            "%.1f ms",
+                            metrics.nof_cached,
+                            (long)metrics.nof_cache_hits,
+                            (long)metrics.nof_plans_created,
+                            (double)metrics.plan_time_ns / 1e6,
+                            (double)metrics.max_plan_time_ns / 1e6,
+                            (double)metrics.wisdom_load_ns / 1e6);
+}
+
+int srsran_dft_precompute_wisdom(int dft_points, bool exhaustive)
+{
+  unsigned       flags = exhaustive ? FFTW_EXHAUSTIVE : FFTW_PATIENT;
+  fftwf_complex* in    = fftwf_malloc(sizeof(fftwf_complex) * dft_points);
+  fftwf_complex* out   = fftwf_malloc(sizeof(fftwf_complex) * dft_points);
+  int            ret   = 0;
+
+  if (in == NULL || out == NULL) {
+    ret = -1;
+  }
+
+  const int signs[2] = {FFTW_FORWARD, FFTW_BACKWARD};
+
+  pthread_mutex_lock(&fft_mutex);
+  for (uint32_t i = 0; i < 2 && ret == 0; i++) {
+    fftwf_plan p = fftwf_plan_dft_1d(dft_points, in, out, signs[i], flags);
+    if (p == NULL) {
+      ret = -1;
+    } else {
+      fftwf_destroy_plan(p);
+    }
+  }
+  pthread_mutex_unlock(&fft_mutex);
+
+  fftwf_free(in);
+  fftwf_free(out);
+  return ret;
+}
+
+int srsran_dft_export_wisdom(const char* filename)
+{
+  char full_path[256];
+  if (filename == NULL) {
+    get_fftw_wisdom_file(full_path, sizeof(full_path));
+    filename = full_path;
+  }
+
+  pthread_mutex_lock(&fft_mutex);
+  int ret = fftwf_export_wisdom_to_filename(filename) ? 0 : -1;
+  pthread_mutex_unlock(&fft_mutex);
+  return ret;
+}
@@ -167,40 +167,83 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
     srsran_vec_cf_zero(in_buffer, q->sf_sz);
   }
 
+  // If Guru DFTs were allocated, free
+  if (q->fft_plan_batch.size) {
+    srsran_dft_plan_free(&q->fft_plan_batch);
+  }
   for (int slot = 0; slot < SRSRAN_NOF_SLOTS_PER_SF; slot++) {
-    // If Guru DFT was allocated, free
     if (q->fft_plan_sf[slot].size) {
       srsran_dft_plan_free(&q->fft_plan_sf[slot]);
     }
+  }
 
-    // Create Tx/Rx plans
-    if (dir == SRSRAN_DFT_FORWARD) {
-      if (srsran_dft_plan_guru_c(&q->fft_plan_sf[slot],
-                                 symbol_sz,
-                                 dir,
-                                 in_buffer + cp1 + q->slot_sz * slot - q->window_offset_n,
-                                 q->tmp,
-                                 1,
-                                 1,
-                                 SRSRAN_CP_NSYMB(cp),
-                                 symbol_sz + cp2,
-                                 symbol_sz)) {
-        ERROR("Creating Guru DFT plan (%d)", slot);
-        return SRSRAN_ERROR;
-      }
-    } else {
-      if (srsran_dft_plan_guru_c(&q->fft_plan_sf[slot],
-                                 symbol_sz,
-                                 dir,
-                                 q->tmp,
-                                 out_buffer + cp1 + q->slot_sz * slot,
-                                 1,
-                                 1,
-                                 SRSRAN_CP_NSYMB(cp),
-                                 symbol_sz,
-                                 symbol_sz + cp2)) {
-        ERROR("Creating Guru inverse-DFT plan (%d)", slot);
-        return SRSRAN_ERROR;
+  // A single plan transforms all the symbols of the subframe. The slot is the outer dimension because the first CP of
+  // every slot is longer than the others
+  int sf_symbols_sz = (int)(q->nof_symbols * symbol_sz);
+  if (dir == SRSRAN_DFT_FORWARD) {
+    if (srsran_dft_plan_guru_batch_c(&q->fft_plan_batch,
+                                     symbol_sz,
+                                     dir,
+                                     in_buffer + cp1 - q->window_offset_n,
+                                     q->tmp,
+                                     SRSRAN_NOF_SLOTS_PER_SF,
+                                     q->slot_sz,
+                                     sf_symbols_sz,
+                                     q->nof_symbols,
+                                     symbol_sz + cp2,
+                                     symbol_sz)) {
+      ERROR("Creating Guru DFT plan");
+      return SRSRAN_ERROR;
+    }
+  } else {
+    if (srsran_dft_plan_guru_batch_c(&q->fft_plan_batch,
+                                     symbol_sz,
+                                     dir,
+                                     q->tmp,
+                                     out_buffer + cp1,
+                                     SRSRAN_NOF_SLOTS_PER_SF,
+                                     sf_symbols_sz,
+                                     q->slot_sz,
+                                     q->nof_symbols,
+                                     symbol_sz,
+                                     symbol_sz + cp2)) {
+      ERROR("Creating Guru inverse-DFT plan");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  // MBSFN subframes transform the non-MBSFN slot on its own
+  if (sf_type == SRSRAN_SF_MBSFN) {
+    for (int slot = 0; slot < SRSRAN_NOF_SLOTS_PER_SF; slot++) {
+      // Create Tx/Rx plans
+      if (dir == SRSRAN_DFT_FORWARD) {
+        if (srsran_dft_plan_guru_c(&q->fft_plan_sf[slot],
+                                   symbol_sz,
+                                   dir,
+                                   in_buffer + cp1 + q->slot_sz * slot - q->window_offset_n,
+                                   q->tmp,
+                                   1,
+                                   1,
+                                   SRSRAN_CP_NSYMB(cp),
+                                   symbol_sz + cp2,
+                                   symbol_sz)) {
+          ERROR("Creating Guru DFT plan (%d)", slot);
+          return SRSRAN_ERROR;
+        }
+      } else {
+        if (srsran_dft_plan_guru_c(&q->fft_plan_sf[slot],
+                                   symbol_sz,
+                                   dir,
+                                   q->tmp,
+                                   out_buffer + cp1 + q->slot_sz * slot,
+                                   1,
+                                   1,
+                                   SRSRAN_CP_NSYMB(cp),
+                                   symbol_sz,
+                                   symbol_sz + cp2)) {
+          ERROR("Creating Guru inverse-DFT plan (%d)", slot);
+          return SRSRAN_ERROR;
+        }
       }
     }
   }
@@ -248,6 +291,9 @@ void srsran_ofdm_free_(srsran_ofdm_t* q)
   srsran_dft_plan_free(&q->fft_plan);
 
 #ifndef AVOID_GURU
+  if (q->fft_plan_batch.init_size) {
+    srsran_dft_plan_free(&q->fft_plan_batch);
+  }
   for (int slot = 0; slot < 2; slot++) {
     if (q->fft_plan_sf[slot].init_size) {
       srsran_dft_plan_free(&q->fft_plan_sf[slot]);
@@ -468,39 +514,34 @@ void srsran_ofdm_rx_slot_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
-/* Transforms input samples into output OFDM symbols.
- * Performs FFT on a each symbol and removes CP.
+#ifndef AVOID_GURU
+/* Moves the used subcarriers of nof_symbols DFT outputs into the resource grid, starting from the subframe symbol l0.
+ * The window offset, phase compensation and normalization are applied while moving them.
  */
-static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
+static void ofdm_rx_demap(srsran_ofdm_t* q, const cf_t* tmp, cf_t* output, uint32_t l0, uint32_t nof_symbols)
 {
-#ifdef AVOID_GURU
-  srsran_ofdm_rx_slot_ng(
-      q, q->cfg.in_buffer + slot_in_sf * q->slot_sz, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
-#else
-  uint32_t nof_symbols = q->nof_symbols;
-  uint32_t nof_re = q->nof_re;
-  cf_t* output = q->cfg.out_buffer + slot_in_sf * nof_re * nof_symbols;
   uint32_t symbol_sz = q->cfg.symbol_sz;
-  float norm = 1.0f / sqrtf(q->fft_plan.size);
-  cf_t* tmp = q->tmp;
-  uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
+  uint32_t nof_re    = q->nof_re;
+  uint32_t half_re   = nof_re / 2;
+  uint32_t dc        = (q->fft_plan.dc) ? 1 : 0;
+  float    norm      = 1.0f / sqrtf(q->fft_plan.size);
 
-  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
+  for (uint32_t l = l0; l < l0 + nof_symbols; l++) {
+    const cf_t* neg = tmp + symbol_sz - half_re;
+    const cf_t* pos = tmp + dc;
 
-  for (int i = 0; i < q->nof_symbols; i++) {
-    // Apply frequency domain window offset
+    // Apply frequency domain window offset, only to the used subcarriers
     if (q->window_offset_n) {
-      srsran_vec_prod_ccc(tmp, q->window_offset_buffer, tmp, symbol_sz);
+      srsran_vec_prod_ccc(neg, &q->window_offset_buffer[symbol_sz - half_re], output, half_re);
+      srsran_vec_prod_ccc(pos, &q->window_offset_buffer[dc], output + half_re, half_re);
+      neg = output;
+      pos = output + half_re;
     }
 
-    // Perform FFT shift
-    memcpy(output, tmp + symbol_sz - nof_re / 2, sizeof(cf_t) * nof_re / 2);
-    memcpy(output + nof_re / 2, &tmp[dc], sizeof(cf_t) * nof_re / 2);
-
-    // Normalize output
+    // Perform FFT shift and normalize output
     if (isnormal(q->cfg.phase_compensation_hz)) {
       // Get phase compensation
-      cf_t phase_compensation = conjf(q->phase_compensation[slot_in_sf * q->nof_symbols + i]);
+      cf_t phase_compensation = conjf(q->phase_compensation[l]);
 
       // Apply normalization
       if (q->fft_plan.norm) {
@@ -508,17 +549,51 @@ static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
       }
 
       // Apply correction
-      srsran_vec_sc_prod_ccc(output, phase_compensation, output, nof_re);
+      srsran_vec_sc_prod_ccc(neg, phase_compensation, output, half_re);
+      srsran_vec_sc_prod_ccc(pos, phase_compensation, output + half_re, half_re);
     } else if (q->fft_plan.norm) {
-      srsran_vec_sc_prod_cfc(output, norm, output, nof_re);
+      srsran_vec_sc_prod_cfc(neg, norm, output, half_re);
+      srsran_vec_sc_prod_cfc(pos, norm, output + half_re, half_re);
+    } else if (!q->window_offset_n) {
+      srsran_vec_cf_copy(output, neg, half_re);
+      srsran_vec_cf_copy(output + half_re, pos, half_re);
     }
 
     tmp += symbol_sz;
     output += nof_re;
   }
+}
+#endif
+
+/* Transforms input samples into output OFDM symbols.
+ * Performs FFT on a each symbol and removes CP.
+ */
+static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
+{
+#ifdef AVOID_GURU
+  srsran_ofdm_rx_slot_ng(
+      q, q->cfg.in_buffer + slot_in_sf * q->slot_sz, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
+#else
+  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
+
+  ofdm_rx_demap(q,
+                q->tmp,
+                q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols,
+                slot_in_sf * q->nof_symbols,
+                q->nof_symbols);
 #endif
 }
 
+#ifndef AVOID_GURU
+/* Transforms all the symbols of a subframe with a single DFT plan */
+static void ofdm_rx_sf_batch(srsran_ofdm_t* q)
+{
+  srsran_dft_run_guru_c(&q->fft_plan_batch);
+
+  ofdm_rx_demap(q, q->tmp, q->cfg.out_buffer, 0, q->nof_symbols * SRSRAN_NOF_SLOTS_PER_SF);
+}
+#endif
+
 static void ofdm_rx_slot_mbsfn(srsran_ofdm_t* q, cf_t* input, cf_t* output)
 {
   uint32_t i;
@@ -554,9 +629,13 @@ void srsran_ofdm_rx_sf(srsran_ofdm_t* q)
     srsran_vec_prod_ccc(q->cfg.in_buffer, q->shift_buffer, q->cfg.in_buffer, q->sf_sz);
   }
   if (!q->mbsfn_subframe) {
+#ifdef AVOID_GURU
     for (uint32_t n = 0; n < SRSRAN_NOF_SLOTS_PER_SF; n++) {
       ofdm_rx_slot(q, n);
     }
+#else
+    ofdm_rx_sf_batch(q);
+#endif
   } else {
     ofdm_rx_slot_mbsfn(q, q->cfg.in_buffer, q->cfg.out_buffer);
     ofdm_rx_slot(q, 1);
@@ -579,52 +658,33 @@ void srsran_ofdm_rx_sf_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
-/* Transforms input OFDM symbols into output samples.
- * Performs the FFT on each symbol and adds CP.
+#ifndef AVOID_GURU
+/* Maps nof_symbols symbols of the resource grid into the inverse-DFT inputs, starting from the subframe symbol l0.
+ * The inverse DFT is linear, so the normalization and phase compensation are applied to the subcarriers while mapping
+ * them, instead of to the time-domain samples.
  */
-static void ofdm_tx_slot(srsran_ofdm_t* q, int slot_in_sf)
+static void ofdm_tx_map(srsran_ofdm_t* q, const cf_t* input, cf_t* tmp, uint32_t l0, uint32_t nof_symbols)
 {
-  uint32_t    symbol_sz = q->cfg.symbol_sz;
-  srsran_cp_t cp        = q->cfg.cp;
-
-  cf_t* input  = q->cfg.in_buffer + slot_in_sf * q->nof_re * q->nof_symbols;
-  cf_t* output = q->cfg.out_buffer + slot_in_sf * q->slot_sz;
-
-#ifdef AVOID_GURU
-  for (int i = 0; i < q->nof_symbols; i++) {
-    int cp_len = SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
-    memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
-    srsran_dft_run_c(&q->fft_plan, q->tmp, &output[cp_len]);
-    input += q->nof_re;
-    /* add CP */
-    memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
-    output += symbol_sz + cp_len;
-  }
-#else
-  uint32_t nof_symbols = q->nof_symbols;
-  uint32_t nof_re = q->nof_re;
-  float norm = 1.0f / sqrtf(symbol_sz);
-  cf_t* tmp = q->tmp;
-
-  bzero(tmp, q->slot_sz);
-  uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
+  uint32_t symbol_sz = q->cfg.symbol_sz;
+  uint32_t nof_re    = q->nof_re;
+  uint32_t half_re   = nof_re / 2;
+  uint32_t dc        = (q->fft_plan.dc) ? 1 : 0;
+  float    norm      = 1.0f / sqrtf(symbol_sz);
 
-  for (int i = 0; i < nof_symbols; i++) {
-    srsran_vec_cf_copy(&tmp[dc], &input[nof_re / 2], nof_re / 2);
-    srsran_vec_cf_copy(&tmp[symbol_sz - nof_re / 2], &input[0], nof_re / 2);
+  for (uint32_t l = l0; l < l0 + nof_symbols; l++) {
+    cf_t* neg = tmp + symbol_sz - half_re;
+    cf_t* pos = tmp + dc;
 
-    input += nof_re;
-    tmp += symbol_sz;
-  }
+    if (dc) {
+      tmp[0] = 0.0f;
+    }
 
-  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
-
-  for (int i = 0; i < nof_symbols; i++) {
-    int cp_len = SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
+    // Zero the guard band, the buffer is shared with the MBSFN slot which maps its subcarriers in the middle
+    srsran_vec_cf_zero(pos + half_re, symbol_sz - nof_re - dc);
 
     if (isnormal(q->cfg.phase_compensation_hz)) {
       // Get phase compensation
-      cf_t phase_compensation = q->phase_compensation[slot_in_sf * q->nof_symbols + i];
+      cf_t phase_compensation = q->phase_compensation[l];
 
       // Apply normalization
       if (q->fft_plan.norm) {
@@ -632,11 +692,30 @@ static void ofdm_tx_slot(srsran_ofdm_t* q, int slot_in_sf)
       }
 
       // Apply correction
-      srsran_vec_sc_prod_ccc(&output[cp_len], phase_compensation, &output[cp_len], symbol_sz);
+      srsran_vec_sc_prod_ccc(&input[half_re], phase_compensation, pos, half_re);
+      srsran_vec_sc_prod_ccc(&input[0], phase_compensation, neg, half_re);
     } else if (q->fft_plan.norm) {
-      srsran_vec_sc_prod_cfc(&output[cp_len], norm, &output[cp_len], symbol_sz);
+      srsran_vec_sc_prod_cfc(&input[half_re], norm, pos, half_re);
+      srsran_vec_sc_prod_cfc(&input[0], norm, neg, half_re);
+    } else {
+      srsran_vec_cf_copy(pos, &input[half_re], half_re);
+      srsran_vec_cf_copy(neg, &input[0], half_re);
     }
 
+    input += nof_re;
+    tmp += symbol_sz;
+  }
+}
+
+/* Applies CFR and adds the CP to the symbols of a slot after the inverse DFT */
+static void ofdm_tx_cp(srsran_ofdm_t* q, cf_t* output)
+{
+  uint32_t    symbol_sz = q->cfg.symbol_sz;
+  srsran_cp_t cp        = q->cfg.cp;
+
+  for (uint32_t i = 0; i < q->nof_symbols; i++) {
+    int cp_len = SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
+
     // CFR: Process the time-domain signal without the CP
     if (q->cfg.cfr_tx_cfg.cfr_enable) {
       srsran_cfr_process(&q->tx_cfr, output + cp_len, output + cp_len);
@@ -646,13 +725,61 @@ static void ofdm_tx_slot(srsran_ofdm_t* q, int slot_in_sf)
     srsran_vec_cf_copy(output, &output[symbol_sz], cp_len);
     output += symbol_sz + cp_len;
   }
+}
+#endif
+
+/* Transforms input OFDM symbols into output samples.
+ * Performs the FFT on each symbol and adds CP.
+ */
+static void ofdm_tx_slot(srsran_ofdm_t* q, int slot_in_sf)
+{
+  cf_t* input  = q->cfg.in_buffer + slot_in_sf * q->nof_re * q->nof_symbols;
+  cf_t* output = q->cfg.out_buffer + slot_in_sf * q->slot_sz;
+
+#ifdef AVOID_GURU
+  uint32_t    symbol_sz = q->cfg.symbol_sz;
+  srsran_cp_t cp        = q->cfg.cp;
+
+  for (int i = 0; i < q->nof_symbols; i++) {
+    int cp_len = SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
+    memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
+    srsran_dft_run_c(&q->fft_plan, q->tmp, &output[cp_len]);
+    input += q->nof_re;
+    /* add CP */
+    memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
+    output += symbol_sz + cp_len;
+  }
+#else
+  ofdm_tx_map(q, input, q->tmp, slot_in_sf * q->nof_symbols, q->nof_symbols);
+
+  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
+
+  ofdm_tx_cp(q, output);
 #endif
 }
 
+#ifndef AVOID_GURU
+/* Transforms all the symbols of a subframe with a single inverse-DFT plan */
+static void ofdm_tx_sf_batch(srsran_ofdm_t* q)
+{
+  ofdm_tx_map(q, q->cfg.in_buffer, q->tmp, 0, q->nof_symbols * SRSRAN_NOF_SLOTS_PER_SF);
+
+  srsran_dft_run_guru_c(&q->fft_plan_batch);
+
+  for (uint32_t n = 0; n < SRSRAN_NOF_SLOTS_PER_SF; n++) {
+    ofdm_tx_cp(q, q->cfg.out_buffer + n * q->slot_sz);
+  }
+}
+#endif
+
 void ofdm_tx_slot_mbsfn(srsran_ofdm_t* q, cf_t* input, cf_t* output)
 {
   uint32_t symbol_sz = q->cfg.symbol_sz;
 
+  // Zero the guards, the buffer may hold the inverse-DFT inputs of the previous subframe
+  srsran_vec_cf_zero(q->tmp, q->nof_guards);
+  srsran_vec_cf_zero(&q->tmp[q->nof_guards + q->nof_re], symbol_sz - q->nof_guards - q->nof_re);
+
   for (uint32_t i = 0; i < q->nof_symbols_mbsfn; i++) {
     int cp_len = (i > (q->non_mbsfn_region - 1)) ? SRSRAN_CP_LEN_EXT(symbol_sz) : SRSRAN_CP_LEN_NORM(i, symbol_sz);
     memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
@@ -675,11 +802,14 @@ void srsran_ofdm_set_normalize(srsran_ofdm_t* q, bool normalize_enable)
 
 void srsran_ofdm_tx_sf(srsran_ofdm_t* q)
 {
-  uint32_t n;
   if (!q->mbsfn_subframe) {
-    for (n = 0; n < SRSRAN_NOF_SLOTS_PER_SF; n++) {
+#ifdef AVOID_GURU
+    for (uint32_t n = 0; n < SRSRAN_NOF_SLOTS_PER_SF; n++) {
       ofdm_tx_slot(q, n);
     }
+#else
+    ofdm_tx_sf_batch(q);
+#endif
   } else {
     ofdm_tx_slot_mbsfn(q, q->cfg.in_buffer, q->cfg.out_buffer);
     ofdm_tx_slot(q, 1);
@@ -36,7 +36,13 @@ static float       rx_window_offset      = 0.5f;
 static float       freq_shift_f          = 0.0f;
 static double      phase_compensation_hz = 0.0;
 static uint32_t    force_symbol_sz       = 0;
-static double      elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
+static bool        benchmark             = false;
+static bool        mbsfn                 = false;
+
+static const uint32_t benchmark_nof_prb[]   = {6, 15, 25, 50, 75, 100};
+static const uint32_t benchmark_nof_ports[] = {1, 2, 4};
+
+static double elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
 {
   if (ts_end->tv_usec > ts_start->tv_usec) {
     return ((double)ts_end->tv_sec - (double)ts_start->tv_sec) * 1000000 + (double)ts_end->tv_usec -
@@ -57,12 +63,16 @@ static void usage(char* prog)
   printf("\t-o rx window offset (portion of CP length) [Default %.1f]\n", rx_window_offset);
   printf("\t-s frequency shift (normalised with sampling rate) [Default %.1f]\n", freq_shift_f);
   printf("\t-p Phase compensation carrier frequency in Hz [Default %.1f]\n", phase_compensation_hz);
+  printf("\t-b Benchmark the time per subframe for 1, 2 and 4 ports and the standard bandwidths [Default %s]\n",
+         benchmark ? "Enabled" : "Disabled");
+  printf("\t-m Check the guard band of consecutive MBSFN subframes is empty [Default %s]\n",
+         mbsfn ? "Enabled" : "Disabled");
 }
 
 static void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "Nnerosp")) != -1) {
+  while ((opt = getopt(argc, argv, "Nnerospbm")) != -1) {
     switch (opt) {
       case 'n':
         nof_prb = (int)strtol(argv[optind], NULL, 10);
@@ -85,6 +95,12 @@ static void parse_args(int argc, char** argv)
       case 'p':
         phase_compensation_hz = strtod(argv[optind], NULL);
         break;
+      case 'b':
+        benchmark = true;
+        break;
+      case 'm':
+        mbsfn = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -92,6 +108,191 @@ static void parse_args(int argc, char** argv)
   }
 }
 
+static int ofdm_init(srsran_ofdm_t* ifft,
+                     srsran_ofdm_t* fft,
+                     uint32_t       n_prb,
+                     uint32_t       symbol_sz,
+                     cf_t*          input,
+                     cf_t*          outifft,
+                     cf_t*          outfft)
+{
+  srsran_ofdm_cfg_t ofdm_cfg     = {};
+  ofdm_cfg.cp                    = cp;
+  ofdm_cfg.in_buffer             = input;
+  ofdm_cfg.out_buffer            = outifft;
+  ofdm_cfg.nof_prb               = n_prb;
+  ofdm_cfg.symbol_sz             = symbol_sz;
+  ofdm_cfg.freq_shift_f          = freq_shift_f;
+  ofdm_cfg.normalize             = true;
+  ofdm_cfg.phase_compensation_hz = phase_compensation_hz;
+  if (srsran_ofdm_tx_init_cfg(ifft, &ofdm_cfg)) {
+    ERROR("Error initializing iFFT");
+    return SRSRAN_ERROR;
+  }
+
+  ofdm_cfg.in_buffer        = outifft;
+  ofdm_cfg.out_buffer       = outfft;
+  ofdm_cfg.rx_window_offset = rx_window_offset;
+  ofdm_cfg.freq_shift_f     = -freq_shift_f;
+  if (srsran_ofdm_rx_init_cfg(fft, &ofdm_cfg)) {
+    ERROR("Error initializing FFT");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Measures the time to modulate and demodulate a subframe on every port, with an OFDM object per port as the eNb and
+ * UE PHY use them */
+static int run_benchmark(srsran_random_t random_gen)
+{
+  struct timeval start, end;
+  srsran_ofdm_t  fft[SRSRAN_MAX_PORTS]     = {};
+  srsran_ofdm_t  ifft[SRSRAN_MAX_PORTS]    = {};
+  cf_t*          input[SRSRAN_MAX_PORTS]   = {};
+  cf_t*          outfft[SRSRAN_MAX_PORTS]  = {};
+  cf_t*          outifft[SRSRAN_MAX_PORTS] = {};
+
+  printf("  PRB ports  Tx us/sf  Rx us/sf\n");
+  for (uint32_t i = 0; i < sizeof(benchmark_nof_prb) / sizeof(uint32_t); i++) {
+    uint32_t n_prb     = benchmark_nof_prb[i];
+    uint32_t symbol_sz = (force_symbol_sz) ? force_symbol_sz : (uint32_t)srsran_symbol_sz(n_prb);
+    uint32_t n_re      = SRSRAN_CP_NSYMB(cp) * n_prb * SRSRAN_NRE * SRSRAN_NOF_SLOTS_PER_SF;
+    uint32_t sf_len    = SRSRAN_SF_LEN(symbol_sz);
+
+    for (uint32_t j = 0; j < sizeof(benchmark_nof_ports) / sizeof(uint32_t); j++) {
+      uint32_t nof_ports = benchmark_nof_ports[j];
+
+      for (uint32_t port = 0; port < nof_ports; port++) {
+        input[port]   = srsran_vec_cf_malloc(n_re);
+        outfft[port]  = srsran_vec_cf_malloc(n_re);
+        outifft[port] = srsran_vec_cf_malloc(sf_len);
+        if (!input[port] || !outfft[port] || !outifft[port]) {
+          perror("malloc");
+          return SRSRAN_ERROR;
+        }
+        srsran_vec_cf_zero(outifft[port], sf_len);
+        if (ofdm_init(&ifft[port], &fft[port], n_prb, symbol_sz, input[port], outifft[port], outfft[port])) {
+          return SRSRAN_ERROR;
+        }
+        srsran_random_uniform_complex_dist_vector(random_gen, input[port], n_re, -1.0f, +1.0f);
+      }
+
+      gettimeofday(&start, NULL);
+      for (uint32_t r = 0; r < nof_repetitions; r++) {
+        for (uint32_t port = 0; port < nof_ports; port++) {
+          srsran_ofdm_tx_sf(&ifft[port]);
+        }
+      }
+      gettimeofday(&end, NULL);
+      double tx_us = elapsed_us(&start, &end) / nof_repetitions;
+
+      gettimeofday(&start, NULL);
+      for (uint32_t r = 0; r < nof_repetitions; r++) {
+        for (uint32_t port = 0; port < nof_ports; port++) {
+          srsran_ofdm_rx_sf(&fft[port]);
+        }
+      }
+      gettimeofday(&end, NULL);
+      double rx_us = elapsed_us(&start, &end) / nof_repetitions;
+
+      printf("%5d %5d %9.1f %9.1f\n", n_prb, nof_ports, tx_us, rx_us);
+
+      for (uint32_t port = 0; port < nof_ports; port++) {
+        srsran_ofdm_rx_free(&fft[port]);
+        srsran_ofdm_tx_free(&ifft[port]);
+        free(input[port]);
+        free(outfft[port]);
+        free(outifft[port]);
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Returns the power in the guard band of a time-domain symbol relative to the power of its subcarriers */
+static float guard_power_ratio(srsran_dft_plan_t* dft, cf_t* symbol, cf_t* freq, uint32_t symbol_sz, uint32_t n_re)
+{
+  uint32_t half_re = n_re / 2;
+
+  srsran_dft_run_c(dft, symbol, freq);
+
+  float guard_pwr = srsran_vec_avg_power_cf(&freq[half_re + 1], symbol_sz - n_re - 1);
+  float pos_pwr   = srsran_vec_avg_power_cf(&freq[1], half_re);
+  float neg_pwr   = srsran_vec_avg_power_cf(&freq[symbol_sz - half_re], half_re);
+
+  return guard_pwr / (pos_pwr + neg_pwr);
+}
+
+/* Modulates two consecutive MBSFN subframes and checks that no subcarrier is transmitted in the guard band of any
+ * symbol. The MBSFN slot and the second slot share the inverse-DFT input buffer. */
+static int run_mbsfn_guard_test(srsran_random_t random_gen, uint32_t n_prb)
+{
+  srsran_ofdm_t     ifft      = {};
+  srsran_dft_plan_t dft       = {};
+  uint32_t          symbol_sz = (uint32_t)srsran_symbol_sz(n_prb);
+  uint32_t          n_re      = n_prb * SRSRAN_NRE;
+  uint32_t          sf_len    = SRSRAN_SF_LEN(symbol_sz);
+  uint32_t          cp_ext    = SRSRAN_CP_LEN_EXT(symbol_sz);
+  uint32_t          nof_symb  = SRSRAN_CP_NSYMB(SRSRAN_CP_EXT);
+  float             max_ratio = 0.0f;
+
+  cf_t* input  = srsran_vec_cf_malloc(n_re * nof_symb * SRSRAN_NOF_SLOTS_PER_SF);
+  cf_t* output = srsran_vec_cf_malloc(sf_len);
+  cf_t* freq   = srsran_vec_cf_malloc(symbol_sz);
+  if (!input || !output || !freq) {
+    perror("malloc");
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(output, sf_len);
+
+  if (srsran_ofdm_tx_init_mbsfn(&ifft, SRSRAN_CP_EXT, input, output, n_prb) ||
+      srsran_dft_plan_c(&dft, (int)symbol_sz, SRSRAN_DFT_FORWARD)) {
+    ERROR("Error initializing DFT");
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t sf = 0; sf < 2; sf++) {
+    srsran_random_uniform_complex_dist_vector(
+        random_gen, input, n_re * nof_symb * SRSRAN_NOF_SLOTS_PER_SF, -1.0f, +1.0f);
+    srsran_ofdm_tx_sf(&ifft);
+
+    // MBSFN slot, the non-MBSFN region uses normal CP and it is followed by a gap
+    cf_t* symbol = output;
+    for (uint32_t i = 0; i < nof_symb; i++) {
+      uint32_t cp_len = (i < ifft.non_mbsfn_region) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : cp_ext;
+      max_ratio       = SRSRAN_MAX(max_ratio, guard_power_ratio(&dft, symbol + cp_len, freq, symbol_sz, n_re));
+      symbol += cp_len + symbol_sz;
+      if (i == ifft.non_mbsfn_region - 1) {
+        symbol += SRSRAN_NON_MBSFN_REGION_GUARD_LENGTH(ifft.non_mbsfn_region, symbol_sz);
+      }
+    }
+
+    // Second slot
+    symbol = output + ifft.slot_sz;
+    for (uint32_t i = 0; i < nof_symb; i++) {
+      max_ratio = SRSRAN_MAX(max_ratio, guard_power_ratio(&dft, symbol + cp_ext, freq, symbol_sz, n_re));
+      symbol += cp_ext + symbol_sz;
+    }
+  }
+
+  printf("MBSFN %d PRB: maximum guard to subcarrier power ratio %.2e\n", n_prb, max_ratio);
+
+  srsran_dft_plan_free(&dft);
+  srsran_ofdm_tx_free(&ifft);
+  free(input);
+  free(output);
+  free(freq);
+
+  if (!(max_ratio < 1e-6f)) {
+    printf("Guard band not empty\n");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   srsran_random_t random_gen = srsran_random_init(0);
@@ -103,6 +304,21 @@ int main(int argc, char** argv)
 
   parse_args(argc, argv);
 
+  if (benchmark) {
+    int ret = run_benchmark(random_gen);
+    srsran_random_free(random_gen);
+    exit(ret);
+  }
+
+  if (mbsfn) {
+    int ret = SRSRAN_SUCCESS;
+    for (uint32_t i = 0; i < sizeof(benchmark_nof_prb) / sizeof(uint32_t) && ret == SRSRAN_SUCCESS; i++) {
+      ret = run_mbsfn_guard_test(random_gen, benchmark_nof_prb[i]);
+    }
+    srsran_random_free(random_gen);
+    exit(ret);
+  }
+
   if (nof_prb == -1) {
     n_prb   = 6;
     max_prb = SRSRAN_MAX_PRB;
@@ -127,26 +343,7 @@ int main(int argc, char** argv)
     }
     srsran_vec_cf_zero(outifft, sf_len);
 
-    srsran_ofdm_cfg_t ofdm_cfg     = {};
-    ofdm_cfg.cp                    = cp;
-    ofdm_cfg.in_buffer             = input;
-    ofdm_cfg.out_buffer            = outifft;
-    ofdm_cfg.nof_prb               = n_prb;
-    ofdm_cfg.symbol_sz             = symbol_sz;
-    ofdm_cfg.freq_shift_f          = freq_shift_f;
-    ofdm_cfg.normalize             = true;
-    ofdm_cfg.phase_compensation_hz = phase_compensation_hz;
-    if (srsran_ofdm_tx_init_cfg(&ifft, &ofdm_cfg)) {
-      ERROR("Error initializing iFFT");
-      exit(-1);
-    }
-
-    ofdm_cfg.in_buffer        = outifft;
-    ofdm_cfg.out_buffer       = outfft;
-    ofdm_cfg.rx_window_offset = rx_window_offset;
-    ofdm_cfg.freq_shift_f     = -freq_shift_f;
-    if (srsran_ofdm_rx_init_cfg(&fft, &ofdm_cfg)) {
-      ERROR("Error initializing FFT");
+    if (ofdm_init(&ifft, &fft, n_prb, symbol_sz, input, outifft, outfft)) {
       exit(-1);
     }
 
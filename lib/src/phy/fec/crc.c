@@ -22,11 +22,24 @@
 #include "srsran/phy/fec/crc.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <string.h>
 
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif // LV_HAVE_SSE
 
+// PCLMULQDQ is not enabled by the build flags, the folding routine is compiled for it and selected at runtime
+#if defined(LV_HAVE_SSE) && defined(__x86_64__) && defined(__GNUC__)
+#define CRC_HAVE_CLMUL 1
+#endif
+
+// Folding needs at least four 128-bit accumulators worth of data to pay off
+#define CRC_CLMUL_MIN_BYTES 64
+
+// Number of bytes packed at once by the unpacked-bit checksum before they are fed to the engine
+#define CRC_PACK_CHUNK_BYTES 256
+
 static void gen_crc_table(srsran_crc_t* h)
 {
   uint32_t pad        = (h->order < 8) ? (8 - h->order) : 0;
@@ -47,6 +60,197 @@ static void gen_crc_table(srsran_crc_t* h)
   }
 }
 
+// Left-aligned 32-bit polynomial without the x^32 term, only valid for orders up to 32
+static inline uint32_t crc_poly32(const srsran_crc_t* h)
+{
+  return (uint32_t)((uint64_t)h->polynom << (32U - h->order));
+}
+
+static void gen_crc_table8(srsran_crc_t* h)
+{
+  uint32_t poly = crc_poly32(h);
+
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i << 24U;
+    for (uint32_t j = 0; j < 8; j++) {
+      crc = (crc & 0x80000000U) ? (crc << 1U) ^ poly : (crc << 1U);
+    }
+    h->table8[0][i] = crc;
+  }
+
+  // table8[k][i] is the CRC of byte i followed by k zero bytes
+  for (uint32_t k = 1; k < 8; k++) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc    = h->table8[k - 1][i];
+      h->table8[k][i] = (crc << 8U) ^ h->table8[0][crc >> 24U];
+    }
+  }
+}
+
+// Computes x^n modulo the left-aligned polynomial
+static uint64_t crc_xpow_mod(const srsran_crc_t* h, uint32_t n)
+{
+  uint64_t poly = (1ULL << 32U) | crc_poly32(h);
+  uint64_t r    = 1;
+
+  for (uint32_t i = 0; i < n; i++) {
+    r <<= 1U;
+    if (r & (1ULL << 32U)) {
+      r ^= poly;
+    }
+  }
+  return r;
+}
+
+static void gen_crc_fold(srsran_crc_t* h)
+{
+  h->fold_k[0] = crc_xpow_mod(h, 512 + 64);
+  h->fold_k[1] = crc_xpow_mod(h, 512);
+  h->fold_k[2] = crc_xpow_mod(h, 128 + 64);
+  h->fold_k[3] = crc_xpow_mod(h, 128);
+}
+
+static bool crc_cpu_has_clmul(void)
+{
+#ifdef CRC_HAVE_CLMUL
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#else  /* CRC_HAVE_CLMUL */
+  return false;
+#endif /* CRC_HAVE_CLMUL */
+}
+
+static inline uint64_t crc_load_be64(const uint8_t* data)
+{
+  return ((uint64_t)data[0] << 56U) | ((uint64_t)data[1] << 48U) | ((uint64_t)data[2] << 40U) |
+         ((uint64_t)data[3] << 32U) | ((uint64_t)data[4] << 24U) | ((uint64_t)data[5] << 16U) |
+         ((uint64_t)data[6] << 8U) | ((uint64_t)data[7]);
+}
+
+// Updates the left-aligned CRC register with len bytes, eight bytes per iteration
+static uint32_t crc_update_slice8(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+  const uint32_t(*t)[256] = h->table8;
+
+  for (; len >= 8; len -= 8, data += 8) {
+    uint64_t w  = crc_load_be64(data);
+    uint32_t hi = (uint32_t)(w >> 32U) ^ crc;
+    uint32_t lo = (uint32_t)w;
+
+    crc = t[7][hi >> 24U] ^ t[6][(hi >> 16U) & 0xffU] ^ t[5][(hi >> 8U) & 0xffU] ^ t[4][hi & 0xffU] ^
+          t[3][lo >> 24U] ^ t[2][(lo >> 16U) & 0xffU] ^ t[1][(lo >> 8U) & 0xffU] ^ t[0][lo & 0xffU];
+  }
+
+  for (; len > 0; len--, data++) {
+    crc = (crc << 8U) ^ t[0][(crc >> 24U) ^ *data];
+  }
+
+  return crc;
+}
+
+#ifdef CRC_HAVE_CLMUL
+// a * x^(D + 128) folded onto 128 bits, k holds x^(D + 64) in the low and x^D in the high quadword
+__attribute__((target("pclmul,ssse3"))) static inline __m128i crc_fold_128(__m128i a, __m128i k)
+{
+  return _mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x01), _mm_clmulepi64_si128(a, k, 0x10));
+}
+
+/*
+ * Folds the message with carry-less multiplications until less than 16 bytes are left. The remaining 128-bit
+ * accumulator is congruent with the processed message, so it is reduced by feeding it to the slice-by-8 tables
+ * followed by the tail bytes. Requires len >= CRC_CLMUL_MIN_BYTES.
+ */
+__attribute__((target("pclmul,ssse3"))) static uint32_t
+crc_update_clmul(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i k4    = _mm_set_epi64x((int64_t)h->fold_k[1], (int64_t)h->fold_k[0]);
+  const __m128i k1    = _mm_set_epi64x((int64_t)h->fold_k[3], (int64_t)h->fold_k[2]);
+
+  // Load the first 64 bytes, the current CRC register is added to the first 32 bits of the message
+  __m128i a0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+  __m128i a1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+  __m128i a2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+  __m128i a3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+  a0         = _mm_xor_si128(a0, _mm_set_epi32((int)crc, 0, 0, 0));
+  data += 64;
+  len -= 64;
+
+  // Fold by four
+  for (; len >= 64; len -= 64, data += 64) {
+    a0 = _mm_xor_si128(crc_fold_128(a0, k4), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap));
+    a1 = _mm_xor_si128(crc_fold_128(a1, k4), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap));
+    a2 = _mm_xor_si128(crc_fold_128(a2, k4), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap));
+    a3 = _mm_xor_si128(crc_fold_128(a3, k4), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap));
+  }
+
+  // Combine the four accumulators and fold the remaining 16-byte blocks
+  __m128i a = _mm_xor_si128(crc_fold_128(a0, k1), a1);
+  a         = _mm_xor_si128(crc_fold_128(a, k1), a2);
+  a         = _mm_xor_si128(crc_fold_128(a, k1), a3);
+  for (; len >= 16; len -= 16, data += 16) {
+    a = _mm_xor_si128(crc_fold_128(a, k1), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), bswap));
+  }
+
+  uint8_t acc[16];
+  _mm_storeu_si128((__m128i*)acc, _mm_shuffle_epi8(a, bswap));
+  crc = crc_update_slice8(h, 0, acc, 16);
+
+  return crc_update_slice8(h, crc, data, len);
+}
+#endif /* CRC_HAVE_CLMUL */
+
+static uint32_t crc_update(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+#ifdef CRC_HAVE_CLMUL
+  if (h->impl == SRSRAN_CRC_IMPL_CLMUL && len >= CRC_CLMUL_MIN_BYTES) {
+    return crc_update_clmul(h, crc, data, len);
+  }
+#endif /* CRC_HAVE_CLMUL */
+  return crc_update_slice8(h, crc, data, len);
+}
+
+// Unpacked bit value, as given by the signed 8-bit comparison of the SIMD packing: any value greater than zero is a one
+static inline uint32_t crc_bit(uint8_t bit)
+{
+  return (int8_t)bit > 0;
+}
+
+// Packs nof_bytes * 8 unpacked bits
+static void crc_pack_bits(const uint8_t* bits, uint8_t* packed, uint32_t nof_bytes)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  const __m256i rev = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, //
+                                      8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  for (; i + 4 <= nof_bytes; i += 4) {
+    __m256i  v = _mm256_loadu_si256((const __m256i*)(bits + 8 * i));
+    v          = _mm256_shuffle_epi8(_mm256_cmpgt_epi8(v, _mm256_setzero_si256()), rev);
+    uint32_t m = (uint32_t)_mm256_movemask_epi8(v);
+    memcpy(&packed[i], &m, sizeof(m));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  const __m128i rev128 = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  for (; i + 2 <= nof_bytes; i += 2) {
+    __m128i  v = _mm_loadu_si128((const __m128i*)(bits + 8 * i));
+    v          = _mm_shuffle_epi8(_mm_cmpgt_epi8(v, _mm_setzero_si128()), rev128);
+    uint16_t m = (uint16_t)_mm_movemask_epi8(v);
+    memcpy(&packed[i], &m, sizeof(m));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < nof_bytes; i++) {
+    uint8_t byte = 0;
+    for (uint32_t k = 0; k < 8; k++) {
+      byte |= (uint8_t)(crc_bit(bits[8 * i + k]) << (7U - k));
+    }
+    packed[i] = byte;
+  }
+}
+
 uint64_t reversecrcbit(uint32_t crc, int nbits, srsran_crc_t* h)
 {
   uint64_t m, rmask = 0x1;
@@ -89,10 +293,58 @@ int srsran_crc_init(srsran_crc_t* h, uint32_t crc_poly, int crc_order)
   // generate lookup table
   gen_crc_table(h);
 
+  // Select the fastest engine available
+  h->impl = SRSRAN_CRC_IMPL_TABLE;
+  if (h->order <= 32) {
+    gen_crc_table8(h);
+    gen_crc_fold(h);
+    h->impl = crc_cpu_has_clmul() ? SRSRAN_CRC_IMPL_CLMUL : SRSRAN_CRC_IMPL_SLICE8;
+  }
+
   return 0;
 }
 
-uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
+int srsran_crc_set_impl(srsran_crc_t* h, srsran_crc_impl_t impl)
+{
+  switch (impl) {
+    case SRSRAN_CRC_IMPL_TABLE:
+      break;
+    case SRSRAN_CRC_IMPL_SLICE8:
+      if (h->order > 32) {
+        ERROR("CRC%d is not supported by %s", h->order, srsran_crc_impl_string(impl));
+        return SRSRAN_ERROR;
+      }
+      break;
+    case SRSRAN_CRC_IMPL_CLMUL:
+      if (h->order > 32 || !crc_cpu_has_clmul()) {
+        ERROR("CRC%d is not supported by %s", h->order, srsran_crc_impl_string(impl));
+        return SRSRAN_ERROR;
+      }
+      break;
+    default:
+      ERROR("Invalid CRC implementation %d", impl);
+      return SRSRAN_ERROR;
+  }
+
+  h->impl = impl;
+  return SRSRAN_SUCCESS;
+}
+
+const char* srsran_crc_impl_string(srsran_crc_impl_t impl)
+{
+  switch (impl) {
+    case SRSRAN_CRC_IMPL_TABLE:
+      return "table";
+    case SRSRAN_CRC_IMPL_SLICE8:
+      return "slice8";
+    case SRSRAN_CRC_IMPL_CLMUL:
+      return "clmul";
+    default:; // Do nothing
+  }
+  return "unknown";
+}
+
+static uint32_t crc_checksum_table(srsran_crc_t* h, uint8_t* data, int len)
 {
   int      i, k, len8, res8, a = 0;
   uint32_t crc = 0;
@@ -143,6 +395,38 @@ uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
   return crc;
 }
 
+uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
+{
+  if (h->impl == SRSRAN_CRC_IMPL_TABLE) {
+    return crc_checksum_table(h, data, len);
+  }
+
+  uint8_t  packed[CRC_PACK_CHUNK_BYTES];
+  uint32_t crc      = 0;
+  uint32_t nof_left = (uint32_t)len / 8;
+
+  // Pack and process the whole bytes in chunks, so the packed data does not leave the L1 cache
+  while (nof_left > 0) {
+    uint32_t n = SRSRAN_MIN(nof_left, CRC_PACK_CHUNK_BYTES);
+    crc_pack_bits(data, packed, n);
+    crc = crc_update(h, crc, packed, n);
+    data += 8 * n;
+    nof_left -= n;
+  }
+
+  // Remaining bits, one at a time
+  uint32_t poly = crc_poly32(h);
+  for (int k = 0; k < len % 8; k++) {
+    crc ^= crc_bit(data[k]) << 31U;
+    crc = (crc & 0x80000000U) ? (crc << 1U) ^ poly : (crc << 1U);
+  }
+
+  crc >>= 32U - h->order;
+  h->crcinit = crc;
+
+  return crc;
+}
+
 // len is multiple of 8
 uint32_t srsran_crc_checksum_byte(srsran_crc_t* h, const uint8_t* data, int len)
 {
@@ -151,6 +435,12 @@ uint32_t srsran_crc_checksum_byte(srsran_crc_t* h, const uint8_t* data, int len)
 
   srsran_crc_set_init(h, 0);
 
+  if (h->impl != SRSRAN_CRC_IMPL_TABLE) {
+    crc        = crc_update(h, 0, data, (uint32_t)len / 8) >> (32U - h->order);
+    h->crcinit = crc;
+    return crc;
+  }
+
   // Calculate CRC
   for (i = 0; i < len / 8; i++) {
     srsran_crc_checksum_put_byte(h, data[i]);
@@ -0,0 +1,237 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdlib.h>
+#include <strings.h>
+
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/fec/fec_pool.h"
+#include "srsran/phy/utils/debug.h"
+
+static void* fec_pool_run(void* arg)
+{
+  srsran_fec_pool_t* q = (srsran_fec_pool_t*)arg;
+
+  pthread_mutex_lock(&q->mutex);
+
+  // Every thread takes the next context in order of start
+  void* ctx = q->ctx[q->nof_started++];
+
+  while (true) {
+    while (q->jobs_count == 0 && !q->quit) {
+      pthread_cond_wait(&q->cvar_job, &q->mutex);
+    }
+
+    // Exit only once the queue is empty, so no caller is left waiting on its barrier
+    if (q->jobs_count == 0) {
+      break;
+    }
+
+    srsran_fec_pool_job_t job = q->jobs[q->jobs_r];
+    q->jobs_r                 = (q->jobs_r + 1) % SRSRAN_FEC_POOL_MAX_JOBS;
+    q->jobs_count--;
+    pthread_cond_signal(&q->cvar_space);
+    pthread_mutex_unlock(&q->mutex);
+
+    job.fn(ctx, job.arg);
+
+    if (job.barrier) {
+      pthread_mutex_lock(&job.barrier->mutex);
+      job.barrier->pending--;
+      if (job.barrier->pending == 0) {
+        pthread_cond_broadcast(&job.barrier->cvar);
+      }
+      pthread_mutex_unlock(&job.barrier->mutex);
+    }
+
+    pthread_mutex_lock(&q->mutex);
+  }
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return NULL;
+}
+
+int srsran_fec_pool_init(srsran_fec_pool_t*         q,
+                         uint32_t                   nof_workers,
+                         srsran_fec_pool_ctx_init_t ctx_init,
+                         srsran_fec_pool_ctx_free_t ctx_free,
+                         void*                      ctx_arg)
+{
+  if (q == NULL || nof_workers == 0 || ctx_init == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_fec_pool_t));
+
+  q->ctx = calloc(nof_workers, sizeof(void*));
+  if (q->ctx == NULL) {
+    ERROR("Error allocating FEC pool contexts");
+    return SRSRAN_ERROR;
+  }
+  q->ctx_free = ctx_free;
+
+  pthread_mutex_init(&q->mutex, NULL);
+  pthread_cond_init(&q->cvar_job, NULL);
+  pthread_cond_init(&q->cvar_space, NULL);
+
+  q->threads = calloc(nof_workers, sizeof(pthread_t));
+  if (q->threads == NULL) {
+    ERROR("Error allocating FEC pool threads");
+    goto clean_exit;
+  }
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    q->ctx[i] = ctx_init(ctx_arg);
+    if (q->ctx[i] == NULL) {
+      ERROR("Error creating context of FEC pool thread %d", i);
+      goto clean_exit;
+    }
+    q->nof_ctx++;
+  }
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    if (pthread_create(&q->threads[i], NULL, fec_pool_run, q)) {
+      ERROR("Error creating FEC pool thread %d", i);
+      goto clean_exit;
+    }
+    q->nof_workers++;
+  }
+
+  return SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_fec_pool_free(q);
+  return SRSRAN_ERROR;
+}
+
+void srsran_fec_pool_free(srsran_fec_pool_t* q)
+{
+  if (q == NULL || q->ctx == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&q->mutex);
+  q->quit = true;
+  pthread_cond_broadcast(&q->cvar_job);
+  pthread_cond_broadcast(&q->cvar_space);
+  pthread_mutex_unlock(&q->mutex);
+
+  for (uint32_t i = 0; i < q->nof_workers; i++) {
+    pthread_join(q->threads[i], NULL);
+  }
+
+  // Contexts are all created before the threads, so some may not have a thread if the pool failed to start
+  if (q->ctx_free) {
+    for (uint32_t i = 0; i < q->nof_ctx; i++) {
+      q->ctx_free(q->ctx[i]);
+    }
+  }
+
+  pthread_mutex_destroy(&q->mutex);
+  pthread_cond_destroy(&q->cvar_job);
+  pthread_cond_destroy(&q->cvar_space);
+
+  if (q->threads) {
+    free(q->threads);
+  }
+  free(q->ctx);
+
+  bzero(q, sizeof(srsran_fec_pool_t));
+}
+
+int srsran_fec_pool_push(srsran_fec_pool_t*         q,
+                         srsran_fec_pool_job_fn_t   fn,
+                         void*                      arg,
+                         srsran_fec_pool_barrier_t* barrier)
+{
+  if (q == NULL || fn == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  pthread_mutex_lock(&q->mutex);
+  while (q->jobs_count == SRSRAN_FEC_POOL_MAX_JOBS && !q->quit) {
+    pthread_cond_wait(&q->cvar_space, &q->mutex);
+  }
+
+  if (q->quit) {
+    pthread_mutex_unlock(&q->mutex);
+    return SRSRAN_ERROR;
+  }
+
+  if (barrier) {
+    pthread_mutex_lock(&barrier->mutex);
+    barrier->pending++;
+    pthread_mutex_unlock(&barrier->mutex);
+  }
+
+  srsran_fec_pool_job_t* job = &q->jobs[(q->jobs_r + q->jobs_count) % SRSRAN_FEC_POOL_MAX_JOBS];
+  job->fn                    = fn;
+  job->arg                   = arg;
+  job->barrier               = barrier;
+  q->jobs_count++;
+
+  pthread_cond_signal(&q->cvar_job);
+  pthread_mutex_unlock(&q->mutex);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_fec_pool_barrier_init(srsran_fec_pool_barrier_t* b)
+{
+  if (b == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  b->pending = 0;
+  if (pthread_mutex_init(&b->mutex, NULL)) {
+    return SRSRAN_ERROR;
+  }
+  if (pthread_cond_init(&b->cvar, NULL)) {
+    pthread_mutex_destroy(&b->mutex);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_fec_pool_barrier_free(srsran_fec_pool_barrier_t* b)
+{
+  if (b == NULL) {
+    return;
+  }
+
+  pthread_mutex_destroy(&b->mutex);
+  pthread_cond_destroy(&b->cvar);
+}
+
+void srsran_fec_pool_barrier_wait(srsran_fec_pool_barrier_t* b)
+{
+  if (b == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&b->mutex);
+  while (b->pending > 0) {
+    pthread_cond_wait(&b->cvar, &b->mutex);
+  }
+  pthread_mutex_unlock(&b->mutex);
+}
@@ -601,6 +601,105 @@ int update_ldpc_soft_bits_c_avx2long_flood(void* p, const int8_t (*these_var_ind
  */
 int extract_ldpc_message_c_avx2long_flood(void* p, uint8_t* message, uint16_t liftK);
 
+/*!
+ * Returns the number of codeblocks the optimized 8-bit-based implementation of the LDPC decoder can pack in one
+ * \ref SRSRAN_AVX2_B_SIZE register (packed version, LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in] ls Lifting size.
+ * \return The number of codeblocks decoded in parallel, 0 if the lifting size is too large to pack codeblocks.
+ */
+uint32_t get_nof_cb_ldpc_dec_c_avx2_batch(uint16_t ls);
+
+/*!
+ * Creates the registers used by the optimized 8-bit-based implementation of the LDPC decoder
+ * (packed version, LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in] bgN          Codeword length.
+ * \param[in] bgM          Number of check nodes.
+ * \param[in] ls           Lifting size.
+ * \param[in] scaling_fctr Scaling factor of the normalized min-sum algorithm.
+ * \return A pointer to the created registers (an ldpc_regs_c_avx2_batch structure).
+ */
+void* create_ldpc_dec_c_avx2_batch(uint8_t bgN, uint8_t bgM, uint16_t ls, float scaling_fctr);
+
+/*!
+ * Destroys the inner registers of the optimized 8-bit integer-based LDPC decoder
+ * (packed version, LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in] p A pointer to the dismantled decoder registers (an ldpc_regs_c_avx2_batch structure).
+ */
+void delete_ldpc_dec_c_avx2_batch(void* p);
+
+/*!
+ * Initializes the inner registers of the optimized 8-bit integer-based LDPC decoder before
+ * carrying out the actual decoding (packed version, LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in,out] p      A pointer to the decoder registers (an ldpc_regs_c_avx2_batch structure).
+ * \param[in]     llrs   Pointers to the arrays of LLR values from the channel, one per codeblock.
+ * \param[in]     nof_cb The number of codeblocks, at most get_nof_cb_ldpc_dec_c_avx2_batch().
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int init_ldpc_dec_c_avx2_batch(void* p, int8_t** llrs, uint32_t nof_cb);
+
+/*!
+ * Updates the messages from variable nodes to check nodes (optimized 8-bit version, packed version,
+ * LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in,out] p       A pointer to the decoder registers (an ldpc_regs_c_avx2_batch structure).
+ * \param[in]     i_layer The index of the variable-to-check layer to update.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int update_ldpc_var_to_check_c_avx2_batch(void* p, int i_layer);
+
+/*!
+ * Updates the messages from check nodes to variable nodes (optimized 8-bit version, packed version,
+ * LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in,out] p        A pointer to the decoder registers (an ldpc_regs_c_avx2_batch structure).
+ * \param[in]     i_layer  The index of the variable-to-check layer to update.
+ * \param[in]     this_pcm A pointer to the row of the parity check matrix (i.e. base
+ *                         graph) corresponding to the selected layer.
+ * \param[in]     these_var_indices
+ *                         Contains the indices of the variable nodes connected
+ *                         to the current layer.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int update_ldpc_check_to_var_c_avx2_batch(void*           p,
+                                          int             i_layer,
+                                          const uint16_t* this_pcm,
+                                          const int8_t (*these_var_indices)[MAX_CNCT]);
+
+/*!
+ * Updates the current estimate of the (soft) bits of the codeword (optimized 8-bit version, packed version,
+ * LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in,out] p        A pointer to the decoder registers (an ldpc_regs_c_avx2_batch structure).
+ * \param[in]     i_layer  The index of the variable-to-check layer to update.
+ * \param[in]     these_var_indices
+ *                         Contains the indices of the variable nodes connected
+ *                         to the current layer.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int update_ldpc_soft_bits_c_avx2_batch(void* p, int i_layer, const int8_t (*these_var_indices)[MAX_CNCT]);
+
+/*!
+ * Checks the hard decisions of all the packed codewords against the first \b n_layers layers of the parity check
+ * matrix (optimized 8-bit version, packed version, LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in] p           A pointer to the decoder registers (an ldpc_regs_c_avx2_batch structure).
+ * \param[in] n_layers    The number of layers to check.
+ * \param[in] pcm         A pointer to the parity check matrix (compact form).
+ * \param[in] var_indices Lists of variable indices connected to each check node.
+ * \return A bitmap with one bit set for each codeblock that does not satisfy all the parity checks.
+ */
+uint32_t check_ldpc_syndrome_c_avx2_batch(void*           p,
+                                          int             n_layers,
+                                          const uint16_t* pcm,
+                                          const int8_t (*var_indices)[MAX_CNCT]);
+
+/*!
+ * Returns the decoded message (hard bits) of one of the packed codeblocks from the current soft bits (optimized 8-bit
+ * version, packed version, LS <= \ref SRSRAN_AVX2_B_SIZE / 2).
+ * \param[in]  p       A pointer to the decoder registers (an ldpc_regs_c_avx2_batch structure).
+ * \param[in]  i_cb    The index of the codeblock within the batch.
+ * \param[out] message A pointer to the decoded message.
+ * \param[in]  liftK   The length of the decoded message.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int extract_ldpc_message_c_avx2_batch(void* p, uint32_t i_cb, uint8_t* message, uint16_t liftK);
+
 /*!
  * Creates the registers used by the optimized 8-bit-based implementation of the LDPC decoder (LS > \ref
  * SRSRAN_AVX512_B_SIZE). \param[in] bgN          Codeword length. \param[in] bgM          Number of check nodes.
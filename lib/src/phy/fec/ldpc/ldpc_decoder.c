@@ -41,28 +41,71 @@
 
 #define LDPC_DECODER_DEFAULT_MAX_NOF_ITER 10 /*!< \brief Default maximum number of iterations of the BP algorithm. */
 
+/*! Adjusts the rate-matched codeword length to the range the decoder can work with. */
+static uint32_t ldpc_decoder_rm_length(const srsran_ldpc_decoder_t* q, uint32_t cdwd_rm_length)
+{
+  // it must be smaller than the codeword size
+  if (cdwd_rm_length > q->liftN - 2 * q->ls) {
+    cdwd_rm_length = q->liftN - 2 * q->ls;
+  }
+  // We need at least q->bgK + 4 variable nodes to cover the high-rate region. However,
+  // 2 variable nodes are systematically punctured by the encoder.
+  if (cdwd_rm_length < (q->bgK + 2) * q->ls) {
+    // ERROR("The rate-matched codeword should have a length at least equal to the high-rate region.");
+    cdwd_rm_length = (q->bgK + 2) * q->ls;
+  }
+  if (cdwd_rm_length % q->ls) {
+    // ERROR("The rate-matched codeword length should be a multiple of the lifting size.");
+    cdwd_rm_length = (cdwd_rm_length / q->ls + 1) * q->ls;
+  }
+  return cdwd_rm_length;
+}
+
+/*! Accounts for one decoded codeblock in the decoder statistics. */
+static void ldpc_decoder_stats_update(srsran_ldpc_decoder_t* q, uint32_t nof_iter, bool early_stop, bool failure)
+{
+  q->stats.nof_cb++;
+  q->stats.nof_iter += nof_iter;
+  q->stats.nof_early_stops += early_stop ? 1 : 0;
+  q->stats.nof_failures += failure ? 1 : 0;
+  q->stats.iter_hist[SRSRAN_MIN(nof_iter, SRSRAN_LDPC_DECODER_NOF_ITER_BINS - 1)]++;
+}
+
+/*!
+ * Checks the hard decisions in q->codeword against the first n_layers layers of the parity check matrix, that is the
+ * layers that involve the transmitted bits only. Check j of a layer is connected to bit (j + shift) mod ls of each of
+ * its variable nodes, the parity of all the checks of the layer is computed at once.
+ */
+static bool ldpc_decoder_syndrome_is_zero(srsran_ldpc_decoder_t* q, uint32_t n_layers)
+{
+  for (uint32_t i_layer = 0; i_layer < n_layers; i_layer++) {
+    const uint16_t* this_pcm          = q->pcm + i_layer * q->bgN;
+    const int8_t*   these_var_indices = q->var_indices[i_layer];
+
+    srsran_vec_u8_zero(q->syndrome, q->ls);
+    for (uint32_t i = 0; (i < MAX_CNCT) && (these_var_indices[i] != -1); i++) {
+      uint16_t       shift = this_pcm[these_var_indices[i]];
+      const uint8_t* node  = q->codeword + these_var_indices[i] * q->ls;
+      srsran_vec_xor_bbb(q->syndrome, node + shift, q->syndrome, q->ls - shift);
+      srsran_vec_xor_bbb(q->syndrome + q->ls - shift, node, q->syndrome + q->ls - shift, shift);
+    }
+
+    for (uint32_t j = 0; j < q->ls; j++) {
+      if (q->syndrome[j] != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 #define LDPC_DECODER_TEMPLATE(LLR_TYPE, SUFFIX)                                                                        \
   static int decode_##SUFFIX(                                                                                          \
       void* o, const LLR_TYPE* llrs, uint8_t* message, uint32_t cdwd_rm_length, srsran_crc_t* crc)                     \
   {                                                                                                                    \
     srsran_ldpc_decoder_t* q = o;                                                                                      \
                                                                                                                        \
-    /* it must be smaller than the codeword size */                                                                    \
-    if (cdwd_rm_length > q->liftN - 2 * q->ls) {                                                                       \
-      cdwd_rm_length = q->liftN - 2 * q->ls;                                                                           \
-    }                                                                                                                  \
-    /* We need at least q->bgK + 4 variable nodes to cover the high-rate region. However,*/                            \
-    /* 2 variable nodes are systematically punctured by the encoder. */                                                \
-    if (cdwd_rm_length < (q->bgK + 2) * q->ls) {                                                                       \
-      /* ERROR("The rate-matched codeword should have a length at least equal to the high-rate region.");*/            \
-      cdwd_rm_length = (q->bgK + 2) * q->ls;                                                                           \
-      /* return -1;*/                                                                                                  \
-    }                                                                                                                  \
-    if (cdwd_rm_length % q->ls) {                                                                                      \
-      cdwd_rm_length = (cdwd_rm_length / q->ls + 1) * q->ls;                                                           \
-      /* ERROR("The rate-matched codeword length should be a multiple of the lifting size."); */                       \
-      /* return -1;*/                                                                                                  \
-    }                                                                                                                  \
+    cdwd_rm_length = ldpc_decoder_rm_length(q, cdwd_rm_length);                                                        \
     init_ldpc_dec_##SUFFIX(q->ptr, llrs, q->ls);                                                                       \
                                                                                                                        \
     uint16_t* this_pcm                   = NULL;                                                                       \
@@ -88,17 +131,31 @@
         extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                      \
                                                                                                                        \
         if (srsran_crc_match(crc, message, q->liftK - crc->order)) {                                                   \
+          ldpc_decoder_stats_update(q, i_iteration + 1, i_iteration + 1 < q->max_nof_iter, false);                     \
+          return i_iteration + 1;                                                                                      \
+        }                                                                                                              \
+      } else if (q->early_stop) {                                                                                      \
+        extract_ldpc_message_##SUFFIX(q->ptr, q->codeword, (q->bgK + n_layers) * q->ls);                               \
+                                                                                                                       \
+        if (ldpc_decoder_syndrome_is_zero(q, n_layers)) {                                                              \
+          srsran_vec_u8_copy(message, q->codeword, q->liftK);                                                          \
+          ldpc_decoder_stats_update(q, i_iteration + 1, i_iteration + 1 < q->max_nof_iter, false);                     \
           return i_iteration + 1;                                                                                      \
         }                                                                                                              \
       }                                                                                                                \
     }                                                                                                                  \
                                                                                                                        \
-    /* If reached here, and CRC is being checked, it has failed */                                                     \
-    if (crc != NULL) {                                                                                                 \
+    /* If reached here, and CRC or syndrome are being checked, it has failed */                                        \
+    if (crc != NULL || q->early_stop) {                                                                                \
+      ldpc_decoder_stats_update(q, q->max_nof_iter, false, true);                                                      \
+      if (crc == NULL) {                                                                                               \
+        srsran_vec_u8_copy(message, q->codeword, q->liftK);                                                            \
+      }                                                                                                                \
       return 0;                                                                                                        \
     }                                                                                                                  \
                                                                                                                        \
     /* Without CRC, extract message and return the maximum number of iterations */                                     \
+    ldpc_decoder_stats_update(q, q->max_nof_iter, false, false);                                                       \
     extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                          \
     return q->max_nof_iter;                                                                                            \
   }
@@ -108,22 +165,7 @@
   {                                                                                                                    \
     srsran_ldpc_decoder_t* q = o;                                                                                      \
                                                                                                                        \
-    /* it must be smaller than the codeword size */                                                                    \
-    if (cdwd_rm_length > q->liftN - 2 * q->ls) {                                                                       \
-      cdwd_rm_length = q->liftN - 2 * q->ls;                                                                           \
-    }                                                                                                                  \
-    /* We need at least q->bgK + 4 variable nodes to cover the high-rate region. However,*/                            \
-    /* 2 variable nodes are systematically punctured by the encoder. */                                                \
-    if (cdwd_rm_length < (q->bgK + 2) * q->ls) {                                                                       \
-      /* ERROR("The rate-matched codeword should have a length at least equal to the high-rate region.");*/            \
-      cdwd_rm_length = (q->bgK + 2) * q->ls;                                                                           \
-      /* return -1;*/                                                                                                  \
-    }                                                                                                                  \
-    if (cdwd_rm_length % q->ls) {                                                                                      \
-      cdwd_rm_length = (cdwd_rm_length / q->ls + 1) * q->ls;                                                           \
-      /* ERROR("The rate-matched codeword length should be a multiple of the lifting size."); */                       \
-      /* return -1;*/                                                                                                  \
-    }                                                                                                                  \
+    cdwd_rm_length = ldpc_decoder_rm_length(q, cdwd_rm_length);                                                        \
     init_ldpc_dec_##SUFFIX(q->ptr, llrs, q->ls);                                                                       \
                                                                                                                        \
     uint16_t* this_pcm                   = NULL;                                                                       \
@@ -151,17 +193,31 @@
         extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                      \
                                                                                                                        \
         if (srsran_crc_match(crc, message, q->liftK - crc->order)) {                                                   \
+          ldpc_decoder_stats_update(q, i_iteration + 1, i_iteration + 1 < 2 * q->max_nof_iter, false);                 \
+          return i_iteration + 1;                                                                                      \
+        }                                                                                                              \
+      } else if (q->early_stop) {                                                                                      \
+        extract_ldpc_message_##SUFFIX(q->ptr, q->codeword, (q->bgK + n_layers) * q->ls);                               \
+                                                                                                                       \
+        if (ldpc_decoder_syndrome_is_zero(q, n_layers)) {                                                              \
+          srsran_vec_u8_copy(message, q->codeword, q->liftK);                                                          \
+          ldpc_decoder_stats_update(q, i_iteration + 1, i_iteration + 1 < 2 * q->max_nof_iter, false);                 \
           return i_iteration + 1;                                                                                      \
         }                                                                                                              \
       }                                                                                                                \
     }                                                                                                                  \
                                                                                                                        \
-    /* If reached here, and CRC is being checked, it has failed */                                                     \
-    if (crc != NULL) {                                                                                                 \
+    /* If reached here, and CRC or syndrome are being checked, it has failed */                                        \
+    if (crc != NULL || q->early_stop) {                                                                                \
+      ldpc_decoder_stats_update(q, 2 * q->max_nof_iter, false, true);                                                  \
+      if (crc == NULL) {                                                                                               \
+        srsran_vec_u8_copy(message, q->codeword, q->liftK);                                                            \
+      }                                                                                                                \
       return 0;                                                                                                        \
     }                                                                                                                  \
                                                                                                                        \
     /* Without CRC, extract message and return the maximum number of iterations */                                     \
+    ldpc_decoder_stats_update(q, 2 * q->max_nof_iter, false, false);                                                   \
     extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                          \
                                                                                                                        \
     return q->max_nof_iter;                                                                                            \
@@ -307,11 +363,91 @@ static void free_dec_c_avx2(void* o)
     free(q->pcm);
   }
   delete_ldpc_dec_c_avx2(q->ptr);
+  delete_ldpc_dec_c_avx2_batch(q->ptr_batch);
 }
 
 /*! Carries out the decoding with 8-bit integer-valued LLRs (AVX2 implementation). */
 LDPC_DECODER_TEMPLATE(int8_t, c_avx2);
 
+/*! Carries out the decoding of several packed codeblocks with 8-bit integer-valued LLRs (AVX2 implementation). */
+static int decode_batch_c_avx2(void*         o,
+                               int8_t**      llrs,
+                               uint8_t**     messages,
+                               uint32_t      nof_cb,
+                               uint32_t      cdwd_rm_length,
+                               srsran_crc_t* crc,
+                               int*          nof_iter)
+{
+  srsran_ldpc_decoder_t* q = o;
+
+  cdwd_rm_length = ldpc_decoder_rm_length(q, cdwd_rm_length);
+  if (init_ldpc_dec_c_avx2_batch(q->ptr_batch, llrs, nof_cb) < 0) {
+    return -1;
+  }
+
+  uint16_t* this_pcm                   = NULL;
+  int8_t(*these_var_indices)[MAX_CNCT] = NULL;
+
+  // When computing the number of layers, we need to recall that the standard always removes
+  // the first two variable nodes from the final codeword.
+  uint8_t n_layers = cdwd_rm_length / q->ls - q->bgK + 2;
+
+  // Codeblocks that have not met the stopping criterion yet, one bit each
+  uint32_t pending = (1U << nof_cb) - 1;
+
+  for (uint32_t i_iteration = 0; i_iteration < q->max_nof_iter && pending != 0; i_iteration++) {
+    for (int i_layer = 0; i_layer < n_layers; i_layer++) {
+      update_ldpc_var_to_check_c_avx2_batch(q->ptr_batch, i_layer);
+
+      this_pcm          = q->pcm + i_layer * q->bgN;
+      these_var_indices = q->var_indices + i_layer;
+
+      update_ldpc_check_to_var_c_avx2_batch(q->ptr_batch, i_layer, this_pcm, these_var_indices);
+
+      update_ldpc_soft_bits_c_avx2_batch(q->ptr_batch, i_layer, these_var_indices);
+    }
+
+    // All the codeblocks satisfying the parity checks at once, or one CRC at a time
+    uint32_t converged = 0;
+    if (crc != NULL) {
+      for (uint32_t i_cb = 0; i_cb < nof_cb; i_cb++) {
+        if ((pending >> i_cb) & 1U) {
+          extract_ldpc_message_c_avx2_batch(q->ptr_batch, i_cb, messages[i_cb], q->liftK);
+          if (srsran_crc_match(crc, messages[i_cb], q->liftK - crc->order)) {
+            converged |= 1U << i_cb;
+          }
+        }
+      }
+    } else if (q->early_stop) {
+      converged = pending & ~check_ldpc_syndrome_c_avx2_batch(q->ptr_batch, n_layers, q->pcm, q->var_indices);
+    }
+
+    for (uint32_t i_cb = 0; i_cb < nof_cb; i_cb++) {
+      if ((converged >> i_cb) & 1U) {
+        if (crc == NULL) {
+          extract_ldpc_message_c_avx2_batch(q->ptr_batch, i_cb, messages[i_cb], q->liftK);
+        }
+        nof_iter[i_cb] = (int)i_iteration + 1;
+        ldpc_decoder_stats_update(q, i_iteration + 1, i_iteration + 1 < q->max_nof_iter, false);
+      }
+    }
+    pending &= ~converged;
+  }
+
+  // Same outcome as the single codeblock decoder for the codeblocks that did not stop early
+  bool check = (crc != NULL || q->early_stop);
+  for (uint32_t i_cb = 0; i_cb < nof_cb; i_cb++) {
+    if ((pending >> i_cb) & 1U) {
+      extract_ldpc_message_c_avx2_batch(q->ptr_batch, i_cb, messages[i_cb], q->liftK);
+      nof_iter[i_cb] = check ? 0 : (int)q->max_nof_iter;
+      ldpc_decoder_stats_update(q, q->max_nof_iter, false, check);
+    }
+  }
+  q->stats.nof_batches++;
+
+  return 0;
+}
+
 /*! Initializes the decoder to work with 8-bit integer-valued LLRs (AVX2 implementation). */
 static int init_c_avx2(srsran_ldpc_decoder_t* q)
 {
@@ -325,6 +461,17 @@ static int init_c_avx2(srsran_ldpc_decoder_t* q)
 
   q->decode_c = decode_c_avx2;
 
+  // Small lifting sizes leave most of the register idle, pack several codeblocks when decoding batches
+  if (get_nof_cb_ldpc_dec_c_avx2_batch(q->ls) > 1) {
+    if ((q->ptr_batch = create_ldpc_dec_c_avx2_batch(q->bgN, q->bgM, q->ls, q->scaling_fctr)) == NULL) {
+      ERROR("Create_ldpc_dec failed");
+      free_dec_c_avx2(q);
+      return -1;
+    }
+    q->batch_size     = get_nof_cb_ldpc_dec_c_avx2_batch(q->ls);
+    q->decode_batch_c = decode_batch_c_avx2;
+  }
+
   return 0;
 }
 
@@ -543,6 +690,20 @@ int srsran_ldpc_decoder_init(srsran_ldpc_decoder_t* q, const srsran_ldpc_decoder
     return -1;
   }
 
+  // Members that are optional for some of the decoder types
+  q->ptr            = NULL;
+  q->ptr_batch      = NULL;
+  q->batch_size     = 1;
+  q->decode_f       = NULL;
+  q->decode_s       = NULL;
+  q->decode_c       = NULL;
+  q->decode_batch_c = NULL;
+  q->codeword       = NULL;
+  q->syndrome       = NULL;
+  q->free           = NULL;
+  q->early_stop     = args->early_stop;
+  srsran_ldpc_decoder_reset_stats(q);
+
   // Extract configuration arguments
   uint16_t                   ls           = args->ls;
   srsran_basegraph_t         bg           = args->bg;
@@ -591,8 +752,21 @@ int srsran_ldpc_decoder_init(srsran_ldpc_decoder_t* q, const srsran_ldpc_decoder
     return -1;
   }
 
+  q->codeword = srsran_vec_u8_malloc(q->liftN);
+  q->syndrome = srsran_vec_u8_malloc(q->ls);
+  if (!q->codeword || !q->syndrome) {
+    free(q->syndrome);
+    free(q->codeword);
+    free(q->var_indices);
+    free(q->pcm);
+    perror("malloc");
+    return -1;
+  }
+
   if (create_compact_pcm(q->pcm, q->var_indices, q->bg, q->ls) != 0) {
     perror("Create PCM");
+    free(q->syndrome);
+    free(q->codeword);
     free(q->var_indices);
     free(q->pcm);
     return -1;
@@ -600,6 +774,8 @@ int srsran_ldpc_decoder_init(srsran_ldpc_decoder_t* q, const srsran_ldpc_decoder
 
   if ((scaling_fctr <= 0) || (scaling_fctr > 1)) {
     perror("The scaling factor of the min-sum algorithm should be larger than 0 and not larger than 1.");
+    free(q->syndrome);
+    free(q->codeword);
     free(q->var_indices);
     free(q->pcm);
     return -1;
@@ -651,9 +827,22 @@ void srsran_ldpc_decoder_free(srsran_ldpc_decoder_t* q)
   if (q->free) {
     q->free(q);
   }
+  if (q->codeword) {
+    free(q->codeword);
+  }
+  if (q->syndrome) {
+    free(q->syndrome);
+  }
   bzero(q, sizeof(srsran_ldpc_decoder_t));
 }
 
+void srsran_ldpc_decoder_reset_stats(srsran_ldpc_decoder_t* q)
+{
+  if (q != NULL) {
+    bzero(&q->stats, sizeof(srsran_ldpc_decoder_stats_t));
+  }
+}
+
 int srsran_ldpc_decoder_decode_f(srsran_ldpc_decoder_t* q, const float* llrs, uint8_t* message, uint32_t cdwd_rm_length)
 {
   return q->decode_f(q, llrs, message, cdwd_rm_length, NULL);
@@ -683,3 +872,35 @@ int srsran_ldpc_decoder_decode_crc_c(srsran_ldpc_decoder_t* q,
 {
   return q->decode_c(q, llrs, message, cdwd_rm_length, crc);
 }
+
+int srsran_ldpc_decoder_decode_batch_c(srsran_ldpc_decoder_t* q,
+                                       int8_t**               llrs,
+                                       uint8_t**              messages,
+                                       uint32_t               nof_cb,
+                                       uint32_t               cdwd_rm_length,
+                                       srsran_crc_t*          crc,
+                                       int*                   nof_iter)
+{
+  if (q == NULL || q->decode_c == NULL || llrs == NULL || messages == NULL || nof_iter == NULL) {
+    return -1;
+  }
+
+  uint32_t i_cb = 0;
+  while (i_cb < nof_cb) {
+    uint32_t count = SRSRAN_MIN(nof_cb - i_cb, q->batch_size);
+    if (q->decode_batch_c != NULL && count > 1) {
+      if (q->decode_batch_c(q, &llrs[i_cb], &messages[i_cb], count, cdwd_rm_length, crc, &nof_iter[i_cb]) < 0) {
+        return -1;
+      }
+    } else {
+      count          = 1;
+      nof_iter[i_cb] = q->decode_c(q, llrs[i_cb], messages[i_cb], cdwd_rm_length, crc);
+      if (nof_iter[i_cb] < 0) {
+        return -1;
+      }
+    }
+    i_cb += count;
+  }
+
+  return 0;
+}
@@ -0,0 +1,308 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_dec_batch_test.c
+ * \brief Unit test and benchmark for the LDPC decoder working with batches of codeblocks.
+ *
+ * For every base graph, lifting size and batch size, random messages are encoded, 2-PAM modulated, sent through an
+ * AWGN channel and decoded with 8-bit LLRs, first one codeblock at a time and then as a batch. The syndrome early stop
+ * is enabled. Both decodings must give the same messages and numbers of iterations, and the decoder statistics must
+ * account for all the codeblocks. The throughput of both decodings is printed for each case.
+ *
+ * Synopsis: **ldpc_dec_batch_test [options]**
+ *
+ * Options:
+ *  - **-b \<number\>** Base Graph (1 or 2, 0 for both. Default 0).
+ *  - **-l \<number\>** Lifting Size (according to 5GNR standard, 0 for a sweep of small sizes. Default 0).
+ *  - **-B \<number\>** Maximum batch size, the sweep goes through the powers of two up to it (Default 16).
+ *  - **-s \<number\>** Signal-to-Noise Ratio in dB (Default 1).
+ *  - **-R \<number\>** Number of times each batch is decoded (Default 100).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/fec/ldpc/ldpc_common.h"
+#include "srsran/phy/fec/ldpc/ldpc_decoder.h"
+#include "srsran/phy/fec/ldpc/ldpc_encoder.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+
+#define MAX_BATCH_SIZE 64 /*!< \brief Maximum number of codeblocks in a batch. */
+
+static int      base_graph     = 0;   /*!< \brief Base Graph (1 or 2, 0 for both). */
+static int      lift_size      = 0;   /*!< \brief Lifting Size, 0 for the sweep. */
+static uint32_t max_batch_size = 16;  /*!< \brief Largest batch size of the sweep. */
+static float    snr            = 1;   /*!< \brief Signal-to-Noise Ratio [dB]. */
+static uint32_t nof_reps       = 100; /*!< \brief Number of times each batch is decoded. */
+
+/*!
+ * \brief Lifting sizes of the sweep: all the packed cases plus a couple of larger ones for reference.
+ */
+static const uint16_t sweep_lift_sizes[] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 20, 32, 64};
+
+/*!
+ * \brief Prints test help when a wrong parameter is passed as input.
+ */
+static void usage(char* prog)
+{
+  printf("Usage: %s [-bX] [-lX] [-BX] [-sX] [-RX]\n", prog);
+  printf("\t-b Base Graph [(1 or 2, 0 for both) Default %d]\n", base_graph);
+  printf("\t-l Lifting Size [(0 for a sweep) Default %d]\n", lift_size);
+  printf("\t-B Maximum batch size [Default %d]\n", max_batch_size);
+  printf("\t-s Signal-to-Noise Ratio [dB, Default %.1f]\n", snr);
+  printf("\t-R Number of times each batch is decoded [Default %d]\n", nof_reps);
+}
+
+/*!
+ * \brief Parses the input line.
+ */
+static void parse_args(int argc, char** argv)
+{
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "b:l:B:s:R:")) != -1) {
+    switch (opt) {
+      case 'b':
+        base_graph = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'l':
+        lift_size = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'B':
+        max_batch_size = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      case 's':
+        snr = (float)strtod(optarg, NULL);
+        break;
+      case 'R':
+        nof_reps = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (base_graph < 0 || base_graph > 2 || max_batch_size == 0 || max_batch_size > MAX_BATCH_SIZE || nof_reps == 0) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+/*!
+ * \brief Returns the elapsed time between two time stamps in seconds.
+ */
+static double elapsed_s(struct timeval* t)
+{
+  get_time_interval(t);
+  return t[0].tv_sec + 1e-6 * t[0].tv_usec;
+}
+
+/*!
+ * \brief Decodes a batch of random codeblocks, one by one and at once, and compares the results.
+ */
+static int run_test(srsran_random_t random_gen, srsran_basegraph_t bg, uint16_t ls, uint32_t batch_size)
+{
+  int ret = -1;
+
+  srsran_ldpc_decoder_args_t decoder_args = {};
+#ifdef LV_HAVE_AVX2
+  decoder_args.type = SRSRAN_LDPC_DECODER_C_AVX2;
+#else  // LV_HAVE_AVX2
+  decoder_args.type = SRSRAN_LDPC_DECODER_C;
+#endif // LV_HAVE_AVX2
+  decoder_args.bg           = bg;
+  decoder_args.ls           = ls;
+  decoder_args.scaling_fctr = 0.8f;
+  decoder_args.early_stop   = true;
+
+  srsran_ldpc_decoder_t decoder;
+  if (srsran_ldpc_decoder_init(&decoder, &decoder_args) != 0) {
+    ERROR("Error initialising the decoder for BG%d and ls=%d", bg + 1, ls);
+    return -1;
+  }
+
+  srsran_ldpc_encoder_t encoder;
+  if (srsran_ldpc_encoder_init(&encoder, SRSRAN_LDPC_ENCODER_C, bg, ls) != 0) {
+    ERROR("Error initialising the encoder for BG%d and ls=%d", bg + 1, ls);
+    srsran_ldpc_decoder_free(&decoder);
+    return -1;
+  }
+
+  uint32_t finalK        = decoder.liftK;
+  uint32_t finalN        = decoder.liftN - 2 * ls;
+  float    noise_var     = srsran_convert_dB_to_power(-snr);
+  float    noise_std_dev = srsran_convert_dB_to_amplitude(-snr);
+  int8_t   inf7          = (1U << 6U) - 1;
+  float    gain_c        = inf7 * noise_std_dev / 8 / (1 / noise_std_dev + 2);
+
+  uint8_t* messages_true = srsran_vec_u8_malloc(finalK * batch_size);
+  uint8_t* messages_cb   = srsran_vec_u8_malloc(finalK * batch_size);
+  uint8_t* messages_bt   = srsran_vec_u8_malloc(finalK * batch_size);
+  uint8_t* codewords     = srsran_vec_u8_malloc(finalN * batch_size);
+  float*   symbols       = srsran_vec_f_malloc(finalN * batch_size);
+  int8_t*  llrs          = srsran_vec_i8_malloc(finalN * batch_size);
+  if (!messages_true || !messages_cb || !messages_bt || !codewords || !symbols || !llrs) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
+  int8_t*  llrs_ptr[MAX_BATCH_SIZE];
+  uint8_t* messages_ptr[MAX_BATCH_SIZE];
+  int      nof_iter_cb[MAX_BATCH_SIZE];
+  int      nof_iter_bt[MAX_BATCH_SIZE];
+
+  for (uint32_t i = 0; i < batch_size; i++) {
+    for (uint32_t j = 0; j < finalK; j++) {
+      messages_true[i * finalK + j] = srsran_random_uniform_int_dist(random_gen, 0, 1);
+    }
+    srsran_ldpc_encoder_encode(&encoder, messages_true + i * finalK, codewords + i * finalN, finalK);
+    for (uint32_t j = 0; j < finalN; j++) {
+      symbols[i * finalN + j] = 1 - 2 * codewords[i * finalN + j];
+    }
+    llrs_ptr[i]     = llrs + i * finalN;
+    messages_ptr[i] = messages_bt + i * finalK;
+  }
+
+  srsran_ch_awgn_f(symbols, symbols, noise_var, batch_size * finalN);
+  srsran_vec_sc_prod_fff(symbols, 2 / noise_var, symbols, batch_size * finalN);
+  srsran_vec_quant_fc(symbols, llrs, gain_c, 0, inf7, batch_size * finalN);
+
+  struct timeval t[3];
+
+  // One codeblock at a time
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    for (uint32_t i = 0; i < batch_size; i++) {
+      nof_iter_cb[i] =
+          srsran_ldpc_decoder_decode_crc_c(&decoder, llrs + i * finalN, messages_cb + i * finalK, finalN, NULL);
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  double time_cb = elapsed_s(t);
+
+  // The whole batch at once
+  srsran_ldpc_decoder_reset_stats(&decoder);
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    if (srsran_ldpc_decoder_decode_batch_c(&decoder, llrs_ptr, messages_ptr, batch_size, finalN, NULL, nof_iter_bt)) {
+      ERROR("Error decoding batch");
+      goto clean_exit;
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  double time_bt = elapsed_s(t);
+
+  uint32_t nof_errors = 0;
+  for (uint32_t i = 0; i < batch_size; i++) {
+    if (nof_iter_cb[i] != nof_iter_bt[i]) {
+      ERROR("BG%d, ls=%d, batch=%d: codeblock %d took %d iterations alone and %d in the batch",
+            bg + 1,
+            ls,
+            batch_size,
+            i,
+            nof_iter_cb[i],
+            nof_iter_bt[i]);
+      goto clean_exit;
+    }
+    if (memcmp(messages_cb + i * finalK, messages_bt + i * finalK, finalK) != 0) {
+      ERROR("BG%d, ls=%d, batch=%d: codeblock %d decoded differently in the batch", bg + 1, ls, batch_size, i);
+      goto clean_exit;
+    }
+    nof_errors += (memcmp(messages_true + i * finalK, messages_bt + i * finalK, finalK) != 0) ? 1 : 0;
+  }
+
+  srsran_ldpc_decoder_stats_t* stats   = &decoder.stats;
+  uint64_t                     nof_cbs = (uint64_t)batch_size * nof_reps;
+  if (stats->nof_cb != nof_cbs || stats->nof_early_stops + stats->nof_failures > nof_cbs) {
+    ERROR("BG%d, ls=%d, batch=%d: inconsistent statistics, %ld codeblocks", bg + 1, ls, batch_size, (long)nof_cbs);
+    goto clean_exit;
+  }
+
+  printf("BG%d ls=%3d batch=%2d (packed %2d): %8.2f Mbps one by one, %8.2f Mbps batch (x%.2f), %.2f iter/cb, "
+         "%ld early stops, %ld failures, %d wrong codeblocks\n",
+         bg + 1,
+         ls,
+         batch_size,
+         decoder.batch_size,
+         finalK * batch_size * nof_reps / time_cb / 1e6,
+         finalK * batch_size * nof_reps / time_bt / 1e6,
+         time_cb / time_bt,
+         (double)stats->nof_iter / stats->nof_cb,
+         (long)stats->nof_early_stops,
+         (long)stats->nof_failures,
+         nof_errors);
+
+  ret = 0;
+
+clean_exit:
+  free(llrs);
+  free(symbols);
+  free(codewords);
+  free(messages_bt);
+  free(messages_cb);
+  free(messages_true);
+  srsran_ldpc_encoder_free(&encoder);
+  srsran_ldpc_decoder_free(&decoder);
+  return ret;
+}
+
+/*!
+ * \brief Main test function.
+ */
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srsran_random_t random_gen = srsran_random_init(0);
+
+  const uint16_t* lift_sizes     = sweep_lift_sizes;
+  uint32_t        nof_lift_sizes = sizeof(sweep_lift_sizes) / sizeof(sweep_lift_sizes[0]);
+  uint16_t        single_ls      = (uint16_t)lift_size;
+  if (lift_size != 0) {
+    lift_sizes     = &single_ls;
+    nof_lift_sizes = 1;
+  }
+
+  int ret = 0;
+  for (int bg = BG1; bg <= BG2 && ret == 0; bg++) {
+    if (base_graph != 0 && bg != base_graph - 1) {
+      continue;
+    }
+    for (uint32_t i = 0; i < nof_lift_sizes && ret == 0; i++) {
+      for (uint32_t batch_size = 1; batch_size <= max_batch_size && ret == 0; batch_size *= 2) {
+        ret = run_test(random_gen, (srsran_basegraph_t)bg, lift_sizes[i], batch_size);
+      }
+    }
+  }
+
+  srsran_random_free(random_gen);
+
+  if (ret == 0) {
+    printf("\nTest completed successfully!\n\n");
+  }
+  return ret;
+}
@@ -41,6 +41,7 @@
 #include "polar_decoder_ssc_c_avx2.h"
 #include "polar_decoder_ssc_f.h"
 #include "polar_decoder_ssc_s.h"
+#include "polar_decoder_sscl_c_avx2.h"
 #include "srsran/phy/fec/polar/polar_decoder.h"
 #include "srsran/phy/utils/debug.h"
 
@@ -112,6 +113,36 @@ static int decode_ssc_c_avx2(void*           o,
 
   return 0;
 }
+
+/*! SSCL Polar decoder AVX2 with int8_t LLR inputs, it returns the most likely candidate. */
+static int decode_sscl_c_avx2(void*           o,
+                              const int8_t*   symbols,
+                              uint8_t*        data,
+                              const uint8_t   n,
+                              const uint16_t* frozen_set,
+                              const uint16_t  frozen_set_size)
+{
+  srsran_polar_decoder_t* q = o;
+
+  init_polar_decoder_sscl_c_avx2(q->ptr, symbols, n, frozen_set, frozen_set_size);
+
+  return (polar_decoder_sscl_c_avx2(q->ptr, &data, 1) == 1) ? 0 : -1;
+}
+
+/*! SSCL Polar decoder AVX2 with int8_t LLR inputs, it returns all the candidates of the list. */
+static int decode_list_sscl_c_avx2(void*           o,
+                                   const int8_t*   symbols,
+                                   uint8_t**       data,
+                                   const uint8_t   n,
+                                   const uint16_t* frozen_set,
+                                   const uint16_t  frozen_set_size)
+{
+  srsran_polar_decoder_t* q = o;
+
+  init_polar_decoder_sscl_c_avx2(q->ptr, symbols, n, frozen_set, frozen_set_size);
+
+  return polar_decoder_sscl_c_avx2(q->ptr, data, q->list_size);
+}
 #endif // LV_HAVE_AVX2
 
 /*! Destructor of a (float) SSC polar decoder. */
@@ -142,6 +173,13 @@ static void free_ssc_c_avx2(void* o)
   srsran_polar_decoder_t* q = o;
   delete_polar_decoder_ssc_c_avx2(q->ptr);
 }
+
+/*! Destructor of a (int8_t, avx2) SSCL polar decoder. */
+static void free_sscl_c_avx2(void* o)
+{
+  srsran_polar_decoder_t* q = o;
+  delete_polar_decoder_sscl_c_avx2(q->ptr);
+}
 #endif
 
 /*! Initializes a polar decoder structure to use the SSC polar decoder algorithm with float LLR inputs. */
@@ -201,11 +239,33 @@ static int init_ssc_c_avx2(srsran_polar_decoder_t* q)
   }
   return 0;
 }
+
+/*! Initializes a polar decoder structure to use the SSCL polar decoder algorithm with uint8_t LLR inputs and AVX2
+ * instructions. */
+static int init_sscl_c_avx2(srsran_polar_decoder_t* q, uint8_t list_size)
+{
+  q->decode_c      = decode_sscl_c_avx2;
+  q->decode_list_c = decode_list_sscl_c_avx2;
+  q->free          = free_sscl_c_avx2;
+  q->list_size     = list_size;
+
+  if ((q->ptr = create_polar_decoder_sscl_c_avx2(q->nMax, list_size)) == NULL) {
+    ERROR("create_polar_decoder_sscl_c_avx2 failed");
+    free_sscl_c_avx2(q);
+    return -1;
+  }
+  return 0;
+}
 #endif
 
 int srsran_polar_decoder_init(srsran_polar_decoder_t* q, srsran_polar_decoder_type_t type, const uint8_t nMax)
 {
-  q->nMax = nMax;
+  q->nMax          = nMax;
+  q->list_size     = 1;
+  q->decode_f      = NULL;
+  q->decode_s      = NULL;
+  q->decode_c      = NULL;
+  q->decode_list_c = NULL;
   switch (type) {
     case SRSRAN_POLAR_DECODER_SSC_F:
       return init_ssc_f(q);
@@ -216,6 +276,12 @@ int srsran_polar_decoder_init(srsran_polar_decoder_t* q, srsran_polar_decoder_ty
 #ifdef LV_HAVE_AVX2
     case SRSRAN_POLAR_DECODER_SSC_C_AVX2:
       return init_ssc_c_avx2(q);
+    case SRSRAN_POLAR_DECODER_SSCL2_C_AVX2:
+      return init_sscl_c_avx2(q, 2);
+    case SRSRAN_POLAR_DECODER_SSCL4_C_AVX2:
+      return init_sscl_c_avx2(q, 4);
+    case SRSRAN_POLAR_DECODER_SSCL8_C_AVX2:
+      return init_sscl_c_avx2(q, 8);
 #endif
     default:
       ERROR("Decoder not implemented");
@@ -273,3 +339,25 @@ int srsran_polar_decoder_decode_c(srsran_polar_decoder_t* q,
 
   return -1;
 }
+
+int srsran_polar_decoder_decode_list_c(srsran_polar_decoder_t* q,
+                                       const int8_t*           llr,
+                                       uint8_t**               data_decoded,
+                                       const uint8_t           n,
+                                       const uint16_t*         frozen_set,
+                                       const uint16_t          frozen_set_size)
+{
+  if (q->nMax < n) {
+    return -1;
+  }
+
+  if (q->decode_list_c != NULL) {
+    return q->decode_list_c(q, llr, data_decoded, n, frozen_set, frozen_set_size);
+  }
+
+  if (q->decode_c != NULL && q->decode_c(q, llr, data_decoded[0], n, frozen_set, frozen_set_size) == 0) {
+    return 1;
+  }
+
+  return -1;
+}
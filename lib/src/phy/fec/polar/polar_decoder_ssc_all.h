@@ -46,6 +46,8 @@ typedef enum {
   RATE_0 = 0, /*!< \brief See function rate_0_node(). */
   RATE_R = 2, /*!< \brief See function rate_r_node(). */
   RATE_1 = 3, /*!< \brief See function rate_1_node(). */
+  REP    = 4, /*!< \brief Repetition node, only the last bit is not frozen (SSCL decoder only). */
+  SPC    = 5, /*!< \brief Single parity-check node, only the first bit is frozen (SSCL decoder only). */
 } node_rate;
 
 /*!
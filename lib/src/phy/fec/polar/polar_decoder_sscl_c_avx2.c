@@ -0,0 +1,758 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_decoder_sscl_c_avx2.c
+ * \brief Definition of the SSC List (SSCL) polar decoder inner functions working with
+ * 8-bit integer-valued LLRs and AVX2 instructions.
+ *
+ * The decoder walks the same decoding tree as the SSC decoder while keeping up to \a list_size paths. Besides the
+ * ::RATE_0 and ::RATE_1 nodes, ::REP and ::SPC nodes are decoded in one go (Fast-SSCL): rate-1 and SPC nodes only fork
+ * on their least reliable bits, repetition nodes fork on the two valid codewords. The LLRs of every stage are kept in a
+ * pool of \a list_size buffers shared among paths with reference counters, so that cloning a path does not copy LLRs.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#include "polar_decoder_sscl_c_avx2.h"
+#include "../utils_avx2.h"
+#include "polar_decoder_vector_avx2.h"
+#include "srsran/phy/fec/polar/polar_code.h"
+#include "srsran/phy/fec/polar/polar_decoder.h"
+#include "srsran/phy/fec/polar/polar_encoder.h"
+#include "srsran/phy/utils/vector.h"
+
+#ifdef LV_HAVE_AVX2
+
+#include <immintrin.h>
+
+#define MAX_LIST SRSRAN_POLAR_DECODER_MAX_LIST_SIZE
+
+/*!
+ * \brief Bit value in the estimated bit buffers, bits are represented by {0, 128}.
+ */
+#define BIT_ONE 0x80
+
+/*!
+ * \brief Describes a candidate path when the list forks.
+ */
+struct Candidate {
+  int32_t pm;     /*!< \brief Path metric of the candidate, the lower the more likely. */
+  uint8_t path;   /*!< \brief Parent path, replaced by the path holding the candidate after the selection. */
+  uint8_t choice; /*!< \brief Node-specific decision taken on the parent path. */
+};
+
+/*!
+ * \brief Describes an SSCL polar decoder (8-bit version).
+ */
+struct pSSCL_c_avx2 {
+  uint8_t                 list_size;                     /*!< \brief Maximum number of paths. */
+  uint8_t                 code_size_log;                 /*!< \brief \f$log_2\f$ of code size. */
+  uint16_t                bit_pos;                       /*!< \brief Position of the next bit to be estimated. */
+  uint16_t                code_stage_size[NMAX_LOG + 1]; /*!< \brief Number of bits of a node at a given stage. */
+  uint8_t*                node_type[NMAX_LOG + 1];       /*!< \brief Node type at every stage, see ::node_rate. */
+  uint16_t*               nof_info[NMAX_LOG + 1];        /*!< \brief Number of non-frozen bits below every node. */
+  uint8_t*                is_frozen;                     /*!< \brief Frozen bit indicator of the codeword bits. */
+  uint16_t*               frozen_set;                    /*!< \brief Frozen set of the current node types. */
+  uint16_t                frozen_set_size;               /*!< \brief Size of the cached frozen set. */
+  uint8_t                 frozen_set_code_size_log;      /*!< \brief Code size of the cached frozen set, 0 if none. */
+  srsran_polar_encoder_t* enc;                           /*!< \brief Pointer to a srsran_polar_encoder_t. */
+
+  int8_t*   llr[NMAX_LOG + 1][MAX_LIST];      /*!< \brief Pool of LLR buffers at every stage. */
+  uint8_t   llr_refs[NMAX_LOG + 1][MAX_LIST]; /*!< \brief Number of paths using each buffer. */
+  uint8_t   llr_idx[MAX_LIST][NMAX_LOG + 1];  /*!< \brief Buffer used by each path at each stage. */
+  uint8_t*  est_bit[MAX_LIST];                /*!< \brief Estimated (coded) bits of each path. */
+  int32_t   pm[MAX_LIST];                     /*!< \brief Path metric of each path. */
+  bool      active[MAX_LIST];                 /*!< \brief True if the path is in the list. */
+  uint16_t  flip_pos[MAX_LIST][MAX_LIST];     /*!< \brief Least reliable bits of the node, per path. */
+  int32_t   flip_llr[MAX_LIST][MAX_LIST];     /*!< \brief Their absolute LLR, per path. */
+  bool      spc_flipped[MAX_LIST];            /*!< \brief True if the SPC parity bit is flipped. */
+  int8_t*   llr_buffer;                       /*!< \brief Memory of all the LLR buffers. */
+  uint8_t*  est_bit_buffer;                   /*!< \brief Memory of all the estimated bits. */
+  uint8_t*  node_type_buffer;                 /*!< \brief Memory of all the node types. */
+  uint16_t* nof_info_buffer;                  /*!< \brief Memory of all the non-frozen bit counters. */
+};
+
+/*!
+ * Size of the LLR buffers at a given stage, the AVX2 functions read and write \ref SRSRAN_AVX2_B_SIZE bytes past the
+ * end of short vectors.
+ */
+static uint32_t llr_buffer_size(uint32_t stage_size)
+{
+  return SRSRAN_MAX(stage_size, SRSRAN_AVX2_B_SIZE) + SRSRAN_AVX2_B_SIZE;
+}
+
+void delete_polar_decoder_sscl_c_avx2(void* p)
+{
+  struct pSSCL_c_avx2* pp = p;
+
+  if (p != NULL) {
+    if (pp->llr_buffer) {
+      free(pp->llr_buffer);
+    }
+    if (pp->est_bit_buffer) {
+      free(pp->est_bit_buffer);
+    }
+    if (pp->node_type_buffer) {
+      free(pp->node_type_buffer);
+    }
+    if (pp->nof_info_buffer) {
+      free(pp->nof_info_buffer);
+    }
+    if (pp->is_frozen) {
+      free(pp->is_frozen);
+    }
+    if (pp->frozen_set) {
+      free(pp->frozen_set);
+    }
+    if (pp->enc) {
+      srsran_polar_encoder_free(pp->enc);
+      free(pp->enc);
+    }
+    free(pp);
+  }
+}
+
+void* create_polar_decoder_sscl_c_avx2(const uint8_t nMax, const uint8_t list_size)
+{
+  struct pSSCL_c_avx2* pp = NULL; // pointer to the polar decoder instance
+
+  if (nMax > NMAX_LOG || list_size < 2 || list_size > MAX_LIST) {
+    return NULL;
+  }
+
+  // allocate memory to the polar decoder instance
+  if ((pp = calloc(1, sizeof(struct pSSCL_c_avx2))) == NULL) {
+    return NULL;
+  }
+  pp->list_size = list_size;
+
+  pp->code_stage_size[0] = 1;
+  for (uint8_t i = 1; i < NMAX_LOG + 1; i++) {
+    pp->code_stage_size[i] = 2 * pp->code_stage_size[i - 1];
+  }
+  uint32_t code_size = pp->code_stage_size[nMax];
+
+  // encoder of maximum size
+  if ((pp->enc = malloc(sizeof(srsran_polar_encoder_t))) == NULL) {
+    delete_polar_decoder_sscl_c_avx2(pp);
+    return NULL;
+  }
+  if (srsran_polar_encoder_init(pp->enc, SRSRAN_POLAR_ENCODER_AVX2, nMax) != 0) {
+    free(pp->enc);
+    pp->enc = NULL;
+    delete_polar_decoder_sscl_c_avx2(pp);
+    return NULL;
+  }
+
+  // LLR pools, list_size buffers per stage
+  uint32_t llr_all_stages = 0;
+  for (uint8_t s = 0; s < nMax + 1; s++) {
+    llr_all_stages += list_size * llr_buffer_size(pp->code_stage_size[s]);
+  }
+  if ((pp->llr_buffer = srsran_vec_i8_malloc(llr_all_stages)) == NULL) {
+    delete_polar_decoder_sscl_c_avx2(pp);
+    return NULL;
+  }
+  int8_t* llr_ptr = pp->llr_buffer;
+  for (uint8_t s = 0; s < nMax + 1; s++) {
+    for (uint8_t l = 0; l < list_size; l++) {
+      pp->llr[s][l] = llr_ptr;
+      llr_ptr += llr_buffer_size(pp->code_stage_size[s]);
+    }
+  }
+
+  // estimated bits, with SRSRAN_AVX2_B_SIZE extra bytes for the output of 256-bit instructions
+  uint32_t est_bit_size = code_size + SRSRAN_AVX2_B_SIZE;
+  if ((pp->est_bit_buffer = srsran_vec_u8_malloc(list_size * est_bit_size)) == NULL) {
+    delete_polar_decoder_sscl_c_avx2(pp);
+    return NULL;
+  }
+  for (uint8_t l = 0; l < list_size; l++) {
+    pp->est_bit[l] = pp->est_bit_buffer + l * est_bit_size;
+  }
+
+  // node types and counters, stage s has 2^(nMax - s) nodes
+  pp->node_type_buffer = srsran_vec_u8_malloc(2 * code_size);
+  pp->nof_info_buffer  = srsran_vec_u16_malloc(2 * code_size);
+  pp->is_frozen        = srsran_vec_u8_malloc(code_size);
+  pp->frozen_set       = srsran_vec_u16_malloc(code_size);
+  if (pp->node_type_buffer == NULL || pp->nof_info_buffer == NULL || pp->is_frozen == NULL || pp->frozen_set == NULL) {
+    delete_polar_decoder_sscl_c_avx2(pp);
+    return NULL;
+  }
+  pp->node_type[0] = pp->node_type_buffer;
+  pp->nof_info[0]  = pp->nof_info_buffer;
+  for (uint8_t s = 1; s < nMax + 1; s++) {
+    pp->node_type[s] = pp->node_type[s - 1] + pp->code_stage_size[nMax - s + 1];
+    pp->nof_info[s]  = pp->nof_info[s - 1] + pp->code_stage_size[nMax - s + 1];
+  }
+
+  return pp;
+}
+
+/*!
+ * Computes the node types of the decoding tree. On top of the SSC node types, the nodes with a single non-frozen bit
+ * in the last position are ::REP nodes and the nodes with a single frozen bit in the first position are ::SPC nodes.
+ */
+static void compute_node_type_sscl(struct pSSCL_c_avx2* pp, const uint16_t* frozen_set, const uint16_t frozen_set_size)
+{
+  uint8_t  code_size_log = pp->code_size_log;
+  uint16_t code_size     = pp->code_stage_size[code_size_log];
+
+  // The decoding tree is reused while the code does not change, as it happens when decoding several candidates
+  if (pp->frozen_set_code_size_log != 0 && pp->frozen_set_code_size_log == code_size_log &&
+      pp->frozen_set_size == frozen_set_size &&
+      memcmp(pp->frozen_set, frozen_set, frozen_set_size * sizeof(uint16_t)) == 0) {
+    return;
+  }
+  pp->frozen_set_code_size_log = code_size_log;
+  pp->frozen_set_size          = frozen_set_size;
+  memcpy(pp->frozen_set, frozen_set, frozen_set_size * sizeof(uint16_t));
+
+  memset(pp->is_frozen, 0, code_size);
+  for (uint16_t i = 0; i < frozen_set_size; i++) {
+    pp->is_frozen[frozen_set[i]] = 1;
+  }
+
+  for (uint16_t j = 0; j < code_size; j++) {
+    pp->nof_info[0][j]  = 1 - pp->is_frozen[j];
+    pp->node_type[0][j] = pp->is_frozen[j] ? RATE_0 : RATE_1;
+  }
+
+  for (uint8_t s = 1; s < code_size_log + 1; s++) {
+    uint16_t stage_size = pp->code_stage_size[s];
+    for (uint16_t j = 0; j < (code_size >> s); j++) {
+      uint16_t nof_info   = pp->nof_info[s - 1][2 * j] + pp->nof_info[s - 1][2 * j + 1];
+      uint16_t first      = j * stage_size;
+      pp->nof_info[s][j] = nof_info;
+
+      if (nof_info == 0) {
+        pp->node_type[s][j] = RATE_0;
+      } else if (nof_info == stage_size) {
+        pp->node_type[s][j] = RATE_1;
+      } else if (nof_info == 1 && !pp->is_frozen[first + stage_size - 1]) {
+        pp->node_type[s][j] = REP;
+      } else if (nof_info == stage_size - 1 && pp->is_frozen[first]) {
+        pp->node_type[s][j] = SPC;
+      } else {
+        pp->node_type[s][j] = RATE_R;
+      }
+    }
+  }
+}
+
+int init_polar_decoder_sscl_c_avx2(void*           p,
+                                   const int8_t*   input_llr,
+                                   const uint8_t   code_size_log,
+                                   const uint16_t* frozen_set,
+                                   const uint16_t  frozen_set_size)
+{
+  struct pSSCL_c_avx2* pp = p;
+
+  if (p == NULL) {
+    return -1;
+  }
+
+  pp->code_size_log = code_size_log;
+  pp->bit_pos       = 0;
+
+  // A single path, using the first buffer of every stage. The input LLRs go to the last stage.
+  memset(pp->llr_refs, 0, sizeof(pp->llr_refs));
+  memset(pp->active, 0, sizeof(pp->active));
+  for (uint8_t s = 0; s < code_size_log + 1; s++) {
+    pp->llr_idx[0][s]  = 0;
+    pp->llr_refs[s][0] = 1;
+  }
+  pp->active[0] = true;
+  pp->pm[0]     = 0;
+
+  srsran_vec_i8_copy(pp->llr[code_size_log][0], input_llr, pp->code_stage_size[code_size_log]);
+
+  compute_node_type_sscl(pp, frozen_set, frozen_set_size);
+
+  return 0;
+}
+
+/*!
+ * Returns the LLRs of a path at a given stage, for reading.
+ */
+static inline int8_t* path_llr(struct pSSCL_c_avx2* pp, uint8_t path, uint8_t stage)
+{
+  return pp->llr[stage][pp->llr_idx[path][stage]];
+}
+
+/*!
+ * Returns the LLRs of a path at a given stage, for writing. If the buffer is shared with other paths, the path gets a
+ * free one. There is always a free buffer, as there are as many buffers as paths.
+ */
+static int8_t* path_llr_write(struct pSSCL_c_avx2* pp, uint8_t path, uint8_t stage)
+{
+  uint8_t idx = pp->llr_idx[path][stage];
+
+  if (pp->llr_refs[stage][idx] > 1) {
+    pp->llr_refs[stage][idx]--;
+    for (idx = 0; pp->llr_refs[stage][idx] != 0; idx++) {
+      // look for the first free buffer
+    }
+    pp->llr_refs[stage][idx] = 1;
+    pp->llr_idx[path][stage] = idx;
+  }
+
+  return pp->llr[stage][idx];
+}
+
+/*!
+ * Makes a path use, at a given stage, the LLR buffer of another path.
+ */
+static void path_llr_share(struct pSSCL_c_avx2* pp, uint8_t path, uint8_t other, uint8_t stage)
+{
+  pp->llr_refs[stage][pp->llr_idx[path][stage]]--;
+  pp->llr_idx[path][stage] = pp->llr_idx[other][stage];
+  pp->llr_refs[stage][pp->llr_idx[path][stage]]++;
+}
+
+static void path_kill(struct pSSCL_c_avx2* pp, uint8_t path)
+{
+  for (uint8_t s = 0; s < pp->code_size_log + 1; s++) {
+    pp->llr_refs[s][pp->llr_idx[path][s]]--;
+  }
+  pp->active[path] = false;
+}
+
+/*!
+ * Copies a path into a free slot of the list. The LLR buffers are shared, the estimated bits are copied up to
+ * \a bit_end.
+ */
+static void path_clone(struct pSSCL_c_avx2* pp, uint8_t path, uint8_t clone, uint16_t bit_end)
+{
+  for (uint8_t s = 0; s < pp->code_size_log + 1; s++) {
+    pp->llr_idx[clone][s] = pp->llr_idx[path][s];
+    pp->llr_refs[s][pp->llr_idx[path][s]]++;
+  }
+  memcpy(pp->est_bit[clone], pp->est_bit[path], bit_end);
+  memcpy(pp->flip_pos[clone], pp->flip_pos[path], sizeof(pp->flip_pos[path]));
+  memcpy(pp->flip_llr[clone], pp->flip_llr[path], sizeof(pp->flip_llr[path]));
+  pp->spc_flipped[clone] = pp->spc_flipped[path];
+  pp->pm[clone]          = pp->pm[path];
+  pp->active[clone]      = true;
+}
+
+/*!
+ * Keeps the \a list_size candidates with the lowest path metric. The paths without surviving candidates leave the
+ * list and the paths with more than one are cloned. On return, \a cand[i].path is the path where the decision of the
+ * i-th surviving candidate must be applied, and the path metrics are updated.
+ * \return The number of surviving candidates.
+ */
+static uint32_t select_paths(struct pSSCL_c_avx2* pp, struct Candidate* cand, uint32_t nof_cand, uint16_t bit_end)
+{
+  // Insertion sort, there are at most 2 * list_size candidates
+  for (uint32_t i = 1; i < nof_cand; i++) {
+    struct Candidate c = cand[i];
+    uint32_t         j = i;
+    for (; j > 0 && cand[j - 1].pm > c.pm; j--) {
+      cand[j] = cand[j - 1];
+    }
+    cand[j] = c;
+  }
+  uint32_t nof_survivors = SRSRAN_MIN(nof_cand, pp->list_size);
+
+  uint8_t nof_children[MAX_LIST] = {};
+  for (uint32_t i = 0; i < nof_survivors; i++) {
+    nof_children[cand[i].path]++;
+  }
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (pp->active[l] && nof_children[l] == 0) {
+      path_kill(pp, l);
+    }
+  }
+
+  // The first child of every path stays in place, the others are cloned before applying any decision
+  bool    in_place[MAX_LIST] = {};
+  uint8_t free_path          = 0;
+  for (uint32_t i = 0; i < nof_survivors; i++) {
+    uint8_t path = cand[i].path;
+    if (!in_place[path]) {
+      in_place[path] = true;
+      continue;
+    }
+    while (pp->active[free_path]) {
+      free_path++;
+    }
+    path_clone(pp, path, free_path, bit_end);
+    cand[i].path = free_path;
+  }
+
+  for (uint32_t i = 0; i < nof_survivors; i++) {
+    pp->pm[cand[i].path] = cand[i].pm;
+  }
+
+  return nof_survivors;
+}
+
+/*!
+ * Computes the path metric penalties of deciding all bits to zero (\a pen0) and all bits to one (\a pen1), that is,
+ * the sum of the absolute values of the negative and positive LLRs, respectively.
+ */
+static void llr_penalties(const int8_t* llr, uint16_t len, int32_t* pen0, int32_t* pen1)
+{
+  int32_t  sum0 = 0;
+  int32_t  sum1 = 0;
+  uint16_t i    = 0;
+
+  if (len >= SRSRAN_AVX2_B_SIZE) {
+    const __m256i m_zero = _mm256_setzero_si256();
+    __m256i       m_sum0 = _mm256_setzero_si256();
+    __m256i       m_sum1 = _mm256_setzero_si256();
+
+    for (; i < len; i += SRSRAN_AVX2_B_SIZE) {
+      __m256i m_llr = _mm256_loadu_si256((__m256i*)&llr[i]);
+      __m256i m_neg = _mm256_max_epi8(_mm256_subs_epi8(m_zero, m_llr), m_zero);
+      __m256i m_pos = _mm256_max_epi8(m_llr, m_zero);
+
+      // absolute values are at most 127, add them by groups of 8 into 64-bit words
+      m_sum0 = _mm256_add_epi64(m_sum0, _mm256_sad_epu8(m_neg, m_zero));
+      m_sum1 = _mm256_add_epi64(m_sum1, _mm256_sad_epu8(m_pos, m_zero));
+    }
+
+    __m128i m_sum0_128 = _mm_add_epi64(_mm256_castsi256_si128(m_sum0), _mm256_extracti128_si256(m_sum0, 1));
+    __m128i m_sum1_128 = _mm_add_epi64(_mm256_castsi256_si128(m_sum1), _mm256_extracti128_si256(m_sum1, 1));
+    sum0               = (int32_t)(_mm_cvtsi128_si64(m_sum0_128) + _mm_extract_epi64(m_sum0_128, 1));
+    sum1               = (int32_t)(_mm_cvtsi128_si64(m_sum1_128) + _mm_extract_epi64(m_sum1_128, 1));
+  }
+
+  for (; i < len; i++) {
+    if (llr[i] < 0) {
+      sum0 -= SRSRAN_MAX(llr[i], -127);
+    } else {
+      sum1 += llr[i];
+    }
+  }
+
+  *pen0 = sum0;
+  *pen1 = sum1;
+}
+
+/*!
+ * Returns the parity of the hard decisions of the given LLRs.
+ */
+static uint32_t hard_bit_parity(const int8_t* llr, uint16_t len)
+{
+  uint32_t parity = 0;
+  uint16_t i      = 0;
+
+  for (; i + SRSRAN_AVX2_B_SIZE <= len; i += SRSRAN_AVX2_B_SIZE) {
+    parity ^= (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((__m256i*)&llr[i])));
+  }
+  for (; i < len; i++) {
+    parity ^= (llr[i] < 0) ? 1 : 0;
+  }
+
+  return parity & 1U;
+}
+
+/*!
+ * Finds the \a nof_pos least reliable LLRs, sorted by increasing absolute value.
+ */
+static void least_reliable(const int8_t* llr, uint16_t len, uint32_t nof_pos, uint16_t* pos, int32_t* abs_llr)
+{
+  uint32_t count = 0;
+
+  for (uint16_t i = 0; i < len; i++) {
+    int32_t a = abs(llr[i]);
+    if (count == nof_pos && a >= abs_llr[count - 1]) {
+      continue;
+    }
+    uint32_t j = (count < nof_pos) ? count++ : count - 1;
+    for (; j > 0 && abs_llr[j - 1] > a; j--) {
+      abs_llr[j] = abs_llr[j - 1];
+      pos[j]     = pos[j - 1];
+    }
+    abs_llr[j] = a;
+    pos[j]     = i;
+  }
+}
+
+/*!
+ * All bits below a ::RATE_0 node are 0, the paths are penalized by the LLRs that disagree.
+ */
+static void rate_0_node(struct pSSCL_c_avx2* pp, uint8_t stage)
+{
+  uint16_t stage_size = pp->code_stage_size[stage];
+
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (pp->active[l]) {
+      int32_t pen0 = 0;
+      int32_t pen1 = 0;
+      llr_penalties(path_llr(pp, l, stage), stage_size, &pen0, &pen1);
+      pp->pm[l] += pen0;
+      memset(pp->est_bit[l] + pp->bit_pos, 0, stage_size);
+    }
+  }
+  pp->bit_pos += stage_size;
+}
+
+/*!
+ * A ::REP node can only be all zeros or all ones, every path forks into both.
+ */
+static void rep_node(struct pSSCL_c_avx2* pp, uint8_t stage)
+{
+  uint16_t         stage_size = pp->code_stage_size[stage];
+  struct Candidate cand[2 * MAX_LIST];
+  uint32_t         nof_cand = 0;
+
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (pp->active[l]) {
+      int32_t pen0 = 0;
+      int32_t pen1 = 0;
+      llr_penalties(path_llr(pp, l, stage), stage_size, &pen0, &pen1);
+      cand[nof_cand++] = (struct Candidate){pp->pm[l] + pen0, l, 0};
+      cand[nof_cand++] = (struct Candidate){pp->pm[l] + pen1, l, 1};
+    }
+  }
+
+  uint32_t nof_survivors = select_paths(pp, cand, nof_cand, pp->bit_pos);
+  for (uint32_t i = 0; i < nof_survivors; i++) {
+    memset(pp->est_bit[cand[i].path] + pp->bit_pos, cand[i].choice ? BIT_ONE : 0, stage_size);
+  }
+  pp->bit_pos += stage_size;
+}
+
+/*!
+ * Flips, one at a time, the bits in \a flip_pos of every path, from \a first to \a last - 1, of a node of size
+ * \a stage_size. Each round, every path forks into keeping and flipping the bit. If \a spc is true, the least reliable
+ * bit is flipped too, so that the parity is kept.
+ */
+static void flip_rounds(struct pSSCL_c_avx2* pp, uint16_t stage_size, uint32_t first, uint32_t last, bool spc)
+{
+  uint16_t bit_end = pp->bit_pos + stage_size;
+
+  for (uint32_t r = first; r < last; r++) {
+    struct Candidate cand[2 * MAX_LIST];
+    uint32_t         nof_cand = 0;
+    int32_t          max_pm   = INT32_MIN;
+    int32_t          min_flip = INT32_MAX;
+
+    for (uint8_t l = 0; l < pp->list_size; l++) {
+      if (pp->active[l]) {
+        int32_t pen = pp->flip_llr[l][r];
+        if (spc) {
+          pen += pp->spc_flipped[l] ? -pp->flip_llr[l][0] : pp->flip_llr[l][0];
+        }
+        cand[nof_cand++] = (struct Candidate){pp->pm[l], l, 0};
+        cand[nof_cand++] = (struct Candidate){pp->pm[l] + pen, l, 1};
+        max_pm           = SRSRAN_MAX(max_pm, pp->pm[l]);
+        min_flip         = SRSRAN_MIN(min_flip, pp->pm[l] + pen);
+      }
+    }
+
+    // The flip penalties do not decrease from one round to the next: if no flip makes it into a full list, the
+    // remaining rounds would not change the list either
+    if (nof_cand == 2 * pp->list_size && min_flip >= max_pm) {
+      break;
+    }
+
+    uint32_t nof_survivors = select_paths(pp, cand, nof_cand, bit_end);
+    for (uint32_t i = 0; i < nof_survivors; i++) {
+      uint8_t l = cand[i].path;
+      if (cand[i].choice) {
+        pp->est_bit[l][pp->bit_pos + pp->flip_pos[l][r]] ^= BIT_ONE;
+        if (spc) {
+          pp->est_bit[l][pp->bit_pos + pp->flip_pos[l][0]] ^= BIT_ONE;
+          pp->spc_flipped[l] = !pp->spc_flipped[l];
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * All bits below a ::RATE_1 node are information bits. Every path takes the hard decision and then forks on its
+ * \f$\min(L - 1, N_v)\f$ least reliable bits.
+ */
+static void rate_1_node(struct pSSCL_c_avx2* pp, uint8_t stage)
+{
+  uint16_t stage_size = pp->code_stage_size[stage];
+  uint32_t nof_flips  = SRSRAN_MIN(pp->list_size - 1, stage_size);
+
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (pp->active[l]) {
+      const int8_t* llr = path_llr(pp, l, stage);
+      srsran_vec_hard_bit_cc_avx2(llr, pp->est_bit[l] + pp->bit_pos, stage_size);
+      least_reliable(llr, stage_size, nof_flips, pp->flip_pos[l], pp->flip_llr[l]);
+    }
+  }
+
+  flip_rounds(pp, stage_size, 0, nof_flips, false);
+  pp->bit_pos += stage_size;
+}
+
+/*!
+ * The bits below an ::SPC node have even parity. Every path takes the hard decision, fixes the parity with the least
+ * reliable bit and then forks on the next \f$\min(L, N_v) - 1\f$ least reliable bits, flipping the least reliable one
+ * along to keep the parity.
+ */
+static void spc_node(struct pSSCL_c_avx2* pp, uint8_t stage)
+{
+  uint16_t stage_size = pp->code_stage_size[stage];
+  uint32_t nof_flips  = SRSRAN_MIN(pp->list_size, stage_size);
+
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (pp->active[l]) {
+      const int8_t* llr = path_llr(pp, l, stage);
+      uint8_t*      est = pp->est_bit[l] + pp->bit_pos;
+      srsran_vec_hard_bit_cc_avx2(llr, est, stage_size);
+      least_reliable(llr, stage_size, nof_flips, pp->flip_pos[l], pp->flip_llr[l]);
+
+      pp->spc_flipped[l] = hard_bit_parity(llr, stage_size) != 0;
+      if (pp->spc_flipped[l]) {
+        est[pp->flip_pos[l][0]] ^= BIT_ONE;
+        pp->pm[l] += pp->flip_llr[l][0];
+      }
+    }
+  }
+
+  flip_rounds(pp, stage_size, 1, nof_flips, true);
+  pp->bit_pos += stage_size;
+}
+
+/*!
+ * Computes \f$ z = x \oplus y \f$ for the partial sums of a node.
+ */
+static inline void xor_bits(const uint8_t* x, const uint8_t* y, uint8_t* z, uint16_t len)
+{
+  if (len >= SRSRAN_AVX2_B_SIZE) {
+    srsran_vec_xor_bbb_avx2(x, y, z, len);
+  } else {
+    for (uint16_t i = 0; i < len; i++) {
+      z[i] = x[i] ^ y[i];
+    }
+  }
+}
+
+/*!
+ * Switches between the different types of node. ::RATE_R nodes run function-f, the left child, function-g, the right
+ * child and the partial sums for every path in the list. Paths sharing the LLRs of the node share the output of
+ * function-f too.
+ */
+static void sscl_node(struct pSSCL_c_avx2* pp, uint8_t stage)
+{
+  uint16_t stage_size      = pp->code_stage_size[stage];
+  uint16_t stage_half_size = 0;
+  uint8_t  done_by[MAX_LIST];
+
+  switch (pp->node_type[stage][pp->bit_pos >> stage]) {
+    case RATE_0:
+      rate_0_node(pp, stage);
+      break;
+    case RATE_1:
+      rate_1_node(pp, stage);
+      break;
+    case REP:
+      rep_node(pp, stage);
+      break;
+    case SPC:
+      spc_node(pp, stage);
+      break;
+    case RATE_R:
+      stage_half_size = pp->code_stage_size[stage - 1];
+
+      memset(done_by, MAX_LIST, sizeof(done_by));
+      for (uint8_t l = 0; l < pp->list_size; l++) {
+        if (pp->active[l]) {
+          uint8_t idx = pp->llr_idx[l][stage];
+          if (done_by[idx] < MAX_LIST) {
+            path_llr_share(pp, l, done_by[idx], stage - 1);
+            continue;
+          }
+          const int8_t* llr = path_llr(pp, l, stage);
+          srsran_vec_function_f_ccc_avx2(llr, llr + stage_half_size, path_llr_write(pp, l, stage - 1), stage_half_size);
+          done_by[idx] = l;
+        }
+      }
+
+      // move to the child node to the left (up) of the tree.
+      sscl_node(pp, stage - 1);
+
+      for (uint8_t l = 0; l < pp->list_size; l++) {
+        if (pp->active[l]) {
+          const int8_t* llr = path_llr(pp, l, stage);
+          srsran_vec_function_g_bccc_avx2(pp->est_bit[l] + pp->bit_pos - stage_half_size,
+                                          llr,
+                                          llr + stage_half_size,
+                                          path_llr_write(pp, l, stage - 1),
+                                          stage_half_size);
+        }
+      }
+
+      // move to the child node to the right (down) of the tree.
+      sscl_node(pp, stage - 1);
+
+      for (uint8_t l = 0; l < pp->list_size; l++) {
+        if (pp->active[l]) {
+          uint8_t* estbits0 = pp->est_bit[l] + pp->bit_pos - stage_size;
+          xor_bits(estbits0, estbits0 + stage_half_size, estbits0, stage_half_size);
+        }
+      }
+      break;
+    default:
+      printf("ERROR: wrong node type %d\n", pp->node_type[stage][pp->bit_pos >> stage]);
+      exit(-1);
+  }
+}
+
+int polar_decoder_sscl_c_avx2(void* p, uint8_t** data_decoded, uint32_t nof_data)
+{
+  struct pSSCL_c_avx2* pp = p;
+
+  if (p == NULL || data_decoded == NULL) {
+    return -1;
+  }
+
+  sscl_node(pp, pp->code_size_log);
+
+  // Sort the surviving paths by path metric
+  uint8_t  order[MAX_LIST];
+  uint32_t nof_paths = 0;
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (pp->active[l]) {
+      uint32_t j = nof_paths++;
+      for (; j > 0 && pp->pm[order[j - 1]] > pp->pm[l]; j--) {
+        order[j] = order[j - 1];
+      }
+      order[j] = l;
+    }
+  }
+
+  nof_paths = SRSRAN_MIN(nof_paths, nof_data);
+  for (uint32_t i = 0; i < nof_paths; i++) {
+    // est_bit contains the coded bits. To obtain the message, we call the encoder
+    srsran_polar_encoder_encode(pp->enc, pp->est_bit[order[i]], data_decoded[i], pp->code_size_log);
+
+    // transform {0,-128} into {0, 1}
+    srsran_vec_sign_to_bit_c_avx2(data_decoded[i], pp->code_stage_size[pp->code_size_log]);
+  }
+
+  return (int)nof_paths;
+}
+
+#endif // LV_HAVE_AVX2
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_decoder_sscl_c_avx2.h
+ * \brief Declaration of the SSC List (SSCL) polar decoder inner functions working with
+ * 8-bit integer-valued LLRs and AVX2 instructions.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#ifndef POLAR_DECODER_SSCL_C_AVX2_H
+#define POLAR_DECODER_SSCL_C_AVX2_H
+
+#include "polar_decoder_ssc_all.h"
+
+/*!
+ * Creates an SSCL polar decoder structure of type pSSCL_c_avx2, and allocates memory for the decoding buffers.
+ *
+ * \param[in] nMax \f$log_2\f$ of the number of bits in the codeword.
+ * \param[in] list_size Number of paths kept by the decoder, from 2 to ::SRSRAN_POLAR_DECODER_MAX_LIST_SIZE.
+ * \return A pointer to a pSSCL_c_avx2 structure if the function executes correctly, NULL otherwise.
+ */
+void* create_polar_decoder_sscl_c_avx2(uint8_t nMax, uint8_t list_size);
+
+/*!
+ * The (8-bit, avx2) polar decoder SSCL "destructor": it frees all the resources allocated to the decoder.
+ *
+ * \param[in, out] p A pointer to the dismantled decoder.
+ */
+void delete_polar_decoder_sscl_c_avx2(void* p);
+
+/*!
+ * Initializes an (8-bit, avx2) SSCL polar decoder before processing a new codeword.
+ *
+ * \param[in, out] p A void pointer used to declare a pSSCL_c_avx2 structure.
+ * \param[in] llr LLRs for the new codeword.
+ * \param[in] code_size_log \f$log_2\f$ of the number of bits in the codeword.
+ * \param[in] frozen_set The position of the frozen bits in the codeword.
+ * \param[in] frozen_set_size Number of frozen bits.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int init_polar_decoder_sscl_c_avx2(void*           p,
+                                   const int8_t*   llr,
+                                   const uint8_t   code_size_log,
+                                   const uint16_t* frozen_set,
+                                   const uint16_t  frozen_set_size);
+
+/*!
+ * Decodes a codeword previously loaded by init_polar_decoder_sscl_c_avx2() and writes the surviving candidates,
+ * sorted by increasing path metric (the most likely first).
+ *
+ * \param[in] p A pointer to the desired decoder.
+ * \param[out] data Array of pointers to the decoded messages.
+ * \param[in] nof_data Number of pointers in \a data.
+ * \return The number of candidates written in \a data, -1 if the function fails.
+ */
+int polar_decoder_sscl_c_avx2(void* p, uint8_t** data, uint32_t nof_data);
+
+#endif // POLAR_DECODER_SSCL_C_AVX2_H
@@ -0,0 +1,294 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_sscl_test.c
+ * \brief Throughput and BLER of the CRC-aided SSC List (SSCL) polar decoders, compared with the SSC decoder.
+ *
+ * Random messages with CRC are allocated, encoded, rate-matched, 2-PAM modulated, sent over an AWGN channel,
+ * quantized to 8 bits, rate-dematched and decoded by every decoder. The message is the first candidate of the list
+ * that passes the CRC check. The CRC is CRC24C if nMax = 9 (downlink), CRC6 or CRC11 otherwise (uplink).
+ *
+ * Synopsis: **polar_sscl_test [options]**
+ *
+ * Options:
+ *
+ *  - <b>-n \<number\></b> nMax,  [Default 9] -- Use 9 for downlink, and 10 for uplink configuration.
+ *  - <b>-k \<number\></b> Message size (K),  [Default 64]. K includes the CRC bits.
+ *  - <b>-e \<number\></b> Rate matching size (E), [Default 128].
+ *  - <b>-i \<number\></b> Enable bit interleaver (bil),  [Default 0].
+ *  - <b>-s \<number\></b> SNR [dB, Default 1.00 dB] -- Use 101 for noiseless, all the messages must be decoded.
+ *  - <b>-R \<number\></b> Number of codewords [Default 1000].
+ *
+ * Example: PDCCH - ./polar_sscl_test -n9 -k64 -e216 -s-1 -R10000
+ *
+ */
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/polar/polar_chanalloc.h"
+#include "srsran/phy/fec/polar/polar_code.h"
+#include "srsran/phy/fec/polar/polar_decoder.h"
+#include "srsran/phy/fec/polar/polar_encoder.h"
+#include "srsran/phy/fec/polar/polar_rm.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static uint16_t K      = 64;  /*!< \brief Number of message bits (data and CRC). */
+static uint16_t E      = 128; /*!< \brief Number of bits of the codeword after rate matching. */
+static uint8_t  nMax   = 9;   /*!< \brief Maximum \f$log_2(N)\f$, where \f$N\f$ is the codeword size.*/
+static uint8_t  bil    = 0;   /*!< \brief If bil = 0 channel interleaver disabled. */
+static double   snr_db = 1;   /*!< \brief SNR in dB (101 for no noise). */
+static uint32_t nof_cw = 1000; /*!< \brief Number of simulated codewords. */
+
+/*!
+ * \brief Decoder under test and its results.
+ */
+typedef struct {
+  srsran_polar_decoder_type_t type;
+  const char*                 name;
+  srsran_polar_decoder_t      dec;
+  uint32_t                    nof_errors;     /*!< \brief Messages not decoded or decoded wrong. */
+  uint32_t                    nof_undetected; /*!< \brief Messages that pass the CRC but are wrong. */
+  double                      elapsed_us;     /*!< \brief Decoding time. */
+} decoder_test_t;
+
+static decoder_test_t decoders[] = {
+#ifdef LV_HAVE_AVX2
+    {.type = SRSRAN_POLAR_DECODER_SSC_C_AVX2, .name = "SSC  (avx2)"},
+    {.type = SRSRAN_POLAR_DECODER_SSCL2_C_AVX2, .name = "SSCL2 (avx2)"},
+    {.type = SRSRAN_POLAR_DECODER_SSCL4_C_AVX2, .name = "SSCL4 (avx2)"},
+    {.type = SRSRAN_POLAR_DECODER_SSCL8_C_AVX2, .name = "SSCL8 (avx2)"},
+#else
+    {.type = SRSRAN_POLAR_DECODER_SSC_C, .name = "SSC"},
+#endif // LV_HAVE_AVX2
+};
+
+#define NOF_DECODERS (sizeof(decoders) / sizeof(decoder_test_t))
+
+void usage(char* prog)
+{
+  printf("Usage: %s [-nX] [-kX] [-eX] [-iX] [-sX] [-RX]\n", prog);
+  printf("\t-n nMax [Default %d]\n", nMax);
+  printf("\t-k Message size, including CRC [Default %d]\n", K);
+  printf("\t-e Rate matching size [Default %d]\n", E);
+  printf("\t-i Bit interleaver indicator [Default %d]\n", bil);
+  printf("\t-s SNR [dB, Default %.2f dB] -- Use 101 for noiseless\n", snr_db);
+  printf("\t-R Number of codewords [Default %d]\n", nof_cw);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:k:e:i:s:R:")) != -1) {
+    switch (opt) {
+      case 'e':
+        E = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'k':
+        K = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'n':
+        nMax = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'i':
+        bil = (int)strtol(optarg, NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(optarg, NULL);
+        break;
+      case 'R':
+        nof_cw = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int                    ret = SRSRAN_ERROR;
+  srsran_polar_code_t    code;
+  srsran_polar_encoder_t enc;
+  srsran_polar_rm_t      rm_tx;
+  srsran_polar_rm_t      rm_rx;
+  srsran_crc_t           crc;
+  struct timeval         t[3];
+
+  parse_args(argc, argv);
+
+  uint32_t crc_len  = (nMax == 9) ? 24 : ((K <= 25) ? 6 : 11);
+  uint32_t crc_poly = (nMax == 9) ? SRSRAN_LTE_CRC24C : ((K <= 25) ? SRSRAN_LTE_CRC6 : SRSRAN_LTE_CRC11);
+  if (K <= crc_len) {
+    ERROR("The message size (%d) must be larger than the CRC (%d)", K, crc_len);
+    return SRSRAN_ERROR;
+  }
+
+  srsran_random_t random_gen = srsran_random_init(0);
+  uint8_t*        data_tx    = srsran_vec_u8_malloc(K);
+  uint8_t*        data_rx    = srsran_vec_u8_malloc(K);
+  uint8_t*        input_enc  = srsran_vec_u8_malloc(NMAX);
+  uint8_t*        output_enc = srsran_vec_u8_malloc(NMAX);
+  uint8_t*        codeword   = srsran_vec_u8_malloc(E);
+  float*          rm_llr     = srsran_vec_f_malloc(E);
+  int8_t*         rm_llr_c   = srsran_vec_i8_malloc(E);
+  int8_t*         llr_c      = srsran_vec_i8_malloc(NMAX);
+  uint8_t*        output_dec[SRSRAN_POLAR_DECODER_MAX_LIST_SIZE];
+  for (uint32_t i = 0; i < SRSRAN_POLAR_DECODER_MAX_LIST_SIZE; i++) {
+    output_dec[i] = srsran_vec_u8_malloc(NMAX);
+    if (output_dec[i] == NULL) {
+      perror("malloc");
+      exit(-1);
+    }
+  }
+  if (!data_tx || !data_rx || !input_enc || !output_enc || !codeword || !rm_llr || !rm_llr_c || !llr_c) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  if (srsran_polar_code_init(&code) || srsran_polar_code_get(&code, K, E, nMax) < SRSRAN_SUCCESS ||
+      srsran_polar_encoder_init(&enc, SRSRAN_POLAR_ENCODER_PIPELINED, nMax) || srsran_polar_rm_tx_init(&rm_tx) ||
+      srsran_polar_rm_rx_init_c(&rm_rx) || srsran_crc_init(&crc, crc_poly, crc_len)) {
+    ERROR("Error initialising the polar chain");
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t d = 0; d < NOF_DECODERS; d++) {
+    if (srsran_polar_decoder_init(&decoders[d].dec, decoders[d].type, nMax) < SRSRAN_SUCCESS) {
+      ERROR("Error initialising the %s decoder", decoders[d].name);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  printf("N=%d; K=%d (CRC%d); PC=%d; E=%d; SNR=%.1f dB; %d codewords\n",
+         code.N,
+         K,
+         crc_len,
+         code.nPC,
+         E,
+         snr_db,
+         nof_cw);
+
+  float var   = srsran_convert_dB_to_power(-snr_db);
+  float gain8 = (snr_db == 101) ? 32 : 127 * var / 20 / (1 / var + 2);
+
+  for (uint32_t cw = 0; cw < nof_cw; cw++) {
+    // random message with CRC
+    for (uint32_t j = 0; j < K - crc_len; j++) {
+      data_tx[j] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+    }
+    srsran_crc_attach(&crc, data_tx, K - crc_len);
+
+    srsran_polar_chanalloc_tx(data_tx, input_enc, code.N, code.K, code.nPC, code.K_set, code.PC_set);
+    srsran_polar_encoder_encode(&enc, input_enc, output_enc, code.n);
+    srsran_polar_rm_tx(&rm_tx, output_enc, codeword, code.n, E, K, bil);
+
+    for (uint32_t j = 0; j < E; j++) {
+      rm_llr[j] = codeword[j] ? -1 : 1;
+    }
+    if (snr_db != 101) {
+      srsran_ch_awgn_f(rm_llr, rm_llr, var, E);
+      srsran_vec_sc_prod_fff(rm_llr, 2 / (var * var), rm_llr, E);
+    }
+    srsran_vec_quant_fc(rm_llr, rm_llr_c, gain8, 0, 127, E);
+    srsran_polar_rm_rx_c(&rm_rx, rm_llr_c, llr_c, E, code.n, K, bil);
+
+    for (uint32_t d = 0; d < NOF_DECODERS; d++) {
+      decoder_test_t* test = &decoders[d];
+
+      gettimeofday(&t[1], NULL);
+      int nof_candidates =
+          srsran_polar_decoder_decode_list_c(&test->dec, llr_c, output_dec, code.n, code.F_set, code.F_set_size);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      test->elapsed_us += t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+      if (nof_candidates < 1 || nof_candidates > test->dec.list_size) {
+        ERROR("Wrong number of candidates (%d) from the %s decoder", nof_candidates, test->name);
+        goto clean_exit;
+      }
+
+      // CRC-aided selection
+      bool crc_ok = false;
+      for (int c = 0; c < nof_candidates && !crc_ok; c++) {
+        srsran_polar_chanalloc_rx(output_dec[c], data_rx, code.K, code.nPC, code.K_set, code.PC_set);
+        crc_ok = srsran_crc_match(&crc, data_rx, K - crc_len);
+      }
+
+      if (!crc_ok) {
+        test->nof_errors++;
+      } else if (memcmp(data_tx, data_rx, K) != 0) {
+        test->nof_errors++;
+        test->nof_undetected++;
+      }
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+  for (uint32_t d = 0; d < NOF_DECODERS; d++) {
+    decoder_test_t* test = &decoders[d];
+    printf("%-13s BLER=%.2e (%d/%d, %d undetected); %6.2f us/codeword; %7.2f Mbps\n",
+           test->name,
+           (double)test->nof_errors / nof_cw,
+           test->nof_errors,
+           nof_cw,
+           test->nof_undetected,
+           test->elapsed_us / nof_cw,
+           (double)K * nof_cw / test->elapsed_us);
+
+    // Without noise, all the messages must be decoded
+    if (snr_db == 101 && test->nof_errors != 0) {
+      ERROR("The %s decoder failed without noise", test->name);
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+clean_exit:
+  for (uint32_t d = 0; d < NOF_DECODERS; d++) {
+    srsran_polar_decoder_free(&decoders[d].dec);
+  }
+  for (uint32_t i = 0; i < SRSRAN_POLAR_DECODER_MAX_LIST_SIZE; i++) {
+    free(output_dec[i]);
+  }
+  free(data_tx);
+  free(data_rx);
+  free(input_enc);
+  free(output_enc);
+  free(codeword);
+  free(rm_llr);
+  free(rm_llr_c);
+  free(llr_c);
+  srsran_random_free(random_gen);
+  srsran_polar_code_free(&code);
+  srsran_polar_encoder_free(&enc);
+  srsran_polar_rm_tx_free(&rm_tx);
+  srsran_polar_rm_rx_free_c(&rm_rx);
+
+  return ret;
+}
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -33,6 +34,7 @@
 int      num_bits = 5001, crc_length = 24;
 uint32_t crc_poly = 0x1864CFB;
 uint32_t seed     = 1;
+uint32_t nof_reps = 0;
 
 void usage(char* prog)
 {
@@ -41,13 +43,14 @@ void usage(char* prog)
   printf("\t-l crc_length [Default %d]\n", crc_length);
   printf("\t-p crc_poly (Hex) [Default 0x%x]\n", crc_poly);
   printf("\t-s seed [Default 0=time]\n");
+  printf("\t-b nof_repetitions, measures the throughput of every CRC engine [Default %d]\n", nof_reps);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "nlpsv")) != -1) {
+  while ((opt = getopt(argc, argv, "nlpsbv")) != -1) {
     switch (opt) {
       case 'n':
         num_bits = (int)strtol(argv[optind], NULL, 10);
@@ -61,6 +64,9 @@ void parse_args(int argc, char** argv)
       case 's':
         seed = (uint32_t)strtoul(argv[optind], NULL, 0);
         break;
+      case 'b':
+        nof_reps = (uint32_t)strtoul(argv[optind], NULL, 0);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -71,6 +77,78 @@ void parse_args(int argc, char** argv)
   }
 }
 
+static const srsran_crc_impl_t impl_list[] = {SRSRAN_CRC_IMPL_TABLE, SRSRAN_CRC_IMPL_SLICE8, SRSRAN_CRC_IMPL_CLMUL};
+#define NOF_IMPL (sizeof(impl_list) / sizeof(impl_list[0]))
+
+// Checks every engine against the byte table for all the lengths up to num_bits, packed and unpacked
+static int test_impl(srsran_crc_t* crc_p, uint8_t* data, uint8_t* data_packed)
+{
+  for (uint32_t i = 1; i < NOF_IMPL; i++) {
+    if (srsran_crc_set_impl(crc_p, impl_list[i]) < SRSRAN_SUCCESS) {
+      printf("CRC engine %s is not available, skipping\n", srsran_crc_impl_string(impl_list[i]));
+      continue;
+    }
+
+    for (int len = 0; len <= num_bits; len++) {
+      srsran_crc_set_impl(crc_p, SRSRAN_CRC_IMPL_TABLE);
+      uint32_t gold = srsran_crc_checksum(crc_p, data, len);
+
+      srsran_crc_set_impl(crc_p, impl_list[i]);
+      uint32_t word = srsran_crc_checksum(crc_p, data, len);
+      if (word != gold) {
+        ERROR("%s: len=%d checksum=%x, expected %x", srsran_crc_impl_string(impl_list[i]), len, word, gold);
+        return SRSRAN_ERROR;
+      }
+
+      if (len % 8 == 0) {
+        word = srsran_crc_checksum_byte(crc_p, data_packed, len);
+        if (word != gold) {
+          ERROR("%s: len=%d byte checksum=%x, expected %x", srsran_crc_impl_string(impl_list[i]), len, word, gold);
+          return SRSRAN_ERROR;
+        }
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void benchmark_impl(srsran_crc_t* crc_p, uint8_t* data, uint8_t* data_packed)
+{
+  struct timeval t[3];
+  int            nof_bits_byte = num_bits - num_bits % 8;
+
+  for (uint32_t i = 0; i < NOF_IMPL; i++) {
+    if (srsran_crc_set_impl(crc_p, impl_list[i]) < SRSRAN_SUCCESS) {
+      continue;
+    }
+
+    uint32_t acc = 0;
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < nof_reps; r++) {
+      acc ^= srsran_crc_checksum(crc_p, data, num_bits);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    double usec_bit = (double)t[0].tv_sec * 1e6 + (double)t[0].tv_usec;
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < nof_reps; r++) {
+      acc ^= srsran_crc_checksum_byte(crc_p, data_packed, nof_bits_byte);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    double usec_byte = (double)t[0].tv_sec * 1e6 + (double)t[0].tv_usec;
+
+    printf("CRC%d %-7s unpacked: %8.1f Mbps; packed: %8.1f Mbps (%x)\n",
+           crc_length,
+           srsran_crc_impl_string(impl_list[i]),
+           (double)num_bits * nof_reps / SRSRAN_MAX(usec_bit, 1.0),
+           (double)nof_bits_byte * nof_reps / SRSRAN_MAX(usec_byte, 1.0),
+           acc);
+  }
+}
+
 int main(int argc, char** argv)
 {
   int          i;
@@ -80,8 +158,9 @@ int main(int argc, char** argv)
 
   parse_args(argc, argv);
 
-  data = srsran_vec_u8_malloc(num_bits + crc_length * 2);
-  if (!data) {
+  data                 = srsran_vec_u8_malloc(num_bits + crc_length * 2);
+  uint8_t* data_packed = srsran_vec_u8_malloc(num_bits / 8 + crc_length);
+  if (!data || !data_packed) {
     perror("malloc");
     exit(-1);
   }
@@ -111,7 +190,18 @@ int main(int argc, char** argv)
 
   INFO("checksum=%x", crc_word);
 
+  // All the engines must match the byte table
+  srsran_bit_pack_vector(data, data_packed, num_bits - num_bits % 8);
+  if (test_impl(&crc_p, data, data_packed) < SRSRAN_SUCCESS) {
+    exit(-1);
+  }
+
+  if (nof_reps > 0) {
+    benchmark_impl(&crc_p, data, data_packed);
+  }
+
   free(data);
+  free(data_packed);
 
   // check if generated word is as expected
   if (get_expected_word(num_bits, crc_length, crc_poly, seed, &expected_word)) {
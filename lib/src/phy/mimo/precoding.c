@@ -1857,6 +1857,507 @@ static int srsran_predecoding_multiplex(cf_t*  y[SRSRAN_MAX_PORTS],
   return SRSRAN_ERROR;
 }
 
+/* Equaliser for up to 4 layers received with up to 4 antennas, h[layer][rxant] holds the effective channel of every
+ * layer (precoding included). Every RE solves (H' x H + No) x = H' x y through the LDL' decomposition of H' x H + No,
+ * which is Hermitian and positive definite, so it needs no pivoting and only the reciprocals of the diagonal D. The
+ * noise term is left out for ZF. The post-equalisation SINR of layer k is 1 / (No * inv(A)[k][k]), minus 1 for MMSE.
+ */
+#define PREDECODING_MIMO_MIN_NOISE 1e-9f
+
+static void predecoding_mimo_ldl_gen(cf_t     h[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                                     uint32_t nof_layers,
+                                     uint32_t nof_rxant,
+                                     float    noise_estimate,
+                                     cf_t     l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS],
+                                     float    dinv[SRSRAN_MAX_LAYERS])
+{
+  float d[SRSRAN_MAX_LAYERS];
+
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    d[j] = noise_estimate;
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      d[j] += crealf(h[j][r]) * crealf(h[j][r]) + cimagf(h[j][r]) * cimagf(h[j][r]);
+    }
+    for (uint32_t k = 0; k < j; k++) {
+      d[j] -= (crealf(l[j][k]) * crealf(l[j][k]) + cimagf(l[j][k]) * cimagf(l[j][k])) * d[k];
+    }
+    dinv[j] = 1.0f / d[j];
+
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      cf_t a = 0.0f;
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        a += h[j][r] * conjf(h[i][r]);
+      }
+      for (uint32_t k = 0; k < j; k++) {
+        a -= l[i][k] * conjf(l[j][k]) * d[k];
+      }
+      l[i][j] = a * dinv[j];
+    }
+  }
+}
+
+static void predecoding_mimo_solve_gen(cf_t     l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS],
+                                       float    dinv[SRSRAN_MAX_LAYERS],
+                                       uint32_t nof_layers,
+                                       cf_t     z[SRSRAN_MAX_LAYERS],
+                                       float    norm,
+                                       cf_t     x[SRSRAN_MAX_LAYERS])
+{
+  cf_t u[SRSRAN_MAX_LAYERS];
+
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    u[i] = z[i];
+    for (uint32_t k = 0; k < i; k++) {
+      u[i] -= l[i][k] * u[k];
+    }
+  }
+
+  for (int i = (int)nof_layers - 1; i >= 0; i--) {
+    x[i] = u[i] * (dinv[i] * norm);
+    for (uint32_t k = i + 1; k < nof_layers; k++) {
+      x[i] -= x[k] * conjf(l[k][i]);
+    }
+  }
+}
+
+static void predecoding_mimo_sinr_gen(cf_t     l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS],
+                                      float    dinv[SRSRAN_MAX_LAYERS],
+                                      uint32_t nof_layers,
+                                      float    noise_estimate,
+                                      bool     mmse,
+                                      float    sinr[SRSRAN_MAX_LAYERS])
+{
+  for (uint32_t k = 0; k < nof_layers; k++) {
+    // Column k of inv(L) gives the diagonal of inv(A) = inv(L)' x inv(D) x inv(L)
+    cf_t  m[SRSRAN_MAX_LAYERS];
+    float b = dinv[k];
+    for (uint32_t i = k + 1; i < nof_layers; i++) {
+      m[i] = -l[i][k];
+      for (uint32_t p = k + 1; p < i; p++) {
+        m[i] -= l[i][p] * m[p];
+      }
+      b += (crealf(m[i]) * crealf(m[i]) + cimagf(m[i]) * cimagf(m[i])) * dinv[i];
+    }
+    sinr[k] = 1.0f / (b * noise_estimate) - (mmse ? 1.0f : 0.0f);
+  }
+}
+
+static void predecoding_mimo_gen(cf_t*    y[SRSRAN_MAX_PORTS],
+                                 cf_t*    h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                 cf_t*    x[SRSRAN_MAX_LAYERS],
+                                 float*   sinr[SRSRAN_MAX_LAYERS],
+                                 uint32_t nof_layers,
+                                 uint32_t nof_rxant,
+                                 int      i,
+                                 int      nof_symbols,
+                                 float    norm,
+                                 float    noise_estimate,
+                                 bool     mmse)
+{
+  for (; i < nof_symbols; i++) {
+    cf_t  hh[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS];
+    cf_t  l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS];
+    float dinv[SRSRAN_MAX_LAYERS];
+    cf_t  z[SRSRAN_MAX_LAYERS];
+    cf_t  xx[SRSRAN_MAX_LAYERS];
+
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      z[j] = 0.0f;
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        hh[j][r] = h[j][r][i];
+        z[j] += y[r][i] * conjf(hh[j][r]);
+      }
+    }
+
+    predecoding_mimo_ldl_gen(hh, nof_layers, nof_rxant, mmse ? noise_estimate : 0.0f, l, dinv);
+    predecoding_mimo_solve_gen(l, dinv, nof_layers, z, norm, xx);
+
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      x[j][i] = xx[j];
+    }
+
+    if (sinr) {
+      float s[SRSRAN_MAX_LAYERS];
+      predecoding_mimo_sinr_gen(l, dinv, nof_layers, noise_estimate, mmse, s);
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        sinr[j][i] = s[j];
+      }
+    }
+  }
+}
+
+static void predecoding_mimo_weights_gen(cf_t*    h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                         cf_t*    w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                                         float*   sinr[SRSRAN_MAX_LAYERS],
+                                         uint32_t nof_layers,
+                                         uint32_t nof_rxant,
+                                         int      i,
+                                         int      nof_symbols,
+                                         float    norm,
+                                         float    noise_estimate,
+                                         bool     mmse)
+{
+  for (; i < nof_symbols; i++) {
+    cf_t  hh[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS];
+    cf_t  l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS];
+    float dinv[SRSRAN_MAX_LAYERS];
+    cf_t  z[SRSRAN_MAX_LAYERS];
+    cf_t  ww[SRSRAN_MAX_LAYERS];
+
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        hh[j][r] = h[j][r][i];
+      }
+    }
+
+    predecoding_mimo_ldl_gen(hh, nof_layers, nof_rxant, mmse ? noise_estimate : 0.0f, l, dinv);
+
+    // Column r of W = inv(A) x H' is the solution for y = e_r
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        z[j] = conjf(hh[j][r]);
+      }
+      predecoding_mimo_solve_gen(l, dinv, nof_layers, z, norm, ww);
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        w[j][r][i] = ww[j];
+      }
+    }
+
+    if (sinr) {
+      float s[SRSRAN_MAX_LAYERS];
+      predecoding_mimo_sinr_gen(l, dinv, nof_layers, noise_estimate, mmse, s);
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        sinr[j][i] = s[j];
+      }
+    }
+  }
+}
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+
+/* The plain SIMD reciprocal is not accurate enough to chain up to 4 pivots, refine it with a Newton-Raphson step */
+static inline simd_f_t predecoding_mimo_rcp_simd(simd_f_t a)
+{
+  simd_f_t r = srsran_simd_f_rcp(a);
+  return srsran_simd_f_mul(r, srsran_simd_f_sub(srsran_simd_f_set1(2.0f), srsran_simd_f_mul(a, r)));
+}
+
+static inline __attribute__((always_inline)) void
+predecoding_mimo_ldl_simd(simd_cf_t h[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                          uint32_t  nof_layers,
+                          uint32_t  nof_rxant,
+                          float     noise_estimate,
+                          simd_cf_t l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS],
+                          simd_f_t  dinv[SRSRAN_MAX_LAYERS])
+{
+  simd_f_t d[SRSRAN_MAX_LAYERS];
+
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    simd_cf_t a = srsran_simd_cf_zero();
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      a = srsran_simd_cf_add(a, srsran_simd_cf_conjprod(h[j][r], h[j][r]));
+    }
+    d[j] = srsran_simd_f_add(srsran_simd_cf_re(a), srsran_simd_f_set1(noise_estimate));
+    for (uint32_t k = 0; k < j; k++) {
+      simd_f_t l2 = srsran_simd_cf_re(srsran_simd_cf_conjprod(l[j][k], l[j][k]));
+      d[j]        = srsran_simd_f_sub(d[j], srsran_simd_f_mul(l2, d[k]));
+    }
+    dinv[j] = predecoding_mimo_rcp_simd(d[j]);
+
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      a = srsran_simd_cf_zero();
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        a = srsran_simd_cf_add(a, srsran_simd_cf_conjprod(h[j][r], h[i][r]));
+      }
+      for (uint32_t k = 0; k < j; k++) {
+        a = srsran_simd_cf_sub(a, srsran_simd_cf_mul(srsran_simd_cf_conjprod(l[i][k], l[j][k]), d[k]));
+      }
+      l[i][j] = srsran_simd_cf_mul(a, dinv[j]);
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void
+predecoding_mimo_solve_simd(simd_cf_t l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS],
+                            simd_f_t  dinv[SRSRAN_MAX_LAYERS],
+                            uint32_t  nof_layers,
+                            simd_cf_t z[SRSRAN_MAX_LAYERS],
+                            float     norm,
+                            simd_cf_t x[SRSRAN_MAX_LAYERS])
+{
+  simd_cf_t u[SRSRAN_MAX_LAYERS];
+
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    u[i] = z[i];
+    for (uint32_t k = 0; k < i; k++) {
+      u[i] = srsran_simd_cf_sub(u[i], srsran_simd_cf_prod(l[i][k], u[k]));
+    }
+  }
+
+  for (int i = (int)nof_layers - 1; i >= 0; i--) {
+    x[i] = srsran_simd_cf_mul(u[i], srsran_simd_f_mul(dinv[i], srsran_simd_f_set1(norm)));
+    for (uint32_t k = i + 1; k < nof_layers; k++) {
+      x[i] = srsran_simd_cf_sub(x[i], srsran_simd_cf_conjprod(x[k], l[k][i]));
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void
+predecoding_mimo_sinr_simd(simd_cf_t l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS],
+                           simd_f_t  dinv[SRSRAN_MAX_LAYERS],
+                           uint32_t  nof_layers,
+                           float     noise_estimate,
+                           bool      mmse,
+                           simd_f_t  sinr[SRSRAN_MAX_LAYERS])
+{
+  for (uint32_t k = 0; k < nof_layers; k++) {
+    simd_cf_t m[SRSRAN_MAX_LAYERS];
+    simd_f_t  b = dinv[k];
+    for (uint32_t i = k + 1; i < nof_layers; i++) {
+      m[i] = srsran_simd_cf_neg(l[i][k]);
+      for (uint32_t p = k + 1; p < i; p++) {
+        m[i] = srsran_simd_cf_sub(m[i], srsran_simd_cf_prod(l[i][p], m[p]));
+      }
+      b = srsran_simd_f_add(b, srsran_simd_f_mul(srsran_simd_cf_re(srsran_simd_cf_conjprod(m[i], m[i])), dinv[i]));
+    }
+    sinr[k] = predecoding_mimo_rcp_simd(srsran_simd_f_mul(b, srsran_simd_f_set1(noise_estimate)));
+    if (mmse) {
+      sinr[k] = srsran_simd_f_sub(sinr[k], srsran_simd_f_set1(1.0f));
+    }
+  }
+}
+
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+/* Inlined with constant dimensions for every supported combination, so the compiler unrolls the loops and keeps the
+ * matrices in registers */
+static inline __attribute__((always_inline)) void predecoding_mimo_nxn(cf_t*    y[SRSRAN_MAX_PORTS],
+                                                                       cf_t*    h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                                                       cf_t*    x[SRSRAN_MAX_LAYERS],
+                                                                       float*   sinr[SRSRAN_MAX_LAYERS],
+                                                                       uint32_t nof_layers,
+                                                                       uint32_t nof_rxant,
+                                                                       int      nof_symbols,
+                                                                       float    norm,
+                                                                       float    noise_estimate,
+                                                                       bool     mmse)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+  for (; i < nof_symbols - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t hh[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS];
+    simd_cf_t l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS];
+    simd_f_t  dinv[SRSRAN_MAX_LAYERS];
+    simd_cf_t z[SRSRAN_MAX_LAYERS];
+    simd_cf_t xx[SRSRAN_MAX_LAYERS];
+    simd_cf_t yy[SRSRAN_MAX_PORTS];
+
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      yy[r] = srsran_simd_cfi_load(&y[r][i]);
+    }
+
+    /* 1. Z = H' x Y */
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      z[j] = srsran_simd_cf_zero();
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        hh[j][r] = srsran_simd_cfi_load(&h[j][r][i]);
+        z[j]     = srsran_simd_cf_add(z[j], srsran_simd_cf_conjprod(yy[r], hh[j][r]));
+      }
+    }
+
+    /* 2. A = H' x H + No = L x D x L' */
+    predecoding_mimo_ldl_simd(hh, nof_layers, nof_rxant, mmse ? noise_estimate : 0.0f, l, dinv);
+
+    /* 3. X = inv(A) x Z */
+    predecoding_mimo_solve_simd(l, dinv, nof_layers, z, norm, xx);
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      srsran_simd_cfi_store(&x[j][i], xx[j]);
+    }
+
+    /* 4. Extract SINR */
+    if (sinr) {
+      simd_f_t s[SRSRAN_MAX_LAYERS];
+      predecoding_mimo_sinr_simd(l, dinv, nof_layers, noise_estimate, mmse, s);
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        srsran_simd_f_store(&sinr[j][i], s[j]);
+      }
+    }
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+  predecoding_mimo_gen(y, h, x, sinr, nof_layers, nof_rxant, i, nof_symbols, norm, noise_estimate, mmse);
+}
+
+static inline __attribute__((always_inline)) void
+predecoding_mimo_weights_nxn(cf_t*    h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                             cf_t*    w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                             float*   sinr[SRSRAN_MAX_LAYERS],
+                             uint32_t nof_layers,
+                             uint32_t nof_rxant,
+                             int      nof_symbols,
+                             float    norm,
+                             float    noise_estimate,
+                             bool     mmse)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+  for (; i < nof_symbols - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t hh[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS];
+    simd_cf_t l[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS];
+    simd_f_t  dinv[SRSRAN_MAX_LAYERS];
+    simd_cf_t z[SRSRAN_MAX_LAYERS];
+    simd_cf_t ww[SRSRAN_MAX_LAYERS];
+
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        hh[j][r] = srsran_simd_cfi_load(&h[j][r][i]);
+      }
+    }
+
+    predecoding_mimo_ldl_simd(hh, nof_layers, nof_rxant, mmse ? noise_estimate : 0.0f, l, dinv);
+
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        z[j] = srsran_simd_cf_conj(hh[j][r]);
+      }
+      predecoding_mimo_solve_simd(l, dinv, nof_layers, z, norm, ww);
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        srsran_simd_cfi_store(&w[j][r][i], ww[j]);
+      }
+    }
+
+    if (sinr) {
+      simd_f_t s[SRSRAN_MAX_LAYERS];
+      predecoding_mimo_sinr_simd(l, dinv, nof_layers, noise_estimate, mmse, s);
+      for (uint32_t j = 0; j < nof_layers; j++) {
+        srsran_simd_f_store(&sinr[j][i], s[j]);
+      }
+    }
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+  predecoding_mimo_weights_gen(h, w, sinr, nof_layers, nof_rxant, i, nof_symbols, norm, noise_estimate, mmse);
+}
+
+static int predecoding_mimo_check(int nof_rxant, int nof_layers)
+{
+  if (nof_layers < 1 || nof_layers > SRSRAN_MAX_LAYERS || nof_rxant < nof_layers || nof_rxant > SRSRAN_MAX_PORTS) {
+    ERROR("Invalid MIMO equaliser dimensions: nof_layers=%d, nof_rxant=%d", nof_layers, nof_rxant);
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+#define PREDECODING_MIMO_CASE(L, R, FUNC, ...)                                                                         \
+  case (L)*8 + (R):                                                                                                    \
+    FUNC(__VA_ARGS__, L, R, nof_symbols, norm, noise_estimate, mmse);                                                  \
+    break
+
+#define PREDECODING_MIMO_SWITCH(FUNC, ...)                                                                             \
+  switch (nof_layers * 8 + nof_rxant) {                                                                                \
+    PREDECODING_MIMO_CASE(1, 1, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(1, 2, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(1, 3, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(1, 4, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(2, 2, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(2, 3, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(2, 4, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(3, 3, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(3, 4, FUNC, __VA_ARGS__);                                                                    \
+    PREDECODING_MIMO_CASE(4, 4, FUNC, __VA_ARGS__);                                                                    \
+    default:                                                                                                           \
+      return SRSRAN_ERROR;                                                                                             \
+  }
+
+int srsran_predecoding_mimo(cf_t*  y[SRSRAN_MAX_PORTS],
+                            cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                            cf_t*  x[SRSRAN_MAX_LAYERS],
+                            float* sinr[SRSRAN_MAX_LAYERS],
+                            int    nof_rxant,
+                            int    nof_layers,
+                            int    nof_symbols,
+                            float  scaling,
+                            float  noise_estimate)
+{
+  if (predecoding_mimo_check(nof_rxant, nof_layers) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  bool  mmse     = (mimo_decoder == SRSRAN_MIMO_DECODER_MMSE);
+  float norm     = 1.0f / scaling;
+  noise_estimate = SRSRAN_MAX(noise_estimate, PREDECODING_MIMO_MIN_NOISE);
+
+  PREDECODING_MIMO_SWITCH(predecoding_mimo_nxn, y, h, x, sinr);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_predecoding_mimo_weights(cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                    cf_t*  w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                                    float* sinr[SRSRAN_MAX_LAYERS],
+                                    int    nof_rxant,
+                                    int    nof_layers,
+                                    int    nof_symbols,
+                                    float  scaling,
+                                    float  noise_estimate)
+{
+  if (predecoding_mimo_check(nof_rxant, nof_layers) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  bool  mmse     = (mimo_decoder == SRSRAN_MIMO_DECODER_MMSE);
+  float norm     = 1.0f / scaling;
+  noise_estimate = SRSRAN_MAX(noise_estimate, PREDECODING_MIMO_MIN_NOISE);
+
+  PREDECODING_MIMO_SWITCH(predecoding_mimo_weights_nxn, h, w, sinr);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_predecoding_mimo_apply(cf_t* y[SRSRAN_MAX_PORTS],
+                                  cf_t* w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS],
+                                  cf_t* x[SRSRAN_MAX_LAYERS],
+                                  int   nof_rxant,
+                                  int   nof_layers,
+                                  int   nof_symbols)
+{
+  if (predecoding_mimo_check(nof_rxant, nof_layers) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  int i = 0;
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+  for (; i < nof_symbols - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t yy[SRSRAN_MAX_PORTS];
+    for (int r = 0; r < nof_rxant; r++) {
+      yy[r] = srsran_simd_cfi_load(&y[r][i]);
+    }
+    for (int j = 0; j < nof_layers; j++) {
+      simd_cf_t xx = srsran_simd_cf_zero();
+      for (int r = 0; r < nof_rxant; r++) {
+        xx = srsran_simd_cf_add(xx, srsran_simd_cf_prod(srsran_simd_cfi_load(&w[j][r][i]), yy[r]));
+      }
+      srsran_simd_cfi_store(&x[j][i], xx);
+    }
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    for (int j = 0; j < nof_layers; j++) {
+      cf_t xx = 0.0f;
+      for (int r = 0; r < nof_rxant; r++) {
+        xx += w[j][r][i] * y[r][i];
+      }
+      x[j][i] = xx;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_predecoding_set_mimo_decoder(srsran_mimo_decoder_t _mimo_decoder)
 {
   mimo_decoder = _mimo_decoder;
@@ -41,6 +41,8 @@ char*                  mimo_type_name        = NULL;
 char                   decoder_type_name[17] = "zf";
 float                  snr_db                = 100.0f;
 float                  scaling               = 0.1f;
+bool                   effective_channel     = false;
+int                    nof_iterations        = 1;
 static srsran_random_t random_gen            = NULL;
 
 void usage(char* prog)
@@ -57,6 +59,9 @@ void usage(char* prog)
   printf("\t-s SNR in dB [Default %.1fdB]*\n", snr_db);
   printf("\t-g Scaling [Default %.1f]*\n", scaling);
   printf("\t-d decoder type [zf|mmse] [Default %s]\n", decoder_type_name);
+  printf("\t-x map the layers straight onto the ports and equalise the effective channel [Default %s]\n",
+         effective_channel ? "true" : "false");
+  printf("\t-i number of equaliser iterations for benchmarking [Default %d]\n", nof_iterations);
   printf("\n");
   printf("* Performance test example:\n\t for snr in {0..20..1}; do ./precoding_test -m single -s $snr; done; \n\n");
 }
@@ -64,7 +69,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "mplnrcdsg")) != -1) {
+  while ((opt = getopt(argc, argv, "mplnrcdsgxi")) != -1) {
     switch (opt) {
       case 'n':
         nof_symbols = (int)strtol(argv[optind], NULL, 10);
@@ -94,12 +99,18 @@ void parse_args(int argc, char** argv)
       case 'g':
         scaling = strtof(argv[optind], NULL);
         break;
+      case 'x':
+        effective_channel = true;
+        break;
+      case 'i':
+        nof_iterations = (int)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
     }
   }
-  if (!mimo_type_name) {
+  if (!mimo_type_name && !effective_channel) {
     usage(argv[0]);
     exit(-1);
   }
@@ -176,6 +187,9 @@ int main(int argc, char** argv)
   float mse;
   cf_t *x[SRSRAN_MAX_LAYERS], *r[SRSRAN_MAX_PORTS], *y[SRSRAN_MAX_PORTS], *h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
       *xr[SRSRAN_MAX_LAYERS];
+  cf_t*              w[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS] = {};
+  cf_t*              xw[SRSRAN_MAX_LAYERS]                  = {};
+  float*             sinr[SRSRAN_MAX_LAYERS]                = {};
   srsran_tx_scheme_t type;
 
   parse_args(argc, argv);
@@ -186,8 +200,11 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
-  /* Parse MIMO Type */
-  if (srsran_str2mimotype(mimo_type_name, &type)) {
+  /* Parse MIMO Type, the effective channel has one port per layer */
+  if (effective_channel) {
+    type         = SRSRAN_TXSCHEME_SPATIALMUX;
+    nof_tx_ports = nof_layers;
+  } else if (srsran_str2mimotype(mimo_type_name, &type)) {
     ERROR("Invalid MIMO type %s", mimo_type_name);
     exit(-1);
   }
@@ -226,6 +243,23 @@ int main(int argc, char** argv)
       perror("srsran_vec_malloc");
       exit(-1);
     }
+
+    /* Equaliser weights, sink data from the weights and SINR */
+    if (effective_channel) {
+      xw[i]   = srsran_vec_cf_malloc(nof_symbols);
+      sinr[i] = srsran_vec_f_malloc(nof_symbols);
+      if (!xw[i] || !sinr[i]) {
+        perror("srsran_vec_malloc");
+        exit(-1);
+      }
+      for (j = 0; j < nof_rx_ports; j++) {
+        w[i][j] = srsran_vec_cf_malloc(nof_symbols);
+        if (!w[i][j]) {
+          perror("srsran_vec_malloc");
+          exit(-1);
+        }
+      }
+    }
   }
 
   /* Allocate y in memory for tx each port */
@@ -267,7 +301,11 @@ int main(int argc, char** argv)
   }
 
   /* Execute Precoding (Tx) */
-  if (srsran_precoding_type(x, y, nof_layers, nof_tx_ports, codebook_idx, nof_symbols, scaling, type) < 0) {
+  if (effective_channel) {
+    for (i = 0; i < nof_layers; i++) {
+      srsran_vec_sc_prod_cfc(x[i], scaling, y[i], nof_symbols);
+    }
+  } else if (srsran_precoding_type(x, y, nof_layers, nof_tx_ports, codebook_idx, nof_symbols, scaling, type) < 0) {
     ERROR("Error layer mapper encoder");
     exit(-1);
   }
@@ -301,20 +339,50 @@ int main(int argc, char** argv)
   /* predecoding / equalization */
   struct timeval t[3];
   gettimeofday(&t[1], NULL);
-  srsran_predecoding_type(r,
-                          h,
-                          xr,
-                          NULL,
-                          nof_rx_ports,
-                          nof_tx_ports,
-                          nof_layers,
-                          codebook_idx,
-                          nof_re,
-                          type,
-                          scaling,
-                          srsran_convert_dB_to_power(-snr_db));
+  for (int n = 0; n < nof_iterations; n++) {
+    if (effective_channel) {
+      srsran_predecoding_mimo(
+          r, h, xr, sinr, nof_rx_ports, nof_layers, nof_re, scaling, srsran_convert_dB_to_power(-snr_db));
+    } else {
+      srsran_predecoding_type(r,
+                              h,
+                              xr,
+                              NULL,
+                              nof_rx_ports,
+                              nof_tx_ports,
+                              nof_layers,
+                              codebook_idx,
+                              nof_re,
+                              type,
+                              scaling,
+                              srsran_convert_dB_to_power(-snr_db));
+    }
+  }
   gettimeofday(&t[2], NULL);
   get_time_interval(t);
+  float exec_time_us = (float)(t[0].tv_sec * 1000000L + t[0].tv_usec);
+
+  /* The weights applied separately must give the same result */
+  if (effective_channel) {
+    srsran_predecoding_mimo_weights(
+        h, w, NULL, nof_rx_ports, nof_layers, nof_re, scaling, srsran_convert_dB_to_power(-snr_db));
+    srsran_predecoding_mimo_apply(r, w, xw, nof_rx_ports, nof_layers, nof_re);
+
+    float mse_w = 0;
+    for (i = 0; i < nof_layers; i++) {
+      for (j = 0; j < nof_symbols; j++) {
+        mse_w += cabsf(xw[i][j] - xr[i][j]);
+        if (!isfinite(sinr[i][j]) || sinr[i][j] < 0.0f) {
+          ERROR("Invalid SINR %f for layer %d and RE %d", sinr[i][j], i, j);
+          ret = SRSRAN_ERROR;
+        }
+      }
+    }
+    if (mse_w / nof_layers / nof_symbols > MSE_THRESHOLD) {
+      ERROR("Weights and equaliser mismatch, MSE=%f", mse_w / nof_layers / nof_symbols);
+      ret = SRSRAN_ERROR;
+    }
+  }
 
   /* check errors */
   mse = 0;
@@ -330,9 +398,10 @@ int main(int argc, char** argv)
       }
     }
   }
-  printf("SNR: %5.1fdB;\tExecution time: %5ldus;\tMSE: %.6f;\tBER: %.6f\n",
+  printf("SNR: %5.1fdB;\tExecution time: %5.0fus (%.1f MRE/s);\tMSE: %.6f;\tBER: %.6f\n",
          snr_db,
-         t[0].tv_usec,
+         exec_time_us,
+         (float)nof_re * nof_iterations / exec_time_us,
          mse / nof_layers / nof_symbols,
          (float)nof_errors / (4.0f * nof_re));
   if (mse / nof_layers / nof_symbols > MSE_THRESHOLD) {
@@ -346,6 +415,17 @@ quit:
   for (i = 0; i < nof_layers; i++) {
     free(x[i]);
     free(xr[i]);
+    if (xw[i]) {
+      free(xw[i]);
+    }
+    if (sinr[i]) {
+      free(sinr[i]);
+    }
+    for (j = 0; j < nof_rx_ports; j++) {
+      if (w[i][j]) {
+        free(w[i][j]);
+      }
+    }
   }
 
   for (i = 0; i < nof_rx_ports; i++) {
@@ -20,12 +20,15 @@
  */
 
 #include <complex.h>
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 
 #include "srsran/phy/modem/demod_soft.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 
 #ifdef HAVE_NEONv8
@@ -799,47 +802,225 @@ void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
   }
 }
 
+/*
+ * 256QAM fixed point demodulation. Every level is computed in float straight from the received symbols, with the scale
+ * folded into the gain and the offsets, then rounded and saturated to the symmetric range of the output type in the
+ * same pass.
+ */
+static const float demod_256qam_offset[3] = {0.6135719911f, 0.3067859955f, 0.1533929978f}; // {8, 4, 2}/sqrt(170)
+
+static inline float demod_256qam_saturate(float llr, float max)
+{
+  llr = rintf(llr);
+  return (llr > max) ? max : ((llr < -max) ? -max : llr);
+}
+
+/* The 8 LLRs of a symbol, in the order real and imaginary of every level */
+static inline void demod_256qam_symbol(const cf_t* symbol, float scale, float max, float* llr)
+{
+  float real = -__real__ symbol[0] * scale;
+  float imag = -__imag__ symbol[0] * scale;
+  for (uint32_t m = 0; m < 4; m++) {
+    if (m > 0) {
+      real = fabsf(real) - demod_256qam_offset[m - 1] * scale;
+      imag = fabsf(imag) - demod_256qam_offset[m - 1] * scale;
+    }
+    llr[2 * m]     = demod_256qam_saturate(real, max);
+    llr[2 * m + 1] = demod_256qam_saturate(imag, max);
+  }
+}
+
+#if SRSRAN_SIMD_F_SIZE && defined(LV_HAVE_SSE)
+#define DEMOD_256QAM_SIMD
+
+typedef struct {
+  simd_f_t gain;
+  simd_f_t offset[3];
+  simd_f_t min;
+  simd_f_t max;
+} demod_256qam_simd_t;
+
+static void demod_256qam_simd_init(demod_256qam_simd_t* q, float scale, float max)
+{
+  // Only the first level is clamped. The bound is large enough for the following levels to saturate as well and
+  // small enough for the conversion to 32-bit integers
+  float bound = max;
+  for (uint32_t m = 0; m < 3; m++) {
+    q->offset[m] = srsran_simd_f_set1(demod_256qam_offset[m] * scale);
+    bound += demod_256qam_offset[m] * scale;
+  }
+  q->gain = srsran_simd_f_set1(-scale);
+  q->max  = srsran_simd_f_set1(bound);
+  q->min  = srsran_simd_f_set1(-bound);
+}
+
+static inline simd_f_t demod_256qam_simd_clamp(simd_f_t a, simd_f_t min, simd_f_t max)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_max_ps(_mm512_min_ps(a, max), min);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_max_ps(_mm256_min_ps(a, max), min);
+#else /* LV_HAVE_AVX2 */
+  return _mm_max_ps(_mm_min_ps(a, max), min);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* Rounds two float vectors and packs them, with saturation, into a 16-bit vector. Every 32-bit unit holds the real and
+ * imaginary LLR of a symbol, in the order of the pack instruction of each 128-bit lane */
+static inline simd_s_t demod_256qam_simd_cvt(simd_f_t a, simd_f_t b)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_packs_epi32(_mm512_cvtps_epi32(a), _mm512_cvtps_epi32(b));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+#else /* LV_HAVE_AVX2 */
+  return _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* Transposes the 4x4 32-bit units of every 128-bit lane, which gathers the 4 levels of every symbol */
+static inline void demod_256qam_simd_transpose(simd_s_t* s)
+{
+#ifdef LV_HAVE_AVX512
+  __m512i t0 = _mm512_unpacklo_epi32(s[0], s[1]);
+  __m512i t1 = _mm512_unpackhi_epi32(s[0], s[1]);
+  __m512i t2 = _mm512_unpacklo_epi32(s[2], s[3]);
+  __m512i t3 = _mm512_unpackhi_epi32(s[2], s[3]);
+  s[0]       = _mm512_unpacklo_epi64(t0, t2);
+  s[1]       = _mm512_unpackhi_epi64(t0, t2);
+  s[2]       = _mm512_unpacklo_epi64(t1, t3);
+  s[3]       = _mm512_unpackhi_epi64(t1, t3);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  __m256i t0 = _mm256_unpacklo_epi32(s[0], s[1]);
+  __m256i t1 = _mm256_unpackhi_epi32(s[0], s[1]);
+  __m256i t2 = _mm256_unpacklo_epi32(s[2], s[3]);
+  __m256i t3 = _mm256_unpackhi_epi32(s[2], s[3]);
+  s[0]       = _mm256_unpacklo_epi64(t0, t2);
+  s[1]       = _mm256_unpackhi_epi64(t0, t2);
+  s[2]       = _mm256_unpacklo_epi64(t1, t3);
+  s[3]       = _mm256_unpackhi_epi64(t1, t3);
+#else /* LV_HAVE_AVX2 */
+  __m128i t0 = _mm_unpacklo_epi32(s[0], s[1]);
+  __m128i t1 = _mm_unpackhi_epi32(s[0], s[1]);
+  __m128i t2 = _mm_unpacklo_epi32(s[2], s[3]);
+  __m128i t3 = _mm_unpackhi_epi32(s[2], s[3]);
+  s[0]       = _mm_unpacklo_epi64(t0, t2);
+  s[1]       = _mm_unpackhi_epi64(t0, t2);
+  s[2]       = _mm_unpacklo_epi64(t1, t3);
+  s[3]       = _mm_unpackhi_epi64(t1, t3);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* The LLRs of the SRSRAN_SIMD_F_SIZE symbols at x, in order, in 4 16-bit vectors */
+static inline void demod_256qam_simd_block(const demod_256qam_simd_t* q, const float* x, simd_s_t* out)
+{
+  simd_s_t s[4];
+  simd_f_t a = demod_256qam_simd_clamp(srsran_simd_f_mul(srsran_simd_f_loadu(x), q->gain), q->min, q->max);
+  simd_f_t b = demod_256qam_simd_clamp(
+      srsran_simd_f_mul(srsran_simd_f_loadu(x + SRSRAN_SIMD_F_SIZE), q->gain), q->min, q->max);
+  s[0] = demod_256qam_simd_cvt(a, b);
+  for (uint32_t m = 1; m < 4; m++) {
+    a    = srsran_simd_f_sub(srsran_simd_f_abs(a), q->offset[m - 1]);
+    b    = srsran_simd_f_sub(srsran_simd_f_abs(b), q->offset[m - 1]);
+    s[m] = demod_256qam_simd_cvt(a, b);
+  }
+
+  demod_256qam_simd_transpose(s);
+
+  // Every 128-bit lane now holds one symbol. The pack gives the symbols of a and b in alternate pairs of units, so the
+  // lanes are put back in symbol order
+#ifdef LV_HAVE_AVX512
+  __m512i lo = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+  __m512i hi = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+  out[0]     = _mm512_permutex2var_epi64(s[0], lo, s[1]);
+  out[1]     = _mm512_permutex2var_epi64(s[0], hi, s[1]);
+  out[2]     = _mm512_permutex2var_epi64(s[2], lo, s[3]);
+  out[3]     = _mm512_permutex2var_epi64(s[2], hi, s[3]);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  out[0] = _mm256_permute2x128_si256(s[0], s[1], 0x20);
+  out[1] = _mm256_permute2x128_si256(s[0], s[1], 0x31);
+  out[2] = _mm256_permute2x128_si256(s[2], s[3], 0x20);
+  out[3] = _mm256_permute2x128_si256(s[2], s[3], 0x31);
+#else /* LV_HAVE_AVX2 */
+  for (uint32_t m = 0; m < 4; m++) {
+    out[m] = s[m];
+  }
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* Packs two 16-bit vectors in order into an 8-bit vector, in the symmetric range [-INT8_MAX, INT8_MAX] */
+static inline simd_b_t demod_256qam_simd_pack_b(simd_s_t a, simd_s_t b)
+{
+#ifdef LV_HAVE_AVX512
+  __m512i s = _mm512_permutexvar_epi64(_mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7), _mm512_packs_epi16(a, b));
+  return _mm512_max_epi8(s, _mm512_set1_epi8(-INT8_MAX));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  __m256i s = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8);
+  return _mm256_max_epi8(s, _mm256_set1_epi8(-INT8_MAX));
+#else /* LV_HAVE_AVX2 */
+  return _mm_max_epi8(_mm_packs_epi16(a, b), _mm_set1_epi8(-INT8_MAX));
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+#endif /* SRSRAN_SIMD_F_SIZE && LV_HAVE_SSE */
+
 void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
-    float real = -__real__ symbols[i];
-    float imag = -__imag__ symbols[i];
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
-    real       = fabsf(real) - 8.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 8.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
-    real       = fabsf(real) - 4.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 4.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
-    real       = fabsf(real) - 2.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 2.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
+  int i = 0;
+
+#ifdef DEMOD_256QAM_SIMD
+  demod_256qam_simd_t q;
+  demod_256qam_simd_init(&q, SCALE_BYTE_CONV_QAM256, INT8_MAX);
+  for (; i < nsymbols - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+    simd_s_t out[4];
+    demod_256qam_simd_block(&q, (const float*)&symbols[i], out);
+    srsran_simd_b_storeu(&llr[8 * i], demod_256qam_simd_pack_b(out[0], out[1]));
+    srsran_simd_b_storeu(&llr[8 * i + SRSRAN_SIMD_B_SIZE], demod_256qam_simd_pack_b(out[2], out[3]));
+  }
+#endif /* DEMOD_256QAM_SIMD */
+
+  for (; i < nsymbols; i++) {
+    float tmp[8];
+    demod_256qam_symbol(&symbols[i], SCALE_BYTE_CONV_QAM256, INT8_MAX, tmp);
+    for (uint32_t j = 0; j < 8; j++) {
+      llr[8 * i + j] = (int8_t)tmp[j];
+    }
   }
 }
 
 void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
-    float real = -__real__ symbols[i];
-    float imag = -__imag__ symbols[i];
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
-    real       = fabsf(real) - 8.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 8.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
-    real       = fabsf(real) - 4.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 4.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
-    real       = fabsf(real) - 2.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 2.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
+  int i = 0;
+
+#ifdef DEMOD_256QAM_SIMD
+  demod_256qam_simd_t q;
+  demod_256qam_simd_init(&q, SCALE_SHORT_CONV_QAM256, INT16_MAX);
+  simd_s_t min = srsran_simd_s_set1(-INT16_MAX);
+  for (; i < nsymbols - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+    simd_s_t out[4];
+    demod_256qam_simd_block(&q, (const float*)&symbols[i], out);
+    for (uint32_t m = 0; m < 4; m++) {
+      srsran_simd_s_storeu(&llr[8 * i + m * SRSRAN_SIMD_S_SIZE], srsran_simd_s_max(out[m], min));
+    }
+  }
+#endif /* DEMOD_256QAM_SIMD */
+
+  for (; i < nsymbols; i++) {
+    float tmp[8];
+    demod_256qam_symbol(&symbols[i], SCALE_SHORT_CONV_QAM256, INT16_MAX, tmp);
+    for (uint32_t j = 0; j < 8; j++) {
+      llr[8 * i + j] = (short)tmp[j];
+    }
   }
 }
 
@@ -30,13 +30,18 @@
 
 #include "srsran/srsran.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SOFT_DEMOD_TEST_TSC
+#endif
+
 static uint32_t     nof_frames = 10;
 static uint32_t     num_bits   = 1000;
 static srsran_mod_t modulation = SRSRAN_MOD_NITEMS;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)\n", prog);
+  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)\n", prog);
   printf("\t-n num_bits [Default %d]\n", num_bits);
   printf("\t-f nof_frames [Default %d]\n", nof_frames);
   printf("\t-v srsran_verbose [Default None]\n");
@@ -75,7 +80,7 @@ void parse_args(int argc, char** argv)
             break;
           default:
             ERROR("Invalid modulation %d. Possible values: "
-                  "(1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)",
+                  "(1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)",
                   (int)strtol(argv[optind], NULL, 10));
             break;
         }
@@ -109,6 +114,94 @@ float mse_threshold()
   }
 }
 
+/* Default scales of srsran_demod_soft_demodulate_s() and srsran_demod_soft_demodulate_b() */
+float default_scale(bool byte)
+{
+  switch (modulation) {
+    case SRSRAN_MOD_BPSK:
+    case SRSRAN_MOD_QPSK:
+      return byte ? 20 : 100;
+    case SRSRAN_MOD_16QAM:
+      return byte ? 30 : 400;
+    case SRSRAN_MOD_64QAM:
+      return byte ? 40 : 700;
+    case SRSRAN_MOD_256QAM:
+      return byte ? 50 : 1000;
+    default:
+      return -1.0f;
+  }
+}
+
+/* The fixed point LLRs must be the floating point ones scaled and saturated, up to max_error units of rounding error */
+static int check_llr_s(const float* llr, const short* llr_s, uint32_t nof_llr, float scale, float max_error)
+{
+  for (uint32_t i = 0; i < nof_llr; i++) {
+    float expected = SRSRAN_MAX(SRSRAN_MIN(llr[i] * scale, INT16_MAX), -INT16_MAX);
+    if (fabsf(expected - llr_s[i]) > max_error) {
+      printf("Error in short LLR %d with scale %.1f: %d, expected %.1f\n", i, scale, llr_s[i], expected);
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static int check_llr_b(const float* llr, const int8_t* llr_b, uint32_t nof_llr, float scale, float max_error)
+{
+  for (uint32_t i = 0; i < nof_llr; i++) {
+    float expected = SRSRAN_MAX(SRSRAN_MIN(llr[i] * scale, INT8_MAX), -INT8_MAX);
+    if (fabsf(expected - llr_b[i]) > max_error) {
+      printf("Error in byte LLR %d with scale %.1f: %d, expected %.1f\n", i, scale, llr_b[i], expected);
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static uint64_t read_tsc(void)
+{
+#ifdef SOFT_DEMOD_TEST_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/* Measures the time and the TSC (reference) cycles per symbol of each demodulator, over at least one million symbols */
+static void benchmark(const cf_t* symbols, uint32_t nof_symbols, float* llr, short* llr_s, int8_t* llr_b)
+{
+  const char* names[3]        = {"float", "short", "byte"};
+  uint32_t    nof_repetitions = SRSRAN_MAX(1, 1000000 / nof_symbols);
+
+  for (int type = 0; type < 3; type++) {
+    struct timespec t_start, t_end;
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    uint64_t tsc_start = read_tsc();
+    for (uint32_t r = 0; r < nof_repetitions; r++) {
+      switch (type) {
+        case 0:
+          srsran_demod_soft_demodulate(modulation, symbols, llr, nof_symbols);
+          break;
+        case 1:
+          srsran_demod_soft_demodulate_s(modulation, symbols, llr_s, nof_symbols);
+          break;
+        default:
+          srsran_demod_soft_demodulate_b(modulation, symbols, llr_b, nof_symbols);
+          break;
+      }
+    }
+    uint64_t tsc_end = read_tsc();
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+    double total_symbols = (double)nof_symbols * nof_repetitions;
+    double elapsed_ns    = (t_end.tv_sec - t_start.tv_sec) * 1e9 + (t_end.tv_nsec - t_start.tv_nsec);
+    printf("Demodulator %-5s: %6.2f ns/symbol", names[type], elapsed_ns / total_symbols);
+#ifdef SOFT_DEMOD_TEST_TSC
+    printf(", %6.2f cycles/symbol", (tsc_end - tsc_start) / total_symbols);
+#endif
+    printf("\n");
+  }
+}
+
 int main(int argc, char** argv)
 {
   int                  i;
@@ -233,7 +326,29 @@ int main(int argc, char** argv)
         goto clean_exit;
       }
     }
+
+    // Check fixed point LLRs with the default scales. The kernels up to 64QAM truncate every level, which gives up to
+    // one unit of error per level
+    float default_max_error = SRSRAN_MAX(1, mod.nbits_x_symbol / 2);
+    if (check_llr_s(llr, llr_s, num_bits, default_scale(false), default_max_error) ||
+        check_llr_b(llr, llr_b, num_bits, default_scale(true), default_max_error)) {
+      goto clean_exit;
+    }
+
+    // The 256QAM kernels round and saturate every level, check them with amplified symbols
+    if (modulation == SRSRAN_MOD_256QAM) {
+      srsran_vec_sc_prod_cfc(symbols, 1000.0f, symbols, num_bits / mod.nbits_x_symbol);
+      srsran_demod_soft_demodulate(modulation, symbols, llr, num_bits / mod.nbits_x_symbol);
+      srsran_demod_soft_demodulate_s(modulation, symbols, llr_s, num_bits / mod.nbits_x_symbol);
+      srsran_demod_soft_demodulate_b(modulation, symbols, llr_b, num_bits / mod.nbits_x_symbol);
+      if (check_llr_s(llr, llr_s, num_bits, default_scale(false), 1.0f) ||
+          check_llr_b(llr, llr_b, num_bits, default_scale(true), 1.0f)) {
+        goto clean_exit;
+      }
+    }
   }
+
+  benchmark(symbols, num_bits / mod.nbits_x_symbol, llr, llr_s, llr_b);
   ret = 0;
 
 clean_exit:
@@ -89,6 +89,16 @@ static int pdcch_init(srsran_pdcch_t* q, uint32_t max_prb, uint32_t nof_rx_anten
 
     srsran_vec_f_zero(q->llr, q->max_bits);
 
+    // One entry per CCE of 72 bits
+    q->cce_mean_llr = srsran_vec_f_malloc(q->max_bits / 72);
+    if (!q->cce_mean_llr) {
+      goto clean;
+    }
+
+    for (uint32_t i = 0; i < q->max_bits / 72; i++) {
+      q->cce_mean_llr[i] = -1.0f;
+    }
+
     q->d = srsran_vec_cf_malloc(q->max_bits / 2);
     if (!q->d) {
       goto clean;
@@ -140,6 +150,9 @@ void srsran_pdcch_free(srsran_pdcch_t* q)
   if (q->llr) {
     free(q->llr);
   }
+  if (q->cce_mean_llr) {
+    free(q->cce_mean_llr);
+  }
   if (q->d) {
     free(q->d);
   }
@@ -369,6 +382,39 @@ int srsran_pdcch_dci_decode(srsran_pdcch_t* q, float* e, uint8_t* data, uint32_t
   }
 }
 
+/* Mean absolute LLR of the CCEs in a location. Every CCE is computed once per subframe and shared by all the
+ * candidates and formats that overlap it */
+static float pdcch_location_mean_llr(srsran_pdcch_t* q, const srsran_dci_location_t* location)
+{
+  uint32_t L    = 1U << location->L;
+  float    mean = 0.0f;
+
+  for (uint32_t i = location->ncce; i < location->ncce + L; i++) {
+    if (q->cce_mean_llr[i] < 0.0f) {
+      double sum = 0;
+      for (uint32_t j = 0; j < 72; j++) {
+        sum += fabsf(q->llr[i * 72 + j]);
+      }
+      q->cce_mean_llr[i] = (float)(sum / 72);
+    }
+    mean += q->cce_mean_llr[i];
+  }
+
+  return mean / L;
+}
+
+static srsran_pdcch_decoded_msg_t*
+pdcch_find_decoded_msg(srsran_pdcch_t* q, const srsran_dci_location_t* location, uint32_t nof_bits)
+{
+  for (uint32_t i = 0; i < q->nof_decoded_msg; i++) {
+    srsran_pdcch_decoded_msg_t* m = &q->decoded_msg[i];
+    if (m->location.L == location->L && m->location.ncce == location->ncce && m->nof_bits == nof_bits) {
+      return m;
+    }
+  }
+  return NULL;
+}
+
 /** Tries to decode a DCI message from the LLRs stored in the srsran_pdcch_t structure by the function
  * srsran_pdcch_extract_llr(). This function can be called multiple times.
  * The location to search for is obtained from msg.
@@ -387,15 +433,30 @@ int srsran_pdcch_decode_msg(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dc
       uint32_t nof_bits = srsran_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
       uint32_t e_bits   = PDCCH_FORMAT_NOF_BITS(msg->location.L);
 
-      // Compute absolute mean of the LLRs
-      double mean = 0;
-      for (int i = 0; i < e_bits; i++) {
-        mean += fabsf(q->llr[msg->location.ncce * 72 + i]);
-      }
-      mean /= e_bits;
+      q->metrics.nof_candidates++;
+
+      // Compute absolute mean of the LLRs, empty CCEs are rejected before running the decoder
+      float mean = pdcch_location_mean_llr(q, &msg->location);
 
       if (mean > 0.3f) {
-        ret = srsran_pdcch_dci_decode(q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
+        // The decoder output does not depend on the RNTI, reuse it for every search of the same location and size
+        srsran_pdcch_decoded_msg_t* decoded = pdcch_find_decoded_msg(q, &msg->location, nof_bits);
+        if (decoded) {
+          memcpy(msg->payload, decoded->payload, nof_bits);
+          msg->rnti = decoded->crc_rem;
+          q->metrics.nof_reused++;
+        } else {
+          ret = srsran_pdcch_dci_decode(
+              q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
+          q->metrics.nof_decoded++;
+          if (ret == SRSRAN_SUCCESS && q->nof_decoded_msg < SRSRAN_PDCCH_MAX_DECODED_MSG) {
+            decoded           = &q->decoded_msg[q->nof_decoded_msg++];
+            decoded->location = msg->location;
+            decoded->nof_bits = nof_bits;
+            decoded->crc_rem  = msg->rnti;
+            memcpy(decoded->payload, msg->payload, nof_bits);
+          }
+        }
         if (ret == SRSRAN_SUCCESS) {
           msg->nof_bits = nof_bits;
           // Check format differentiation
@@ -414,6 +475,7 @@ int srsran_pdcch_decode_msg(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dc
              msg->rnti);
       } else {
         INFO("Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f", msg->location.ncce, msg->location.L, nof_bits, mean);
+        q->metrics.nof_skipped++;
       }
     }
   } else if (msg != NULL) {
@@ -422,6 +484,13 @@ int srsran_pdcch_decode_msg(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dc
   return ret;
 }
 
+void srsran_pdcch_get_metrics(srsran_pdcch_t* q, srsran_pdcch_metrics_t* metrics)
+{
+  if (q != NULL && metrics != NULL) {
+    *metrics = q->metrics;
+  }
+}
+
 float srsran_pdcch_msg_corr(srsran_pdcch_t* q, srsran_dci_msg_t* msg)
 {
   if (q == NULL || msg == NULL) {
@@ -463,6 +532,12 @@ int srsran_pdcch_extract_llr(srsran_pdcch_t*        q,
     ret             = SRSRAN_ERROR;
     srsran_vec_f_zero(q->llr, q->max_bits);
 
+    // New LLRs, forget the CCE energies and the decoded messages of the previous subframe
+    for (i = 0; i < NOF_CCE(sf->cfi); i++) {
+      q->cce_mean_llr[i] = -1.0f;
+    }
+    q->nof_decoded_msg = 0;
+
     DEBUG("Extracting LLRs: E: %d, SF: %d, CFI: %d", e_bits, sf->tti % 10, sf->cfi);
 
     /* number of layers equals number of ports */
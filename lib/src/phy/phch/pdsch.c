@@ -659,13 +659,15 @@ static void pdsch_decode_debug(srsran_pdsch_t*     q,
   }
 }
 
-static int srsran_pdsch_codeword_decode(srsran_pdsch_t*     q,
-                                        srsran_dl_sf_cfg_t* sf,
-                                        srsran_pdsch_cfg_t* cfg,
-                                        srsran_sch_t*       dl_sch,
-                                        srsran_pdsch_res_t* data,
-                                        uint32_t            tb_idx,
-                                        bool*               ack)
+/* Decodes a codeword. The time of the demodulation and decoding stages is added to meas_time, unless it is NULL */
+static int srsran_pdsch_codeword_decode(srsran_pdsch_t*          q,
+                                        srsran_dl_sf_cfg_t*      sf,
+                                        srsran_pdsch_cfg_t*      cfg,
+                                        srsran_sch_t*            dl_sch,
+                                        srsran_pdsch_res_t*      data,
+                                        uint32_t                 tb_idx,
+                                        bool*                    ack,
+                                        srsran_phch_meas_time_t* meas_time)
 {
   srsran_ra_tb_t*         mcs          = &cfg->grant.tb[tb_idx];
   uint32_t                rv           = mcs->rv;
@@ -686,6 +688,8 @@ static int srsran_pdsch_codeword_decode(srsran_pdsch_t*     q,
          cfg->grant.tb[tb_idx].nof_bits,
          rv);
 
+    uint64_t t_demod = meas_time ? srsran_phch_meas_time_now() : 0;
+
     /* demodulate symbols
      * The MAX-log-MAP algorithm used in turbo decoding is unsensitive to SNR estimation,
      * thus we don't need tot set it in the LLRs normalization
@@ -736,9 +740,17 @@ static int srsran_pdsch_codeword_decode(srsran_pdsch_t*     q,
       csi_correction(q, cfg, codeword_idx, tb_idx, q->e[codeword_idx]);
     }
 
+    uint64_t t_decode = meas_time ? srsran_phch_meas_time_now() : 0;
+
     /* Return  */
     ret = srsran_dlsch_decode2(dl_sch, cfg, q->e[codeword_idx], data[tb_idx].payload, tb_idx, nof_layers);
 
+    if (meas_time) {
+      uint64_t t_end = srsran_phch_meas_time_now();
+      meas_time->demod_ns += t_decode - t_demod;
+      meas_time->decode_ns += t_end - t_decode;
+    }
+
     if (ret == SRSRAN_SUCCESS) {
       *ack = true;
     } else if (ret == SRSRAN_ERROR) {
@@ -769,7 +781,8 @@ static void* srsran_pdsch_decode_thread(void* arg)
 
   sem_wait(&q->start);
   while (!q->quit) {
-    q->ret_status = srsran_pdsch_codeword_decode(q->pdsch_ptr, q->sf, q->cfg, &q->dl_sch, q->data, q->tb_idx, q->ack);
+    q->ret_status =
+        srsran_pdsch_codeword_decode(q->pdsch_ptr, q->sf, q->cfg, &q->dl_sch, q->data, q->tb_idx, q->ack, NULL);
 
     /* Post finish semaphore */
     sem_post(&q->finish);
@@ -797,9 +810,14 @@ int srsran_pdsch_decode(srsran_pdsch_t*        q,
   cf_t**   x;
 
   if (q != NULL && sf_symbols != NULL && data != NULL && cfg != NULL) {
-    struct timeval t[3];
+    struct timeval           t[3];
+    srsran_phch_meas_time_t* meas_time   = NULL;
+    uint64_t                 t_equalizer = 0;
     if (cfg->meas_time_en) {
       gettimeofday(&t[1], NULL);
+      meas_time = &cfg->meas_time_stages;
+      SRSRAN_MEM_ZERO(meas_time, srsran_phch_meas_time_t, 1);
+      t_equalizer = srsran_phch_meas_time_now();
     }
 
     uint32_t nof_tb = cfg->grant.nof_tb;
@@ -886,6 +904,10 @@ int srsran_pdsch_decode(srsran_pdsch_t*        q,
       srsran_layerdemap_type(x, q->d, cfg->grant.nof_layers, nof_tb, nof_symbols[0], nof_symbols, cfg->grant.tx_scheme);
     }
 
+    if (meas_time) {
+      meas_time->equalizer_ns = srsran_phch_meas_time_now() - t_equalizer;
+    }
+
     /* Codeword decoding: Implementation of 3GPP 36.212 Table 5.3.3.1.5-1 and Table 5.3.3.1.5-2 */
     for (uint32_t tb_idx = 0; tb_idx < SRSRAN_MAX_TB; tb_idx++) {
       /* Decode only if transport block is enabled and the default ACK is not true */
@@ -906,7 +928,7 @@ int srsran_pdsch_decode(srsran_pdsch_t*        q,
             sem_post(&h->start);
 
           } else {
-            ret = srsran_pdsch_codeword_decode(q, sf, cfg, &q->dl_sch, data, tb_idx, &data[tb_idx].crc);
+            ret = srsran_pdsch_codeword_decode(q, sf, cfg, &q->dl_sch, data, tb_idx, &data[tb_idx].crc, meas_time);
 
             data[tb_idx].avg_iterations_block = srsran_sch_last_noi(&q->dl_sch);
           }
@@ -367,8 +367,10 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
 
   if (q != NULL && sf_symbols != NULL && out != NULL && cfg != NULL) {
     struct timeval t[3];
+    uint64_t       t_stage[4] = {};
     if (cfg->meas_time_en) {
       gettimeofday(&t[1], NULL);
+      t_stage[0] = srsran_phch_meas_time_now();
     }
 
     /* Limit UL modulation if not supported by the UE or disabled by higher layers */
@@ -415,6 +417,10 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
     // DFT predecoding
     srsran_dft_precoding(&q->dft_precoding, q->z, q->d, cfg->grant.L_prb, cfg->grant.nof_symb);
 
+    if (cfg->meas_time_en) {
+      t_stage[1] = srsran_phch_meas_time_now();
+    }
+
     // Soft demodulation
     if (q->llr_is_8bit) {
       srsran_demod_soft_demodulate_b(cfg->grant.tb.mod, q->d, q->q, cfg->grant.nof_re);
@@ -446,6 +452,10 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
     srsran_sequence_pusch_gen_unpack(
         c, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
 
+    if (cfg->meas_time_en) {
+      t_stage[2] = srsran_phch_meas_time_now();
+    }
+
     // Set max number of iterations
     srsran_sch_set_max_noi(&q->ul_sch, cfg->max_nof_iterations);
 
@@ -461,6 +471,12 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
     ret             = SRSRAN_SUCCESS;
 
     if (cfg->meas_time_en) {
+      t_stage[3] = srsran_phch_meas_time_now();
+
+      cfg->meas_time_stages.equalizer_ns = t_stage[1] - t_stage[0];
+      cfg->meas_time_stages.demod_ns     = t_stage[2] - t_stage[1];
+      cfg->meas_time_stages.decode_ns    = t_stage[3] - t_stage[2];
+
       gettimeofday(&t[2], NULL);
       get_time_interval(t);
       cfg->meas_time_value = t[0].tv_usec;
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 
 #define SRSRAN_PDSCH_MIN_TDEC_ITERS 2
 #define SRSRAN_PDSCH_MAX_TDEC_ITERS 10
@@ -368,108 +369,367 @@ static int encode_tb(srsran_sch_t*           q,
   return encode_tb_off(q, soft_buffer, cb_segm, Qm, rv, nof_e_bits, data, e_bits, 0);
 }
 
-bool decode_tb_cb(srsran_sch_t*           q,
-                  srsran_softbuffer_rx_t* softbuffer,
-                  srsran_cbsegm_t*        cb_segm,
-                  uint32_t                Qm,
-                  uint32_t                rv,
-                  uint32_t                nof_e_bits,
-                  void*                   e_bits,
-                  uint8_t*                data)
+/* Undoes the rate matching of one codeblock into its softbuffer */
+static int decode_cb_rate_dematch(srsran_sch_t*           q,
+                                  srsran_softbuffer_rx_t* softbuffer,
+                                  srsran_cbsegm_t*        cb_segm,
+                                  uint32_t                Qm,
+                                  uint32_t                rv,
+                                  uint32_t                nof_e_bits,
+                                  void*                   e_bits,
+                                  uint32_t                cb_idx,
+                                  uint32_t*               rp_out,
+                                  uint32_t*               n_e_out)
 {
   int8_t*  e_bits_b = e_bits;
   int16_t* e_bits_s = e_bits;
 
-  if (cb_segm->C > SRSRAN_MAX_CODEBLOCKS) {
-    ERROR("Error SRSRAN_MAX_CODEBLOCKS=%d", SRSRAN_MAX_CODEBLOCKS);
-    return false;
+  uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
+
+  uint32_t Gp    = nof_e_bits / Qm;
+  uint32_t gamma = cb_segm->C > 0 ? Gp % cb_segm->C : Gp;
+  uint32_t n_e   = Qm * (Gp / cb_segm->C);
+
+  uint32_t rp   = cb_idx * n_e;
+  uint32_t n_e2 = n_e;
+
+  if (cb_idx > cb_segm->C - gamma) {
+    n_e2 = n_e + Qm;
+    rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
   }
 
-  q->avg_iterations = 0;
+  if (q->llr_is_8bit) {
+    if (srsran_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+      ERROR("Error in rate matching");
+      return SRSRAN_ERROR;
+    }
+  } else {
+    if (srsran_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+      ERROR("Error in rate matching");
+      return SRSRAN_ERROR;
+    }
+  }
 
-  for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
-    /* Do not process blocks with CRC Ok */
-    if (softbuffer->cb_crc[cb_idx] == false) {
-      uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
-      uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
+  if (rp_out) {
+    *rp_out = rp;
+  }
+  if (n_e_out) {
+    *n_e_out = n_e2;
+  }
+  return SRSRAN_SUCCESS;
+}
 
-      uint32_t rlen  = cb_segm->C == 1 ? cb_len : (cb_len - 24);
-      uint32_t Gp    = nof_e_bits / Qm;
-      uint32_t gamma = cb_segm->C > 0 ? Gp % cb_segm->C : Gp;
-      uint32_t n_e   = Qm * (Gp / cb_segm->C);
+/* Checks the CRC of a decoded codeblock, the TB CRC is used if the TB has a single codeblock */
+static bool
+decode_cb_crc(srsran_crc_t* crc_tb, srsran_crc_t* crc_cb, srsran_cbsegm_t* cb_segm, uint8_t* cb_data, uint32_t cb_len)
+{
+  uint32_t      len_crc;
+  srsran_crc_t* crc_ptr;
 
-      uint32_t rp   = cb_idx * n_e;
-      uint32_t n_e2 = n_e;
+  if (cb_segm->C > 1) {
+    len_crc = cb_len;
+    crc_ptr = crc_cb;
+  } else {
+    len_crc = cb_segm->tbs + 24;
+    crc_ptr = crc_tb;
+  }
 
-      if (cb_idx > cb_segm->C - gamma) {
-        n_e2 = n_e + Qm;
-        rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
-      }
+  return srsran_crc_checksum_byte(crc_ptr, cb_data, len_crc) == 0;
+}
 
-      if (q->llr_is_8bit) {
-        if (srsran_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching");
-          return SRSRAN_ERROR;
-        }
-      } else {
-        if (srsran_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching");
-          return SRSRAN_ERROR;
-        }
-      }
+/* Runs turbo decoder iterations on a codeblock until its CRC matches or the maximum number of iterations is reached.
+ * Returns the number of iterations */
+static uint32_t decode_cb_iterations(srsran_sch_t*    q,
+                                     srsran_tdec_t*   decoder,
+                                     srsran_crc_t*    crc_tb,
+                                     srsran_crc_t*    crc_cb,
+                                     srsran_cbsegm_t* cb_segm,
+                                     void*            input,
+                                     uint8_t*         output,
+                                     uint32_t         cb_len,
+                                     bool*            crc_ok)
+{
+  bool     early_stop = false;
+  uint32_t cb_noi     = 0;
 
-      srsran_tdec_new_cb(&q->decoder, cb_len);
+  srsran_tdec_new_cb(decoder, cb_len);
 
-      // Run iterations and use CRC for early stopping
-      bool     early_stop = false;
-      uint32_t cb_noi     = 0;
-      do {
-        if (q->llr_is_8bit) {
-          srsran_tdec_iteration_8bit(&q->decoder, (int8_t*)softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        } else {
-          srsran_tdec_iteration(&q->decoder, softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        }
-        q->avg_iterations++;
-        cb_noi++;
+  do {
+    if (q->llr_is_8bit) {
+      srsran_tdec_iteration_8bit(decoder, (int8_t*)input, output);
+    } else {
+      srsran_tdec_iteration(decoder, (int16_t*)input, output);
+    }
+    cb_noi++;
 
-        uint32_t      len_crc;
-        srsran_crc_t* crc_ptr;
+    // CRC is OK and ran the minimum number of iterations
+    if (decode_cb_crc(crc_tb, crc_cb, cb_segm, output, cb_len) && (cb_noi >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
+      early_stop = true;
+    }
+  } while (cb_noi < q->max_iterations && !early_stop);
 
-        if (cb_segm->C > 1) {
-          len_crc = cb_len;
-          crc_ptr = &q->crc_cb;
-        } else {
-          len_crc = cb_segm->tbs + 24;
-          crc_ptr = &q->crc_tb;
-        }
+  *crc_ok = early_stop;
+  return cb_noi;
+}
 
-        // CRC is OK and ran the minimum number of iterations
-        if (!srsran_crc_checksum_byte(crc_ptr, &data[cb_idx * rlen / 8], len_crc) &&
-            (cb_noi >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
-          softbuffer->cb_crc[cb_idx] = true;
-          early_stop                 = true;
+static uint32_t decode_elapsed_us(struct timeval* t)
+{
+  get_time_interval(t);
+  return (uint32_t)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+}
 
-          // CRC is error and exceeded maximum iterations for this CB.
-          // Early stop the whole transport block.
-        }
+typedef struct {
+  srsran_tdec_t decoder;
+  srsran_crc_t  crc_tb;
+  srsran_crc_t  crc_cb;
+} sch_fec_ctx_t;
+
+typedef struct {
+  // Inputs, shared by all the codeblocks of the transport block
+  srsran_sch_t*           q;
+  srsran_softbuffer_rx_t* softbuffer;
+  srsran_cbsegm_t*        cb_segm;
+  uint32_t                Qm;
+  uint32_t                rv;
+  uint32_t                nof_e_bits;
+  void*                   e_bits;
+  uint32_t                cb_idx;
+
+  // Outputs
+  int      ret;
+  bool     crc_ok;
+  uint32_t noi;
+  uint32_t time_us;
+} sch_fec_job_t;
+
+static void* sch_fec_ctx_init(void* arg)
+{
+  sch_fec_ctx_t* ctx = calloc(1, sizeof(sch_fec_ctx_t));
+  if (ctx == NULL) {
+    return NULL;
+  }
+
+  if (srsran_crc_init(&ctx->crc_tb, SRSRAN_LTE_CRC24A, 24) || srsran_crc_init(&ctx->crc_cb, SRSRAN_LTE_CRC24B, 24)) {
+    ERROR("Error initiating CRC");
+    free(ctx);
+    return NULL;
+  }
+
+  if (srsran_tdec_init(&ctx->decoder, SRSRAN_TCOD_MAX_LEN_CB)) {
+    ERROR("Error initiating Turbo Decoder");
+    free(ctx);
+    return NULL;
+  }
+
+  return ctx;
+}
 
-      } while (cb_noi < q->max_iterations && !early_stop);
+static void sch_fec_ctx_free(void* arg)
+{
+  sch_fec_ctx_t* ctx = (sch_fec_ctx_t*)arg;
+
+  srsran_tdec_free(&ctx->decoder);
+  free(ctx);
+}
+
+/* Runs in a FEC pool thread. The codeblock is decoded into its softbuffer, as the whole codeblock with its CRC
+ * overlaps with the next one in the transport block */
+static void sch_fec_job_run(void* ctx_, void* arg)
+{
+  sch_fec_ctx_t* ctx = (sch_fec_ctx_t*)ctx_;
+  sch_fec_job_t* job = (sch_fec_job_t*)arg;
+  struct timeval t[3];
+
+  gettimeofday(&t[1], NULL);
+
+  uint32_t cb_len = job->cb_idx < job->cb_segm->C1 ? job->cb_segm->K1 : job->cb_segm->K2;
+
+  job->ret = decode_cb_rate_dematch(
+      job->q, job->softbuffer, job->cb_segm, job->Qm, job->rv, job->nof_e_bits, job->e_bits, job->cb_idx, NULL, NULL);
+  if (job->ret == SRSRAN_SUCCESS) {
+    job->noi = decode_cb_iterations(job->q,
+                                    &ctx->decoder,
+                                    &ctx->crc_tb,
+                                    &ctx->crc_cb,
+                                    job->cb_segm,
+                                    job->softbuffer->buffer_f[job->cb_idx],
+                                    job->softbuffer->data[job->cb_idx],
+                                    cb_len,
+                                    &job->crc_ok);
+  }
+
+  gettimeofday(&t[2], NULL);
+  job->time_us = decode_elapsed_us(t);
+}
 
-      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
+int srsran_sch_fec_pool_init(srsran_fec_pool_t* pool, uint32_t nof_workers)
+{
+  return srsran_fec_pool_init(pool, nof_workers, sch_fec_ctx_init, sch_fec_ctx_free, NULL);
+}
+
+void srsran_sch_set_fec_pool(srsran_sch_t* q, srsran_fec_pool_t* pool)
+{
+  if (q) {
+    q->fec_pool = pool;
+  }
+}
+
+/* Decodes all pending codeblocks in the FEC pool threads and waits for them */
+static int decode_tb_cb_pool(srsran_sch_t*           q,
+                             srsran_softbuffer_rx_t* softbuffer,
+                             srsran_cbsegm_t*        cb_segm,
+                             uint32_t                Qm,
+                             uint32_t                rv,
+                             uint32_t                nof_e_bits,
+                             void*                   e_bits,
+                             uint8_t*                data)
+{
+  sch_fec_job_t             jobs[SRSRAN_MAX_CODEBLOCKS];
+  srsran_fec_pool_barrier_t barrier;
+  int                       ret = SRSRAN_SUCCESS;
+
+  if (srsran_fec_pool_barrier_init(&barrier)) {
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
+    q->cb_time_us[cb_idx] = 0;
+
+    if (softbuffer->cb_crc[cb_idx]) {
+      continue;
+    }
+
+    sch_fec_job_t* job = &jobs[cb_idx];
+    job->q             = q;
+    job->softbuffer    = softbuffer;
+    job->cb_segm       = cb_segm;
+    job->Qm            = Qm;
+    job->rv            = rv;
+    job->nof_e_bits    = nof_e_bits;
+    job->e_bits        = e_bits;
+    job->cb_idx        = cb_idx;
+    job->ret           = SRSRAN_ERROR;
+    job->crc_ok        = false;
+    job->noi           = 0;
+    job->time_us       = 0;
+
+    if (srsran_fec_pool_push(q->fec_pool, sch_fec_job_run, job, &barrier)) {
+      ERROR("Error pushing CB %d to the FEC pool", cb_idx);
+      ret = SRSRAN_ERROR;
+      break;
+    }
+  }
+
+  // Wait for all the pushed jobs even if one failed to push, as they point to this stack
+  srsran_fec_pool_barrier_wait(&barrier);
+  srsran_fec_pool_barrier_free(&barrier);
+
+  if (ret) {
+    return ret;
+  }
+
+  for (uint32_t cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
+    uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
+    uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
+
+    if (!softbuffer->cb_crc[cb_idx]) {
+      sch_fec_job_t* job = &jobs[cb_idx];
+      if (job->ret) {
+        return SRSRAN_ERROR;
+      }
+
+      softbuffer->cb_crc[cb_idx] = job->crc_ok;
+      q->cb_time_us[cb_idx]      = job->time_us;
+      q->avg_iterations += job->noi;
+
+      INFO("CB %d: cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d, time=%d us",
            cb_idx,
-           rp,
-           n_e2,
            cb_len,
-           early_stop ? "OK" : "KO",
+           job->crc_ok ? "OK" : "KO",
            rlen,
-           cb_noi,
-           q->max_iterations);
+           job->noi,
+           q->max_iterations,
+           job->time_us);
+    }
 
-    } else {
-      // Copy decoded data from previous transmissions
+    // Copy decoded data from this or previous transmissions
+    memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+bool decode_tb_cb(srsran_sch_t*           q,
+                  srsran_softbuffer_rx_t* softbuffer,
+                  srsran_cbsegm_t*        cb_segm,
+                  uint32_t                Qm,
+                  uint32_t                rv,
+                  uint32_t                nof_e_bits,
+                  void*                   e_bits,
+                  uint8_t*                data)
+{
+  if (cb_segm->C > SRSRAN_MAX_CODEBLOCKS) {
+    ERROR("Error SRSRAN_MAX_CODEBLOCKS=%d", SRSRAN_MAX_CODEBLOCKS);
+    return false;
+  }
+
+  q->avg_iterations = 0;
+
+  if (q->fec_pool && cb_segm->C > 1) {
+    if (decode_tb_cb_pool(q, softbuffer, cb_segm, Qm, rv, nof_e_bits, e_bits, data)) {
+      return false;
+    }
+  } else {
+    for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
       uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
       uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
-      memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+
+      q->cb_time_us[cb_idx] = 0;
+
+      /* Do not process blocks with CRC Ok */
+      if (softbuffer->cb_crc[cb_idx] == false) {
+        uint32_t       rp     = 0;
+        uint32_t       n_e2   = 0;
+        bool           crc_ok = false;
+        struct timeval t[3];
+
+        gettimeofday(&t[1], NULL);
+
+        if (decode_cb_rate_dematch(q, softbuffer, cb_segm, Qm, rv, nof_e_bits, e_bits, cb_idx, &rp, &n_e2)) {
+          return SRSRAN_ERROR;
+        }
+
+        // Run iterations and use CRC for early stopping
+        uint32_t cb_noi = decode_cb_iterations(q,
+                                               &q->decoder,
+                                               &q->crc_tb,
+                                               &q->crc_cb,
+                                               cb_segm,
+                                               softbuffer->buffer_f[cb_idx],
+                                               &data[cb_idx * rlen / 8],
+                                               cb_len,
+                                               &crc_ok);
+        q->avg_iterations += cb_noi;
+        softbuffer->cb_crc[cb_idx] = crc_ok;
+
+        gettimeofday(&t[2], NULL);
+        q->cb_time_us[cb_idx] = decode_elapsed_us(t);
+
+        INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d, time=%d us",
+             cb_idx,
+             rp,
+             n_e2,
+             cb_len,
+             crc_ok ? "OK" : "KO",
+             rlen,
+             cb_noi,
+             q->max_iterations,
+             q->cb_time_us[cb_idx]);
+
+      } else {
+        // Copy decoded data from previous transmissions
+        memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+      }
     }
   }
 
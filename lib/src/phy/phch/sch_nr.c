@@ -28,6 +28,7 @@
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
+#include <sys/time.h>
 
 #define SCH_INFO_TX(...) INFO("SCH Tx: " __VA_ARGS__)
 #define SCH_INFO_RX(...) INFO("SCH Rx: " __VA_ARGS__)
@@ -356,9 +357,52 @@ int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
     return SRSRAN_ERROR;
   }
 
+  q->fec_pool = NULL;
+
   return SRSRAN_SUCCESS;
 }
 
+static void* sch_nr_fec_ctx_init(void* arg)
+{
+  const srsran_sch_nr_args_t* args = (const srsran_sch_nr_args_t*)arg;
+
+  srsran_sch_nr_t* ctx = SRSRAN_MEM_ALLOC(srsran_sch_nr_t, 1);
+  if (ctx == NULL) {
+    return NULL;
+  }
+  SRSRAN_MEM_ZERO(ctx, srsran_sch_nr_t, 1);
+
+  if (srsran_sch_nr_init_rx(ctx, args) < SRSRAN_SUCCESS) {
+    srsran_sch_nr_free(ctx);
+    free(ctx);
+    return NULL;
+  }
+
+  return ctx;
+}
+
+static void sch_nr_fec_ctx_free(void* ctx)
+{
+  srsran_sch_nr_free((srsran_sch_nr_t*)ctx);
+  free(ctx);
+}
+
+int srsran_sch_nr_fec_pool_init(srsran_fec_pool_t* pool, uint32_t nof_workers, const srsran_sch_nr_args_t* args)
+{
+  if (args == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  return srsran_fec_pool_init(pool, nof_workers, sch_nr_fec_ctx_init, sch_nr_fec_ctx_free, (void*)args);
+}
+
+void srsran_sch_nr_set_fec_pool(srsran_sch_nr_t* q, srsran_fec_pool_t* pool)
+{
+  if (q) {
+    q->fec_pool = pool;
+  }
+}
+
 int srsran_sch_nr_set_carrier(srsran_sch_nr_t* q, const srsran_carrier_nr_t* carrier)
 {
   if (!q) {
@@ -551,6 +595,107 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
   return SRSRAN_SUCCESS;
 }
 
+typedef struct {
+  int      ret;
+  bool     crc_ok;
+  uint32_t n_iter;
+  uint32_t time_us;
+} sch_nr_cb_res_t;
+
+/**
+ * @brief Decodes a single codeblock using the decoder, rate matching and CRC objects of q. If the CRC matches, the
+ * decoded codeblock is packed into the soft-buffer data
+ */
+static void sch_nr_decode_cb(srsran_sch_nr_t*               q,
+                             const srsran_sch_nr_tb_info_t* cfg,
+                             const srsran_sch_tb_t*         tb,
+                             uint32_t                       r,
+                             int8_t*                        input_ptr,
+                             uint32_t                       E,
+                             sch_nr_cb_res_t*               res)
+{
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+
+  res->ret    = SRSRAN_ERROR;
+  res->crc_ok = false;
+  res->n_iter = 0;
+
+  srsran_ldpc_decoder_t* decoder   = (cfg->bg == BG1) ? q->decoder_bg1[cfg->Z] : q->decoder_bg2[cfg->Z];
+  int8_t*                rm_buffer = (int8_t*)tb->softbuffer.tx->buffer_b[r];
+
+  // LDPC Rate matching
+  SCH_INFO_RX("RM CB %d: E=%d; F=%d; BG=%d; Z=%d; RV=%d; Qm=%d; Nref=%d;",
+              r,
+              E,
+              cfg->F,
+              cfg->bg == BG1 ? 1 : 2,
+              cfg->Z,
+              tb->rv,
+              cfg->Qm,
+              cfg->Nref);
+  int n_llr =
+      srsran_ldpc_rm_rx_c(&q->rx_rm, input_ptr, rm_buffer, E, cfg->F, cfg->bg, cfg->Z, tb->rv, tb->mod, cfg->Nref);
+  if (n_llr < SRSRAN_SUCCESS) {
+    ERROR("Error in LDPC rate mateching");
+    return;
+  }
+
+  // Select CB or TB early stop CRC
+  srsran_crc_t* crc = (cfg->L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
+  if (cfg->L_cb) {
+    crc = &q->crc_cb;
+  }
+
+  // Decode. if CRC=KO, then ret=0
+  int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
+  if (ret < SRSRAN_SUCCESS) {
+    ERROR("Error decoding CB");
+    return;
+  }
+
+  // Compute number of iterations
+  res->n_iter = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
+  res->crc_ok = (ret != 0);
+
+  // Check if CB is all zeros
+  uint32_t cb_len = cfg->Kp - cfg->L_cb;
+
+  // CB Debug trace
+  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+    DEBUG("CB %d/%d:", r, cfg->C);
+    srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
+  }
+
+  // Pack only if CRC is match
+  if (res->crc_ok) {
+    srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
+  }
+
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  res->time_us = (uint32_t)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+  res->ret     = SRSRAN_SUCCESS;
+}
+
+typedef struct {
+  const srsran_sch_nr_tb_info_t* cfg;
+  const srsran_sch_tb_t*         tb;
+  uint32_t                       r;
+  int8_t*                        input_ptr;
+  uint32_t                       E;
+  sch_nr_cb_res_t                res;
+} sch_nr_fec_job_t;
+
+/**
+ * @brief Runs in a FEC pool thread, the context is an SCH object private to the thread
+ */
+static void sch_nr_fec_job_run(void* ctx, void* arg)
+{
+  sch_nr_fec_job_t* job = (sch_nr_fec_job_t*)arg;
+  sch_nr_decode_cb((srsran_sch_nr_t*)ctx, job->cfg, job->tb, job->r, job->input_ptr, job->E, &job->res);
+}
+
 static int sch_nr_decode(srsran_sch_nr_t*        q,
                          const srsran_sch_cfg_t* sch_cfg,
                          const srsran_sch_tb_t*  tb,
@@ -607,16 +752,28 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
   uint32_t cb_ok = 0;
   res->crc       = false;
 
+  // Code blocks are decoded in the FEC pool, if any, when there is more than one
+  bool                      use_pool = (q->fec_pool != NULL && cfg.C > 1);
+  sch_nr_fec_job_t          jobs[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
+  srsran_fec_pool_barrier_t barrier;
+  if (use_pool && srsran_fec_pool_barrier_init(&barrier) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
   // For each code block...
-  uint32_t j = 0;
-  for (uint32_t r = 0; r < cfg.C; r++) {
+  int      ret = SRSRAN_SUCCESS;
+  uint32_t j   = 0;
+  for (uint32_t r = 0; r < cfg.C && ret == SRSRAN_SUCCESS; r++) {
     bool    decoded   = tb->softbuffer.rx->cb_crc[r];
     int8_t* rm_buffer = (int8_t*)tb->softbuffer.tx->buffer_b[r];
     if (!rm_buffer) {
       ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
-      return SRSRAN_ERROR;
+      ret = SRSRAN_ERROR;
+      break;
     }
 
+    q->cb_time_us[r] = 0;
+
     // Skip CB if mask indicates no transmission of the CB
     if (!cfg.mask[r]) {
       if (decoded) {
@@ -630,67 +787,69 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     uint32_t E = sch_nr_get_E(&cfg, j);
     j++;
 
-    // Skip CB if it has a matched CRC
+    // Skip CB if it has a matched CRC, its bits are still present in the input sequence
     if (decoded) {
       SCH_INFO_RX("RM CB %d: CRC OK ... Skipping", r);
       cb_ok++;
+      input_ptr += E;
       continue;
     }
 
-    // LDPC Rate matching
-    SCH_INFO_RX("RM CB %d: E=%d; F=%d; BG=%d; Z=%d; RV=%d; Qm=%d; Nref=%d;",
-                r,
-                E,
-                cfg.F,
-                cfg.bg == BG1 ? 1 : 2,
-                cfg.Z,
-                tb->rv,
-                cfg.Qm,
-                cfg.Nref);
-    int n_llr =
-        srsran_ldpc_rm_rx_c(&q->rx_rm, input_ptr, rm_buffer, E, cfg.F, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
-    if (n_llr < SRSRAN_SUCCESS) {
-      ERROR("Error in LDPC rate mateching");
-      return SRSRAN_ERROR;
-    }
-
-    // Select CB or TB early stop CRC
-    srsran_crc_t* crc = (cfg.L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
-    if (cfg.L_cb) {
-      crc = &q->crc_cb;
-    }
+    sch_nr_fec_job_t* job = &jobs[r];
+    job->cfg              = &cfg;
+    job->tb               = tb;
+    job->r                = r;
+    job->input_ptr        = input_ptr;
+    job->E                = E;
+    job->res.ret          = SRSRAN_ERROR;
 
-    // Decode. if CRC=KO, then ret=0
-    int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
-    if (ret < SRSRAN_SUCCESS) {
-      ERROR("Error decoding CB");
-      return SRSRAN_ERROR;
+    if (use_pool) {
+      if (srsran_fec_pool_push(q->fec_pool, sch_nr_fec_job_run, job, &barrier) < SRSRAN_SUCCESS) {
+        ERROR("Error pushing CB %d to the FEC pool", r);
+        ret = SRSRAN_ERROR;
+      }
+    } else {
+      sch_nr_decode_cb(q, &cfg, tb, r, input_ptr, E, &job->res);
+      ret = job->res.ret;
     }
 
-    // Compute number of iterations
-    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
-    nof_iter_sum += n_iter_cb;
+    input_ptr += E;
+  }
 
-    // Check if CB is all zeros
-    uint32_t cb_len = cfg.Kp - cfg.L_cb;
+  if (use_pool) {
+    // Wait for all the pushed jobs even if an error occurred, as they point to this stack
+    srsran_fec_pool_barrier_wait(&barrier);
+    srsran_fec_pool_barrier_free(&barrier);
+  }
 
-    tb->softbuffer.rx->cb_crc[r] = (ret != 0);
-    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", r, cfg.C, n_iter_cb, tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO");
+  // Collect the results of the decoded code blocks
+  for (uint32_t r = 0; r < cfg.C && ret == SRSRAN_SUCCESS; r++) {
+    if (!cfg.mask[r] || tb->softbuffer.rx->cb_crc[r]) {
+      continue;
+    }
 
-    // CB Debug trace
-    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-      DEBUG("CB %d/%d:", r, cfg.C);
-      srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
+    const sch_nr_cb_res_t* cb_res = &jobs[r].res;
+    if (cb_res->ret < SRSRAN_SUCCESS) {
+      ret = SRSRAN_ERROR;
+      break;
     }
 
-    // Pack and count CRC OK only if CRC is match
-    if (tb->softbuffer.rx->cb_crc[r]) {
-      srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
+    nof_iter_sum += cb_res->n_iter;
+    q->cb_time_us[r]             = cb_res->time_us;
+    tb->softbuffer.rx->cb_crc[r] = cb_res->crc_ok;
+    SCH_INFO_RX(
+        "CB %d/%d iter=%d CRC=%s time=%d us", r, cfg.C, cb_res->n_iter, cb_res->crc_ok ? "OK" : "KO", cb_res->time_us);
+
+    // Count CRC OK only if CRC is match
+    if (cb_res->crc_ok) {
       cb_ok++;
     }
+  }
 
-    input_ptr += E;
+  if (ret < SRSRAN_SUCCESS) {
+    return ret;
   }
+
   // Set average number of iterations
   res->avg_iter = (float)nof_iter_sum / (float)cfg.C;
 
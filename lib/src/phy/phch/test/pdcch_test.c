@@ -19,6 +19,7 @@
  *
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -194,15 +195,19 @@ static int test_case1()
 
   // Iterate all possible subframes
   for (uint32_t f_idx = 0; formats[f_idx] != SRSRAN_DCI_NOF_FORMATS; f_idx++) {
-    srsran_dci_format_t format                 = formats[f_idx];
-    struct timeval      t[3]                   = {};
-    uint64_t            t_encode_us            = 0;
-    uint64_t            t_encode_count         = 0;
-    uint64_t            t_llr_us               = 0;
-    uint64_t            t_decode_us            = 0;
-    uint64_t            t_decode_count         = 0;
-    uint32_t            false_alarm_corr_count = 0;
-    float               min_corr               = INFINITY;
+    srsran_dci_format_t    format                 = formats[f_idx];
+    struct timeval         t[3]                   = {};
+    uint64_t               t_encode_us            = 0;
+    uint64_t               t_encode_count         = 0;
+    uint64_t               t_llr_us               = 0;
+    uint64_t               t_decode_us            = 0;
+    uint64_t               t_decode_count         = 0;
+    uint32_t               false_alarm_corr_count = 0;
+    float                  min_corr               = INFINITY;
+    srsran_pdcch_metrics_t metrics_before         = {};
+    srsran_pdcch_metrics_t metrics_after          = {};
+
+    srsran_pdcch_get_metrics(&pdcch_rx, &metrics_before);
 
     for (uint32_t sf_idx = 0; sf_idx < repetitions * SRSRAN_NOF_SF_X_FRAME; sf_idx++) {
       srsran_dl_sf_cfg_t dl_sf_cfg = {};
@@ -334,14 +339,26 @@ static int test_case1()
       return SRSRAN_ERROR;
     }
 
+    // Every candidate is either decoded, rejected by the pre-screen or served by a previous decoding
+    srsran_pdcch_get_metrics(&pdcch_rx, &metrics_after);
+    uint64_t nof_candidates = metrics_after.nof_candidates - metrics_before.nof_candidates;
+    uint64_t nof_decoded    = metrics_after.nof_decoded - metrics_before.nof_decoded;
+    uint64_t nof_skipped    = metrics_after.nof_skipped - metrics_before.nof_skipped;
+    uint64_t nof_reused     = metrics_after.nof_reused - metrics_before.nof_reused;
+    TESTASSERT(nof_candidates == t_decode_count);
+    TESTASSERT(nof_candidates == nof_decoded + nof_skipped + nof_reused);
+
     printf("test_case_1 - format %s - passed - %.1f usec/encode; %.1f usec/llr; %.1f usec/decode; min_corr=%f; "
-           "false_alarm_prob=%f;\n",
+           "false_alarm_prob=%f; decodes_avoided=%.1f%% (%" PRIu64 " skipped, %" PRIu64 " reused);\n",
            srsran_dci_format_string(format),
            (double)t_encode_us / (double)(t_encode_count),
            (double)t_llr_us / (double)(t_encode_count),
            (double)t_decode_us / (double)(t_decode_count),
            min_corr,
-           (double)false_alarm_corr_count / (double)t_decode_count);
+           (double)false_alarm_corr_count / (double)t_decode_count,
+           100.0 * (double)(nof_skipped + nof_reused) / (double)nof_candidates,
+           nof_skipped,
+           nof_reused);
   }
 
   return SRSRAN_SUCCESS;
@@ -56,6 +56,7 @@ int          freq_hop      = -1;
 int          riv           = -1;
 uint32_t     mcs_idx       = 0;
 bool         enable_64_qam = false;
+uint32_t     nof_fec       = 0;
 
 void usage(char* prog)
 {
@@ -83,6 +84,7 @@ void usage(char* prog)
 
   printf("\n\tOther parameters:\n");
   printf("\t\t-p enable_64qam [Default %s]\n", enable_64_qam ? "enabled" : "disabled");
+  printf("\t\t-p fec_threads, 0 for decoding in the main thread [Default %d]\n", nof_fec);
   printf("\t\t-s number of subframes [Default %d]\n", subframe);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
@@ -126,6 +128,8 @@ void parse_extensive_param(char* param, char* arg)
     uci_data_tx.cfg.ack[0].nof_acks = SRSRAN_MIN((uint32_t)strtol(arg, NULL, 10), SRSRAN_UCI_MAX_ACK_BITS);
   } else if (!strcmp(param, "enable_64qam")) {
     enable_64_qam ^= true;
+  } else if (!strcmp(param, "fec_threads")) {
+    nof_fec = (uint32_t)strtol(arg, NULL, 10);
   } else {
     ext_code = SRSRAN_ERROR;
   }
@@ -185,6 +189,7 @@ int main(int argc, char** argv)
   srsran_chest_ul_res_t  chest_res  = {};
   srsran_pusch_t         pusch_tx   = {};
   srsran_pusch_t         pusch_rx   = {};
+  srsran_fec_pool_t      fec_pool   = {};
   uint8_t*               data       = NULL;
   uint8_t*               data_rx    = NULL;
   cf_t*                  sf_symbols = NULL;
@@ -243,6 +248,13 @@ int main(int argc, char** argv)
     ERROR("Error creating PUSCH object");
     goto quit;
   }
+  if (nof_fec > 0) {
+    if (srsran_sch_fec_pool_init(&fec_pool, nof_fec)) {
+      ERROR("Error creating FEC pool");
+      goto quit;
+    }
+    srsran_sch_set_fec_pool(&pusch_rx.ul_sch, &fec_pool);
+  }
 
   uint16_t rnti = 62;
   dci.rnti      = rnti;
@@ -403,6 +415,7 @@ quit:
   srsran_chest_ul_res_free(&chest_res);
   srsran_pusch_free(&pusch_tx);
   srsran_pusch_free(&pusch_rx);
+  srsran_fec_pool_free(&fec_pool);
   srsran_softbuffer_tx_free(&softbuffer_tx);
   srsran_softbuffer_rx_free(&softbuffer_rx);
   srsran_random_free(random_h);
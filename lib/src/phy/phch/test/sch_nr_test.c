@@ -32,6 +32,7 @@ static srsran_carrier_nr_t carrier = SRSRAN_DEFAULT_CARRIER_NR;
 static uint32_t            n_prb     = 0;  // Set to 0 for steering
 static uint32_t            mcs       = 30; // Set to 30 for steering
 static uint32_t            rv        = 4;  // Set to 30 for steering
+static uint32_t            nof_fec   = 0;  // Set to 0 for decoding in the main thread
 static srsran_sch_cfg_nr_t pdsch_cfg = {};
 
 static void usage(char* prog)
@@ -44,13 +45,14 @@ static void usage(char* prog)
   printf("\t-T Provide MCS table (64qam, 256qam, 64qamLowSE) [Default %s]\n",
          srsran_mcs_table_to_str(pdsch_cfg.sch_cfg.mcs_table));
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
+  printf("\t-F Number of FEC pool threads, set to 0 for decoding in the main thread [Default %d]\n", nof_fec);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "PpmTLvr")) != -1) {
+  while ((opt = getopt(argc, argv, "PpmTLFvr")) != -1) {
     switch (opt) {
       case 'P':
         carrier.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -70,6 +72,9 @@ int parse_args(int argc, char** argv)
       case 'L':
         carrier.max_mimo_layers = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'F':
+        nof_fec = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -84,10 +89,11 @@ int parse_args(int argc, char** argv)
 
 int main(int argc, char** argv)
 {
-  int             ret       = SRSRAN_ERROR;
-  srsran_sch_nr_t sch_nr_tx = {};
-  srsran_sch_nr_t sch_nr_rx = {};
-  srsran_random_t rand_gen  = srsran_random_init(1234);
+  int               ret       = SRSRAN_ERROR;
+  srsran_sch_nr_t   sch_nr_tx = {};
+  srsran_sch_nr_t   sch_nr_rx = {};
+  srsran_fec_pool_t fec_pool  = {};
+  srsran_random_t   rand_gen  = srsran_random_init(1234);
 
   uint8_t* data_tx = srsran_vec_u8_malloc(1024 * 1024);
   uint8_t* encoded = srsran_vec_u8_malloc(1024 * 1024 * 8);
@@ -120,6 +126,14 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
+  if (nof_fec > 0) {
+    if (srsran_sch_nr_fec_pool_init(&fec_pool, nof_fec, &args) < SRSRAN_SUCCESS) {
+      ERROR("Error initiating FEC pool");
+      goto clean_exit;
+    }
+    srsran_sch_nr_set_fec_pool(&sch_nr_rx, &fec_pool);
+  }
+
   if (srsran_sch_nr_set_carrier(&sch_nr_tx, &carrier)) {
     ERROR("Error setting SCH NR carrier");
     goto clean_exit;
@@ -240,6 +254,7 @@ clean_exit:
   srsran_random_free(rand_gen);
   srsran_sch_nr_free(&sch_nr_tx);
   srsran_sch_nr_free(&sch_nr_rx);
+  srsran_fec_pool_free(&fec_pool);
   if (data_tx) {
     free(data_tx);
   }
@@ -0,0 +1,1000 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp.h"
+#include "rf_helper.h"
+#include "rf_plugin.h"
+#include "rf_shm_imp_trx.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <srsran/phy/common/phy_common.h>
+#include <srsran/phy/common/timestamp.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+typedef struct {
+  // Common attributes
+  srsran_rf_info_t info;
+  uint32_t         nof_channels;
+
+  // RF State
+  uint32_t srate; // radio rate configured by upper layers
+  uint32_t base_srate;
+  uint32_t decim_factor; // decimation factor between base_srate used on transport on radio's rate
+  double   rx_gain;
+  double   tx_gain;
+  uint32_t tx_freq_mhz[SRSRAN_MAX_CHANNELS];
+  uint32_t rx_freq_mhz[SRSRAN_MAX_CHANNELS];
+  bool     tx_off;
+  char     id[RF_PARAM_LEN];
+
+  // Rings
+  rf_shm_tx_t transmitter[SRSRAN_MAX_CHANNELS];
+  rf_shm_rx_t receiver[SRSRAN_MAX_CHANNELS];
+
+  // Rx timestamp, it is shared with the peers through the rings
+  uint64_t next_rx_ts;
+
+  // Error handler
+  srsran_rf_error_handler_t error_handler;
+  void*                     error_handler_arg;
+
+  pthread_mutex_t tx_config_mutex;
+  pthread_mutex_t rx_config_mutex;
+  pthread_mutex_t decim_mutex;
+  pthread_mutex_t rx_gain_mutex;
+} rf_shm_handler_t;
+
+static void update_rates(rf_shm_handler_t* handler, double srate);
+
+/*
+ * Static Atributes
+ */
+const char shm_devname[4] = "shm";
+
+static uint32_t shm_token_counter = 0;
+
+/*
+ * Static methods
+ */
+
+void rf_shm_info(char* id, const char* format, ...)
+{
+#if VERBOSE
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  va_list args;
+  va_start(args, format);
+  printf("[%s@%02ld.%06ld] ", id ? id : "shm", t.tv_sec % 10, t.tv_usec);
+  vprintf(format, args);
+  va_end(args);
+#else  /* VERBOSE */
+  // Do nothing
+#endif /* VERBOSE */
+}
+
+void rf_shm_error(char* id, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "[shm] %s: ", id ? id : "shm");
+  vfprintf(stderr, format, args);
+  va_end(args);
+}
+
+static void rf_shm_report(rf_shm_handler_t* handler, int type, int opt)
+{
+  if (handler->error_handler) {
+    srsran_rf_error_t error = {};
+    error.type              = type;
+    error.opt               = opt;
+    handler->error_handler(handler->error_handler_arg, error);
+  }
+}
+
+static inline int update_ts(void* h, uint64_t* ts, int nsamples, const char* dir)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (h && nsamples > 0) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+    (*ts) += nsamples;
+
+    srsran_timestamp_t _ts = {};
+    srsran_timestamp_init_uint64(&_ts, *ts, handler->base_srate);
+    rf_shm_info(
+        handler->id, "    -> next %s time after %d samples: %d + %.3f\n", dir, nsamples, _ts.full_secs, _ts.frac_secs);
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+  return ret;
+}
+
+/*
+ * Ring methods
+ */
+
+int rf_shm_ring_open(rf_shm_ring_t* q, const char* name, uint32_t ring_size)
+{
+  int   ret  = SRSRAN_ERROR;
+  int   fd   = -1;
+  void* base = MAP_FAILED;
+
+  bzero(q, sizeof(rf_shm_ring_t));
+  q->slot = -1;
+
+  // POSIX shared memory object names start with a slash
+  snprintf(q->name, RF_PARAM_LEN, "%s%s", (name[0] == '/') ? "" : "/", name);
+
+  if (ring_size < SHM_RING_SIZE_MIN || (ring_size & (ring_size - 1)) != 0) {
+    fprintf(stderr, "[shm] Error: ring size %d must be a power of two not below %d\n", ring_size, SHM_RING_SIZE_MIN);
+    return SRSRAN_ERROR;
+  }
+
+  fd = shm_open(q->name, O_RDWR | O_CREAT, 0666);
+  if (fd < 0) {
+    fprintf(stderr, "[shm] Error: opening %s: %s\n", q->name, strerror(errno));
+    goto clean_exit;
+  }
+
+  size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  q->hdr_size      = SRSRAN_CEIL(sizeof(rf_shm_ring_hdr_t), page_size) * page_size;
+
+  // The first user of the ring sets its size, the others adopt it
+  struct stat st = {};
+  if (fstat(fd, &st) < 0) {
+    fprintf(stderr, "[shm] Error: reading size of %s: %s\n", q->name, strerror(errno));
+    goto clean_exit;
+  }
+  if (st.st_size == 0) {
+    if (ftruncate(fd, (off_t)(q->hdr_size + ring_size * sizeof(cf_t))) < 0) {
+      fprintf(stderr, "[shm] Error: resizing %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+  } else {
+    ring_size = (uint32_t)(((size_t)st.st_size - SRSRAN_MIN((size_t)st.st_size, q->hdr_size)) / sizeof(cf_t));
+    if (ring_size < SHM_RING_SIZE_MIN || (ring_size & (ring_size - 1)) != 0) {
+      fprintf(stderr, "[shm] Error: %s is not a valid ring, remove it from /dev/shm\n", q->name);
+      goto clean_exit;
+    }
+  }
+  q->nof_samples = ring_size;
+
+  q->hdr = mmap(NULL, q->hdr_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (q->hdr == MAP_FAILED) {
+    q->hdr = NULL;
+    fprintf(stderr, "[shm] Error: mapping %s: %s\n", q->name, strerror(errno));
+    goto clean_exit;
+  }
+
+  // Map the samples twice back to back, so that any access of up to nof_samples is contiguous
+  size_t data_size = ring_size * sizeof(cf_t);
+  base             = mmap(NULL, 2 * data_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    fprintf(stderr, "[shm] Error: reserving memory for %s: %s\n", q->name, strerror(errno));
+    goto clean_exit;
+  }
+  for (uint32_t i = 0; i < 2; i++) {
+    void* ptr = (uint8_t*)base + i * data_size;
+    if (mmap(ptr, data_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, (off_t)q->hdr_size) != ptr) {
+      fprintf(stderr, "[shm] Error: mapping samples of %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+  }
+  q->data = (cf_t*)base;
+  base    = MAP_FAILED;
+
+  // A new ring is zero filled, which is a valid empty state once it is marked
+  uint64_t magic = 0;
+  if (!__atomic_compare_exchange_n(&q->hdr->magic, &magic, SHM_MAGIC, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) &&
+      magic != SHM_MAGIC) {
+    fprintf(stderr, "[shm] Error: %s is not a valid ring, remove it from /dev/shm\n", q->name);
+    goto clean_exit;
+  }
+
+  rf_shm_info(NULL, "Opened ring %s with %d samples\n", q->name, q->nof_samples);
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  if (base != MAP_FAILED) {
+    munmap(base, 2 * ring_size * sizeof(cf_t));
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (ret) {
+    rf_shm_ring_close(q);
+  }
+  return ret;
+}
+
+void rf_shm_ring_close(rf_shm_ring_t* q)
+{
+  if (q->data) {
+    munmap(q->data, 2 * q->nof_samples * sizeof(cf_t));
+    q->data = NULL;
+  }
+  if (q->hdr) {
+    munmap(q->hdr, q->hdr_size);
+    q->hdr = NULL;
+  }
+}
+
+uint64_t rf_shm_ring_get_write_ts(rf_shm_ring_t* q)
+{
+  return __atomic_load_n(&q->hdr->write_ts, __ATOMIC_ACQUIRE);
+}
+
+bool rf_shm_ring_has_producer(rf_shm_ring_t* q)
+{
+  return __atomic_load_n(&q->hdr->producer, __ATOMIC_ACQUIRE) != 0;
+}
+
+int rf_shm_ring_wait(uint32_t* seq, uint32_t* waiters, uint32_t value, uint32_t timeout_us)
+{
+  // The waiter count is raised before sleeping, a wake up issued after reading value is never lost: either the
+  // sequence counter has already changed and the futex returns immediately, or the waker sees the waiter
+  __atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+#ifdef __linux__
+  struct timespec timeout = {timeout_us / 1000000, (timeout_us % 1000000) * 1000};
+  syscall(SYS_futex, seq, FUTEX_WAIT, value, &timeout, NULL, 0);
+#else  /* __linux__ */
+  if (__atomic_load_n(seq, __ATOMIC_SEQ_CST) == value) {
+    usleep(SRSRAN_MIN(timeout_us, 100));
+  }
+#endif /* __linux__ */
+  __atomic_fetch_sub(waiters, 1, __ATOMIC_SEQ_CST);
+  return SRSRAN_SUCCESS;
+}
+
+void rf_shm_ring_wake(uint32_t* seq, uint32_t* waiters)
+{
+  __atomic_fetch_add(seq, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) {
+#ifdef __linux__
+    syscall(SYS_futex, seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif /* __linux__ */
+  }
+}
+
+bool rf_shm_owner_is_alive(uint64_t owner)
+{
+  if (owner == 0) {
+    return false;
+  }
+  pid_t pid = (pid_t)(owner >> 32U);
+  return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+uint64_t rf_shm_new_token(void)
+{
+  uint32_t count = __atomic_add_fetch(&shm_token_counter, 1, __ATOMIC_RELAXED);
+  return ((uint64_t)getpid() << 32U) | count;
+}
+
+/*
+ * Public methods
+ */
+
+void rf_shm_suppress_stdout(void* h)
+{
+  // do nothing
+}
+
+void rf_shm_register_error_handler(void* h, srsran_rf_error_handler_t new_handler, void* arg)
+{
+  if (h) {
+    rf_shm_handler_t* handler  = (rf_shm_handler_t*)h;
+    handler->error_handler     = new_handler;
+    handler->error_handler_arg = arg;
+  }
+}
+
+const char* rf_shm_devname(void* h)
+{
+  return shm_devname;
+}
+
+int rf_shm_start_rx_stream(void* h, bool now)
+{
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_stop_rx_stream(void* h)
+{
+  return SRSRAN_SUCCESS;
+}
+
+void rf_shm_flush_buffer(void* h)
+{
+  // do nothing
+}
+
+bool rf_shm_has_rssi(void* h)
+{
+  return false;
+}
+
+float rf_shm_get_rssi(void* h)
+{
+  return 0.0;
+}
+
+int rf_shm_open(char* args, void** h)
+{
+  return rf_shm_open_multi(args, h, 1);
+}
+
+static void parse_bool(char* args, const char* config_arg_base, int channel_index, bool* value)
+{
+  char tmp[RF_PARAM_LEN] = {};
+  if (parse_string(args, config_arg_base, channel_index, tmp) == SRSRAN_SUCCESS) {
+    *value = strncmp(tmp, "true", RF_PARAM_LEN) == 0 || strncmp(tmp, "yes", RF_PARAM_LEN) == 0;
+  }
+}
+
+int rf_shm_open_multi(char* args, void** h, uint32_t nof_channels)
+{
+  int ret = SRSRAN_ERROR;
+  if (h && nof_channels <= SRSRAN_MAX_CHANNELS) {
+    *h = NULL;
+
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)malloc(sizeof(rf_shm_handler_t));
+    if (!handler) {
+      perror("malloc");
+      return SRSRAN_ERROR;
+    }
+    bzero(handler, sizeof(rf_shm_handler_t));
+    *h                        = handler;
+    handler->base_srate       = SHM_BASERATE_DEFAULT_HZ; // Sample rate for 100 PRB cell
+    handler->rx_gain          = 0.0;
+    handler->info.max_rx_gain = SHM_MAX_GAIN_DB;
+    handler->info.min_rx_gain = SHM_MIN_GAIN_DB;
+    handler->info.max_tx_gain = SHM_MAX_GAIN_DB;
+    handler->info.min_tx_gain = SHM_MIN_GAIN_DB;
+    handler->nof_channels     = nof_channels;
+    strcpy(handler->id, "shm\0");
+
+    if (pthread_mutex_init(&handler->tx_config_mutex, NULL)) {
+      perror("Mutex init");
+    }
+    if (pthread_mutex_init(&handler->rx_config_mutex, NULL)) {
+      perror("Mutex init");
+    }
+    if (pthread_mutex_init(&handler->decim_mutex, NULL)) {
+      perror("Mutex init");
+    }
+    if (pthread_mutex_init(&handler->rx_gain_mutex, NULL)) {
+      perror("Mutex init");
+    }
+
+    rf_shm_opts_t rx_opts = {};
+    rf_shm_opts_t tx_opts = {};
+    rx_opts.id            = handler->id;
+    tx_opts.id            = handler->id;
+    rx_opts.ring_size     = SHM_RING_SIZE_DEFAULT;
+    rx_opts.nof_fanin     = 1;
+
+    // parse args
+    if (args && strlen(args)) {
+      // base_srate
+      parse_uint32(args, "base_srate", -1, &handler->base_srate);
+
+      // id
+      parse_string(args, "id", -1, handler->id);
+
+      // ring_size
+      parse_uint32(args, "ring_size", -1, &rx_opts.ring_size);
+
+      // rx_fanin
+      parse_uint32(args, "rx_fanin", -1, &rx_opts.nof_fanin);
+      if (rx_opts.nof_fanin == 0 || rx_opts.nof_fanin > SHM_MAX_FANIN) {
+        fprintf(stderr, "[shm] Error: rx_fanin must be between 1 and %d\n", SHM_MAX_FANIN);
+        goto clean_exit;
+      }
+
+      // Options for all channels, a channel index overrides them for that channel
+      rx_opts.trx_timeout_ms = SHM_TIMEOUT_MS;
+      parse_uint32(args, "trx_timeout_ms", -1, &rx_opts.trx_timeout_ms);
+      parse_bool(args, "fail_on_disconnect", -1, &rx_opts.fail_on_disconnect);
+      parse_bool(args, "log_trx_timeout", -1, &rx_opts.log_trx_timeout);
+    } else {
+      fprintf(stderr,
+              "[shm] Error: No device 'args' option has been set. Please make sure to set this option to be able to "
+              "use the shared memory no-RF module\n");
+      goto clean_exit;
+    }
+    tx_opts.ring_size = rx_opts.ring_size;
+
+    update_rates(handler, 1.92e6);
+
+    for (int i = 0; i < handler->nof_channels; i++) {
+      // rx_shm
+      char rx_name[RF_PARAM_LEN] = {};
+      parse_string(args, "rx_shm", i, rx_name);
+
+      // rx_freq
+      double rx_freq = 0.0f;
+      parse_double(args, "rx_freq", i, &rx_freq);
+      rx_opts.frequency_mhz = (uint32_t)(rx_freq / 1e6);
+
+      // tx_shm
+      char tx_name[RF_PARAM_LEN] = {};
+      parse_string(args, "tx_shm", i, tx_name);
+
+      // tx_freq
+      double tx_freq = 0.0f;
+      parse_double(args, "tx_freq", i, &tx_freq);
+      tx_opts.frequency_mhz = (uint32_t)(tx_freq / 1e6);
+
+      // fail_on_disconnect, trx_timeout_ms and log_trx_timeout
+      rf_shm_opts_t ch_rx_opts = rx_opts;
+      parse_bool(args, "fail_on_disconnect", i, &ch_rx_opts.fail_on_disconnect);
+      parse_uint32(args, "trx_timeout_ms", i, &ch_rx_opts.trx_timeout_ms);
+      parse_bool(args, "log_trx_timeout", i, &ch_rx_opts.log_trx_timeout);
+      tx_opts.trx_timeout_ms  = ch_rx_opts.trx_timeout_ms;
+      tx_opts.log_trx_timeout = ch_rx_opts.log_trx_timeout;
+
+      // initialize transmitter
+      if (strlen(tx_name) != 0) {
+        if (rf_shm_tx_open(&handler->transmitter[i], tx_opts, tx_name) != SRSRAN_SUCCESS) {
+          fprintf(stderr, "[shm] Error: opening transmitter\n");
+          goto clean_exit;
+        }
+      } else {
+        fprintf(stdout, "[shm] %s Tx ring not specified. Disabling transmitter.\n", handler->id);
+        handler->tx_off = true;
+      }
+
+      // initialize receiver
+      if (strlen(rx_name) != 0) {
+        if (rf_shm_rx_open(&handler->receiver[i], ch_rx_opts, rx_name) != SRSRAN_SUCCESS) {
+          fprintf(stderr, "[shm] Error: opening receiver\n");
+          goto clean_exit;
+        }
+      } else {
+        fprintf(stdout, "[shm] %s Rx ring not specified. Disabling receiver.\n", handler->id);
+      }
+
+      if (!handler->transmitter[i].running && !handler->receiver[i].running) {
+        fprintf(stderr, "[shm] Error: Neither Tx ring nor Rx ring specified.\n");
+        goto clean_exit;
+      }
+    }
+
+    // All the rings share one clock. Join at the latest time seen in any of them, the transmitters restart their
+    // streams there and the receivers start reading there
+    uint64_t clock = 0;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      if (rf_shm_tx_is_running(&handler->transmitter[i])) {
+        clock = SRSRAN_MAX(clock, rf_shm_tx_get_nsamples(&handler->transmitter[i]));
+      }
+      if (rf_shm_rx_is_running(&handler->receiver[i])) {
+        clock = SRSRAN_MAX(clock, rf_shm_rx_get_clock(&handler->receiver[i]));
+      }
+    }
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      if (rf_shm_rx_is_running(&handler->receiver[i]) &&
+          rf_shm_rx_register(&handler->receiver[i], clock) != SRSRAN_SUCCESS) {
+        fprintf(stderr, "[shm] Error: registering receiver\n");
+        goto clean_exit;
+      }
+      if (rf_shm_tx_is_running(&handler->transmitter[i])) {
+        rf_shm_tx_sync(&handler->transmitter[i], clock);
+      }
+    }
+    handler->next_rx_ts = clock;
+
+    ret = SRSRAN_SUCCESS;
+
+  clean_exit:
+    if (ret) {
+      rf_shm_close(handler);
+      *h = NULL;
+    }
+  }
+  return ret;
+}
+
+int rf_shm_close(void* h)
+{
+  rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+  rf_shm_info(handler->id, "Closing ...\n");
+
+  for (int i = 0; i < handler->nof_channels; i++) {
+    rf_shm_tx_close(&handler->transmitter[i]);
+    rf_shm_rx_close(&handler->receiver[i]);
+  }
+
+  pthread_mutex_destroy(&handler->tx_config_mutex);
+  pthread_mutex_destroy(&handler->rx_config_mutex);
+  pthread_mutex_destroy(&handler->decim_mutex);
+  pthread_mutex_destroy(&handler->rx_gain_mutex);
+
+  // Free all
+  free(handler);
+
+  return SRSRAN_SUCCESS;
+}
+
+void update_rates(rf_shm_handler_t* handler, double srate)
+{
+  pthread_mutex_lock(&handler->decim_mutex);
+  if (handler) {
+    // Decimation must be full integer
+    if (((uint64_t)handler->base_srate % (uint64_t)srate) == 0) {
+      handler->srate        = (uint32_t)srate;
+      handler->decim_factor = handler->base_srate / handler->srate;
+    } else {
+      fprintf(stderr,
+              "Error: couldn't update sample rate. %.2f is not divisible by %.2f\n",
+              srate / 1e6,
+              handler->base_srate / 1e6);
+    }
+    printf("Current sample rate is %.2f MHz with a base rate of %.2f MHz (x%d decimation)\n",
+           handler->srate / 1e6,
+           handler->base_srate / 1e6,
+           handler->decim_factor);
+  }
+  pthread_mutex_unlock(&handler->decim_mutex);
+}
+
+double rf_shm_set_rx_srate(void* h, double srate)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    update_rates(handler, srate);
+    ret = handler->srate;
+  }
+  return ret;
+}
+
+double rf_shm_set_tx_srate(void* h, double srate)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    update_rates(handler, srate);
+    ret = srate;
+  }
+  return ret;
+}
+
+int rf_shm_set_rx_gain(void* h, double gain)
+{
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->rx_gain_mutex);
+    handler->rx_gain = gain;
+    pthread_mutex_unlock(&handler->rx_gain_mutex);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_set_rx_gain_ch(void* h, uint32_t ch, double gain)
+{
+  return rf_shm_set_rx_gain(h, gain);
+}
+
+int rf_shm_set_tx_gain(void* h, double gain)
+{
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    handler->tx_gain = gain;
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_set_tx_gain_ch(void* h, uint32_t ch, double gain)
+{
+  return rf_shm_set_tx_gain(h, gain);
+}
+
+double rf_shm_get_rx_gain(void* h)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->rx_gain_mutex);
+    ret = handler->rx_gain;
+    pthread_mutex_unlock(&handler->rx_gain_mutex);
+  }
+  return ret;
+}
+
+double rf_shm_get_tx_gain(void* h)
+{
+  double ret = NAN;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    ret = handler->tx_gain;
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+  }
+  return ret;
+}
+
+srsran_rf_info_t* rf_shm_get_info(void* h)
+{
+  srsran_rf_info_t* info = NULL;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    info                      = &handler->info;
+  }
+  return info;
+}
+
+double rf_shm_set_rx_freq(void* h, uint32_t ch, double freq)
+{
+  double ret = NAN;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->rx_config_mutex);
+    if (ch < handler->nof_channels && isnormal(freq) && freq > 0.0) {
+      handler->rx_freq_mhz[ch] = (uint32_t)(freq / 1e6);
+      ret                      = freq;
+    }
+    pthread_mutex_unlock(&handler->rx_config_mutex);
+  }
+  return ret;
+}
+
+double rf_shm_set_tx_freq(void* h, uint32_t ch, double freq)
+{
+  double ret = NAN;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    if (ch < handler->nof_channels && isnormal(freq) && freq > 0.0) {
+      handler->tx_freq_mhz[ch] = (uint32_t)(freq / 1e6);
+      ret                      = freq;
+    }
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+  }
+  return ret;
+}
+
+void rf_shm_get_time(void* h, time_t* secs, double* frac_secs)
+{
+  if (h) {
+    rf_shm_handler_t*  handler = (rf_shm_handler_t*)h;
+    srsran_timestamp_t ts      = {};
+    srsran_timestamp_init_uint64(&ts, handler->next_rx_ts, handler->base_srate);
+
+    if (secs) {
+      *secs = ts.full_secs;
+    }
+
+    if (frac_secs) {
+      *frac_secs = ts.frac_secs;
+    }
+  }
+}
+
+int rf_shm_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+{
+  return rf_shm_recv_with_time_multi(h, &data, nsamples, blocking, secs, frac_secs);
+}
+
+int rf_shm_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+    // Map ports to data buffers according to the selected frequencies
+    pthread_mutex_lock(&handler->rx_config_mutex);
+    bool  mapped[SRSRAN_MAX_CHANNELS]  = {}; // Mapped mask, set to true when the physical channel is used
+    cf_t* buffers[SRSRAN_MAX_CHANNELS] = {}; // Buffer pointers, NULL if unmatched
+
+    // For each logical channel...
+    for (uint32_t logical = 0; logical < handler->nof_channels; logical++) {
+      bool unmatched = true;
+
+      // For each physical channel...
+      for (uint32_t physical = 0; physical < handler->nof_channels; physical++) {
+        // Consider a match if the physical channel is NOT mapped and the frequency match
+        if (!mapped[physical] && rf_shm_rx_match_freq(&handler->receiver[physical], handler->rx_freq_mhz[logical])) {
+          // Not mapped and matched frequency with receiver
+          buffers[physical] = (cf_t*)data[logical];
+          mapped[physical]  = true;
+          unmatched         = false;
+          break;
+        }
+      }
+
+      // If no matching frequency found; set data to zeros
+      if (unmatched) {
+        srsran_vec_zero(data[logical], nsamples);
+      }
+    }
+    pthread_mutex_unlock(&handler->rx_config_mutex);
+
+    // Protect the access to decim_factor since is a shared variable
+    pthread_mutex_lock(&handler->decim_mutex);
+    uint32_t decim_factor = handler->decim_factor;
+    pthread_mutex_unlock(&handler->decim_mutex);
+
+    uint32_t nsamples_baserate = nsamples * decim_factor;
+
+    rf_shm_info(handler->id, "Rx %d samples\n", nsamples);
+
+    // set timestamp for this reception
+    if (secs != NULL && frac_secs != NULL) {
+      srsran_timestamp_t ts = {};
+      srsran_timestamp_init_uint64(&ts, handler->next_rx_ts, handler->base_srate);
+      *secs      = ts.full_secs;
+      *frac_secs = ts.frac_secs;
+    }
+
+    // return if receiver is turned off
+    if (!rf_shm_rx_is_running(&handler->receiver[0])) {
+      update_ts(handler, &handler->next_rx_ts, nsamples_baserate, "rx");
+      return nsamples;
+    }
+
+    // Check ring size, a read cannot span more than half of it
+    if (nsamples_baserate > handler->receiver[0].ring[0].nof_samples / 2) {
+      fprintf(stderr,
+              "[shm] Error: Trying to receive %d samples but the ring only has %d.\n",
+              nsamples_baserate,
+              handler->receiver[0].ring[0].nof_samples);
+      goto clean_exit;
+    }
+
+    // Bring the own transmitters up to the end of this reception, the peers may be waiting for them
+    for (int i = 0; i < handler->nof_channels; i++) {
+      if (rf_shm_tx_is_running(&handler->transmitter[i])) {
+        rf_shm_tx_align(&handler->transmitter[i], handler->next_rx_ts + nsamples_baserate);
+      }
+    }
+
+    // Rx gain, the scale shall also incorporate decim_factor
+    pthread_mutex_lock(&handler->rx_gain_mutex);
+    float scale = srsran_convert_dB_to_amplitude(handler->rx_gain);
+    pthread_mutex_unlock(&handler->rx_gain_mutex);
+    if (decim_factor > 0) {
+      scale = scale / decim_factor;
+    }
+
+    // Read, sum and decimate each channel straight from the rings into the provided buffers
+    uint32_t nof_producers = 0;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      rf_shm_rx_t* receiver = &handler->receiver[i];
+      if (!rf_shm_rx_is_running(receiver)) {
+        continue;
+      }
+
+      uint32_t nof_overflows = receiver->nof_overflows;
+      int      n             = SRSRAN_ERROR_TIMEOUT;
+      while (n == SRSRAN_ERROR_TIMEOUT) {
+        n = rf_shm_rx_baseband(receiver, handler->next_rx_ts, buffers[i], nsamples, decim_factor, scale);
+        if (n == SRSRAN_ERROR_TIMEOUT) {
+          if (receiver->log_trx_timeout) {
+            fprintf(stderr, "Error: timeout receiving samples after %dms\n", receiver->trx_timeout_ms);
+          }
+          // Other end disconnected, either keep going, or fail
+          if (receiver->fail_on_disconnect) {
+            goto clean_exit;
+          }
+        } else if (n < SRSRAN_SUCCESS) {
+          // Other error, exit
+          fprintf(stderr, "Error: receiving data.\n");
+          goto clean_exit;
+        }
+      }
+      nof_producers += (uint32_t)n;
+
+      if (receiver->nof_overflows != nof_overflows) {
+        rf_shm_report(handler, SRSRAN_RF_ERROR_OVERFLOW, (int)(receiver->nof_overflows - nof_overflows));
+      }
+    }
+
+    // Without any peer, pace the stream in real time rather than spinning through it
+    if (nof_producers == 0) {
+      usleep((1000000UL * nsamples_baserate) / handler->base_srate);
+    }
+
+    // update rx time
+    update_ts(handler, &handler->next_rx_ts, nsamples_baserate, "rx");
+  }
+
+  ret = nsamples;
+
+clean_exit:
+
+  return ret;
+}
+
+int rf_shm_send_timed(void*  h,
+                      void*  data,
+                      int    nsamples,
+                      time_t secs,
+                      double frac_secs,
+                      bool   has_time_spec,
+                      bool   blocking,
+                      bool   is_start_of_burst,
+                      bool   is_end_of_burst)
+{
+  void* _data[4] = {data, NULL, NULL, NULL};
+
+  return rf_shm_send_timed_multi(
+      h, _data, nsamples, secs, frac_secs, has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
+}
+
+int rf_shm_send_timed_multi(void*  h,
+                            void*  data[4],
+                            int    nsamples,
+                            time_t secs,
+                            double frac_secs,
+                            bool   has_time_spec,
+                            bool   blocking,
+                            bool   is_start_of_burst,
+                            bool   is_end_of_burst)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (h && data && nsamples > 0) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+    // Map ports to data buffers according to the selected frequencies
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    bool  mapped[SRSRAN_MAX_CHANNELS]  = {}; // Mapped mask, set to true when the physical channel is used
+    cf_t* buffers[SRSRAN_MAX_CHANNELS] = {}; // Buffer pointers, NULL if unmatched or zero transmission
+
+    // For each logical channel...
+    for (uint32_t logical = 0; logical < handler->nof_channels; logical++) {
+      // For each physical channel...
+      for (uint32_t physical = 0; physical < handler->nof_channels; physical++) {
+        // Consider a match if the physical channel is NOT mapped and the frequency match
+        if (!mapped[physical] && rf_shm_tx_match_freq(&handler->transmitter[physical], handler->tx_freq_mhz[logical])) {
+          // Not mapped and matched frequency with receiver
+          buffers[physical] = (cf_t*)data[logical];
+          mapped[physical]  = true;
+          break;
+        }
+      }
+    }
+
+    // Load transmission gain
+    float tx_gain = srsran_convert_dB_to_amplitude(handler->tx_gain);
+
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+
+    // If the Tx gain is NAN, INF or 0.0, use 1.0
+    if (!isnormal(tx_gain)) {
+      tx_gain = 1.0f;
+    }
+
+    // Protect the access to decim_factor since is a shared variable
+    pthread_mutex_lock(&handler->decim_mutex);
+    uint32_t decim_factor = handler->decim_factor;
+    pthread_mutex_unlock(&handler->decim_mutex);
+
+    rf_shm_info(handler->id, "Tx %d samples\n", nsamples);
+
+    // return if transmitter is switched off
+    if (handler->tx_off) {
+      return SRSRAN_SUCCESS;
+    }
+
+    // check if this is a tx in the future
+    if (has_time_spec) {
+      rf_shm_info(handler->id, "    - tx time: %d + %.3f\n", secs, frac_secs);
+
+      srsran_timestamp_t ts = {};
+      srsran_timestamp_init(&ts, secs, frac_secs);
+      uint64_t tx_ts              = srsran_timestamp_uint64(&ts, handler->base_srate);
+      int      num_tx_gap_samples = 0;
+
+      for (int i = 0; i < handler->nof_channels; i++) {
+        if (rf_shm_tx_is_running(&handler->transmitter[i])) {
+          num_tx_gap_samples = rf_shm_tx_align(&handler->transmitter[i], tx_ts);
+        }
+      }
+
+      if (num_tx_gap_samples < 0) {
+        fprintf(stderr,
+                "[shm] Error: tx time is %.3f ms in the past (%" PRIu64 " < %" PRIu64 ")\n",
+                -1000.0 * num_tx_gap_samples / handler->base_srate,
+                tx_ts,
+                rf_shm_tx_get_nsamples(&handler->transmitter[0]));
+        rf_shm_report(handler, SRSRAN_RF_ERROR_LATE, -num_tx_gap_samples);
+        goto clean_exit;
+      }
+    }
+
+    // Write the base-band samples straight into the rings, interpolating and scaling on the way
+    for (int i = 0; i < handler->nof_channels; i++) {
+      if (rf_shm_tx_is_running(&handler->transmitter[i]) &&
+          rf_shm_tx_baseband(&handler->transmitter[i], buffers[i], nsamples, tx_gain, decim_factor) == SRSRAN_ERROR) {
+        goto clean_exit;
+      }
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+
+  return ret;
+}
+
+rf_dev_t srsran_rf_dev_shm = {"shm",
+                              rf_shm_devname,
+                              rf_shm_start_rx_stream,
+                              rf_shm_stop_rx_stream,
+                              rf_shm_flush_buffer,
+                              rf_shm_has_rssi,
+                              rf_shm_get_rssi,
+                              rf_shm_suppress_stdout,
+                              rf_shm_register_error_handler,
+                              rf_shm_open,
+                              .srsran_rf_open_multi = rf_shm_open_multi,
+                              rf_shm_close,
+                              rf_shm_set_rx_srate,
+                              rf_shm_set_rx_gain,
+                              rf_shm_set_rx_gain_ch,
+                              rf_shm_set_tx_gain,
+                              rf_shm_set_tx_gain_ch,
+                              rf_shm_get_rx_gain,
+                              rf_shm_get_tx_gain,
+                              rf_shm_get_info,
+                              rf_shm_set_rx_freq,
+                              rf_shm_set_tx_srate,
+                              rf_shm_set_tx_freq,
+                              rf_shm_get_time,
+                              NULL,
+                              rf_shm_recv_with_time,
+                              rf_shm_recv_with_time_multi,
+                              rf_shm_send_timed,
+                              .srsran_rf_send_timed_multi = rf_shm_send_timed_multi};
+
+#ifdef ENABLE_RF_PLUGINS
+int register_plugin(rf_dev_t** rf_api)
+{
+  if (rf_api == NULL) {
+    return SRSRAN_ERROR;
+  }
+  *rf_api = &srsran_rf_dev_shm;
+  return SRSRAN_SUCCESS;
+}
+#endif /* ENABLE_RF_PLUGINS */
@@ -0,0 +1,306 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <inttypes.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SHM_RX_WAIT_US (1000)
+
+int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, const char* name)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (q) {
+    // Zero object
+    bzero(q, sizeof(rf_shm_rx_t));
+
+    // Copy id
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->id[SHM_ID_STRLEN - 1] = '\0';
+
+    q->frequency_mhz      = opts.frequency_mhz;
+    q->fail_on_disconnect = opts.fail_on_disconnect;
+    q->trx_timeout_ms     = opts.trx_timeout_ms;
+    q->log_trx_timeout    = opts.log_trx_timeout;
+    q->nof_rings          = SRSRAN_MAX(opts.nof_fanin, 1);
+
+    // With fan-in, every transmitter has its own ring named after the receiver one and the transmitter index
+    for (uint32_t i = 0; i < q->nof_rings; i++) {
+      char ring_name[RF_PARAM_LEN] = {};
+      if (q->nof_rings > 1) {
+        snprintf(ring_name, RF_PARAM_LEN, "%s.%d", name, i);
+      } else {
+        snprintf(ring_name, RF_PARAM_LEN, "%s", name);
+      }
+
+      rf_shm_info(q->id, "Opening receiver: %s\n", ring_name);
+
+      if (rf_shm_ring_open(&q->ring[i], ring_name, opts.ring_size) != SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+    }
+
+    q->running = true;
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  if (ret && q) {
+    rf_shm_rx_close(q);
+  }
+  return ret;
+}
+
+uint64_t rf_shm_rx_get_clock(rf_shm_rx_t* q)
+{
+  uint64_t clock = 0;
+  for (uint32_t i = 0; i < q->nof_rings; i++) {
+    clock = SRSRAN_MAX(clock, rf_shm_ring_get_write_ts(&q->ring[i]));
+  }
+  return clock;
+}
+
+static int rf_shm_rx_register_ring(rf_shm_ring_t* r, uint64_t ts)
+{
+  rf_shm_ring_hdr_t* hdr = r->hdr;
+
+  if (r->token == 0) {
+    r->token = rf_shm_new_token();
+  }
+
+  for (int32_t i = 0; i < SHM_MAX_CONSUMERS; i++) {
+    uint64_t owner = __atomic_load_n(&hdr->consumer[i].owner, __ATOMIC_ACQUIRE);
+
+    // Reuse the slots of the receivers that closed without leaving the ring
+    if (owner != 0 && !rf_shm_owner_is_alive(owner)) {
+      __atomic_compare_exchange_n(&hdr->consumer[i].owner, &owner, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+      owner = 0;
+    }
+
+    if (owner == 0 && __atomic_compare_exchange_n(
+                          &hdr->consumer[i].owner, &owner, r->token, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+      __atomic_store_n(&hdr->consumer[i].read_ts, ts, __ATOMIC_SEQ_CST);
+      r->slot = i;
+      return SRSRAN_SUCCESS;
+    }
+  }
+
+  fprintf(stderr, "[shm] Error: %s has no free receiver slot (maximum %d)\n", r->name, SHM_MAX_CONSUMERS);
+  return SRSRAN_ERROR;
+}
+
+int rf_shm_rx_register(rf_shm_rx_t* q, uint64_t ts)
+{
+  for (uint32_t i = 0; i < q->nof_rings; i++) {
+    if (rf_shm_rx_register_ring(&q->ring[i], ts) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static uint64_t time_us(void)
+{
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000UL + (uint64_t)ts.tv_nsec / 1000UL;
+}
+
+/*
+ * Waits until the ring holds the samples up to end_ts. Returns SRSRAN_SUCCESS if they are available, SRSRAN_ERROR if
+ * the ring has no transmitter and SRSRAN_ERROR_TIMEOUT if the transmitter did not write them in time. With a single
+ * ring the receiver keeps waiting for a transmitter to show up, a fan-in receiver does not wait for absent ones.
+ */
+static int rf_shm_rx_wait(rf_shm_rx_t* q, rf_shm_ring_t* r, uint64_t end_ts)
+{
+  rf_shm_ring_hdr_t* hdr      = r->hdr;
+  uint64_t           deadline = 0;
+
+  while (q->running) {
+    uint32_t seq      = __atomic_load_n(&hdr->data_seq, __ATOMIC_SEQ_CST);
+    uint64_t producer = __atomic_load_n(&hdr->producer, __ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&hdr->write_ts, __ATOMIC_SEQ_CST) >= end_ts) {
+      return SRSRAN_SUCCESS;
+    }
+
+    if (producer == 0 && q->nof_rings > 1) {
+      return SRSRAN_ERROR;
+    }
+
+    uint64_t now = time_us();
+    if (deadline == 0) {
+      deadline = now + q->trx_timeout_ms * 1000UL;
+    } else if (now >= deadline) {
+      // Forget transmitters whose process is gone
+      if (producer != 0 && !rf_shm_owner_is_alive(producer)) {
+        __atomic_compare_exchange_n(&hdr->producer, &producer, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+      }
+      return SRSRAN_ERROR_TIMEOUT;
+    }
+
+    rf_shm_ring_wait(&hdr->data_seq, &hdr->data_waiters, seq, SHM_RX_WAIT_US);
+  }
+
+  return SRSRAN_ERROR;
+}
+
+static void rf_shm_rx_release(rf_shm_ring_t* r, uint64_t ts)
+{
+  rf_shm_ring_hdr_t* hdr = r->hdr;
+  __atomic_store_n(&hdr->consumer[r->slot].read_ts, ts, __ATOMIC_SEQ_CST);
+  rf_shm_ring_wake(&hdr->space_seq, &hdr->space_waiters);
+}
+
+static void rf_shm_rx_accumulate(cf_t* dst, const cf_t* src, uint32_t nsamples, uint32_t decim, bool first)
+{
+  if (decim == 1) {
+    if (first) {
+      srsran_vec_cf_copy(dst, src, nsamples);
+    } else {
+      srsran_vec_sum_ccc(dst, src, dst, nsamples);
+    }
+    return;
+  }
+
+  for (uint32_t i = 0, n = 0; i < nsamples; i++) {
+    // Averaging decimation
+    cf_t avg = 0.0f;
+    for (uint32_t j = 0; j < decim; j++, n++) {
+      avg += src[n];
+    }
+    dst[i] = first ? avg : dst[i] + avg; // divide by decim_factor later via scale
+  }
+}
+
+/*
+ * Reads the samples from ts to ts + nsamples * decim of every ring, sums them and decimates them into buffer. Samples
+ * are read in place from the rings. Returns the number of transmitters that contributed, or a negative error code.
+ */
+int rf_shm_rx_baseband(rf_shm_rx_t* q, uint64_t ts, cf_t* buffer, uint32_t nsamples, uint32_t decim, float scale)
+{
+  uint32_t nsamples_b    = nsamples * decim;
+  uint64_t end_ts        = ts + nsamples_b;
+  uint32_t nof_producers = 0;
+
+  for (uint32_t i = 0; i < q->nof_rings && buffer != NULL; i++) {
+    rf_shm_ring_t*     r   = &q->ring[i];
+    rf_shm_ring_hdr_t* hdr = r->hdr;
+
+    // A transmitter drops a stalled receiver, register again and report the lost samples
+    if (__atomic_load_n(&hdr->consumer[r->slot].owner, __ATOMIC_ACQUIRE) != r->token) {
+      q->nof_overflows++;
+      if (rf_shm_rx_register_ring(r, ts) != SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+    }
+
+    int ret = rf_shm_rx_wait(q, r, end_ts);
+    if (ret == SRSRAN_ERROR_TIMEOUT && (q->nof_rings == 1 || q->fail_on_disconnect)) {
+      return ret;
+    }
+    if (ret != SRSRAN_SUCCESS) {
+      if (q->log_trx_timeout && ret == SRSRAN_ERROR_TIMEOUT) {
+        fprintf(stderr, "[shm] %s: skipping %s after %dms\n", q->id, r->name, q->trx_timeout_ms);
+      }
+      continue;
+    }
+
+    // Skip the samples written before the current transmitter started
+    if (ts < __atomic_load_n(&hdr->start_ts, __ATOMIC_ACQUIRE)) {
+      continue;
+    }
+
+    const cf_t* src = &r->data[ts & (r->nof_samples - 1)];
+    if (q->nof_rings == 1 && decim == 1) {
+      srsran_vec_sc_prod_cfc(src, scale, buffer, nsamples);
+    } else {
+      rf_shm_rx_accumulate(buffer, src, nsamples, decim, nof_producers == 0);
+    }
+    nof_producers++;
+
+    // The transmitter only overwrites unread samples after dropping this receiver
+    if (rf_shm_ring_get_write_ts(r) > ts + r->nof_samples) {
+      q->nof_overflows++;
+    }
+  }
+
+  if (buffer != NULL) {
+    if (nof_producers == 0) {
+      srsran_vec_cf_zero(buffer, nsamples);
+    } else if (q->nof_rings > 1 || decim > 1) {
+      srsran_vec_sc_prod_cfc(buffer, scale, buffer, nsamples);
+    }
+  }
+
+  // Let the transmitters move on
+  for (uint32_t i = 0; i < q->nof_rings; i++) {
+    if (q->ring[i].slot >= 0) {
+      rf_shm_rx_release(&q->ring[i], end_ts);
+    }
+  }
+
+  return (int)nof_producers;
+}
+
+bool rf_shm_rx_match_freq(rf_shm_rx_t* q, uint32_t freq_hz)
+{
+  bool ret = false;
+  if (q) {
+    ret = (q->frequency_mhz == 0 || q->frequency_mhz == freq_hz);
+  }
+  return ret;
+}
+
+void rf_shm_rx_close(rf_shm_rx_t* q)
+{
+  q->running = false;
+
+  for (uint32_t i = 0; i < q->nof_rings; i++) {
+    rf_shm_ring_t* r = &q->ring[i];
+
+    // Leave the ring, so that the transmitter does not wait for this receiver
+    if (r->hdr && r->slot >= 0) {
+      uint64_t token = r->token;
+      __atomic_compare_exchange_n(
+          &r->hdr->consumer[r->slot].owner, &token, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+      rf_shm_ring_wake(&r->hdr->space_seq, &r->hdr->space_waiters);
+      r->slot = -1;
+    }
+
+    rf_shm_ring_close(r);
+  }
+  q->nof_rings = 0;
+}
+
+bool rf_shm_rx_is_running(rf_shm_rx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  return q->running;
+}
@@ -0,0 +1,175 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RF_SHM_IMP_TRX_H
+#define SRSRAN_RF_SHM_IMP_TRX_H
+
+#include "srsran/config.h"
+#include "srsran/phy/rf/rf.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Definitions */
+#define VERBOSE (0)
+#define SHM_MAGIC (0x737273686d763031ULL) // "srshmv01"
+#define SHM_CACHE_LINE (64)
+#define SHM_ID_STRLEN 16
+#define SHM_MAX_CONSUMERS (64)
+#define SHM_MAX_FANIN (64)
+#define SHM_RING_SIZE_DEFAULT (1U << 20) // ~45 ms at 23.04 MHz
+#define SHM_RING_SIZE_MIN (1U << 12)
+#define SHM_TIMEOUT_MS (2000)
+#define SHM_BASERATE_DEFAULT_HZ (23040000)
+#define SHM_MAX_GAIN_DB (30.0f)
+#define SHM_MIN_GAIN_DB (0.0f)
+
+/*
+ * A ring carries the samples of one transmitter (the producer) to any number of receivers (the consumers). Samples are
+ * addressed by their timestamp at the base rate: the sample with timestamp ts lives at data[ts % nof_samples]. The
+ * producer publishes write_ts after writing and never overwrites samples that a registered consumer has not read yet.
+ * Each consumer publishes its read_ts after reading. Both sides sleep on the sequence counters when the ring is empty
+ * or full, and are only woken up if they announced themselves as waiters.
+ */
+typedef struct {
+  uint64_t owner;   // Process id in the upper 32 bits and a per-process token in the lower 32 bits, 0 if free
+  uint64_t read_ts; // Timestamp of the next sample to read
+} __attribute__((aligned(SHM_CACHE_LINE))) rf_shm_consumer_t;
+
+typedef struct {
+  uint64_t magic;
+  uint64_t producer; // Same format as rf_shm_consumer_t::owner
+  uint64_t start_ts; // Timestamp of the first sample written by the current producer
+
+  uint64_t write_ts __attribute__((aligned(SHM_CACHE_LINE))); // Timestamp of the next sample to write
+  uint32_t data_seq;
+  uint32_t data_waiters;
+
+  uint32_t space_seq __attribute__((aligned(SHM_CACHE_LINE)));
+  uint32_t space_waiters;
+
+  rf_shm_consumer_t consumer[SHM_MAX_CONSUMERS];
+} rf_shm_ring_hdr_t;
+
+typedef struct {
+  char               name[RF_PARAM_LEN];
+  rf_shm_ring_hdr_t* hdr;
+  size_t             hdr_size;
+  cf_t*              data; // The sample memory is mapped twice back to back, accesses never wrap
+  uint32_t           nof_samples;
+  uint64_t           token; // Producer or consumer token of this process in the ring
+  int32_t            slot;  // Consumer slot, -1 if not registered
+} rf_shm_ring_t;
+
+typedef struct {
+  char            id[SHM_ID_STRLEN];
+  rf_shm_ring_t   ring;
+  bool            running;
+  pthread_mutex_t mutex;
+  uint32_t        frequency_mhz;
+  uint32_t        trx_timeout_ms;
+  bool            log_trx_timeout;
+} rf_shm_tx_t;
+
+typedef struct {
+  char          id[SHM_ID_STRLEN];
+  rf_shm_ring_t ring[SHM_MAX_FANIN];
+  uint32_t      nof_rings;
+  bool          running;
+  uint32_t      frequency_mhz;
+  bool          fail_on_disconnect;
+  uint32_t      trx_timeout_ms;
+  bool          log_trx_timeout;
+  uint32_t      nof_overflows;
+} rf_shm_rx_t;
+
+typedef struct {
+  const char* id;
+  uint32_t    ring_size; ///< ring size in samples, power of two
+  uint32_t    nof_fanin; ///< number of rings summed by a receiver
+  uint32_t    frequency_mhz;
+  bool        fail_on_disconnect;
+  uint32_t    trx_timeout_ms;
+  bool        log_trx_timeout;
+} rf_shm_opts_t;
+
+/*
+ * Common functions
+ */
+SRSRAN_API void rf_shm_info(char* id, const char* format, ...);
+
+SRSRAN_API void rf_shm_error(char* id, const char* format, ...);
+
+SRSRAN_API int rf_shm_ring_open(rf_shm_ring_t* q, const char* name, uint32_t ring_size);
+
+SRSRAN_API void rf_shm_ring_close(rf_shm_ring_t* q);
+
+SRSRAN_API uint64_t rf_shm_ring_get_write_ts(rf_shm_ring_t* q);
+
+SRSRAN_API bool rf_shm_ring_has_producer(rf_shm_ring_t* q);
+
+SRSRAN_API int rf_shm_ring_wait(uint32_t* seq, uint32_t* waiters, uint32_t value, uint32_t timeout_us);
+
+SRSRAN_API void rf_shm_ring_wake(uint32_t* seq, uint32_t* waiters);
+
+SRSRAN_API bool rf_shm_owner_is_alive(uint64_t owner);
+
+SRSRAN_API uint64_t rf_shm_new_token(void);
+
+/*
+ * Transmitter functions
+ */
+SRSRAN_API int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, const char* name);
+
+SRSRAN_API void rf_shm_tx_sync(rf_shm_tx_t* q, uint64_t ts);
+
+SRSRAN_API int rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts);
+
+SRSRAN_API int rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, uint32_t nsamples, float scale, uint32_t interp);
+
+SRSRAN_API uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q);
+
+SRSRAN_API bool rf_shm_tx_match_freq(rf_shm_tx_t* q, uint32_t freq_hz);
+
+SRSRAN_API void rf_shm_tx_close(rf_shm_tx_t* q);
+
+SRSRAN_API bool rf_shm_tx_is_running(rf_shm_tx_t* q);
+
+/*
+ * Receiver functions
+ */
+SRSRAN_API int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, const char* name);
+
+SRSRAN_API uint64_t rf_shm_rx_get_clock(rf_shm_rx_t* q);
+
+SRSRAN_API int rf_shm_rx_register(rf_shm_rx_t* q, uint64_t ts);
+
+SRSRAN_API int
+rf_shm_rx_baseband(rf_shm_rx_t* q, uint64_t ts, cf_t* buffer, uint32_t nsamples, uint32_t decim, float scale);
+
+SRSRAN_API bool rf_shm_rx_match_freq(rf_shm_rx_t* q, uint32_t freq_hz);
+
+SRSRAN_API void rf_shm_rx_close(rf_shm_rx_t* q);
+
+SRSRAN_API bool rf_shm_rx_is_running(rf_shm_rx_t* q);
+
+#endif // SRSRAN_RF_SHM_IMP_TRX_H
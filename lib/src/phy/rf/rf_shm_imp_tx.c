@@ -0,0 +1,275 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <inttypes.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SHM_TX_WAIT_US (1000)
+
+int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, const char* name)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (q) {
+    // Zero object
+    bzero(q, sizeof(rf_shm_tx_t));
+
+    // Copy id
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->id[SHM_ID_STRLEN - 1] = '\0';
+
+    q->frequency_mhz   = opts.frequency_mhz;
+    q->trx_timeout_ms  = opts.trx_timeout_ms;
+    q->log_trx_timeout = opts.log_trx_timeout;
+
+    rf_shm_info(q->id, "Opening transmitter: %s\n", name);
+
+    if (rf_shm_ring_open(&q->ring, name, opts.ring_size) != SRSRAN_SUCCESS) {
+      goto clean_exit;
+    }
+
+    // A ring has a single producer, take it over only if the previous one is gone
+    rf_shm_ring_hdr_t* hdr      = q->ring.hdr;
+    uint64_t           producer = __atomic_load_n(&hdr->producer, __ATOMIC_ACQUIRE);
+    if (rf_shm_owner_is_alive(producer)) {
+      fprintf(stderr, "[shm] Error: %s already has a transmitter\n", q->ring.name);
+      goto clean_exit;
+    }
+    q->ring.token = rf_shm_new_token();
+    if (!__atomic_compare_exchange_n(
+            &hdr->producer, &producer, q->ring.token, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+      fprintf(stderr, "[shm] Error: %s already has a transmitter\n", q->ring.name);
+      q->ring.token = 0;
+      goto clean_exit;
+    }
+
+    if (pthread_mutex_init(&q->mutex, NULL)) {
+      fprintf(stderr, "Error: creating mutex\n");
+      goto clean_exit;
+    }
+
+    q->running = true;
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  if (ret && q) {
+    rf_shm_tx_close(q);
+  }
+  return ret;
+}
+
+void rf_shm_tx_sync(rf_shm_tx_t* q, uint64_t ts)
+{
+  pthread_mutex_lock(&q->mutex);
+
+  // Restart the stream at ts, the older samples in the ring no longer belong to it
+  rf_shm_ring_hdr_t* hdr = q->ring.hdr;
+  __atomic_store_n(&hdr->start_ts, ts, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&hdr->write_ts, ts, __ATOMIC_SEQ_CST);
+  rf_shm_ring_wake(&hdr->data_seq, &hdr->data_waiters);
+
+  pthread_mutex_unlock(&q->mutex);
+}
+
+static uint64_t time_us(void)
+{
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000UL + (uint64_t)ts.tv_nsec / 1000UL;
+}
+
+// Waits until all the registered receivers have read enough to write up to end_ts
+static int rf_shm_tx_wait_space(rf_shm_tx_t* q, uint64_t end_ts)
+{
+  rf_shm_ring_hdr_t* hdr      = q->ring.hdr;
+  uint64_t           deadline = 0;
+
+  while (q->running) {
+    uint32_t seq      = __atomic_load_n(&hdr->space_seq, __ATOMIC_SEQ_CST);
+    uint64_t start_ts = __atomic_load_n(&hdr->start_ts, __ATOMIC_RELAXED);
+
+    // Find the slowest receiver, the ones behind the start of the stream do not hold it back
+    int32_t  slowest = -1;
+    uint64_t min_ts  = UINT64_MAX;
+    for (int32_t i = 0; i < SHM_MAX_CONSUMERS; i++) {
+      if (__atomic_load_n(&hdr->consumer[i].owner, __ATOMIC_ACQUIRE) != 0) {
+        uint64_t read_ts = SRSRAN_MAX(__atomic_load_n(&hdr->consumer[i].read_ts, __ATOMIC_ACQUIRE), start_ts);
+        if (read_ts < min_ts) {
+          min_ts  = read_ts;
+          slowest = i;
+        }
+      }
+    }
+
+    if (slowest < 0 || end_ts <= min_ts + q->ring.nof_samples) {
+      return SRSRAN_SUCCESS;
+    }
+
+    // Drop the slowest receiver if its process is gone or it stalled for too long. It resynchronises on its next read
+    uint64_t owner = __atomic_load_n(&hdr->consumer[slowest].owner, __ATOMIC_ACQUIRE);
+    uint64_t now   = time_us();
+    if (deadline == 0) {
+      deadline = now + q->trx_timeout_ms * 1000UL;
+    }
+    bool alive = rf_shm_owner_is_alive(owner);
+    if (!alive || now >= deadline) {
+      if (__atomic_compare_exchange_n(
+              &hdr->consumer[slowest].owner, &owner, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) &&
+          q->log_trx_timeout) {
+        fprintf(stderr,
+                "[shm] %s: dropping %s receiver %d of %s\n",
+                q->id,
+                alive ? "stalled" : "closed",
+                slowest,
+                q->ring.name);
+      }
+      deadline = 0;
+      continue;
+    }
+
+    rf_shm_ring_wait(&hdr->space_seq, &hdr->space_waiters, seq, SHM_TX_WAIT_US);
+  }
+
+  return SRSRAN_ERROR;
+}
+
+static int _rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, uint32_t nsamples, float scale, uint32_t interp)
+{
+  rf_shm_ring_hdr_t* hdr        = q->ring.hdr;
+  uint32_t           nsamples_b = nsamples * interp;
+
+  if (nsamples_b > q->ring.nof_samples / 2) {
+    rf_shm_error(q->id, "Error: trying to transmit too many samples (%d > %d).\n", nsamples_b, q->ring.nof_samples / 2);
+    return SRSRAN_ERROR;
+  }
+
+  uint64_t ts = __atomic_load_n(&hdr->write_ts, __ATOMIC_RELAXED);
+  if (rf_shm_tx_wait_space(q, ts + nsamples_b) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // Write in place, the double mapping makes the destination contiguous
+  cf_t* dst = &q->ring.data[ts & (q->ring.nof_samples - 1)];
+  if (buffer == NULL) {
+    srsran_vec_cf_zero(dst, nsamples_b);
+  } else if (interp == 1) {
+    if (scale == 1.0f) {
+      srsran_vec_cf_copy(dst, buffer, nsamples);
+    } else {
+      srsran_vec_sc_prod_cfc(buffer, scale, dst, nsamples);
+    }
+  } else {
+    // perform zero order hold
+    for (uint32_t k = 0, n = 0; k < nsamples; k++) {
+      cf_t sample = buffer[k] * scale;
+      for (uint32_t j = 0; j < interp; j++, n++) {
+        dst[n] = sample;
+      }
+    }
+  }
+
+  // Publish the samples
+  __atomic_store_n(&hdr->write_ts, ts + nsamples_b, __ATOMIC_SEQ_CST);
+  rf_shm_ring_wake(&hdr->data_seq, &hdr->data_waiters);
+
+  return (int)nsamples;
+}
+
+int rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts)
+{
+  pthread_mutex_lock(&q->mutex);
+
+  int64_t nsamples = (int64_t)ts - (int64_t)__atomic_load_n(&q->ring.hdr->write_ts, __ATOMIC_RELAXED);
+
+  if (nsamples > 0) {
+    rf_shm_info(q->id, " - Detected Tx gap of %d samples.\n", nsamples);
+  }
+
+  // Fill the gap with zeros, in pieces that fit in the ring
+  for (int64_t n = 0; n < nsamples;) {
+    uint32_t count = (uint32_t)SRSRAN_MIN(nsamples - n, (int64_t)q->ring.nof_samples / 2);
+    if (_rf_shm_tx_baseband(q, NULL, count, 1.0f, 1) < SRSRAN_SUCCESS) {
+      nsamples = SRSRAN_ERROR;
+      break;
+    }
+    n += count;
+  }
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return (int)nsamples;
+}
+
+int rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, uint32_t nsamples, float scale, uint32_t interp)
+{
+  pthread_mutex_lock(&q->mutex);
+  int n = _rf_shm_tx_baseband(q, buffer, nsamples, scale, interp);
+  pthread_mutex_unlock(&q->mutex);
+
+  return n;
+}
+
+uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q)
+{
+  return rf_shm_ring_get_write_ts(&q->ring);
+}
+
+bool rf_shm_tx_match_freq(rf_shm_tx_t* q, uint32_t freq_hz)
+{
+  bool ret = false;
+  if (q) {
+    ret = (q->frequency_mhz == 0 || q->frequency_mhz == freq_hz);
+  }
+  return ret;
+}
+
+void rf_shm_tx_close(rf_shm_tx_t* q)
+{
+  if (q->running) {
+    q->running = false;
+    pthread_mutex_destroy(&q->mutex);
+  }
+
+  // Leave the ring, so that the receivers stop waiting for samples
+  if (q->ring.hdr && q->ring.token) {
+    uint64_t token = q->ring.token;
+    __atomic_compare_exchange_n(&q->ring.hdr->producer, &token, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    rf_shm_ring_wake(&q->ring.hdr->data_seq, &q->ring.hdr->data_waiters);
+    q->ring.token = 0;
+  }
+
+  rf_shm_ring_close(&q->ring);
+}
+
+bool rf_shm_tx_is_running(rf_shm_tx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  return q->running;
+}
@@ -0,0 +1,405 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/rf/rf.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_NOF_UE 64
+#define MAX_NOF_CHANNELS 2
+#define MAX_SF_LEN 23040
+#define TX_OFFSET_MS 4
+#define NOF_SF_CHECK 20
+#define COMPARE_EPSILON (1e-4f)
+
+static uint32_t nof_ue = 8;
+static uint32_t nof_sf = 200;
+
+static char ring_names[MAX_NOF_UE + 2 * MAX_NOF_CHANNELS][64];
+static int  nof_ring_names = 0;
+
+typedef struct {
+  const char* devname;
+  char        args[RF_PARAM_LEN];
+  bool        is_enb;
+  uint32_t    nof_channels;
+  double      srate;
+  bool        check;
+  float       ul_value;    // Constant transmitted by a UE
+  float       ul_expected; // Sum of the UE constants received by the eNb
+  uint32_t    nof_errors;
+  uint32_t    nof_checked;
+  double      elapsed_s;
+  double      cpu_s;
+  pthread_t   thread;
+} radio_args_t;
+
+static radio_args_t enb_args;
+static radio_args_t ue_args[MAX_NOF_UE];
+static bool         enb_done = false;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [un]\n", prog);
+  printf("\t-u number of UEs of the fan-in test and benchmark [Default %d]\n", nof_ue);
+  printf("\t-n number of subframes [Default %d]\n", nof_sf);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "u:n:h")) != -1) {
+    switch (opt) {
+      case 'u':
+        nof_ue = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      case 'n':
+        nof_sf = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static double now_s(clockid_t clock)
+{
+  struct timespec ts = {};
+  clock_gettime(clock, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Downlink test pattern, a function of the sample time at the radio rate
+static cf_t dl_sample(uint64_t n, uint32_t ch)
+{
+  return ((float)(n % 997) + _Complex_I * (float)((ch + 1) * (n % 13))) / 1000.0f;
+}
+
+static const char* ring_name(const char* format, uint32_t idx)
+{
+  snprintf(ring_names[nof_ring_names], sizeof(ring_names[0]), format, getpid(), idx);
+  return ring_names[nof_ring_names++];
+}
+
+static void unlink_rings()
+{
+  for (int i = 0; i < nof_ring_names; i++) {
+    shm_unlink(ring_names[i]);
+  }
+  nof_ring_names = 0;
+}
+
+static void* radio_thread(void* arg)
+{
+  radio_args_t* q        = (radio_args_t*)arg;
+  srsran_rf_t   radio    = {};
+  uint32_t      sf_len   = (uint32_t)(q->srate / 1000);
+  cf_t*         rx[MAX_NOF_CHANNELS] = {};
+  cf_t*         tx[MAX_NOF_CHANNELS] = {};
+
+  if (srsran_rf_open_devname(&radio, q->devname, q->args, q->nof_channels)) {
+    fprintf(stderr, "Error opening rf\n");
+    q->nof_errors++;
+    return NULL;
+  }
+  srsran_rf_set_rx_srate(&radio, q->srate);
+  srsran_rf_set_tx_srate(&radio, q->srate);
+
+  for (uint32_t c = 0; c < q->nof_channels; c++) {
+    rx[c] = srsran_vec_cf_malloc(sf_len);
+    tx[c] = srsran_vec_cf_malloc(sf_len);
+    for (uint32_t i = 0; i < sf_len; i++) {
+      tx[c][i] = q->ul_value;
+    }
+  }
+
+  double t_start   = now_s(CLOCK_MONOTONIC);
+  double cpu_start = now_s(CLOCK_THREAD_CPUTIME_ID);
+
+  for (uint32_t sf = 0; q->is_enb ? sf < nof_sf : !__atomic_load_n(&enb_done, __ATOMIC_ACQUIRE); sf++) {
+    srsran_timestamp_t rx_time = {}, tx_time = {};
+    if (srsran_rf_recv_with_time_multi(&radio, (void**)rx, sf_len, true, &rx_time.full_secs, &rx_time.frac_secs) !=
+        sf_len) {
+      // The UEs stop when the eNb is gone
+      if (q->is_enb) {
+        fprintf(stderr, "Error receiving subframe %d\n", sf);
+        q->nof_errors++;
+      }
+      break;
+    }
+    uint64_t rx_n = srsran_timestamp_uint64(&rx_time, q->srate);
+
+    if (q->check && q->is_enb && sf >= nof_sf - NOF_SF_CHECK) {
+      // In the end all the UEs are transmitting, the eNb receives the sum of their constants
+      for (uint32_t i = 0; i < sf_len; i++) {
+        if (cabsf(rx[0][i] - q->ul_expected) > COMPARE_EPSILON * q->ul_expected) {
+          fprintf(stderr, "Uplink mismatch in subframe %d sample %d: %f\n", sf, i, crealf(rx[0][i]));
+          q->nof_errors++;
+          break;
+        }
+      }
+      q->nof_checked += sf_len;
+    } else if (q->check && !q->is_enb) {
+      // The UE receives the eNb pattern once the eNb transmits
+      for (uint32_t c = 0; c < q->nof_channels; c++) {
+        for (uint32_t i = 0; i < sf_len; i++) {
+          if (rx[c][i] != 0.0f) {
+            if (cabsf(rx[c][i] - dl_sample(rx_n + i, c)) > COMPARE_EPSILON) {
+              fprintf(stderr, "Downlink mismatch in channel %d sample %" PRIu64 "\n", c, rx_n + i);
+              q->nof_errors++;
+              break;
+            }
+            q->nof_checked++;
+          }
+        }
+      }
+    }
+
+    srsran_timestamp_copy(&tx_time, &rx_time);
+    srsran_timestamp_add(&tx_time, 0, TX_OFFSET_MS * 1e-3);
+    if (q->is_enb) {
+      uint64_t tx_n = srsran_timestamp_uint64(&tx_time, q->srate);
+      for (uint32_t c = 0; c < q->nof_channels; c++) {
+        for (uint32_t i = 0; i < sf_len; i++) {
+          tx[c][i] = dl_sample(tx_n + i, c);
+        }
+      }
+    }
+    if (srsran_rf_send_timed_multi(
+            &radio, (void**)tx, sf_len, tx_time.full_secs, tx_time.frac_secs, true, true, false) != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending subframe %d\n", sf);
+      q->nof_errors++;
+      break;
+    }
+  }
+
+  q->elapsed_s = now_s(CLOCK_MONOTONIC) - t_start;
+  q->cpu_s     = now_s(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+
+  if (q->is_enb) {
+    __atomic_store_n(&enb_done, true, __ATOMIC_RELEASE);
+  }
+  srsran_rf_close(&radio);
+
+  for (uint32_t c = 0; c < q->nof_channels; c++) {
+    free(rx[c]);
+    free(tx[c]);
+  }
+  return NULL;
+}
+
+static int run(const char* name, uint32_t nues)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  enb_done = false;
+  for (uint32_t i = 0; i < nues; i++) {
+    if (pthread_create(&ue_args[i].thread, NULL, radio_thread, &ue_args[i])) {
+      perror("pthread_create");
+      return SRSRAN_ERROR;
+    }
+  }
+  radio_thread(&enb_args);
+
+  double ue_cpu_s = 0.0;
+  for (uint32_t i = 0; i < nues; i++) {
+    pthread_join(ue_args[i].thread, NULL);
+    if (ue_args[i].nof_errors || (ue_args[i].check && ue_args[i].nof_checked == 0)) {
+      fprintf(stderr,
+              "%s: UE %d failed (%d errors, %d checked samples)\n",
+              name,
+              i,
+              ue_args[i].nof_errors,
+              ue_args[i].nof_checked);
+      ret = SRSRAN_ERROR;
+    }
+    ue_cpu_s += ue_args[i].cpu_s;
+  }
+  if (enb_args.nof_errors || (enb_args.check && enb_args.nof_checked == 0)) {
+    fprintf(stderr, "%s: eNb failed (%d errors)\n", name, enb_args.nof_errors);
+    ret = SRSRAN_ERROR;
+  }
+
+  double sf_per_s = nof_sf / enb_args.elapsed_s;
+  printf("%s: %d UE, %d channels at %.2f MHz: %.0f subframes/s (%.1fx real time), CPU per subframe: eNb %.1f us, "
+         "UEs %.1f us\n",
+         name,
+         nues,
+         enb_args.nof_channels,
+         enb_args.srate / 1e6,
+         sf_per_s,
+         sf_per_s / 1000.0,
+         1e6 * enb_args.cpu_s / nof_sf,
+         1e6 * ue_cpu_s / nof_sf);
+
+  return ret;
+}
+
+static void init_args(radio_args_t* q, const char* devname, bool is_enb, uint32_t nof_channels, double srate)
+{
+  bzero(q, sizeof(radio_args_t));
+  q->devname      = devname;
+  q->is_enb       = is_enb;
+  q->nof_channels = nof_channels;
+  q->srate        = srate;
+}
+
+// One eNb and one UE over two channels, at 1.92 MHz over a 23.04 MHz transport
+static int test_link()
+{
+  init_args(&enb_args, "shm", true, MAX_NOF_CHANNELS, 1.92e6);
+  init_args(&ue_args[0], "shm", false, MAX_NOF_CHANNELS, 1.92e6);
+  enb_args.check       = true;
+  enb_args.ul_expected = 0.5f;
+  ue_args[0].check     = true;
+  ue_args[0].ul_value  = 0.5f;
+
+  const char* dl[MAX_NOF_CHANNELS] = {};
+  const char* ul[MAX_NOF_CHANNELS] = {};
+  for (uint32_t c = 0; c < MAX_NOF_CHANNELS; c++) {
+    dl[c] = ring_name("/srsran_shm_test_%d_dl%d", c);
+    ul[c] = ring_name("/srsran_shm_test_%d_ul%d", c);
+  }
+  snprintf(enb_args.args,
+           RF_PARAM_LEN,
+           "tx_shm=%s,tx_shm=%s,rx_shm=%s,rx_shm=%s,id=enb,base_srate=23.04e6",
+           dl[0],
+           dl[1],
+           ul[0],
+           ul[1]);
+  snprintf(ue_args[0].args,
+           RF_PARAM_LEN,
+           "rx_shm=%s,rx_shm=%s,tx_shm=%s,tx_shm=%s,id=ue,base_srate=23.04e6,fail_on_disconnect=true,"
+           "trx_timeout_ms=100",
+           dl[0],
+           dl[1],
+           ul[0],
+           ul[1]);
+
+  int ret = run("shm link", 1);
+  unlink_rings();
+  return ret;
+}
+
+// One eNb summing the uplink of several UEs, each with its own ring, at 23.04 MHz
+static int test_fanin(uint32_t nues)
+{
+  init_args(&enb_args, "shm", true, 1, 23.04e6);
+  enb_args.check = true;
+
+  const char* dl = ring_name("/srsran_shm_test_%d_dl%d", 0);
+  const char* ul = ring_name("/srsran_shm_test_%d_ul%d", 0);
+  snprintf(enb_args.args, RF_PARAM_LEN, "tx_shm=%s,rx_shm=%s,rx_fanin=%d,id=enb,base_srate=23.04e6", dl, ul, nues);
+
+  for (uint32_t i = 0; i < nues; i++) {
+    init_args(&ue_args[i], "shm", false, 1, 23.04e6);
+    ue_args[i].ul_value = (float)(i + 1) / 64.0f;
+    enb_args.ul_expected += ue_args[i].ul_value;
+
+    // A single UE transmits into the receiver ring itself
+    const char* ue_ul = ul;
+    if (nues > 1) {
+      snprintf(ring_names[nof_ring_names], sizeof(ring_names[0]), "%s.%d", ul, i);
+      ue_ul = ring_names[nof_ring_names++];
+    }
+    snprintf(ue_args[i].args,
+             RF_PARAM_LEN,
+             "rx_shm=%s,tx_shm=%s,id=ue%d,base_srate=23.04e6,fail_on_disconnect=true,trx_timeout_ms=100",
+             dl,
+             ue_ul,
+             i);
+  }
+
+  int ret = run("shm fan-in", nues);
+  unlink_rings();
+  return ret;
+}
+
+#ifdef ENABLE_ZEROMQ
+// The same eNb and UE loop over ZeroMQ IPC sockets, for reference
+static int bench_zmq()
+{
+  init_args(&enb_args, "zmq", true, 1, 23.04e6);
+  init_args(&ue_args[0], "zmq", false, 1, 23.04e6);
+
+  snprintf(enb_args.args,
+           RF_PARAM_LEN,
+           "tx_port=ipc:///tmp/srsran_shm_test_%d_dl,rx_port=ipc:///tmp/srsran_shm_test_%d_ul,id=enb,"
+           "base_srate=23.04e6",
+           getpid(),
+           getpid());
+  snprintf(ue_args[0].args,
+           RF_PARAM_LEN,
+           "rx_port=ipc:///tmp/srsran_shm_test_%d_dl,tx_port=ipc:///tmp/srsran_shm_test_%d_ul,id=ue,base_srate=23.04e6,"
+           "fail_on_disconnect=true,trx_timeout_ms=100",
+           getpid(),
+           getpid());
+
+  return run("zmq", 1);
+}
+#endif /* ENABLE_ZEROMQ */
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (nof_ue == 0 || nof_ue > MAX_NOF_UE || nof_sf <= NOF_SF_CHECK) {
+    usage(argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  if (test_link() != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Link test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (test_fanin(1) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Single UE test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (test_fanin(nof_ue) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Fan-in test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+#ifdef ENABLE_ZEROMQ
+  if (bench_zmq() != SRSRAN_SUCCESS) {
+    fprintf(stderr, "ZeroMQ reference failed!\n");
+    return SRSRAN_ERROR;
+  }
+#endif /* ENABLE_ZEROMQ */
+
+  return SRSRAN_SUCCESS;
+}
@@ -869,7 +869,7 @@ static int ssb_pss_search(srsran_ssb_t* q,
   int shift_range = (int)ceil(SRSRAN_SUBC_SPACING_NR(q->cfg.scs) / coarse_cfo_ref_hz);
 
   // Calculate the coarse shift increment for half of the subcarrier spacing
-  int shift_coarse_inc = shift_range / 2;
+  int shift_coarse_inc = SRSRAN_MAX(shift_range / 2, 1);
 
   // Correlation best sequence
   float    best_corr   = 0;
@@ -186,6 +186,7 @@ int srsran_ue_dl_set_cell(srsran_ue_dl_t* q, srsran_cell_t cell)
 
   if (q != NULL && srsran_cell_isvalid(&cell)) {
     q->pending_ul_dci_count = 0;
+    bzero(q->ue_ss_cache, sizeof(q->ue_ss_cache));
 
     if (q->cell.id != cell.id || q->cell.nof_prb == 0) {
       if (q->cell.nof_prb != 0) {
@@ -312,7 +313,7 @@ static void set_mi_value(srsran_ue_dl_t* q, srsran_dl_sf_cfg_t* sf, srsran_ue_dl
   }
 }
 
-static int estimate_pdcch_pcfich(srsran_ue_dl_t* q, srsran_dl_sf_cfg_t* sf, srsran_ue_dl_cfg_t* cfg)
+int srsran_ue_dl_estimate(srsran_ue_dl_t* q, srsran_dl_sf_cfg_t* sf, srsran_ue_dl_cfg_t* cfg)
 {
   if (q) {
     float cfi_corr = 0;
@@ -357,7 +358,7 @@ int srsran_ue_dl_decode_fft_estimate(srsran_ue_dl_t* q, srsran_dl_sf_cfg_t* sf,
         srsran_ofdm_rx_sf(&q->fft[j]);
       }
     }
-    return estimate_pdcch_pcfich(q, sf, cfg);
+    return srsran_ue_dl_estimate(q, sf, cfg);
   } else {
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
@@ -377,7 +378,7 @@ int srsran_ue_dl_decode_fft_estimate_noguru(srsran_ue_dl_t*     q,
         srsran_ofdm_rx_sf_ng(&q->fft[j], input[j], q->sf_symbols[j]);
       }
     }
-    return estimate_pdcch_pcfich(q, sf, cfg);
+    return srsran_ue_dl_estimate(q, sf, cfg);
   } else {
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
@@ -542,10 +543,16 @@ static int find_dci_ss(srsran_ue_dl_t*            q,
   q->current_ss_common.nof_locations =
       srsran_pdcch_common_locations(&q->pdcch, q->current_ss_common.loc, SRSRAN_MAX_CANDIDATES_COM, cfi);
 
-  // Generate Search Space
+  // Generate Search Space, or reuse the one generated for the same RNTI, CFI and subframe in a previous frame
   if (is_ue) {
-    search_space.nof_locations =
-        srsran_pdcch_ue_locations(&q->pdcch, sf, search_space.loc, SRSRAN_MAX_CANDIDATES_UE, rnti);
+    srsran_ue_dl_ss_cache_t* ss = &q->ue_ss_cache[cfi - 1][sf->tti % SRSRAN_NOF_SF_X_FRAME];
+    if (ss->rnti != rnti || ss->nof_cce != q->pdcch.nof_cce[cfi - 1]) {
+      ss->rnti          = rnti;
+      ss->nof_cce       = q->pdcch.nof_cce[cfi - 1];
+      ss->nof_locations = srsran_pdcch_ue_locations(&q->pdcch, sf, ss->loc, SRSRAN_MAX_CANDIDATES_UE, rnti);
+    }
+    search_space.nof_locations = ss->nof_locations;
+    memcpy(search_space.loc, ss->loc, sizeof(srsran_dci_location_t) * ss->nof_locations);
   } else {
     // Disable extended CSI request and SRS request in common SS
     srsran_dci_cfg_set_common_ss(&dci_cfg);
@@ -25,6 +25,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <time.h>
 #include <unistd.h>
@@ -154,6 +155,67 @@ clean_exit:
   return res;
 }
 
+/* Two objects of the same size and direction share the plan, and each of them keeps working after freeing the other or
+ * replanning */
+int test_shared_plan(cf_t* in)
+{
+  int                  res = -1;
+  srsran_dft_metrics_t metrics_before, metrics_after;
+  srsran_dft_plan_t    plan1 = {};
+  srsran_dft_plan_t    plan2 = {};
+
+  cf_t* out1 = srsran_vec_cf_malloc(N);
+  cf_t* out2 = srsran_vec_cf_malloc(N);
+
+  if (srsran_dft_plan(&plan1, N, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX) != SRSRAN_SUCCESS) {
+    ERROR("Error in DFT plan");
+    goto clean_exit;
+  }
+  srsran_dft_get_metrics(&metrics_before);
+  if (srsran_dft_plan(&plan2, N, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX) != SRSRAN_SUCCESS) {
+    ERROR("Error in DFT plan");
+    goto clean_exit;
+  }
+  srsran_dft_get_metrics(&metrics_after);
+
+  // The second plan is served from the cache
+  if (!plan1.is_shared || plan1.p != plan2.p || metrics_after.nof_cache_hits != metrics_before.nof_cache_hits + 1 ||
+      metrics_after.nof_plans_created != metrics_before.nof_plans_created) {
+    ERROR("The DFT plan is not shared");
+    goto clean_exit;
+  }
+
+  srsran_dft_run_c(&plan1, in, out1);
+  srsran_dft_plan_free(&plan1);
+  srsran_dft_run_c(&plan2, in, out2);
+  if (memcmp(out1, out2, sizeof(cf_t) * N) != 0) {
+    ERROR("Shared DFT plans give different results");
+    goto clean_exit;
+  }
+
+  // Replanning does not affect the other users of the plan
+  if (srsran_dft_plan(&plan1, N, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX) != SRSRAN_SUCCESS ||
+      srsran_dft_replan(&plan2, N / 2) != SRSRAN_SUCCESS || srsran_dft_replan(&plan2, N) != SRSRAN_SUCCESS) {
+    ERROR("Error in DFT replan");
+    goto clean_exit;
+  }
+  srsran_dft_run_c(&plan1, in, out1);
+  srsran_dft_run_c(&plan2, in, out2);
+  if (memcmp(out1, out2, sizeof(cf_t) * N) != 0) {
+    ERROR("Replanned DFT gives different results");
+    goto clean_exit;
+  }
+  res = 0;
+
+clean_exit:
+  srsran_dft_plan_free(&plan1);
+  srsran_dft_plan_free(&plan2);
+  free(out1);
+  free(out2);
+
+  return res;
+}
+
 int main(int argc, char** argv)
 {
   srsran_random_t random_gen = srsran_random_init(0x1234);
@@ -165,6 +227,9 @@ int main(int argc, char** argv)
   if (test_dft(in) != 0)
     return -1;
 
+  if (test_shared_plan(in) != 0)
+    return -1;
+
   free(in);
   srsran_random_free(random_gen);
   printf("Done\n");
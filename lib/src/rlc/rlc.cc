@@ -21,6 +21,7 @@
 
 #include "srsran/rlc/rlc.h"
 #include "srsran/common/rwlock_guard.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/rlc/rlc_am_base.h"
 #include "srsran/rlc/rlc_tm.h"
 #include "srsran/rlc/rlc_um_lte.h"
@@ -183,6 +184,7 @@ void rlc::empty_queue()
 
 void rlc::write_sdu(uint32_t lcid, unique_byte_buffer_t sdu)
 {
+  tti_trace_event("RLC", "rlc::write_sdu");
   // TODO: rework build PDU logic to allow large SDUs (without concatenation)
   if (sdu->N_bytes > RLC_MAX_SDU_SIZE) {
     logger.warning("Dropping too long SDU of size %d B (Max. size %d B).", sdu->N_bytes, RLC_MAX_SDU_SIZE);
@@ -282,6 +284,7 @@ uint32_t rlc::get_total_mch_buffer_state(uint32_t lcid)
 
 uint32_t rlc::read_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 {
+  tti_trace_event("RLC", "rlc::read_pdu");
   uint32_t ret = 0;
 
   rwlock_read_guard lock(rwlock);
@@ -317,6 +320,7 @@ uint32_t rlc::read_pdu_mch(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 // Write PDU methods are called from Stack thread context, no need to acquire the lock
 void rlc::write_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 {
+  tti_trace_event("RLC", "rlc::write_pdu");
   if (valid_lcid(lcid)) {
     rlc_array.at(lcid)->write_pdu_s(payload, nof_bytes);
     update_bsr(lcid);
@@ -1369,8 +1369,6 @@ void rlc_am_lte_rx::handle_data_pdu_full(uint8_t* payload, uint32_t nof_bytes, r
 
 void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_pdu_header_t& header)
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-
   RlcHexInfo(payload,
              nof_bytes,
              "Rx data PDU segment of SN=%d (%d B), SO=%d, N_li=%d",
@@ -1390,9 +1388,15 @@ void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes
     return;
   }
 
-  rlc_amd_rx_pdu segment;
-  segment.buf = srsran::make_byte_buffer();
-  if (segment.buf == NULL) {
+  rlc_amd_rx_pdu_segment* segment = rx_segment_pool.allocate();
+  if (segment == nullptr) {
+    // The segment will be retransmitted by the peer, as for any other lost PDU
+    RlcWarning("Dropping segment SN=%d SO=%d, no free RX segments", header.sn, header.so);
+    return;
+  }
+  segment->buf = srsran::make_byte_buffer();
+  if (segment->buf == NULL) {
+    segment->release();
 #ifdef RLC_AM_BUFFER_DEBUG
     srsran::console("Fatal Error: Couldn't allocate PDU in handle_data_pdu_segment().\n");
     exit(-1);
@@ -1402,34 +1406,38 @@ void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes
 #endif
   }
 
-  if (segment.buf->get_tailroom() < nof_bytes) {
+  // Keep the packed header in front of the data, the LIs are needed to reconstruct the header of the full PDU
+  uint8_t* ptr = segment->buf->msg;
+  rlc_am_write_data_pdu_header(&header, &ptr);
+  uint32_t header_len = ptr - segment->buf->msg;
+  if (segment->buf->get_tailroom() < header_len + nof_bytes) {
     RlcInfo("Dropping corrupted segment SN=%d, not enough space to fit %d B", header.sn, nof_bytes);
+    segment->release();
     return;
   }
 
-  memcpy(segment.buf->msg, payload, nof_bytes);
-  segment.buf->N_bytes = nof_bytes;
-  segment.header       = header;
+  memcpy(ptr, payload, nof_bytes);
+  segment->buf->N_bytes = header_len + nof_bytes;
+  segment->so           = header.so;
+  segment->payload_len  = nof_bytes;
+  segment->lsf          = header.lsf;
 
   // Check if we already have a segment from the same PDU
-  it = rx_segments.find(header.sn);
-  if (rx_segments.end() != it) {
+  if (rx_segments.has_sn(header.sn)) {
     if (header.p) {
       RlcInfo("Status packet requested through polling bit");
       do_status = true;
     }
 
-    // Add segment to PDU list and check for complete
-    // NOTE: MAY MOVE. Preference would be to capture by value, and then move; but header is stack allocated
-    if (add_segment_and_check(&it->second, &segment)) {
-      rx_segments.erase(it);
+    // Add segment to PDU list and check for complete. The full PDU may have been reassembled already, which removes
+    // the segments of its SN
+    if (add_segment_and_check(&rx_segments[header.sn], segment) and rx_segments.has_sn(header.sn)) {
+      rx_segments.remove_pdu(header.sn);
     }
 
   } else {
     // Create new PDU segment list and write to rx_segments
-    rlc_amd_rx_pdu_segments_t pdu;
-    pdu.segments.push_back(std::move(segment));
-    rx_segments[header.sn] = std::move(pdu);
+    rx_segments.add_pdu(header.sn).segments.push_front(segment);
 
     // Update vr_h
     if (RX_MOD_BASE(header.sn) >= RX_MOD_BASE(vr_h)) {
@@ -1585,19 +1593,12 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
     // Move the rx_window
     RlcDebug("Erasing SN=%d.", vr_r);
     // also erase any segments of this SN
-    std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-    it = rx_segments.find(vr_r);
-    if (rx_segments.end() != it) {
+    if (rx_segments.has_sn(vr_r)) {
       RlcDebug("Erasing segments of SN=%d", vr_r);
-      std::list<rlc_amd_rx_pdu>::iterator segit;
-      for (segit = it->second.segments.begin(); segit != it->second.segments.end(); ++segit) {
-        RlcDebug(" Erasing segment of SN=%d SO=%d Len=%d N_li=%d",
-                 segit->header.sn,
-                 segit->header.so,
-                 segit->buf->N_bytes,
-                 segit->header.N_li);
+      for (const rlc_amd_rx_pdu_segment& segment : rx_segments[vr_r].segments) {
+        RlcDebug(" Erasing segment of SN=%d SO=%d Len=%d", vr_r, segment.so, segment.payload_len);
       }
-      it->second.segments.clear();
+      rx_segments.remove_pdu(vr_r);
     }
     rx_window.remove_pdu(vr_r);
     vr_r  = (vr_r + 1) % MOD;
@@ -1733,72 +1734,82 @@ int rlc_am_lte_rx::get_status_pdu_length()
 
 void rlc_am_lte_rx::print_rx_segments()
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-  std::stringstream                                       ss;
+  std::stringstream ss;
   ss << "rx_segments:" << std::endl;
-  for (it = rx_segments.begin(); it != rx_segments.end(); it++) {
-    std::list<rlc_amd_rx_pdu>::iterator segit;
-    for (segit = it->second.segments.begin(); segit != it->second.segments.end(); segit++) {
-      ss << "    SN=" << segit->header.sn << " SO:" << segit->header.so << " N:" << segit->buf->N_bytes
-         << " N_li: " << segit->header.N_li << std::endl;
+  for (uint32_t sn = vr_r; RX_MOD_BASE(sn) < RX_MOD_BASE(vr_mr); sn = (sn + 1) % MOD) {
+    if (not rx_segments.has_sn(sn)) {
+      continue;
+    }
+    for (const rlc_amd_rx_pdu_segment& segment : rx_segments[sn].segments) {
+      ss << "    SN=" << sn << " SO:" << segment.so << " N:" << segment.payload_len << std::endl;
     }
   }
   RlcDebug("%s", ss.str().c_str());
 }
 
-// NOTE: Preference would be to capture by value, and then move; but header is stack allocated
-bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu* segment)
+// NOTE: The segment is owned by the list of the PDU afterwards, or released if it is not needed
+bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu_segment* segment)
 {
   // Find segment insertion point in the list of segments
-  auto it1 = pdu->segments.begin();
-  while (it1 != pdu->segments.end() && (*it1).header.so < segment->header.so) {
-    // Increment iterator
-    it1++;
-  }
-
-  // Check if the insertion point was found
-  if (it1 != pdu->segments.end()) {
-    // Found insertion point
-    rlc_amd_rx_pdu& s = *it1;
-    if (s.header.so == segment->header.so) {
-      // Same Segment offset
-      if (segment->buf->N_bytes > s.buf->N_bytes) {
-        // replace if the new one is bigger
-        s = std::move(*segment);
-      } else {
-        // Ignore otherwise
-      }
-    } else if (s.header.so > segment->header.so) {
-      pdu->segments.insert(it1, std::move(*segment));
+  rlc_amd_rx_pdu_segment* prev = nullptr;
+  auto                    it   = pdu->segments.begin();
+  while (it != pdu->segments.end() && it->so < segment->so) {
+    prev = &*it;
+    ++it;
+  }
+
+  if (it != pdu->segments.end() && it->so == segment->so) {
+    // Same Segment offset
+    if (segment->payload_len > it->payload_len) {
+      // replace if the new one is bigger
+      rlc_amd_rx_pdu_segment* old = (prev == nullptr) ? pdu->segments.pop_front() : pdu->segments.erase_after(prev);
+      old->release();
+    } else {
+      // Ignore otherwise
+      segment->release();
+      segment = nullptr;
+    }
+  }
+  if (segment != nullptr) {
+    if (prev == nullptr) {
+      pdu->segments.push_front(segment);
+    } else {
+      pdu->segments.insert_after(prev, segment);
     }
-  } else {
-    // Either the new segment is the latest or the only one, push back
-    pdu->segments.push_back(std::move(*segment));
   }
 
   // Check for complete
-  uint32_t                            so = 0;
-  std::list<rlc_amd_rx_pdu>::iterator it, tmpit;
+  uint32_t so           = 0;
+  uint32_t nof_segments = 0;
+  prev                  = nullptr;
   for (it = pdu->segments.begin(); it != pdu->segments.end(); /* Do not increment */) {
+    rlc_amd_rx_pdu_segment* s = &*it;
+
     // Check that there is no gap between last segment and current; overlap allowed
-    if (so < it->header.so) {
+    if (so < s->so) {
       // return
       return false;
     }
 
-    // Check if segment is overlapped
-    if (it->header.so + it->buf->N_bytes <= so) {
+    ++it;
+    if (s->so + s->payload_len <= so) {
       // completely overlapped with previous segments, erase
-      it = pdu->segments.erase(it); // Returns next iterator
+      if (prev == nullptr) {
+        pdu->segments.pop_front();
+      } else {
+        pdu->segments.erase_after(prev);
+      }
+      s->release();
     } else {
       // Update segment offset it shall not go backwards
-      so = SRSRAN_MAX(so, it->header.so + it->buf->N_bytes);
-      it++; // Increments iterator
+      so   = SRSRAN_MAX(so, s->so + s->payload_len);
+      prev = s;
+      nof_segments++;
     }
   }
 
   // Check for last segment flag available
-  if (!pdu->segments.back().header.lsf) {
+  if (prev == nullptr || !prev->lsf) {
     return false;
   }
 
@@ -1808,29 +1819,39 @@ bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_am
   header.rf   = 0;
   header.p    = 0;
   header.fi   = RLC_FI_FIELD_START_AND_END_ALIGNED;
-  header.sn   = pdu->segments.front().header.sn;
+  header.sn   = pdu->rlc_sn;
   header.lsf  = 0;
   header.so   = 0;
   header.N_li = 0;
 
-  // Reconstruct fi field
-  header.fi |= (pdu->segments.front().header.fi & RLC_FI_FIELD_NOT_START_ALIGNED);
-  header.fi |= (pdu->segments.back().header.fi & RLC_FI_FIELD_NOT_END_ALIGNED);
-
-  RlcDebug("Starting header reconstruction of %zd segments", pdu->segments.size());
+  RlcDebug("Starting header reconstruction of %d segments", nof_segments);
 
   // Reconstruct li fields
-  uint16_t count          = 0;
-  uint16_t carryover      = 0;
-  uint16_t consumed_bytes = 0; // rolling sum of all allocated LIs during segment reconstruction
+  uint16_t             count          = 0;
+  uint16_t             carryover      = 0;
+  uint16_t             consumed_bytes = 0; // rolling sum of all allocated LIs during segment reconstruction
+  rlc_amd_pdu_header_t seg_header;
 
   for (it = pdu->segments.begin(); it != pdu->segments.end(); ++it) {
-    RlcDebug(" Handling %d PDU segments", it->header.N_li);
-    for (uint32_t i = 0; i < it->header.N_li; i++) {
+    // Unpack the header stored in front of the segment data
+    uint8_t* ptr = it->buf->msg;
+    uint32_t len = it->buf->N_bytes;
+    rlc_am_read_data_pdu_header(&ptr, &len, &seg_header);
+
+    // Reconstruct fi field
+    if (it == pdu->segments.begin()) {
+      header.fi |= (seg_header.fi & RLC_FI_FIELD_NOT_START_ALIGNED);
+    }
+    if (&*it == prev) {
+      header.fi |= (seg_header.fi & RLC_FI_FIELD_NOT_END_ALIGNED);
+    }
+
+    RlcDebug(" Handling %d PDU segments", seg_header.N_li);
+    for (uint32_t i = 0; i < seg_header.N_li; i++) {
       // variable marks total offset of each _processed_ LI of this segment
-      uint32_t total_pdu_offset = it->header.so;
+      uint32_t total_pdu_offset = it->so;
       for (uint32_t k = 0; k <= i; k++) {
-        total_pdu_offset += it->header.li[k];
+        total_pdu_offset += seg_header.li[k];
       }
 
       RlcDebug("  - (total_pdu_offset=%d, consumed_bytes=%d, header.li[i]=%d)",
@@ -1843,44 +1864,40 @@ bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_am
 
         RlcDebug("  - adding segment %d/%d (%d B, SO=%d, carryover=%d, count=%d)",
                  i + 1,
-                 it->header.N_li,
+                 seg_header.N_li,
                  header.li[header.N_li],
                  header.so,
                  carryover,
                  count);
         header.N_li++;
-        count += it->header.li[i];
+        count += seg_header.li[i];
         carryover = 0;
       } else {
         RlcDebug("  - Skipping segment in reTx PDU segment which is already included (%d B, SO=%d)",
-                 it->header.li[i],
+                 seg_header.li[i],
                  header.so);
       }
     }
 
-    if (count <= it->buf->N_bytes) {
-      carryover = it->header.so + it->buf->N_bytes;
+    if (count <= it->payload_len) {
+      carryover = it->so + it->payload_len;
       // substract all previous LIs
       for (uint32_t k = 0; k < header.N_li; ++k) {
         carryover -= header.li[k];
       }
-      RlcDebug("Incremented carryover (it->buf->N_bytes=%d, count=%d). New carryover=%d",
-               it->buf->N_bytes,
-               count,
-               carryover);
+      RlcDebug("Incremented carryover (payload_len=%d, count=%d). New carryover=%d", it->payload_len, count, carryover);
     } else {
       // Next segment would be too long, recalculate carryover
       header.N_li--;
-      carryover = it->buf->N_bytes - (count - header.li[header.N_li]);
-      RlcDebug("Recalculated carryover=%d (it->buf->N_bytes=%d, count=%d, header.li[header.N_li]=%d)",
+      carryover = it->payload_len - (count - header.li[header.N_li]);
+      RlcDebug("Recalculated carryover=%d (payload_len=%d, count=%d, header.li[header.N_li]=%d)",
                carryover,
-               it->buf->N_bytes,
+               it->payload_len,
                count,
                header.li[header.N_li]);
     }
 
-    tmpit = it;
-    if (rlc_am_end_aligned(it->header.fi) && ++tmpit != pdu->segments.end()) {
+    if (rlc_am_end_aligned(seg_header.fi) && &*it != prev) {
       RlcDebug("Header is end-aligned, overwrite header.li[%d]=%d", header.N_li, carryover);
       header.li[header.N_li] = carryover;
       header.N_li++;
@@ -1890,10 +1907,10 @@ bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_am
     count = 0;
 
     // set Poll bit if any of the segments had it set
-    header.p |= it->header.p;
+    header.p |= seg_header.p;
   }
 
-  RlcDebug("Finished header reconstruction of %zd segments", pdu->segments.size());
+  RlcDebug("Finished header reconstruction of %d segments", nof_segments);
 
   // Copy data
   unique_byte_buffer_t full_pdu = srsran::make_byte_buffer();
@@ -1906,20 +1923,20 @@ bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_am
     return false;
 #endif
   }
-  for (it = pdu->segments.begin(); it != pdu->segments.end(); it++) {
+  for (it = pdu->segments.begin(); it != pdu->segments.end(); ++it) {
     // By default, the segment is not copied. It could be it is fully overlapped with previous segments
     uint32_t overlap = 0;
     uint32_t n       = 0;
 
     // Check if the segment has non-overlapped bytes
-    if (it->header.so + it->buf->N_bytes > full_pdu->N_bytes) {
+    if (it->so + it->payload_len > full_pdu->N_bytes) {
       // Calculate overlap and number of bytes
-      overlap = full_pdu->N_bytes - it->header.so;
-      n       = it->buf->N_bytes - overlap;
+      overlap = full_pdu->N_bytes - it->so;
+      n       = it->payload_len - overlap;
     }
 
     // Copy data itself
-    memcpy(&full_pdu->msg[full_pdu->N_bytes], &it->buf->msg[overlap], n);
+    memcpy(&full_pdu->msg[full_pdu->N_bytes], &it->payload()[overlap], n);
     full_pdu->N_bytes += n;
   }
 
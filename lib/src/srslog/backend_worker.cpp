@@ -98,18 +98,23 @@ void backend_worker::do_work()
   /// termination variable periodically.
   constexpr std::chrono::microseconds sleep_period{100};
 
+  std::vector<detail::log_entry> batch(max_batch_size);
+
   while (running_flag) {
-    auto item = queue.try_pop();
+    size_t nof_items = queue.try_pop(batch.data(), batch.size());
 
     // Spin while there are no new entries to process.
-    if (!item.first) {
+    if (nof_items == 0) {
       std::this_thread::sleep_for(sleep_period);
       continue;
     }
 
     report_queue_on_full_once();
+    report_discarded_entries();
 
-    process_log_entry(std::move(item.second));
+    for (size_t i = 0; i != nof_items; ++i) {
+      process_log_entry(std::move(batch[i]));
+    }
   }
 
   // When we reach here, the thread is about to terminate, last chance to
@@ -151,6 +156,25 @@ void backend_worker::process_log_entry(detail::log_entry&& entry)
   }
 }
 
+void backend_worker::report_discarded_entries()
+{
+  uint64_t nof_discarded = nof_discarded_entries.load(std::memory_order_relaxed);
+  if (nof_discarded == nof_reported_discarded_entries ||
+      overflow_policy.load(std::memory_order_relaxed) != backend_overflow_policy::discard_and_count) {
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_discard_report < std::chrono::seconds(1)) {
+    return;
+  }
+
+  err_handler(fmt::format("{} log entries have been discarded as the backend queue was full",
+                          nof_discarded - nof_reported_discarded_entries));
+  nof_reported_discarded_entries = nof_discarded;
+  last_discard_report            = now;
+}
+
 void backend_worker::process_outstanding_entries()
 {
   assert(!running_flag && "Cannot process outstanding entries while thread is running");
@@ -24,8 +24,11 @@
 
 #include "srsran/srslog/detail/log_entry.h"
 #include "srsran/srslog/detail/support/dyn_arg_store_pool.h"
+#include "srsran/srslog/detail/support/thread_utils.h"
 #include "srsran/srslog/detail/support/work_queue.h"
 #include "srsran/srslog/shared_types.h"
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <thread>
 
@@ -79,6 +82,16 @@ public:
     err_handler = std::move(new_err_handler);
   }
 
+  /// Sets the behaviour of the producers when the queue is full.
+  void set_overflow_policy(backend_overflow_policy policy) { overflow_policy.store(policy, std::memory_order_relaxed); }
+  backend_overflow_policy get_overflow_policy() const { return overflow_policy.load(std::memory_order_relaxed); }
+
+  /// Accounts for a log entry that has been discarded as the queue was full.
+  void notify_discarded_entry() { nof_discarded_entries.fetch_add(1, std::memory_order_relaxed); }
+
+  /// Returns the total number of log entries discarded as the queue was full.
+  uint64_t get_nof_discarded_entries() const { return nof_discarded_entries.load(std::memory_order_relaxed); }
+
 private:
   /// Creates the worker thread.
   /// NOTE: This function should be only called once.
@@ -98,19 +111,27 @@ private:
   /// Error message is only reported once to avoid spamming.
   void report_queue_on_full_once()
   {
-    if (queue.is_almost_full()) {
+    if (!queue_full_reported && queue.is_almost_full()) {
       err_handler(fmt::format("The backend queue size is about to reach its maximum "
                               "capacity of {} elements, new log entries will get "
                               "discarded.\nConsider increasing the queue capacity.",
                               queue.get_capacity()));
-      err_handler = [](const std::string&) {};
+      queue_full_reported = true;
     }
   }
 
+  /// Reports through the error handler the number of log entries discarded
+  /// since the last report, at most once per second, when the policy is
+  /// discard_and_count.
+  void report_discarded_entries();
+
   /// Establishes the specified thread priority for the calling thread.
   void set_thread_priority(backend_priority priority) const;
 
 private:
+  /// Maximum number of entries popped from the queue at once.
+  static constexpr size_t max_batch_size = 64;
+
   detail::work_queue<detail::log_entry>& queue;
   detail::dyn_arg_store_pool&            arg_pool;
   detail::shared_variable<bool>          running_flag;
@@ -118,6 +139,13 @@ private:
   std::once_flag     start_once_flag;
   std::thread        worker_thread;
   fmt::memory_buffer fmt_buffer;
+
+  // Queue overflow handling.
+  bool                                  queue_full_reported = false;
+  std::atomic<backend_overflow_policy>  overflow_policy{backend_overflow_policy::discard};
+  std::atomic<uint64_t>                 nof_discarded_entries{0};
+  uint64_t                              nof_reported_discarded_entries = 0;
+  std::chrono::steady_clock::time_point last_discard_report;
 };
 
 } // namespace srslog
@@ -43,20 +43,54 @@ public:
   bool push(detail::log_entry&& entry) override
   {
     auto* arg_store = entry.metadata.store;
-    if (!queue.push(std::move(entry))) {
-      arg_pool.dealloc(arg_store);
-      return false;
+    if (queue.push(std::move(entry))) {
+      return true;
     }
-    return true;
+
+    // The queue is full. The entry is left untouched by a failed push.
+    if (worker.get_overflow_policy() == backend_overflow_policy::block) {
+      while (worker.is_running()) {
+        std::this_thread::yield();
+        if (queue.push(std::move(entry))) {
+          return true;
+        }
+      }
+    }
+    arg_pool.dealloc(arg_store);
+    worker.notify_discarded_entry();
+    return false;
   }
 
-  fmt::dynamic_format_arg_store<fmt::printf_context>* alloc_arg_store() override { return arg_pool.alloc(); }
+  fmt::dynamic_format_arg_store<fmt::printf_context>* alloc_arg_store() override
+  {
+    if (auto* p = arg_pool.alloc()) {
+      return p;
+    }
+
+    // The pool has the same capacity as the queue, so it gets exhausted under the same conditions.
+    if (worker.get_overflow_policy() == backend_overflow_policy::block) {
+      while (worker.is_running()) {
+        std::this_thread::yield();
+        if (auto* p = arg_pool.alloc()) {
+          return p;
+        }
+      }
+    }
+    worker.notify_discarded_entry();
+    return nullptr;
+  }
 
   bool is_running() const override { return worker.is_running(); }
 
   /// Installs the specified error handler into the backend worker.
   void set_error_handler(error_handler err_handler) { worker.set_error_handler(std::move(err_handler)); }
 
+  /// Sets the behaviour of push() when the queue is full.
+  void set_overflow_policy(backend_overflow_policy policy) { worker.set_overflow_policy(policy); }
+
+  /// Returns the total number of log entries discarded as the queue was full.
+  uint64_t get_nof_discarded_entries() const { return worker.get_nof_discarded_entries(); }
+
   /// Stops the backend worker thread.
   void stop() { worker.stop(); }
 
@@ -88,6 +88,12 @@ public:
   /// Installs the specified error handler into the backend.
   void set_error_handler(error_handler callback) { backend.set_error_handler(std::move(callback)); }
 
+  /// Sets the behaviour of the backend when its queue is full.
+  void set_overflow_policy(backend_overflow_policy policy) { backend.set_overflow_policy(policy); }
+
+  /// Returns the number of log entries discarded by the backend.
+  uint64_t get_nof_discarded_entries() const { return backend.get_nof_discarded_entries(); }
+
   /// Set the specified sink as the default one.
   void set_default_sink(sink& s) { default_sink = &s; }
 
@@ -151,6 +151,112 @@ void test_fixedsize_pool()
   TESTASSERT(C::default_ctor_counter == C::dtor_counter);
 }
 
+void test_fixedsize_pool_multithread()
+{
+  const size_t nof_threads = 4, nof_iters = 20000;
+  auto*        fixed_pool  = BigObj::pool_t::get_instance();
+  auto         sum_allocs  = [fixed_pool]() {
+    uint64_t sum = 0;
+    for (const srsran::memory_pool_thread_metrics& m : fixed_pool->get_metrics()) {
+      sum += m.nof_cache_hits + m.nof_cache_misses;
+    }
+    return sum;
+  };
+  uint64_t allocs_before = sum_allocs();
+
+  // TEST: several threads allocate and deallocate at the same time, part of the objects are freed by another thread
+  {
+    srsran::dyn_blocking_queue<std::unique_ptr<BigObj> > queue(64);
+    std::vector<std::thread>                             threads;
+    for (size_t t = 0; t < nof_threads; ++t) {
+      threads.emplace_back([&queue, t]() {
+        std::vector<std::unique_ptr<BigObj> > objs;
+        for (size_t i = 0; i < nof_iters; ++i) {
+          objs.emplace_back(new (std::nothrow) BigObj());
+          TESTASSERT(objs.back() != nullptr);
+          if (objs.size() > 8 + 4 * t) {
+            queue.try_push(std::move(objs.back()));
+            objs.clear();
+          }
+          std::unique_ptr<BigObj> other;
+          queue.try_pop(other);
+        }
+      });
+    }
+    for (std::thread& t : threads) {
+      t.join();
+    }
+  }
+  TESTASSERT(C::default_ctor_counter == C::dtor_counter);
+
+  // Allocation counters of the exited threads are kept by the pool
+  TESTASSERT(sum_allocs() == allocs_before + nof_threads * nof_iters);
+  for (const srsran::memory_pool_thread_metrics& m : fixed_pool->get_metrics()) {
+    if (m.id == std::thread::id()) {
+      TESTASSERT(m.nof_cache_hits > m.nof_cache_misses);
+      TESTASSERT(m.nof_alloc_failures == 0);
+    }
+  }
+  fixed_pool->print_all_buffers();
+
+  // All the blocks must be back in the pool
+  std::vector<std::unique_ptr<BigObj> > vec(fixed_pool->size());
+  for (auto& obj : vec) {
+    obj.reset(new (std::nothrow) BigObj());
+    TESTASSERT(obj != nullptr);
+  }
+  vec.clear();
+  TESTASSERT(C::default_ctor_counter == C::dtor_counter);
+}
+
+void test_memblock_batch_stack_multithread()
+{
+  const size_t nof_threads = 4, nof_iters = 20000, nof_blocks = 256, block_size = 64, batch_size = 4;
+  std::unique_ptr<uint8_t[]>              mem(new uint8_t[nof_blocks * block_size]);
+  srsran::concurrent_memblock_batch_stack stack(mem.get(), block_size, nof_blocks);
+
+  srsran::free_memblock_list blocks;
+  for (size_t i = 0; i < nof_blocks; ++i) {
+    blocks.push(mem.get() + i * block_size);
+  }
+  while (not blocks.empty()) {
+    stack.push_batch(blocks, batch_size);
+  }
+  TESTASSERT(stack.size() == nof_blocks);
+
+  // TEST: the popped blocks are fully overwritten, as users do, while other threads keep popping
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nof_threads; ++t) {
+    threads.emplace_back([&stack, t]() {
+      for (size_t i = 0; i < nof_iters; ++i) {
+        srsran::free_memblock_list popped;
+        stack.pop_batch(popped);
+        srsran::free_memblock_list used;
+        while (not popped.empty()) {
+          void* block = popped.pop();
+          memset(block, static_cast<int>(t + i), block_size);
+          used.push(block);
+        }
+        while (not used.empty()) {
+          stack.push_batch(used, batch_size);
+        }
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  // All the blocks must be back in the stack
+  TESTASSERT(stack.size() == nof_blocks);
+  size_t count = 0;
+  while (not stack.empty()) {
+    count += stack.pop_batch(blocks);
+  }
+  TESTASSERT(count == nof_blocks);
+  TESTASSERT(blocks.size() == nof_blocks);
+}
+
 struct D : public C {
   char val = '\0';
 };
@@ -187,6 +293,8 @@ int main(int argc, char** argv)
 
   test_nontrivial_obj_pool();
   test_fixedsize_pool();
+  test_fixedsize_pool_multithread();
+  test_memblock_batch_stack_multithread();
   test_background_pool();
 
   printf("Success\n");
@@ -130,6 +130,74 @@ int test_socket_handler()
   return 0;
 }
 
+int test_udp_socket_handler()
+{
+  auto& logger = srslog::fetch_basic_logger("S1AP", false);
+
+  const uint32_t                      nof_servers = 3, nof_pdus = 20;
+  std::vector<std::atomic<uint32_t> > counters(nof_servers);
+  std::vector<srsran::unique_socket>  servers(nof_servers);
+  srsran::unique_socket               client;
+  srsran::socket_manager              sockhandler(2);
+  rx_thread_tester                    rx_tester;
+  using namespace srsran::net_utils;
+
+  TESTASSERT(sockhandler.get_nof_rx_threads() == 2);
+  TESTASSERT(client.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  for (uint32_t i = 0; i < nof_servers; ++i) {
+    counters[i] = 0;
+    TESTASSERT(servers[i].open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+    TESTASSERT(servers[i].bind_addr("127.0.0.1", 0));
+    auto pdu_handler = [&counters, i](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+      TESTASSERT(pdu->N_bytes == pdu->msg[0] + 1U);
+      counters[i]++;
+    };
+    TESTASSERT(sockhandler.add_socket_handler(servers[i].fd(),
+                                              srsran::make_sdu_handler(logger, rx_tester.task_queue, pdu_handler)));
+  }
+  // registering the same fd twice is an error
+  auto noop_handler = [](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {};
+  TESTASSERT(not sockhandler.add_socket_handler(servers[0].fd(),
+                                                srsran::make_sdu_handler(logger, rx_tester.task_queue, noop_handler)));
+
+  // send bursts to every server, so that several datagrams are read at once
+  uint8_t buf[128] = {};
+  auto    send_all = [&]() {
+    for (uint32_t n = 0; n < nof_pdus; ++n) {
+      for (srsran::unique_socket& server : servers) {
+        sockaddr_in dst = {};
+        socklen_t   len = sizeof(dst);
+        TESTASSERT(getsockname(server.fd(), (sockaddr*)&dst, &len) == 0);
+        buf[0] = n;
+        TESTASSERT(sendto(client.fd(), buf, n + 1, 0, (sockaddr*)&dst, sizeof(dst)) == n + 1);
+      }
+    }
+  };
+  auto wait_for = [&counters](uint32_t expected, uint32_t last) {
+    for (uint32_t time_elapsed = 0; time_elapsed < 3000000; time_elapsed += 100) {
+      if (std::all_of(counters.begin(), counters.begin() + last, [expected](const std::atomic<uint32_t>& c) {
+            return c == expected;
+          })) {
+        return true;
+      }
+      usleep(100);
+    }
+    return false;
+  };
+  send_all();
+  TESTASSERT(wait_for(nof_pdus, nof_servers));
+
+  // Once removed, the handler of the socket is not called anymore
+  TESTASSERT(sockhandler.remove_socket(servers.back().fd()));
+  TESTASSERT(not sockhandler.remove_socket(servers.back().fd()));
+  send_all();
+  TESTASSERT(wait_for(2 * nof_pdus, nof_servers - 1));
+  usleep(10000);
+  TESTASSERT(counters.back() == nof_pdus);
+
+  return SRSRAN_SUCCESS;
+}
+
 int test_sctp_bind_error()
 {
   srsran::unique_socket sock;
@@ -158,6 +226,7 @@ int main()
 
   TESTASSERT(test_socket_handler() == 0);
   TESTASSERT(test_sctp_bind_error() == 0);
+  TESTASSERT(test_udp_socket_handler() == 0);
 
   return 0;
 }
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Throughput of the ciphering and integrity algorithms, one PDU per call (as PDCP does) versus the batch functions.
+ */
+
+#include "srsran/common/security.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <functional>
+#include <getopt.h>
+#include <vector>
+
+using namespace srsran;
+
+static uint32_t pdu_len     = 1500;
+static uint32_t nof_pdus    = 32;
+static uint32_t duration_ms = 200;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [lnd]\n", prog);
+  printf("\t-l PDU length in bytes [Default %d]\n", pdu_len);
+  printf("\t-n Number of PDUs per batch [Default %d]\n", nof_pdus);
+  printf("\t-d Duration of each measurement in milliseconds [Default %d]\n", duration_ms);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "lndh")) != -1) {
+    switch (opt) {
+      case 'l':
+        pdu_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_pdus = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Runs the function, which processes a whole batch, for duration_ms and prints the rate
+static void measure(const char* name, const std::function<void()>& process_batch)
+{
+  uint64_t nof_batches = 0;
+  auto     t_start     = std::chrono::steady_clock::now();
+  auto     t_end       = t_start;
+  do {
+    process_batch();
+    nof_batches++;
+    t_end = std::chrono::steady_clock::now();
+  } while (t_end - t_start < std::chrono::milliseconds(duration_ms));
+
+  double elapsed_s = std::chrono::duration<double>(t_end - t_start).count();
+  double nof_bytes = (double)nof_batches * nof_pdus * pdu_len;
+  printf("%-24s %9.1f Mbps %9.3f Mpps\n",
+         name,
+         nof_bytes * 8 / elapsed_s / 1e6,
+         nof_batches * nof_pdus / elapsed_s / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  if (pdu_len == 0 or nof_pdus == 0) {
+    usage(argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  uint8_t key[16];
+  for (uint32_t i = 0; i < sizeof(key); i++) {
+    key[i] = i * 17;
+  }
+  uint8_t bearer    = 4;
+  uint8_t direction = SECURITY_DIRECTION_UPLINK;
+
+  std::vector<std::vector<uint8_t> > buffers(nof_pdus, std::vector<uint8_t>(pdu_len, 0xab));
+  std::vector<std::array<uint8_t, 4> > macs(nof_pdus);
+  std::vector<security_pdu_t>          pdus(nof_pdus);
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    pdus[i] = {i, buffers[i].data(), pdu_len, buffers[i].data(), macs[i].data()};
+  }
+
+  printf("PDU length=%d bytes, batch=%d PDUs\n", pdu_len, nof_pdus);
+
+  // EEA1
+  measure("EEA1 per PDU", [&]() {
+    for (security_pdu_t& p : pdus) {
+      security_128_eea1(key, p.count, bearer, direction, p.out, p.msg_len, p.out);
+    }
+  });
+  measure("EEA1 batch", [&]() { security_128_eea1_batch(key, bearer, direction, pdus.data(), nof_pdus); });
+
+  // EEA2/EIA2
+  measure("EEA2 per PDU", [&]() {
+    for (security_pdu_t& p : pdus) {
+      security_128_eea2(key, p.count, bearer, direction, p.out, p.msg_len, p.out);
+    }
+  });
+  measure("EIA2 per PDU", [&]() {
+    for (security_pdu_t& p : pdus) {
+      security_128_eia2(key, p.count, bearer, direction, p.out, p.msg_len, p.mac);
+    }
+  });
+  security_aes128_ctx_t ctx;
+  security_aes128_init(&ctx, key);
+  for (uint32_t impl = 0; impl < SECURITY_AES128_N_ITEMS; impl++) {
+    if (not security_aes128_set_impl(&ctx, (security_aes128_impl_t)impl)) {
+      continue;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "EEA2 batch (%s)", security_aes128_impl_text[impl]);
+    measure(name, [&]() { security_128_eea2_batch(&ctx, bearer, direction, pdus.data(), nof_pdus); });
+    snprintf(name, sizeof(name), "EIA2 batch (%s)", security_aes128_impl_text[impl]);
+    measure(name, [&]() { security_128_eia2_batch(&ctx, bearer, direction, pdus.data(), nof_pdus); });
+  }
+
+  // EEA3
+  measure("EEA3 per PDU", [&]() {
+    for (security_pdu_t& p : pdus) {
+      security_128_eea3(key, p.count, bearer, direction, p.out, p.msg_len, p.out);
+    }
+  });
+  measure("EEA3 batch", [&]() { security_128_eea3_batch(key, bearer, direction, pdus.data(), nof_pdus); });
+
+  return SRSRAN_SUCCESS;
+}
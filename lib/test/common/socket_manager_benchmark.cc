@@ -0,0 +1,232 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Loopback UDP benchmark of the socket_manager. Each server socket is fed by its own sender thread, and the received
+ * datagrams go through the same make_sdu_handler(...) + task queue path used by GTP-U. The packet rate is reported per
+ * rx thread CPU second.
+ */
+
+#include "srsran/common/network_utils.h"
+#include "srsran/common/task_scheduler.h"
+#include "srsran/common/test_common.h"
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <getopt.h>
+#include <map>
+#include <thread>
+#include <time.h>
+
+static uint32_t nof_rx_threads = 1;
+static uint32_t nof_sockets    = 1;
+static uint32_t duration_ms    = 1000;
+static uint32_t max_batch      = srsran::SOCKET_MAX_RX_BATCH;
+static uint32_t payload_len    = 64;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [tsdbl]\n", prog);
+  printf("\t-t Number of rx threads [Default %d]\n", nof_rx_threads);
+  printf("\t-s Number of UDP sockets, each one with its own sender thread [Default %d]\n", nof_sockets);
+  printf("\t-d Duration in milliseconds [Default %d]\n", duration_ms);
+  printf("\t-b Maximum number of datagrams per recvmmsg call [Default %d]\n", max_batch);
+  printf("\t-l Payload length in bytes [Default %d]\n", payload_len);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "tsdblh")) != -1) {
+    switch (opt) {
+      case 't':
+        nof_rx_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        nof_sockets = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'b':
+        max_batch = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        payload_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static uint64_t thread_cpu_time_ns()
+{
+  timespec ts = {};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/// CPU time consumed by the rx thread that serves a socket, sampled after each wakeup
+struct socket_rx_stats {
+  std::atomic<uint64_t>        nof_wakeups = {0};
+  std::atomic<uint64_t>        cpu_ns      = {0};
+  std::atomic<std::thread::id> rx_thread   = {};
+};
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  if (nof_sockets == 0 or payload_len == 0) {
+    usage(argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  auto& logger = srslog::fetch_basic_logger("SOCK", false);
+  srslog::fetch_basic_logger("COMN", false).set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  srsran::task_scheduler    task_sched(8192);
+  srsran::task_queue_handle queue = task_sched.make_task_queue(8192);
+  srsran::socket_manager    rx_sockets(nof_rx_threads);
+
+  std::atomic<uint64_t> nof_rx_pdus  = {0};
+  std::atomic<uint64_t> nof_rx_bytes = {0};
+  auto rx_callback = [&nof_rx_pdus, &nof_rx_bytes](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+    nof_rx_pdus.fetch_add(1, std::memory_order_relaxed);
+    nof_rx_bytes.fetch_add(pdu->N_bytes, std::memory_order_relaxed);
+  };
+
+  // Stack thread, where the received PDUs are handled
+  std::thread stack_thread([&task_sched]() {
+    while (task_sched.run_next_task()) {
+    }
+  });
+
+  // Server sockets, all bound to an ephemeral port of the loopback interface
+  std::vector<srsran::unique_socket>            servers(nof_sockets);
+  std::vector<std::unique_ptr<socket_rx_stats> > stats;
+  for (srsran::unique_socket& server : servers) {
+    TESTASSERT(server.open_socket(srsran::net_utils::addr_family::ipv4,
+                                  srsran::net_utils::socket_type::datagram,
+                                  srsran::net_utils::protocol_type::UDP));
+    TESTASSERT(server.bind_addr("127.0.0.1", 0));
+    int rcvbuf = 8 * 1024 * 1024;
+    setsockopt(server.fd(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    stats.emplace_back(new socket_rx_stats());
+    socket_rx_stats*                        st      = stats.back().get();
+    srsran::socket_manager_itf::recv_callback_t handler =
+        srsran::make_sdu_handler(logger, queue, rx_callback, max_batch);
+    TESTASSERT(rx_sockets.add_socket_handler(server.fd(), [st, h = std::move(handler)](int fd) mutable {
+      bool ret = h(fd);
+      st->nof_wakeups.fetch_add(1, std::memory_order_relaxed);
+      st->cpu_ns.store(thread_cpu_time_ns(), std::memory_order_relaxed);
+      st->rx_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+      return ret;
+    }));
+  }
+
+  // One sender per server socket
+  std::atomic<bool>        stop_token = {false};
+  std::atomic<uint64_t>    nof_tx     = {0};
+  std::vector<std::thread> senders;
+  for (srsran::unique_socket& server : servers) {
+    sockaddr_in dst = {};
+    socklen_t   len = sizeof(dst);
+    TESTASSERT(getsockname(server.fd(), (sockaddr*)&dst, &len) == 0);
+    senders.emplace_back([dst, &stop_token, &nof_tx]() {
+      srsran::unique_socket client;
+      client.open_socket(srsran::net_utils::addr_family::ipv4,
+                         srsran::net_utils::socket_type::datagram,
+                         srsran::net_utils::protocol_type::UDP);
+      std::vector<uint8_t>    payload(payload_len, 0xab);
+      std::array<mmsghdr, 32> msgs = {};
+      std::array<iovec, 32>   iovs = {};
+      for (size_t i = 0; i < msgs.size(); ++i) {
+        iovs[i].iov_base            = payload.data();
+        iovs[i].iov_len             = payload.size();
+        msgs[i].msg_hdr.msg_name    = (void*)&dst;
+        msgs[i].msg_hdr.msg_namelen = sizeof(dst);
+        msgs[i].msg_hdr.msg_iov     = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+      }
+      uint64_t sent = 0;
+      while (not stop_token.load(std::memory_order_relaxed)) {
+        int n = sendmmsg(client.fd(), msgs.data(), msgs.size(), 0);
+        if (n > 0) {
+          sent += n;
+        }
+      }
+      nof_tx.fetch_add(sent, std::memory_order_relaxed);
+    });
+  }
+
+  // Measure only the steady state
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  uint64_t                            pdus_start = nof_rx_pdus.load();
+  std::map<std::thread::id, uint64_t> cpu_start;
+  for (const auto& st : stats) {
+    cpu_start[st->rx_thread.load()] = std::max(cpu_start[st->rx_thread.load()], st->cpu_ns.load());
+  }
+  auto t_start = std::chrono::steady_clock::now();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+
+  uint64_t                            pdus_end    = nof_rx_pdus.load();
+  auto                                t_end       = std::chrono::steady_clock::now();
+  std::map<std::thread::id, uint64_t> cpu_end;
+  uint64_t                            nof_wakeups = 0;
+  for (const auto& st : stats) {
+    cpu_end[st->rx_thread.load()] = std::max(cpu_end[st->rx_thread.load()], st->cpu_ns.load());
+    nof_wakeups += st->nof_wakeups.load();
+  }
+
+  stop_token = true;
+  for (std::thread& t : senders) {
+    t.join();
+  }
+  rx_sockets.stop();
+  task_sched.stop();
+  stack_thread.join();
+
+  double elapsed_s = std::chrono::duration<double>(t_end - t_start).count();
+  double rx_cpu_s  = 0;
+  for (const auto& e : cpu_end) {
+    rx_cpu_s += (e.second - cpu_start[e.first]) / 1e9;
+  }
+  uint64_t nof_pdus = pdus_end - pdus_start;
+
+  printf("rx_threads=%d, sockets=%d, batch=%d, payload=%d bytes\n", nof_rx_threads, nof_sockets, max_batch, payload_len);
+  printf("Sent %" PRIu64 " datagrams, received %" PRIu64 " (%" PRIu64 " bytes), %.2f datagrams/wakeup\n",
+         nof_tx.load(),
+         nof_rx_pdus.load(),
+         nof_rx_bytes.load(),
+         nof_wakeups > 0 ? (double)nof_rx_pdus.load() / nof_wakeups : 0.0);
+  printf("Rx rate: %.3f Mpps, %.3f Mpps per rx thread CPU second (rx threads at %.1f%% CPU)\n",
+         nof_pdus / elapsed_s / 1e6,
+         rx_cpu_s > 0 ? nof_pdus / rx_cpu_s / 1e6 : 0.0,
+         100.0 * rx_cpu_s / elapsed_s / std::max(nof_rx_threads, 1U));
+
+  TESTASSERT(nof_pdus > 0);
+  return SRSRAN_SUCCESS;
+}
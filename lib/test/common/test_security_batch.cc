@@ -0,0 +1,160 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Checks the batch ciphering/integrity functions against the single PDU ones, for PDUs of random length and COUNT.
+ */
+
+#include "srsran/common/security.h"
+#include "srsran/common/test_common.h"
+#include <random>
+#include <vector>
+
+using namespace srsran;
+
+static std::mt19937 rand_gen(1234);
+
+struct test_batch_t {
+  std::vector<std::vector<uint8_t> > msg;
+  std::vector<std::vector<uint8_t> > out;
+  std::vector<std::array<uint8_t, 4> > mac;
+  std::vector<security_pdu_t>          pdus;
+
+  test_batch_t(uint32_t nof_pdus, uint32_t max_len, bool in_place)
+  {
+    std::uniform_int_distribution<uint32_t> len_dist(1, max_len);
+    msg.resize(nof_pdus);
+    out.resize(nof_pdus);
+    mac.resize(nof_pdus);
+    pdus.resize(nof_pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      msg[i].resize(len_dist(rand_gen));
+      for (uint8_t& b : msg[i]) {
+        b = rand_gen();
+      }
+      out[i]          = msg[i];
+      pdus[i].count   = rand_gen();
+      pdus[i].msg     = in_place ? out[i].data() : msg[i].data();
+      pdus[i].msg_len = msg[i].size();
+      pdus[i].out     = out[i].data();
+      pdus[i].mac     = mac[i].data();
+    }
+  }
+};
+
+int test_eea(CIPHERING_ALGORITHM_ID_ENUM alg, security_aes128_impl_t impl, uint32_t nof_pdus, bool in_place)
+{
+  uint8_t key[16];
+  for (uint8_t& b : key) {
+    b = rand_gen();
+  }
+  uint8_t bearer    = rand_gen() & 0x1f;
+  uint8_t direction = rand_gen() & 0x1;
+
+  test_batch_t batch(nof_pdus, 1600, in_place);
+  switch (alg) {
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+      security_128_eea1_batch(key, bearer, direction, batch.pdus.data(), nof_pdus);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2: {
+      security_aes128_ctx_t ctx;
+      security_aes128_init(&ctx, key);
+      if (not security_aes128_set_impl(&ctx, impl)) {
+        return SRSRAN_SUCCESS;
+      }
+      security_128_eea2_batch(&ctx, bearer, direction, batch.pdus.data(), nof_pdus);
+    } break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+      security_128_eea3_batch(key, bearer, direction, batch.pdus.data(), nof_pdus);
+      break;
+    default:
+      return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    std::vector<uint8_t> expected(batch.msg[i].size());
+    switch (alg) {
+      case CIPHERING_ALGORITHM_ID_128_EEA1:
+        security_128_eea1(
+            key, batch.pdus[i].count, bearer, direction, batch.msg[i].data(), batch.msg[i].size(), expected.data());
+        break;
+      case CIPHERING_ALGORITHM_ID_128_EEA2:
+        security_128_eea2(
+            key, batch.pdus[i].count, bearer, direction, batch.msg[i].data(), batch.msg[i].size(), expected.data());
+        break;
+      default:
+        security_128_eea3(
+            key, batch.pdus[i].count, bearer, direction, batch.msg[i].data(), batch.msg[i].size(), expected.data());
+        break;
+    }
+    TESTASSERT(expected == batch.out[i]);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_eia2(security_aes128_impl_t impl, uint32_t nof_pdus)
+{
+  uint8_t key[16];
+  for (uint8_t& b : key) {
+    b = rand_gen();
+  }
+  uint32_t bearer    = rand_gen() & 0x1f;
+  uint8_t  direction = rand_gen() & 0x1;
+
+  security_aes128_ctx_t ctx;
+  security_aes128_init(&ctx, key);
+  if (not security_aes128_set_impl(&ctx, impl)) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // Short PDUs, around the block boundaries, and long ones
+  test_batch_t batch(nof_pdus, nof_pdus % 2 ? 40 : 1600, false);
+  security_128_eia2_batch(&ctx, bearer, direction, batch.pdus.data(), nof_pdus);
+
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    uint8_t expected[4] = {};
+    security_128_eia2(
+        key, batch.pdus[i].count, bearer, direction, batch.msg[i].data(), batch.msg[i].size(), expected);
+    TESTASSERT(memcmp(expected, batch.mac[i].data(), 4) == 0);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  for (uint32_t nof_pdus : {1, 2, 7, 8, 9, 33}) {
+    for (bool in_place : {false, true}) {
+      TESTASSERT(test_eea(CIPHERING_ALGORITHM_ID_128_EEA1, SECURITY_AES128_GENERIC, nof_pdus, in_place) ==
+                 SRSRAN_SUCCESS);
+      TESTASSERT(test_eea(CIPHERING_ALGORITHM_ID_128_EEA3, SECURITY_AES128_GENERIC, nof_pdus, in_place) ==
+                 SRSRAN_SUCCESS);
+      for (uint32_t impl = 0; impl < SECURITY_AES128_N_ITEMS; impl++) {
+        TESTASSERT(test_eea(CIPHERING_ALGORITHM_ID_128_EEA2, (security_aes128_impl_t)impl, nof_pdus, in_place) ==
+                   SRSRAN_SUCCESS);
+      }
+    }
+    for (uint32_t impl = 0; impl < SECURITY_AES128_N_ITEMS; impl++) {
+      TESTASSERT(test_eia2((security_aes128_impl_t)impl, nof_pdus) == SRSRAN_SUCCESS);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
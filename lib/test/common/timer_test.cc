@@ -21,6 +21,7 @@
 
 #include "srsran/common/timers.h"
 #include "srsran/support/srsran_test.h"
+#include <chrono>
 #include <iostream>
 #include <random>
 #include <srsran/common/tti_sync_cv.h>
@@ -448,6 +449,74 @@ void timers_test7()
   TESTASSERT(timers.nof_running_timers() == 1 and timers.nof_timers() == 3);
 }
 
+/**
+ * Description: Benchmark of the timer_handler with a large number of concurrent timers
+ * - 100k timers are armed from two threads, with durations that span several levels of the wheel
+ * - one every ten timers is stopped from the second thread before expiring
+ * - every other timer shall expire exactly at its timeout
+ */
+void timers_test_100k()
+{
+  const uint32_t nof_timers    = 100000;
+  const uint32_t max_duration  = 20000;
+  const uint32_t long_duration = 1U << 20U;
+  timer_handler  timers(nof_timers);
+  std::mt19937   mt19937(7);
+
+  std::vector<unique_timer> utimers(nof_timers);
+  std::vector<uint32_t>     durations(nof_timers);
+  uint32_t                  cur_tic = 0, nof_expired = 0, nof_wrong_tic = 0;
+  for (uint32_t i = 0; i < nof_timers; ++i) {
+    // Mostly RLC/PDCP-like durations, and a few that need the upper levels of the wheel
+    durations[i] = (i % 1000 == 0) ? long_duration + i : 1 + mt19937() % max_duration;
+    utimers[i]   = timers.get_unique_timer();
+    utimers[i].set(durations[i], [&durations, &cur_tic, &nof_expired, &nof_wrong_tic](uint32_t tid) {
+      nof_expired++;
+      nof_wrong_tic += durations[tid] != cur_tic ? 1 : 0;
+    });
+  }
+
+  // Arm the timers from two threads
+  auto        tp_start = std::chrono::steady_clock::now();
+  std::thread thread([&utimers, nof_timers]() {
+    for (uint32_t i = 1; i < nof_timers; i += 2) {
+      utimers[i].run();
+    }
+    for (uint32_t i = 1; i < nof_timers; i += 10) {
+      utimers[i].stop();
+    }
+  });
+  for (uint32_t i = 0; i < nof_timers; i += 2) {
+    utimers[i].run();
+  }
+  thread.join();
+  auto tp_armed = std::chrono::steady_clock::now();
+  TESTASSERT(timers.nof_running_timers() == nof_timers - nof_timers / 10);
+
+  // Advance the time until all timers have expired
+  while (timers.nof_running_timers() > 0) {
+    cur_tic++;
+    timers.step_all();
+    TESTASSERT(cur_tic <= long_duration + nof_timers);
+  }
+  auto tp_end = std::chrono::steady_clock::now();
+
+  TESTASSERT(nof_expired == nof_timers - nof_timers / 10);
+  TESTASSERT(nof_wrong_tic == 0);
+  for (uint32_t i = 0; i < nof_timers; ++i) {
+    TESTASSERT(utimers[i].is_expired() == (i % 10 != 1));
+  }
+
+  auto arm_ns  = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_armed - tp_start).count();
+  auto step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_armed).count();
+  printf("Armed %d timers in %.1f ns/timer. Expired %d timers in %d step_all() calls, %.1f ns/step_all()\n",
+         nof_timers,
+         (double)arm_ns / nof_timers,
+         nof_expired,
+         cur_tic,
+         (double)step_ns / cur_tic);
+}
+
 int main()
 {
   timers_test1();
@@ -457,6 +526,7 @@ int main()
   timers_test5();
   timers_test6();
   timers_test7();
+  timers_test_100k();
   printf("Success\n");
   return 0;
 }
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/tti_trace.h"
+#include "srsran/common/test_common.h"
+#include <fstream>
+#include <pthread.h>
+#include <sstream>
+#include <thread>
+
+static const char* trace_filename = "/tmp/tti_trace_test.json";
+
+static std::string read_file(const char* filename)
+{
+  std::ifstream     f(filename);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+static uint32_t count_occurrences(const std::string& text, const std::string& pattern)
+{
+  uint32_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+    count++;
+  }
+  return count;
+}
+
+void test_ring_wrap_around()
+{
+  // Rounded up to 8 events
+  srsran::tti_trace_ring ring(5, "test", 1);
+  TESTASSERT(ring.snapshot().empty());
+
+  for (uint32_t i = 0; i < 20; ++i) {
+    ring.push({"CAT", "event", i, 1, i});
+  }
+  // The slot of the oldest event is the next one to be written, so it is never exported
+  std::vector<srsran::tti_trace_event_t> events = ring.snapshot();
+  TESTASSERT(events.size() == 7);
+  TESTASSERT(ring.nof_lost() == 13);
+  for (uint32_t i = 0; i < events.size(); ++i) {
+    TESTASSERT(events[i].start_ns == 13 + i);
+    TESTASSERT(events[i].tti == 13 + i);
+  }
+}
+
+void test_ring_concurrent_snapshot()
+{
+  srsran::tti_trace_ring ring(8, "test", 1);
+  std::atomic<bool>      stop = {false};
+
+  // The writer keeps wrapping around the ring while it is being copied
+  std::thread writer([&ring, &stop]() {
+    for (uint32_t i = 0; not stop; ++i) {
+      ring.push({"CAT", "event", i, 1, i});
+    }
+  });
+  for (uint32_t n = 0; n < 10000; ++n) {
+    std::vector<srsran::tti_trace_event_t> events = ring.snapshot();
+    TESTASSERT(events.size() < 8);
+    for (uint32_t i = 0; i < events.size(); ++i) {
+      TESTASSERT(events[i].start_ns == events[i].tti);
+      TESTASSERT(i == 0 or events[i].tti == events[i - 1].tti + 1);
+    }
+  }
+  stop = true;
+  writer.join();
+}
+
+void test_disabled()
+{
+  TESTASSERT(not srsran::tti_trace_is_enabled());
+  {
+    tti_trace_event("CAT", "disabled_event", 0);
+  }
+  TESTASSERT(srsran::tti_trace_write(trace_filename));
+  TESTASSERT(count_occurrences(read_file(trace_filename), "\"ph\":\"X\"") == 0);
+}
+
+void test_threads()
+{
+  const uint32_t nof_events = 100;
+
+  TESTASSERT(srsran::tti_trace_init(trace_filename, 1024));
+  TESTASSERT(srsran::tti_trace_is_enabled());
+
+  // Both workers are alive until both have recorded their events, so each one gets its own ring
+  std::atomic<uint32_t> nof_done = {0};
+
+  auto worker = [nof_events, &nof_done](const char* thread_name) {
+    pthread_setname_np(pthread_self(), thread_name);
+    for (uint32_t tti = 0; tti < nof_events; ++tti) {
+      tti_trace_event("PHY", "worker_tti", tti);
+      tti_trace_event("MAC", "no_tti_event");
+    }
+    nof_done++;
+    while (nof_done < 2) {
+      std::this_thread::yield();
+    }
+  };
+  std::thread t1(worker, "TEST_WORKER1");
+  std::thread t2(worker, "TEST_WORKER2");
+  t1.join();
+  t2.join();
+
+  // Nothing is recorded once stopped
+  srsran::tti_trace_stop();
+  {
+    tti_trace_event("CAT", "stopped_event", 0);
+  }
+
+  TESTASSERT(srsran::tti_trace_write());
+  std::string trace = read_file(trace_filename);
+  TESTASSERT(trace.front() == '{');
+  TESTASSERT(trace.find("]}") != std::string::npos);
+  TESTASSERT(count_occurrences(trace, "\"name\":\"TEST_WORKER1\"") == 1);
+  TESTASSERT(count_occurrences(trace, "\"name\":\"TEST_WORKER2\"") == 1);
+  TESTASSERT(count_occurrences(trace, "\"name\":\"worker_tti\"") == 2 * nof_events);
+  TESTASSERT(count_occurrences(trace, "\"name\":\"no_tti_event\"") == 2 * nof_events);
+  TESTASSERT(count_occurrences(trace, "\"args\":{\"tti\":") == 2 * nof_events);
+  TESTASSERT(count_occurrences(trace, "\"args\":{\"tti\":42}") == 2);
+  TESTASSERT(count_occurrences(trace, "stopped_event") == 0);
+}
+
+void test_exited_threads_reuse_rings()
+{
+  const uint32_t nof_threads = 10;
+
+  // The rings of TEST_WORKER1 and TEST_WORKER2 are free, as both threads have exited
+  TESTASSERT(srsran::tti_trace_init(trace_filename, 1024));
+  for (uint32_t i = 0; i < nof_threads; ++i) {
+    std::thread t([i]() {
+      std::string thread_name = "TEST_SEQ" + std::to_string(i);
+      pthread_setname_np(pthread_self(), thread_name.c_str());
+      tti_trace_event("PHY", "seq_tti", i);
+    });
+    t.join();
+  }
+  srsran::tti_trace_stop();
+
+  // Every thread reused a ring and discarded the events of its previous writer
+  TESTASSERT(srsran::tti_trace_write());
+  std::string trace = read_file(trace_filename);
+  TESTASSERT(count_occurrences(trace, "\"ph\":\"M\"") == 2);
+  TESTASSERT(count_occurrences(trace, "\"name\":\"TEST_SEQ" + std::to_string(nof_threads - 1) + "\"") == 1);
+  TESTASSERT(count_occurrences(trace, "\"name\":\"seq_tti\"") == 1);
+}
+
+int main()
+{
+  test_ring_wrap_around();
+  test_ring_concurrent_snapshot();
+  test_disabled();
+  test_threads();
+  test_exited_threads_reuse_rings();
+
+  remove(trace_filename);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,689 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Replays a subframe aligned IQ capture through the LTE receive chain of the UE (PDSCH) or the eNb (PUSCH) as fast as
+ * possible, without any real-time pacing, and reports the time spent in every stage of the chain and the number of
+ * TTIs processed per second. The capture is memory mapped, so that the file reads stay out of the measurements.
+ *
+ * The capture contains single antenna complex float samples at the sampling rate of the cell bandwidth, starting
+ * at the sample offset given with -o, and it is processed with the same srsran_ue_dl and srsran_enb_ul objects that
+ * the PHY workers run. The UE searches the PDSCH grants of the RNTI in the PDCCH, while the eNb assumes a full band
+ * PUSCH grant with the given MCS in every subframe. When no capture is given, a synthetic one is generated first,
+ * optionally kept in the file given with -w.
+ */
+
+#include "srsran/srsran.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAX_DATABUFFER_SIZE (6144 * 16 * 3 / 8)
+
+static srsran_cell_t cell = {.nof_prb         = 25,
+                             .nof_ports       = 1,
+                             .id              = 1,
+                             .cp              = SRSRAN_CP_NORM,
+                             .phich_resources = SRSRAN_PHICH_R_1,
+                             .phich_length    = SRSRAN_PHICH_NORM};
+
+static char*    input_file_name  = NULL;
+static char*    output_file_name = NULL;
+static bool     uplink           = false;
+static uint16_t rnti             = 0x1234;
+static uint32_t mcs              = 20;
+static uint32_t cfi              = 2;
+static uint32_t nof_subframes    = 100;
+static uint32_t nof_loops        = 1;
+static uint32_t sample_offset    = 0;
+static uint32_t first_tti        = 0;
+static float    snr_db           = 30.0f;
+
+typedef enum {
+  STAGE_FFT = 0,
+  STAGE_CHEST,
+  STAGE_PDCCH,
+  STAGE_EQUALIZER,
+  STAGE_DEMOD,
+  STAGE_DECODE,
+  STAGE_TOTAL,
+  NOF_STAGES
+} stage_t;
+
+static const char* stage_names[NOF_STAGES] = {"FFT", "Chest", "PDCCH", "Equaliser", "Demod", "Decode", "Total"};
+
+typedef struct {
+  uint64_t stage_ns[NOF_STAGES];
+  uint64_t nof_ttis;
+  uint64_t nof_tbs;
+  uint64_t nof_tbs_ok;
+  uint64_t nof_bits_ok;
+} bench_stats_t;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [iwUpcrmfsSoltv]\n", prog);
+  printf("\t-i capture file to replay [Default: generate a synthetic capture]\n");
+  printf("\t-w file where the synthetic capture is kept [Default: temporary file]\n");
+  printf("\t-U replay the uplink (eNb PUSCH) instead of the downlink (UE PDSCH) [Default %s]\n", uplink ? "yes" : "no");
+  printf("\t-p cell.nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-c cell id [Default %d]\n", cell.id);
+  printf("\t-r rnti [Default 0x%x]\n", rnti);
+  printf("\t-m mcs of the synthetic capture and of the uplink grant [Default %d]\n", mcs);
+  printf("\t-f cfi of the synthetic capture [Default %d]\n", cfi);
+  printf("\t-s number of subframes of the synthetic capture [Default %d]\n", nof_subframes);
+  printf("\t-S SNR in dB of the synthetic capture [Default %+.2f]\n", snr_db);
+  printf("\t-o sample offset of the first subframe in the capture [Default %d]\n", sample_offset);
+  printf("\t-l number of times the capture is replayed [Default %d]\n", nof_loops);
+  printf("\t-t TTI of the first subframe in the capture [Default %d]\n", first_tti);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "iwUpcrmfsSoltv")) != -1) {
+    switch (opt) {
+      case 'i':
+        input_file_name = argv[optind];
+        break;
+      case 'w':
+        output_file_name = argv[optind];
+        break;
+      case 'U':
+        uplink = true;
+        break;
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'c':
+        cell.id = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        rnti = (uint16_t)strtol(argv[optind], NULL, 0);
+        break;
+      case 'm':
+        mcs = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        cfi = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        nof_subframes = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'o':
+        sample_offset = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        nof_loops = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        first_tti = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/// Full band grant used by the synthetic uplink capture and assumed by the uplink replay
+static void set_ul_dci(srsran_dci_ul_t* dci)
+{
+  ZERO_OBJECT(*dci);
+  dci->rnti            = rnti;
+  dci->format          = SRSRAN_DCI_FORMAT0;
+  dci->type2_alloc.riv = srsran_ra_type2_to_riv(cell.nof_prb, 0, cell.nof_prb);
+  dci->freq_hop_fl     = SRSRAN_RA_PUSCH_HOP_DISABLED;
+  dci->tb.mcs_idx      = mcs;
+  dci->tb.rv           = 0;
+  dci->tb.ndi          = 0;
+}
+
+static int generate_dl(FILE* f)
+{
+  int                    ret           = SRSRAN_ERROR;
+  srsran_enb_dl_t*       enb_dl        = srsran_vec_malloc(sizeof(srsran_enb_dl_t));
+  cf_t*                  signal_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(cell.nof_prb));
+  uint8_t*               data_tx       = srsran_vec_u8_malloc(MAX_DATABUFFER_SIZE);
+  srsran_random_t        random        = srsran_random_init(0);
+  srsran_softbuffer_tx_t softbuffer_tx = {};
+  srsran_channel_awgn_t  awgn          = {};
+
+  if (!enb_dl || !signal_buffer || !data_tx) {
+    ERROR("Error allocating memory");
+    goto quit;
+  }
+  cf_t* buffers[SRSRAN_MAX_PORTS] = {signal_buffer};
+  if (srsran_enb_dl_init(enb_dl, buffers, cell.nof_prb) || srsran_enb_dl_set_cell(enb_dl, cell)) {
+    ERROR("Error initiating eNb downlink");
+    goto quit;
+  }
+  if (srsran_softbuffer_tx_init(&softbuffer_tx, cell.nof_prb)) {
+    ERROR("Error initiating softbuffer_tx");
+    goto quit;
+  }
+  if (srsran_channel_awgn_init(&awgn, 0x1234) ||
+      srsran_channel_awgn_set_n0(&awgn, srsran_enb_dl_get_maximum_signal_power_dBfs(cell.nof_prb) - snr_db)) {
+    ERROR("Error initiating AWGN");
+    goto quit;
+  }
+
+  srsran_dci_cfg_t dci_cfg    = {};
+  srsran_dci_dl_t  dci        = {};
+  dci.rnti                    = rnti;
+  dci.format                  = SRSRAN_DCI_FORMAT1;
+  dci.alloc_type              = SRSRAN_RA_ALLOC_TYPE0;
+  dci.type0_alloc.rbg_bitmask = 0xffffffff;
+  dci.tb[0].rv                = 0;
+  dci.tb[0].cw_idx            = 0;
+  dci.tb[1].rv                = 1;
+
+  for (uint32_t sf_idx = 0; sf_idx < nof_subframes; sf_idx++) {
+    srsran_dl_sf_cfg_t sf_cfg_dl = {};
+    sf_cfg_dl.tti                = (first_tti + sf_idx) % 10240;
+    sf_cfg_dl.cfi                = cfi;
+    sf_cfg_dl.sf_type            = SRSRAN_SF_NORM;
+
+    srsran_dci_location_t locations[SRSRAN_MAX_CANDIDATES_UE];
+    uint32_t              nof_locations =
+        srsran_pdcch_ue_locations(&enb_dl->pdcch, &sf_cfg_dl, locations, SRSRAN_MAX_CANDIDATES_UE, rnti);
+    if (nof_locations == 0) {
+      ERROR("No PDCCH locations for rnti=0x%x", rnti);
+      goto quit;
+    }
+    dci.location = locations[sf_idx % nof_locations];
+
+    // The synchronisation signals and the PBCH leave too few resource elements in a 6 PRB cell
+    dci.tb[0].mcs_idx = (cell.nof_prb == 6 && sf_cfg_dl.tti % 5 == 0) ? 0 : mcs;
+
+    srsran_pdsch_cfg_t pdsch_cfg = {};
+    if (srsran_ra_dl_dci_to_grant(&cell, &sf_cfg_dl, SRSRAN_TM1, false, &dci, &pdsch_cfg.grant)) {
+      ERROR("Computing DL grant sf_idx=%d", sf_idx);
+      goto quit;
+    }
+    pdsch_cfg.softbuffers.tx[0] = &softbuffer_tx;
+    pdsch_cfg.rnti              = rnti;
+
+    uint8_t* data[SRSRAN_MAX_TB] = {data_tx};
+    srsran_random_byte_vector(random, data_tx, pdsch_cfg.grant.tb[0].tbs / 8);
+
+    srsran_enb_dl_put_base(enb_dl, &sf_cfg_dl);
+    if (srsran_enb_dl_put_pdcch_dl(enb_dl, &dci_cfg, &dci) || srsran_enb_dl_put_pdsch(enb_dl, &pdsch_cfg, data)) {
+      ERROR("Error putting PDCCH/PDSCH sf_idx=%d", sf_idx);
+      goto quit;
+    }
+    srsran_enb_dl_gen_signal(enb_dl);
+    srsran_channel_awgn_run_c(&awgn, signal_buffer, signal_buffer, SRSRAN_SF_LEN_PRB(cell.nof_prb));
+
+    if (fwrite(signal_buffer, sizeof(cf_t), SRSRAN_SF_LEN_PRB(cell.nof_prb), f) != SRSRAN_SF_LEN_PRB(cell.nof_prb)) {
+      perror("fwrite");
+      goto quit;
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+quit:
+  if (enb_dl) {
+    srsran_enb_dl_free(enb_dl);
+    free(enb_dl);
+  }
+  srsran_softbuffer_tx_free(&softbuffer_tx);
+  srsran_channel_awgn_free(&awgn);
+  srsran_random_free(random);
+  if (signal_buffer) {
+    free(signal_buffer);
+  }
+  if (data_tx) {
+    free(data_tx);
+  }
+  return ret;
+}
+
+static int generate_ul(FILE* f)
+{
+  int                    ret           = SRSRAN_ERROR;
+  srsran_ue_ul_t*        ue_ul         = srsran_vec_malloc(sizeof(srsran_ue_ul_t));
+  cf_t*                  signal_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(cell.nof_prb));
+  uint8_t*               data_tx       = srsran_vec_u8_malloc(MAX_DATABUFFER_SIZE);
+  srsran_random_t        random        = srsran_random_init(0);
+  srsran_softbuffer_tx_t softbuffer_tx = {};
+  srsran_channel_awgn_t  awgn          = {};
+
+  if (!ue_ul || !signal_buffer || !data_tx) {
+    ERROR("Error allocating memory");
+    goto quit;
+  }
+  if (srsran_ue_ul_init(ue_ul, signal_buffer, cell.nof_prb) || srsran_ue_ul_set_cell(ue_ul, cell)) {
+    ERROR("Error initiating UE uplink");
+    goto quit;
+  }
+  if (srsran_softbuffer_tx_init(&softbuffer_tx, cell.nof_prb)) {
+    ERROR("Error initiating softbuffer_tx");
+    goto quit;
+  }
+  if (srsran_channel_awgn_init(&awgn, 0x1234)) {
+    ERROR("Error initiating AWGN");
+    goto quit;
+  }
+
+  srsran_dci_ul_t dci;
+  set_ul_dci(&dci);
+
+  srsran_ue_ul_cfg_t ue_ul_cfg             = {};
+  ue_ul_cfg.ul_cfg.pusch.rnti              = rnti;
+  ue_ul_cfg.ul_cfg.pusch.enable_64qam      = true;
+  ue_ul_cfg.ul_cfg.pusch.softbuffers.tx    = &softbuffer_tx;
+  ue_ul_cfg.ul_cfg.hopping.hopping_enabled = false;
+  ue_ul_cfg.grant_available                = true;
+  ue_ul_cfg.normalize_mode                 = SRSRAN_UE_UL_NORMALIZE_MODE_AUTO;
+
+  for (uint32_t sf_idx = 0; sf_idx < nof_subframes; sf_idx++) {
+    srsran_ul_sf_cfg_t ul_sf = {};
+    ul_sf.tti                = (first_tti + sf_idx) % 10240;
+
+    if (srsran_ue_ul_dci_to_pusch_grant(ue_ul, &ul_sf, &ue_ul_cfg, &dci, &ue_ul_cfg.ul_cfg.pusch.grant)) {
+      ERROR("Computing UL grant sf_idx=%d", sf_idx);
+      goto quit;
+    }
+    srsran_softbuffer_tx_reset(&softbuffer_tx);
+    srsran_random_byte_vector(random, data_tx, ue_ul_cfg.ul_cfg.pusch.grant.tb.tbs / 8);
+
+    srsran_pusch_data_t pusch_data = {};
+    pusch_data.ptr                 = data_tx;
+    if (srsran_ue_ul_encode(ue_ul, &ul_sf, &ue_ul_cfg, &pusch_data) < SRSRAN_SUCCESS) {
+      ERROR("Error encoding PUSCH sf_idx=%d", sf_idx);
+      goto quit;
+    }
+
+    // The UE normalises its output, so the noise is set relative to the transmitted power
+    float signal_power_dB =
+        srsran_convert_power_to_dB(srsran_vec_avg_power_cf(signal_buffer, SRSRAN_SF_LEN_PRB(cell.nof_prb)));
+    srsran_channel_awgn_set_n0(&awgn, signal_power_dB - snr_db);
+    srsran_channel_awgn_run_c(&awgn, signal_buffer, signal_buffer, SRSRAN_SF_LEN_PRB(cell.nof_prb));
+
+    if (fwrite(signal_buffer, sizeof(cf_t), SRSRAN_SF_LEN_PRB(cell.nof_prb), f) != SRSRAN_SF_LEN_PRB(cell.nof_prb)) {
+      perror("fwrite");
+      goto quit;
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+quit:
+  if (ue_ul) {
+    srsran_ue_ul_free(ue_ul);
+    free(ue_ul);
+  }
+  srsran_softbuffer_tx_free(&softbuffer_tx);
+  srsran_channel_awgn_free(&awgn);
+  srsran_random_free(random);
+  if (signal_buffer) {
+    free(signal_buffer);
+  }
+  if (data_tx) {
+    free(data_tx);
+  }
+  return ret;
+}
+
+static int replay_dl(cf_t* capture, uint32_t nof_sf, bench_stats_t* stats)
+{
+  int                    ret           = SRSRAN_ERROR;
+  srsran_ue_dl_t*        ue_dl         = srsran_vec_malloc(sizeof(srsran_ue_dl_t));
+  cf_t*                  signal_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(cell.nof_prb));
+  uint8_t*               data_rx       = srsran_vec_u8_malloc(MAX_DATABUFFER_SIZE);
+  srsran_softbuffer_rx_t softbuffer_rx = {};
+  uint32_t               sf_len        = SRSRAN_SF_LEN_PRB(cell.nof_prb);
+
+  if (!ue_dl || !signal_buffer || !data_rx) {
+    ERROR("Error allocating memory");
+    goto quit;
+  }
+  cf_t* buffers[SRSRAN_MAX_PORTS] = {signal_buffer};
+  if (srsran_ue_dl_init(ue_dl, buffers, cell.nof_prb, 1) || srsran_ue_dl_set_cell(ue_dl, cell)) {
+    ERROR("Error initiating UE downlink");
+    goto quit;
+  }
+  if (srsran_softbuffer_rx_init(&softbuffer_rx, cell.nof_prb)) {
+    ERROR("Error initiating softbuffer_rx");
+    goto quit;
+  }
+
+  srsran_ue_dl_cfg_t ue_dl_cfg           = {};
+  ue_dl_cfg.cfg.tm                       = SRSRAN_TM1;
+  ue_dl_cfg.cfg.pdsch.decoder_type       = SRSRAN_MIMO_DECODER_MMSE;
+  ue_dl_cfg.cfg.pdsch.max_nof_iterations = 10;
+  ue_dl_cfg.cfg.pdsch.meas_time_en       = true;
+  ue_dl_cfg.cfg.pdsch.rnti               = rnti;
+  ue_dl_cfg.cfg.pdsch.softbuffers.rx[0]  = &softbuffer_rx;
+  ue_dl_cfg.chest_cfg.filter_coef[0]     = 4;
+  ue_dl_cfg.chest_cfg.filter_coef[1]     = 1;
+  ue_dl_cfg.chest_cfg.filter_type        = SRSRAN_CHEST_FILTER_GAUSS;
+  ue_dl_cfg.chest_cfg.noise_alg          = SRSRAN_NOISE_ALG_REFS;
+  ue_dl_cfg.chest_cfg.estimator_alg      = SRSRAN_ESTIMATOR_ALG_AVERAGE;
+
+  for (uint32_t loop = 0; loop < nof_loops; loop++) {
+    for (uint32_t sf_idx = 0; sf_idx < nof_sf; sf_idx++) {
+      srsran_dl_sf_cfg_t sf_cfg_dl                       = {};
+      srsran_dci_dl_t    dci_dl[SRSRAN_MAX_DCI_MSG]      = {};
+      srsran_pdsch_res_t pdsch_res[SRSRAN_MAX_CODEWORDS] = {};
+      uint64_t           t[5]                            = {};
+      sf_cfg_dl.tti                                      = (first_tti + sf_idx) % 10240;
+      sf_cfg_dl.sf_type                                  = SRSRAN_SF_NORM;
+      pdsch_res[0].payload                               = data_rx;
+
+      t[0] = srsran_phch_meas_time_now();
+      srsran_ofdm_rx_sf_ng(&ue_dl->fft[0], &capture[sf_idx * sf_len], ue_dl->sf_symbols[0]);
+      t[1] = srsran_phch_meas_time_now();
+      if (srsran_ue_dl_estimate(ue_dl, &sf_cfg_dl, &ue_dl_cfg) < SRSRAN_SUCCESS) {
+        ERROR("Estimating channel sf_idx=%d", sf_idx);
+        goto quit;
+      }
+      t[2]           = srsran_phch_meas_time_now();
+      int nof_grants = srsran_ue_dl_find_dl_dci(ue_dl, &sf_cfg_dl, &ue_dl_cfg, rnti, dci_dl);
+      t[3]           = srsran_phch_meas_time_now();
+
+      bool decoded = false;
+      if (nof_grants > 0 &&
+          srsran_ue_dl_dci_to_pdsch_grant(ue_dl, &sf_cfg_dl, &ue_dl_cfg, &dci_dl[0], &ue_dl_cfg.cfg.pdsch.grant) ==
+              SRSRAN_SUCCESS) {
+        srsran_softbuffer_rx_reset(&softbuffer_rx);
+        if (srsran_ue_dl_decode_pdsch(ue_dl, &sf_cfg_dl, &ue_dl_cfg.cfg.pdsch, pdsch_res)) {
+          ERROR("Decoding PDSCH sf_idx=%d", sf_idx);
+          goto quit;
+        }
+        decoded = true;
+      }
+      t[4] = srsran_phch_meas_time_now();
+
+      stats->stage_ns[STAGE_FFT] += t[1] - t[0];
+      stats->stage_ns[STAGE_CHEST] += t[2] - t[1];
+      stats->stage_ns[STAGE_PDCCH] += t[3] - t[2];
+      stats->stage_ns[STAGE_TOTAL] += t[4] - t[0];
+      stats->nof_ttis++;
+      if (decoded) {
+        stats->stage_ns[STAGE_EQUALIZER] += ue_dl_cfg.cfg.pdsch.meas_time_stages.equalizer_ns;
+        stats->stage_ns[STAGE_DEMOD] += ue_dl_cfg.cfg.pdsch.meas_time_stages.demod_ns;
+        stats->stage_ns[STAGE_DECODE] += ue_dl_cfg.cfg.pdsch.meas_time_stages.decode_ns;
+        stats->nof_tbs++;
+        if (pdsch_res[0].crc) {
+          stats->nof_tbs_ok++;
+          stats->nof_bits_ok += ue_dl_cfg.cfg.pdsch.grant.tb[0].tbs;
+        }
+      }
+
+      if (get_srsran_verbose_level() >= SRSRAN_VERBOSE_INFO && decoded) {
+        char str[512];
+        srsran_pdsch_rx_info(&ue_dl_cfg.cfg.pdsch, pdsch_res, str, sizeof(str));
+        INFO("sf_idx=%d, cfi=%d, %s", sf_idx, sf_cfg_dl.cfi, str);
+      }
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+quit:
+  if (ue_dl) {
+    srsran_ue_dl_free(ue_dl);
+    free(ue_dl);
+  }
+  srsran_softbuffer_rx_free(&softbuffer_rx);
+  if (signal_buffer) {
+    free(signal_buffer);
+  }
+  if (data_rx) {
+    free(data_rx);
+  }
+  return ret;
+}
+
+static int replay_ul(cf_t* capture, uint32_t nof_sf, bench_stats_t* stats)
+{
+  int                               ret           = SRSRAN_ERROR;
+  srsran_enb_ul_t*                  enb_ul        = srsran_vec_malloc(sizeof(srsran_enb_ul_t));
+  cf_t*                             signal_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(cell.nof_prb));
+  uint8_t*                          data_rx       = srsran_vec_u8_malloc(MAX_DATABUFFER_SIZE);
+  srsran_softbuffer_rx_t            softbuffer_rx = {};
+  srsran_refsignal_dmrs_pusch_cfg_t dmrs_cfg      = {};
+  uint32_t                          sf_len        = SRSRAN_SF_LEN_PRB(cell.nof_prb);
+
+  if (!enb_ul || !signal_buffer || !data_rx) {
+    ERROR("Error allocating memory");
+    goto quit;
+  }
+  if (srsran_enb_ul_init(enb_ul, signal_buffer, cell.nof_prb) ||
+      srsran_enb_ul_set_cell(enb_ul, cell, &dmrs_cfg, NULL)) {
+    ERROR("Error initiating eNb uplink");
+    goto quit;
+  }
+  if (srsran_softbuffer_rx_init(&softbuffer_rx, cell.nof_prb)) {
+    ERROR("Error initiating softbuffer_rx");
+    goto quit;
+  }
+
+  srsran_dci_ul_t dci;
+  set_ul_dci(&dci);
+
+  srsran_pusch_hopping_cfg_t hopping   = {};
+  srsran_pusch_cfg_t         pusch_cfg = {};
+  pusch_cfg.rnti                       = rnti;
+  pusch_cfg.enable_64qam               = true;
+  pusch_cfg.max_nof_iterations         = 8;
+  pusch_cfg.meas_time_en               = true;
+  pusch_cfg.softbuffers.rx             = &softbuffer_rx;
+
+  for (uint32_t loop = 0; loop < nof_loops; loop++) {
+    for (uint32_t sf_idx = 0; sf_idx < nof_sf; sf_idx++) {
+      srsran_ul_sf_cfg_t ul_sf     = {};
+      srsran_pusch_res_t pusch_res = {};
+      uint64_t           t[4]      = {};
+      ul_sf.tti                    = (first_tti + sf_idx) % 10240;
+      pusch_res.data               = data_rx;
+
+      if (srsran_ra_ul_dci_to_grant(&cell, &ul_sf, &hopping, &dci, &pusch_cfg.grant)) {
+        ERROR("Computing UL grant sf_idx=%d", sf_idx);
+        goto quit;
+      }
+      srsran_softbuffer_rx_reset(&softbuffer_rx);
+
+      // The FFT removes the half subcarrier shift in place, so the subframe is copied as the radio would do
+      srsran_vec_cf_copy(signal_buffer, &capture[sf_idx * sf_len], sf_len);
+
+      t[0] = srsran_phch_meas_time_now();
+      srsran_enb_ul_fft(enb_ul);
+      t[1] = srsran_phch_meas_time_now();
+      srsran_chest_ul_estimate_pusch(&enb_ul->chest, &ul_sf, &pusch_cfg, enb_ul->sf_symbols, &enb_ul->chest_res);
+      t[2] = srsran_phch_meas_time_now();
+      if (srsran_pusch_decode(&enb_ul->pusch, &ul_sf, &pusch_cfg, &enb_ul->chest_res, enb_ul->sf_symbols, &pusch_res)) {
+        ERROR("Decoding PUSCH sf_idx=%d", sf_idx);
+        goto quit;
+      }
+      t[3] = srsran_phch_meas_time_now();
+
+      stats->stage_ns[STAGE_FFT] += t[1] - t[0];
+      stats->stage_ns[STAGE_CHEST] += t[2] - t[1];
+      stats->stage_ns[STAGE_EQUALIZER] += pusch_cfg.meas_time_stages.equalizer_ns;
+      stats->stage_ns[STAGE_DEMOD] += pusch_cfg.meas_time_stages.demod_ns;
+      stats->stage_ns[STAGE_DECODE] += pusch_cfg.meas_time_stages.decode_ns;
+      stats->stage_ns[STAGE_TOTAL] += t[3] - t[0];
+      stats->nof_ttis++;
+      stats->nof_tbs++;
+      if (pusch_res.crc) {
+        stats->nof_tbs_ok++;
+        stats->nof_bits_ok += pusch_cfg.grant.tb.tbs;
+      }
+
+      INFO("sf_idx=%d, crc=%s, snr=%+.1f dB, its=%.1f",
+           sf_idx,
+           pusch_res.crc ? "OK" : "KO",
+           enb_ul->chest_res.snr_db,
+           pusch_res.avg_iterations_block);
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+quit:
+  if (enb_ul) {
+    srsran_enb_ul_free(enb_ul);
+    free(enb_ul);
+  }
+  srsran_softbuffer_rx_free(&softbuffer_rx);
+  if (signal_buffer) {
+    free(signal_buffer);
+  }
+  if (data_rx) {
+    free(data_rx);
+  }
+  return ret;
+}
+
+static void print_stats(const bench_stats_t* stats)
+{
+  double nof_ttis = SRSRAN_MAX(stats->nof_ttis, 1);
+  double total_s  = stats->stage_ns[STAGE_TOTAL] / 1e9;
+
+  printf("%s, %d PRB: %ld TTIs, %ld TBs, BLER %.2f%%\n",
+         uplink ? "PUSCH" : "PDSCH",
+         cell.nof_prb,
+         (long)stats->nof_ttis,
+         (long)stats->nof_tbs,
+         100.0 * (stats->nof_tbs - stats->nof_tbs_ok) / SRSRAN_MAX(stats->nof_tbs, 1));
+  printf("%10s %10s %6s\n", "Stage", "us/TTI", "%");
+  for (uint32_t i = 0; i < NOF_STAGES; i++) {
+    if (uplink && i == STAGE_PDCCH) {
+      continue;
+    }
+    printf("%10s %10.1f %6.1f\n",
+           stage_names[i],
+           stats->stage_ns[i] / nof_ttis / 1e3,
+           100.0 * stats->stage_ns[i] / SRSRAN_MAX(stats->stage_ns[STAGE_TOTAL], 1));
+  }
+  printf("Throughput: %.1f TTIs/s, %.1f Mbps decoded\n",
+         stats->nof_ttis / SRSRAN_MAX(total_s, 1e-9),
+         stats->nof_bits_ok / SRSRAN_MAX(total_s, 1e-9) / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+  int           ret          = SRSRAN_ERROR;
+  int           fd           = -1;
+  void*         map          = MAP_FAILED;
+  size_t        map_len      = 0;
+  bool          is_synthetic = false;
+  char          tmp_name[]   = "/tmp/phy_replay_benchXXXXXX";
+  bench_stats_t stats        = {};
+
+  parse_args(argc, argv);
+
+  /*
+   * Generate a synthetic capture if none is given
+   */
+  if (input_file_name == NULL) {
+    FILE* f = NULL;
+    if (output_file_name) {
+      f = fopen(output_file_name, "w");
+    } else {
+      int tmp_fd = mkstemp(tmp_name);
+      if (tmp_fd >= 0) {
+        f = fdopen(tmp_fd, "w");
+      }
+      output_file_name = tmp_name;
+    }
+    if (f == NULL) {
+      perror("Opening capture file");
+      goto quit;
+    }
+    int gen_ret = uplink ? generate_ul(f) : generate_dl(f);
+    fclose(f);
+    if (gen_ret) {
+      goto quit;
+    }
+    input_file_name = output_file_name;
+    is_synthetic    = true;
+  }
+
+  /*
+   * Map the capture
+   */
+  fd = open(input_file_name, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) < 0) {
+    perror("Opening capture file");
+    goto quit;
+  }
+  map_len = (size_t)st.st_size;
+  if (map_len < (size_t)sample_offset * sizeof(cf_t)) {
+    ERROR("The sample offset %d exceeds the capture length", sample_offset);
+    goto quit;
+  }
+  uint32_t nof_sf = (map_len / sizeof(cf_t) - sample_offset) / SRSRAN_SF_LEN_PRB(cell.nof_prb);
+  if (nof_sf == 0) {
+    ERROR("The capture %s does not contain a complete subframe", input_file_name);
+    goto quit;
+  }
+  map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    perror("mmap");
+    goto quit;
+  }
+  madvise(map, map_len, MADV_SEQUENTIAL);
+
+  /*
+   * Replay
+   */
+  cf_t* capture = (cf_t*)map + sample_offset;
+  if ((uplink ? replay_ul(capture, nof_sf, &stats) : replay_dl(capture, nof_sf, &stats)) != SRSRAN_SUCCESS) {
+    goto quit;
+  }
+  print_stats(&stats);
+
+  // A synthetic capture must be decoded without errors
+  if (stats.nof_tbs == 0 || (is_synthetic && stats.nof_tbs_ok != stats.nof_tbs)) {
+    ERROR("Decoded %ld of %ld transport blocks", (long)stats.nof_tbs_ok, (long)stats.nof_tbs);
+    goto quit;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+quit:
+  if (map != MAP_FAILED) {
+    munmap(map, map_len);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (output_file_name == tmp_name) {
+    unlink(tmp_name);
+  }
+  return ret;
+}
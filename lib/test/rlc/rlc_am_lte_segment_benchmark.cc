@@ -0,0 +1,214 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Cost of the RLC AM RX reassembly of heavily segmented retransmissions. For every window of PDUs, the first
+ * transmissions are lost and the TX entity retransmits all of them in small segments, several times and with different
+ * grant sizes. The overlapping segments are delivered to the RX entity in random order, with duplicates, and the time
+ * spent in the RX entity is measured. All SDUs must be delivered.
+ */
+
+#include "rlc_test_common.h"
+#include "srsran/common/test_common.h"
+#include "srsran/common/timers.h"
+#include "srsran/rlc/rlc_am_lte.h"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace bpo = boost::program_options;
+using namespace srsran;
+
+struct bench_args_t {
+  uint32_t nof_windows  = 100;
+  uint32_t nof_sdus     = 64;
+  uint32_t sdu_size     = 1000;
+  uint32_t pdu_size     = 1500;
+  uint32_t segment_size = 64;
+  uint32_t nof_retx     = 2;
+  float    dup_rate     = 0.1;
+  uint32_t seed         = 0;
+};
+
+struct bench_result_t {
+  uint64_t nof_segments = 0;
+  uint64_t nof_sdus     = 0;
+  double   rx_time_s    = 0;
+};
+
+using segment_list_t = std::vector<std::vector<uint8_t> >;
+
+/// Reads PDUs from the TX entity until it has nothing else to transmit, with a random grant size in [min_sz, max_sz]
+static void read_pdus(rlc_am& tx, uint32_t min_sz, uint32_t max_sz, std::mt19937& rnd, segment_list_t& pdus)
+{
+  std::uniform_int_distribution<uint32_t> grant_dist(min_sz, max_sz);
+  while (tx.get_buffer_state() > 0) {
+    std::vector<uint8_t> pdu(grant_dist(rnd));
+    uint32_t             len = tx.read_pdu(pdu.data(), pdu.size());
+    if (len == 0) {
+      break;
+    }
+    pdu.resize(len);
+    pdus.push_back(std::move(pdu));
+  }
+}
+
+/// NACKs all the PDUs transmitted so far
+static void write_nack_all(rlc_am& tx, uint32_t nof_pdus)
+{
+  rlc_status_pdu_t status;
+  status.ack_sn = nof_pdus;
+  status.N_nack = nof_pdus;
+  for (uint32_t sn = 0; sn < nof_pdus; sn++) {
+    status.nacks[sn].nack_sn = sn;
+  }
+
+  byte_buffer_t status_buf;
+  rlc_am_write_status_pdu(&status, &status_buf);
+  tx.write_pdu(status_buf.msg, status_buf.N_bytes);
+}
+
+static int run_window(const bench_args_t& args, timer_handler& timers, std::mt19937& rnd, bench_result_t& result)
+{
+  rlc_am_tester tester(true, nullptr);
+  rlc_am        rlc1(srsran_rat_t::lte, srslog::fetch_basic_logger("RLC_AM_1", false), 1, &tester, &tester, &timers);
+  rlc_am        rlc2(srsran_rat_t::lte, srslog::fetch_basic_logger("RLC_AM_2", false), 1, &tester, &tester, &timers);
+  TESTASSERT(rlc1.configure(rlc_config_t::default_rlc_am_config()));
+  TESTASSERT(rlc2.configure(rlc_config_t::default_rlc_am_config()));
+
+  // Each SDU is filled with its index
+  for (uint32_t i = 0; i < args.nof_sdus; i++) {
+    unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    TESTASSERT(sdu != nullptr);
+    memset(sdu->msg, i & 0xffU, args.sdu_size);
+    sdu->N_bytes    = args.sdu_size;
+    sdu->md.pdcp_sn = i;
+    rlc1.write_sdu(std::move(sdu));
+  }
+
+  // First transmissions, all of them get lost
+  segment_list_t pdus;
+  read_pdus(rlc1, args.pdu_size, args.pdu_size, rnd, pdus);
+  uint32_t nof_pdus = pdus.size();
+  TESTASSERT(nof_pdus < RLC_AM_WINDOW_SIZE);
+  pdus.clear();
+
+  // Segmented retransmissions. Each round cuts the PDUs at different offsets
+  segment_list_t segments;
+  for (uint32_t retx = 0; retx < args.nof_retx; retx++) {
+    write_nack_all(rlc1, nof_pdus);
+    read_pdus(rlc1, args.segment_size / 2, args.segment_size * 3 / 2, rnd, segments);
+  }
+
+  // Shuffle and duplicate the segments
+  std::bernoulli_distribution dup_dist(args.dup_rate);
+  for (uint32_t i = 0, nof_retx_segments = segments.size(); i < nof_retx_segments; i++) {
+    if (dup_dist(rnd)) {
+      segments.push_back(segments[i]);
+    }
+  }
+  std::shuffle(segments.begin(), segments.end(), rnd);
+
+  auto t_start = std::chrono::steady_clock::now();
+  for (std::vector<uint8_t>& segment : segments) {
+    rlc2.write_pdu(segment.data(), segment.size());
+  }
+  result.rx_time_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+  result.nof_segments += segments.size();
+  result.nof_sdus += tester.sdus.size();
+
+  // All SDUs delivered in order
+  TESTASSERT(tester.sdus.size() == args.nof_sdus);
+  for (uint32_t i = 0; i < args.nof_sdus; i++) {
+    TESTASSERT(tester.sdus[i]->N_bytes == args.sdu_size);
+    for (uint32_t j = 0; j < args.sdu_size; j++) {
+      TESTASSERT(tester.sdus[i]->msg[j] == (i & 0xffU));
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static int parse_args(int argc, char** argv, bench_args_t& args)
+{
+  bpo::options_description options("RLC AM segment reassembly benchmark options");
+
+  // clang-format off
+  options.add_options()
+      ("windows",      bpo::value<uint32_t>(&args.nof_windows)->default_value(args.nof_windows),   "Number of windows of PDUs to transmit")
+      ("sdus",         bpo::value<uint32_t>(&args.nof_sdus)->default_value(args.nof_sdus),         "Number of SDUs per window, up to the TX queue length")
+      ("sdu_size",     bpo::value<uint32_t>(&args.sdu_size)->default_value(args.sdu_size),         "Size of the SDUs")
+      ("pdu_size",     bpo::value<uint32_t>(&args.pdu_size)->default_value(args.pdu_size),         "Grant size of the first transmissions")
+      ("segment_size", bpo::value<uint32_t>(&args.segment_size)->default_value(args.segment_size), "Average grant size of the retransmissions")
+      ("retx",         bpo::value<uint32_t>(&args.nof_retx)->default_value(args.nof_retx),         "Number of retransmissions of every PDU")
+      ("dup_rate",     bpo::value<float>(&args.dup_rate)->default_value(args.dup_rate),            "Rate at which segments are duplicated")
+      ("seed",         bpo::value<uint32_t>(&args.seed)->default_value(args.seed),                 "Random seed")
+      ("help", "Show this message");
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << e.what() << std::endl;
+    return SRSRAN_ERROR;
+  }
+
+  if (vm.count("help") or args.nof_retx == 0 or args.segment_size < 16 or args.nof_sdus == 0 or
+      args.nof_sdus > RLC_TX_QUEUE_LEN or args.sdu_size == 0 or
+      args.sdu_size > SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << std::endl << options << std::endl;
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  bench_args_t args;
+  if (parse_args(argc, argv, args) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  srslog::fetch_basic_logger("RLC_AM_1", false).set_level(srslog::basic_levels::error);
+  srslog::fetch_basic_logger("RLC_AM_2", false).set_level(srslog::basic_levels::error);
+  srslog::init();
+
+  timer_handler  timers(8);
+  std::mt19937   rnd(args.seed);
+  bench_result_t result;
+  for (uint32_t w = 0; w < args.nof_windows; w++) {
+    if (run_window(args, timers, rnd, result) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+
+  printf("windows=%d, sdus=%ld, segments=%ld (%.1f per PDU of %d B): %.1f ns/segment, %.2f Mbps\n",
+         args.nof_windows,
+         (long)result.nof_sdus,
+         (long)result.nof_segments,
+         (double)result.nof_segments * args.pdu_size / ((double)args.nof_sdus * args.sdu_size * args.nof_windows),
+         args.pdu_size,
+         result.rx_time_s * 1e9 / std::max(result.nof_segments, (uint64_t)1),
+         result.nof_sdus * args.sdu_size * 8 / std::max(result.rx_time_s, 1e-9) / 1e6);
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,103 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/srslog/srslog.h"
+#include <chrono>
+#include <thread>
+
+using namespace srslog;
+
+static constexpr unsigned num_entries_per_thread = 200000;
+
+/// Worker function used for each thread of the benchmark to generate log entries as fast as possible.
+static void run_thread(log_channel& c)
+{
+  for (unsigned entry_num = 0; entry_num != num_entries_per_thread; ++entry_num) {
+    double d = entry_num;
+    c("SRSLOG throughput benchmark: int: %u, double: %f, string: %s", entry_num, d, "test");
+  }
+}
+
+static const char* to_string(backend_overflow_policy policy)
+{
+  switch (policy) {
+    case backend_overflow_policy::discard:
+      return "discard";
+    case backend_overflow_policy::discard_and_count:
+      return "discard_and_count";
+    case backend_overflow_policy::block:
+      return "block";
+  }
+  return "unknown";
+}
+
+/// This function runs the throughput benchmark generating log entries using the specified number of threads, measuring
+/// the time taken until all the entries have been written into the sink.
+static void benchmark(log_channel& channel, unsigned num_threads, backend_overflow_policy policy)
+{
+  srslog::set_overflow_policy(policy);
+  uint64_t discarded_before = srslog::get_nof_discarded_entries();
+
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads);
+
+  auto begin = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i != num_threads; ++i) {
+    workers.emplace_back(run_thread, std::ref(channel));
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  auto produced = std::chrono::steady_clock::now();
+  srslog::flush();
+  auto end = std::chrono::steady_clock::now();
+
+  uint64_t total     = uint64_t(num_threads) * num_entries_per_thread;
+  uint64_t discarded = srslog::get_nof_discarded_entries() - discarded_before;
+  double   produce_s = std::chrono::duration<double>(produced - begin).count();
+  double   total_s   = std::chrono::duration<double>(end - begin).count();
+
+  fmt::print("{:2} thread{} | {:17} | produced: {:6.3f} Mentries/s | written: {:6.3f} Mentries/s | discarded: {}\n",
+             num_threads,
+             (num_threads > 1) ? "s" : " ",
+             to_string(policy),
+             total / produce_s / 1e6,
+             (total - discarded) / total_s / 1e6,
+             discarded);
+}
+
+int main()
+{
+  auto& s       = srslog::fetch_file_sink("srslog_throughput_benchmark.txt");
+  auto& channel = srslog::fetch_log_channel("bench", s, {});
+
+  srslog::init();
+
+  fmt::print("SRSLOG Backend Throughput Benchmark - {} entries per thread\n", num_entries_per_thread);
+  for (auto policy :
+       {backend_overflow_policy::discard, backend_overflow_policy::discard_and_count, backend_overflow_policy::block}) {
+    for (auto n : {1, 2, 4, 8}) {
+      benchmark(channel, n, policy);
+    }
+  }
+
+  return 0;
+}
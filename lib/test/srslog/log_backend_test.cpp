@@ -233,6 +233,48 @@ static bool when_empty_handler_is_used_then_backend_does_not_crash()
   return true;
 }
 
+static bool when_queue_is_full_then_new_entries_are_discarded_and_counted()
+{
+  sink_spy         spy;
+  log_backend_impl backend;
+  backend.set_overflow_policy(backend_overflow_policy::discard_and_count);
+
+  // Nothing consumes the entries while the backend is not started.
+  unsigned nof_entries = 2 * SRSLOG_QUEUE_CAPACITY;
+  unsigned nof_pushed  = 0;
+  for (unsigned i = 0; i != nof_entries; ++i) {
+    nof_pushed += backend.push(build_log_entry(&spy, nullptr));
+  }
+
+  ASSERT_EQ(nof_pushed < nof_entries, true);
+  ASSERT_EQ(backend.get_nof_discarded_entries(), nof_entries - nof_pushed);
+
+  return true;
+}
+
+static bool when_overflow_policy_is_block_then_no_entries_are_discarded()
+{
+  sink_spy         spy;
+  log_backend_impl backend;
+  // We want to remove output to stderr by the default handler.
+  backend.set_error_handler([](const std::string&) {});
+  backend.set_overflow_policy(backend_overflow_policy::block);
+  backend.start();
+
+  unsigned nof_entries = 4 * SRSLOG_QUEUE_CAPACITY;
+  for (unsigned i = 0; i != nof_entries; ++i) {
+    backend.push(build_log_entry(&spy, backend.alloc_arg_store()));
+  }
+
+  // Stop the backend to ensure the entries have been processed.
+  backend.stop();
+
+  ASSERT_EQ(spy.write_invocation_count(), nof_entries);
+  ASSERT_EQ(backend.get_nof_discarded_entries(), 0);
+
+  return true;
+}
+
 int main()
 {
   TEST_FUNCTION(when_backend_is_started_then_is_started_returns_true);
@@ -243,6 +285,8 @@ int main()
   TEST_FUNCTION(when_sink_write_fails_then_error_handler_is_invoked);
   TEST_FUNCTION(when_handler_is_set_after_start_then_handler_is_not_used);
   TEST_FUNCTION(when_empty_handler_is_used_then_backend_does_not_crash);
+  TEST_FUNCTION(when_queue_is_full_then_new_entries_are_discarded_and_counted);
+  TEST_FUNCTION(when_overflow_policy_is_block_then_no_entries_are_discarded);
 
   return 0;
 }
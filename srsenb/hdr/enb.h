@@ -46,6 +46,7 @@
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/interfaces_common.h"
 #include "srsran/common/mac_pcap.h"
+#include "srsran/common/network_utils.h"
 #include "srsran/common/security.h"
 #include "srsran/interfaces/enb_command_interface.h"
 #include "srsran/interfaces/enb_metrics_interface.h"
@@ -104,12 +105,16 @@ struct general_args_t {
   bool        tracing_enable;
   std::size_t tracing_buffcapacity;
   std::string tracing_filename;
+  bool        tti_trace_enable;
+  std::string tti_trace_filename;
+  uint32_t    tti_trace_nof_events;
   std::string eia_pref_list;
   std::string eea_pref_list;
   uint32_t    max_mac_dl_kos;
   uint32_t    max_mac_ul_kos;
   uint32_t    gtpu_indirect_tunnel_timeout;
   uint32_t    rlf_release_timer_ms;
+  uint32_t    nof_rx_socket_threads;
 };
 
 struct all_args_t {
@@ -173,7 +178,8 @@ private:
   rrc_nr_cfg_t rrc_nr_cfg = {};
 
   // eNB components
-  std::unique_ptr<x2_interface>       x2;
+  std::unique_ptr<srsran::socket_manager> rx_sockets;
+  std::unique_ptr<x2_interface>           x2;
   std::unique_ptr<enb_stack_base>     eutra_stack = nullptr;
   std::unique_ptr<enb_stack_base>     nr_stack    = nullptr;
   std::unique_ptr<srsran::radio_base> radio       = nullptr;
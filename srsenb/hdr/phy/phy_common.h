@@ -34,6 +34,7 @@
 #include "srsran/interfaces/radio_interfaces.h"
 #include "srsran/phy/channel/channel.h"
 #include "srsran/radio/radio.h"
+#include "srsran/srsran.h"
 
 #include <map>
 #include <srsran/common/tti_sempahore.h>
@@ -45,6 +46,7 @@ class phy_common : public srsran::phy_common_interface
 {
 public:
   phy_common() = default;
+  ~phy_common();
 
   bool init(const phy_cell_cfg_list_t&    cell_list_,
             const phy_cell_cfg_list_nr_t& cell_list_nr_,
@@ -71,6 +73,11 @@ public:
   // Common objects
   phy_args_t params = {};
 
+  /**
+   * Returns the FEC pool shared by all LTE workers for decoding PUSCH codeblocks, nullptr if it is not enabled
+   */
+  srsran_fec_pool_t* get_fec_pool() { return fec_pool_enabled ? &fec_pool : nullptr; }
+
   uint32_t get_nof_carriers_lte() { return static_cast<uint32_t>(cell_list_lte.size()); }
   uint32_t get_nof_carriers_nr() { return static_cast<uint32_t>(cell_list_nr.size()); }
   uint32_t get_nof_carriers() { return static_cast<uint32_t>(cell_list_lte.size() + cell_list_nr.size()); }
@@ -308,6 +315,9 @@ private:
   phy_cell_cfg_list_nr_t cell_list_nr;
   std::mutex             cell_gain_mutex;
 
+  srsran_fec_pool_t fec_pool         = {};
+  bool              fec_pool_enabled = false;
+
   bool                    have_mtch_stop   = false;
   std::mutex              mtch_mutex;
   std::condition_variable mtch_cvar;
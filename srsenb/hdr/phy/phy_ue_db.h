@@ -23,9 +23,12 @@
 #define SRSENB_PHY_UE_DB_H_
 
 #include "phy_interfaces.h"
+#include "srsenb/hdr/common/common_enb.h"
 #include "srsran/interfaces/enb_mac_interfaces.h"
 #include "srsran/interfaces/enb_phy_interfaces.h"
-#include <map>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <srsran/adt/circular_array.h>
 
@@ -81,37 +84,84 @@ private:
   } cell_state_t;
 
   /**
-   * Cell information for the UE database
+   * Cell configuration of a UE, part of the UE configuration snapshot
+   */
+  struct cell_cfg_t {
+    cell_state_t      state                   = cell_state_none; ///< Configuration state
+    uint32_t          enb_cc_idx              = 0;               ///< Corresponding eNb cell/carrier index
+    bool              stash_use_tbs_index_alt = false;
+    srsran::phy_cfg_t phy_cfg; ///< Configuration, it has a default constructor
+  };
+
+  /**
+   * UE configuration snapshot. A snapshot is never modified once it has been published, the configuration procedures
+   * copy the current snapshot, modify the copy and replace the published one. The workers keep a reference to the
+   * snapshot they are using, so they never wait for the stack while it computes a new configuration.
+   */
+  struct ue_cfg_t {
+    bool                                        stashed_multiple_csi_request_enabled = false;
+    std::array<cell_cfg_t, SRSRAN_MAX_CARRIERS> cell_cfg = {}; ///< Cell configuration, indexed by ue_cc_idx
+  };
+
+  /**
+   * Cell information for the UE database, updated by the workers
    */
   struct cell_info_t {
-    cell_state_t state      = cell_state_none; ///< Configuration state
-    uint32_t     enb_cc_idx = 0;               ///< Corresponding eNb cell/carrier index
-    uint8_t      last_ri    = 0;               ///< Last reported rank indicator
+    uint8_t last_ri = 0; ///< Last reported rank indicator
     srsran::circular_array<srsran_ra_tb_t, SRSRAN_MAX_HARQ_PROC> last_tb =
         {}; ///< Stores last PUSCH Resource allocation
-    bool                                    stash_use_tbs_index_alt = false;
-    srsran::phy_cfg_t                       phy_cfg;            ///< Configuration, it has a default constructor
-    srsran::circular_array<bool, TTIMOD_SZ> is_grant_available; ///< Indicates whether there is an available grant
+    srsran::circular_array<bool, TTIMOD_SZ> is_grant_available = {}; ///< Indicates whether there is an available grant
   };
 
   /**
    * UE object stored in the PHY common database
    */
   struct common_ue {
-    bool                                                  stashed_multiple_csi_request_enabled = false;
+    /// Protects all the members below. The UE entries are recycled, so the RNTI shall be checked after locking
+    std::mutex                                            mutex;
+    uint16_t                                              rnti      = SRSRAN_INVALID_RNTI;
+    std::shared_ptr<const ue_cfg_t>                       cfg       = nullptr; ///< Current configuration snapshot
     srsran::circular_array<srsran_pdsch_ack_t, TTIMOD_SZ> pdsch_ack = {}; ///< Pending acknowledgements for this Cell
-    std::array<cell_info_t, SRSRAN_MAX_CARRIERS>          cell_info = {}; ///< Cell information, indexed by ue_cell_idx
+    std::array<cell_info_t, SRSRAN_MAX_CARRIERS>          cell_info = {}; ///< Cell information, indexed by ue_cc_idx
+  };
+
+  /**
+   * Scoped lock of the UE entry of an RNTI. It evaluates to false if the RNTI does not exist
+   */
+  class ue_lock_t
+  {
+  public:
+    ue_lock_t(const phy_ue_db& db, uint16_t rnti);
+    explicit   operator bool() const { return ue != nullptr; }
+    common_ue* operator->() const { return ue; }
+    common_ue& operator*() const { return *ue; }
+
+  private:
+    std::unique_lock<std::mutex> lock;
+    common_ue*                   ue = nullptr;
   };
 
   /**
-   * UE database indexed by RNTI
+   * Maximum number of UEs in the database
+   */
+  static constexpr uint32_t max_nof_ues = SRSENB_MAX_UES;
+
+  /**
+   * UE entries. They are allocated at construction and recycled, so a worker never accesses released memory
+   */
+  std::unique_ptr<common_ue[]> ues;
+
+  /**
+   * UE database indexed by RNTI. Each element holds the index of the RNTI entry in ues, or max_nof_ues if the RNTI
+   * does not exist
    */
-  std::map<uint16_t, common_ue> ue_db;
+  std::unique_ptr<std::atomic<uint16_t>[]> rnti_to_ue;
 
   /**
-   * Concurrency protection mutex, allowed modifications from const methods.
+   * Serialises the stack configuration procedures (addition, removal and configuration of RNTIs). It is never taken by
+   * the workers
    */
-  mutable std::mutex mutex;
+  std::mutex cfg_mutex;
 
   /**
    * Stack interface
@@ -129,20 +179,49 @@ private:
   const phy_cell_cfg_list_t* cell_cfg_list = nullptr;
 
   /**
-   * Internal RNTI addition, it is not thread safe protected
+   * Configuration of the non-user RNTIs
+   */
+  srsran::phy_cfg_t default_cfg = {};
+
+  /**
+   * Looks up the UE entry of an RNTI, without locking it
+   *
+   * @param rnti identifier of the UE
+   * @return the UE entry if the RNTI exists, nullptr otherwise
+   */
+  inline common_ue* _find_ue(uint16_t rnti) const;
+
+  /**
+   * Gets the current configuration snapshot of an RNTI
+   *
+   * @param rnti identifier of the UE
+   * @return the configuration snapshot if the RNTI exists, nullptr otherwise
+   */
+  inline std::shared_ptr<const ue_cfg_t> _get_ue_cfg(uint16_t rnti) const;
+
+  /**
+   * Replaces the configuration snapshot of a UE entry
+   *
+   * @param ue the UE entry
+   * @param cfg the new configuration snapshot
+   */
+  static inline void _publish_ue_cfg(common_ue& ue, std::shared_ptr<const ue_cfg_t> cfg);
+
+  /**
+   * Internal RNTI addition, the caller shall hold cfg_mutex
    *
    * @param rnti identifier of the UE
-   * @return SRSRAN_SUCCESS if the RNTI is not duplicated and is added successfully, SRSRAN_ERROR code if it exists
+   * @return the new UE entry, or nullptr if the RNTI already exists or the database is full
    */
-  inline int _add_rnti(uint16_t rnti);
+  inline common_ue* _add_rnti(uint16_t rnti);
 
   /**
-   * Internal pending ACK clear for a given RNTI and TTI, it is not thread safe protected
+   * Internal pending ACK clear for a given UE and TTI, the caller shall hold the UE entry lock
    *
    * @param tti is the given TTI (requires assertion prior to call)
-   * @param rnti identifier of the UE (requires assertion prior to call)
+   * @param ue locked UE entry
    */
-  inline void _clear_tti_pending_rnti(uint32_t tti, uint16_t rnti);
+  static inline void _clear_tti_pending_rnti(uint32_t tti, common_ue& ue);
 
   /**
    * Helper method to set the constant attributes of a given RNTI after the configuration is set, it does not modify
@@ -154,14 +233,14 @@ private:
   inline void _set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t& phy_cfg) const;
 
   /**
-   * Gets the SCell index for a given RNTI and a eNb cell/carrier. It returns the SCell index (0 if PCell) if the cc_idx
-   * is found among the configured cells/carriers. Otherwise, it returns SRSRAN_MAX_CARRIERS.
+   * Gets the SCell index for a given UE configuration and a eNb cell/carrier. It returns the SCell index (0 if PCell) if
+   * the cc_idx is found among the configured cells/carriers. Otherwise, it returns SRSRAN_MAX_CARRIERS.
    *
-   * @param rnti identifier of the UE (requires assertion prior to call)
+   * @param cfg configuration of the UE
    * @param enb_cc_idx the eNb cell/carrier index to look for in the RNTI.
    * @return the SCell index as described above.
    */
-  inline uint32_t _get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const;
+  static inline uint32_t _get_ue_cc_idx(const ue_cfg_t& cfg, uint32_t enb_cc_idx);
 
   /**
    * Gets the eNb Cell/Carrier index in which the UCI shall be carried. This corresponds to the serving cell with lowest
@@ -170,49 +249,42 @@ private:
    * If no grant is available in the indicated TTI, it returns the number of the eNb Cells/Carriers.
    *
    * @param tti The UL processing TTI
-   * @param rnti Temporal UE ID
+   * @param ue locked UE entry
    * @return the eNb Cell/Carrier with lowest serving cell index that has an UL grant
    */
-  uint32_t _get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const;
-
-  /**
-   * Checks if a given RNTI exists in the database
-   * @param rnti provides UE identifier
-   * @return SRSRAN_SUCCESS if the indicated RNTI exists, otherwise it returns SRSRAN_ERROR
-   */
-  inline int _assert_rnti(uint16_t rnti) const;
+  uint32_t _get_uci_enb_cc_idx(uint32_t tti, const common_ue& ue) const;
 
   /**
-   * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell
-   * @param rnti provides UE identifier
+   * Checks if a UE is configured to use an specified eNb cell/carrier as PCell or SCell
+   * @param cfg configuration of the UE
    * @param enb_cc_idx provides eNb cell/carrier
-   * @return SRSRAN_SUCCESS if the indicated RNTI exists, otherwise it returns SRSRAN_ERROR
+   * @return SRSRAN_SUCCESS if the indicated eNb cell/carrier is configured, otherwise it returns SRSRAN_ERROR
    */
-  inline int _assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
+  static inline int _assert_enb_cc(const ue_cfg_t& cfg, uint32_t enb_cc_idx);
 
   /**
-   * Checks if an RNTI uses a given eNb cell/carrier as PCell
-   * @param rnti provides UE identifier
+   * Checks if a UE uses a given eNb cell/carrier as PCell
+   * @param cfg configuration of the UE
    * @param enb_cc_idx provides eNb cell/carrier index
    * @return SRSRAN_SUCCESS if the indicated eNb cell/carrier of the RNTI is a PCell, otherwise it returns SRSRAN_ERROR
    */
-  inline int _assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const;
+  static inline int _assert_enb_pcell(const ue_cfg_t& cfg, uint32_t enb_cc_idx);
 
   /**
-   * Checks if an RNTI is configured to use an specified UE cell/carrier as PCell or SCell
-   * @param rnti provides UE identifier
+   * Checks if a UE is configured to use an specified UE cell/carrier as PCell or SCell
+   * @param cfg configuration of the UE
    * @param ue_cc_idx UE cell/carrier index that is asserted
    * @return SRSRAN_SUCCESS if the indicated cell/carrier index is valid, otherwise it returns SRSRAN_ERROR
    */
-  inline int _assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const;
+  static inline int _assert_ue_cc(const ue_cfg_t& cfg, uint32_t ue_cc_idx);
 
   /**
-   * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell and it is active
-   * @param rnti provides UE identifier
+   * Checks if a UE is configured to use an specified eNb cell/carrier as PCell or SCell and it is active
+   * @param cfg configuration of the UE
    * @param enb_cc_idx UE cell/carrier index that is asserted
    * @return SRSRAN_SUCCESS if the indicated eNb cell/carrier is active, otherwise it returns SRSRAN_ERROR
    */
-  inline int _assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
+  static inline int _assert_active_enb_cc(const ue_cfg_t& cfg, uint32_t enb_cc_idx);
 
   /**
    * Internal eNb stack assertion
@@ -227,24 +299,28 @@ private:
   inline int _assert_cell_list_cfg() const;
 
   /**
-   * Internal eNb general configuration getter, returns default configuration if the UE does not exist in the given cell
+   * Internal eNb general configuration getter for user RNTIs
    *
    * @param rnti provides UE identifier
    * @param enb_cc_idx eNb cell index
-   * @param[out] phy_cfg The PHY configuration of the indicated UE for the indicated eNb carrier/call index.
-   * @return SRSRAN_SUCCESS if provided context is correct, SRSRAN_ERROR code otherwise
+   * @param[out] cfg holds the configuration snapshot, the returned cell configuration is valid while it is held
+   * @param[out] ue_cc_idx UE cell/carrier index of the eNb cell/carrier
+   * @return the cell configuration if the provided context is correct, nullptr otherwise
    */
-  inline int _get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, srsran::phy_cfg_t& phy_cfg) const;
+  inline const cell_cfg_t*
+  _get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, std::shared_ptr<const ue_cfg_t>& cfg, uint32_t& ue_cc_idx) const;
 
   /**
    * Count number of configured secondary serving cells
    *
-   * @param rnti provides UE identifier
+   * @param cfg configuration of the UE
    * @return The number of configured secondary cells
    */
-  inline uint32_t _count_nof_configured_scell(uint16_t rnti);
+  static inline uint32_t _count_nof_configured_scell(const ue_cfg_t& cfg);
 
 public:
+  phy_ue_db();
+
   /**
    * Initialises the UE database with the stack and cell list
    * @param stack_ptr points to the stack (read/write)
@@ -51,7 +51,7 @@ class enb_stack_lte final : public enb_stack_base,
                             public srsran::thread
 {
 public:
-  enb_stack_lte(srslog::sink& log_sink);
+  enb_stack_lte(srslog::sink& log_sink, srsran::socket_manager& rx_sockets_);
   ~enb_stack_lte() final;
 
   // eNB stack base interface
@@ -175,6 +175,9 @@ private:
   srsran::task_scheduler    task_sched;
   srsran::task_queue_handle enb_task_queue, sync_task_queue, metrics_task_queue, x2_task_queue;
 
+  // S1AP and GTP-U sockets, shared with the NR stack
+  srsran::socket_manager& rx_sockets;
+
   // bearer management
   enb_bearer_manager                 bearers; // helper to manage mapping between EPS and radio bearers
   std::unique_ptr<gtpu_pdcp_adapter> gtpu_adapter;
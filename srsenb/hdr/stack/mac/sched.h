@@ -26,7 +26,10 @@
 #include "sched_interface.h"
 #include "sched_ue.h"
 #include "srsenb/hdr/common/common_enb.h"
+#include "srsran/common/thread_pool.h"
 #include <atomic>
+#include <bitset>
+#include <condition_variable>
 #include <map>
 #include <mutex>
 
@@ -93,8 +96,13 @@ public:
   class carrier_sched;
 
 protected:
+  using cc_mask_t = std::bitset<SRSRAN_MAX_CARRIERS>;
+
   void new_tti(srsran::tti_point tti_rx);
   bool is_generated(srsran::tti_point, uint32_t enb_cc_idx) const;
+  // Parallel allocation of the carrier grants
+  std::vector<cc_mask_t> get_cc_groups(const cc_mask_t& cc_mask) const;
+  void                   alloc_cc_group_grants(srsran::tti_point tti_rx, const cc_mask_t& cc_group);
   // Helper methods
   template <typename Func>
   int ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name = nullptr, bool log_fail = true);
@@ -115,6 +123,13 @@ protected:
   srsran::tti_point last_tti;
   std::mutex        sched_mutex;
   bool              configured;
+
+  // Workers that allocate the grants of groups of carriers in parallel
+  static const int                          CC_WORKERS_THREAD_PRIO = 2;
+  std::mutex                                cc_workers_mutex;
+  std::condition_variable                   cc_workers_cvar;
+  uint32_t                                  nof_pending_cc_groups = 0;
+  std::unique_ptr<srsran::task_thread_pool> cc_workers;
 };
 
 } // namespace srsenb
@@ -43,6 +43,14 @@ public:
   void                   reset();
   void                   carrier_cfg(const sched_cell_params_t& sched_params_);
   void                   set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs);
+  //! Setup the TTI and schedule the allocations that depend on state shared with other carriers. Called for all
+  //! carriers, from the same thread, before alloc_tti_grants()
+  void new_tti(srsran::tti_point tti_rx);
+  //! Allocate the RBGs, PRBs and CCEs of the remaining grants. Only writes to this carrier and to the state that the
+  //! UEs keep for it, so the carriers can be allocated concurrently
+  void alloc_tti_grants(srsran::tti_point tti_rx);
+  //! Generate the DCIs and MAC PDUs of the allocated grants, which updates the UE HARQs, buffers and UCI. Called for
+  //! each carrier in order, from the same thread, after alloc_tti_grants()
   const cc_sched_result& generate_tti_result(srsran::tti_point tti_rx);
   int                    dl_rach_info(dl_sched_rar_info_t rar_info);
   int                    pdcch_order_info(dl_sched_po_info_t pdcch_order_info);
@@ -61,6 +69,8 @@ private:
   sf_sched* get_sf_sched(srsran::tti_point tti_rx);
   //! Schedule PDCCH orders
   void pdcch_order_sched(sf_sched* tti_sched);
+  //! Whether DL is allowed in the TTI (e.g. not in MBSFN subframes)
+  bool is_dl_active(const sf_sched* tti_sched) const;
 
   // args
   const sched_cell_params_t* cc_cfg = nullptr;
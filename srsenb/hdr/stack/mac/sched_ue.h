@@ -46,7 +46,7 @@ class sched_ue
 
 public:
   sched_ue(uint16_t rnti, const std::vector<sched_cell_params_t>& cell_list_params_, const ue_cfg_t& cfg);
-  void new_subframe(tti_point tti_rx, uint32_t enb_cc_idx);
+  void new_subframe(tti_point tti_rx);
 
   /*************************************************************
    *
@@ -60,11 +60,14 @@ int enb::init(const all_args_t& args_)
 
   srsran::byte_buffer_pool::get_instance()->enable_logger(true);
 
+  // Sockets of the core network interfaces, shared by the EUTRA and NR stacks
+  rx_sockets.reset(new srsran::socket_manager(args.general.nof_rx_socket_threads));
+
   // Create layers
   std::unique_ptr<enb_stack_lte> tmp_eutra_stack;
   if (not rrc_cfg.cell_list.empty()) {
     // add EUTRA stack
-    tmp_eutra_stack.reset(new enb_stack_lte(log_sink));
+    tmp_eutra_stack.reset(new enb_stack_lte(log_sink, *rx_sockets));
     if (tmp_eutra_stack == nullptr) {
       srsran::console("Error creating EUTRA stack.\n");
       return SRSRAN_ERROR;
@@ -74,7 +77,7 @@ int enb::init(const all_args_t& args_)
   std::unique_ptr<gnb_stack_nr> tmp_nr_stack;
   if (not rrc_nr_cfg.cell_list.empty()) {
     // add NR stack
-    tmp_nr_stack.reset(new gnb_stack_nr(log_sink));
+    tmp_nr_stack.reset(new gnb_stack_nr(log_sink, *rx_sockets));
     if (tmp_nr_stack == nullptr) {
       srsran::console("Error creating NR stack.\n");
       return SRSRAN_ERROR;
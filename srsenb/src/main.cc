@@ -30,6 +30,7 @@
 #include "srsran/common/config_file.h"
 #include "srsran/common/crash_handler.h"
 #include "srsran/common/tsan_options.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/srslog/event_trace.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/support/emergency_handlers.h"
@@ -180,11 +181,13 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.init_dl_cqi", bpo::value<int>(&args->stack.mac.sched.init_dl_cqi)->default_value(5), "DL CQI value used before any CQI report is available to the eNB")
     ("scheduler.max_sib_coderate", bpo::value<float>(&args->stack.mac.sched.max_sib_coderate)->default_value(0.8), "Upper bound on SIB and RAR grants coderate")
     ("scheduler.pdcch_cqi_offset", bpo::value<int>(&args->stack.mac.sched.pdcch_cqi_offset)->default_value(0), "CQI offset in derivation of PDCCH aggregation level")
+    ("scheduler.nof_cc_workers", bpo::value<uint32_t>(&args->stack.mac.sched.nof_cc_workers)->default_value(0), "Number of threads that allocate the carrier grants in parallel (0 to schedule the carriers in the PHY thread)")
 
 
 
     /* Downlink Channel emulator section */
     ("channel.dl.enable",            bpo::value<bool>(&args->phy.dl_channel_args.enable)->default_value(false),               "Enable/Disable internal Downlink channel emulator")
+    ("channel.dl.nof_threads",       bpo::value<uint32_t>(&args->phy.dl_channel_args.nof_threads)->default_value(1),          "Number of threads running the fading and delay of the antenna channels")
     ("channel.dl.awgn.enable",       bpo::value<bool>(&args->phy.dl_channel_args.awgn_enable)->default_value(false),          "Enable/Disable AWGN simulator")
     ("channel.dl.awgn.snr",          bpo::value<float>(&args->phy.dl_channel_args.awgn_snr_dB)->default_value(30.0f),         "Target SNR in dB")
     ("channel.dl.fading.enable",     bpo::value<bool>(&args->phy.dl_channel_args.fading_enable)->default_value(false),        "Enable/Disable Fading model")
@@ -204,6 +207,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     /* Uplink Channel emulator section */
     ("channel.ul.enable",            bpo::value<bool>(&args->phy.ul_channel_args.enable)->default_value(false),                  "Enable/Disable internal Downlink channel emulator")
+    ("channel.ul.nof_threads",       bpo::value<uint32_t>(&args->phy.ul_channel_args.nof_threads)->default_value(1),             "Number of threads running the fading and delay of the antenna channels")
     ("channel.ul.awgn.enable",       bpo::value<bool>(&args->phy.ul_channel_args.awgn_enable)->default_value(false),             "Enable/Disable AWGN simulator")
     ("channel.ul.awgn.signal_power", bpo::value<float>(&args->phy.ul_channel_args.awgn_signal_power_dBfs)->default_value(30.0f), "Received signal power in decibels full scale (dBfs)")
     ("channel.ul.awgn.snr",          bpo::value<float>(&args->phy.ul_channel_args.awgn_snr_dB)->default_value(30.0f),            "Noise level in decibels full scale (dBfs)")
@@ -239,6 +243,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure.")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor.")
     ("expert.nof_phy_threads", bpo::value<uint32_t>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads.")
+    ("expert.nof_fec_threads", bpo::value<uint32_t>(&args->phy.nof_fec_threads)->default_value(0), "Number of threads for decoding PUSCH codeblocks in parallel, 0 decodes them in the PHY worker.")
+    ("expert.nof_rx_socket_threads", bpo::value<uint32_t>(&args->general.nof_rx_socket_threads)->default_value(1), "Number of threads receiving from the S1AP/NGAP and GTP-U sockets. Each socket is served by a single thread.")
     ("expert.nof_prach_threads", bpo::value<uint32_t>(&args->phy.nof_prach_threads)->default_value(1), "Number of PRACH workers per carrier. Only 1 or 0 is supported.")
     ("expert.max_prach_offset_us", bpo::value<float>(&args->phy.max_prach_offset_us)->default_value(30), "Maximum allowed RACH offset (in us).")
     ("expert.equalizer_mode", bpo::value<string>(&args->phy.equalizer_mode)->default_value("mmse"), "Equalizer mode.")
@@ -252,6 +258,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.tracing_enable",  bpo::value<bool>(&args->general.tracing_enable)->default_value(false), "Events tracing.")
     ("expert.tracing_filename", bpo::value<string>(&args->general.tracing_filename)->default_value("/tmp/enb_tracing.log"), "Tracing events filename.")
     ("expert.tracing_buffcapacity", bpo::value<std::size_t>(&args->general.tracing_buffcapacity)->default_value(1000000), "Tracing buffer capcity.")
+    ("expert.tti_trace_enable", bpo::value<bool>(&args->general.tti_trace_enable)->default_value(false), "Record the latency of the TTI processing stages and write them as a Chrome/Perfetto trace at exit.")
+    ("expert.tti_trace_filename", bpo::value<string>(&args->general.tti_trace_filename)->default_value("/tmp/enb_tti_trace.json"), "TTI latency trace filename.")
+    ("expert.tti_trace_nof_events", bpo::value<uint32_t>(&args->general.tti_trace_nof_events)->default_value(65536), "Number of trace events kept per thread, the oldest ones are overwritten.")
     ("expert.stdout_ts_enable", bpo::value<bool>(&stdout_ts_enable)->default_value(false), "Prints once per second the timestamp into stdout.")
     ("expert.rrc_inactivity_timer", bpo::value<uint32_t>(&args->general.rrc_inactivity_timer)->default_value(30000), "Inactivity timer in ms.")
     ("expert.print_buffer_state", bpo::value<bool>(&args->general.print_buffer_state)->default_value(false), "Prints on the console the buffer state every 10 seconds.")
@@ -632,6 +641,12 @@ int main(int argc, char* argv[])
   }
 #endif
 
+  if (args.general.tti_trace_enable) {
+    if (!srsran::tti_trace_init(args.general.tti_trace_filename, args.general.tti_trace_nof_events)) {
+      return SRSRAN_ERROR;
+    }
+  }
+
   // Start the log backend.
   srslog::init();
 
@@ -714,6 +729,13 @@ int main(int argc, char* argv[])
   input.join();
   metricshub.stop();
   enb->stop();
+
+  if (args.general.tti_trace_enable) {
+    srsran::tti_trace_stop();
+    if (srsran::tti_trace_write()) {
+      cout << "TTI trace written to " << args.general.tti_trace_filename << endl;
+    }
+  }
   cout << "---  exiting  ---" << endl;
 
   return SRSRAN_SUCCESS;
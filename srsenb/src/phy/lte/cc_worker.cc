@@ -156,6 +156,7 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+  srsran_sch_set_fec_pool(&enb_ul.pusch.ul_sch, phy->get_fec_pool());
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
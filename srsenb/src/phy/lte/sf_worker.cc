@@ -20,6 +20,7 @@
  */
 
 #include "srsran/common/threads.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/srsran.h"
 
 #include "srsenb/hdr/phy/lte/sf_worker.h"
@@ -163,6 +164,8 @@ void sf_worker::work_imp()
     return;
   }
 
+  tti_trace_event("PHY", "sf_worker::work_imp", tti_tx_dl);
+
   srsran_mbsfn_cfg_t mbsfn_cfg;
   srsran_sf_t        sf_type = phy->is_mbsfn_sf(&mbsfn_cfg, tti_tx_dl) ? SRSRAN_SF_MBSFN : SRSRAN_SF_NORM;
 
@@ -189,8 +192,11 @@ void sf_worker::work_imp()
   }
 
   // Process UL
-  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
-    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
+  {
+    tti_trace_event("PHY", "sf_worker::work_ul", tti_rx);
+    for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
+      cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
+    }
   }
 
   // Get DL scheduling for the TX TTI from MAC
@@ -225,13 +231,16 @@ void sf_worker::work_imp()
   phy->ue_db.clear_tti_pending_ack(tti_tx_ul);
 
   // Process DL
-  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
-    // Select CFI and make sure it is in the right range
-    dl_sf.cfi = dl_grants[cc].cfi;
-    dl_sf.cfi = SRSRAN_MAX(dl_sf.cfi, 1);
-    dl_sf.cfi = SRSRAN_MIN(dl_sf.cfi, 3);
-
-    cc_workers[cc]->work_dl(dl_sf, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg);
+  {
+    tti_trace_event("PHY", "sf_worker::work_dl", tti_tx_dl);
+    for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
+      // Select CFI and make sure it is in the right range
+      dl_sf.cfi = dl_grants[cc].cfi;
+      dl_sf.cfi = SRSRAN_MAX(dl_sf.cfi, 1);
+      dl_sf.cfi = SRSRAN_MIN(dl_sf.cfi, 3);
+
+      cc_workers[cc]->work_dl(dl_sf, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg);
+    }
   }
 
   // Save grants
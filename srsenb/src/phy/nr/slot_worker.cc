@@ -22,6 +22,7 @@
 #include "srsenb/hdr/phy/nr/slot_worker.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/common.h"
+#include "srsran/common/tti_trace.h"
 
 //#define DEBUG_WRITE_FILE
 
@@ -103,6 +104,7 @@ bool slot_worker::init(const args_t& args)
     logger.error("Error gNb DL init");
     return false;
   }
+  srsran_sch_nr_set_fec_pool(&gnb_ul.pusch.sch, args.fec_pool);
 
 #ifdef DEBUG_WRITE_FILE
   const char* filename = "nr_baseband.dat";
@@ -403,6 +405,8 @@ bool slot_worker::work_dl()
 
 void slot_worker::work_imp()
 {
+  tti_trace_event("PHY", "slot_worker::work_imp", dl_slot_cfg.idx);
+
   // Inform Scheduler about new slot
   stack.slot_indication(dl_slot_cfg);
 
@@ -38,6 +38,11 @@ worker_pool::worker_pool(srsran::phy_common_interface& common_,
   // Do nothing
 }
 
+worker_pool::~worker_pool()
+{
+  srsran_fec_pool_free(&fec_pool);
+}
+
 bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_list)
 {
   nof_prach_workers = args.nof_prach_workers;
@@ -53,6 +58,16 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
   srslog::basic_levels log_level = srslog::str_to_basic_level(args.log.phy_level);
   logger.set_level(log_level);
 
+  // Create the FEC pool shared by all workers, its decoders use the same arguments as the workers PUSCH
+  if (args.nof_fec_threads > 0) {
+    srsran_sch_nr_args_t sch_args = {};
+    sch_args.max_nof_iter         = args.pusch_max_its;
+    if (srsran_sch_nr_fec_pool_init(&fec_pool, args.nof_fec_threads, &sch_args) < SRSRAN_SUCCESS) {
+      logger.error("Error creating FEC pool with %d threads", args.nof_fec_threads);
+      return false;
+    }
+  }
+
   // Add workers to workers pool and start threads
   for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
     auto& log = srslog::fetch_basic_logger(fmt::format("{}PHY{}-NR", args.log.id_preamble, i), log_sink);
@@ -73,6 +88,7 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
     w_args.srate_hz                = srate_hz;
     w_args.pusch_max_its           = args.pusch_max_its;
     w_args.pusch_min_snr_dB        = args.pusch_min_snr_dB;
+    w_args.fec_pool                = args.nof_fec_threads > 0 ? &fec_pool : nullptr;
 
     if (not w->init(w_args)) {
       return false;
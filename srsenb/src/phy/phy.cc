@@ -173,7 +173,10 @@ int phy::init_lte(const phy_args_t&            args,
 
   workers_common.params = args;
 
-  workers_common.init(cfg.phy_cell_cfg, cfg.phy_cell_cfg_nr, radio, stack_lte_);
+  if (not workers_common.init(cfg.phy_cell_cfg, cfg.phy_cell_cfg_nr, radio, stack_lte_)) {
+    phy_log.error("Couldn't initialize PHY common");
+    return SRSRAN_ERROR;
+  }
   if (cfg.cfr_config.cfr_enable) {
     workers_common.set_cfr_config(cfg.cfr_config);
   }
@@ -198,6 +201,12 @@ int phy::init_lte(const phy_args_t&            args,
   }
   prach.set_max_prach_offset_us(args.max_prach_offset_us);
 
+  if (phy_log.info.enabled()) {
+    char dft_info[256];
+    srsran_dft_metrics_info(dft_info, sizeof(dft_info));
+    phy_log.info("%s", dft_info);
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -376,6 +385,7 @@ int phy::init_nr(const phy_args_t& args, const phy_cfg_t& cfg, stack_interface_p
   worker_args.log.phy_level           = args.log.phy_level;
   worker_args.log.phy_hex_limit       = args.log.phy_hex_limit;
   worker_args.pusch_max_its           = args.nr_pusch_max_its;
+  worker_args.nof_fec_threads         = args.nof_fec_threads;
 
   if (not nr_workers->init(worker_args, cfg.phy_cell_cfg_nr)) {
     return SRSRAN_ERROR;
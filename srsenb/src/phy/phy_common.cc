@@ -69,6 +69,15 @@ bool phy_common::init(const phy_cell_cfg_list_t&    cell_list_,
   if (!cell_list_lte.empty()) {
     ue_db.init(stack, params, cell_list_lte);
   }
+
+  // Create the FEC pool shared by all LTE workers
+  if (!cell_list_lte.empty() && params.nof_fec_threads > 0) {
+    if (srsran_sch_fec_pool_init(&fec_pool, params.nof_fec_threads) < SRSRAN_SUCCESS) {
+      srslog::fetch_basic_logger("PHY").error("Error creating FEC pool with %d threads", params.nof_fec_threads);
+      return false;
+    }
+    fec_pool_enabled = true;
+  }
   if (mcch_configured) {
     build_mch_table();
     build_mcch_table();
@@ -78,6 +87,12 @@ bool phy_common::init(const phy_cell_cfg_list_t&    cell_list_,
   return true;
 }
 
+phy_common::~phy_common()
+{
+  // Workers are stopped before, no codeblock is pending at this point
+  srsran_fec_pool_free(&fec_pool);
+}
+
 void phy_common::stop()
 {
   semaphore.wait_all();
@@ -23,6 +23,30 @@
 
 using namespace srsenb;
 
+/// Number of RNTI values, used for sizing the RNTI indexed table
+static constexpr uint32_t nof_rnti_values = 1U << 16U;
+
+phy_ue_db::ue_lock_t::ue_lock_t(const phy_ue_db& db, uint16_t rnti)
+{
+  common_ue* entry = db._find_ue(rnti);
+  if (entry == nullptr) {
+    return;
+  }
+
+  // The entry may have been released, or even reused by another RNTI, since it was looked up
+  lock = std::unique_lock<std::mutex>(entry->mutex);
+  if (entry->rnti == rnti) {
+    ue = entry;
+  }
+}
+
+phy_ue_db::phy_ue_db() : ues(new common_ue[max_nof_ues]), rnti_to_ue(new std::atomic<uint16_t>[nof_rnti_values])
+{
+  for (uint32_t rnti = 0; rnti < nof_rnti_values; rnti++) {
+    rnti_to_ue[rnti].store(max_nof_ues, std::memory_order_relaxed);
+  }
+}
+
 void phy_ue_db::init(stack_interface_phy_lte*   stack_ptr,
                      const phy_args_t&          phy_args_,
                      const phy_cell_cfg_list_t& cell_cfg_list_)
@@ -32,44 +56,85 @@ void phy_ue_db::init(stack_interface_phy_lte*   stack_ptr,
   cell_cfg_list = &cell_cfg_list_;
 }
 
-inline int phy_ue_db::_add_rnti(uint16_t rnti)
+inline phy_ue_db::common_ue* phy_ue_db::_find_ue(uint16_t rnti) const
 {
-  // Private function not mutexed
+  uint16_t ue_idx = rnti_to_ue[rnti].load(std::memory_order_acquire);
+  if (ue_idx >= max_nof_ues) {
+    return nullptr;
+  }
 
-  // Assert RNTI does NOT exist
-  if (ue_db.count(rnti)) {
-    return SRSRAN_ERROR;
+  return &ues[ue_idx];
+}
+
+inline std::shared_ptr<const phy_ue_db::ue_cfg_t> phy_ue_db::_get_ue_cfg(uint16_t rnti) const
+{
+  ue_lock_t ue(*this, rnti);
+  if (not ue) {
+    return nullptr;
   }
 
-  // Create new UE by accesing it
-  ue_db[rnti].cell_info[0] = {};
+  return ue->cfg;
+}
+
+inline void phy_ue_db::_publish_ue_cfg(common_ue& ue, std::shared_ptr<const ue_cfg_t> cfg)
+{
+  std::lock_guard<std::mutex> lock(ue.mutex);
+  ue.cfg.swap(cfg);
+
+  // The previous snapshot is released after unlocking, unless a worker still uses it
+}
+
+inline phy_ue_db::common_ue* phy_ue_db::_add_rnti(uint16_t rnti)
+{
+  // Private function, the caller holds the configuration mutex
 
-  // Get UE
-  common_ue& ue = ue_db[rnti];
+  // Assert RNTI does NOT exist
+  if (_find_ue(rnti) != nullptr) {
+    return nullptr;
+  }
+
+  // Find a free UE entry. Only the configuration procedures change the RNTI of an entry
+  uint32_t ue_idx = 0;
+  while (ue_idx < max_nof_ues and ues[ue_idx].rnti != SRSRAN_INVALID_RNTI) {
+    ue_idx++;
+  }
+  if (ue_idx == max_nof_ues) {
+    return nullptr;
+  }
 
   // Load default values to PCell
-  ue.cell_info[0].phy_cfg.set_defaults();
+  std::shared_ptr<ue_cfg_t> cfg = std::make_shared<ue_cfg_t>();
+  cfg->cell_cfg[0].phy_cfg.set_defaults();
 
   // Set constant configuration fields
-  _set_common_config_rnti(rnti, ue.cell_info[0].phy_cfg);
+  _set_common_config_rnti(rnti, cfg->cell_cfg[0].phy_cfg);
 
   // Configure as PCell
-  ue.cell_info[0].state = cell_state_primary;
-
-  // Iterate all pending ACK
-  for (uint32_t tti = 0; tti < TTIMOD_SZ; tti++) {
-    _clear_tti_pending_rnti(tti, rnti);
+  cfg->cell_cfg[0].state = cell_state_primary;
+
+  common_ue& ue = ues[ue_idx];
+  {
+    std::lock_guard<std::mutex> lock(ue.mutex);
+    ue.rnti      = rnti;
+    ue.cfg       = std::move(cfg);
+    ue.cell_info = {};
+
+    // Iterate all pending ACK
+    for (uint32_t tti = 0; tti < TTIMOD_SZ; tti++) {
+      _clear_tti_pending_rnti(tti, ue);
+    }
   }
 
-  return SRSRAN_SUCCESS;
+  // Make the UE visible to the workers
+  rnti_to_ue[rnti].store(ue_idx, std::memory_order_release);
+
+  return &ue;
 }
 
-inline void phy_ue_db::_clear_tti_pending_rnti(uint32_t tti, uint16_t rnti)
+inline void phy_ue_db::_clear_tti_pending_rnti(uint32_t tti, common_ue& ue)
 {
-  // Private function not mutexed, no need to assert RNTI or TTI
-
-  // Get UE
-  common_ue& ue = ue_db[rnti];
+  // Private function, the caller holds the UE lock, no need to assert RNTI or TTI
+  const ue_cfg_t& cfg = *ue.cfg;
 
   srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
 
@@ -77,17 +142,17 @@ inline void phy_ue_db::_clear_tti_pending_rnti(uint32_t tti, uint16_t rnti)
   pdsch_ack = {};
 
   uint32_t nof_active_cc = 0;
-  for (auto& cell_info : ue.cell_info) {
-    if (cell_info.state == cell_state_primary or cell_info.state == cell_state_secondary_active) {
+  for (const cell_cfg_t& cell_cfg : cfg.cell_cfg) {
+    if (cell_cfg.state == cell_state_primary or cell_cfg.state == cell_state_secondary_active) {
       nof_active_cc++;
     }
   }
 
   // Copy essentials. It is assumed the PUCCH parameters are the same for all carriers
-  pdsch_ack.transmission_mode      = ue.cell_info[0].phy_cfg.dl_cfg.tm;
+  pdsch_ack.transmission_mode      = cfg.cell_cfg[0].phy_cfg.dl_cfg.tm;
   pdsch_ack.nof_cc                 = nof_active_cc;
-  pdsch_ack.ack_nack_feedback_mode = ue.cell_info[0].phy_cfg.ul_cfg.pucch.ack_nack_feedback_mode;
-  pdsch_ack.simul_cqi_ack          = ue.cell_info[0].phy_cfg.ul_cfg.pucch.simul_cqi_ack;
+  pdsch_ack.ack_nack_feedback_mode = cfg.cell_cfg[0].phy_cfg.ul_cfg.pucch.ack_nack_feedback_mode;
+  pdsch_ack.simul_cqi_ack          = cfg.cell_cfg[0].phy_cfg.ul_cfg.pucch.simul_cqi_ack;
 }
 
 inline void phy_ue_db::_set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t& phy_cfg) const
@@ -109,15 +174,14 @@ inline void phy_ue_db::_set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t&
   phy_cfg.ul_cfg.pucch.meas_ta_en                    = phy_args->pucch_meas_ta;
 }
 
-inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const
+inline uint32_t phy_ue_db::_get_ue_cc_idx(const ue_cfg_t& cfg, uint32_t enb_cc_idx)
 {
-  uint32_t         ue_cc_idx = 0;
-  const common_ue& ue        = ue_db.at(rnti);
+  uint32_t ue_cc_idx = 0;
 
   for (; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    const cell_info_t& scell_info = ue.cell_info[ue_cc_idx];
-    if (scell_info.enb_cc_idx == enb_cc_idx and
-        (scell_info.state == cell_state_primary or scell_info.state == cell_state_secondary_active)) {
+    const cell_cfg_t& scell_cfg = cfg.cell_cfg[ue_cc_idx];
+    if (scell_cfg.enb_cc_idx == enb_cc_idx and
+        (scell_cfg.state == cell_state_primary or scell_cfg.state == cell_state_secondary_active)) {
       return ue_cc_idx;
     }
   }
@@ -125,36 +189,22 @@ inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) co
   return ue_cc_idx;
 }
 
-uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const
+uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, const common_ue& ue) const
 {
   // Find the lowest index available PUSCH grant
-  for (const cell_info_t& cell_info : ue_db.at(rnti).cell_info) {
-    if (cell_info.is_grant_available[tti]) {
-      return cell_info.enb_cc_idx;
+  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
+    if (ue.cell_info[ue_cc_idx].is_grant_available[tti]) {
+      return ue.cfg->cell_cfg[ue_cc_idx].enb_cc_idx;
     }
   }
 
   return (uint32_t)cell_cfg_list->size();
 }
 
-inline int phy_ue_db::_assert_rnti(uint16_t rnti) const
+inline int phy_ue_db::_assert_enb_cc(const ue_cfg_t& cfg, uint32_t enb_cc_idx)
 {
-  if (not ue_db.count(rnti)) {
-    return SRSRAN_ERROR;
-  }
-
-  return SRSRAN_SUCCESS;
-}
-
-inline int phy_ue_db::_assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
-{
-  // Assert RNTI exist
-  if (_assert_rnti(rnti) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
-  }
-
   // Check Component Carrier is part of UE SCell map
-  if (_get_ue_cc_idx(rnti, enb_cc_idx) == SRSRAN_MAX_CARRIERS) {
+  if (_get_ue_cc_idx(cfg, enb_cc_idx) == SRSRAN_MAX_CARRIERS) {
     return SRSRAN_ERROR;
   }
 
@@ -163,52 +213,49 @@ inline int phy_ue_db::_assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
 
 bool phy_ue_db::ue_has_cell(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  return _assert_enb_cc(rnti, enb_cc_idx) == SRSRAN_SUCCESS;
+  std::shared_ptr<const ue_cfg_t> cfg = _get_ue_cfg(rnti);
+  return cfg != nullptr and _assert_enb_cc(*cfg, enb_cc_idx) == SRSRAN_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
+inline int phy_ue_db::_assert_enb_pcell(const ue_cfg_t& cfg, uint32_t enb_cc_idx)
 {
-  if (_assert_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  if (_assert_enb_cc(cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // Check cell is PCell
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
-  if (cell_info.state != cell_state_primary) {
+  const cell_cfg_t& cell_cfg = cfg.cell_cfg[_get_ue_cc_idx(cfg, enb_cc_idx)];
+  if (cell_cfg.state != cell_state_primary) {
     return SRSRAN_ERROR;
   }
 
   return SRSRAN_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
+inline int phy_ue_db::_assert_ue_cc(const ue_cfg_t& cfg, uint32_t ue_cc_idx)
 {
-  if (_assert_rnti(rnti) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
-  }
-
   // Check the cell index is in range
   if (ue_cc_idx >= SRSRAN_MAX_CARRIERS) {
     return SRSRAN_ERROR;
   }
 
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info.at(ue_cc_idx);
-  if (cell_info.state == cell_state_none) {
+  const cell_cfg_t& cell_cfg = cfg.cell_cfg.at(ue_cc_idx);
+  if (cell_cfg.state == cell_state_none) {
     return SRSRAN_ERROR;
   }
 
   return SRSRAN_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
+inline int phy_ue_db::_assert_active_enb_cc(const ue_cfg_t& cfg, uint32_t enb_cc_idx)
 {
-  if (_assert_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  if (_assert_enb_cc(cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // Check SCell is active, ignore PCell state
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
-  if (cell_info.state != cell_state_primary and cell_info.state != cell_state_secondary_active) {
+  const cell_cfg_t& cell_cfg = cfg.cell_cfg[_get_ue_cc_idx(cfg, enb_cc_idx)];
+  if (cell_cfg.state != cell_state_primary and cell_cfg.state != cell_state_secondary_active) {
     return SRSRAN_ERROR;
   }
 
@@ -233,52 +280,48 @@ inline int phy_ue_db::_assert_cell_list_cfg() const
   return SRSRAN_SUCCESS;
 }
 
-inline int phy_ue_db::_get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, srsran::phy_cfg_t& phy_cfg) const
+inline const phy_ue_db::cell_cfg_t* phy_ue_db::_get_rnti_config(uint16_t                         rnti,
+                                                                uint32_t                         enb_cc_idx,
+                                                                std::shared_ptr<const ue_cfg_t>& cfg,
+                                                                uint32_t&                        ue_cc_idx) const
 {
-  srsran::phy_cfg_t default_cfg = {};
-  default_cfg.set_defaults();
-  default_cfg.dl_cfg.pdsch.rnti = rnti;
-  default_cfg.ul_cfg.pucch.rnti = rnti;
-  default_cfg.ul_cfg.pusch.rnti = rnti;
-
-  // Use default configuration for non-user C-RNTI
-  if (not SRSRAN_RNTI_ISUSER(rnti)) {
-    phy_cfg = default_cfg;
-    return SRSRAN_SUCCESS;
-  }
-
   // Make sure the C-RNTI exists and the cell/carrier is configured
-  if (_assert_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
+  cfg = _get_ue_cfg(rnti);
+  if (cfg == nullptr or _assert_enb_cc(*cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
+    return nullptr;
   }
 
-  // Write the current configuration
-  uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-  phy_cfg            = ue_db.at(rnti).cell_info.at(ue_cc_idx).phy_cfg;
-  return SRSRAN_SUCCESS;
+  ue_cc_idx = _get_ue_cc_idx(*cfg, enb_cc_idx);
+  return &cfg->cell_cfg.at(ue_cc_idx);
 }
 
 void phy_ue_db::clear_tti_pending_ack(uint32_t tti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Iterate all UEs
-  for (auto& iter : ue_db) {
-    _clear_tti_pending_rnti(TTIMOD(tti), iter.first);
+  for (uint32_t ue_idx = 0; ue_idx < max_nof_ues; ue_idx++) {
+    std::lock_guard<std::mutex> lock(ues[ue_idx].mutex);
+    if (ues[ue_idx].rnti != SRSRAN_INVALID_RNTI) {
+      _clear_tti_pending_rnti(TTIMOD(tti), ues[ue_idx]);
+    }
   }
 }
 
 void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_cfg_list_t& phy_cfg_list)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(cfg_mutex);
 
   // Create new user if did not exist
-  if (ue_db.count(rnti) == 0) {
-    _add_rnti(rnti);
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr) {
+    ue = _add_rnti(rnti);
+    if (ue == nullptr) {
+      srslog::fetch_basic_logger("PHY").error("Error adding rnti=0x%x, the UE database is full", rnti);
+      return;
+    }
   }
 
-  // Get UE by reference
-  common_ue& ue = ue_db[rnti];
+  // Copy the current configuration. It is not modified by other threads, as they do not hold the configuration mutex
+  std::shared_ptr<ue_cfg_t> cfg = std::make_shared<ue_cfg_t>(*ue->cfg);
 
   // During a reconfiguration, all parameters in phy_cfg_t shall be applied immediately except:
   // - Multiple CSI request field in DCI (phy_cfg_t.dl_cfg.dci.multiple_csi_request_enabled)
@@ -289,9 +332,9 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
   // and the reception of the reconfigurationComplete, the values before the reconfiguration shall be used
 
   // Store the current values for CSI and extended TBS in temporary variables
-  ue.stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(rnti) > 0);
+  cfg->stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(*cfg) > 0);
   for (uint32_t i = 0; i < SRSRAN_MAX_CARRIERS; i++) {
-    ue.cell_info[i].stash_use_tbs_index_alt = ue.cell_info[i].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
+    cfg->cell_cfg[i].stash_use_tbs_index_alt = cfg->cell_cfg[i].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
   }
 
   // Iterate PHY RRC configuration for each UE cell/carrier
@@ -299,70 +342,81 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
   for (uint32_t ue_cc_idx = 0; ue_cc_idx < nof_cc; ue_cc_idx++) {
     const phy_interface_rrc_lte::phy_rrc_cfg_t& phy_rrc_dedicated = phy_cfg_list[ue_cc_idx];
 
-    // Configured, add/modify entry in the cell_info map
-    cell_info_t& cell_info = ue.cell_info[ue_cc_idx];
+    // Configured, add/modify entry in the cell_cfg map
+    cell_cfg_t& cell_cfg = cfg->cell_cfg[ue_cc_idx];
 
     // Configure PHY
-    if (cell_info.state == cell_state_primary) {
+    if (cell_cfg.state == cell_state_primary) {
       // If primary serving cell's eNb cell/carrier index changed, it applies default current config
-      if (cell_info.enb_cc_idx != phy_rrc_dedicated.enb_cc_idx) {
-        cell_info.phy_cfg.set_defaults();
-        _set_common_config_rnti(rnti, cell_info.phy_cfg);
+      if (cell_cfg.enb_cc_idx != phy_rrc_dedicated.enb_cc_idx) {
+        cell_cfg.phy_cfg.set_defaults();
+        _set_common_config_rnti(rnti, cell_cfg.phy_cfg);
       }
 
       // Apply primary serving cell configuration
-      cell_info.phy_cfg = phy_rrc_dedicated.phy_cfg;
-      _set_common_config_rnti(rnti, cell_info.phy_cfg);
+      cell_cfg.phy_cfg = phy_rrc_dedicated.phy_cfg;
+      _set_common_config_rnti(rnti, cell_cfg.phy_cfg);
     } else if (phy_rrc_dedicated.configured) {
       // Overwrite the secondary serving cell configuration independently of the current state. Higher layers (MAC
       // and/or RRC) shall be responsible for the secondary serving cell activation/deactivation.
-      cell_info.phy_cfg = phy_rrc_dedicated.phy_cfg;
-      _set_common_config_rnti(rnti, cell_info.phy_cfg);
+      cell_cfg.phy_cfg = phy_rrc_dedicated.phy_cfg;
+      _set_common_config_rnti(rnti, cell_cfg.phy_cfg);
 
       // Set Cell state to inactive (as configured) only if it was not configured before. Avoid losing coherence with
       // MAC Activation/Deactivation states
-      if (cell_info.state == cell_state_t::cell_state_none) {
-        cell_info.state = cell_state_secondary_inactive;
+      if (cell_cfg.state == cell_state_t::cell_state_none) {
+        cell_cfg.state = cell_state_secondary_inactive;
       }
     } else {
       // Cell without configuration (except PCell)
-      cell_info.state = cell_state_none;
+      cell_cfg.state = cell_state_none;
     }
 
     // Set serving cell index
-    cell_info.enb_cc_idx = phy_rrc_dedicated.enb_cc_idx;
+    cell_cfg.enb_cc_idx = phy_rrc_dedicated.enb_cc_idx;
   }
 
   // Disable the rest of potential serving cells
   for (uint32_t i = nof_cc; i < SRSRAN_MAX_CARRIERS; i++) {
-    ue.cell_info[i].state = cell_state_none;
+    cfg->cell_cfg[i].state = cell_state_none;
   }
 
   // Enable/Disable extended CSI field in DCI according to 3GPP 36.212 R10 5.3.3.1.1 Format 0
+  bool multiple_csi_request_enabled = (_count_nof_configured_scell(*cfg) > 0);
   for (uint32_t ue_cc_idx = 0; ue_cc_idx < nof_cc; ue_cc_idx++) {
-    ue.cell_info[ue_cc_idx].phy_cfg.dl_cfg.dci.multiple_csi_request_enabled = (_count_nof_configured_scell(rnti) > 0);
+    cfg->cell_cfg[ue_cc_idx].phy_cfg.dl_cfg.dci.multiple_csi_request_enabled = multiple_csi_request_enabled;
   }
+
+  _publish_ue_cfg(*ue, std::move(cfg));
 }
 
 int phy_ue_db::rem_rnti(uint16_t rnti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(cfg_mutex);
 
-  if (ue_db.count(rnti) == 0) {
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr) {
     return SRSRAN_ERROR;
   }
 
-  ue_db.erase(rnti);
+  // Hide the UE from new lookups, then release the entry for the workers that already found it
+  rnti_to_ue[rnti].store(max_nof_ues, std::memory_order_release);
+  std::shared_ptr<const ue_cfg_t> cfg;
+  {
+    std::lock_guard<std::mutex> ue_lock(ue->mutex);
+    ue->rnti = SRSRAN_INVALID_RNTI;
+    ue->cfg.swap(cfg);
+  }
 
   return SRSRAN_SUCCESS;
 }
 
-uint32_t phy_ue_db::_count_nof_configured_scell(uint16_t rnti)
+uint32_t phy_ue_db::_count_nof_configured_scell(const ue_cfg_t& cfg)
 {
   uint32_t nof_configured_scell = 0;
   for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    if (ue_db[rnti].cell_info[ue_cc_idx].state == cell_state_t::cell_state_secondary_inactive ||
-        ue_db[rnti].cell_info[ue_cc_idx].state == cell_state_t::cell_state_secondary_active) {
+    if (cfg.cell_cfg[ue_cc_idx].state == cell_state_t::cell_state_secondary_inactive ||
+        cfg.cell_cfg[ue_cc_idx].state == cell_state_t::cell_state_secondary_active) {
       nof_configured_scell++;
     }
   }
@@ -371,135 +425,162 @@ uint32_t phy_ue_db::_count_nof_configured_scell(uint16_t rnti)
 
 int phy_ue_db::complete_config(uint16_t rnti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(cfg_mutex);
 
   // Makes sure the RNTI exists
-  if (_assert_rnti(rnti) != SRSRAN_SUCCESS) {
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr) {
     return SRSRAN_ERROR;
   }
 
   // Once the reconfiguration is complete, the temporary parameters become the new ones
+  std::shared_ptr<ue_cfg_t> cfg = std::make_shared<ue_cfg_t>(*ue->cfg);
 
   // Update temporary multiple CSI DCI field with the new value
-  ue_db[rnti].stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(rnti) > 0);
+  cfg->stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(*cfg) > 0);
   // Update temporary alternate TBS value with the new one
   for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    ue_db[rnti].cell_info[ue_cc_idx].stash_use_tbs_index_alt =
-        ue_db[rnti].cell_info[ue_cc_idx].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
+    cfg->cell_cfg[ue_cc_idx].stash_use_tbs_index_alt = cfg->cell_cfg[ue_cc_idx].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
   }
 
+  _publish_ue_cfg(*ue, std::move(cfg));
+
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, bool activate)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(cfg_mutex);
 
   // Assert RNTI and SCell are valid
-  if (_assert_ue_cc(rnti, ue_cc_idx) != SRSRAN_SUCCESS) {
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr or _assert_ue_cc(*ue->cfg, ue_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_SUCCESS;
   }
 
-  cell_info_t& cell_info = ue_db[rnti].cell_info[ue_cc_idx];
+  std::shared_ptr<ue_cfg_t> cfg      = std::make_shared<ue_cfg_t>(*ue->cfg);
+  cell_cfg_t&               cell_cfg = cfg->cell_cfg[ue_cc_idx];
 
   // If scell is default only complain
-  if (activate and cell_info.state == cell_state_none) {
+  if (activate and cell_cfg.state == cell_state_none) {
     return SRSRAN_ERROR;
   }
 
   // Set scell state
-  cell_info.state = (activate) ? cell_state_secondary_active : cell_state_secondary_inactive;
+  cell_cfg.state = (activate) ? cell_state_secondary_active : cell_state_secondary_inactive;
+
+  _publish_ue_cfg(*ue, std::move(cfg));
 
   return SRSRAN_SUCCESS;
 }
 
 bool phy_ue_db::is_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  return _assert_enb_pcell(rnti, enb_cc_idx) == SRSRAN_SUCCESS;
+  std::shared_ptr<const ue_cfg_t> cfg = _get_ue_cfg(rnti);
+  return cfg != nullptr and _assert_enb_pcell(*cfg, enb_cc_idx) == SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_dl_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dl_cfg_t& dl_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    dl_cfg            = default_cfg.dl_cfg;
+    dl_cfg.pdsch.rnti = rnti;
+    return SRSRAN_SUCCESS;
+  }
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  std::shared_ptr<const ue_cfg_t> cfg;
+  uint32_t                        ue_cc_idx = 0;
+  const cell_cfg_t*               cell_cfg  = _get_rnti_config(rnti, enb_cc_idx, cfg, ue_cc_idx);
+  if (cell_cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  dl_cfg = phy_cfg.dl_cfg;
+  dl_cfg = cell_cfg->phy_cfg.dl_cfg;
 
   // The DL configuration must overwrite the use_tbs_index_alt value (for 256QAM) with the temporary value
   // in case we are in the middle of a reconfiguration
-  if (ue_db.count(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
-    uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-    if (ue_cc_idx == 0) {
-      dl_cfg.pdsch.use_tbs_index_alt = ue_db.at(rnti).cell_info[ue_cc_idx].stash_use_tbs_index_alt;
-    }
+  if (ue_cc_idx == 0) {
+    dl_cfg.pdsch.use_tbs_index_alt = cell_cfg->stash_use_tbs_index_alt;
   }
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dci_cfg_t& dci_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    dci_cfg = default_cfg.dl_cfg.dci;
+    return SRSRAN_SUCCESS;
+  }
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  std::shared_ptr<const ue_cfg_t> cfg;
+  uint32_t                        ue_cc_idx = 0;
+  const cell_cfg_t*               cell_cfg  = _get_rnti_config(rnti, enb_cc_idx, cfg, ue_cc_idx);
+  if (cell_cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  dci_cfg = phy_cfg.dl_cfg.dci;
+  dci_cfg = cell_cfg->phy_cfg.dl_cfg.dci;
 
   // The DCI configuration used for DL grants must overwrite the multiple_csi_request_enabled value with the
   // temporary value in case we are in the middle of a reconfiguration
-  if (ue_db.count(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
-    uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-    if (ue_cc_idx == 0) {
-      dci_cfg.multiple_csi_request_enabled = ue_db.at(rnti).stashed_multiple_csi_request_enabled;
-    }
+  if (ue_cc_idx == 0) {
+    dci_cfg.multiple_csi_request_enabled = cfg->stashed_multiple_csi_request_enabled;
   }
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_ul_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_ul_cfg_t& ul_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    ul_cfg            = default_cfg.ul_cfg;
+    ul_cfg.pucch.rnti = rnti;
+    ul_cfg.pusch.rnti = rnti;
+    return SRSRAN_SUCCESS;
+  }
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  std::shared_ptr<const ue_cfg_t> cfg;
+  uint32_t                        ue_cc_idx = 0;
+  const cell_cfg_t*               cell_cfg  = _get_rnti_config(rnti, enb_cc_idx, cfg, ue_cc_idx);
+  if (cell_cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  ul_cfg = phy_cfg.ul_cfg;
+  ul_cfg = cell_cfg->phy_cfg.ul_cfg;
 
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_dci_ul_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dci_cfg_t& dci_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    dci_cfg = default_cfg.dl_cfg.dci;
+    return SRSRAN_SUCCESS;
+  }
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  std::shared_ptr<const ue_cfg_t> cfg;
+  uint32_t                        ue_cc_idx = 0;
+  const cell_cfg_t*               cell_cfg  = _get_rnti_config(rnti, enb_cc_idx, cfg, ue_cc_idx);
+  if (cell_cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  dci_cfg = phy_cfg.dl_cfg.dci;
+  dci_cfg = cell_cfg->phy_cfg.dl_cfg.dci;
 
   return SRSRAN_SUCCESS;
 }
 
 bool phy_ue_db::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srsran_dci_dl_t& dci)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  ue_lock_t ue(*this, dci.rnti);
 
   // Assert rnti and cell exits and it is active
-  if (_assert_active_enb_cc(dci.rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  if (not ue or _assert_active_enb_cc(*ue->cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return false;
   }
 
-  common_ue& ue        = ue_db.at(dci.rnti);
-  uint32_t   ue_cc_idx = _get_ue_cc_idx(dci.rnti, enb_cc_idx);
+  uint32_t ue_cc_idx = _get_ue_cc_idx(*ue->cfg, enb_cc_idx);
 
-  srsran_pdsch_ack_cc_t& pdsch_ack_cc = ue.pdsch_ack[tti].cc[ue_cc_idx];
+  srsran_pdsch_ack_cc_t& pdsch_ack_cc = ue->pdsch_ack[tti].cc[ue_cc_idx];
   pdsch_ack_cc.M                      = 1; ///< Hardcoded for FDD
 
   // Fill PDSCH ACK information
@@ -530,8 +611,6 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
                             bool              is_pusch_available,
                             srsran_uci_cfg_t& uci_cfg)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Reset UCI CFG, avoid returning carrying cached information
   uci_cfg = {};
 
@@ -541,12 +620,14 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   }
 
   // Assert eNb Cell/Carrier for the given RNTI
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  ue_lock_t ue(*this, rnti);
+  if (not ue or _assert_active_enb_cc(*ue->cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
+  const ue_cfg_t& cfg = *ue->cfg;
 
   // Get the eNb cell/carrier index with lowest serving cell index (ue_cc_idx) that has an available grant.
-  uint32_t uci_enb_cc_id         = _get_uci_enb_cc_idx(tti, rnti);
+  uint32_t uci_enb_cc_id         = _get_uci_enb_cc_idx(tti, *ue);
   bool     pusch_grant_available = (uci_enb_cc_id < (uint32_t)cell_cfg_list->size());
 
   // There is a PUSCH grant available for the provided RNTI in at least one serving cell and this call is for PUCCH
@@ -560,16 +641,15 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   }
 
   // No PUSCH grant for this TTI and cell and no enb_cc_idx is not the PCell
-  if (not pusch_grant_available and _get_ue_cc_idx(rnti, enb_cc_idx) != 0) {
+  if (not pusch_grant_available and _get_ue_cc_idx(cfg, enb_cc_idx) != 0) {
     return SRSRAN_SUCCESS;
   }
 
-  common_ue&               ue           = ue_db.at(rnti);
-  const srsran::phy_cfg_t& pcell_cfg    = ue.cell_info[0].phy_cfg;
+  const srsran::phy_cfg_t& pcell_cfg    = cfg.cell_cfg[0].phy_cfg;
   bool                     uci_required = false;
 
-  const cell_info_t&   pcell_info = ue.cell_info[0];
-  const srsran_cell_t& pcell      = cell_cfg_list->at(pcell_info.enb_cc_idx).cell;
+  const cell_info_t&   pcell_info = ue->cell_info[0];
+  const srsran_cell_t& pcell      = cell_cfg_list->at(cfg.cell_cfg[0].enb_cc_idx).cell;
 
   // Check if SR opportunity (will only be used in PUCCH)
   uci_cfg.is_scheduling_request_tti = (srsran_ue_ul_sr_send_tti(&pcell_cfg.ul_cfg.pucch, tti) == 1);
@@ -578,16 +658,17 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   // Get pending CQI reports for this TTI, stops at first CC reporting
   bool periodic_cqi_required = false;
   for (uint32_t cell_idx = 0; cell_idx < SRSRAN_MAX_CARRIERS and not periodic_cqi_required; cell_idx++) {
-    const cell_info_t&     cell_info = ue.cell_info[cell_idx];
-    const srsran_dl_cfg_t& dl_cfg    = cell_info.phy_cfg.dl_cfg;
+    const cell_cfg_t&      cell_cfg = cfg.cell_cfg[cell_idx];
+    const srsran_dl_cfg_t& dl_cfg   = cell_cfg.phy_cfg.dl_cfg;
 
     // According 3GPP 36.213 R10 section 7.2 UE procedure for reporting Channel State Information (CSI)
     // If the UE is configured with more than one serving cell, it transmits CSI for activated serving cell(s) only.
-    if (cell_info.state == cell_state_primary or cell_info.state == cell_state_secondary_active) {
-      const srsran_cell_t& cell = cell_cfg_list->at(cell_info.enb_cc_idx).cell;
+    if (cell_cfg.state == cell_state_primary or cell_cfg.state == cell_state_secondary_active) {
+      const srsran_cell_t& cell = cell_cfg_list->at(cell_cfg.enb_cc_idx).cell;
 
       // Check if CQI report is required
-      periodic_cqi_required = srsran_enb_dl_gen_cqi_periodic(&cell, &dl_cfg, tti, cell_info.last_ri, &uci_cfg.cqi);
+      periodic_cqi_required =
+          srsran_enb_dl_gen_cqi_periodic(&cell, &dl_cfg, tti, ue->cell_info[cell_idx].last_ri, &uci_cfg.cqi);
 
       // Save SCell index for using it after
       uci_cfg.cqi.scell_index = cell_idx;
@@ -598,7 +679,7 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   // If no periodic CQI report required, check aperiodic reporting
   if ((not periodic_cqi_required) and aperiodic_cqi_request) {
     // Aperiodic only supported for PCell
-    const srsran_dl_cfg_t& dl_cfg = pcell_info.phy_cfg.dl_cfg;
+    const srsran_dl_cfg_t& dl_cfg = pcell_cfg.dl_cfg;
 
     uci_required = srsran_enb_dl_gen_cqi_aperiodic(&pcell, &dl_cfg, pcell_info.last_ri, &uci_cfg.cqi);
   }
@@ -606,7 +687,7 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   // Get pending ACKs from PDSCH
   srsran_dl_sf_cfg_t dl_sf_cfg  = {};
   dl_sf_cfg.tti                 = tti;
-  srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
+  srsran_pdsch_ack_t& pdsch_ack = ue->pdsch_ack[tti];
   pdsch_ack.is_pusch_available  = is_pusch_available;
   srsran_enb_dl_gen_ack(&pcell, &dl_sf_cfg, &pdsch_ack, &uci_cfg);
   uci_required |= (srsran_uci_cfg_total_ack(&uci_cfg) > 0);
@@ -660,12 +741,12 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
                              const srsran_uci_cfg_t&   uci_cfg,
                              const srsran_uci_value_t& uci_value)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert UE RNTI database entry and eNb cell/carrier must be active
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  ue_lock_t ue(*this, rnti);
+  if (not ue or _assert_active_enb_cc(*ue->cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
+  const ue_cfg_t& cfg = *ue->cfg;
 
   // Assert Stack
   if (_assert_stack() != SRSRAN_SUCCESS) {
@@ -677,12 +758,9 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
     stack->sr_detected(tti, rnti);
   }
 
-  // Get UE
-  common_ue& ue = ue_db.at(rnti);
-
   // Get ACK info
-  srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
-  const srsran_cell_t& cell      = cell_cfg_list->at(ue.cell_info[0].enb_cc_idx).cell;
+  srsran_pdsch_ack_t&  pdsch_ack = ue->pdsch_ack[tti];
+  const srsran_cell_t& cell      = cell_cfg_list->at(cfg.cell_cfg[0].enb_cc_idx).cell;
   srsran_enb_dl_get_ack(&cell, &uci_cfg, &uci_value, &pdsch_ack);
 
   // Iterate over the ACK information
@@ -692,7 +770,7 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
       if (pdsch_ack_cc.m[m].present) {
         for (uint32_t tb = 0; tb < SRSRAN_MAX_CODEWORDS; tb++) {
           if (pdsch_ack_cc.m[m].value[tb] != 2) {
-            stack->ack_info(tti, rnti, ue.cell_info[ue_cc_idx].enb_cc_idx, tb, pdsch_ack_cc.m[m].value[tb] == 1);
+            stack->ack_info(tti, rnti, cfg.cell_cfg[ue_cc_idx].enb_cc_idx, tb, pdsch_ack_cc.m[m].value[tb] == 1);
           }
         }
       }
@@ -700,19 +778,20 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
   }
 
   // Assert the SCell exists and it is active
-  if (_assert_ue_cc(rnti, uci_cfg.cqi.scell_index) != SRSRAN_SUCCESS) {
+  if (_assert_ue_cc(cfg, uci_cfg.cqi.scell_index) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // Get CQI carrier index
-  cell_info_t& cqi_scell_info = ue_db.at(rnti).cell_info[uci_cfg.cqi.scell_index];
-  uint32_t     cqi_cc_idx     = cqi_scell_info.enb_cc_idx;
+  cell_info_t& cqi_scell_info = ue->cell_info[uci_cfg.cqi.scell_index];
+  uint32_t     cqi_cc_idx     = cfg.cell_cfg[uci_cfg.cqi.scell_index].enb_cc_idx;
 
   // Notify CQI only if CRC is valid
   if (uci_value.cqi.data_crc) {
     // Channel quality indicator itself
     if (uci_cfg.cqi.data_enable) {
-      send_cqi_data(tti, rnti, cqi_cc_idx, uci_cfg.cqi, uci_value.cqi, ue.cell_info[0].phy_cfg.dl_cfg.cqi_report, cell, stack);
+      send_cqi_data(
+          tti, rnti, cqi_cc_idx, uci_cfg.cqi, uci_value.cqi, cfg.cell_cfg[0].phy_cfg.dl_cfg.cqi_report, cell, stack);
     }
 
     // Precoding Matrix indicator (TM4)
@@ -744,42 +823,40 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
 
 int phy_ue_db::set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srsran_ra_tb_t tb)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert UE DB entry
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  ue_lock_t ue(*this, rnti);
+  if (not ue or _assert_active_enb_cc(*ue->cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // Save resource allocation
-  ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid] = tb;
+  ue->cell_info[_get_ue_cc_idx(*ue->cfg, enb_cc_idx)].last_tb[pid] = tb;
 
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srsran_ra_tb_t& ra_tb) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert UE DB entry
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  ue_lock_t ue(*this, rnti);
+  if (not ue or _assert_active_enb_cc(*ue->cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // writes the latest stored UL transmission grant
-  ra_tb = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid];
+  ra_tb = ue->cell_info[_get_ue_cc_idx(*ue->cfg, enb_cc_idx)].last_tb[pid];
 
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_lte::ul_sched_list_t& ul_sched_list)
 {
-  int                         ret = SRSRAN_SUCCESS;
-  std::lock_guard<std::mutex> lock(mutex);
+  int ret = SRSRAN_SUCCESS;
 
   // Reset all available grants flags for the given TTI
-  for (auto& ue : ue_db) {
-    for (cell_info_t& cell_info : ue.second.cell_info) {
+  for (uint32_t ue_idx = 0; ue_idx < max_nof_ues; ue_idx++) {
+    std::lock_guard<std::mutex> lock(ues[ue_idx].mutex);
+    for (cell_info_t& cell_info : ues[ue_idx].cell_info) {
       cell_info.is_grant_available[tti] = false;
     }
   }
@@ -791,13 +868,14 @@ int phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_lt
       const stack_interface_phy_lte::ul_sched_grant_t& ul_sched_grant = ul_sched.pusch[i];
       uint16_t                                         rnti           = ul_sched_grant.dci.rnti;
       // Check that eNb Cell/Carrier is active for the given RNTI
-      if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+      ue_lock_t ue(*this, rnti);
+      if (not ue or _assert_active_enb_cc(*ue->cfg, enb_cc_idx) != SRSRAN_SUCCESS) {
         ret = SRSRAN_ERROR;
         srslog::fetch_basic_logger("PHY").info("Error setting grant for rnti=0x%x, cc=%d", rnti, enb_cc_idx);
         continue;
       }
       // Rise Grant available flag
-      ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].is_grant_available[tti] = true;
+      ue->cell_info[_get_ue_cc_idx(*ue->cfg, enb_cc_idx)].is_grant_available[tti] = true;
     }
   }
 
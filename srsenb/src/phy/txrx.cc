@@ -24,6 +24,7 @@
 #include "srsenb/hdr/phy/txrx.h"
 #include "srsran/common/band_helper.h"
 #include "srsran/common/threads.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/srsran.h"
 
 #define Error(fmt, ...)                                                                                                \
@@ -140,6 +141,7 @@ void txrx::run_thread()
   while (running) {
     tti = TTI_ADD(tti, 1);
     logger.set_context(tti);
+    tti_trace_event("PHY", "txrx::run_thread", tti);
 
     lte::sf_worker* lte_worker = nullptr;
     if (worker_com->get_nof_carriers_lte() > 0) {
@@ -186,7 +188,10 @@ void txrx::run_thread()
     }
 
     buffer.set_nof_samples(sf_len);
-    radio_h->rx_now(buffer, timestamp);
+    {
+      tti_trace_event("PHY", "radio::rx_now", tti);
+      radio_h->rx_now(buffer, timestamp);
+    }
 
     if (ul_channel) {
       ul_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), sf_len, timestamp.get(0));
@@ -32,7 +32,7 @@ using namespace srsran;
 
 namespace srsenb {
 
-enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
+enb_stack_lte::enb_stack_lte(srslog::sink& log_sink, srsran::socket_manager& rx_sockets_) :
   thread("STACK"),
   mac_logger(srslog::fetch_basic_logger("MAC", log_sink)),
   rlc_logger(srslog::fetch_basic_logger("RLC", log_sink, false)),
@@ -42,11 +42,12 @@ enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
   gtpu_logger(srslog::fetch_basic_logger("GTPU", log_sink, false)),
   stack_logger(srslog::fetch_basic_logger("STCK", log_sink, false)),
   task_sched(512, 128),
+  rx_sockets(rx_sockets_),
   pdcp(&task_sched, pdcp_logger),
   mac(&task_sched, mac_logger),
   rlc(rlc_logger),
-  gtpu(&task_sched, gtpu_logger, &get_rx_io_manager()),
-  s1ap(&task_sched, s1ap_logger, &get_rx_io_manager()),
+  gtpu(&task_sched, gtpu_logger, &rx_sockets_),
+  s1ap(&task_sched, s1ap_logger, &rx_sockets_),
   rrc(&task_sched, bearers),
   mac_pcap(),
   pending_stack_metrics(64)
@@ -185,7 +186,7 @@ void enb_stack_lte::stop()
 
 void enb_stack_lte::stop_impl()
 {
-  get_rx_io_manager().stop();
+  rx_sockets.stop();
 
   s1ap.stop();
   gtpu.stop();
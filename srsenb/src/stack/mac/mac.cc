@@ -27,6 +27,7 @@
 #include "srsran/common/rwlock_guard.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/time_prof.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/interfaces/enb_phy_interfaces.h"
 #include "srsran/interfaces/enb_rlc_interfaces.h"
 #include "srsran/interfaces/enb_rrc_interface_mac.h"
@@ -637,6 +638,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
   }
 
   trace_threshold_complete_event("mac::get_dl_sched", "total_time", std::chrono::microseconds(100));
+  tti_trace_event("MAC", "mac::get_dl_sched", tti_tx_dl);
   logger.set_context(TTI_SUB(tti_tx_dl, FDD_HARQ_DELAY_UL_MS));
   if (do_padding) {
     add_padding();
@@ -964,6 +966,7 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
     return SRSRAN_SUCCESS;
   }
 
+  tti_trace_event("MAC", "mac::get_ul_sched", tti_tx_ul);
   logger.set_context(TTI_SUB(tti_tx_ul, FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS));
 
   srsran::rwlock_read_guard lock(rwlock);
@@ -19,6 +19,7 @@
  *
  */
 
+#include <algorithm>
 #include <srsenb/hdr/stack/mac/sched_ue.h>
 #include <string.h>
 
@@ -52,6 +53,10 @@ void sched::init(rrc_interface_mac* rrc_, const sched_args_t& sched_cfg_)
   // Initialize first carrier scheduler
   carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0, &sched_results});
 
+  if (sched_cfg.nof_cc_workers > 0) {
+    cc_workers.reset(new srsran::task_thread_pool{sched_cfg.nof_cc_workers, false, CC_WORKERS_THREAD_PRIO});
+  }
+
   reset();
 }
 
@@ -361,15 +366,98 @@ void sched::new_tti(tti_point tti_rx)
 {
   last_tti = std::max(last_tti, tti_rx);
 
-  // Generate sched results for all CCs, if not yet generated
+  // Find the CCs whose results are not yet generated
+  cc_mask_t pending_ccs;
+  for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    pending_ccs[cc_idx] = not is_generated(tti_rx, cc_idx);
+  }
+  if (pending_ccs.none()) {
+    return;
+  }
+
+  /* Refresh UE internal buffers and subframe vars */
+  for (auto& user : ue_db) {
+    user.second->new_subframe(tti_rx);
+  }
+
+  /* Setup the CCs. This step accesses state shared by all CCs */
+  for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    if (pending_ccs.test(cc_idx)) {
+      carrier_schedulers[cc_idx]->new_tti(tti_rx);
+    }
+  }
+
+  /* Generate carrier scheduling results */
+  if (cc_workers == nullptr) {
+    for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+      if (pending_ccs.test(cc_idx)) {
+        carrier_schedulers[cc_idx]->alloc_tti_grants(tti_rx);
+        carrier_schedulers[cc_idx]->generate_tti_result(tti_rx);
+      }
+    }
+    return;
+  }
+
+  /* Allocate the carrier grants in parallel */
+  std::vector<cc_mask_t> cc_groups = get_cc_groups(pending_ccs);
+  {
+    std::lock_guard<std::mutex> lock(cc_workers_mutex);
+    nof_pending_cc_groups = cc_groups.size() - 1;
+  }
+  for (size_t i = 1; i < cc_groups.size(); ++i) {
+    cc_mask_t cc_group = cc_groups[i];
+    cc_workers->push_task([this, tti_rx, cc_group]() {
+      alloc_cc_group_grants(tti_rx, cc_group);
+      std::lock_guard<std::mutex> lock(cc_workers_mutex);
+      if (--nof_pending_cc_groups == 0) {
+        cc_workers_cvar.notify_one();
+      }
+    });
+  }
+  // The calling thread takes the first group, and waits for the workers to finish the others
+  alloc_cc_group_grants(tti_rx, cc_groups[0]);
+  {
+    std::unique_lock<std::mutex> lock(cc_workers_mutex);
+    while (nof_pending_cc_groups > 0) {
+      cc_workers_cvar.wait(lock);
+    }
+  }
+
+  /* Merge the UE state. The DCIs and MAC PDUs of each CC are generated in order, so the HARQs, buffers and UCI on PUSCH
+   * of the UEs are updated as in the serial case. The DL grants whose buffer was emptied by a lower index CC of the
+   * same UE are dropped */
   for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
-    if (not is_generated(tti_rx, cc_idx)) {
-      // Generate carrier scheduling result
+    if (pending_ccs.test(cc_idx)) {
       carrier_schedulers[cc_idx]->generate_tti_result(tti_rx);
     }
   }
 }
 
+/// Splits the CCs into one group per thread, i.e. the workers plus the calling thread. A CC only allocates its own
+/// grids and the per-CC state of its UEs, so the CCs of a CA UE may be allocated by different threads
+std::vector<sched::cc_mask_t> sched::get_cc_groups(const cc_mask_t& cc_mask) const
+{
+  size_t nof_groups = std::min(cc_mask.count(), cc_workers->nof_workers() + 1);
+
+  std::vector<cc_mask_t> groups(nof_groups);
+  size_t                 count = 0;
+  for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    if (cc_mask.test(cc_idx)) {
+      groups[count++ % nof_groups].set(cc_idx);
+    }
+  }
+  return groups;
+}
+
+void sched::alloc_cc_group_grants(tti_point tti_rx, const cc_mask_t& cc_group)
+{
+  for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    if (cc_group.test(cc_idx)) {
+      carrier_schedulers[cc_idx]->alloc_tti_grants(tti_rx);
+    }
+  }
+}
+
 /// Check if TTI result is generated
 bool sched::is_generated(srsran::tti_point tti_rx, uint32_t enb_cc_idx) const
 {
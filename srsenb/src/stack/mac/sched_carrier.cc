@@ -381,31 +381,32 @@ void sched::carrier_sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
   sf_dl_mask.assign(tti_mask, tti_mask + nof_sfs);
 }
 
-const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_rx)
+void sched::carrier_sched::new_tti(tti_point tti_rx)
 {
-  sf_sched*        tti_sched = get_sf_sched(tti_rx);
-  sf_sched_result* sf_result = prev_sched_results->get_sf(tti_rx);
-  cc_sched_result* cc_result = sf_result->get_cc(enb_cc_idx);
+  sf_sched* tti_sched = get_sf_sched(tti_rx);
 
-  bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] == 0;
-
-  /* Refresh UE internal buffers and subframe vars */
-  for (auto& user : *ue_db) {
-    user.second->new_subframe(tti_rx, enb_cc_idx);
-  }
-
-  /* Schedule PHICH */
+  /* Schedule PHICH. The UL HARQ state is read by all the carriers of a CA UE */
   for (auto& ue_pair : *ue_db) {
     if (tti_sched->alloc_phich(ue_pair.second.get()) == alloc_result::no_grant_space) {
       break;
     }
   }
 
-  /* Schedule DL control data */
-  if (dl_active) {
-    /* Schedule Broadcast data (SIB and paging) */
+  if (is_dl_active(tti_sched)) {
+    /* Setup the Msg3 TTI, whose results are shared by all carriers */
+    get_sf_sched(tti_rx + MSG3_DELAY_MS);
+
+    /* Schedule Broadcast data (SIB and paging). The paging state is shared by all carriers */
     bc_sched_ptr->dl_sched(tti_sched);
+  }
+}
 
+void sched::carrier_sched::alloc_tti_grants(tti_point tti_rx)
+{
+  sf_sched* tti_sched = get_sf_sched(tti_rx);
+
+  /* Schedule DL control data */
+  if (is_dl_active(tti_sched)) {
     /* Schedule RAR */
     ra_sched_ptr->dl_sched(tti_sched);
 
@@ -428,6 +429,13 @@ const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_r
   if ((tti_rx.to_uint() % 2) == 1) {
     alloc_ul_users(tti_sched);
   }
+}
+
+const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_rx)
+{
+  sf_sched*        tti_sched = get_sf_sched(tti_rx);
+  sf_sched_result* sf_result = prev_sched_results->get_sf(tti_rx);
+  cc_sched_result* cc_result = sf_result->get_cc(enb_cc_idx);
 
   /* Select the winner DCI allocation combination, store all the scheduling results */
   tti_sched->generate_sched_results(*ue_db);
@@ -443,9 +451,14 @@ const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_r
   return *cc_result;
 }
 
+bool sched::carrier_sched::is_dl_active(const sf_sched* tti_sched) const
+{
+  return sf_dl_mask[tti_sched->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] == 0;
+}
+
 void sched::carrier_sched::alloc_dl_users(sf_sched* tti_result)
 {
-  if (sf_dl_mask[tti_result->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] != 0) {
+  if (not is_dl_active(tti_result)) {
     return;
   }
 
@@ -699,7 +699,27 @@ void sf_sched::set_dl_data_sched_result(const sf_cch_allocator::alloc_result_t&
                                         sched_interface::dl_sched_res_t*        dl_result,
                                         sched_ue_list&                          ue_list)
 {
+  cc_sched_result* cc_result = cc_results->get_cc(cc_cfg->enb_cc_idx);
+
   for (const auto& data_alloc : data_allocs) {
+    auto ue_it = ue_list.find(data_alloc.rnti);
+    if (ue_it != ue_list.end()) {
+      sched_ue* user = ue_it->second.get();
+      if (user->get_dl_harq(data_alloc.pid, cc_cfg->enb_cc_idx).is_empty() and
+          user->get_pending_dl_bytes(cc_cfg->enb_cc_idx) == 0) {
+        // When the carriers are allocated in parallel, the results of the carriers generated before this one may have
+        // emptied the UE DL buffers. The grant is dropped, and its CCEs and RBGs are released
+        const srsran_dci_location_t& loc = dci_result[data_alloc.dci_idx]->dci_pos;
+        cc_result->pdcch_mask.fill(loc.ncce, loc.ncce + (1u << loc.L), false);
+        cc_result->dl_mask &= ~data_alloc.user_mask;
+        logger.info("SCHED: DL tx rnti=0x%x, cc=%d, pid=%d dropped. Cause: DL buffer emptied by other carriers",
+                    user->get_rnti(),
+                    cc_cfg->enb_cc_idx,
+                    data_alloc.pid);
+        continue;
+      }
+    }
+
     dl_result->data.emplace_back();
     sched_interface::dl_sched_data_t* data = &dl_result->data.back();
 
@@ -707,7 +727,6 @@ void sf_sched::set_dl_data_sched_result(const sf_cch_allocator::alloc_result_t&
     data->dci.location = dci_result[data_alloc.dci_idx]->dci_pos;
 
     // Generate DCI Format1/2/2A
-    auto ue_it = ue_list.find(data_alloc.rnti);
     if (ue_it == ue_list.end()) {
       continue;
     }
@@ -992,12 +1011,12 @@ void sf_sched::generate_sched_results(sched_ue_list& ue_db)
     log_po_allocation(cc_result->dl_sched_result.po.back(), po_alloc.rbg_range, *cc_cfg);
   }
 
+  cc_result->dl_mask = tti_alloc.get_dl_mask();
   set_dl_data_sched_result(dci_result, &cc_result->dl_sched_result, ue_db);
 
   set_ul_sched_result(dci_result, &cc_result->ul_sched_result, ue_db);
 
   /* Store remaining sf_sched results for this TTI */
-  cc_result->dl_mask   = tti_alloc.get_dl_mask();
   cc_result->ul_mask   = tti_alloc.get_ul_mask();
   cc_result->generated = true;
 }
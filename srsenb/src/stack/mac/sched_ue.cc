@@ -96,7 +96,7 @@ void sched_ue::set_cfg(const ue_cfg_t& cfg_)
   check_ue_cfg_correctness(cfg);
 }
 
-void sched_ue::new_subframe(tti_point tti_rx, uint32_t enb_cc_idx)
+void sched_ue::new_subframe(tti_point tti_rx)
 {
   if (current_tti != tti_rx) {
     current_tti = tti_rx;
@@ -33,6 +33,9 @@ struct run_params {
   uint32_t    nof_ttis;
   uint32_t    cqi;
   const char* sched_policy;
+  uint32_t    nof_ccs;
+  uint32_t    nof_ccs_per_ue;
+  uint32_t    nof_cc_workers;
 };
 
 struct run_params_range {
@@ -41,13 +44,19 @@ struct run_params_range {
   uint32_t                 nof_ttis     = 10000;
   std::vector<uint32_t>    cqi          = {5, 10, 15};
   std::vector<const char*> sched_policy = {"time_rr", "time_pf"};
+  uint32_t                 nof_ccs        = 1;
+  uint32_t                 nof_ccs_per_ue = 1;
+  uint32_t                 nof_cc_workers = 0;
 
   size_t     nof_runs() const { return nof_prbs.size() * nof_ues.size() * cqi.size() * sched_policy.size(); }
   run_params get_params(size_t idx) const
   {
-    run_params r = {};
-    r.nof_ttis   = nof_ttis;
-    r.nof_prbs   = nof_prbs[idx % nof_prbs.size()];
+    run_params r     = {};
+    r.nof_ttis       = nof_ttis;
+    r.nof_ccs        = nof_ccs;
+    r.nof_ccs_per_ue = nof_ccs_per_ue;
+    r.nof_cc_workers = nof_cc_workers;
+    r.nof_prbs       = nof_prbs[idx % nof_prbs.size()];
     idx /= nof_prbs.size();
     r.nof_ues = nof_ues[idx % nof_ues.size()];
     idx /= nof_ues.size();
@@ -90,7 +99,7 @@ public:
 
   struct throughput_stats {
     srsran::rolling_average<float>  mean_dl_tbs, mean_ul_tbs, avg_dl_mcs, avg_ul_mcs;
-    srsran::rolling_average<double> avg_latency;
+    srsran::rolling_average<double> avg_latency, avg_tti_latency;
     std::vector<uint32_t>           latency_samples;
   };
   throughput_stats total_stats;
@@ -101,6 +110,7 @@ public:
     mac_logger.set_context(tti_rx.to_uint());
     new_tti(tti_rx);
 
+    std::chrono::time_point<std::chrono::steady_clock> tti_tp = std::chrono::steady_clock::now();
     for (uint32_t cc = 0; cc < get_cell_params().size(); ++cc) {
       std::chrono::time_point<std::chrono::steady_clock> tp = std::chrono::steady_clock::now();
       TESTASSERT(sched_ptr->dl_sched(to_tx_dl(tti_rx).to_uint(), cc, dl_result[cc]) == SRSRAN_SUCCESS);
@@ -110,6 +120,10 @@ public:
       total_stats.avg_latency.push(tdur.count());
       total_stats.latency_samples.push_back(tdur.count());
     }
+    // With CC workers, all the carriers get scheduled in the first call, so the latency of a TTI is also kept
+    std::chrono::nanoseconds tti_dur =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tti_tp);
+    total_stats.avg_tti_latency.push(tti_dur.count());
 
     sf_output_res_t sf_out{get_cell_params(), tti_rx, ul_result, dl_result};
     update(sf_out);
@@ -167,14 +181,19 @@ struct run_data {
   float                     avg_ul_mcs;
   std::chrono::microseconds avg_latency;
   std::chrono::microseconds q0_9_latency;
+  std::chrono::microseconds avg_tti_latency;
 };
 
 int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results)
 {
-  std::vector<sched_interface::cell_cfg_t> cell_list(1, generate_default_cell_cfg(params.nof_prbs));
+  std::vector<sched_interface::cell_cfg_t> cell_list(params.nof_ccs, generate_default_cell_cfg(params.nof_prbs));
   sched_interface::ue_cfg_t                ue_cfg_default = generate_default_ue_cfg();
   sched_interface::sched_args_t            sched_args     = {};
   sched_args.sched_policy                                 = params.sched_policy;
+  sched_args.nof_cc_workers                               = params.nof_cc_workers;
+  for (uint32_t cc = 0; cc < cell_list.size(); ++cc) {
+    cell_list[cc].cell.id = cc + 1;
+  }
 
   sched     sched_obj;
   rrc_dummy rrc{};
@@ -186,14 +205,21 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
 
   for (uint32_t ue_idx = 0; ue_idx < params.nof_ues; ++ue_idx) {
     uint16_t rnti = 0x46 + ue_idx;
+    // Spread the UEs across carriers. CA UEs get consecutive carriers, starting at a multiple of the UE carriers
+    sched_interface::ue_cfg_t ue_cfg = ue_cfg_default;
+    ue_cfg.supported_cc_list.resize(params.nof_ccs_per_ue);
+    for (uint32_t i = 0; i < params.nof_ccs_per_ue; ++i) {
+      ue_cfg.supported_cc_list[i].active     = true;
+      ue_cfg.supported_cc_list[i].enb_cc_idx = (ue_idx * params.nof_ccs_per_ue + i) % params.nof_ccs;
+    }
     // Add user (first need to advance to a PRACH TTI)
     while (not srsran_prach_tti_opportunity_config_fdd(
-        tester.get_cell_params()[ue_cfg_default.supported_cc_list[0].enb_cc_idx].cfg.prach_config,
+        tester.get_cell_params()[ue_cfg.supported_cc_list[0].enb_cc_idx].cfg.prach_config,
         tester.get_tti_rx().to_uint(),
         -1)) {
       TESTASSERT(tester.advance_tti() == SRSRAN_SUCCESS);
     }
-    TESTASSERT(tester.add_user(rnti, ue_cfg_default, 16) == SRSRAN_SUCCESS);
+    TESTASSERT(tester.add_user(rnti, ue_cfg, 16) == SRSRAN_SUCCESS);
     TESTASSERT(tester.advance_tti() == SRSRAN_SUCCESS);
   }
 
@@ -208,7 +234,7 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
 
   // Run benchmark
   tester.total_stats = {};
-  tester.total_stats.latency_samples.reserve(params.nof_ttis);
+  tester.total_stats.latency_samples.reserve(params.nof_ttis * params.nof_ccs);
   for (uint32_t count = 0; count < params.nof_ttis; ++count) {
     tester.advance_tti();
   }
@@ -223,6 +249,8 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
   run_result.avg_latency  = std::chrono::microseconds(static_cast<int>(tester.total_stats.avg_latency.value() / 1000));
   run_result.q0_9_latency = std::chrono::microseconds(
       tester.total_stats.latency_samples[static_cast<size_t>(tester.total_stats.latency_samples.size() * 0.9)] / 1000);
+  run_result.avg_tti_latency =
+      std::chrono::microseconds(static_cast<int>(tester.total_stats.avg_tti_latency.value() / 1000));
   run_results.push_back(run_result);
 
   return SRSRAN_SUCCESS;
@@ -264,10 +292,10 @@ run_data expected_run_result(run_params params)
 void print_benchmark_results(const std::vector<run_data>& run_results)
 {
   srslog::flush();
-  fmt::print("run | Nprb | cqi | sched pol | Nue | DL/UL [Mbps] | DL/UL mcs | DL/UL OH [%] | latency | latency q0.9 "
-             "[usec]\n");
+  fmt::print("run | Nprb | cqi | sched pol | Nue | Ncc | Ncc/ue | Nwrk | DL/UL [Mbps] | DL/UL mcs | DL/UL OH [%] | "
+             "latency | latency q0.9 | TTI latency [usec]\n");
   fmt::print("------------------------------------------------------------------------------------------------------"
-             "------\n");
+             "-----------------------------------------------\n");
   for (uint32_t i = 0; i < run_results.size(); ++i) {
     const run_data& r = run_results[i];
 
@@ -279,12 +307,16 @@ void print_benchmark_results(const std::vector<run_data>& run_results)
     tbs                     = srsran_ra_tbs_from_idx(tbs_idx, nof_pusch_prbs);
     float ul_rate_overhead  = 1.0F - r.avg_ul_throughput / (static_cast<float>(tbs) * 1e3F);
 
-    fmt::print("{:>3d}{:>6d}{:>6d}{:>12}{:>6d}{:>9.2}/{:>4.2}{:>9.1f}/{:>4.1f}{:9.1f}/{:>4.1f}{:>9d}{:12d}\n",
+    fmt::print("{:>3d}{:>6d}{:>6d}{:>12}{:>6d}{:>6d}{:>9d}{:>7d}{:>9.2}/{:>4.2}{:>9.1f}/{:>4.1f}{:9.1f}/{:>4.1f}"
+               "{:>9d}{:15d}{:21d}\n",
                i,
                r.params.nof_prbs,
                r.params.cqi,
                r.params.sched_policy,
                r.params.nof_ues,
+               r.params.nof_ccs,
+               r.params.nof_ccs_per_ue,
+               r.params.nof_cc_workers,
                r.avg_dl_throughput / 1e6,
                r.avg_ul_throughput / 1e6,
                r.avg_dl_mcs,
@@ -292,7 +324,8 @@ void print_benchmark_results(const std::vector<run_data>& run_results)
                dl_rate_overhead * 100,
                ul_rate_overhead * 100,
                r.avg_latency.count(),
-               r.q0_9_latency.count());
+               r.q0_9_latency.count(),
+               r.avg_tti_latency.count());
   }
 }
 
@@ -315,6 +348,18 @@ int run_rate_test()
     TESTASSERT(run_benchmark_scenario(runparams, run_results) == SRSRAN_SUCCESS);
   }
 
+  // One UE per carrier, with the carriers scheduled in parallel
+  run_param_list.nof_prbs       = {6, 25, 100};
+  run_param_list.nof_ues        = {2};
+  run_param_list.nof_ccs        = 2;
+  run_param_list.nof_cc_workers = 1;
+  for (size_t r = 0; r < run_param_list.nof_runs(); ++r) {
+    run_params runparams = run_param_list.get_params(r);
+
+    mac_logger.info("\n=== New run {} ===\n", nof_runs + r);
+    TESTASSERT(run_benchmark_scenario(runparams, run_results) == SRSRAN_SUCCESS);
+  }
+
   print_benchmark_results(run_results);
 
   bool success = true;
@@ -394,6 +439,39 @@ int run_benchmark()
   return SRSRAN_SUCCESS;
 }
 
+int run_cc_benchmark()
+{
+  run_params_range      run_param_list{};
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  run_param_list.nof_ttis     = 100000;
+  run_param_list.nof_prbs     = {100};
+  run_param_list.cqi          = {15};
+  run_param_list.nof_ues      = {16};
+  run_param_list.sched_policy = {"time_pf"};
+  run_param_list.nof_ccs      = 4;
+
+  // UEs with 1, 2 and 4 carriers. The grants of the carriers of a CA UE are also allocated in parallel
+  std::vector<run_data> run_results;
+  fmt::print("Running Carrier Aggregation Benchmark\n");
+  for (uint32_t nof_ccs_per_ue : {1, 2, 4}) {
+    run_param_list.nof_ccs_per_ue = nof_ccs_per_ue;
+    for (uint32_t nof_cc_workers : {0, 1, 3}) {
+      run_param_list.nof_cc_workers = nof_cc_workers;
+      for (size_t r = 0; r < run_param_list.nof_runs(); ++r) {
+        run_params runparams = run_param_list.get_params(r);
+
+        mac_logger.info("\n### New run {} ###\n", run_results.size());
+        TESTASSERT(run_benchmark_scenario(runparams, run_results) == SRSRAN_SUCCESS);
+      }
+    }
+  }
+
+  print_benchmark_results(run_results);
+
+  return SRSRAN_SUCCESS;
+}
+
 } // namespace srsenb
 
 int main(int argc, char* argv[])
@@ -424,6 +502,8 @@ int main(int argc, char* argv[])
     TESTASSERT(srsenb::run_rate_test() == SRSRAN_SUCCESS);
   } else if (strcmp(argv[1], "benchmark") == 0) {
     TESTASSERT(srsenb::run_benchmark() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "cc_benchmark") == 0) {
+    TESTASSERT(srsenb::run_cc_benchmark() == SRSRAN_SUCCESS);
   } else {
     TESTASSERT(srsenb::run_all() == SRSRAN_SUCCESS);
   }
@@ -56,6 +56,14 @@ private:
  *      Scheduler Tests
  *****************************/
 
+/// Exposes the split of the carriers among the CC workers
+class ca_sched_tester : public common_sched_tester
+{
+public:
+  using sched::cc_mask_t;
+  using sched::get_cc_groups;
+};
+
 sim_sched_args generate_default_sim_args(uint32_t nof_prb, uint32_t nof_ccs)
 {
   sim_sched_args sim_args;
@@ -84,7 +92,8 @@ sim_sched_args generate_default_sim_args(uint32_t nof_prb, uint32_t nof_ccs)
 }
 
 struct test_scell_activation_params {
-  uint32_t pcell_idx = 0;
+  uint32_t pcell_idx      = 0;
+  uint32_t nof_cc_workers = 0;
 };
 
 int test_scell_activation(uint32_t sim_number, test_scell_activation_params params)
@@ -118,11 +127,12 @@ int test_scell_activation(uint32_t sim_number, test_scell_activation_params para
   sim_args.default_ue_sim_cfg.ue_cfg.supported_cc_list[0].enb_cc_idx                            = cc_idxs[0];
   sim_args.default_ue_sim_cfg.ue_cfg.supported_cc_list[0].dl_cfg.cqi_report.periodic_configured = true;
   sim_args.default_ue_sim_cfg.ue_cfg.supported_cc_list[0].dl_cfg.cqi_report.pmi_idx             = 37;
+  sim_args.sched_args.nof_cc_workers                                                            = params.nof_cc_workers;
 
   /* Simulation Objects Setup */
   sched_sim_event_generator generator;
   // Setup scheduler
-  common_sched_tester tester;
+  ca_sched_tester tester;
   tester.sim_cfg(sim_args);
 
   /* Simulation */
@@ -182,6 +192,14 @@ int test_scell_activation(uint32_t sim_number, test_scell_activation_params para
   for (uint32_t i = 0; i < cc_idxs.size(); ++i) {
     TESTASSERT(activ_list[i] >= 0);
   }
+  if (params.nof_cc_workers > 0) {
+    // The carriers of the CA UE get their grants allocated by different threads
+    ca_sched_tester::cc_mask_t cc_mask;
+    for (uint32_t i = 0; i < nof_ccs; ++i) {
+      cc_mask.set(i);
+    }
+    TESTASSERT(tester.get_cc_groups(cc_mask).size() == nof_ccs);
+  }
 
   // TEST: When a DL newtx takes place, it should also encode the CE
   for (uint32_t i = 0; i < 100; ++i) {
@@ -235,6 +253,17 @@ int test_scell_activation(uint32_t sim_number, test_scell_activation_params para
 
   TESTASSERT(tot_dl_sched_data > 0);
   TESTASSERT(tot_ul_sched_data > 0);
+  if (params.nof_cc_workers > 0) {
+    // The DL data of the UE is merged from the grants of all its carriers
+    for (const auto& c : cc_idxs) {
+      TESTASSERT(tester.sched_stats->users[rnti1].tot_dl_sched_data[c] > 0);
+    }
+
+    // Event: Small buffers, which the carriers allocate in parallel without seeing the grants of each other. The grants
+    // left without data are dropped when the carrier results are generated
+    generate_data(50, P_dl, P_ul_sr, 0);
+    TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+  }
 
   srslog::flush();
   printf("[TESTER] Sim%d finished successfully\n\n", sim_number);
@@ -282,6 +311,16 @@ int main()
     TESTASSERT(test_scell_activation(n * 2 + 1, p) == SRSRAN_SUCCESS);
   }
 
+  // Carriers scheduled in parallel until the SCell gets configured
+  for (uint32_t n = 0; n < N_runs; ++n) {
+    printf("[TESTER] Sim run number with CC workers: %u\n", n);
+
+    test_scell_activation_params p = {};
+    p.pcell_idx                    = n % 2;
+    p.nof_cc_workers               = 1;
+    TESTASSERT(test_scell_activation(N_runs * 2 + n, p) == SRSRAN_SUCCESS);
+  }
+
   srslog::flush();
 
   return 0;
@@ -0,0 +1,258 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Throughput of the PHY UE database accesses done by the workers for every UE and TTI, while the stack keeps
+ * reconfiguring UEs in the background.
+ */
+
+#include "srsenb/hdr/common/common_enb.h"
+#include "srsenb/hdr/phy/phy_ue_db.h"
+#include "srsran/common/string_helpers.h"
+#include <atomic>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace bpo = boost::program_options;
+
+struct bench_args_t {
+  std::string nof_workers_str  = "1,2,4,8";
+  std::string nof_ues_str      = "8,32,64";
+  uint32_t    nof_cells        = 2;
+  uint32_t    duration_ms      = 500;
+  uint32_t    reconf_period_us = 1000;
+};
+
+static const uint16_t first_rnti = 0x46;
+
+static srsran::phy_cfg_t get_ue_phy_cfg(uint16_t rnti)
+{
+  srsran::phy_cfg_t phy_cfg = {};
+
+  // Periodic CQI and SR, so that the UCI configuration is computed for some TTIs
+  phy_cfg.dl_cfg.cqi_report.periodic_configured = true;
+  phy_cfg.dl_cfg.cqi_report.pmi_idx             = 25 + rnti % 10;
+  phy_cfg.ul_cfg.pucch.sr_configured            = true;
+  phy_cfg.ul_cfg.pucch.I_sr                     = 15 + rnti % 10;
+  phy_cfg.ul_cfg.pucch.n_pucch_sr               = rnti % 16;
+  return phy_cfg;
+}
+
+static srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t get_ue_cfg(uint16_t rnti, uint32_t nof_cells, bool scell)
+{
+  srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t cfg_list(scell ? nof_cells : 1);
+  for (uint32_t ue_cc_idx = 0; ue_cc_idx < cfg_list.size(); ue_cc_idx++) {
+    cfg_list[ue_cc_idx].configured = true;
+    cfg_list[ue_cc_idx].enb_cc_idx = (rnti + ue_cc_idx) % nof_cells;
+    cfg_list[ue_cc_idx].phy_cfg    = get_ue_phy_cfg(rnti);
+  }
+  return cfg_list;
+}
+
+/// Worker function, it processes the TTIs worker_idx, worker_idx + nof_workers, ... as the PHY workers do
+static void run_worker(srsenb::phy_ue_db&       ue_db,
+                       uint32_t                 worker_idx,
+                       uint32_t                 nof_workers,
+                       uint32_t                 nof_ues,
+                       uint32_t                 nof_cells,
+                       const std::atomic<bool>& running,
+                       std::atomic<uint64_t>&   nof_accesses)
+{
+  srsenb::stack_interface_phy_lte::ul_sched_list_t ul_sched_list(nof_cells);
+  uint64_t                                         count = 0;
+
+  for (uint32_t tti = worker_idx; running.load(std::memory_order_relaxed); tti += nof_workers) {
+    uint32_t tti_mod = TTIMOD(tti);
+
+    // UL grants for half of the UEs in every cell
+    for (uint32_t enb_cc_idx = 0; enb_cc_idx < nof_cells; enb_cc_idx++) {
+      srsenb::stack_interface_phy_lte::ul_sched_t& ul_sched = ul_sched_list[enb_cc_idx];
+      ul_sched.nof_grants                                   = 0;
+      for (uint32_t i = (tti + enb_cc_idx) % 2; i < nof_ues; i += 2) {
+        ul_sched.pusch[ul_sched.nof_grants++].dci.rnti = first_rnti + i;
+      }
+    }
+    ue_db.set_ul_grant_available(tti_mod, ul_sched_list);
+    ue_db.clear_tti_pending_ack(tti_mod);
+    count += 2;
+
+    for (uint32_t i = 0; i < nof_ues; i++) {
+      uint16_t rnti = first_rnti + i;
+      for (uint32_t enb_cc_idx = 0; enb_cc_idx < nof_cells; enb_cc_idx++) {
+        // DL processing
+        srsran_dl_cfg_t  dl_cfg;
+        srsran_dci_cfg_t dci_cfg;
+        srsran_dci_dl_t  dci = {};
+        dci.rnti             = rnti;
+        dci.format           = SRSRAN_DCI_FORMAT1;
+        dci.tb[0].mcs_idx    = 10;
+        ue_db.get_dci_dl_config(rnti, enb_cc_idx, dci_cfg);
+        ue_db.get_dl_config(rnti, enb_cc_idx, dl_cfg);
+        ue_db.set_ack_pending(tti_mod, enb_cc_idx, dci);
+
+        // UL processing
+        srsran_ul_cfg_t  ul_cfg;
+        srsran_uci_cfg_t uci_cfg;
+        srsran_ra_tb_t   tb = {};
+        ue_db.get_dci_ul_config(rnti, enb_cc_idx, dci_cfg);
+        ue_db.get_ul_config(rnti, enb_cc_idx, ul_cfg);
+        ue_db.fill_uci_cfg(tti_mod, enb_cc_idx, rnti, false, ue_db.is_pcell(rnti, enb_cc_idx), uci_cfg);
+        ue_db.get_last_ul_tb(rnti, enb_cc_idx, tti % SRSRAN_MAX_HARQ_PROC, tb);
+        ue_db.set_last_ul_tb(rnti, enb_cc_idx, tti % SRSRAN_MAX_HARQ_PROC, tb);
+        count += 9;
+      }
+    }
+  }
+
+  nof_accesses.fetch_add(count, std::memory_order_relaxed);
+}
+
+static void run_benchmark(const bench_args_t& args, uint32_t nof_workers, uint32_t nof_ues)
+{
+  srsenb::phy_args_t          phy_args = {};
+  srsenb::phy_cell_cfg_list_t cell_list(args.nof_cells);
+  for (uint32_t enb_cc_idx = 0; enb_cc_idx < args.nof_cells; enb_cc_idx++) {
+    srsenb::phy_cell_cfg_t& cell_cfg = cell_list[enb_cc_idx];
+    cell_cfg                         = {};
+    cell_cfg.cell.nof_prb            = 25;
+    cell_cfg.cell.nof_ports          = 1;
+    cell_cfg.cell.id                 = enb_cc_idx;
+    cell_cfg.cell.cp                 = SRSRAN_CP_NORM;
+    cell_cfg.cell.frame_type         = SRSRAN_FDD;
+  }
+
+  std::unique_ptr<srsenb::phy_ue_db> ue_db(new srsenb::phy_ue_db);
+  ue_db->init(nullptr, phy_args, cell_list);
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    uint16_t rnti = first_rnti + i;
+    ue_db->addmod_rnti(rnti, get_ue_cfg(rnti, args.nof_cells, true));
+    ue_db->complete_config(rnti);
+    for (uint32_t ue_cc_idx = 1; ue_cc_idx < args.nof_cells; ue_cc_idx++) {
+      ue_db->activate_deactivate_scell(rnti, ue_cc_idx, true);
+    }
+  }
+
+  std::atomic<bool>     running(true);
+  std::atomic<uint64_t> nof_accesses(0);
+  uint64_t              nof_reconfs = 0;
+
+  std::vector<std::thread> workers;
+  auto                     t_start = std::chrono::steady_clock::now();
+  for (uint32_t w = 0; w < nof_workers; w++) {
+    workers.emplace_back(run_worker,
+                         std::ref(*ue_db),
+                         w,
+                         nof_workers,
+                         nof_ues,
+                         args.nof_cells,
+                         std::cref(running),
+                         std::ref(nof_accesses));
+  }
+
+  // The calling thread acts as the stack, reconfiguring UEs and toggling their SCells
+  auto t_end = t_start + std::chrono::milliseconds(args.duration_ms);
+  while (std::chrono::steady_clock::now() < t_end) {
+    uint16_t rnti  = first_rnti + nof_reconfs % nof_ues;
+    bool     scell = (nof_reconfs / nof_ues) % 2 == 0;
+    ue_db->addmod_rnti(rnti, get_ue_cfg(rnti, args.nof_cells, scell));
+    ue_db->complete_config(rnti);
+    for (uint32_t ue_cc_idx = 1; scell and ue_cc_idx < args.nof_cells; ue_cc_idx++) {
+      ue_db->activate_deactivate_scell(rnti, ue_cc_idx, true);
+    }
+    nof_reconfs++;
+    if (args.reconf_period_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(args.reconf_period_us));
+    }
+  }
+
+  running = false;
+  for (std::thread& w : workers) {
+    w.join();
+  }
+  double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+  printf("workers=%2d, ues=%2d, cells=%d: %7.2f M accesses/s, %6.1f ns/access, %ld reconfigurations\n",
+         nof_workers,
+         nof_ues,
+         args.nof_cells,
+         nof_accesses / elapsed_s / 1e6,
+         elapsed_s * nof_workers * 1e9 / std::max(nof_accesses.load(), (uint64_t)1),
+         (long)nof_reconfs);
+}
+
+static int parse_args(int argc, char** argv, bench_args_t& args)
+{
+  bpo::options_description options("PHY UE database benchmark options");
+
+  // clang-format off
+  options.add_options()
+      ("workers",   bpo::value<std::string>(&args.nof_workers_str)->default_value(args.nof_workers_str), "Comma separated list of number of worker threads")
+      ("ues",       bpo::value<std::string>(&args.nof_ues_str)->default_value(args.nof_ues_str),         "Comma separated list of number of UEs")
+      ("cells",     bpo::value<uint32_t>(&args.nof_cells)->default_value(args.nof_cells),                "Number of eNb cells/carriers, all of them configured in every UE")
+      ("duration",  bpo::value<uint32_t>(&args.duration_ms)->default_value(args.duration_ms),            "Duration of each run in milliseconds")
+      ("reconf_us", bpo::value<uint32_t>(&args.reconf_period_us)->default_value(args.reconf_period_us),  "Period of the UE reconfigurations in microseconds")
+      ("help", "Show this message");
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << e.what() << std::endl;
+    return SRSRAN_ERROR;
+  }
+
+  if (vm.count("help") or args.nof_cells == 0 or args.nof_cells > SRSRAN_MAX_CARRIERS) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << std::endl << options << std::endl;
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  bench_args_t args;
+  if (parse_args(argc, argv, args) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  std::vector<uint32_t> nof_workers_list;
+  std::vector<uint32_t> nof_ues_list;
+  srsran::string_parse_list(args.nof_workers_str, ',', nof_workers_list);
+  srsran::string_parse_list(args.nof_ues_str, ',', nof_ues_list);
+
+  srslog::init();
+
+  for (uint32_t nof_ues : nof_ues_list) {
+    if (nof_ues == 0 or nof_ues > SRSENB_MAX_UES) {
+      fprintf(stderr, "Invalid number of UEs %d, it must be between 1 and %d\n", nof_ues, SRSENB_MAX_UES);
+      return SRSRAN_ERROR;
+    }
+    for (uint32_t nof_workers : nof_workers_list) {
+      run_benchmark(args, nof_workers, nof_ues);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
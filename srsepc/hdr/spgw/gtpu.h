@@ -29,29 +29,36 @@
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
+#include <memory>
+#include <pthread.h>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 namespace srsepc {
 
+/// Maximum number of packets read from SGi or S1-U and forwarded with a single system call by a user-plane thread
+const uint32_t SPGW_UP_MAX_BATCH = 32;
+
 class spgw::gtpu : public gtpu_interface_gtpc
 {
+  class up_thread;
+
 public:
   gtpu();
   virtual ~gtpu();
   int  init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc);
+  int  start_up_threads();
   void stop();
 
   int init_sgi(spgw_args_t* args);
   int init_s1u(spgw_args_t* args);
-  int get_sgi();
-  int get_s1u();
 
-  void handle_sgi_pdu(srsran::unique_byte_buffer_t msg);
-  void handle_s1u_pdu(srsran::byte_buffer_t* msg);
   void send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg);
 
   virtual in_addr_t get_s1u_addr();
 
+  virtual bool add_gtpu_ul_tunnel(in_addr_t ue_ipv4, uint32_t up_user_teid);
   virtual bool modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtp_fteid_t dw_user_fteid, uint32_t up_ctr_fteid);
   virtual bool delete_gtpu_tunnel(in_addr_t ue_ipv4);
   virtual bool delete_gtpc_tunnel(in_addr_t ue_ipv4);
@@ -61,30 +68,34 @@ public:
   spgw*                m_spgw;
   gtpc_interface_gtpu* m_gtpc;
 
-  bool m_sgi_up;
-  int  m_sgi;
+  // One TUN queue and one S1-U socket per user-plane thread
+  bool             m_sgi_up;
+  std::vector<int> m_sgi;
 
-  bool        m_s1u_up;
-  int         m_s1u;
-  sockaddr_in m_s1u_addr;
+  bool             m_s1u_up;
+  std::vector<int> m_s1u;
+  sockaddr_in      m_s1u_addr;
 
-  std::map<in_addr_t, srsran::gtp_fteid_t> m_ip_to_usr_teid; // Map IP to User-plane TEID for downlink traffic
-  std::map<in_addr_t, uint32_t>            m_ip_to_ctr_teid; // IP to control TEID map. Important to check if
-                                                             // UE is attached without an active user-plane
-                                                             // for downlink notifications.
+  std::vector<std::unique_ptr<up_thread> > m_up_threads;
 
-  srslog::basic_logger& m_logger = srslog::fetch_basic_logger("GTPU");
-};
+private:
+  // Tunnel state of a UE, looked up by the user-plane threads for every packet
+  struct ue_tunnel_t {
+    bool                usr_present  = false; // Downlink user-plane tunnel towards the eNB is active
+    srsran::gtp_fteid_t dw_user_fteid = {};
+    bool                ctr_present  = false; // UE is attached, even if not ECM connected
+    uint32_t            up_ctrl_teid = 0;
+    uint32_t            up_user_teid = 0;
+  };
 
-inline int spgw::gtpu::get_sgi()
-{
-  return m_sgi;
-}
+  // The tables are written by the S11 thread and read by the user-plane threads. The UE IP to tunnel map is used for
+  // downlink traffic and to check if the UE is attached without an active user-plane for downlink notifications.
+  pthread_rwlock_t                           m_tunnel_rwlock = {};
+  std::unordered_map<in_addr_t, ue_tunnel_t> m_ip_to_tunnel;
+  std::unordered_map<uint32_t, in_addr_t>    m_ul_teid_to_ip; // Uplink user-plane TEID to UE IP
 
-inline int spgw::gtpu::get_s1u()
-{
-  return m_s1u;
-}
+  srslog::basic_logger& m_logger = srslog::fetch_basic_logger("GTPU");
+};
 
 inline in_addr_t spgw::gtpu::get_s1u_addr()
 {
@@ -33,6 +33,7 @@
 #include "srsran/common/threads.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
+#include <mutex>
 #include <queue>
 
 namespace srsepc {
@@ -46,6 +47,7 @@ typedef struct {
   std::string sgi_if_addr;
   std::string sgi_if_name;
   uint32_t    max_paging_queue;
+  uint32_t    nof_up_threads;
 } spgw_args_t;
 
 typedef struct spgw_tunnel_ctx {
@@ -83,6 +85,9 @@ private:
   bool      m_running;
   mme_gtpc* m_mme_gtpc;
 
+  // Serializes the GTP-C state between the S11 thread and the paging triggers of the user-plane threads
+  std::mutex m_ctrl_mutex;
+
   // GTP-C and GTP-U handlers
   gtpc* m_gtpc;
   gtpu* m_gtpu;
@@ -87,6 +87,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   string   integrity_algo;
   uint16_t paging_timer     = 0;
   uint32_t max_paging_queue = 0;
+  uint32_t nof_up_threads   = 0;
   string   spgw_bind_addr;
   string   sgi_if_addr;
   string   sgi_if_name;
@@ -131,6 +132,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
     ("spgw.sgi_if_name",    bpo::value<string>(&sgi_if_name)->default_value("srs_spgw_sgi"), "Name of TUN interface for the SGi connection")
     ("spgw.max_paging_queue", bpo::value<uint32_t>(&max_paging_queue)->default_value(100), "Max number of packets in paging queue")
+    ("spgw.nof_up_threads",   bpo::value<uint32_t>(&nof_up_threads)->default_value(1),     "Number of user-plane threads, each with its own SGi TUN queue and S1-U socket")
 
     ("pcap.enable",   bpo::value<bool>(&args->mme_args.s1ap_args.pcap_enable)->default_value(false),         "Enable S1AP PCAP")
     ("pcap.filename", bpo::value<string>(&args->mme_args.s1ap_args.pcap_filename)->default_value("/tmp/epc.pcap"), "PCAP filename")
@@ -295,6 +297,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   args->spgw_args.sgi_if_addr             = sgi_if_addr;
   args->spgw_args.sgi_if_name             = sgi_if_name;
   args->spgw_args.max_paging_queue        = max_paging_queue;
+  args->spgw_args.nof_up_threads          = nof_up_threads;
   args->hss_args.db_file                  = hss_db_file;
 
   // Apply all_level to any unset layers
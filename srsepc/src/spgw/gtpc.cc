@@ -41,7 +41,7 @@ namespace srsepc {
  * comminication with the MME
  *
  **********************************************/
-spgw::gtpc::gtpc() : m_h_next_ue_ip(0), m_next_ctrl_teid(1), m_next_user_teid(1), m_max_paging_queue(0)
+spgw::gtpc::gtpc() : m_s11(-1), m_h_next_ue_ip(0), m_next_ctrl_teid(1), m_next_user_teid(1), m_max_paging_queue(0)
 {
   return;
 }
@@ -93,6 +93,12 @@ void spgw::gtpc::stop()
     delete it->second;
     m_teid_to_tunnel_ctx.erase(it++);
   }
+
+  // Release the S11 address, so that the SP-GW can be initialized again
+  if (m_s11 >= 0) {
+    close(m_s11);
+    m_s11 = -1;
+  }
   return;
 }
 
@@ -466,6 +472,9 @@ spgw_tunnel_ctx_t* spgw::gtpc::create_gtpc_ctx(const struct srsran::gtpc_create_
 
   m_teid_to_tunnel_ctx.insert(std::pair<uint32_t, spgw_tunnel_ctx_t*>(spgw_uplink_ctrl_teid, tunnel_ctx));
   m_imsi_to_ctr_teid.insert(std::pair<uint64_t, uint32_t>(cs_req.imsi, spgw_uplink_ctrl_teid));
+
+  // Uplink user-plane traffic is accepted as soon as the eNB learns the S-GW TEID, before the Modify Bearer Request
+  m_gtpu->add_gtpu_ul_tunnel(ue_ip, spgw_uplink_user_teid);
   return tunnel_ctx;
 }
 
@@ -21,22 +21,366 @@
 
 #include "srsepc/hdr/spgw/gtpu.h"
 #include "srsepc/hdr/mme/mme_gtpc.h"
-#include "srsran/common/string_helpers.h"
 #include "srsran/common/network_utils.h"
+#include "srsran/common/rwlock_guard.h"
+#include "srsran/common/string_helpers.h"
 #include "srsran/upper/gtpu.h"
 #include <algorithm>
 #include <arpa/inet.h>
+#include <array>
+#include <atomic>
 #include <fcntl.h>
 #include <inttypes.h> // for printing uint64_t
+#include <linux/filter.h>
 #include <linux/if.h>
 #include <linux/if_tun.h>
 #include <linux/ip.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 
 namespace srsepc {
 
+static void close_fds(std::vector<int>& fds)
+{
+  for (int fd : fds) {
+    close(fd);
+  }
+  fds.clear();
+}
+
+/**************************************
+ *
+ * User-plane thread. Serves one TUN
+ * queue and one S1-U socket, moving
+ * packets in batches in both directions
+ *
+ **************************************/
+
+class spgw::gtpu::up_thread final : public srsran::thread
+{
+public:
+  up_thread(gtpu* parent_, uint32_t id_, int sgi_, int s1u_);
+  ~up_thread();
+
+  int  init();
+  void stop();
+
+private:
+  void run_thread() override;
+  void handle_sgi_batch();
+  void handle_s1u_batch();
+
+  gtpu*                 parent;
+  srslog::basic_logger& logger;
+  uint32_t              id;
+  int                   sgi;
+  int                   s1u;
+  int                   stop_fd = -1;
+  std::atomic<bool>     running = {false};
+
+  uint64_t nof_ul_pdus           = 0;
+  uint64_t nof_dl_pdus           = 0;
+  uint64_t nof_unknown_teid_pdus = 0;
+
+  std::array<srsran::unique_byte_buffer_t, SPGW_UP_MAX_BATCH> sgi_pdus;
+  std::array<srsran::unique_byte_buffer_t, SPGW_UP_MAX_BATCH> s1u_pdus;
+  std::array<mmsghdr, SPGW_UP_MAX_BATCH>                      msgs  = {};
+  std::array<iovec, SPGW_UP_MAX_BATCH>                        iovs  = {};
+  std::array<sockaddr_in, SPGW_UP_MAX_BATCH>                  addrs = {};
+};
+
+spgw::gtpu::up_thread::up_thread(gtpu* parent_, uint32_t id_, int sgi_, int s1u_) :
+  thread("SPGW_UP" + std::to_string(id_)), parent(parent_), logger(parent_->m_logger), id(id_), sgi(sgi_), s1u(s1u_)
+{}
+
+spgw::gtpu::up_thread::~up_thread()
+{
+  stop();
+  if (stop_fd >= 0) {
+    close(stop_fd);
+  }
+}
+
+int spgw::gtpu::up_thread::init()
+{
+  stop_fd = eventfd(0, EFD_NONBLOCK);
+  if (stop_fd < 0) {
+    logger.error("Failed to create user-plane thread eventfd: %s", strerror(errno));
+    return SRSRAN_ERROR;
+  }
+  running = true;
+  return SRSRAN_SUCCESS;
+}
+
+void spgw::gtpu::up_thread::stop()
+{
+  if (running.exchange(false)) {
+    uint64_t one = 1;
+    if (write(stop_fd, &one, sizeof(one)) != sizeof(one)) {
+      logger.error("Failed to wake up user-plane thread %d", id);
+    }
+    wait_thread_finish();
+    logger.info("User-plane thread %d stopped. UL PDUs %" PRIu64 ", DL PDUs %" PRIu64 ", unknown TEID PDUs %" PRIu64,
+                id,
+                nof_ul_pdus,
+                nof_dl_pdus,
+                nof_unknown_teid_pdus);
+  }
+}
+
+void spgw::gtpu::up_thread::run_thread()
+{
+  struct pollfd fds[3] = {};
+  fds[0].fd            = stop_fd;
+  fds[0].events        = POLLIN;
+  fds[1].fd            = sgi;
+  fds[1].events        = POLLIN;
+  fds[2].fd            = s1u;
+  fds[2].events        = POLLIN;
+
+  while (running) {
+    int n = poll(fds, 3, -1);
+    if (n < 0) {
+      if (errno != EINTR) {
+        logger.error("Error from poll: %s", strerror(errno));
+      }
+      continue;
+    }
+    if (fds[0].revents & POLLIN) {
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      handle_sgi_batch();
+    }
+    if (fds[2].revents & POLLIN) {
+      handle_s1u_batch();
+    }
+  }
+}
+
+void spgw::gtpu::up_thread::handle_sgi_batch()
+{
+  size_t buf_len = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
+
+  // TUN devices have no batched read, so the queue is drained packet by packet. The tunnel lookup and the
+  // transmission towards the eNBs are then done once for the whole batch.
+  uint32_t nof_pdus = 0;
+  for (; nof_pdus < SPGW_UP_MAX_BATCH; ++nof_pdus) {
+    srsran::unique_byte_buffer_t& msg = sgi_pdus[nof_pdus];
+    if (msg == nullptr) {
+      /*
+       * SGi messages may need to be queued when waiting for UE Paging procedure.
+       * For this reason, buffers for SGi pdus are owned by this thread and reused across batches, unless they are
+       * handed over to gtpc::queue_downlink_packet(). They are deallocated at gtpu::send_all_queued_packets() when
+       * the PDU is sent, or at gtpc::free_all_queued_packets, which is called when the Downlink Data Notification
+       * procedure fails (see handle_downlink_data_notification_acknowledgment and
+       * handle_downlink_data_notification_failure)
+       */
+      msg = srsran::make_byte_buffer("spgw::up_thread::sgi_msg");
+      if (msg == nullptr) {
+        logger.warning("Could not allocate SGi PDU");
+        break;
+      }
+    } else {
+      msg->clear();
+    }
+    ssize_t n = read(sgi, msg->msg, buf_len);
+    if (n <= 0) {
+      if (n < 0 and errno != EAGAIN and errno != EWOULDBLOCK) {
+        logger.error("Error reading from SGi: %s", strerror(errno));
+      }
+      break;
+    }
+    msg->N_bytes = n;
+  }
+  if (nof_pdus == 0) {
+    return;
+  }
+  logger.debug("Received %d SGi PDUs", nof_pdus);
+
+  uint32_t                                nof_tx     = 0;
+  uint32_t                                nof_paging = 0;
+  std::array<uint32_t, SPGW_UP_MAX_BATCH> paging_idx;
+  std::array<uint32_t, SPGW_UP_MAX_BATCH> paging_teid;
+  {
+    srsran::rwlock_read_guard lock(parent->m_tunnel_rwlock);
+    for (uint32_t i = 0; i < nof_pdus; ++i) {
+      srsran::byte_buffer_t* msg = sgi_pdus[i].get();
+      struct iphdr*          iph = (struct iphdr*)msg->msg;
+
+      if (iph->version != 4) {
+        logger.info("IPv6 not supported yet.");
+        continue;
+      }
+      if (ntohs(iph->tot_len) < 20) {
+        logger.warning("Invalid IP header length. IP length %d.", ntohs(iph->tot_len));
+        continue;
+      }
+
+      // Logging PDU info
+      if (logger.debug.enabled()) {
+        logger.debug("SGi PDU -- IP version %d, Total length %d", int(iph->version), ntohs(iph->tot_len));
+        fmt::memory_buffer buffer;
+        srsran::gtpu_ntoa(buffer, iph->saddr);
+        logger.debug("SGi PDU -- IP src addr %s", srsran::to_c_str(buffer));
+        buffer.clear();
+        srsran::gtpu_ntoa(buffer, iph->daddr);
+        logger.debug("SGi PDU -- IP dst addr %s", srsran::to_c_str(buffer));
+      }
+
+      // Find user and control tunnel
+      auto tunnel_it = parent->m_ip_to_tunnel.find(iph->daddr);
+      bool usr_found = tunnel_it != parent->m_ip_to_tunnel.end() and tunnel_it->second.usr_present;
+      bool ctr_found = tunnel_it != parent->m_ip_to_tunnel.end() and tunnel_it->second.ctr_present;
+
+      // Handle SGi packet
+      if (usr_found == false && ctr_found == false) {
+        logger.debug("Packet for unknown UE.");
+      } else if (usr_found == false && ctr_found == true) {
+        // The GTP-C state is not protected by the tunnel lock, the paging is triggered once the lock is released
+        paging_idx[nof_paging]  = i;
+        paging_teid[nof_paging] = tunnel_it->second.up_ctrl_teid;
+        nof_paging++;
+      } else if (usr_found == true && ctr_found == false) {
+        logger.error("User plane tunnel found without a control plane tunnel present.");
+      } else {
+        const srsran::gtp_fteid_t& enb_fteid = tunnel_it->second.dw_user_fteid;
+
+        // Setup GTP-U header
+        srsran::gtpu_header_t header;
+        header.flags        = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+        header.message_type = GTPU_MSG_DATA_PDU;
+        header.length       = msg->N_bytes;
+        header.teid         = enb_fteid.teid;
+        if (!srsran::gtpu_write_header(&header, msg, logger)) {
+          logger.error("Error writing GTP-U header on PDU");
+          continue;
+        }
+
+        // Set eNB destination address
+        addrs[nof_tx].sin_family         = AF_INET;
+        addrs[nof_tx].sin_port           = htons(GTPU_RX_PORT);
+        addrs[nof_tx].sin_addr.s_addr    = enb_fteid.ipv4;
+        iovs[nof_tx].iov_base            = msg->msg;
+        iovs[nof_tx].iov_len             = msg->N_bytes;
+        msgs[nof_tx].msg_hdr             = {};
+        msgs[nof_tx].msg_hdr.msg_name    = &addrs[nof_tx];
+        msgs[nof_tx].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[nof_tx].msg_hdr.msg_iov     = &iovs[nof_tx];
+        msgs[nof_tx].msg_hdr.msg_iovlen  = 1;
+        nof_tx++;
+      }
+    }
+  }
+
+  // Send the whole batch to the eNBs with a single system call, if the socket buffer allows it
+  uint32_t nof_sent = 0;
+  while (nof_sent < nof_tx) {
+    int n = sendmmsg(s1u, &msgs[nof_sent], nof_tx - nof_sent, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger.error("Error sending packets to eNB: %s", strerror(errno));
+      break;
+    }
+    nof_sent += n;
+  }
+  nof_dl_pdus += nof_sent;
+
+  if (nof_paging > 0) {
+    std::lock_guard<std::mutex> lock(parent->m_spgw->m_ctrl_mutex);
+    for (uint32_t i = 0; i < nof_paging; ++i) {
+      logger.debug("Packet for attached UE that is not ECM connected.");
+      logger.debug("Triggering Donwlink Notification Requset.");
+      parent->m_gtpc->send_downlink_data_notification(paging_teid[i]);
+      parent->m_gtpc->queue_downlink_packet(paging_teid[i], std::move(sgi_pdus[paging_idx[i]]));
+    }
+  }
+}
+
+void spgw::gtpu::up_thread::handle_s1u_batch()
+{
+  size_t buf_len = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
+
+  uint32_t nof_bufs = 0;
+  for (; nof_bufs < SPGW_UP_MAX_BATCH; ++nof_bufs) {
+    srsran::unique_byte_buffer_t& msg = s1u_pdus[nof_bufs];
+    if (msg == nullptr) {
+      msg = srsran::make_byte_buffer("spgw::up_thread::s1u_msg");
+      if (msg == nullptr) {
+        logger.warning("Could not allocate S1-U PDU");
+        break;
+      }
+    } else {
+      msg->clear();
+    }
+    iovs[nof_bufs].iov_base            = msg->msg;
+    iovs[nof_bufs].iov_len             = buf_len;
+    msgs[nof_bufs].msg_hdr             = {};
+    msgs[nof_bufs].msg_hdr.msg_name    = &addrs[nof_bufs];
+    msgs[nof_bufs].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    msgs[nof_bufs].msg_hdr.msg_iov     = &iovs[nof_bufs];
+    msgs[nof_bufs].msg_hdr.msg_iovlen  = 1;
+  }
+  if (nof_bufs == 0) {
+    return;
+  }
+
+  int nof_pdus = recvmmsg(s1u, msgs.data(), nof_bufs, MSG_DONTWAIT, nullptr);
+  if (nof_pdus <= 0) {
+    if (nof_pdus < 0 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+      logger.error("Error reading from S1-U socket: %s", strerror(errno));
+    }
+    return;
+  }
+  logger.debug("Received %d S1-U PDUs", nof_pdus);
+
+  // Strip the GTP-U headers and check the TEIDs, holding the tunnel lock once for the whole batch
+  std::array<bool, SPGW_UP_MAX_BATCH> forward = {};
+  {
+    srsran::rwlock_read_guard lock(parent->m_tunnel_rwlock);
+    for (int i = 0; i < nof_pdus; ++i) {
+      srsran::byte_buffer_t* msg = s1u_pdus[i].get();
+      msg->N_bytes               = msgs[i].msg_len;
+
+      srsran::gtpu_header_t header;
+      if (msg->N_bytes < GTPU_BASE_HEADER_LEN or not srsran::gtpu_read_header(msg, &header, logger)) {
+        continue;
+      }
+      logger.debug("Received PDU from S1-U. Bytes=%d", msg->N_bytes);
+      logger.debug("TEID 0x%x. Bytes=%d", header.teid, msg->N_bytes);
+      if (header.message_type != GTPU_MSG_DATA_PDU) {
+        logger.debug("Ignoring GTP-U message type 0x%x", header.message_type);
+        continue;
+      }
+      if (parent->m_ul_teid_to_ip.count(header.teid) == 0) {
+        logger.error("Dropping S1-U PDU with unknown TEID 0x%x. Bytes=%d", header.teid, msg->N_bytes);
+        nof_unknown_teid_pdus++;
+        continue;
+      }
+      forward[i] = true;
+    }
+  }
+
+  for (int i = 0; i < nof_pdus; ++i) {
+    if (not forward[i]) {
+      continue;
+    }
+    srsran::byte_buffer_t* msg = s1u_pdus[i].get();
+    int                    n   = write(sgi, msg->msg, msg->N_bytes);
+    if (n < 0) {
+      logger.error("Could not write to TUN interface.");
+    } else {
+      logger.debug("Forwarded packet to TUN interface. Bytes= %d/%d", n, msg->N_bytes);
+      nof_ul_pdus++;
+    }
+  }
+}
+
 /**************************************
  *
  * GTP-U class that handles the packet
@@ -46,11 +390,14 @@ namespace srsepc {
 
 spgw::gtpu::gtpu() : m_sgi_up(false), m_s1u_up(false)
 {
+  pthread_rwlock_init(&m_tunnel_rwlock, nullptr);
   return;
 }
 
 spgw::gtpu::~gtpu()
 {
+  m_up_threads.clear();
+  pthread_rwlock_destroy(&m_tunnel_rwlock);
   return;
 }
 
@@ -81,15 +428,44 @@ int spgw::gtpu::init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc)
   return SRSRAN_SUCCESS;
 }
 
+int spgw::gtpu::start_up_threads()
+{
+  if (not m_up_threads.empty()) {
+    return SRSRAN_ERROR_ALREADY_STARTED;
+  }
+  if (not m_sgi_up or not m_s1u_up) {
+    return SRSRAN_ERROR_CANT_START;
+  }
+
+  for (uint32_t i = 0; i < m_sgi.size(); ++i) {
+    std::unique_ptr<up_thread> t(new up_thread(this, i, m_sgi[i], m_s1u[i]));
+    if (t->init() != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR_CANT_START;
+    }
+    t->start();
+    m_up_threads.push_back(std::move(t));
+  }
+  m_logger.info("Started %zd user-plane threads", m_up_threads.size());
+  return SRSRAN_SUCCESS;
+}
+
 void spgw::gtpu::stop()
 {
+  // Stop the user-plane threads before closing their file descriptors
+  for (std::unique_ptr<up_thread>& t : m_up_threads) {
+    t->stop();
+  }
+  m_up_threads.clear();
+
   // Clean up SGi interface
   if (m_sgi_up) {
-    close(m_sgi);
+    close_fds(m_sgi);
+    m_sgi_up = false;
   }
   // Clean up S1-U socket
   if (m_s1u_up) {
-    close(m_s1u);
+    close_fds(m_s1u);
+    m_s1u_up = false;
   }
 }
 
@@ -97,29 +473,37 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
 {
   struct ifreq ifr;
   int          sgi_sock;
+  uint32_t     nof_queues = std::max(args->nof_up_threads, 1U);
 
   if (m_sgi_up) {
     return SRSRAN_ERROR_ALREADY_STARTED;
   }
 
-  // Construct the TUN device
-  m_sgi = open("/dev/net/tun", O_RDWR);
-  m_logger.info("TUN file descriptor = %d", m_sgi);
-  if (m_sgi < 0) {
-    m_logger.error("Failed to open TUN device: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
-  }
-
+  // Construct the TUN device, with one queue per user-plane thread
   memset(&ifr, 0, sizeof(ifr));
   ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+  if (nof_queues > 1) {
+    ifr.ifr_flags |= IFF_MULTI_QUEUE;
+  }
   strncpy(
       ifr.ifr_ifrn.ifrn_name, args->sgi_if_name.c_str(), std::min(args->sgi_if_name.length(), (size_t)(IFNAMSIZ - 1)));
   ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = '\0';
 
-  if (ioctl(m_sgi, TUNSETIFF, &ifr) < 0) {
-    m_logger.error("Failed to set TUN device name: %s", strerror(errno));
-    close(m_sgi);
-    return SRSRAN_ERROR_CANT_START;
+  for (uint32_t i = 0; i < nof_queues; ++i) {
+    int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    m_logger.info("TUN file descriptor = %d", fd);
+    if (fd < 0) {
+      m_logger.error("Failed to open TUN device: %s", strerror(errno));
+      close_fds(m_sgi);
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_sgi.push_back(fd);
+
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+      m_logger.error("Failed to set TUN device name: %s", strerror(errno));
+      close_fds(m_sgi);
+      return SRSRAN_ERROR_CANT_START;
+    }
   }
 
   // Bring up the interface
@@ -127,7 +511,7 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
   if (ioctl(sgi_sock, SIOCGIFFLAGS, &ifr) < 0) {
     m_logger.error("Failed to bring up socket: %s", strerror(errno));
     close(sgi_sock);
-    close(m_sgi);
+    close_fds(m_sgi);
     return SRSRAN_ERROR_CANT_START;
   }
 
@@ -135,7 +519,7 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
   if (ioctl(sgi_sock, SIOCSIFFLAGS, &ifr) < 0) {
     m_logger.error("Failed to set socket flags: %s", strerror(errno));
     close(sgi_sock);
-    close(m_sgi);
+    close_fds(m_sgi);
     return SRSRAN_ERROR_CANT_START;
   }
 
@@ -144,13 +528,15 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
   if (not srsran::net_utils::set_sockaddr(addr, args->sgi_if_addr.c_str(), 0)) {
     m_logger.error("Invalid sgi_if_addr: %s", args->sgi_if_addr.c_str());
     srsran::console("Invalid sgi_if_addr: %s\n", args->sgi_if_addr.c_str());
+    close(sgi_sock);
+    close_fds(m_sgi);
     return SRSRAN_ERROR_CANT_START;
   }
 
   if (ioctl(sgi_sock, SIOCSIFADDR, &ifr) < 0) {
     m_logger.error(
         "Failed to set TUN interface IP. Address: %s, Error: %s", args->sgi_if_addr.c_str(), strerror(errno));
-    close(m_sgi);
+    close_fds(m_sgi);
     close(sgi_sock);
     return SRSRAN_ERROR_CANT_START;
   }
@@ -162,121 +548,78 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
   }
   if (ioctl(sgi_sock, SIOCSIFNETMASK, &ifr) < 0) {
     m_logger.error("Failed to set TUN interface Netmask. Error: %s", strerror(errno));
-    close(m_sgi);
+    close_fds(m_sgi);
     close(sgi_sock);
     return SRSRAN_ERROR_CANT_START;
   }
 
   close(sgi_sock);
   m_sgi_up = true;
-  m_logger.info("Initialized SGi interface");
+  m_logger.info("Initialized SGi interface with %d queues", nof_queues);
   return SRSRAN_SUCCESS;
 }
 
 int spgw::gtpu::init_s1u(spgw_args_t* args)
 {
-  // Open S1-U socket
-  m_s1u = socket(AF_INET, SOCK_DGRAM, 0);
-  if (m_s1u == -1) {
-    m_logger.error("Failed to open socket: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
-  }
-  m_s1u_up = true;
+  uint32_t nof_sockets = std::max(args->nof_up_threads, 1U);
 
-  // Bind the socket
-  m_s1u_addr.sin_family      = AF_INET;
+  // Bind address
+  m_s1u_addr.sin_family = AF_INET;
   if (inet_pton(m_s1u_addr.sin_family, args->gtpu_bind_addr.c_str(), &m_s1u_addr.sin_addr.s_addr) != 1) {
     m_logger.error("Invalid gtpu_bind_addr: %s", args->gtpu_bind_addr.c_str());
     srsran::console("Invalid gtpu_bind_addr: %s\n", args->gtpu_bind_addr.c_str());
     return SRSRAN_ERROR_CANT_START;
   }
-  m_s1u_addr.sin_port        = htons(GTPU_RX_PORT);
+  m_s1u_addr.sin_port = htons(GTPU_RX_PORT);
+
+  // Open one S1-U socket per user-plane thread. With several sockets, they share the port through SO_REUSEPORT
+  for (uint32_t i = 0; i < nof_sockets; ++i) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd == -1) {
+      m_logger.error("Failed to open socket: %s", strerror(errno));
+      close_fds(m_s1u);
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_s1u.push_back(fd);
+
+    int enable = 1;
+    if (nof_sockets > 1 and setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+      m_logger.error("Failed to set SO_REUSEPORT: %s", strerror(errno));
+      close_fds(m_s1u);
+      return SRSRAN_ERROR_CANT_START;
+    }
+
+    // Bind the socket
+    if (bind(fd, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
+      m_logger.error("Failed to bind socket: %s", strerror(errno));
+      close_fds(m_s1u);
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_logger.info("S1-U socket = %d", fd);
+  }
 
-  if (bind(m_s1u, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
-    m_logger.error("Failed to bind socket: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
+  // By default the kernel picks the socket by hashing the source address and port, which sends all the traffic of an
+  // eNB to the same thread. Pick it by TEID instead, so the tunnels of an eNB are spread across the threads. A socket
+  // index is the order in which the socket was bound, and the program runs with the UDP payload at offset 0.
+  if (nof_sockets > 1) {
+    struct sock_filter teid_filter[] = {
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, 4},            // A = TEID, at offset 4 of the GTP-U header
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, nof_sockets}, // A = A % nof_sockets
+        {BPF_RET | BPF_A, 0, 0, 0},                     // Return A as the socket index
+    };
+    struct sock_fprog teid_prog = {sizeof(teid_filter) / sizeof(teid_filter[0]), teid_filter};
+    if (setsockopt(m_s1u[0], SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &teid_prog, sizeof(teid_prog)) < 0) {
+      m_logger.warning("Failed to steer S1-U PDUs by TEID, all the PDUs of an eNB go to one thread: %s",
+                       strerror(errno));
+    }
   }
-  m_logger.info("S1-U socket = %d", m_s1u);
+  m_s1u_up = true;
   m_logger.info("S1-U IP = %s, Port = %d ", inet_ntoa(m_s1u_addr.sin_addr), ntohs(m_s1u_addr.sin_port));
 
   m_logger.info("Initialized S1-U interface");
   return SRSRAN_SUCCESS;
 }
 
-void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
-{
-  bool usr_found = false;
-  bool ctr_found = false;
-
-  std::map<uint32_t, srsran::gtpc_f_teid_ie>::iterator gtpu_fteid_it;
-  std::map<in_addr_t, uint32_t>::iterator              gtpc_teid_it;
-  srsran::gtpc_f_teid_ie                               enb_fteid;
-  uint32_t                                             spgw_teid;
-  struct iphdr*                                        iph = (struct iphdr*)msg->msg;
-  m_logger.debug("Received SGi PDU. Bytes %d", msg->N_bytes);
-
-  if (iph->version != 4) {
-    m_logger.info("IPv6 not supported yet.");
-    return;
-  }
-  if (ntohs(iph->tot_len) < 20) {
-    m_logger.warning("Invalid IP header length. IP length %d.", ntohs(iph->tot_len));
-    return;
-  }
-
-  // Logging PDU info
-  m_logger.debug("SGi PDU -- IP version %d, Total length %d", int(iph->version), ntohs(iph->tot_len));
-  fmt::memory_buffer buffer;
-  srsran::gtpu_ntoa(buffer, iph->saddr);
-  m_logger.debug("SGi PDU -- IP src addr %s", srsran::to_c_str(buffer));
-  buffer.clear();
-  srsran::gtpu_ntoa(buffer, iph->daddr);
-  m_logger.debug("SGi PDU -- IP dst addr %s", srsran::to_c_str(buffer));
-
-  // Find user and control tunnel
-  gtpu_fteid_it = m_ip_to_usr_teid.find(iph->daddr);
-  if (gtpu_fteid_it != m_ip_to_usr_teid.end()) {
-    usr_found = true;
-    enb_fteid = gtpu_fteid_it->second;
-  }
-  gtpc_teid_it = m_ip_to_ctr_teid.find(iph->daddr);
-  if (gtpc_teid_it != m_ip_to_ctr_teid.end()) {
-    ctr_found = true;
-    spgw_teid = gtpc_teid_it->second;
-  }
-
-  // Handle SGi packet
-  if (usr_found == false && ctr_found == false) {
-    m_logger.debug("Packet for unknown UE.");
-  } else if (usr_found == false && ctr_found == true) {
-    m_logger.debug("Packet for attached UE that is not ECM connected.");
-    m_logger.debug("Triggering Donwlink Notification Requset.");
-    m_gtpc->send_downlink_data_notification(spgw_teid);
-    m_gtpc->queue_downlink_packet(spgw_teid, std::move(msg));
-    return;
-  } else if (usr_found == true && ctr_found == false) {
-    m_logger.error("User plane tunnel found without a control plane tunnel present.");
-  } else {
-    send_s1u_pdu(enb_fteid, msg.get());
-  }
-}
-
-void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg)
-{
-  srsran::gtpu_header_t header;
-  srsran::gtpu_read_header(msg, &header, m_logger);
-
-  m_logger.debug("Received PDU from S1-U. Bytes=%d", msg->N_bytes);
-  m_logger.debug("TEID 0x%x. Bytes=%d", header.teid, msg->N_bytes);
-  int n = write(m_sgi, msg->msg, msg->N_bytes);
-  if (n < 0) {
-    m_logger.error("Could not write to TUN interface.");
-  } else {
-    m_logger.debug("Forwarded packet to TUN interface. Bytes= %d/%d", n, msg->N_bytes);
-  }
-  return;
-}
-
 void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg)
 {
   // Set eNB destination address
@@ -303,7 +646,7 @@ void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer
   }
 
   // Send packet to destination
-  n = sendto(m_s1u, msg->msg, msg->N_bytes, 0, (struct sockaddr*)&enb_addr, sizeof(enb_addr));
+  n = sendto(m_s1u[0], msg->msg, msg->N_bytes, 0, (struct sockaddr*)&enb_addr, sizeof(enb_addr));
   if (n < 0) {
     m_logger.error("Error sending packet to eNB");
   } else if ((unsigned int)n != msg->N_bytes) {
@@ -330,6 +673,19 @@ void spgw::gtpu::send_all_queued_packets(srsran::gtp_fteid_t
 /*
  * Tunnel managment
  */
+bool spgw::gtpu::add_gtpu_ul_tunnel(in_addr_t ue_ipv4, uint32_t up_user_teid)
+{
+  m_logger.info("Adding uplink GTP-U Tunnel. S-GW Rx User TEID 0x%x", up_user_teid);
+  srsran::rwlock_write_guard lock(m_tunnel_rwlock);
+  ue_tunnel_t&               tunnel = m_ip_to_tunnel[ue_ipv4];
+  if (tunnel.up_user_teid != 0) {
+    m_ul_teid_to_ip.erase(tunnel.up_user_teid);
+  }
+  tunnel.up_user_teid           = up_user_teid;
+  m_ul_teid_to_ip[up_user_teid] = ue_ipv4;
+  return true;
+}
+
 bool spgw::gtpu::modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtpc_f_teid_ie dw_user_fteid, uint32_t up_ctrl_teid)
 {
   m_logger.info("Modifying GTP-U Tunnel.");
@@ -340,29 +696,49 @@ bool spgw::gtpu::modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtpc_f_teid_ie dw
   srsran::gtpu_ntoa(buffer, dw_user_fteid.ipv4);
   m_logger.info("Downlink eNB addr %s, U-TEID 0x%x", srsran::to_c_str(buffer), dw_user_fteid.teid);
   m_logger.info("Uplink C-TEID: 0x%x", up_ctrl_teid);
-  m_ip_to_usr_teid[ue_ipv4] = dw_user_fteid;
-  m_ip_to_ctr_teid[ue_ipv4] = up_ctrl_teid;
+
+  srsran::rwlock_write_guard lock(m_tunnel_rwlock);
+  ue_tunnel_t&               tunnel = m_ip_to_tunnel[ue_ipv4];
+  tunnel.usr_present                = true;
+  tunnel.dw_user_fteid              = dw_user_fteid;
+  tunnel.ctr_present                = true;
+  tunnel.up_ctrl_teid               = up_ctrl_teid;
   return true;
 }
 
 bool spgw::gtpu::delete_gtpu_tunnel(in_addr_t ue_ipv4)
 {
   // Remove GTP-U connections, if any.
-  if (m_ip_to_usr_teid.count(ue_ipv4)) {
-    m_ip_to_usr_teid.erase(ue_ipv4);
-  } else {
+  srsran::rwlock_write_guard lock(m_tunnel_rwlock);
+  auto                       tunnel_it = m_ip_to_tunnel.find(ue_ipv4);
+  if (tunnel_it == m_ip_to_tunnel.end() or not tunnel_it->second.usr_present) {
     m_logger.error("Could not find GTP-U Tunnel to delete.");
     return false;
   }
+  tunnel_it->second.usr_present = false;
   return true;
 }
 
 bool spgw::gtpu::delete_gtpc_tunnel(in_addr_t ue_ipv4)
 {
-  // Remove Ctrl TEID from IP mapping.
-  if (m_ip_to_ctr_teid.count(ue_ipv4)) {
-    m_ip_to_ctr_teid.erase(ue_ipv4);
-  } else {
+  // Remove Ctrl TEID and uplink User TEID from IP mapping.
+  srsran::rwlock_write_guard lock(m_tunnel_rwlock);
+  auto                       tunnel_it = m_ip_to_tunnel.find(ue_ipv4);
+  if (tunnel_it == m_ip_to_tunnel.end()) {
+    m_logger.error("Could not find GTP-C Tunnel info to delete.");
+    return false;
+  }
+  ue_tunnel_t& tunnel = tunnel_it->second;
+  bool         found  = tunnel.ctr_present;
+  tunnel.ctr_present  = false;
+  if (tunnel.up_user_teid != 0) {
+    m_ul_teid_to_ip.erase(tunnel.up_user_teid);
+    tunnel.up_user_teid = 0;
+  }
+  if (not tunnel.usr_present) {
+    m_ip_to_tunnel.erase(tunnel_it);
+  }
+  if (not found) {
     m_logger.error("Could not find GTP-C Tunnel info to delete.");
     return false;
   }
@@ -103,65 +103,37 @@ void spgw::run_thread()
 {
   // Mark the thread as running
   m_running = true;
-  srsran::unique_byte_buffer_t sgi_msg, s1u_msg, s11_msg;
-  s1u_msg = srsran::make_byte_buffer("spgw::run_thread::s1u");
+  srsran::unique_byte_buffer_t s11_msg;
   s11_msg = srsran::make_byte_buffer("spgw::run_thread::s11");
 
-  struct sockaddr_in src_addr_in;
   struct sockaddr_un src_addr_un;
-  struct iphdr*      ip_pkt;
 
-  int sgi = m_gtpu->get_sgi();
-  int s1u = m_gtpu->get_s1u();
+  // SGi and S1-U are served by the GTP-U user-plane threads, this thread only handles the S11 control path
+  if (m_gtpu->start_up_threads() != SRSRAN_SUCCESS) {
+    m_logger.error("Could not start the SPGW user-plane threads");
+    srsran::console("Could not start the SPGW user-plane threads\n");
+  }
+
   int s11 = m_gtpc->get_s11();
 
   size_t buf_len = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
 
-  fd_set set;
-  int    max_fd = std::max(s1u, sgi);
-  max_fd        = std::max(max_fd, s11);
   while (m_running) {
-    s1u_msg->clear();
     s11_msg->clear();
 
-    FD_ZERO(&set);
-    FD_SET(s1u, &set);
-    FD_SET(sgi, &set);
-    FD_SET(s11, &set);
-
-    int n = select(max_fd + 1, &set, NULL, NULL, NULL);
-    if (n == -1) {
-      m_logger.error("Error from select");
-    } else if (n) {
-      if (FD_ISSET(sgi, &set)) {
-        /*
-         * SGi messages may need to be queued when waiting for UE Paging procedure.
-         * For this reason, buffers for SGi pdus are allocated here and deallocated
-         * at the gtpu::send_s1u_pdu() when the PDU is sent, at handle_sgi_pdu() when the PDU is dropped or at
-         * gtpc::free_all_queued_packets, which is called when the Downlink Data Notification
-         * procedure fails (see handle_downlink_data_notification_acknowledgment and
-         * handle_downlink_data_notification_failure)
-         */
-        m_logger.debug("Message received at SPGW: SGi Message");
-        sgi_msg          = srsran::make_byte_buffer("spgw::run_thread::sgi_msg");
-        sgi_msg->N_bytes = read(sgi, sgi_msg->msg, buf_len);
-        m_gtpu->handle_sgi_pdu(std::move(sgi_msg));
-      }
-      if (FD_ISSET(s1u, &set)) {
-        m_logger.debug("Message received at SPGW: S1-U Message");
-        socklen_t addrlen = sizeof(src_addr_in);
-        s1u_msg->N_bytes  = recvfrom(s1u, s1u_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_in, &addrlen);
-        m_gtpu->handle_s1u_pdu(s1u_msg.get());
+    socklen_t addrlen = sizeof(src_addr_un);
+    int       n       = recvfrom(s11, s11_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_un, &addrlen);
+    if (n < 0) {
+      if (errno != EINTR) {
+        m_logger.error("Error receiving from S11: %s", strerror(errno));
       }
-      if (FD_ISSET(s11, &set)) {
-        m_logger.debug("Message received at SPGW: S11 Message");
-        socklen_t addrlen = sizeof(src_addr_un);
-        s11_msg->N_bytes  = recvfrom(s11, s11_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_un, &addrlen);
-        m_gtpc->handle_s11_pdu(s11_msg.get());
-      }
-    } else {
-      m_logger.debug("No data from select.");
+      continue;
     }
+    m_logger.debug("Message received at SPGW: S11 Message");
+    s11_msg->N_bytes = n;
+
+    std::lock_guard<std::mutex> lock(m_ctrl_mutex);
+    m_gtpc->handle_s11_pdu(s11_msg.get());
   }
   return;
 }
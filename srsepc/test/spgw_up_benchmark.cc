@@ -0,0 +1,430 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Loopback benchmark of the SP-GW user plane. The benchmark plays the MME over S11 to set up one session per UE, and
+ * the eNB and the internet host over the loopback and the SGi TUN interface:
+ *  - Downlink: UDP packets are sent to the UE IPs, routed by the kernel into the SGi TUN interface, encapsulated by the
+ *    SP-GW and received on the eNB GTP-U socket.
+ *  - Uplink: GTP-U packets are sent from the eNB socket to the SP-GW, decapsulated into the SGi TUN interface and
+ *    received on a UDP socket bound to the SGi address. All the UEs share the eNB socket, as in a real eNB, so the
+ *    uplink only scales with the number of threads if the SP-GW spreads the tunnels of an eNB across them.
+ * Both directions are measured with 1, 2, 4... user-plane threads, and the rate of each one is reported relative to
+ * the single thread rate. It needs CAP_NET_ADMIN to create the TUN interface.
+ */
+
+#include "srsepc/hdr/spgw/spgw.h"
+#include "srsran/asn1/gtpc.h"
+#include "srsran/common/test_common.h"
+#include "srsran/upper/gtpu.h"
+#include <arpa/inet.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <functional>
+#include <getopt.h>
+#include <linux/ip.h>
+#include <netinet/udp.h>
+#include <sys/un.h>
+#include <thread>
+
+using namespace srsepc;
+
+static uint32_t    nof_up_threads = 4;
+static uint32_t    nof_ues        = 4;
+static uint32_t    duration_ms    = 1000;
+static uint32_t    payload_len    = 1400;
+static std::string enb_addr       = "127.0.2.1";
+static std::string spgw_addr      = "127.0.1.100";
+static std::string sgi_addr       = "172.31.0.1";
+
+static const uint16_t HOST_PORT = 5000;
+static const uint32_t BATCH     = 32;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [tudl]\n", prog);
+  printf("\t-t Maximum number of SP-GW user-plane threads, it runs with 1, 2, 4... up to it [Default %d]\n",
+         nof_up_threads);
+  printf("\t-u Number of UEs, each one with its own sender thread [Default %d]\n", nof_ues);
+  printf("\t-d Duration of each direction in milliseconds [Default %d]\n", duration_ms);
+  printf("\t-l UDP payload length in bytes [Default %d]\n", payload_len);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "tudlh")) != -1) {
+    switch (opt) {
+      case 't':
+        nof_up_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        payload_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+struct ue_session_t {
+  in_addr_t ue_ipv4;
+  uint32_t  sgw_user_teid;
+  uint32_t  enb_user_teid;
+};
+
+static int open_udp_socket(const char* addr, uint16_t port)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  int enable = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  int bufsize = 16 * 1024 * 1024;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+  timeval tv = {0, 100000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  if (addr != nullptr) {
+    sockaddr_in sa     = {};
+    sa.sin_family      = AF_INET;
+    sa.sin_port        = htons(port);
+    sa.sin_addr.s_addr = inet_addr(addr);
+    if (bind(fd, (sockaddr*)&sa, sizeof(sa)) < 0) {
+      perror("bind");
+      close(fd);
+      return -1;
+    }
+  }
+  return fd;
+}
+
+/// Plays the MME side of S11: Create Session followed by Modify Bearer, as done at attach
+static int setup_sessions(std::vector<ue_session_t>& sessions)
+{
+  int s11 = socket(AF_UNIX, SOCK_DGRAM, 0);
+  TESTASSERT(s11 >= 0);
+  sockaddr_un mme = {}, sgw = {};
+  mme.sun_family  = AF_UNIX;
+  snprintf(mme.sun_path, sizeof(mme.sun_path), "@mme_s11");
+  mme.sun_path[0] = '\0';
+  sgw.sun_family  = AF_UNIX;
+  snprintf(sgw.sun_path, sizeof(sgw.sun_path), "@spgw_s11");
+  sgw.sun_path[0] = '\0';
+  TESTASSERT(bind(s11, (sockaddr*)&mme, sizeof(mme)) == 0);
+  timeval tv = {1, 0};
+  setsockopt(s11, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    srsran::gtpc_pdu                      pdu     = {};
+    srsran::gtpc_create_session_request&  cs_req  = pdu.choice.create_session_request;
+    srsran::gtpc_create_session_response& cs_resp = pdu.choice.create_session_response;
+    srsran::gtpc_modify_bearer_request&   mb_req  = pdu.choice.modify_bearer_request;
+
+    pdu.header.type                       = srsran::GTPC_MSG_TYPE_CREATE_SESSION_REQUEST;
+    cs_req.imsi                           = 1010123456780ULL + i;
+    cs_req.sender_f_teid.teid             = i + 1;
+    cs_req.eps_bearer_context_created.ebi = 5;
+    TESTASSERT(sendto(s11, &pdu, sizeof(pdu), 0, (sockaddr*)&sgw, sizeof(sgw)) == sizeof(pdu));
+    TESTASSERT(recv(s11, &pdu, sizeof(pdu), 0) == sizeof(pdu));
+    TESTASSERT(pdu.header.type == srsran::GTPC_MSG_TYPE_CREATE_SESSION_RESPONSE);
+
+    ue_session_t session   = {};
+    session.ue_ipv4        = cs_resp.paa.ipv4;
+    session.sgw_user_teid  = cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid.teid;
+    session.enb_user_teid  = 0x100 + i;
+    uint32_t sgw_ctrl_teid = cs_resp.sender_f_teid.teid;
+
+    pdu                                                      = {};
+    pdu.header.type                                          = srsran::GTPC_MSG_TYPE_MODIFY_BEARER_REQUEST;
+    pdu.header.teid_present                                  = true;
+    pdu.header.teid                                          = sgw_ctrl_teid;
+    mb_req.eps_bearer_context_to_modify.ebi                  = 5;
+    mb_req.eps_bearer_context_to_modify.s1_u_enb_f_teid.ipv4 = inet_addr(enb_addr.c_str());
+    mb_req.eps_bearer_context_to_modify.s1_u_enb_f_teid.teid = session.enb_user_teid;
+    TESTASSERT(sendto(s11, &pdu, sizeof(pdu), 0, (sockaddr*)&sgw, sizeof(sgw)) == sizeof(pdu));
+    TESTASSERT(recv(s11, &pdu, sizeof(pdu), 0) == sizeof(pdu));
+    TESTASSERT(pdu.header.type == srsran::GTPC_MSG_TYPE_MODIFY_BEARER_RESPONSE);
+
+    sessions.push_back(session);
+  }
+  close(s11);
+  return SRSRAN_SUCCESS;
+}
+
+static uint16_t ip_checksum(const uint8_t* hdr, uint32_t len)
+{
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < len; i += 2) {
+    sum += (hdr[i] << 8) | hdr[i + 1];
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return htons(~sum);
+}
+
+/// Builds the GTP-U encapsulated IPv4/UDP packet of an uplink flow
+static std::vector<uint8_t> make_ul_packet(const ue_session_t& session, uint16_t src_port)
+{
+  uint32_t             ip_len = sizeof(iphdr) + sizeof(udphdr) + payload_len;
+  std::vector<uint8_t> pkt(GTPU_BASE_HEADER_LEN + ip_len, 0xab);
+
+  uint8_t* gtpu = pkt.data();
+  gtpu[0]       = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+  gtpu[1]       = GTPU_MSG_DATA_PDU;
+  gtpu[2]       = ip_len >> 8;
+  gtpu[3]       = ip_len & 0xff;
+  gtpu[4]       = session.sgw_user_teid >> 24;
+  gtpu[5]       = (session.sgw_user_teid >> 16) & 0xff;
+  gtpu[6]       = (session.sgw_user_teid >> 8) & 0xff;
+  gtpu[7]       = session.sgw_user_teid & 0xff;
+
+  iphdr* iph    = (iphdr*)(pkt.data() + GTPU_BASE_HEADER_LEN);
+  iph->version  = 4;
+  iph->ihl      = 5;
+  iph->tos      = 0;
+  iph->tot_len  = htons(ip_len);
+  iph->id       = 0;
+  iph->frag_off = 0;
+  iph->ttl      = 64;
+  iph->protocol = IPPROTO_UDP;
+  iph->check    = 0;
+  iph->saddr    = session.ue_ipv4;
+  iph->daddr    = inet_addr(sgi_addr.c_str());
+  iph->check    = ip_checksum((uint8_t*)iph, sizeof(iphdr));
+
+  udphdr* udph = (udphdr*)(iph + 1);
+  udph->source = htons(src_port);
+  udph->dest   = htons(HOST_PORT);
+  udph->len    = htons(sizeof(udphdr) + payload_len);
+  udph->check  = 0;
+  return pkt;
+}
+
+struct direction_result_t {
+  uint64_t nof_rx_pkts = 0;
+  uint64_t rx_bytes    = 0; // IP bytes, without the GTP-U header
+  double   elapsed_s   = 0;
+
+  double mpps() const { return nof_rx_pkts / elapsed_s / 1e6; }
+  double gbps() const { return rx_bytes * 8 / elapsed_s / 1e9; }
+};
+
+using sender_func_t = std::function<void(uint32_t ue_idx, const std::atomic<bool>& stop_token)>;
+
+/// Sends with one thread per UE and counts the packets that arrive at rx_fd
+static direction_result_t run_direction(int rx_fd, int32_t rx_ip_overhead, const sender_func_t& sender)
+{
+  std::atomic<bool>     stop_token = {false};
+  std::atomic<uint64_t> nof_rx     = {0};
+  std::atomic<uint64_t> rx_bytes   = {0};
+
+  std::thread receiver([&]() {
+    std::vector<uint8_t>       bufs(BATCH * 2048);
+    std::array<mmsghdr, BATCH> msgs = {};
+    std::array<iovec, BATCH>   iovs = {};
+    while (not stop_token.load(std::memory_order_relaxed)) {
+      for (uint32_t i = 0; i < BATCH; ++i) {
+        iovs[i].iov_base           = &bufs[i * 2048];
+        iovs[i].iov_len            = 2048;
+        msgs[i].msg_hdr            = {};
+        msgs[i].msg_hdr.msg_iov    = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+      int n = recvmmsg(rx_fd, msgs.data(), BATCH, MSG_WAITFORONE, nullptr);
+      if (n > 0) {
+        uint64_t bytes = 0;
+        for (int i = 0; i < n; ++i) {
+          bytes += msgs[i].msg_len + rx_ip_overhead;
+        }
+        rx_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        nof_rx.fetch_add(n, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  std::vector<std::thread> senders;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    senders.emplace_back([&sender, &stop_token, i]() { sender(i, stop_token); });
+  }
+
+  // Measure only the steady state
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  uint64_t rx_start    = nof_rx.load();
+  uint64_t bytes_start = rx_bytes.load();
+  auto     t_start     = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+  uint64_t rx_end    = nof_rx.load();
+  uint64_t bytes_end = rx_bytes.load();
+  auto     t_end     = std::chrono::steady_clock::now();
+
+  stop_token = true;
+  for (std::thread& t : senders) {
+    t.join();
+  }
+  receiver.join();
+
+  direction_result_t result;
+  result.nof_rx_pkts = rx_end - rx_start;
+  result.rx_bytes    = bytes_end - bytes_start;
+  result.elapsed_s   = std::chrono::duration<double>(t_end - t_start).count();
+  return result;
+}
+
+/// Sends the same datagram from fd to dst in batches until stopped
+static void send_loop(int fd, const sockaddr_in& dst, uint8_t* data, size_t len, const std::atomic<bool>& stop_token)
+{
+  std::array<mmsghdr, BATCH> msgs = {};
+  iovec                      iov  = {data, len};
+  for (mmsghdr& m : msgs) {
+    m.msg_hdr.msg_name    = (void*)&dst;
+    m.msg_hdr.msg_namelen = sizeof(dst);
+    m.msg_hdr.msg_iov     = &iov;
+    m.msg_hdr.msg_iovlen  = 1;
+  }
+  while (not stop_token.load(std::memory_order_relaxed)) {
+    sendmmsg(fd, msgs.data(), msgs.size(), 0);
+  }
+}
+
+static void print_result(const char* dir, const direction_result_t& r)
+{
+  printf("%s: %" PRIu64 " packets received in %.2f s, %.3f Mpps, %.3f Gbps (IP layer)\n",
+         dir,
+         r.nof_rx_pkts,
+         r.elapsed_s,
+         r.mpps(),
+         r.gbps());
+}
+
+/// Sets up the SP-GW with nof_threads user-plane threads and measures both directions
+static int run_benchmark(uint32_t nof_threads, direction_result_t& dl, direction_result_t& ul)
+{
+  spgw_args_t args      = {};
+  args.gtpu_bind_addr   = spgw_addr;
+  args.sgi_if_addr      = sgi_addr;
+  args.sgi_if_name      = "srs_spgw_bench";
+  args.max_paging_queue = 100;
+  args.nof_up_threads   = nof_threads;
+
+  spgw* gw = spgw::get_instance();
+  if (gw->init(&args, {}) != SRSRAN_SUCCESS) {
+    printf("Could not initialize the SP-GW. The benchmark needs CAP_NET_ADMIN\n");
+    spgw::cleanup();
+    return SRSRAN_ERROR;
+  }
+  gw->start();
+
+  std::vector<ue_session_t> sessions;
+  TESTASSERT(setup_sessions(sessions) == SRSRAN_SUCCESS);
+
+  int enb_fd  = open_udp_socket(enb_addr.c_str(), GTPU_RX_PORT);
+  int host_fd = open_udp_socket(sgi_addr.c_str(), HOST_PORT);
+  TESTASSERT(enb_fd >= 0 and host_fd >= 0);
+
+  printf("up_threads=%d, ues=%d, payload=%d bytes\n", nof_threads, nof_ues, payload_len);
+
+  // Downlink: internet host -> SGi -> SP-GW -> S1-U -> eNB. Every UE is a different flow
+  dl = run_direction(
+      enb_fd, -(int32_t)GTPU_BASE_HEADER_LEN, [&sessions](uint32_t ue_idx, const std::atomic<bool>& stop) {
+        std::vector<uint8_t> payload(payload_len, 0xab);
+        sockaddr_in          dst = {};
+        dst.sin_family           = AF_INET;
+        dst.sin_port             = htons(HOST_PORT);
+        dst.sin_addr.s_addr      = sessions[ue_idx].ue_ipv4;
+        int fd                   = open_udp_socket(nullptr, 0);
+        send_loop(fd, dst, payload.data(), payload.size(), stop);
+        close(fd);
+      });
+  print_result("DL", dl);
+
+  // Uplink: eNB -> S1-U -> SP-GW -> SGi -> internet host. All the UEs are sent from the eNB socket
+  ul = run_direction(
+      host_fd, sizeof(iphdr) + sizeof(udphdr), [&sessions, enb_fd](uint32_t ue_idx, const std::atomic<bool>& stop) {
+        std::vector<uint8_t> pkt = make_ul_packet(sessions[ue_idx], HOST_PORT + 1 + ue_idx);
+        sockaddr_in          dst = {};
+        dst.sin_family           = AF_INET;
+        dst.sin_port             = htons(GTPU_RX_PORT);
+        dst.sin_addr.s_addr      = inet_addr(spgw_addr.c_str());
+        send_loop(enb_fd, dst, pkt.data(), pkt.size(), stop);
+      });
+  print_result("UL", ul);
+
+  close(enb_fd);
+  close(host_fd);
+  gw->stop();
+  spgw::cleanup();
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  if (nof_ues == 0 or nof_up_threads == 0 or payload_len == 0 or payload_len > 1400) {
+    usage(argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  srslog::fetch_basic_logger("GTPU", false).set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("SPGW", false).set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("SPGW GTPC", false).set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  std::vector<uint32_t> thread_counts;
+  for (uint32_t n = 1; n < nof_up_threads; n *= 2) {
+    thread_counts.push_back(n);
+  }
+  thread_counts.push_back(nof_up_threads);
+
+  std::vector<direction_result_t> dl(thread_counts.size()), ul(thread_counts.size());
+  for (uint32_t i = 0; i < thread_counts.size(); ++i) {
+    if (run_benchmark(thread_counts[i], dl[i], ul[i]) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+    TESTASSERT(dl[i].nof_rx_pkts > 0);
+    TESTASSERT(ul[i].nof_rx_pkts > 0);
+  }
+  srslog::flush();
+
+  printf("\nthreads |  DL Mpps  DL Gbps  DL scaling |  UL Mpps  UL Gbps  UL scaling\n");
+  for (uint32_t i = 0; i < thread_counts.size(); ++i) {
+    printf("%7d | %8.3f %8.3f %10.2fx | %8.3f %8.3f %10.2fx\n",
+           thread_counts[i],
+           dl[i].mpps(),
+           dl[i].gbps(),
+           dl[i].mpps() / dl[0].mpps(),
+           ul[i].mpps(),
+           ul[i].gbps(),
+           ul[i].mpps() / ul[0].mpps());
+  }
+
+  return SRSRAN_SUCCESS;
+}
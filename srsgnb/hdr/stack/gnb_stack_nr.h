@@ -37,6 +37,7 @@
 #include "srsran/interfaces/gnb_interfaces.h"
 
 #include "srsran/common/ngap_pcap.h"
+#include "srsran/common/network_utils.h"
 
 namespace srsenb {
 
@@ -61,7 +62,7 @@ class gnb_stack_nr final : public srsenb::enb_stack_base,
                            public srsran::thread
 {
 public:
-  explicit gnb_stack_nr(srslog::sink& log_sink);
+  gnb_stack_nr(srslog::sink& log_sink, srsran::socket_manager& rx_sockets_);
   ~gnb_stack_nr() final;
 
   int init(const gnb_stack_args_t& args_,
@@ -80,6 +81,7 @@ public:
 
   // Temporary GW interface
   void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) override;
+  void write_sdu_batch(uint32_t lcid, srsue::gw_sdu_batch_t sdus) override;
   bool has_active_radio_bearer(uint32_t eps_bearer_id) override;
   bool switch_on();
   void tti_clock() override;
@@ -151,6 +153,9 @@ private:
   srsran::task_multiqueue::queue_handle sync_task_queue, gtpu_task_queue, metrics_task_queue, gnb_task_queue,
       x2_task_queue;
 
+  // NGAP and GTP-U sockets, shared with the EUTRA stack
+  srsran::socket_manager& rx_sockets;
+
   // metrics waiting condition
   std::mutex              metrics_mutex;
   std::condition_variable metrics_cvar;
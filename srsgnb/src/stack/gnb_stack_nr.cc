@@ -29,8 +29,9 @@
 
 namespace srsenb {
 
-gnb_stack_nr::gnb_stack_nr(srslog::sink& log_sink) :
+gnb_stack_nr::gnb_stack_nr(srslog::sink& log_sink, srsran::socket_manager& rx_sockets_) :
   task_sched{512, 128},
+  rx_sockets(rx_sockets_),
   thread("gNB"),
   mac_logger(srslog::fetch_basic_logger("MAC-NR", log_sink)),
   rlc_logger(srslog::fetch_basic_logger("RLC-NR", log_sink, false)),
@@ -91,8 +92,8 @@ int gnb_stack_nr::init(const gnb_stack_args_t& args_,
 
   if (x2_ == nullptr) {
     // SA mode
-    ngap.reset(new srsenb::ngap(&task_sched, ngap_logger, &srsran::get_rx_io_manager()));
-    gtpu.reset(new srsenb::gtpu(&task_sched, gtpu_logger, &srsran::get_rx_io_manager()));
+    ngap.reset(new srsenb::ngap(&task_sched, ngap_logger, &rx_sockets));
+    gtpu.reset(new srsenb::gtpu(&task_sched, gtpu_logger, &rx_sockets));
     gtpu_adapter.reset(new gtpu_pdcp_adapter(gtpu_logger, nullptr, &pdcp, gtpu.get(), *bearer_manager));
   }
 
@@ -146,7 +147,7 @@ void gnb_stack_nr::stop()
 
 void gnb_stack_nr::stop_impl()
 {
-  srsran::get_rx_io_manager().stop();
+  rx_sockets.stop();
 
   rrc.stop();
   pdcp.stop();
@@ -222,6 +223,11 @@ void gnb_stack_nr::write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu)
   // not implemented
 }
 
+void gnb_stack_nr::write_sdu_batch(uint32_t lcid, srsue::gw_sdu_batch_t sdus)
+{
+  // not implemented
+}
+
 bool gnb_stack_nr::has_active_radio_bearer(uint32_t eps_bearer_id)
 {
   return false;
@@ -103,6 +103,18 @@ public:
     return (uint32_t)(perf_count_samples / perf_count_us);
   };
 
+  /**
+   * @brief Computes the average SSB search and measurement time since last configuration
+   * @return The average time in microseconds per measurement
+   */
+  double get_perf_usec() const
+  {
+    if (perf_count_meas == 0) {
+      return 0.0;
+    }
+    return (double)perf_count_us / (double)perf_count_meas;
+  };
+
 private:
   /**
    * @brief Provides with the RAT to the base class
@@ -129,6 +141,7 @@ private:
   /// Performance
   uint64_t perf_count_us      = 0; ///< Counts execution time in microseconds
   uint64_t perf_count_samples = 0; ///< Counts the number samples
+  uint64_t perf_count_meas    = 0; ///< Counts the number of measurements
 
   /// NR-based measuring objects
   srsran_ssb_t ssb = {}; ///< SS/PBCH Block
@@ -28,8 +28,10 @@
 #include "srsran/common/interfaces_common.h"
 #include "srsran/common/threads.h"
 #include "srsran/interfaces/ue_gw_interfaces.h"
+#include "srsran/interfaces/ue_pdcp_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include "tft_packet_filter.h"
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <net/if.h>
@@ -47,6 +49,7 @@ struct gw_args_t {
   std::string netns;
   std::string tun_dev_name;
   std::string tun_dev_netmask;
+  bool        batch_io = false;
 };
 
 class gw : public gw_interface_stack, public srsran::thread
@@ -101,12 +104,26 @@ private:
   uint32_t                                       dl_tput_bytes = 0;
   std::chrono::high_resolution_clock::time_point metrics_tp; // stores time when last metrics have been taken
 
-  void run_thread();
-  int  init_if(char* err_str);
-  int  setup_if_addr4(uint32_t ip_addr, char* err_str);
-  int  setup_if_addr6(uint8_t* ipv6_if_id, char* err_str);
-  bool find_ipv6_addr(struct in6_addr* in6_out);
-  void del_ipv6_addr(struct in6_addr* in6p);
+  // Batch I/O. The buffers are kept across wakeups of the GW thread
+  std::array<srsran::unique_byte_buffer_t, GW_MAX_SDU_BATCH> ul_pdus;
+  gw_sdu_batch_t                                             ul_batch;
+  gw_sdu_batch_t                                             dl_batch;
+  gw_sdu_batch_t                                             dl_pending; // filled by the stack, protected by dl_mutex
+  std::mutex                                                 dl_mutex;
+  int32_t                                                    dl_event_fd = -1; // wakes the GW thread on new DL PDUs
+
+  void     run_thread();
+  void     run_thread_batch();
+  void     write_dl_batch();
+  void     write_tun(srsran::byte_buffer_t* pdu);
+  uint16_t get_ip_pkt_len(srsran::byte_buffer_t* pdu);
+  bool     wait_for_attach(std::unique_lock<std::mutex>& lock);
+  bool     wait_for_service(uint8_t eps_bearer_id);
+  int      init_if(char* err_str);
+  int      setup_if_addr4(uint32_t ip_addr, char* err_str);
+  int      setup_if_addr6(uint8_t* ipv6_if_id, char* err_str);
+  bool     find_ipv6_addr(struct in6_addr* in6_out);
+  void     del_ipv6_addr(struct in6_addr* in6p);
 
   // MBSFN
   int                mbsfn_sock_fd                   = 0;  // Sink UDP socket file descriptor
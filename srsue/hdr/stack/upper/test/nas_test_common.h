@@ -176,6 +176,12 @@ public:
     return true;
   }
   void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) { pdcp->write_sdu(lcid, std::move(sdu)); }
+  void write_sdu_batch(uint32_t lcid, gw_sdu_batch_t sdus)
+  {
+    for (srsran::unique_byte_buffer_t& sdu : sdus) {
+      pdcp->write_sdu(lcid, std::move(sdu));
+    }
+  }
   bool has_active_radio_bearer(uint32_t eps_bearer_id) { return true; }
 
   bool is_registered() { return true; }
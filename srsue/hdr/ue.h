@@ -75,6 +75,9 @@ typedef struct {
   bool        tracing_enable;
   std::string tracing_filename;
   std::size_t tracing_buffcapacity;
+  bool        tti_trace_enable;
+  std::string tti_trace_filename;
+  uint32_t    tti_trace_nof_events;
 } general_args_t;
 
 typedef struct {
@@ -25,6 +25,7 @@
 #include "srsran/common/metrics_hub.h"
 #include "srsran/common/multiqueue.h"
 #include "srsran/common/tsan_options.h"
+#include "srsran/common/tti_trace.h"
 #include "srsran/srslog/event_trace.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/srsran.h"
@@ -208,9 +209,11 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("gw.netns", bpo::value<string>(&args->gw.netns)->default_value(""), "Network namespace to for TUN device (empty for default netns)")
     ("gw.ip_devname", bpo::value<string>(&args->gw.tun_dev_name)->default_value("tun_srsue"), "Name of the tun_srsue device")
     ("gw.ip_netmask", bpo::value<string>(&args->gw.tun_dev_netmask)->default_value("255.255.255.0"), "Netmask of the tun_srsue device")
+    ("gw.batch_io", bpo::value<bool>(&args->gw.batch_io)->default_value(false), "Drain the tun_srsue device in batches and hand them to the stack in a single task")
 
     /* Downlink Channel emulator section */
     ("channel.dl.enable",            bpo::value<bool>(&args->phy.dl_channel_args.enable)->default_value(false),                 "Enable/Disable internal Downlink channel emulator")
+    ("channel.dl.nof_threads",       bpo::value<uint32_t>(&args->phy.dl_channel_args.nof_threads)->default_value(1),            "Number of threads running the fading and delay of the antenna channels")
     ("channel.dl.awgn.enable",       bpo::value<bool>(&args->phy.dl_channel_args.awgn_enable)->default_value(false),            "Enable/Disable AWGN simulator")
     ("channel.dl.awgn.snr",          bpo::value<float>(&args->phy.dl_channel_args.awgn_snr_dB)->default_value(30.0f),           "SNR in dB")
     ("channel.dl.awgn.signal_power", bpo::value<float>(&args->phy.dl_channel_args.awgn_signal_power_dBfs)->default_value(0.0f), "Received signal power in decibels full scale (dBfs)")
@@ -231,6 +234,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
 
     /* Uplink Channel emulator section */
     ("channel.ul.enable",            bpo::value<bool>(&args->phy.ul_channel_args.enable)->default_value(false),                  "Enable/Disable internal Downlink channel emulator")
+    ("channel.ul.nof_threads",       bpo::value<uint32_t>(&args->phy.ul_channel_args.nof_threads)->default_value(1),             "Number of threads running the fading and delay of the antenna channels")
     ("channel.ul.awgn.enable",       bpo::value<bool>(&args->phy.ul_channel_args.awgn_enable)->default_value(false),             "Enable/Disable AWGN simulator")
     ("channel.ul.awgn.snr",          bpo::value<float>(&args->phy.ul_channel_args.awgn_snr_dB)->default_value(30.0f),            "Noise level in decibels full scale (dBfs)")
     ("channel.ul.awgn.signal_power", bpo::value<float>(&args->phy.ul_channel_args.awgn_signal_power_dBfs)->default_value(30.0f), "Transmitted signal power in decibels full scale (dBfs)")
@@ -492,6 +496,18 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
            bpo::value<std::size_t>(&args->general.tracing_buffcapacity)->default_value(1000000),
            "Tracing buffer capcity")
 
+    ("general.tti_trace_enable",
+           bpo::value<bool>(&args->general.tti_trace_enable)->default_value(false),
+           "Record the latency of the TTI processing stages and write them as a Chrome/Perfetto trace at exit")
+
+    ("general.tti_trace_filename",
+           bpo::value<string>(&args->general.tti_trace_filename)->default_value("/tmp/ue_tti_trace.json"),
+           "TTI latency trace filename")
+
+    ("general.tti_trace_nof_events",
+           bpo::value<uint32_t>(&args->general.tti_trace_nof_events)->default_value(65536),
+           "Number of trace events kept per thread, the oldest ones are overwritten")
+
     ("stack.have_tti_time_stats",
         bpo::value<bool>(&args->stack.have_tti_time_stats)->default_value(true),
         "Calculate TTI execution statistics")
@@ -749,6 +765,12 @@ int main(int argc, char* argv[])
   }
 #endif
 
+  if (args.general.tti_trace_enable) {
+    if (!srsran::tti_trace_init(args.general.tti_trace_filename, args.general.tti_trace_nof_events)) {
+      return SRSRAN_ERROR;
+    }
+  }
+
   // Start the log backend.
   srslog::init();
 
@@ -817,6 +839,13 @@ int main(int argc, char* argv[])
   metricshub.stop();
   metrics_file.stop();
   ue.stop();
+
+  if (args.general.tti_trace_enable) {
+    srsran::tti_trace_stop();
+    if (srsran::tti_trace_write()) {
+      cout << "TTI trace written to " << args.general.tti_trace_filename << endl;
+    }
+  }
   cout << "---  exiting  ---" << endl;
 
   return SRSRAN_SUCCESS;
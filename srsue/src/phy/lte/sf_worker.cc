@@ -22,6 +22,7 @@
 #include "srsran/srsran.h"
 
 #include "srsran/common/standard_streams.h"
+#include "srsran/common/tti_trace.h"
 #include "srsue/hdr/phy/lte/sf_worker.h"
 #include <string.h>
 
@@ -164,6 +165,8 @@ void sf_worker::work_imp()
     return;
   }
 
+  tti_trace_event("PHY", "sf_worker::work_imp", tti);
+
   bool     rx_signal_ok    = false;
   bool     tx_signal_ready = false;
   uint32_t nof_samples     = SRSRAN_SF_LEN_PRB(cell.nof_prb);
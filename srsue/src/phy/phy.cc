@@ -148,6 +148,12 @@ void phy::run_thread()
   sfsync.init(
       radio, stack, &prach_buffer, &lte_workers, &nr_workers, &common, SF_RECV_THREAD_PRIO, args.sync_cpu_affinity);
 
+  if (logger_phy.info.enabled()) {
+    char dft_info[256];
+    srsran_dft_metrics_info(dft_info, sizeof(dft_info));
+    logger_phy.info("%s", dft_info);
+  }
+
   is_configured = true;
   config_cond.notify_all();
 }
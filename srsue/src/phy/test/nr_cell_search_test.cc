@@ -533,6 +533,11 @@ int main(int argc, char** argv)
 
   ret = rrc.print_stats(args) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
 
+  // Report the SSB search time
+  printf("            SSB search time: %.1f usec/search (%d Msps)\n",
+         intra_measure.get_perf_usec(),
+         intra_measure.get_perf());
+
   if (radio) {
     radio->stop();
   }
@@ -423,19 +423,8 @@ void ue_stack_lte::write_sdu(uint32_t eps_bearer_id, srsran::unique_byte_buffer_
 {
   auto bearer = bearers.get_radio_bearer(eps_bearer_id);
 
-  auto task   = [this, eps_bearer_id, bearer](srsran::unique_byte_buffer_t& sdu) {
-    // route SDU to PDCP entity
-    if (bearer.rat == srsran_rat_t::lte) {
-      pdcp.write_sdu(bearer.lcid, std::move(sdu));
-    } else if (bearer.rat == srsran_rat_t::nr) {
-      if (args.sa_mode) {
-        sdap.write_sdu(bearer.lcid, std::move(sdu));
-      } else {
-        pdcp_nr.write_sdu(bearer.lcid, std::move(sdu));
-      }
-    } else {
-      stack_logger.warning("Can't deliver SDU for EPS bearer %d. Dropping it.", eps_bearer_id);
-    }
+  auto task = [this, eps_bearer_id, bearer](srsran::unique_byte_buffer_t& sdu) {
+    route_sdu(eps_bearer_id, bearer, std::move(sdu));
   };
 
   bool ret = gw_queue_id.try_push(std::bind(task, std::move(sdu))).has_value();
@@ -445,6 +434,49 @@ void ue_stack_lte::write_sdu(uint32_t eps_bearer_id, srsran::unique_byte_buffer_
   }
 }
 
+/**
+ * Same as write_sdu() for a batch of SDUs of the same EPS bearer. The bearer
+ * lookup and the stack task are done once for the whole batch.
+ *
+ * @param eps_bearer_id
+ * @param sdus
+ */
+void ue_stack_lte::write_sdu_batch(uint32_t eps_bearer_id, gw_sdu_batch_t sdus)
+{
+  auto     bearer   = bearers.get_radio_bearer(eps_bearer_id);
+  uint32_t nof_sdus = sdus.size();
+
+  auto task = [this, eps_bearer_id, bearer](gw_sdu_batch_t& sdus) {
+    for (srsran::unique_byte_buffer_t& sdu : sdus) {
+      route_sdu(eps_bearer_id, bearer, std::move(sdu));
+    }
+  };
+
+  bool ret = gw_queue_id.try_push(std::bind(task, std::move(sdus))).has_value();
+  if (not ret) {
+    pdcp_logger.info("GW batch of %d SDUs with lcid=%d was discarded.", nof_sdus, bearer.lcid);
+    ul_dropped_sdus += nof_sdus;
+  }
+}
+
+void ue_stack_lte::route_sdu(uint32_t                                eps_bearer_id,
+                             const ue_bearer_manager::radio_bearer_t& bearer,
+                             srsran::unique_byte_buffer_t             sdu)
+{
+  // route SDU to PDCP entity
+  if (bearer.rat == srsran_rat_t::lte) {
+    pdcp.write_sdu(bearer.lcid, std::move(sdu));
+  } else if (bearer.rat == srsran_rat_t::nr) {
+    if (args.sa_mode) {
+      sdap.write_sdu(bearer.lcid, std::move(sdu));
+    } else {
+      pdcp_nr.write_sdu(bearer.lcid, std::move(sdu));
+    }
+  } else {
+    stack_logger.warning("Can't deliver SDU for EPS bearer %d. Dropping it.", eps_bearer_id);
+  }
+}
+
 bool ue_stack_lte::has_active_radio_bearer(uint32_t eps_bearer_id)
 {
   return bearers.has_active_radio_bearer(eps_bearer_id);
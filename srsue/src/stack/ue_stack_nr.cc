@@ -184,6 +184,22 @@ void ue_stack_nr::write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu)
   }
 }
 
+void ue_stack_nr::write_sdu_batch(uint32_t lcid, gw_sdu_batch_t sdus)
+{
+  if (pdcp != nullptr) {
+    auto ret = gw_task_queue.try_push(std::bind(
+        [this, lcid](gw_sdu_batch_t& sdus) {
+          for (srsran::unique_byte_buffer_t& sdu : sdus) {
+            pdcp->write_sdu(lcid, std::move(sdu));
+          }
+        },
+        std::move(sdus)));
+    if (ret.is_error()) {
+      pdcp_logger.warning("GW SDU batch with lcid=%d was discarded.", lcid);
+    }
+  }
+}
+
 /********************
  *  SYNC Interface
  *******************/
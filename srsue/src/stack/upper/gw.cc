@@ -32,6 +32,8 @@
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -76,6 +78,9 @@ gw::~gw()
   if (tun_fd > 0) {
     close(tun_fd);
   }
+  if (dl_event_fd >= 0) {
+    close(dl_event_fd);
+  }
 }
 
 void gw::stop()
@@ -136,10 +141,32 @@ void gw::get_metrics(gw_metrics_t& m, const uint32_t nof_tti)
 void gw::write_pdu(uint32_t lcid, srsran::unique_byte_buffer_t pdu)
 {
   logger.info(pdu->msg, pdu->N_bytes, "RX PDU. Stack latency: %ld us", pdu->get_latency_us().count());
+  if (args.batch_io && if_up) {
+    // Hand the PDU over to the GW thread, which writes all the pending PDUs to the TUN device per wakeup. It is only
+    // woken up by the first PDU of a batch
+    std::lock_guard<std::mutex> lock(dl_mutex);
+    if (dl_pending.full()) {
+      logger.warning("DL TUN/TAP batch full - dropping gw RX message");
+      return;
+    }
+    dl_pending.push_back(std::move(pdu));
+    if (dl_pending.size() == 1) {
+      uint64_t event = 1;
+      if (write(dl_event_fd, &event, sizeof(event)) != sizeof(event)) {
+        logger.warning("Failed to wake up the GW thread");
+      }
+    }
+    return;
+  }
   {
     std::unique_lock<std::mutex> lock(gw_mutex);
     dl_tput_bytes += pdu->N_bytes;
   }
+  write_tun(pdu.get());
+}
+
+void gw::write_tun(srsran::byte_buffer_t* pdu)
+{
   if (!if_up) {
     if (run_enable) {
       logger.warning("TUN/TAP not up - dropping gw RX message");
@@ -274,6 +301,11 @@ void gw::add_mch_port(uint32_t lcid, uint32_t port)
 /********************/
 void gw::run_thread()
 {
+  if (args.batch_io) {
+    run_thread_batch();
+    return;
+  }
+
   uint32 idx     = 0;
   int32  N_bytes = 0;
 
@@ -283,9 +315,6 @@ void gw::run_thread()
     return;
   }
 
-  const static uint32_t REGISTER_WAIT_TOUT = 40, SERVICE_WAIT_TOUT = 40; // 4 sec
-  uint32_t              register_wait = 0, service_wait = 0;
-
   logger.info("GW IP packet receiver thread run_enable");
 
   running = true;
@@ -309,65 +338,34 @@ void gw::run_thread()
     {
       std::unique_lock<std::mutex> lock(gw_mutex);
       // Check if IP version makes sense and get packtet length
-      struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
-      struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-      uint16_t        pkt_len = 0;
-      pdu->N_bytes            = idx + N_bytes;
-      if (ip_pkt->version == 4) {
-        pkt_len = ntohs(ip_pkt->tot_len);
-      } else if (ip_pkt->version == 6) {
-        pkt_len = ntohs(ip6_pkt->payload_len) + 40;
-      } else {
-        logger.error(pdu->msg, pdu->N_bytes, "Unsupported IP version. Dropping packet.");
+      struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
+      pdu->N_bytes         = idx + N_bytes;
+      uint16_t pkt_len     = get_ip_pkt_len(pdu.get());
+      if (pkt_len == 0) {
         continue;
       }
-      logger.debug("IPv%d packet total length: %d Bytes", int(ip_pkt->version), pkt_len);
 
       // Check if entire packet was received
       if (pkt_len == pdu->N_bytes) {
         logger.info(pdu->msg, pdu->N_bytes, "TX PDU");
 
-        // Make sure UE is attached and has default EPS bearer activated
-        while (run_enable && default_eps_bearer_id == NOT_ASSIGNED && register_wait < REGISTER_WAIT_TOUT) {
-          if (!register_wait) {
-            logger.info("UE is not attached, waiting for NAS attach (%d/%d)", register_wait, REGISTER_WAIT_TOUT);
+        // Make sure UE is attached and has default EPS bearer activated. If we are still not attached by this stage,
+        // drop packet
+        if (!wait_for_attach(lock)) {
+          if (!run_enable) {
+            break;
           }
-          lock.unlock();
-          std::this_thread::sleep_for(std::chrono::microseconds(100));
-          lock.lock();
-          register_wait++;
-        }
-        register_wait = 0;
-
-        // If we are still not attached by this stage, drop packet
-        if (run_enable && default_eps_bearer_id == NOT_ASSIGNED) {
           continue;
         }
 
-        if (!run_enable) {
-          break;
-        }
-
         // Beyond this point we should have a activated default EPS bearer
         srsran_assert(default_eps_bearer_id != NOT_ASSIGNED, "Default EPS bearer not activated");
 
         uint8_t eps_bearer_id = default_eps_bearer_id;
         tft_matcher.check_tft_filter_match(pdu, eps_bearer_id);
 
-        // Wait for service request if necessary
-        while (run_enable && !stack->has_active_radio_bearer(eps_bearer_id) && service_wait < SERVICE_WAIT_TOUT) {
-          if (!service_wait) {
-            logger.info(
-                "UE does not have service, waiting for NAS service request (%d/%d)", service_wait, SERVICE_WAIT_TOUT);
-            stack->start_service_request();
-          }
-          usleep(100000);
-          service_wait++;
-        }
-        service_wait = 0;
-
-        // Quit before writing packet if necessary
-        if (!run_enable) {
+        // Wait for service request if necessary. Quit before writing packet if necessary
+        if (!wait_for_service(eps_bearer_id)) {
           break;
         }
 
@@ -393,6 +391,202 @@ void gw::run_thread()
   logger.info("GW IP receiver thread exiting.");
 }
 
+/*
+ * Batched I/O loop. The TUN device is non-blocking and, after each wakeup, all the pending IP packets (up to
+ * GW_MAX_SDU_BATCH) are read into their own buffers, keeping the byte_buffer headroom for the PDCP/RLC/MAC headers.
+ * Consecutive packets of the same EPS bearer are then pushed to the stack with a single task. The same thread writes
+ * the DL PDUs queued by the stack, so the stack does not block on the TUN writes.
+ */
+void gw::run_thread_batch()
+{
+  struct pollfd pfd[2] = {};
+  pfd[0].fd            = tun_fd;
+  pfd[0].events        = POLLIN;
+  pfd[1].fd            = dl_event_fd;
+  pfd[1].events        = POLLIN;
+
+  logger.info("GW IP packet batch receiver thread run_enable");
+
+  running = true;
+  while (run_enable) {
+    if (poll(pfd, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger.error("Failed to poll TUN interface - gw receive thread exiting.");
+      srsran::console("Failed to poll TUN interface - gw receive thread exiting.\n");
+      break;
+    }
+
+    if (pfd[1].revents & POLLIN) {
+      write_dl_batch();
+    }
+    if (!(pfd[0].revents & POLLIN)) {
+      continue;
+    }
+
+    // Drain the TUN device. Each read returns one entire IP packet
+    uint32_t nof_pdus = 0;
+    bool     tun_err  = false;
+    while (nof_pdus < GW_MAX_SDU_BATCH) {
+      srsran::unique_byte_buffer_t& pdu = ul_pdus[nof_pdus];
+      if (pdu == nullptr) {
+        pdu = srsran::make_byte_buffer();
+        if (pdu == nullptr) {
+          logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+          break;
+        }
+      } else {
+        pdu->clear();
+      }
+      int32_t N_bytes = read(tun_fd, pdu->msg, SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET);
+      if (N_bytes <= 0) {
+        tun_err = N_bytes == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+        break;
+      }
+      pdu->N_bytes = N_bytes;
+
+      uint16_t pkt_len = get_ip_pkt_len(pdu.get());
+      if (pkt_len == 0) {
+        continue;
+      }
+      if (pkt_len != pdu->N_bytes) {
+        logger.warning("Dropping truncated IP packet. Total Length %d, N_Bytes %d.", pkt_len, pdu->N_bytes);
+        continue;
+      }
+      logger.info(pdu->msg, pdu->N_bytes, "TX PDU");
+      nof_pdus++;
+    }
+    if (tun_err) {
+      logger.error("Failed to read from TUN interface - gw receive thread exiting.");
+      srsran::console("Failed to read from TUN interface - gw receive thread exiting.\n");
+      break;
+    }
+    if (nof_pdus == 0) {
+      continue;
+    }
+    logger.debug("Read %d packets from TUN fd=%d", nof_pdus, tun_fd);
+
+    std::unique_lock<std::mutex> lock(gw_mutex);
+
+    // Make sure UE is attached and has default EPS bearer activated, otherwise drop the batch
+    if (!wait_for_attach(lock)) {
+      if (!run_enable) {
+        break;
+      }
+      continue;
+    }
+
+    uint8_t batch_eps_bearer_id = default_eps_bearer_id;
+    ul_batch.clear();
+    for (uint32_t i = 0; i <= nof_pdus; ++i) {
+      uint8_t eps_bearer_id = default_eps_bearer_id;
+      if (i < nof_pdus) {
+        tft_matcher.check_tft_filter_match(ul_pdus[i], eps_bearer_id);
+      }
+
+      // Flush the batch at the end or when the EPS bearer changes
+      if (!ul_batch.empty() && (i == nof_pdus || eps_bearer_id != batch_eps_bearer_id)) {
+        if (!wait_for_service(batch_eps_bearer_id)) {
+          break;
+        }
+        stack->write_sdu_batch(batch_eps_bearer_id, std::move(ul_batch));
+        ul_batch.clear();
+      }
+      if (i == nof_pdus) {
+        break;
+      }
+
+      ul_pdus[i]->set_timestamp();
+      ul_tput_bytes += ul_pdus[i]->N_bytes;
+      ul_batch.push_back(std::move(ul_pdus[i]));
+      batch_eps_bearer_id = eps_bearer_id;
+    }
+  }
+  running = false;
+  logger.info("GW IP batch receiver thread exiting.");
+}
+
+/*
+ * Writes the DL PDUs handed over by the stack since the last wakeup. They are moved out of the pending batch under
+ * dl_mutex, so the stack can keep on queueing while the TUN writes are ongoing.
+ */
+void gw::write_dl_batch()
+{
+  uint64_t event = 0;
+  if (read(dl_event_fd, &event, sizeof(event)) != sizeof(event)) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(dl_mutex);
+    dl_batch.clear();
+    for (srsran::unique_byte_buffer_t& pdu : dl_pending) {
+      dl_batch.push_back(std::move(pdu));
+    }
+    dl_pending.clear();
+  }
+
+  uint32_t nof_bytes = 0;
+  for (srsran::unique_byte_buffer_t& pdu : dl_batch) {
+    nof_bytes += pdu->N_bytes;
+    write_tun(pdu.get());
+  }
+  logger.debug("Wrote %zd packets to TUN fd=%d", dl_batch.size(), tun_fd);
+  dl_batch.clear();
+
+  std::lock_guard<std::mutex> lock(gw_mutex);
+  dl_tput_bytes += nof_bytes;
+}
+
+uint16_t gw::get_ip_pkt_len(srsran::byte_buffer_t* pdu)
+{
+  struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
+  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
+  uint16_t        pkt_len = 0;
+  if (ip_pkt->version == 4) {
+    pkt_len = ntohs(ip_pkt->tot_len);
+  } else if (ip_pkt->version == 6) {
+    pkt_len = ntohs(ip6_pkt->payload_len) + 40;
+  } else {
+    logger.error(pdu->msg, pdu->N_bytes, "Unsupported IP version. Dropping packet.");
+    return 0;
+  }
+  logger.debug("IPv%d packet total length: %d Bytes", int(ip_pkt->version), pkt_len);
+  return pkt_len;
+}
+
+bool gw::wait_for_attach(std::unique_lock<std::mutex>& lock)
+{
+  const static uint32_t REGISTER_WAIT_TOUT = 40;
+  uint32_t              register_wait      = 0;
+  while (run_enable && default_eps_bearer_id == NOT_ASSIGNED && register_wait < REGISTER_WAIT_TOUT) {
+    if (!register_wait) {
+      logger.info("UE is not attached, waiting for NAS attach (%d/%d)", register_wait, REGISTER_WAIT_TOUT);
+    }
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    lock.lock();
+    register_wait++;
+  }
+  return run_enable && default_eps_bearer_id != NOT_ASSIGNED;
+}
+
+bool gw::wait_for_service(uint8_t eps_bearer_id)
+{
+  const static uint32_t SERVICE_WAIT_TOUT = 40; // 4 sec
+  uint32_t              service_wait      = 0;
+  while (run_enable && !stack->has_active_radio_bearer(eps_bearer_id) && service_wait < SERVICE_WAIT_TOUT) {
+    if (!service_wait) {
+      logger.info("UE does not have service, waiting for NAS service request (%d/%d)", service_wait, SERVICE_WAIT_TOUT);
+      stack->start_service_request();
+    }
+    usleep(100000);
+    service_wait++;
+  }
+  return run_enable;
+}
+
 /**************************/
 /* TUN Interface Helpers  */
 /**************************/
@@ -419,14 +613,23 @@ int gw::init_if(char* err_str)
     }
   }
 
-  // Construct the TUN device
-  tun_fd = open("/dev/net/tun", O_RDWR);
+  // Construct the TUN device. In batch mode it is drained with non-blocking reads
+  tun_fd = open("/dev/net/tun", args.batch_io ? O_RDWR | O_NONBLOCK : O_RDWR);
   logger.info("TUN file descriptor = %d", tun_fd);
   if (0 > tun_fd) {
     err_str = strerror(errno);
     logger.error("Failed to open TUN device: %s", err_str);
     return SRSRAN_ERROR_CANT_START;
   }
+  if (args.batch_io && dl_event_fd < 0) {
+    dl_event_fd = eventfd(0, EFD_NONBLOCK);
+    if (0 > dl_event_fd) {
+      err_str = strerror(errno);
+      logger.error("Failed to create the DL event fd: %s", err_str);
+      close(tun_fd);
+      return SRSRAN_ERROR_CANT_START;
+    }
+  }
 
   memset(&ifr, 0, sizeof(ifr));
   ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
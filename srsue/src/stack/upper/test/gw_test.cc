@@ -25,20 +25,84 @@
 #include "srsue/hdr/stack/upper/gw.h"
 
 #include <arpa/inet.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+#include <thread>
+
+static const uint16_t ul_port  = 5000;
+static const uint16_t dl_port  = 5001;
+static const uint32_t nof_pkts = 16;
 
 class test_stack_dummy : public srsue::stack_interface_gw
 {
 public:
   bool is_registered() { return true; }
   bool start_service_request() { return true; };
-  void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) { return; }
+  void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) { nof_ul_pkts += is_test_pkt(sdu.get()); }
+  void write_sdu_batch(uint32_t eps_bearer_id, srsue::gw_sdu_batch_t sdus)
+  {
+    for (srsran::unique_byte_buffer_t& sdu : sdus) {
+      nof_ul_batch_pkts += is_test_pkt(sdu.get());
+    }
+  }
   bool has_active_radio_bearer(uint32_t eps_bearer_id) { return true; }
+
+  std::atomic<uint32_t> nof_ul_pkts       = {0};
+  std::atomic<uint32_t> nof_ul_batch_pkts = {0};
+
+private:
+  // The kernel may also send its own packets (e.g. IPv6 router solicitations) through the TUN device
+  static bool is_test_pkt(srsran::byte_buffer_t* sdu)
+  {
+    struct iphdr*  ip_pkt  = (struct iphdr*)sdu->msg;
+    struct udphdr* udp_pkt = (struct udphdr*)&sdu->msg[ip_pkt->ihl * 4];
+    return ip_pkt->version == 4 && ip_pkt->protocol == IPPROTO_UDP && ntohs(udp_pkt->dest) == ul_port;
+  }
 };
 
-int gw_test()
+// Builds an IPv4/UDP packet as it would come out of the PDCP in DL
+srsran::unique_byte_buffer_t make_dl_pkt(in_addr_t src, in_addr_t dst, uint32_t idx)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  if (pdu == nullptr) {
+    return pdu;
+  }
+  pdu->N_bytes = sizeof(struct iphdr) + sizeof(struct udphdr) + sizeof(idx);
+  memset(pdu->msg, 0, pdu->N_bytes);
+
+  struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
+  ip_pkt->version      = 4;
+  ip_pkt->ihl          = 5;
+  ip_pkt->tot_len      = htons(pdu->N_bytes);
+  ip_pkt->ttl          = 64;
+  ip_pkt->protocol     = IPPROTO_UDP;
+  ip_pkt->saddr        = src;
+  ip_pkt->daddr        = dst;
+
+  // The kernel drops IPv4 packets with a wrong header checksum
+  uint32_t  sum = 0;
+  uint16_t* hdr = (uint16_t*)ip_pkt;
+  for (uint32_t i = 0; i < sizeof(struct iphdr) / 2; i++) {
+    sum += hdr[i];
+  }
+  sum           = (sum & 0xffff) + (sum >> 16);
+  ip_pkt->check = ~((sum & 0xffff) + (sum >> 16));
+
+  // A zero UDP checksum is not checked
+  struct udphdr* udp_pkt = (struct udphdr*)&pdu->msg[sizeof(struct iphdr)];
+  udp_pkt->source        = htons(dl_port);
+  udp_pkt->dest          = htons(dl_port);
+  udp_pkt->len           = htons(sizeof(struct udphdr) + sizeof(idx));
+  memcpy(&pdu->msg[sizeof(struct iphdr) + sizeof(struct udphdr)], &idx, sizeof(idx));
+  return pdu;
+}
+
+int gw_test(bool batch_io)
 {
   srsue::gw_args_t gw_args;
   gw_args.tun_dev_name     = "tun1";
+  gw_args.tun_dev_netmask  = "255.255.255.0";
+  gw_args.batch_io         = batch_io;
   gw_args.log.gw_level     = "debug";
   gw_args.log.gw_hex_limit = 100000;
   test_stack_dummy stack;
@@ -52,8 +116,9 @@ int gw_test()
   char*    err_str                    = nullptr;
   int      rtn                        = 0;
 
-  struct in_addr in_addr;
-  if (inet_pton(AF_INET, "192.168.56.32", &in_addr.s_addr) != 1) {
+  struct in_addr in_addr, peer_addr;
+  if (inet_pton(AF_INET, "192.168.56.32", &in_addr.s_addr) != 1 ||
+      inet_pton(AF_INET, "192.168.56.33", &peer_addr.s_addr) != 1) {
     perror("inet_pton");
     return SRSRAN_ERROR;
   }
@@ -66,8 +131,44 @@ int gw_test()
     return SRSRAN_SUCCESS;
   }
 
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  TESTASSERT(sock >= 0);
+  struct timeval tout = {1, 0};
+  TESTASSERT(setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tout, sizeof(tout)) == 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family         = AF_INET;
+  addr.sin_addr           = in_addr;
+  addr.sin_port           = htons(dl_port);
+  TESTASSERT(bind(sock, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+
+  // UL: the packets routed to the TUN device must reach the stack, through the batch interface in batch mode
+  addr.sin_addr = peer_addr;
+  addr.sin_port = htons(ul_port);
+  for (uint32_t i = 0; i < nof_pkts; i++) {
+    TESTASSERT(sendto(sock, &i, sizeof(i), 0, (struct sockaddr*)&addr, sizeof(addr)) == sizeof(i));
+  }
+  std::atomic<uint32_t>& nof_ul_pkts = batch_io ? stack.nof_ul_batch_pkts : stack.nof_ul_pkts;
+  for (uint32_t i = 0; i < 100 && nof_ul_pkts < nof_pkts; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  TESTASSERT(nof_ul_pkts == nof_pkts);
+  TESTASSERT(stack.nof_ul_pkts + stack.nof_ul_batch_pkts == nof_pkts);
+
+  // DL: the PDUs from the stack must be written to the TUN device, in order
+  for (uint32_t i = 0; i < nof_pkts; i++) {
+    srsran::unique_byte_buffer_t pdu = make_dl_pkt(peer_addr.s_addr, in_addr.s_addr, i);
+    TESTASSERT(pdu != nullptr);
+    gw.write_pdu(new_lcid, std::move(pdu));
+  }
+  for (uint32_t i = 0; i < nof_pkts; i++) {
+    uint32_t idx = 0;
+    TESTASSERT(recv(sock, &idx, sizeof(idx), 0) == sizeof(idx));
+    TESTASSERT(idx == i);
+  }
+  close(sock);
+
   TESTASSERT(gw.deactivate_eps_bearer(eps_bearer_id) == SRSRAN_SUCCESS);
-  TESTASSERT(gw.deactivate_eps_bearer(non_existing_eps_bearer_id) == SRSRAN_ERROR);
+  TESTASSERT(gw.deactivate_eps_bearer(non_existing_eps_bearer_id) == SRSRAN_SUCCESS);
   gw.stop();
   return SRSRAN_SUCCESS;
 }
@@ -76,7 +177,8 @@ int main(int argc, char** argv)
 {
   srslog::init();
 
-  TESTASSERT(gw_test() == SRSRAN_SUCCESS);
+  TESTASSERT(gw_test(false) == SRSRAN_SUCCESS);
+  TESTASSERT(gw_test(true) == SRSRAN_SUCCESS);
 
   return SRSRAN_SUCCESS;
 }